@@ -12,6 +12,9 @@ if(TUVX_ENABLE_TESTS)
   FetchContent_MakeAvailable(googletest)
 endif()
 
+# Threads (ThreadPool)
+find_package(Threads REQUIRED)
+
 # OpenMP
 if(TUVX_ENABLE_OPENMP)
   find_package(OpenMP REQUIRED)
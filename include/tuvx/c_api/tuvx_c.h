@@ -0,0 +1,132 @@
+/* TUV-x C API
+ *
+ * Bulk C interface to the TUV-x photolysis model. The host describes a whole
+ * batch of columns with pointers and element strides into its own arrays, and
+ * TUV-x writes J-values directly into a host-owned output array, so a single
+ * call covers the batch and no std::vector marshalling happens per column.
+ *
+ * Functions return 0 on success or one of the TUVX_*_ERROR_CODE_* values from
+ * <tuvx/util/error.hpp>.
+ */
+#ifndef TUVX_C_API_TUVX_C_H
+#define TUVX_C_API_TUVX_C_H
+
+#include <stddef.h>
+
+#include <tuvx/util/error.hpp>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Success return code */
+#define TUVX_SUCCESS 0
+
+  /* Opaque model handle */
+  typedef struct tuvx_model tuvx_model;
+
+  /* Model configuration (mirrors tuvx::ModelConfig) */
+  typedef struct tuvx_model_config
+  {
+    double wavelength_min;        /* [nm] */
+    double wavelength_max;        /* [nm] */
+    size_t n_wavelength_bins;
+    double altitude_min;          /* [km] */
+    double altitude_max;          /* [km] */
+    size_t n_altitude_layers;
+    int day_of_year;              /* [1-366] */
+    double earth_sun_distance;    /* [AU], <= 0 computes from day_of_year */
+    double surface_albedo;        /* default albedo when the batch gives none */
+    double ozone_column_du;       /* ozone column for default profiles [DU] */
+    int use_spherical_geometry;   /* nonzero to enable */
+  } tuvx_model_config;
+
+  /* Host-owned inputs for a batch of columns
+   *
+   * Strides are in elements. Layer l of column c of a profile is read from
+   * profile[c * column_stride + l * layer_stride]. A NULL profile (or albedo)
+   * pointer selects the model default. */
+  typedef struct tuvx_column_batch
+  {
+    size_t n_columns;
+    size_t n_layers;
+
+    const double* solar_zenith_angle; /* [degrees] */
+    ptrdiff_t solar_zenith_angle_stride;
+
+    const double* surface_albedo; /* [0-1], may be NULL */
+    ptrdiff_t surface_albedo_stride;
+
+    const double* temperature; /* [K], may be NULL */
+    ptrdiff_t temperature_column_stride;
+    ptrdiff_t temperature_layer_stride;
+
+    const double* air_density; /* [molecules/cm^3], may be NULL */
+    ptrdiff_t air_density_column_stride;
+    ptrdiff_t air_density_layer_stride;
+
+    const double* ozone; /* [molecules/cm^3], may be NULL */
+    ptrdiff_t ozone_column_stride;
+    ptrdiff_t ozone_layer_stride;
+  } tuvx_column_batch;
+
+  /* Host-owned photolysis rate output
+   *
+   * J for column c, reaction r and level l is written to
+   * data[c * column_stride + r * reaction_stride + l * level_stride]. */
+  typedef struct tuvx_rate_array
+  {
+    double* data; /* [s^-1] */
+    ptrdiff_t column_stride;
+    ptrdiff_t reaction_stride;
+    ptrdiff_t level_stride;
+  } tuvx_rate_array;
+
+  /* Fill a configuration with the tuvx::ModelConfig defaults */
+  void tuvx_model_config_default(tuvx_model_config* config);
+
+  /* Create a model; returns NULL and sets *error on failure */
+  tuvx_model* tuvx_model_create(const tuvx_model_config* config, int* error);
+
+  /* Destroy a model created by tuvx_model_create (NULL is ignored) */
+  void tuvx_model_destroy(tuvx_model* model);
+
+  /* Add the standard radiators (O3, O2, Rayleigh) */
+  int tuvx_model_add_standard_radiators(tuvx_model* model);
+
+  /* Add the default aerosol radiator */
+  int tuvx_model_add_aerosol_radiator(tuvx_model* model);
+
+  /* Add a built-in photolysis reaction by name.
+   * Supported: "O3 -> O2 + O(1D)", "O3 -> O2 + O(3P)" */
+  int tuvx_model_add_builtin_reaction(tuvx_model* model, const char* name);
+
+  /* Add a photolysis reaction from a tabulated cross-section and a constant
+   * quantum yield. The arrays are copied. */
+  int tuvx_model_add_tabulated_reaction(
+      tuvx_model* model,
+      const char* name,
+      size_t n_points,
+      const double* wavelengths,
+      const double* cross_sections,
+      double quantum_yield);
+
+  /* Model dimensions */
+  size_t tuvx_model_number_of_layers(const tuvx_model* model);
+  size_t tuvx_model_number_of_levels(const tuvx_model* model);
+  size_t tuvx_model_number_of_wavelengths(const tuvx_model* model);
+  size_t tuvx_model_number_of_reactions(const tuvx_model* model);
+
+  /* Copy the name of reaction `index` into `buffer` (NUL-terminated, truncated
+   * to buffer_size - 1 characters) */
+  int tuvx_model_reaction_name(const tuvx_model* model, size_t index, char* buffer, size_t buffer_size);
+
+  /* Calculate photolysis rates for every column in the batch */
+  int tuvx_model_calculate_batch(tuvx_model* model, const tuvx_column_batch* batch, const tuvx_rate_array* rates);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TUVX_C_API_TUVX_C_H */
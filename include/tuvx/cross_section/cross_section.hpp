@@ -1,6 +1,8 @@
 #pragma once
 
+#include <algorithm>
 #include <memory>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -38,6 +40,20 @@ namespace tuvx
     /// has size equal to wavelength_grid.Spec().n_cells.
     virtual std::vector<double> Calculate(const Grid& wavelength_grid, double temperature) const = 0;
 
+    /// @brief Calculate cross-section values into caller-owned memory
+    /// @param wavelength_grid Wavelength grid (midpoints used) [nm]
+    /// @param temperature Temperature [K]
+    /// @param result Destination for wavelength_grid.Spec().n_cells values [cm^2/molecule]
+    ///
+    /// The default implementation copies the result of Calculate(). Types
+    /// whose data is already tabulated override it to write in place without
+    /// allocating.
+    virtual void CalculateInto(const Grid& wavelength_grid, double temperature, std::span<double> result) const
+    {
+      auto values = Calculate(wavelength_grid, temperature);
+      std::copy_n(values.begin(), std::min(values.size(), result.size()), result.begin());
+    }
+
     /// @brief Calculate cross-section profile (altitude-dependent)
     /// @param wavelength_grid Wavelength grid
     /// @param altitude_grid Altitude grid
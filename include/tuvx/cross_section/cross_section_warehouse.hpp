@@ -7,6 +7,7 @@
 #include <vector>
 
 #include <tuvx/cross_section/cross_section.hpp>
+#include <tuvx/util/internal_error.hpp>
 
 namespace tuvx
 {
@@ -70,13 +71,13 @@ namespace tuvx
     {
       if (!cross_section)
       {
-        throw std::runtime_error("Cannot add null cross-section to warehouse");
+        TUVX_THROW(std::runtime_error("Cannot add null cross-section to warehouse"));
       }
 
       const std::string& name = cross_section->Name();
       if (name_to_index_.count(name) > 0)
       {
-        throw std::runtime_error("Cross-section '" + name + "' already exists in warehouse");
+        TUVX_THROW(std::runtime_error("Cross-section '" + name + "' already exists in warehouse"));
       }
 
       std::size_t index = cross_sections_.size();
@@ -95,7 +96,7 @@ namespace tuvx
       auto it = name_to_index_.find(name);
       if (it == name_to_index_.end())
       {
-        throw std::out_of_range("Cross-section '" + name + "' not found in warehouse");
+        TUVX_THROW(std::out_of_range("Cross-section '" + name + "' not found in warehouse"));
       }
       return *cross_sections_[it->second];
     }
@@ -108,7 +109,7 @@ namespace tuvx
     {
       if (!handle.IsValid() || handle.Index() >= cross_sections_.size())
       {
-        throw std::out_of_range("Invalid cross-section handle");
+        TUVX_THROW(std::out_of_range("Invalid cross-section handle"));
       }
       return *cross_sections_[handle.Index()];
     }
@@ -122,7 +123,7 @@ namespace tuvx
       auto it = name_to_index_.find(name);
       if (it == name_to_index_.end())
       {
-        throw std::out_of_range("Cross-section '" + name + "' not found in warehouse");
+        TUVX_THROW(std::out_of_range("Cross-section '" + name + "' not found in warehouse"));
       }
       return CrossSectionHandle(it->second);
     }
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <tuvx/cross_section/cross_section.hpp>
+#include <tuvx/cross_section/temperature_based.hpp>
+#include <tuvx/util/internal_error.hpp>
+
+namespace tuvx
+{
+  /// @brief Effective cross-section of each band of a coarse wavelength grid
+  ///
+  /// Holds one value per band at each reference temperature, usually
+  /// flux-weighted averages of a high-resolution cross-section over the fine
+  /// bins each band covers (see BandAggregation). Values are interpolated
+  /// linearly in temperature and clamped to the table range. There is no
+  /// wavelength interpolation: the grid passed to Calculate() must be the
+  /// band grid itself.
+  class BandCrossSection : public CrossSection
+  {
+   public:
+    /// @brief Construct from a band table
+    /// @param name Species or reaction name
+    /// @param temperatures Reference temperatures [K], sorted ascending
+    /// @param values Effective values [n_temperatures][n_bands] [cm^2/molecule]
+    /// @throws std::invalid_argument if the table shape does not match the temperatures
+    BandCrossSection(std::string name, std::vector<double> temperatures, std::vector<std::vector<double>> values)
+        : temperatures_(std::move(temperatures)),
+          values_(std::move(values))
+    {
+      name_ = std::move(name);
+      if (temperatures_.empty() || values_.size() != temperatures_.size())
+      {
+        TUVX_THROW(std::invalid_argument("Band cross-section '" + name_ + "' needs one row per temperature"));
+      }
+      for (const auto& row : values_)
+      {
+        if (row.size() != values_[0].size())
+        {
+          TUVX_THROW(std::invalid_argument("Band cross-section '" + name_ + "' rows differ in length"));
+        }
+      }
+    }
+
+    /// @brief Clone this cross-section
+    std::unique_ptr<CrossSection> Clone() const override
+    {
+      return std::make_unique<BandCrossSection>(name_, temperatures_, values_);
+    }
+
+    /// @brief Effective values on the band grid
+    /// @param wavelength_grid Band grid; must have NumberOfBands() cells
+    /// @param temperature Temperature [K]
+    /// @throws std::invalid_argument if the grid is not the band grid
+    std::vector<double> Calculate(const Grid& wavelength_grid, double temperature) const override
+    {
+      if (wavelength_grid.Spec().n_cells != NumberOfBands())
+      {
+        TUVX_THROW(std::invalid_argument("Band cross-section '" + name_ + "' evaluated on a grid with a different band count"));
+      }
+      if (temperatures_.size() == 1)
+      {
+        return values_[0];
+      }
+      return TemperatureBasedCrossSection<BandCrossSection>::InterpolateTemperature(temperature, temperatures_, values_);
+    }
+
+    /// @brief Number of bands in the table
+    std::size_t NumberOfBands() const
+    {
+      return values_[0].size();
+    }
+
+    /// @brief Reference temperatures of the table rows [K]
+    const std::vector<double>& ReferenceTemperatures() const
+    {
+      return temperatures_;
+    }
+
+    /// @brief Table values [n_temperatures][n_bands]
+    const std::vector<std::vector<double>>& Values() const
+    {
+      return values_;
+    }
+
+   private:
+    std::vector<double> temperatures_;
+    std::vector<std::vector<double>> values_;
+  };
+
+}  // namespace tuvx
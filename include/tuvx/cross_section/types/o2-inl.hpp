@@ -0,0 +1,48 @@
+#pragma once
+
+#include <tuvx/cross_section/types/o2.hpp>
+
+#include <vector>
+
+// Embedded O2 reference data. Included by o2.hpp in header-only
+// builds, compiled into the library by src/tuvx.cpp with TUVX_BUILD_COMPILED.
+
+namespace tuvx
+{
+  TUVX_INLINE void O2CrossSection::InitializeDefaultData()
+  {
+    // Wavelengths from far UV to edge of UV-C [nm]
+    wavelengths_ = {
+      130.0, 140.0, 150.0, 160.0, 170.0,  // Schumann-Runge continuum
+      175.0, 180.0, 185.0, 190.0, 195.0,  // Schumann-Runge bands
+      200.0, 205.0, 210.0, 215.0, 220.0,  // Herzberg continuum
+      225.0, 230.0, 235.0, 240.0, 245.0
+    };
+
+    // Cross-section values [cm^2/molecule]
+    // Based on JPL-19 recommendations
+    cross_section_data_ = {
+      1.5e-17,  // 130 nm - SR continuum (strong)
+      1.2e-17,  // 140 nm
+      8.0e-18,  // 150 nm
+      4.0e-18,  // 160 nm
+      1.5e-18,  // 170 nm
+      7.0e-19,  // 175 nm - SR bands begin
+      3.0e-19,  // 180 nm
+      1.5e-19,  // 185 nm
+      8.0e-20,  // 190 nm
+      4.0e-20,  // 195 nm
+      1.5e-20,  // 200 nm
+      5.0e-21,  // 205 nm - SR bands end
+      1.5e-21,  // 210 nm - Herzberg continuum
+      7.0e-22,  // 215 nm
+      3.0e-22,  // 220 nm
+      1.0e-22,  // 225 nm
+      5.0e-23,  // 230 nm
+      2.0e-23,  // 235 nm
+      1.0e-23,  // 240 nm
+      5.0e-24   // 245 nm
+    };
+  }
+
+}  // namespace tuvx
@@ -1,13 +1,16 @@
 #pragma once
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <memory>
+#include <span>
 #include <string>
 #include <vector>
 
 #include <tuvx/cross_section/cross_section.hpp>
 #include <tuvx/interpolation/linear_interpolator.hpp>
+#include <tuvx/util/build_mode.hpp>
 
 namespace tuvx
 {
@@ -54,19 +57,26 @@ namespace tuvx
     /// @brief Calculate O2 cross-section (temperature-independent approximation)
     std::vector<double> Calculate(const Grid& wavelength_grid, double temperature) const override
     {
-      (void)temperature;  // Temperature dependence is weak, ignored in this version
+      std::vector<double> result(wavelength_grid.Spec().n_cells);
+      CalculateInto(wavelength_grid, temperature, result);
+      return result;
+    }
 
-      std::size_t n_wavelengths = wavelength_grid.Spec().n_cells;
+    /// @brief Calculate O2 cross-section without allocating
+    void CalculateInto(const Grid& wavelength_grid, double temperature, std::span<double> result) const override
+    {
+      (void)temperature;  // Temperature dependence is weak, ignored in this version
 
       // Interpolate to target wavelength grid
       LinearInterpolator interp;
       auto target_wavelengths = wavelength_grid.Midpoints();
-      auto result = interp.Interpolate(target_wavelengths, wavelengths_, cross_section_data_);
+      interp.InterpolateInto(target_wavelengths, wavelengths_, cross_section_data_, result);
 
       // Zero out values outside the O2 absorption range
       double wl_min = wavelengths_.front();
       double wl_max = wavelengths_.back();
 
+      std::size_t n_wavelengths = std::min(target_wavelengths.size(), result.size());
       for (std::size_t i = 0; i < n_wavelengths; ++i)
       {
         double wl = target_wavelengths[i];
@@ -80,8 +90,6 @@ namespace tuvx
           result[i] = 0.0;
         }
       }
-
-      return result;
     }
 
     /// @brief Get reference wavelengths
@@ -99,41 +107,11 @@ namespace tuvx
     /// Representative O2 cross-sections covering UV-C region.
     /// The Schumann-Runge bands (175-205 nm) show complex structure
     /// that is simplified here to representative continuum values.
-    void InitializeDefaultData()
-    {
-      // Wavelengths from far UV to edge of UV-C [nm]
-      wavelengths_ = {
-        130.0, 140.0, 150.0, 160.0, 170.0,  // Schumann-Runge continuum
-        175.0, 180.0, 185.0, 190.0, 195.0,  // Schumann-Runge bands
-        200.0, 205.0, 210.0, 215.0, 220.0,  // Herzberg continuum
-        225.0, 230.0, 235.0, 240.0, 245.0
-      };
-
-      // Cross-section values [cm^2/molecule]
-      // Based on JPL-19 recommendations
-      cross_section_data_ = {
-        1.5e-17,  // 130 nm - SR continuum (strong)
-        1.2e-17,  // 140 nm
-        8.0e-18,  // 150 nm
-        4.0e-18,  // 160 nm
-        1.5e-18,  // 170 nm
-        7.0e-19,  // 175 nm - SR bands begin
-        3.0e-19,  // 180 nm
-        1.5e-19,  // 185 nm
-        8.0e-20,  // 190 nm
-        4.0e-20,  // 195 nm
-        1.5e-20,  // 200 nm
-        5.0e-21,  // 205 nm - SR bands end
-        1.5e-21,  // 210 nm - Herzberg continuum
-        7.0e-22,  // 215 nm
-        3.0e-22,  // 220 nm
-        1.0e-22,  // 225 nm
-        5.0e-23,  // 230 nm
-        2.0e-23,  // 235 nm
-        1.0e-23,  // 240 nm
-        5.0e-24   // 245 nm
-      };
-    }
+    void InitializeDefaultData();
   };
 
 }  // namespace tuvx
+
+#if TUVX_HEADER_ONLY
+  #include <tuvx/cross_section/types/o2-inl.hpp>
+#endif
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <tuvx/cross_section/types/o3.hpp>
+
+#include <vector>
+
+// Embedded O3 reference data. Included by o3.hpp in header-only
+// builds, compiled into the library by src/tuvx.cpp with TUVX_BUILD_COMPILED.
+
+namespace tuvx
+{
+  TUVX_INLINE void O3CrossSection::InitializeDefaultData()
+  {
+    // Representative wavelengths covering UV-B and UV-C
+    wavelengths_ = { 175.0, 200.0, 210.0, 220.0, 230.0, 240.0, 250.0, 260.0, 270.0, 280.0,
+                     290.0, 300.0, 310.0, 320.0, 330.0, 340.0, 350.0, 400.0, 500.0, 600.0 };
+
+    // Reference temperatures
+    temperatures_ = { 218.0, 228.0, 243.0, 273.0, 295.0 };
+
+    // Cross-section values [cm^2/molecule]
+    // Values are representative based on JPL-19 recommendations
+    // At 295 K (room temperature)
+    std::vector<double> xs_295K = {
+      1.0e-17,  // 175 nm - Hartley continuum
+      1.1e-17,  // 200 nm
+      1.0e-17,  // 210 nm
+      7.4e-18,  // 220 nm
+      4.3e-18,  // 230 nm
+      2.1e-18,  // 240 nm
+      9.9e-19,  // 250 nm
+      5.1e-19,  // 260 nm
+      3.3e-19,  // 270 nm
+      2.6e-19,  // 280 nm - Huggins bands begin
+      1.4e-19,  // 290 nm
+      4.3e-20,  // 300 nm
+      7.6e-21,  // 310 nm
+      9.5e-22,  // 320 nm
+      1.6e-22,  // 330 nm
+      5.0e-23,  // 340 nm
+      1.5e-23,  // 350 nm
+      1.0e-24,  // 400 nm - Chappuis band
+      4.0e-21,  // 500 nm - Chappuis peak
+      5.0e-21   // 600 nm - Chappuis
+    };
+
+    // At 218 K (stratospheric temperature)
+    // Temperature effect primarily in Huggins bands (300-350 nm)
+    std::vector<double> xs_218K = {
+      1.0e-17,  // 175 nm
+      1.1e-17,  // 200 nm
+      1.0e-17,  // 210 nm
+      7.4e-18,  // 220 nm
+      4.3e-18,  // 230 nm
+      2.1e-18,  // 240 nm
+      9.9e-19,  // 250 nm
+      5.1e-19,  // 260 nm
+      3.3e-19,  // 270 nm
+      2.6e-19,  // 280 nm
+      1.4e-19,  // 290 nm
+      3.8e-20,  // 300 nm - reduced at low T
+      5.5e-21,  // 310 nm
+      5.5e-22,  // 320 nm
+      6.0e-23,  // 330 nm
+      1.5e-23,  // 340 nm
+      4.0e-24,  // 350 nm
+      1.0e-24,  // 400 nm
+      4.0e-21,  // 500 nm
+      5.0e-21   // 600 nm
+    };
+
+    // Interpolate for intermediate temperatures
+    std::vector<double> xs_228K(wavelengths_.size());
+    std::vector<double> xs_243K(wavelengths_.size());
+    std::vector<double> xs_273K(wavelengths_.size());
+
+    for (std::size_t i = 0; i < wavelengths_.size(); ++i)
+    {
+      double t_frac = (228.0 - 218.0) / (295.0 - 218.0);
+      xs_228K[i] = xs_218K[i] + t_frac * (xs_295K[i] - xs_218K[i]);
+
+      t_frac = (243.0 - 218.0) / (295.0 - 218.0);
+      xs_243K[i] = xs_218K[i] + t_frac * (xs_295K[i] - xs_218K[i]);
+
+      t_frac = (273.0 - 218.0) / (295.0 - 218.0);
+      xs_273K[i] = xs_218K[i] + t_frac * (xs_295K[i] - xs_218K[i]);
+    }
+
+    cross_section_data_ = { xs_218K, xs_228K, xs_243K, xs_273K, xs_295K };
+  }
+
+}  // namespace tuvx
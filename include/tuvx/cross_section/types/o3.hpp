@@ -1,15 +1,16 @@
 #pragma once
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <memory>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include <tuvx/cross_section/cross_section.hpp>
-#include <tuvx/cross_section/temperature_based.hpp>
-#include <tuvx/interpolation/linear_interpolator.hpp>
+#include <tuvx/util/build_mode.hpp>
 
 namespace tuvx
 {
@@ -59,36 +60,84 @@ namespace tuvx
     /// @brief Calculate O3 cross-section at given temperature
     std::vector<double> Calculate(const Grid& wavelength_grid, double temperature) const override
     {
-      std::size_t n_wavelengths = wavelength_grid.Spec().n_cells;
-
-      // Get cross-sections at target temperature
-      auto temp_xs = TemperatureBasedCrossSection<O3CrossSection>::InterpolateTemperature(
-          temperature, temperatures_, cross_section_data_);
+      std::vector<double> result(wavelength_grid.Spec().n_cells);
+      CalculateInto(wavelength_grid, temperature, result);
+      return result;
+    }
 
-      // Interpolate to target wavelength grid
-      LinearInterpolator interp;
+    /// @brief Calculate O3 cross-section at given temperature without allocating
+    ///
+    /// Interpolates in temperature as
+    /// TemperatureBasedCrossSection::InterpolateTemperature() and in
+    /// wavelength as LinearInterpolator, evaluating the temperature-interpolated
+    /// row only at the reference wavelengths each bin needs.
+    void CalculateInto(const Grid& wavelength_grid, double temperature, std::span<double> result) const override
+    {
       auto target_wavelengths = wavelength_grid.Midpoints();
-      auto result = interp.Interpolate(target_wavelengths, wavelengths_, temp_xs);
+      std::size_t n_wavelengths = std::min(target_wavelengths.size(), result.size());
+      std::fill_n(result.begin(), n_wavelengths, 0.0);
+      if (temperatures_.empty() || cross_section_data_.empty() || wavelengths_.empty() ||
+          cross_section_data_[0].size() != wavelengths_.size())
+      {
+        return;
+      }
+
+      // Bracketing reference temperatures
+      double clamped_temp = std::clamp(temperature, temperatures_.front(), temperatures_.back());
+      std::size_t i_upper = static_cast<std::size_t>(
+          std::lower_bound(temperatures_.begin(), temperatures_.end(), clamped_temp) - temperatures_.begin());
+      std::size_t i_lower = i_upper;
+      double weight = 0.0;
+      bool interpolate = false;
+      if (i_upper == temperatures_.size())
+      {
+        i_lower = i_upper = temperatures_.size() - 1;
+      }
+      else if (i_upper > 0)
+      {
+        i_lower = i_upper - 1;
+        interpolate = std::abs(temperatures_[i_upper] - temperatures_[i_lower]) >= 1e-10;
+        if (interpolate)
+        {
+          weight = (clamped_temp - temperatures_[i_lower]) / (temperatures_[i_upper] - temperatures_[i_lower]);
+        }
+      }
+      const auto& data_lower = cross_section_data_[i_lower];
+      const auto& data_upper = cross_section_data_[i_upper];
+      auto row_value = [&](std::size_t k)
+      { return interpolate ? data_lower[k] + weight * (data_upper[k] - data_lower[k]) : data_lower[k]; };
 
-      // Zero out values outside the O3 absorption range
+      // Interpolate to target wavelength grid, zero outside the O3 absorption range
       double wl_min = wavelengths_.front();
       double wl_max = wavelengths_.back();
-
       for (std::size_t i = 0; i < n_wavelengths; ++i)
       {
         double wl = target_wavelengths[i];
         if (wl < wl_min || wl > wl_max)
         {
-          result[i] = 0.0;
+          continue;
         }
-        // Ensure non-negative
-        if (result[i] < 0.0)
+        double value = 0.0;
+        if (wl == wl_min)
+        {
+          value = row_value(0);
+        }
+        else if (wl == wl_max)
         {
-          result[i] = 0.0;
+          value = row_value(wavelengths_.size() - 1);
         }
+        else
+        {
+          std::size_t k_upper = static_cast<std::size_t>(
+              std::upper_bound(wavelengths_.begin(), wavelengths_.end(), wl) - wavelengths_.begin());
+          std::size_t k_lower = k_upper - 1;
+          double t = (wl - wavelengths_[k_lower]) / (wavelengths_[k_upper] - wavelengths_[k_lower]);
+          double y0 = row_value(k_lower);
+          value = y0 + t * (row_value(k_upper) - y0);
+        }
+        // Ensure non-negative
+        result[i] = value < 0.0 ? 0.0 : value;
       }
-
-      return result;
     }
 
     /// @brief Get reference wavelengths
@@ -112,85 +161,11 @@ namespace tuvx
     ///
     /// This provides representative O3 cross-sections for the Hartley and
     /// Huggins bands. For production use, load full data from files.
-    void InitializeDefaultData()
-    {
-      // Representative wavelengths covering UV-B and UV-C
-      wavelengths_ = { 175.0, 200.0, 210.0, 220.0, 230.0, 240.0, 250.0, 260.0, 270.0, 280.0,
-                       290.0, 300.0, 310.0, 320.0, 330.0, 340.0, 350.0, 400.0, 500.0, 600.0 };
-
-      // Reference temperatures
-      temperatures_ = { 218.0, 228.0, 243.0, 273.0, 295.0 };
-
-      // Cross-section values [cm^2/molecule]
-      // Values are representative based on JPL-19 recommendations
-      // At 295 K (room temperature)
-      std::vector<double> xs_295K = {
-        1.0e-17,  // 175 nm - Hartley continuum
-        1.1e-17,  // 200 nm
-        1.0e-17,  // 210 nm
-        7.4e-18,  // 220 nm
-        4.3e-18,  // 230 nm
-        2.1e-18,  // 240 nm
-        9.9e-19,  // 250 nm
-        5.1e-19,  // 260 nm
-        3.3e-19,  // 270 nm
-        2.6e-19,  // 280 nm - Huggins bands begin
-        1.4e-19,  // 290 nm
-        4.3e-20,  // 300 nm
-        7.6e-21,  // 310 nm
-        9.5e-22,  // 320 nm
-        1.6e-22,  // 330 nm
-        5.0e-23,  // 340 nm
-        1.5e-23,  // 350 nm
-        1.0e-24,  // 400 nm - Chappuis band
-        4.0e-21,  // 500 nm - Chappuis peak
-        5.0e-21   // 600 nm - Chappuis
-      };
-
-      // At 218 K (stratospheric temperature)
-      // Temperature effect primarily in Huggins bands (300-350 nm)
-      std::vector<double> xs_218K = {
-        1.0e-17,  // 175 nm
-        1.1e-17,  // 200 nm
-        1.0e-17,  // 210 nm
-        7.4e-18,  // 220 nm
-        4.3e-18,  // 230 nm
-        2.1e-18,  // 240 nm
-        9.9e-19,  // 250 nm
-        5.1e-19,  // 260 nm
-        3.3e-19,  // 270 nm
-        2.6e-19,  // 280 nm
-        1.4e-19,  // 290 nm
-        3.8e-20,  // 300 nm - reduced at low T
-        5.5e-21,  // 310 nm
-        5.5e-22,  // 320 nm
-        6.0e-23,  // 330 nm
-        1.5e-23,  // 340 nm
-        4.0e-24,  // 350 nm
-        1.0e-24,  // 400 nm
-        4.0e-21,  // 500 nm
-        5.0e-21   // 600 nm
-      };
-
-      // Interpolate for intermediate temperatures
-      std::vector<double> xs_228K(wavelengths_.size());
-      std::vector<double> xs_243K(wavelengths_.size());
-      std::vector<double> xs_273K(wavelengths_.size());
-
-      for (std::size_t i = 0; i < wavelengths_.size(); ++i)
-      {
-        double t_frac = (228.0 - 218.0) / (295.0 - 218.0);
-        xs_228K[i] = xs_218K[i] + t_frac * (xs_295K[i] - xs_218K[i]);
-
-        t_frac = (243.0 - 218.0) / (295.0 - 218.0);
-        xs_243K[i] = xs_218K[i] + t_frac * (xs_295K[i] - xs_218K[i]);
-
-        t_frac = (273.0 - 218.0) / (295.0 - 218.0);
-        xs_273K[i] = xs_218K[i] + t_frac * (xs_295K[i] - xs_218K[i]);
-      }
-
-      cross_section_data_ = { xs_218K, xs_228K, xs_243K, xs_273K, xs_295K };
-    }
+    void InitializeDefaultData();
   };
 
 }  // namespace tuvx
+
+#if TUVX_HEADER_ONLY
+  #include <tuvx/cross_section/types/o3-inl.hpp>
+#endif
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <tuvx/cross_section/cross_section.hpp>
+#include <tuvx/grid/grid.hpp>
+#include <tuvx/util/internal_error.hpp>
+#include <tuvx/util/shared_table.hpp>
+
+namespace tuvx
+{
+  namespace detail
+  {
+    /// @brief Interpolate a temperature-by-wavelength table onto a grid, without allocating
+    /// @param wavelength_grid Target grid (midpoints used)
+    /// @param temperature Target temperature [K], clamped to the table range
+    /// @param wavelengths Table column wavelengths [nm], ascending
+    /// @param temperatures Table row temperatures [K], ascending
+    /// @param values Row-major table, one row per temperature
+    /// @param result Destination, one value per grid cell; zero outside the table's wavelength range
+    ///
+    /// Rows are interpolated linearly in temperature and, unless the table was
+    /// binned on the grid's own midpoints, linearly in wavelength. A table
+    /// temperature or the grid's own midpoints reproduce the table exactly.
+    inline void InterpolateTable(
+        const Grid& wavelength_grid,
+        double temperature,
+        std::span<const double> wavelengths,
+        std::span<const double> temperatures,
+        const SharedTable& values,
+        std::span<double> result)
+    {
+      std::fill(result.begin(), result.end(), 0.0);
+      if (temperatures.empty() || wavelengths.empty())
+      {
+        return;
+      }
+
+      // Bracketing rows and the weight of the upper one
+      double clamped = std::clamp(temperature, temperatures.front(), temperatures.back());
+      std::size_t i_upper = static_cast<std::size_t>(
+          std::lower_bound(temperatures.begin(), temperatures.end(), clamped) - temperatures.begin());
+      i_upper = std::min(i_upper, temperatures.size() - 1);
+      std::size_t i_lower = i_upper;
+      double weight = 0.0;
+      if (temperatures[i_upper] != clamped && i_upper > 0)
+      {
+        i_lower = i_upper - 1;
+        weight = (clamped - temperatures[i_lower]) / (temperatures[i_upper] - temperatures[i_lower]);
+      }
+      auto lower_row = values.Row(i_lower);
+      auto upper_row = values.Row(i_upper);
+      auto row_value = [&](std::size_t c)
+      { return i_lower == i_upper ? upper_row[c] : lower_row[c] + weight * (upper_row[c] - lower_row[c]); };
+
+      auto target = wavelength_grid.Midpoints();
+      std::size_t n = std::min(target.size(), result.size());
+      if (std::equal(target.begin(), target.end(), wavelengths.begin(), wavelengths.end()))
+      {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+          result[i] = row_value(i);
+        }
+        return;
+      }
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        if (target[i] < wavelengths.front() || target[i] > wavelengths.back())
+        {
+          continue;
+        }
+        std::size_t c_upper = static_cast<std::size_t>(
+            std::lower_bound(wavelengths.begin(), wavelengths.end(), target[i]) - wavelengths.begin());
+        if (wavelengths[c_upper] == target[i] || c_upper == 0)
+        {
+          result[i] = row_value(c_upper);
+          continue;
+        }
+        double fraction = (target[i] - wavelengths[c_upper - 1]) / (wavelengths[c_upper] - wavelengths[c_upper - 1]);
+        double below = row_value(c_upper - 1);
+        result[i] = below + fraction * (row_value(c_upper) - below);
+      }
+    }
+  }  // namespace detail
+
+  /// @brief Cross-section whose data lives in a SharedTableSegment
+  ///
+  /// Reads the tables "<key>/wavelengths", "<key>/temperatures" and
+  /// "<key>/values" (one row per temperature) directly from the shared
+  /// mapping, so ranks on a node share one copy. Values are interpolated
+  /// linearly in temperature (clamped to the table range) and, unless the
+  /// table was binned on the same grid, linearly in wavelength. The object
+  /// keeps the segment mapped for as long as it (or a clone) exists.
+  ///
+  /// Tables are usually written with BinCrossSection.
+  class SharedCrossSection : public CrossSection
+  {
+   public:
+    /// @brief Reference a cross-section in a shared segment
+    /// @param segment Segment holding the tables
+    /// @param key Table key prefix; also used as the cross-section name
+    /// @throws std::out_of_range if any of the tables is missing
+    /// @throws std::invalid_argument if the table shapes do not match
+    SharedCrossSection(std::shared_ptr<const SharedTableSegment> segment, const std::string& key)
+        : segment_(std::move(segment)),
+          wavelengths_(segment_->Get(key + "/wavelengths")),
+          temperatures_(segment_->Get(key + "/temperatures")),
+          values_(segment_->Get(key + "/values"))
+    {
+      name_ = key;
+      if (values_.rows != temperatures_.cols || values_.cols != wavelengths_.cols || wavelengths_.cols == 0)
+      {
+        TUVX_THROW(std::invalid_argument("Shared cross-section '" + key + "' has inconsistent table shapes"));
+      }
+    }
+
+    /// @brief Clone this cross-section (shares the segment)
+    std::unique_ptr<CrossSection> Clone() const override
+    {
+      return std::make_unique<SharedCrossSection>(*this);
+    }
+
+    /// @brief Calculate cross-section values on wavelength grid
+    std::vector<double> Calculate(const Grid& wavelength_grid, double temperature) const override
+    {
+      std::vector<double> result(wavelength_grid.Spec().n_cells);
+      CalculateInto(wavelength_grid, temperature, result);
+      return result;
+    }
+
+    /// @brief Interpolate the shared table straight into caller-owned memory, without allocating
+    void CalculateInto(const Grid& wavelength_grid, double temperature, std::span<double> result) const override
+    {
+      detail::InterpolateTable(wavelength_grid, temperature, wavelengths_.Values(), temperatures_.Values(), values_, result);
+    }
+
+    /// @brief Wavelengths of the table columns [nm]
+    std::span<const double> ReferenceWavelengths() const
+    {
+      return wavelengths_.Values();
+    }
+
+    /// @brief Temperatures of the table rows [K]
+    std::span<const double> ReferenceTemperatures() const
+    {
+      return temperatures_.Values();
+    }
+
+   private:
+    std::shared_ptr<const SharedTableSegment> segment_;
+    SharedTable wavelengths_;
+    SharedTable temperatures_;
+    SharedTable values_;
+  };
+
+  /// @brief Bin a cross-section onto a wavelength grid and add it to a shared-table builder
+  /// @param builder Builder to add the "<key>/..." tables to
+  /// @param key Table key prefix
+  /// @param cross_section Cross-section to evaluate
+  /// @param wavelength_grid Grid whose midpoints become the table wavelengths
+  /// @param temperatures Temperatures to evaluate at [K], ascending
+  ///
+  /// A SharedCrossSection used on the same grid then returns the binned
+  /// values unchanged at these temperatures.
+  inline void BinCrossSection(
+      SharedTableBuilder& builder,
+      const std::string& key,
+      const CrossSection& cross_section,
+      const Grid& wavelength_grid,
+      const std::vector<double>& temperatures)
+  {
+    auto midpoints = wavelength_grid.Midpoints();
+    std::vector<double> values;
+    values.reserve(temperatures.size() * midpoints.size());
+    for (double temperature : temperatures)
+    {
+      auto row = cross_section.Calculate(wavelength_grid, temperature);
+      values.insert(values.end(), row.begin(), row.end());
+    }
+    builder.Add(key + "/wavelengths", midpoints);
+    builder.Add(key + "/temperatures", temperatures);
+    builder.Add(key + "/values", temperatures.size(), midpoints.size(), values);
+  }
+
+}  // namespace tuvx
@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <string>
+#include <system_error>
 #include <unordered_map>
 #include <vector>
 
@@ -129,6 +130,43 @@ namespace tuvx
       return grids_[handle.Index()];
     }
 
+    /// @brief Look up a grid by name and units without throwing
+    /// @param name Grid name
+    /// @param units Grid units
+    /// @param grid Set to the grid on success, nullptr otherwise
+    /// @return Empty error code on success, TuvxInternalErrc::GridNotFound otherwise
+    ///
+    /// Compares the stored specs instead of building a key, so the lookup
+    /// does not allocate; radiators call it on every update.
+    std::error_code TryGet(const std::string& name, const std::string& units, const Grid*& grid) const
+    {
+      grid = nullptr;
+      for (const auto& entry : grids_)
+      {
+        if (entry.Spec().name == name && entry.Spec().units == units)
+        {
+          grid = &entry;
+          return {};
+        }
+      }
+      return TuvxInternalErrc::GridNotFound;
+    }
+
+    /// @brief Look up a grid by handle without throwing
+    /// @param handle Grid handle from Add()
+    /// @param grid Set to the grid on success, nullptr otherwise
+    /// @return Empty error code on success, TuvxInternalErrc::InvalidHandle otherwise
+    std::error_code TryGet(GridHandle handle, const Grid*& grid) const noexcept
+    {
+      if (!handle.IsValid() || handle.Index() >= grids_.size())
+      {
+        grid = nullptr;
+        return TuvxInternalErrc::InvalidHandle;
+      }
+      grid = &grids_[handle.Index()];
+      return {};
+    }
+
     /// @brief Get a handle for a grid by name and units
     /// @param name Grid name
     /// @param units Grid units
@@ -38,27 +38,35 @@ namespace tuvx
         std::span<const double> source_x,
         std::span<const double> source_y) const
     {
-      std::vector<double> result;
-      result.reserve(target_x.size());
-
-      if (source_x.empty() || source_y.empty())
-      {
-        result.resize(target_x.size(), 0.0);
-        return result;
-      }
+      std::vector<double> result(target_x.size());
+      InterpolateInto(target_x, source_x, source_y, result);
+      return result;
+    }
 
-      if (source_x.size() != source_y.size())
+    /// @brief Interpolate source data onto target coordinates in caller-owned memory
+    /// @param target_x Target x-coordinates where values are needed
+    /// @param source_x Source x-coordinates (must be sorted ascending)
+    /// @param source_y Source y-values corresponding to source_x
+    /// @param result Destination for the first result.size() interpolated values
+    ///
+    /// Same values as Interpolate(), without allocating.
+    void InterpolateInto(
+        std::span<const double> target_x,
+        std::span<const double> source_x,
+        std::span<const double> source_y,
+        std::span<double> result) const
+    {
+      std::size_t n = std::min(target_x.size(), result.size());
+      if (source_x.empty() || source_y.empty() || source_x.size() != source_y.size())
       {
-        result.resize(target_x.size(), 0.0);
-        return result;
+        std::fill_n(result.begin(), n, 0.0);
+        return;
       }
 
-      for (const double x : target_x)
+      for (std::size_t i = 0; i < n; ++i)
       {
-        result.push_back(InterpolateSingle(x, source_x, source_y));
+        result[i] = InterpolateSingle(target_x[i], source_x, source_y);
       }
-
-      return result;
     }
 
     /// @brief Check if extrapolation is supported
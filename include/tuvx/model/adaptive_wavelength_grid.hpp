@@ -0,0 +1,264 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/radiator/radiator_state.hpp>
+#include <tuvx/radiator/radiator_warehouse.hpp>
+#include <tuvx/util/internal_error.hpp>
+
+namespace tuvx
+{
+  /// @brief Options for BuildAdaptiveWavelengthGrid()
+  struct AdaptiveGridConfig
+  {
+    /// Bin budget; refinement stops once the grid has this many bins
+    std::size_t max_bins{ 140 };
+
+    /// Estimated relative J error at which refinement stops early (0 = use the whole budget)
+    double tolerance{ 0.0 };
+
+    /// Width of the reference bins the spectra are sampled on [nm]; bin edges snap to them
+    double reference_resolution{ 0.1 };
+
+    /// Equal-width bins the refinement starts from
+    std::size_t initial_bins{ 8 };
+
+    /// Temperature the cross-sections and quantum yields are sampled at [K]
+    double reference_temperature{ 250.0 };
+
+    /// Multiples of the vertical column optical depth at which the direct-beam
+    /// transmission is applied; 0 is the top of the atmosphere
+    std::vector<double> attenuation_scales{ 0.0, 0.3, 1.0, 3.0 };
+  };
+
+  /// @brief Wavelength grid placed by spectral structure
+  struct AdaptiveWavelengthGrid
+  {
+    /// Bin edges [nm], ready for TuvModel::SetWavelengthGrid()
+    std::vector<double> edges;
+
+    /// Largest estimated relative J error over the reactions and attenuations
+    double estimated_error{ 0.0 };
+  };
+
+  /// @brief Place wavelength bin edges where the photolysis integrands have structure
+  /// @param model Model whose wavelength range, radiators and reactions drive the placement
+  /// @param config Refinement options
+  /// @return Bin edges and the estimated error they reach
+  /// @throws std::invalid_argument if the budget or the reference resolution is not positive
+  ///
+  /// The model is sampled on a fine reference grid over its wavelength
+  /// range. For each reaction, and for the actinic flux alone, the integrand
+  /// F(λ) σ(λ) φ(λ) exp(-s τ(λ)) is formed from the extraterrestrial flux,
+  /// the reaction's σ·φ and the direct-beam transmission through s times the
+  /// column optical depth of the model's radiators. The error of a bin is
+  /// how far the model's rule, the integrand at the bin midpoint times the
+  /// width, misses the reference integral over the bin, relative to the
+  /// J-value over the whole range. It grows with the curvature and the
+  /// magnitude of the integrand, so bins end up narrow in the Huggins bands
+  /// and at the 290–320 nm cutoff and wide in the smooth visible.
+  ///
+  /// Starting from AdaptiveGridConfig::initial_bins equal bins, the bin with
+  /// the largest summed error is bisected, at a reference edge, until the
+  /// budget is spent or every reaction's summed bin error is within the
+  /// tolerance. The estimate is an upper bound on the quadrature error of the
+  /// sampled spectra; errors of opposite sign partly cancel in practice.
+  inline AdaptiveWavelengthGrid BuildAdaptiveWavelengthGrid(const TuvModel& model, const AdaptiveGridConfig& config = {})
+  {
+    if (config.max_bins == 0 || config.reference_resolution <= 0.0)
+    {
+      TUVX_THROW(std::invalid_argument("Adaptive wavelength grid needs a positive bin budget and reference resolution"));
+    }
+
+    // Reference grid over the model's range
+    double lower = model.WavelengthGrid().LowerBound();
+    double upper = model.WavelengthGrid().UpperBound();
+    auto n_reference = static_cast<std::size_t>(std::ceil((upper - lower) / config.reference_resolution));
+    n_reference = std::max(n_reference, config.max_bins);
+    std::vector<double> reference_edges(n_reference + 1);
+    for (std::size_t i = 0; i <= n_reference; ++i)
+    {
+      reference_edges[i] = lower + (upper - lower) * static_cast<double>(i) / static_cast<double>(n_reference);
+    }
+    reference_edges.back() = upper;
+
+    TuvModel reference(model);
+    reference.SetWavelengthGrid(reference_edges);
+    reference.PrepareComponents();
+    const Grid& grid = reference.WavelengthGrid();
+    auto midpoints = grid.Midpoints();
+    auto deltas = grid.Deltas();
+    const auto& flux = reference.ExtraterrestrialFlux();
+
+    // σ·φ of each reaction, plus a unit row for the actinic flux itself
+    std::vector<std::vector<double>> yields(1, std::vector<double>(n_reference, 1.0));
+    const auto& reactions = reference.PhotolysisReactions();
+    for (std::size_t r = 0; r < reactions.Size(); ++r)
+    {
+      const auto& reaction = reactions.Get(r);
+      std::vector<double> product(n_reference, 0.0);
+      if (reaction.GetCrossSection() != nullptr && reaction.GetQuantumYield() != nullptr)
+      {
+        auto xs = reaction.GetCrossSection()->Calculate(grid, config.reference_temperature);
+        auto qy = reaction.GetQuantumYield()->Calculate(grid, config.reference_temperature);
+        for (std::size_t i = 0; i < n_reference; ++i)
+        {
+          product[i] = xs[i] * qy[i];
+        }
+      }
+      yields.push_back(std::move(product));
+    }
+
+    // Direct-beam transmission at each attenuation scale
+    RadiatorWarehouse radiators = reference.Radiators().Clone();
+    radiators.UpdateAll(reference.GetGridWarehouse(), reference.CreateProfileWarehouse());
+    RadiatorState state = radiators.CombinedState();
+    std::vector<double> column(n_reference, 0.0);
+    for (std::size_t l = 0; l < state.NumberOfLayers(); ++l)
+    {
+      for (std::size_t i = 0; i < n_reference; ++i)
+      {
+        column[i] += state.optical_depth[l][i];
+      }
+    }
+    std::vector<std::vector<double>> transmissions;
+    for (double scale : config.attenuation_scales)
+    {
+      std::vector<double> transmission(n_reference);
+      for (std::size_t i = 0; i < n_reference; ++i)
+      {
+        transmission[i] = std::exp(-scale * column[i]);
+      }
+      transmissions.push_back(std::move(transmission));
+    }
+    if (transmissions.empty())
+    {
+      transmissions.emplace_back(n_reference, 1.0);
+    }
+
+    // One term per (yield, transmission): cumulative integrals and total J
+    struct Term
+    {
+      const std::vector<double>* yield;
+      const std::vector<double>* transmission;
+      std::vector<double> cumulative;
+    };
+    std::vector<Term> terms;
+    for (const auto& yield : yields)
+    {
+      for (const auto& transmission : transmissions)
+      {
+        Term term{ &yield, &transmission, std::vector<double>(n_reference + 1, 0.0) };
+        for (std::size_t i = 0; i < n_reference; ++i)
+        {
+          term.cumulative[i + 1] = term.cumulative[i] + flux[i] * yield[i] * transmission[i] * std::abs(deltas[i]);
+        }
+        if (term.cumulative.back() > 0.0)
+        {
+          terms.push_back(std::move(term));
+        }
+      }
+    }
+
+    // Relative midpoint-rule error of bin [first, last) for each term
+    auto bin_errors = [&](std::size_t first, std::size_t last)
+    {
+      double center = 0.5 * (reference_edges[first] + reference_edges[last]);
+      double width = reference_edges[last] - reference_edges[first];
+
+      // Linear interpolation between reference midpoints, as the model samples its data
+      auto upper_it = std::upper_bound(midpoints.begin(), midpoints.end(), center);
+      std::size_t hi = std::min<std::size_t>(static_cast<std::size_t>(upper_it - midpoints.begin()), n_reference - 1);
+      std::size_t lo = hi > 0 ? hi - 1 : 0;
+      double weight = hi == lo ? 0.0 : std::clamp((center - midpoints[lo]) / (midpoints[hi] - midpoints[lo]), 0.0, 1.0);
+      auto at_center = [&](const std::vector<double>& values) { return values[lo] + weight * (values[hi] - values[lo]); };
+
+      double flux_center = at_center(flux);
+      std::vector<double> errors(terms.size());
+      for (std::size_t k = 0; k < terms.size(); ++k)
+      {
+        const auto& term = terms[k];
+        double rule = width * flux_center * at_center(*term.yield) * at_center(*term.transmission);
+        double exact = term.cumulative[last] - term.cumulative[first];
+        errors[k] = std::abs(rule - exact) / term.cumulative.back();
+      }
+      return errors;
+    };
+
+    struct Bin
+    {
+      double cost;
+      std::size_t first;
+      std::size_t last;
+      std::vector<double> errors;
+
+      bool operator<(const Bin& other) const
+      {
+        return cost < other.cost;
+      }
+    };
+    std::priority_queue<Bin> splittable;
+    std::vector<Bin> finished;
+    std::vector<double> totals(terms.size(), 0.0);
+    auto add_bin = [&](std::size_t first, std::size_t last)
+    {
+      Bin bin{ 0.0, first, last, bin_errors(first, last) };
+      for (std::size_t k = 0; k < terms.size(); ++k)
+      {
+        bin.cost += bin.errors[k];
+        totals[k] += bin.errors[k];
+      }
+      if (last - first > 1)
+      {
+        splittable.push(std::move(bin));
+      }
+      else
+      {
+        finished.push_back(std::move(bin));
+      }
+    };
+    auto estimated_error = [&] { return terms.empty() ? 0.0 : *std::max_element(totals.begin(), totals.end()); };
+
+    std::size_t n_initial = std::clamp<std::size_t>(config.initial_bins, 1, config.max_bins);
+    for (std::size_t b = 0; b < n_initial; ++b)
+    {
+      add_bin(b * n_reference / n_initial, (b + 1) * n_reference / n_initial);
+    }
+    std::size_t n_bins = n_initial;
+    while (n_bins < config.max_bins && !splittable.empty() && (config.tolerance <= 0.0 || estimated_error() > config.tolerance))
+    {
+      Bin bin = splittable.top();
+      splittable.pop();
+      for (std::size_t k = 0; k < terms.size(); ++k)
+      {
+        totals[k] -= bin.errors[k];
+      }
+      std::size_t middle = (bin.first + bin.last) / 2;
+      add_bin(bin.first, middle);
+      add_bin(middle, bin.last);
+      ++n_bins;
+    }
+
+    AdaptiveWavelengthGrid result;
+    result.estimated_error = estimated_error();
+    for (; !splittable.empty(); splittable.pop())
+    {
+      finished.push_back(splittable.top());
+    }
+    for (const auto& bin : finished)
+    {
+      result.edges.push_back(reference_edges[bin.first]);
+    }
+    result.edges.push_back(upper);
+    std::sort(result.edges.begin(), result.edges.end());
+    return result;
+  }
+
+}  // namespace tuvx
@@ -0,0 +1,393 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <tuvx/model/batch_driver.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/util/internal_error.hpp>
+
+namespace tuvx
+{
+  /// @brief Configuration for AsyncCalculator
+  struct AsyncCalculatorConfig
+  {
+    /// Worker threads, each with its own copy of the model
+    std::size_t n_workers{ 1 };
+
+    /// Requests that may wait in the queue; Submit() blocks while it is full
+    std::size_t queue_capacity{ 4 };
+  };
+
+  /// @brief How an asynchronous request ended
+  enum class AsyncStatus
+  {
+    Completed,  ///< Every column was calculated
+    Cancelled,  ///< Cancelled before or while running, or submitted while the calculator was shutting down
+    Failed      ///< A column raised an error, which the future rethrows; later columns were not written
+  };
+
+  /// @brief Outcome of one asynchronous request
+  struct AsyncResult
+  {
+    AsyncStatus status{ AsyncStatus::Completed };
+
+    /// Columns whose rates were written, in batch order
+    std::size_t columns_completed{ 0 };
+  };
+
+  /// @brief Called on the worker thread when a request finishes, before its future becomes ready
+  ///
+  /// Runs for every request, including failed and cancelled ones. The
+  /// callback must not throw and should return quickly, since the worker
+  /// takes no other request while it runs.
+  using AsyncCallback = std::function<void(const AsyncResult&)>;
+
+  namespace detail
+  {
+    /// State shared by a queued request and its ticket
+    struct AsyncRequest
+    {
+      ColumnBatchView batch;
+      RateBatchView rates;
+      AsyncCallback callback;
+      std::promise<AsyncResult> promise;
+      std::atomic<bool> cancelled{ false };
+    };
+  }  // namespace detail
+
+  /// @brief Handle to a submitted request
+  class AsyncTicket
+  {
+   public:
+    AsyncTicket(std::future<AsyncResult> future, std::shared_ptr<detail::AsyncRequest> request)
+        : future_(std::move(future)),
+          request_(std::move(request))
+    {
+    }
+
+    /// @brief Future that becomes ready when the request finishes
+    ///
+    /// Errors raised while calculating are rethrown by get().
+    std::future<AsyncResult>& Future()
+    {
+      return future_;
+    }
+
+    /// @brief Wait for the request and return its outcome
+    AsyncResult Get()
+    {
+      return future_.get();
+    }
+
+    /// @brief Ask the request to stop
+    ///
+    /// A queued request finishes without calculating; a running one stops
+    /// before its next column. Columns already written are left in place.
+    void Cancel()
+    {
+      request_->cancelled.store(true, std::memory_order_relaxed);
+    }
+
+   private:
+    std::future<AsyncResult> future_;
+    std::shared_ptr<detail::AsyncRequest> request_;
+  };
+
+  /// @brief Calculates batches on background threads so the host can overlap other work
+  ///
+  /// Submit() queues a batch and returns at once with a ticket whose future
+  /// becomes ready when the batch's rates have been written. Requests run on
+  /// dedicated worker threads, each with a copy of the model made at
+  /// construction, so changes made to the model afterwards are not seen.
+  /// The queue is bounded: Submit() blocks while it is full and TrySubmit()
+  /// returns nothing instead, which keeps a fast producer from queueing
+  /// unbounded work.
+  ///
+  /// Rates are bit-identical to BatchDriver. Input and output arrays are not
+  /// copied and must stay valid, and unmodified, until the request finishes.
+  ///
+  /// Destroying the calculator cancels queued requests and waits for running
+  /// ones. Requests submitted while it is being destroyed finish at once as
+  /// cancelled.
+  ///
+  /// Example usage:
+  /// @code
+  /// AsyncCalculator async(model);
+  /// auto ticket = async.Submit(next_block, next_rates);
+  /// host.RunChemistry(current_block);
+  /// ticket.Get();
+  /// @endcode
+  class AsyncCalculator
+  {
+   public:
+    /// @brief Create a calculator and start its workers
+    /// @param model Model with grids, radiators and reactions set up (copied once per worker; must outlive
+    ///              the calculator, which checks submitted batches against its grids)
+    /// @param config Worker and queue sizes
+    /// @throws std::invalid_argument if n_workers or queue_capacity is zero
+    /// @throws Whatever copying the model throws on a worker; the other workers are stopped first
+    explicit AsyncCalculator(const TuvModel& model, AsyncCalculatorConfig config = {})
+        : config_(config),
+          reference_(model)
+    {
+      if (config_.n_workers == 0 || config_.queue_capacity == 0)
+      {
+        TUVX_THROW(std::invalid_argument("AsyncCalculator needs at least one worker and one queue slot"));
+      }
+      workers_.reserve(config_.n_workers);
+      for (std::size_t w = 0; w < config_.n_workers; ++w)
+      {
+        workers_.emplace_back([this, &model] { WorkerLoop(model); });
+      }
+      std::exception_ptr error;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ready_cv_.wait(lock, [this] { return workers_ready_ == workers_.size(); });
+        error = startup_error_;
+        stop_ = error != nullptr;
+      }
+      if (error)
+      {
+        work_cv_.notify_all();
+        for (auto& worker : workers_)
+        {
+          worker.join();
+        }
+#if TUVX_EXCEPTIONS
+        std::rethrow_exception(error);
+#endif
+      }
+    }
+
+    AsyncCalculator(const AsyncCalculator&) = delete;
+    AsyncCalculator& operator=(const AsyncCalculator&) = delete;
+
+    ~AsyncCalculator()
+    {
+      std::deque<std::shared_ptr<detail::AsyncRequest>> pending;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+        pending.swap(queue_);
+      }
+      work_cv_.notify_all();
+      space_cv_.notify_all();
+      for (auto& request : pending)
+      {
+        Finish(*request, { AsyncStatus::Cancelled, 0 });
+      }
+      for (auto& worker : workers_)
+      {
+        worker.join();
+      }
+    }
+
+    /// @brief Configuration in use
+    const AsyncCalculatorConfig& Config() const
+    {
+      return config_;
+    }
+
+    /// @brief Queue a batch, waiting while the queue is full
+    /// @param batch Column inputs (must outlive the request)
+    /// @param rates Destination for J-values (must outlive the request)
+    /// @param callback Optional callable run on the worker thread when the request finishes
+    /// @throws TuvxInternalException if the batch does not match the model grids
+    AsyncTicket Submit(const ColumnBatchView& batch, const RateBatchView& rates, AsyncCallback callback = {})
+    {
+      auto request = MakeRequest(batch, rates, std::move(callback));
+      auto future = request->promise.get_future();
+      bool queued = false;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        space_cv_.wait(lock, [this] { return stop_ || queue_.size() < config_.queue_capacity; });
+        if (!stop_)
+        {
+          queue_.push_back(request);
+          queued = true;
+        }
+      }
+      if (!queued)
+      {
+        // No worker will take it
+        request->cancelled.store(true, std::memory_order_relaxed);
+        Finish(*request, { AsyncStatus::Cancelled, 0 });
+        return AsyncTicket(std::move(future), std::move(request));
+      }
+      work_cv_.notify_one();
+      return AsyncTicket(std::move(future), std::move(request));
+    }
+
+    /// @brief Queue a batch if there is room
+    /// @return The ticket, or nothing if the queue is full or the calculator is shutting down
+    /// @throws TuvxInternalException if the batch does not match the model grids
+    std::optional<AsyncTicket>
+    TrySubmit(const ColumnBatchView& batch, const RateBatchView& rates, AsyncCallback callback = {})
+    {
+      auto request = MakeRequest(batch, rates, std::move(callback));
+      auto future = request->promise.get_future();
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stop_ || queue_.size() >= config_.queue_capacity)
+        {
+          return std::nullopt;
+        }
+        queue_.push_back(request);
+      }
+      work_cv_.notify_one();
+      return AsyncTicket(std::move(future), std::move(request));
+    }
+
+    /// @brief Number of requests waiting for a worker
+    std::size_t Queued() const
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return queue_.size();
+    }
+
+   private:
+    std::shared_ptr<detail::AsyncRequest>
+    MakeRequest(const ColumnBatchView& batch, const RateBatchView& rates, AsyncCallback callback) const
+    {
+      if (batch.n_columns > 0)
+      {
+        detail::CheckBatch(reference_, batch, rates);
+      }
+      auto request = std::make_shared<detail::AsyncRequest>();
+      request->batch = batch;
+      request->rates = rates;
+      request->callback = std::move(callback);
+      return request;
+    }
+
+    /// @brief Run the callback and fulfil the promise
+    /// @param request Finished request
+    /// @param result Outcome passed to the callback, and to the future unless there is an error
+    /// @param error Error the future rethrows instead of returning the result
+    static void Finish(detail::AsyncRequest& request, const AsyncResult& result, std::exception_ptr error = nullptr)
+    {
+      if (request.callback)
+      {
+        request.callback(result);
+      }
+      if (error)
+      {
+        request.promise.set_exception(error);
+      }
+      else
+      {
+        request.promise.set_value(result);
+      }
+    }
+
+    /// @brief Calculate a request's columns until done or cancelled
+    static void Run(TuvModel& model, detail::AsyncRequest& request)
+    {
+      const ColumnBatchView& batch = request.batch;
+      const RateBatchView& rates = request.rates;
+      AsyncResult result;
+#if TUVX_EXCEPTIONS
+      try
+      {
+#endif
+        for (std::size_t c = 0; c < batch.n_columns; ++c)
+        {
+          if (request.cancelled.load(std::memory_order_relaxed))
+          {
+            result.status = AsyncStatus::Cancelled;
+            break;
+          }
+          model.CalculatePhotolysisRates(
+              detail::BatchColumn(model, batch, c),
+              rates.data + static_cast<std::ptrdiff_t>(c) * rates.column_stride,
+              rates.reaction_stride,
+              rates.level_stride);
+          ++result.columns_completed;
+        }
+#if TUVX_EXCEPTIONS
+      }
+      catch (...)
+      {
+        result.status = AsyncStatus::Failed;
+        Finish(request, result, std::current_exception());
+        return;
+      }
+#endif
+      Finish(request, result);
+    }
+
+    void WorkerLoop(const TuvModel& model)
+    {
+      // Copied on the worker so its memory is local to the worker's NUMA node
+      std::optional<TuvModel> replica;
+#if TUVX_EXCEPTIONS
+      try
+      {
+        replica.emplace(model);
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!startup_error_)
+        {
+          startup_error_ = std::current_exception();
+        }
+      }
+#else
+      replica.emplace(model);
+#endif
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++workers_ready_;
+      }
+      ready_cv_.notify_one();
+      if (!replica)
+      {
+        return;
+      }
+
+      for (;;)
+      {
+        std::shared_ptr<detail::AsyncRequest> request;
+        {
+          std::unique_lock<std::mutex> lock(mutex_);
+          work_cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+          if (queue_.empty())
+          {
+            return;
+          }
+          request = std::move(queue_.front());
+          queue_.pop_front();
+        }
+        space_cv_.notify_one();
+        Run(*replica, *request);
+      }
+    }
+
+    AsyncCalculatorConfig config_;
+    const TuvModel& reference_;
+    std::vector<std::thread> workers_;
+    std::size_t workers_ready_{ 0 };
+    std::exception_ptr startup_error_;
+    std::deque<std::shared_ptr<detail::AsyncRequest>> queue_;
+    bool stop_{ false };
+    mutable std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable space_cv_;
+    std::condition_variable ready_cv_;
+  };
+
+}  // namespace tuvx
@@ -0,0 +1,461 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <tuvx/cross_section/types/band.hpp>
+#include <tuvx/model/column_state.hpp>
+#include <tuvx/model/differential_harness.hpp>
+#include <tuvx/model/model_config.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/quantum_yield/types/base.hpp>
+#include <tuvx/radiator/radiator_state.hpp>
+#include <tuvx/radiator/radiator_warehouse.hpp>
+#include <tuvx/radiator/types/from_cross_section.hpp>
+#include <tuvx/util/internal_error.hpp>
+
+namespace tuvx
+{
+  /// @brief Options for deriving a coarse band grid from a fine model
+  struct BandAggregationConfig
+  {
+    /// Number of bands the fine wavelength grid is merged into
+    std::size_t n_bands{ 18 };
+
+    /// Temperatures the effective cross-sections are tabulated at [K], ascending
+    std::vector<double> temperatures{ 180.0, 200.0, 220.0, 240.0, 260.0, 280.0, 300.0, 320.0 };
+
+    /// Multiples of the vertical column optical depth at which the direct-beam
+    /// transmission of each fine bin is sampled. They stand in for the slant
+    /// paths to the different levels and solar zenith angles.
+    std::vector<double> attenuation_scales{ 0.01, 0.03, 0.1, 0.3, 1.0, 3.0 };
+
+    /// Weight of the solar flux alone, relative to one reaction's J-value, so
+    /// bins that no reaction absorbs in still shape the radiation field
+    double flux_weight{ 0.05 };
+  };
+
+  /// @brief Accuracy and cost of a band grid against its fine grid
+  struct BandAccuracyReport
+  {
+    std::size_t n_fine_bins{ 0 };
+    std::size_t n_bands{ 0 };
+    std::size_t n_columns{ 0 };
+
+    /// Per-reaction error of the band J-values over all columns and levels
+    std::vector<DifferentialReactionError> reactions;
+
+    /// Wall time for all columns on each grid [s]
+    double fine_seconds{ 0.0 };
+    double band_seconds{ 0.0 };
+
+    /// @brief Fine time over band time
+    double Speedup() const
+    {
+      return band_seconds > 0.0 ? fine_seconds / band_seconds : 0.0;
+    }
+
+    /// @brief Largest relative error of any reaction
+    double MaxRelativeError() const
+    {
+      double max_error = 0.0;
+      for (const auto& reaction : reactions)
+      {
+        max_error = std::max(max_error, reaction.max_relative_error);
+      }
+      return max_error;
+    }
+
+    /// @brief Grid sizes, timings and one line per reaction
+    std::string Summary() const
+    {
+      std::ostringstream out;
+      out << n_fine_bins << " bins -> " << n_bands << " bands over " << n_columns << " columns: " << fine_seconds
+          << " s -> " << band_seconds << " s (" << Speedup() << "x)\n";
+      for (const auto& reaction : reactions)
+      {
+        out << "  " << reaction.reaction_name << ": max " << reaction.max_relative_error << ", rms "
+            << reaction.rms_relative_error << " over " << reaction.n_values << " values\n";
+      }
+      return out.str();
+    }
+  };
+
+  namespace detail
+  {
+    /// @brief Merge adjacent bins until n_bands remain, by Ward's criterion
+    /// @param features Feature vector of each bin
+    /// @param weights Weight of each bin
+    /// @param n_bands Number of bands to keep
+    /// @return Index of the first bin of each band, followed by the bin count
+    ///
+    /// Each step merges the adjacent pair whose merge adds the least weighted
+    /// within-band variance, w_a w_b / (w_a + w_b) |f_a - f_b|^2, so bands
+    /// form where the features are nearly constant and heavily weighted bins
+    /// stay resolved.
+    inline std::vector<std::size_t>
+    MergeBands(std::vector<std::vector<double>> features, std::vector<double> weights, std::size_t n_bands)
+    {
+      std::size_t n_bins = features.size();
+      std::vector<std::size_t> starts(n_bins);
+      std::iota(starts.begin(), starts.end(), std::size_t{ 0 });
+
+      auto cost = [&](std::size_t a)
+      {
+        double total = weights[a] + weights[a + 1];
+        if (total <= 0.0)
+        {
+          return 0.0;
+        }
+        double distance = 0.0;
+        for (std::size_t f = 0; f < features[a].size(); ++f)
+        {
+          double difference = features[a][f] - features[a + 1][f];
+          distance += difference * difference;
+        }
+        return weights[a] * weights[a + 1] / total * distance;
+      };
+
+      while (starts.size() > std::max<std::size_t>(n_bands, 1))
+      {
+        std::size_t best = 0;
+        double best_cost = std::numeric_limits<double>::infinity();
+        for (std::size_t a = 0; a + 1 < starts.size(); ++a)
+        {
+          double c = cost(a);
+          if (c < best_cost)
+          {
+            best = a;
+            best_cost = c;
+          }
+        }
+
+        // Merged band carries the weighted mean features
+        double total = weights[best] + weights[best + 1];
+        for (std::size_t f = 0; f < features[best].size(); ++f)
+        {
+          features[best][f] = total > 0.0 ? (weights[best] * features[best][f] + weights[best + 1] * features[best + 1][f]) / total
+                                           : 0.5 * (features[best][f] + features[best + 1][f]);
+        }
+        weights[best] = total;
+        starts.erase(starts.begin() + static_cast<std::ptrdiff_t>(best + 1));
+        features.erase(features.begin() + static_cast<std::ptrdiff_t>(best + 1));
+        weights.erase(weights.begin() + static_cast<std::ptrdiff_t>(best + 1));
+      }
+      starts.push_back(n_bins);
+      return starts;
+    }
+  }  // namespace detail
+
+  /// @brief Coarse band version of a model with flux-weighted effective cross-sections
+  ///
+  /// In the spirit of Fast-J, a fine wavelength grid is merged into a few
+  /// bands chosen so the direct-beam transmission is nearly uniform inside
+  /// each band, weighted by where the registered reactions take their
+  /// J-values from. Within a band the effective σ·φ of each reaction is its
+  /// flux-weighted mean, Σ F σ φ Δλ / Σ F Δλ, tabulated at
+  /// BandAggregationConfig::temperatures, so J-values at the top of the
+  /// atmosphere are reproduced exactly. Absorbing radiators (the
+  /// FromCrossSectionRadiator ones, e.g. O3 and O2) get effective
+  /// cross-sections weighted the same way as the bands; other radiators,
+  /// such as Rayleigh and aerosol, are copied and evaluated at the band
+  /// midpoints. The extraterrestrial flux is the band mean.
+  ///
+  /// Model() is an ordinary TuvModel on the band grid: it owns nothing the
+  /// fine model needs, and can be copied, batched or run under an
+  /// ExecutionPlan. Its effective cross-sections live in this object, which
+  /// must outlive it and its copies. Quantum yields that depend on air
+  /// density are evaluated as the fine model's rate calculator does, at the
+  /// temperature alone.
+  ///
+  /// Example usage:
+  /// @code
+  /// BandAggregation bands(fine_model);
+  /// auto report = bands.Evaluate(fine_model, 200, 42);
+  /// std::cout << report.Summary();
+  /// bands.Model().CalculatePhotolysisRates(column, rates, reaction_stride, level_stride);
+  /// @endcode
+  class BandAggregation
+  {
+   public:
+    /// @brief Derive the band grid and build the band model
+    /// @param fine_model Model on the fine grid, with its radiators and reactions
+    /// @param config Aggregation options
+    /// @throws std::invalid_argument if no bands are requested or the temperatures are not ascending
+    explicit BandAggregation(const TuvModel& fine_model, BandAggregationConfig config = BandAggregationConfig{})
+        : config_(std::move(config)),
+          unit_yield_(std::make_unique<ConstantQuantumYield>("band", "", "", 1.0))
+    {
+      if (config_.n_bands == 0 || config_.temperatures.empty() ||
+          !std::is_sorted(config_.temperatures.begin(), config_.temperatures.end()))
+      {
+        TUVX_THROW(std::invalid_argument("Band aggregation needs at least one band and ascending temperatures"));
+      }
+
+      TuvModel reference(fine_model);
+      reference.PrepareComponents();
+      const Grid& grid = reference.WavelengthGrid();
+      std::size_t n_bins = grid.Spec().n_cells;
+      auto deltas = grid.Deltas();
+      const auto& flux = reference.ExtraterrestrialFlux();
+
+      // Photons per fine bin
+      std::vector<double> bin_flux(n_bins);
+      for (std::size_t i = 0; i < n_bins; ++i)
+      {
+        bin_flux[i] = flux[i] * std::abs(deltas[i]);
+      }
+      double total_flux = std::accumulate(bin_flux.begin(), bin_flux.end(), 0.0);
+
+      // σ·φ of each reaction at each table temperature [reaction][temperature][bin]
+      const auto& reactions = reference.PhotolysisReactions();
+      std::vector<std::vector<std::vector<double>>> yields(reactions.Size());
+      for (std::size_t r = 0; r < reactions.Size(); ++r)
+      {
+        const auto& reaction = reactions.Get(r);
+        for (double temperature : config_.temperatures)
+        {
+          std::vector<double> product(n_bins, 0.0);
+          if (reaction.GetCrossSection() != nullptr && reaction.GetQuantumYield() != nullptr)
+          {
+            auto xs = reaction.GetCrossSection()->Calculate(grid, temperature);
+            auto qy = reaction.GetQuantumYield()->Calculate(grid, temperature);
+            for (std::size_t i = 0; i < n_bins; ++i)
+            {
+              product[i] = xs[i] * qy[i];
+            }
+          }
+          yields[r].push_back(std::move(product));
+        }
+      }
+
+      // Bin weight: share of each reaction's top-of-atmosphere J, plus a little flux
+      std::size_t middle = config_.temperatures.size() / 2;
+      std::vector<double> weights(n_bins, 0.0);
+      for (std::size_t r = 0; r < yields.size(); ++r)
+      {
+        double j = 0.0;
+        for (std::size_t i = 0; i < n_bins; ++i)
+        {
+          j += bin_flux[i] * yields[r][middle][i];
+        }
+        for (std::size_t i = 0; j > 0.0 && i < n_bins; ++i)
+        {
+          weights[i] += bin_flux[i] * yields[r][middle][i] / j;
+        }
+      }
+      for (std::size_t i = 0; total_flux > 0.0 && i < n_bins; ++i)
+      {
+        weights[i] += config_.flux_weight * bin_flux[i] / total_flux;
+      }
+
+      // Features: direct-beam transmission at several multiples of the column optical depth
+      RadiatorWarehouse radiators = reference.Radiators().Clone();
+      radiators.UpdateAll(reference.GetGridWarehouse(), reference.CreateProfileWarehouse());
+      RadiatorState state = radiators.CombinedState();
+      std::vector<std::vector<double>> features(n_bins);
+      for (std::size_t i = 0; i < n_bins; ++i)
+      {
+        double column = 0.0;
+        for (std::size_t l = 0; l < state.NumberOfLayers(); ++l)
+        {
+          column += state.optical_depth[l][i];
+        }
+        for (double scale : config_.attenuation_scales)
+        {
+          features[i].push_back(std::exp(-scale * column));
+        }
+      }
+
+      band_starts_ = detail::MergeBands(std::move(features), weights, config_.n_bands);
+      std::size_t n_bands = band_starts_.size() - 1;
+      auto edges = grid.Edges();
+      for (std::size_t start : band_starts_)
+      {
+        band_edges_.push_back(edges[start]);
+      }
+
+      // Band means weighted by w, or plain means where w vanishes
+      auto band_mean = [&](const std::vector<double>& values, const std::vector<double>& w)
+      {
+        std::vector<double> means(n_bands, 0.0);
+        for (std::size_t b = 0; b < n_bands; ++b)
+        {
+          double sum = 0.0;
+          double weight = 0.0;
+          for (std::size_t i = band_starts_[b]; i < band_starts_[b + 1]; ++i)
+          {
+            sum += w[i] * values[i];
+            weight += w[i];
+          }
+          if (weight > 0.0)
+          {
+            means[b] = sum / weight;
+          }
+          else
+          {
+            means[b] = std::accumulate(values.begin() + static_cast<std::ptrdiff_t>(band_starts_[b]),
+                                       values.begin() + static_cast<std::ptrdiff_t>(band_starts_[b + 1]),
+                                       0.0) /
+                       static_cast<double>(band_starts_[b + 1] - band_starts_[b]);
+          }
+        }
+        return means;
+      };
+
+      // Band model: same configuration on the band grid
+      ModelConfig band_config = reference.Config();
+      band_config.wavelength_edges = band_edges_;
+      if (!band_config.surface_albedo_spectrum.empty())
+      {
+        band_config.surface_albedo_spectrum = band_mean(band_config.surface_albedo_spectrum, bin_flux);
+      }
+      band_model_.SetConfig(band_config);
+      if (reference.GetSolver() != nullptr)
+      {
+        band_model_.SetSolver(reference.GetSolver()->Clone());
+      }
+
+      for (const auto& name : reference.Radiators().Names())
+      {
+        const Radiator& radiator = reference.Radiators().Get(name);
+        const auto* absorber = dynamic_cast<const FromCrossSectionRadiator*>(&radiator);
+        if (absorber == nullptr)
+        {
+          band_model_.AddRadiator(radiator);
+          continue;
+        }
+        std::vector<std::vector<double>> table;
+        for (double temperature : config_.temperatures)
+        {
+          table.push_back(band_mean(absorber->GetCrossSection().Calculate(grid, temperature), weights));
+        }
+        band_model_.AddRadiator(FromCrossSectionRadiator(
+            name,
+            std::make_unique<BandCrossSection>(name, config_.temperatures, std::move(table)),
+            absorber->DensityProfileName()));
+      }
+
+      for (std::size_t r = 0; r < reactions.Size(); ++r)
+      {
+        std::vector<std::vector<double>> table;
+        for (const auto& product : yields[r])
+        {
+          table.push_back(band_mean(product, bin_flux));
+        }
+        const std::string& name = reactions.Get(r).ReactionName();
+        cross_sections_.push_back(std::make_unique<BandCrossSection>(name, config_.temperatures, std::move(table)));
+        band_model_.AddPhotolysisReaction(name, cross_sections_.back().get(), unit_yield_.get());
+      }
+
+      std::vector<double> band_flux(n_bands, 0.0);
+      for (std::size_t b = 0; b < n_bands; ++b)
+      {
+        for (std::size_t i = band_starts_[b]; i < band_starts_[b + 1]; ++i)
+        {
+          band_flux[b] += bin_flux[i];
+        }
+        band_flux[b] /= std::abs(band_edges_[b + 1] - band_edges_[b]);
+      }
+      band_model_.SetExtraterrestrialFlux(std::move(band_flux));
+      band_model_.PrepareComponents();
+    }
+
+    BandAggregation(const BandAggregation&) = delete;
+    BandAggregation& operator=(const BandAggregation&) = delete;
+    BandAggregation(BandAggregation&&) = default;
+    BandAggregation& operator=(BandAggregation&&) = default;
+
+    /// @brief Model on the band grid
+    TuvModel& Model()
+    {
+      return band_model_;
+    }
+
+    /// @brief Model on the band grid
+    const TuvModel& Model() const
+    {
+      return band_model_;
+    }
+
+    /// @brief Number of bands
+    std::size_t NumberOfBands() const
+    {
+      return band_edges_.size() - 1;
+    }
+
+    /// @brief Band edges [nm]; a subset of the fine grid's edges
+    const std::vector<double>& BandEdges() const
+    {
+      return band_edges_;
+    }
+
+    /// @brief First fine bin of each band, followed by the fine bin count
+    const std::vector<std::size_t>& BandStarts() const
+    {
+      return band_starts_;
+    }
+
+    /// @brief Effective σ·φ of a reaction, in the fine model's reaction order
+    /// @param reaction Reaction index
+    const BandCrossSection& EffectiveCrossSection(std::size_t reaction) const
+    {
+      return *cross_sections_.at(reaction);
+    }
+
+    /// @brief Compare band J-values with the fine model on random columns
+    /// @param fine_model Model the bands were derived from
+    /// @param n_columns Number of columns
+    /// @param seed Seed for DifferentialColumnGenerator; aerosol draws are ignored
+    /// @param relative_floor Errors are relative to at least this fraction of
+    ///        the column's largest J for the reaction, so levels where a
+    ///        reaction is switched off do not dominate
+    /// @return Errors and the wall time of each grid
+    /// @throws std::invalid_argument if the fine model's altitude grid or reactions differ
+    BandAccuracyReport
+    Evaluate(const TuvModel& fine_model, std::size_t n_columns, std::uint64_t seed, double relative_floor = 1.0e-3) const
+    {
+      TuvModel fine(fine_model);
+      TuvModel band(band_model_);
+      fine.PrepareComponents();
+      std::size_t n_reactions = band.PhotolysisReactions().Size();
+      std::size_t n_levels = band.AltitudeGrid().Spec().n_cells + 1;
+      if (fine.PhotolysisReactions().Size() != n_reactions || fine.AltitudeGrid().Spec().n_cells + 1 != n_levels)
+      {
+        TUVX_THROW(std::invalid_argument("Band aggregation evaluated against a different model"));
+      }
+
+      auto columns = detail::RandomColumns(band, n_columns, seed);
+      BandAccuracyReport report;
+      report.n_fine_bins = fine.WavelengthGrid().Spec().n_cells;
+      report.n_bands = NumberOfBands();
+      report.n_columns = n_columns;
+      std::vector<double> fine_rates;
+      std::vector<double> band_rates;
+      report.fine_seconds = detail::TimeBulkColumns(fine, columns, fine_rates);
+      report.band_seconds = detail::TimeBulkColumns(band, columns, band_rates);
+      report.reactions = detail::CompareBulkRates(
+          band.PhotolysisReactions().ReactionNames(), fine_rates, band_rates, n_columns, n_levels, relative_floor);
+      return report;
+    }
+
+   private:
+    BandAggregationConfig config_;
+    std::vector<std::size_t> band_starts_;
+    std::vector<double> band_edges_;
+    std::unique_ptr<ConstantQuantumYield> unit_yield_;
+    std::vector<std::unique_ptr<BandCrossSection>> cross_sections_;
+    TuvModel band_model_;
+  };
+
+}  // namespace tuvx
@@ -0,0 +1,484 @@
+#pragma once
+
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <tuvx/model/column_state.hpp>
+#include <tuvx/model/result_cache.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/util/hash.hpp>
+#include <tuvx/util/internal_error.hpp>
+#include <tuvx/util/strided_view.hpp>
+#include <tuvx/util/thread_pool.hpp>
+
+namespace tuvx
+{
+  /// @brief Strided view of one profile for every column in a batch
+  ///
+  /// Layer l of column c lives at data[c * column_stride + l * layer_stride].
+  /// A null data pointer means the profile is not provided by the batch.
+  struct ProfileBatchView
+  {
+    const double* data{ nullptr };
+    std::ptrdiff_t column_stride{ 0 };
+    std::ptrdiff_t layer_stride{ 1 };
+
+    /// @brief Get the view of one column's profile
+    /// @param column Column index
+    /// @param n_layers Number of layers
+    StridedView<const double> Column(std::size_t column, std::size_t n_layers) const
+    {
+      if (data == nullptr)
+      {
+        return {};
+      }
+      return StridedView<const double>(data + static_cast<std::ptrdiff_t>(column) * column_stride, n_layers, layer_stride);
+    }
+  };
+
+  /// @brief Strided view of host-owned inputs for a batch of columns
+  struct ColumnBatchView
+  {
+    /// Number of columns in the batch
+    std::size_t n_columns{ 0 };
+
+    /// Number of layers per column (must match the model altitude grid)
+    std::size_t n_layers{ 0 };
+
+    /// Solar zenith angle for each column [degrees]
+    StridedView<const double> solar_zenith_angle{};
+
+    /// Surface albedo for each column; if empty, the model's configured albedo is used
+    StridedView<const double> surface_albedo{};
+
+    /// Temperature profiles [K]
+    ProfileBatchView temperature{};
+
+    /// Air density profiles [molecules/cm³]
+    ProfileBatchView air_density{};
+
+    /// Ozone density profiles [molecules/cm³]
+    ProfileBatchView ozone{};
+  };
+
+  /// @brief Strided view of a host-owned photolysis rate array for a batch
+  ///
+  /// J for column c, reaction r and level l is written to
+  /// data[c * column_stride + r * reaction_stride + l * level_stride].
+  struct RateBatchView
+  {
+    double* data{ nullptr };
+    std::ptrdiff_t column_stride{ 0 };
+    std::ptrdiff_t reaction_stride{ 0 };
+    std::ptrdiff_t level_stride{ 1 };
+  };
+
+  namespace detail
+  {
+    /// @brief Check that a batch matches a model's grids
+    /// @throws TuvxInternalException if it does not
+    inline void CheckBatch(const TuvModel& model, const ColumnBatchView& batch, const RateBatchView& rates)
+    {
+      if (batch.n_layers != model.AltitudeGrid().Spec().n_cells)
+      {
+        TUVX_INTERNAL_ERROR("Batch layer count does not match altitude grid");
+      }
+      if (batch.solar_zenith_angle.Size() < batch.n_columns)
+      {
+        TUVX_INTERNAL_ERROR("Batch solar zenith angles do not cover all columns");
+      }
+      if (!batch.surface_albedo.Empty() && batch.surface_albedo.Size() < batch.n_columns)
+      {
+        TUVX_INTERNAL_ERROR("Batch surface albedos do not cover all columns");
+      }
+      if (rates.data == nullptr && model.PhotolysisReactions().Size() > 0)
+      {
+        TUVX_INTERNAL_ERROR("Batch rate array is null");
+      }
+    }
+
+    /// @brief Get the view of one column in a batch
+    inline ColumnView BatchColumn(const TuvModel& model, const ColumnBatchView& batch, std::size_t column)
+    {
+      ColumnView view;
+      view.solar_zenith_angle = batch.solar_zenith_angle[column];
+      view.surface_albedo = batch.surface_albedo.Empty() ? model.Config().surface_albedo : batch.surface_albedo[column];
+      view.temperature = batch.temperature.Column(column, batch.n_layers);
+      view.air_density = batch.air_density.Column(column, batch.n_layers);
+      view.ozone = batch.ozone.Column(column, batch.n_layers);
+      return view;
+    }
+
+    /// @brief Hash the bit patterns of a column's inputs
+    inline std::uint64_t HashColumn(const ColumnView& column)
+    {
+      std::uint64_t hash = HashCombine(kHashSeed, column.solar_zenith_angle);
+      hash = HashCombine(hash, column.surface_albedo);
+      hash = HashCombine(hash, column.temperature);
+      hash = HashCombine(hash, column.air_density);
+      return HashCombine(hash, column.ozone);
+    }
+
+    /// @brief Whether two strided views hold the same bit patterns
+    inline bool SameValues(const StridedView<const double>& a, const StridedView<const double>& b)
+    {
+      if (a.Size() != b.Size())
+      {
+        return false;
+      }
+      for (std::size_t i = 0; i < a.Size(); ++i)
+      {
+        if (std::bit_cast<std::uint64_t>(a[i]) != std::bit_cast<std::uint64_t>(b[i]))
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    /// @brief Whether two columns have bit-identical inputs
+    inline bool SameColumn(const ColumnView& a, const ColumnView& b)
+    {
+      return std::bit_cast<std::uint64_t>(a.solar_zenith_angle) == std::bit_cast<std::uint64_t>(b.solar_zenith_angle) &&
+             std::bit_cast<std::uint64_t>(a.surface_albedo) == std::bit_cast<std::uint64_t>(b.surface_albedo) &&
+             SameValues(a.temperature, b.temperature) && SameValues(a.air_density, b.air_density) &&
+             SameValues(a.ozone, b.ozone);
+    }
+  }  // namespace detail
+
+  /// @brief Instrumentation of one BatchDriver::Calculate() call
+  struct BatchStats
+  {
+    /// Columns in the batch
+    std::size_t n_columns{ 0 };
+
+    /// Columns actually solved (the unique columns when deduplicating)
+    std::size_t n_solved{ 0 };
+
+    /// Time spent hashing and grouping columns [s]
+    double hash_seconds{ 0.0 };
+
+    /// Time for the whole call [s]
+    double total_seconds{ 0.0 };
+
+    /// @brief Columns per solved column (1 when nothing was deduplicated)
+    double DedupeRatio() const
+    {
+      return n_solved == 0 ? 1.0 : static_cast<double>(n_columns) / static_cast<double>(n_solved);
+    }
+  };
+
+  /// @brief How BatchDriver hands columns to pool threads
+  enum class BatchSchedule
+  {
+    /// Columns are handed out one at a time to whichever thread is free
+    Dynamic,
+    /// Thread w computes the contiguous block StaticBlock(n_columns, w, pool size),
+    /// matching the first-touch layout of NumaBatchBuffers
+    Static
+  };
+
+  /// @brief Drives a configured TuvModel over a batch of columns
+  ///
+  /// BatchDriver reads column inputs directly from host arrays and writes
+  /// photolysis rates directly into a host array, so one call covers an
+  /// entire batch with no per-column marshalling through ModelOutput.
+  ///
+  /// Example usage:
+  /// @code
+  /// ColumnBatchView batch;
+  /// batch.n_columns = n_columns;
+  /// batch.n_layers = n_layers;
+  /// batch.solar_zenith_angle = StridedView<const double>(sza.data(), n_columns);
+  /// batch.temperature = { temperature.data(), n_layers, 1 };
+  ///
+  /// RateBatchView rates{ j.data(), n_reactions * n_levels, n_levels, 1 };
+  /// BatchDriver(model).Calculate(batch, rates);
+  /// @endcode
+  ///
+  /// Given a ThreadPool, columns are distributed across threads, each running
+  /// its own copy of the model. Every column is computed by the same code
+  /// with the same fixed-order reductions, so the rates are bit-identical for
+  /// any number of threads.
+  class BatchDriver
+  {
+   public:
+    /// @brief Construct a driver for a configured model
+    /// @param model Model with grids, radiators and reactions set up (must outlive the driver)
+    explicit BatchDriver(TuvModel& model)
+        : model_(model)
+    {
+    }
+
+    /// @brief Construct a driver that spreads columns across a thread pool
+    /// @param model Model with grids, radiators and reactions set up (must outlive the driver)
+    /// @param pool Thread pool (must outlive the driver)
+    ///
+    /// The model is copied once per additional pool thread. Each copy is made
+    /// by the thread that will use it, so its memory is local to that thread's
+    /// NUMA node when the pool is pinned. Calculate() copies the model again
+    /// when its Generation() has changed since, so every thread always runs
+    /// the model's current configuration.
+    BatchDriver(TuvModel& model, ThreadPool& pool, BatchSchedule schedule = BatchSchedule::Dynamic)
+        : model_(model),
+          pool_(&pool),
+          schedule_(schedule)
+    {
+      BuildReplicas();
+    }
+
+    /// @brief How columns are distributed across pool threads
+    BatchSchedule Schedule() const
+    {
+      return schedule_;
+    }
+
+    /// @brief Set how columns are distributed across pool threads
+    void SetSchedule(BatchSchedule schedule)
+    {
+      schedule_ = schedule;
+    }
+
+    /// @brief Result cache consulted for every column, or nullptr
+    ResultCache* Cache() const
+    {
+      return cache_;
+    }
+
+    /// @brief Serve columns from a result cache when their quantized inputs were seen before
+    /// @param cache Cache shared by all pool threads (must outlive the driver), or nullptr to disable
+    ///
+    /// Keys are built from the model given at construction, so replicas share entries.
+    void SetCache(ResultCache* cache)
+    {
+      cache_ = cache;
+    }
+
+    /// @brief Whether bit-identical columns are solved once per batch
+    bool Deduplicate() const
+    {
+      return deduplicate_;
+    }
+
+    /// @brief Solve bit-identical columns once and copy their rates to the duplicates
+    /// @param deduplicate True to hash every column's inputs before solving
+    ///
+    /// Columns are compared bit for bit after the default albedo is applied,
+    /// so results are identical to a run without deduplication. With
+    /// BatchSchedule::Static the unique columns, not all columns, are split
+    /// into per-thread blocks.
+    void SetDeduplicate(bool deduplicate)
+    {
+      deduplicate_ = deduplicate;
+    }
+
+    /// @brief Instrumentation of the most recent Calculate()
+    const BatchStats& Stats() const
+    {
+      return stats_;
+    }
+
+    /// @brief Calculate photolysis rates for every column in a batch
+    /// @param batch Column inputs
+    /// @param rates Destination for J-values
+    /// @throws TuvxInternalException if the batch does not match the model grids
+    void Calculate(const ColumnBatchView& batch, const RateBatchView& rates)
+    {
+      stats_ = BatchStats{};
+      if (batch.n_columns == 0)
+      {
+        return;
+      }
+      detail::CheckBatch(model_, batch, rates);
+      auto start = std::chrono::steady_clock::now();
+      if (pool_ != nullptr && replica_generation_ != model_.Generation())
+      {
+        BuildReplicas();
+      }
+
+      // Columns to solve; with deduplication only the first of each set of identical columns
+      std::size_t n_solved = batch.n_columns;
+      if (deduplicate_)
+      {
+        FindUniqueColumns(batch);
+        n_solved = unique_.size();
+      }
+      auto solve_start = std::chrono::steady_clock::now();
+      auto column_index = [&](std::size_t i) { return deduplicate_ ? unique_[i] : i; };
+
+      auto calculate_column = [&](std::size_t i, std::size_t worker)
+      {
+        std::size_t c = column_index(i);
+        TuvModel& model = worker == 0 ? model_ : *replicas_[worker - 1];
+        ColumnView column = Column(batch, c);
+        double* column_rates = rates.data + static_cast<std::ptrdiff_t>(c) * rates.column_stride;
+        if (cache_ != nullptr)
+        {
+          cache_->CalculatePhotolysisRates(
+              cache_->MakeKey(model_, column), model, column, column_rates, rates.reaction_stride, rates.level_stride);
+          return;
+        }
+        model.CalculatePhotolysisRates(column, column_rates, rates.reaction_stride, rates.level_stride);
+      };
+
+      if (pool_ != nullptr && schedule_ == BatchSchedule::Static)
+      {
+        pool_->ForEachWorker(
+            [&](std::size_t worker)
+            {
+              auto [first, last] = StaticBlock(n_solved, worker, pool_->Size());
+              for (std::size_t i = first; i < last; ++i)
+              {
+                calculate_column(i, worker);
+              }
+            });
+      }
+      else if (pool_ != nullptr)
+      {
+        pool_->ParallelFor(n_solved, calculate_column);
+      }
+      else
+      {
+        for (std::size_t i = 0; i < n_solved; ++i)
+        {
+          calculate_column(i, 0);
+        }
+      }
+
+      if (deduplicate_)
+      {
+        ScatterDuplicates(batch, rates);
+      }
+      auto end = std::chrono::steady_clock::now();
+
+      stats_.n_columns = batch.n_columns;
+      stats_.n_solved = n_solved;
+      stats_.hash_seconds = std::chrono::duration<double>(solve_start - start).count();
+      stats_.total_seconds = std::chrono::duration<double>(end - start).count();
+    }
+
+    /// @brief Get the view of one column in a batch
+    /// @param batch Column inputs
+    /// @param column Column index
+    ColumnView Column(const ColumnBatchView& batch, std::size_t column) const
+    {
+      return detail::BatchColumn(model_, batch, column);
+    }
+
+   private:
+    static constexpr std::size_t kNoColumn = static_cast<std::size_t>(-1);
+
+    /// @brief Copy the model for every pool thread but the first, on the thread that uses the copy
+    void BuildReplicas()
+    {
+      replica_generation_ = model_.Generation();
+      replicas_.resize(pool_->Size() - 1);
+      pool_->ForEachWorker(
+          [&](std::size_t w)
+          {
+            if (w > 0)
+            {
+              replicas_[w - 1] = std::make_unique<TuvModel>(model_);
+            }
+          });
+    }
+
+    /// @brief Fill unique_ with the first column of each set of bit-identical columns
+    void FindUniqueColumns(const ColumnBatchView& batch)
+    {
+      std::size_t n_columns = batch.n_columns;
+      hashes_.resize(n_columns);
+      auto hash_column = [&](std::size_t c) { hashes_[c] = detail::HashColumn(Column(batch, c)); };
+      if (pool_ != nullptr)
+      {
+        pool_->ParallelFor(n_columns, hash_column);
+      }
+      else
+      {
+        for (std::size_t c = 0; c < n_columns; ++c)
+        {
+          hash_column(c);
+        }
+      }
+
+      // Columns sharing a hash are chained through next_with_hash_ and compared exactly
+      representative_.resize(n_columns);
+      next_with_hash_.assign(n_columns, kNoColumn);
+      unique_.clear();
+      first_with_hash_.clear();
+      first_with_hash_.reserve(n_columns);
+      for (std::size_t c = 0; c < n_columns; ++c)
+      {
+        auto [entry, inserted] = first_with_hash_.try_emplace(hashes_[c], c);
+        std::size_t candidate = entry->second;
+        representative_[c] = c;
+        while (!inserted)
+        {
+          if (detail::SameColumn(Column(batch, candidate), Column(batch, c)))
+          {
+            representative_[c] = candidate;
+            break;
+          }
+          if (next_with_hash_[candidate] == kNoColumn)
+          {
+            next_with_hash_[candidate] = c;
+            break;
+          }
+          candidate = next_with_hash_[candidate];
+        }
+        if (representative_[c] == c)
+        {
+          unique_.push_back(c);
+        }
+      }
+    }
+
+    /// @brief Copy each solved column's rates to its duplicates
+    void ScatterDuplicates(const ColumnBatchView& batch, const RateBatchView& rates) const
+    {
+      std::size_t n_reactions = model_.PhotolysisReactions().Size();
+      std::size_t n_levels = batch.n_layers + 1;
+      for (std::size_t c = 0; c < batch.n_columns; ++c)
+      {
+        std::size_t source = representative_[c];
+        if (source == c)
+        {
+          continue;
+        }
+        const double* from = rates.data + static_cast<std::ptrdiff_t>(source) * rates.column_stride;
+        double* to = rates.data + static_cast<std::ptrdiff_t>(c) * rates.column_stride;
+        for (std::size_t r = 0; r < n_reactions; ++r)
+        {
+          for (std::size_t l = 0; l < n_levels; ++l)
+          {
+            std::ptrdiff_t offset =
+                static_cast<std::ptrdiff_t>(r) * rates.reaction_stride + static_cast<std::ptrdiff_t>(l) * rates.level_stride;
+            to[offset] = from[offset];
+          }
+        }
+      }
+    }
+
+    TuvModel& model_;
+    ThreadPool* pool_{ nullptr };
+    BatchSchedule schedule_{ BatchSchedule::Dynamic };
+    ResultCache* cache_{ nullptr };
+    bool deduplicate_{ false };
+    BatchStats stats_;
+    std::vector<std::unique_ptr<TuvModel>> replicas_;
+    std::uint64_t replica_generation_{ 0 };
+
+    // Deduplication workspaces, reused across batches
+    std::vector<std::uint64_t> hashes_;
+    std::vector<std::size_t> representative_;
+    std::vector<std::size_t> next_with_hash_;
+    std::vector<std::size_t> unique_;
+    std::unordered_map<std::uint64_t, std::size_t> first_with_hash_;
+  };
+
+}  // namespace tuvx
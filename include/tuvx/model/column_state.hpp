@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <tuvx/util/strided_view.hpp>
+
+namespace tuvx
+{
+  /// @brief Read-only view of the per-column inputs to a model calculation
+  ///
+  /// ColumnView describes everything that varies from one atmospheric column
+  /// to the next while the model configuration (grids, radiators, reactions)
+  /// stays fixed. Profiles are strided views into caller-owned memory and are
+  /// given at layer midpoints, surface first.
+  ///
+  /// An empty profile view means "use the profile configured on the model"
+  /// (or the US Standard Atmosphere if none is configured).
+  struct ColumnView
+  {
+    /// Solar zenith angle [degrees]
+    double solar_zenith_angle{ 0.0 };
+
+    /// Uniform surface albedo [0-1], used when the model has no surface albedo spectrum
+    double surface_albedo{ 0.1 };
+
+    /// Temperature at layer midpoints [K]
+    StridedView<const double> temperature{};
+
+    /// Air number density at layer midpoints [molecules/cm³]
+    StridedView<const double> air_density{};
+
+    /// Ozone number density at layer midpoints [molecules/cm³]
+    StridedView<const double> ozone{};
+  };
+
+  /// @brief Owning container for the per-column inputs to a model calculation
+  ///
+  /// ColumnState is the value-type counterpart of ColumnView, used when the
+  /// column has to outlive the caller's arrays (queues, traces, caches).
+  struct ColumnState
+  {
+    /// Solar zenith angle [degrees]
+    double solar_zenith_angle{ 0.0 };
+
+    /// Uniform surface albedo [0-1], used when the model has no surface albedo spectrum
+    double surface_albedo{ 0.1 };
+
+    /// Temperature at layer midpoints [K]
+    std::vector<double> temperature{};
+
+    /// Air number density at layer midpoints [molecules/cm³]
+    std::vector<double> air_density{};
+
+    /// Ozone number density at layer midpoints [molecules/cm³]
+    std::vector<double> ozone{};
+
+    /// @brief Get a view of this column
+    ColumnView View() const
+    {
+      ColumnView view;
+      view.solar_zenith_angle = solar_zenith_angle;
+      view.surface_albedo = surface_albedo;
+      view.temperature = StridedView<const double>(temperature.data(), temperature.size());
+      view.air_density = StridedView<const double>(air_density.data(), air_density.size());
+      view.ozone = StridedView<const double>(ozone.data(), ozone.size());
+      return view;
+    }
+  };
+
+}  // namespace tuvx
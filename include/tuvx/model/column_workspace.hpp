@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+
+#include <tuvx/radiation_field/radiation_field.hpp>
+#include <tuvx/radiator/radiator_state.hpp>
+#include <tuvx/solver/solver.hpp>
+#include <tuvx/spherical_geometry/spherical_geometry.hpp>
+
+namespace tuvx
+{
+  /// @brief Intermediate results for one column as it moves through the model stages
+  ///
+  /// TuvModel computes a column in four stages that communicate only through
+  /// this struct: GatherColumn() fills the inputs, ComputeOpticalProperties()
+  /// the slant paths and combined optical properties, SolveColumn() the
+  /// radiation field, and IntegrateColumn() reads it to write J-values.
+  /// Keeping the stages' data here lets PipelineExecutor run different
+  /// columns through different stages at the same time. The vectors keep
+  /// their capacity when a workspace is reused.
+  struct ColumnWorkspace
+  {
+    /// Solar zenith angle [degrees]
+    double solar_zenith_angle{ 0.0 };
+
+    /// Surface albedo at each wavelength bin
+    std::vector<double> surface_albedo{};
+
+    /// Temperature at layer midpoints [K]
+    std::vector<double> temperature{};
+
+    /// Air density at layer midpoints [molecules/cm³]
+    std::vector<double> air_density{};
+
+    /// Ozone density at layer midpoints [molecules/cm³]
+    std::vector<double> ozone{};
+
+    /// O2 density at layer midpoints, a fixed fraction of the air density [molecules/cm³]
+    std::vector<double> o2{};
+
+    /// Slant path factors (spherical geometry only)
+    SphericalGeometry::SlantPathResult geometry{};
+
+    /// Combined optical properties of all radiators
+    RadiatorState optical_properties{};
+
+    /// Extraterrestrial flux at the top of the atmosphere, distance-corrected
+    std::vector<double> solar_flux{};
+
+    /// Radiation field at all levels and wavelengths
+    RadiationField radiation_field{};
+
+    /// Solver scratch memory, reused from one column to the next
+    SolverWorkspace solver{};
+  };
+
+}  // namespace tuvx
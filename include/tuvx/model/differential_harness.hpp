@@ -0,0 +1,469 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <tuvx/model/column_state.hpp>
+#include <tuvx/model/model_config.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/photolysis/photolysis_rate.hpp>
+#include <tuvx/radiator/types/aerosol.hpp>
+#include <tuvx/util/thread_pool.hpp>
+
+namespace tuvx
+{
+  /// @brief One randomized column for differential testing
+  struct DifferentialColumn
+  {
+    /// SZA, albedo and profiles at the model's layer midpoints
+    ColumnState state;
+
+    /// Aerosol load, or none for a clean column
+    std::optional<AerosolRadiator::Config> aerosol;
+  };
+
+  /// @brief Generates randomized but physically valid columns
+  ///
+  /// Profiles are perturbations of the US Standard Atmosphere: a smooth
+  /// temperature offset, a surface-pressure scaling of air density and an
+  /// ozone profile for a random total column. SZA covers day and twilight,
+  /// albedo covers ocean to fresh snow, and about three columns in four carry
+  /// an aerosol load. The sequence depends only on the seed.
+  class DifferentialColumnGenerator
+  {
+   public:
+    /// @brief Construct for a grid
+    /// @param altitude_midpoints Layer midpoints [km]
+    /// @param seed Random seed
+    DifferentialColumnGenerator(std::vector<double> altitude_midpoints, std::uint64_t seed)
+        : midpoints_(std::move(altitude_midpoints)),
+          rng_(seed),
+          base_temperature_(StandardAtmosphere::GenerateTemperatureProfile(midpoints_)),
+          base_air_density_(StandardAtmosphere::GenerateAirDensityProfile(midpoints_))
+    {
+    }
+
+    /// @brief Generate the next column
+    DifferentialColumn Next()
+    {
+      DifferentialColumn column;
+      ColumnState& state = column.state;
+      state.solar_zenith_angle = Uniform(0.0, 89.0);
+      state.surface_albedo = Uniform(0.02, 0.9);
+
+      // Smooth temperature offset: surface offset relaxing to a stratospheric one
+      double surface_offset = Uniform(-20.0, 20.0);
+      double upper_offset = Uniform(-10.0, 10.0);
+      double transition = Uniform(8.0, 20.0);
+      state.temperature.resize(midpoints_.size());
+      for (std::size_t i = 0; i < midpoints_.size(); ++i)
+      {
+        double w = std::exp(-midpoints_[i] / transition);
+        state.temperature[i] = std::clamp(base_temperature_[i] + w * surface_offset + (1.0 - w) * upper_offset, 160.0, 330.0);
+      }
+
+      double pressure_scale = Uniform(0.95, 1.05);
+      state.air_density.resize(midpoints_.size());
+      for (std::size_t i = 0; i < midpoints_.size(); ++i)
+      {
+        // Keep p = n k T consistent with the perturbed temperature
+        state.air_density[i] = base_air_density_[i] * pressure_scale * base_temperature_[i] / state.temperature[i];
+      }
+
+      state.ozone = StandardAtmosphere::GenerateOzoneProfile(midpoints_, Uniform(200.0, 450.0));
+
+      if (Uniform(0.0, 1.0) < 0.75)
+      {
+        AerosolRadiator::Config aerosol;
+        aerosol.optical_depth_ref = Uniform(0.01, 1.0);
+        aerosol.angstrom_exponent = Uniform(0.2, 2.5);
+        aerosol.scale_height = Uniform(1.0, 8.0);
+        aerosol.single_scattering_albedo = Uniform(0.75, 1.0);
+        aerosol.asymmetry_factor = Uniform(0.5, 0.8);
+        column.aerosol = aerosol;
+      }
+      return column;
+    }
+
+   private:
+    double Uniform(double low, double high)
+    {
+      return std::uniform_real_distribution<double>(low, high)(rng_);
+    }
+
+    std::vector<double> midpoints_;
+    std::mt19937_64 rng_;
+    std::vector<double> base_temperature_;
+    std::vector<double> base_air_density_;
+  };
+
+  /// @brief Error limits a fast path must meet, per reaction
+  ///
+  /// Relative errors use max(|J_ref|, absolute_floor) as the denominator, so
+  /// J-values that underflow to zero in deep twilight do not dominate.
+  struct DifferentialTolerance
+  {
+    double max_relative{ 1.0e-5 };
+    double rms_relative{ 1.0e-6 };
+    double absolute_floor{ 1.0e-30 };
+  };
+
+  /// @brief Error statistics of one reaction over all columns and levels
+  struct DifferentialReactionError
+  {
+    std::string reaction_name;
+    double max_relative_error{ 0.0 };
+    double rms_relative_error{ 0.0 };
+    std::size_t n_values{ 0 };
+
+    /// @brief True if both limits are met
+    bool Passes(const DifferentialTolerance& tolerance) const
+    {
+      return max_relative_error <= tolerance.max_relative && rms_relative_error <= tolerance.rms_relative;
+    }
+  };
+
+  /// @brief Comparison of one fast path against the reference path
+  struct DifferentialReport
+  {
+    std::string path_name;
+    DifferentialTolerance tolerance;
+    std::vector<DifferentialReactionError> reactions;
+
+    /// @brief True if every reaction meets the tolerance
+    bool Passed() const
+    {
+      return std::all_of(
+          reactions.begin(), reactions.end(), [&](const auto& reaction) { return reaction.Passes(tolerance); });
+    }
+
+    /// @brief One line per reaction: name, max and RMS error, PASS/FAIL
+    std::string Summary() const
+    {
+      std::ostringstream out;
+      out << path_name << ":\n";
+      for (const auto& reaction : reactions)
+      {
+        out << "  " << reaction.reaction_name << ": max " << reaction.max_relative_error << ", rms "
+            << reaction.rms_relative_error << " over " << reaction.n_values << " values "
+            << (reaction.Passes(tolerance) ? "PASS" : "FAIL") << "\n";
+      }
+      return out.str();
+    }
+  };
+
+  /// @brief Runs random columns through the reference path and each fast path
+  ///
+  /// For every column the harness builds a model with the column's profiles,
+  /// albedo and aerosol, the standard radiators and the caller's reactions.
+  /// The reference J-values come from TuvModel::Calculate() (Delta-Eddington
+  /// solver and PhotolysisRateSet). Each fast path receives its own copy of
+  /// the same model and returns J-values for the same reactions.
+  ///
+  /// Example usage:
+  /// @code
+  /// DifferentialHarness harness(config, [&](TuvModel& m) { m.AddPhotolysisReaction(...); });
+  /// harness.AddPath("my_fast_path", MyFastPath, DifferentialTolerance{});
+  /// for (const auto& report : harness.Run(200, 42))
+  /// {
+  ///   EXPECT_TRUE(report.Passed()) << report.Summary();
+  /// }
+  /// @endcode
+  class DifferentialHarness
+  {
+   public:
+    /// Adds the reactions under test to a freshly built model
+    using ReactionSetup = std::function<void(TuvModel&)>;
+
+    /// Computes J-values for a column with a fast path
+    using FastPath = std::function<std::vector<PhotolysisRateCalculator::Result>(TuvModel&, const DifferentialColumn&)>;
+
+    /// @brief Construct a harness
+    /// @param config Grid and solver configuration shared by all columns
+    /// @param add_reactions Adds the reactions to compare
+    DifferentialHarness(ModelConfig config, ReactionSetup add_reactions)
+        : config_(std::move(config)),
+          add_reactions_(std::move(add_reactions))
+    {
+    }
+
+    /// @brief Register a fast path
+    /// @param name Name used in reports
+    /// @param path Fast path implementation
+    /// @param tolerance Limits the path must meet
+    void AddPath(std::string name, FastPath path, DifferentialTolerance tolerance = DifferentialTolerance{})
+    {
+      paths_.push_back({ std::move(name), std::move(path), tolerance });
+    }
+
+    /// @brief Build the reference model for a column
+    /// @param column Column inputs
+    /// @return Model with the column's profiles, albedo, radiators and reactions
+    TuvModel BuildModel(const DifferentialColumn& column) const
+    {
+      TuvModel model(config_);
+      model.SetTemperatureProfile(column.state.temperature);
+      model.SetAirDensityProfile(column.state.air_density);
+      model.SetOzoneProfile(column.state.ozone);
+      model.SetSurfaceAlbedo(column.state.surface_albedo);
+      model.AddStandardRadiators();
+      if (column.aerosol)
+      {
+        model.AddAerosolRadiator(*column.aerosol);
+      }
+      add_reactions_(model);
+      return model;
+    }
+
+    /// @brief Compare every registered path on random columns
+    /// @param n_columns Number of columns
+    /// @param seed Random seed for the column generator
+    /// @return One report per registered path, in registration order
+    std::vector<DifferentialReport> Run(std::size_t n_columns, std::uint64_t seed) const
+    {
+      TuvModel grid_model(config_);
+      auto midpoints = grid_model.AltitudeGrid().Midpoints();
+      DifferentialColumnGenerator generator(std::vector<double>(midpoints.begin(), midpoints.end()), seed);
+
+      // Sum of squared relative errors per path and reaction
+      std::vector<std::vector<double>> sum_squares(paths_.size());
+      std::vector<DifferentialReport> reports(paths_.size());
+      for (std::size_t p = 0; p < paths_.size(); ++p)
+      {
+        reports[p].path_name = paths_[p].name;
+        reports[p].tolerance = paths_[p].tolerance;
+      }
+
+      for (std::size_t c = 0; c < n_columns; ++c)
+      {
+        DifferentialColumn column = generator.Next();
+        TuvModel reference_model = BuildModel(column);
+        auto reference = reference_model.Calculate(column.state.solar_zenith_angle).photolysis_rates;
+
+        for (std::size_t p = 0; p < paths_.size(); ++p)
+        {
+          TuvModel model(reference_model);
+          auto candidate = paths_[p].path(model, column);
+          Accumulate(reference, candidate, paths_[p].tolerance, reports[p], sum_squares[p]);
+        }
+      }
+
+      for (std::size_t p = 0; p < paths_.size(); ++p)
+      {
+        for (std::size_t r = 0; r < reports[p].reactions.size(); ++r)
+        {
+          auto& reaction = reports[p].reactions[r];
+          reaction.rms_relative_error =
+              reaction.n_values > 0 ? std::sqrt(sum_squares[p][r] / static_cast<double>(reaction.n_values)) : 0.0;
+        }
+      }
+      return reports;
+    }
+
+   private:
+    struct Path
+    {
+      std::string name;
+      FastPath path;
+      DifferentialTolerance tolerance;
+    };
+
+    static void Accumulate(
+        const std::vector<PhotolysisRateCalculator::Result>& reference,
+        const std::vector<PhotolysisRateCalculator::Result>& candidate,
+        const DifferentialTolerance& tolerance,
+        DifferentialReport& report,
+        std::vector<double>& sum_squares)
+    {
+      if (report.reactions.empty())
+      {
+        for (const auto& result : reference)
+        {
+          report.reactions.push_back({ result.reaction_name });
+        }
+        sum_squares.assign(reference.size(), 0.0);
+      }
+
+      for (std::size_t r = 0; r < reference.size(); ++r)
+      {
+        auto& reaction = report.reactions[r];
+        const auto& expected = reference[r].rates;
+        const std::vector<double>* actual = nullptr;
+        for (const auto& result : candidate)
+        {
+          if (result.reaction_name == reference[r].reaction_name)
+          {
+            actual = &result.rates;
+            break;
+          }
+        }
+
+        for (std::size_t l = 0; l < expected.size(); ++l)
+        {
+          // A missing reaction or level counts as an infinite error
+          double error = std::numeric_limits<double>::infinity();
+          if (actual != nullptr && l < actual->size())
+          {
+            error = std::abs((*actual)[l] - expected[l]) / std::max(std::abs(expected[l]), tolerance.absolute_floor);
+          }
+          if (std::isnan(error))
+          {
+            error = std::numeric_limits<double>::infinity();
+          }
+          reaction.max_relative_error = std::max(reaction.max_relative_error, error);
+          sum_squares[r] += error * error;
+          ++reaction.n_values;
+        }
+      }
+    }
+
+    ModelConfig config_;
+    ReactionSetup add_reactions_;
+    std::vector<Path> paths_;
+  };
+
+  namespace differential_paths
+  {
+    /// @brief Bulk column path: TuvModel::CalculatePhotolysisRates(ColumnView, ...)
+    inline std::vector<PhotolysisRateCalculator::Result> BulkColumn(TuvModel& model, const DifferentialColumn& column)
+    {
+      std::size_t n_levels = model.AltitudeGrid().Spec().n_cells + 1;
+      auto names = model.PhotolysisReactions().ReactionNames();
+      std::vector<double> rates(names.size() * n_levels, 0.0);
+      model.CalculatePhotolysisRates(column.state.View(), rates.data(), static_cast<std::ptrdiff_t>(n_levels), 1);
+
+      std::vector<PhotolysisRateCalculator::Result> results(names.size());
+      for (std::size_t r = 0; r < names.size(); ++r)
+      {
+        results[r].reaction_name = names[r];
+        results[r].rates.assign(rates.begin() + r * n_levels, rates.begin() + (r + 1) * n_levels);
+      }
+      return results;
+    }
+
+    /// @brief Threaded photolysis path: PhotolysisRateSet::CalculateAll on a pool
+    /// @param pool Pool to run on (must outlive the returned path)
+    inline DifferentialHarness::FastPath ThreadedRates(ThreadPool& pool)
+    {
+      return [&pool](TuvModel& model, const DifferentialColumn& column)
+      {
+        auto output = model.Calculate(column.state.solar_zenith_angle);
+        return model.PhotolysisReactions().CalculateAll(
+            output.radiation_field, model.WavelengthGrid(), column.state.temperature, pool);
+      };
+    }
+  }  // namespace differential_paths
+
+  namespace detail
+  {
+    /// @brief Random columns on a model's altitude grid
+    /// @param model Model whose layer midpoints the profiles are built on
+    /// @param n_columns Number of columns
+    /// @param seed Random seed for DifferentialColumnGenerator
+    inline std::vector<ColumnState> RandomColumns(const TuvModel& model, std::size_t n_columns, std::uint64_t seed)
+    {
+      auto midpoints = model.AltitudeGrid().Midpoints();
+      DifferentialColumnGenerator generator(std::vector<double>(midpoints.begin(), midpoints.end()), seed);
+      std::vector<ColumnState> columns;
+      for (std::size_t c = 0; c < n_columns; ++c)
+      {
+        columns.push_back(generator.Next().state);
+      }
+      return columns;
+    }
+
+    /// @brief Time the bulk column path over a set of columns
+    /// @tparam Model TuvModel, or a model exposing the same AltitudeGrid(),
+    ///         PhotolysisReactions() and CalculatePhotolysisRates()
+    /// @param model Model to run
+    /// @param columns Column inputs
+    /// @param rates Output J-values, [column][reaction][level]
+    /// @return Wall time for all columns [s]; one untimed warm-up column runs
+    ///         first so the timing excludes first-use allocation
+    template<typename Model>
+    double TimeBulkColumns(Model& model, const std::vector<ColumnState>& columns, std::vector<double>& rates)
+    {
+      std::size_t n_levels = model.AltitudeGrid().Spec().n_cells + 1;
+      std::size_t column_size = model.PhotolysisReactions().Size() * n_levels;
+      rates.assign(std::max<std::size_t>(columns.size(), 1) * column_size, 0.0);
+      if (!columns.empty())
+      {
+        model.CalculatePhotolysisRates(columns[0].View(), rates.data(), static_cast<std::ptrdiff_t>(n_levels), 1);
+      }
+      auto start = std::chrono::steady_clock::now();
+      for (std::size_t c = 0; c < columns.size(); ++c)
+      {
+        model.CalculatePhotolysisRates(
+            columns[c].View(), rates.data() + c * column_size, static_cast<std::ptrdiff_t>(n_levels), 1);
+      }
+      return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /// @brief Per-reaction error of bulk J-values against reference values
+    /// @param names Reaction names
+    /// @param expected Reference J-values, [column][reaction][level]
+    /// @param actual J-values to check, same layout
+    /// @param n_columns Number of columns
+    /// @param n_levels Levels per reaction
+    /// @param relative_floor Errors are relative to the larger of |J| and this
+    ///        fraction of the reaction's peak J in the column
+    inline std::vector<DifferentialReactionError> CompareBulkRates(
+        const std::vector<std::string>& names,
+        const std::vector<double>& expected,
+        const std::vector<double>& actual,
+        std::size_t n_columns,
+        std::size_t n_levels,
+        double relative_floor)
+    {
+      std::size_t column_size = names.size() * n_levels;
+      std::vector<DifferentialReactionError> errors;
+      for (std::size_t r = 0; r < names.size(); ++r)
+      {
+        DifferentialReactionError error{ names[r] };
+        double sum_squares = 0.0;
+        for (std::size_t c = 0; c < n_columns; ++c)
+        {
+          const double* reference = expected.data() + c * column_size + r * n_levels;
+          const double* candidate = actual.data() + c * column_size + r * n_levels;
+          double peak = 0.0;
+          for (std::size_t l = 0; l < n_levels; ++l)
+          {
+            peak = std::max(peak, std::abs(reference[l]));
+          }
+          for (std::size_t l = 0; l < n_levels; ++l)
+          {
+            double scale = std::max(std::abs(reference[l]), relative_floor * peak);
+            if (scale == 0.0)
+            {
+              continue;
+            }
+            double relative = std::abs(candidate[l] - reference[l]) / scale;
+            if (std::isnan(relative))
+            {
+              relative = std::numeric_limits<double>::infinity();
+            }
+            error.max_relative_error = std::max(error.max_relative_error, relative);
+            sum_squares += relative * relative;
+            ++error.n_values;
+          }
+        }
+        error.rms_relative_error = error.n_values > 0 ? std::sqrt(sum_squares / static_cast<double>(error.n_values)) : 0.0;
+        errors.push_back(std::move(error));
+      }
+      return errors;
+    }
+  }  // namespace detail
+
+}  // namespace tuvx
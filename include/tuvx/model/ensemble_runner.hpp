@@ -0,0 +1,221 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <tuvx/model/batch_driver.hpp>
+#include <tuvx/model/column_state.hpp>
+#include <tuvx/model/column_workspace.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/radiation_field/radiation_field.hpp>
+#include <tuvx/radiator/radiator.hpp>
+#include <tuvx/radiator/radiator_state.hpp>
+#include <tuvx/solver/solver.hpp>
+#include <tuvx/util/internal_error.hpp>
+
+namespace tuvx
+{
+  /// @brief Scale factor applied to one radiator's optical depth
+  struct RadiatorScaling
+  {
+    /// Radiator name (e.g. "O3", "aerosol")
+    std::string radiator;
+
+    /// Factor applied to the radiator's layer optical depths
+    double factor{ 1.0 };
+  };
+
+  /// @brief Perturbation defining one ensemble member relative to the base column
+  ///
+  /// Radiators not listed keep their base optical properties. Scaling the O3
+  /// radiator is equivalent to scaling the ozone profile; scaling the aerosol
+  /// radiator scales its optical depth at every wavelength.
+  struct EnsembleMember
+  {
+    std::vector<RadiatorScaling> scalings;
+  };
+
+  /// @brief Runs ensemble members that differ only in radiator optical depth scaling
+  ///
+  /// Running each member as an independent column repeats the geometry,
+  /// extraterrestrial flux, Rayleigh and O2 work that all members share.
+  /// EnsembleRunner evaluates every radiator once for the base column and
+  /// pre-combines the radiators no member perturbs. Per member it only scales
+  /// the perturbed radiators and combines them with the shared part, then
+  /// solves all members in one Solver::SolveBatch() call.
+  ///
+  /// Members without scalings are bit-identical to
+  /// TuvModel::CalculatePhotolysisRates() for the base column. Scaled members
+  /// agree with an independent run using scaled ozone or aerosol optical depth
+  /// to rounding, since the optical depth is scaled after it is computed.
+  ///
+  /// The runner updates the model's radiators, so it must not run
+  /// concurrently with other calculations on the same model.
+  ///
+  /// Example usage:
+  /// @code
+  /// std::vector<EnsembleMember> members(n_members);
+  /// for (std::size_t m = 0; m < n_members; ++m)
+  ///   members[m].scalings = { { "O3", 0.9 + 0.01 * m } };
+  /// EnsembleRunner(model).Calculate(base.View(), members, { j.data(), n_reactions * n_levels, n_levels, 1 });
+  /// @endcode
+  class EnsembleRunner
+  {
+   public:
+    /// @brief Create a runner for a configured model
+    /// @param model Model with grids, radiators and reactions set up (must outlive the runner)
+    explicit EnsembleRunner(TuvModel& model)
+        : model_(model)
+    {
+    }
+
+    /// @brief Calculate photolysis rates for every ensemble member
+    /// @param base Column inputs shared by all members
+    /// @param members Perturbation of each member
+    /// @param rates Destination; J for member m, reaction r and level l is written to
+    ///              data[m * column_stride + r * reaction_stride + l * level_stride]
+    /// @throws std::invalid_argument if a scaling names a radiator the model does not have
+    /// @throws TuvxInternalException if a profile does not match the altitude grid or the rate array is null
+    void Calculate(const ColumnView& base, std::span<const EnsembleMember> members, const RateBatchView& rates)
+    {
+      if (members.empty())
+      {
+        return;
+      }
+      model_.PrepareComponents();
+      const RadiatorWarehouse& radiators = model_.Radiators();
+      for (const auto& member : members)
+      {
+        for (const auto& scaling : member.scalings)
+        {
+          if (!radiators.Exists(scaling.radiator))
+          {
+            TUVX_THROW(std::invalid_argument("Ensemble member scales unknown radiator '" + scaling.radiator + "'"));
+          }
+        }
+      }
+      if (rates.data == nullptr && model_.PhotolysisReactions().Size() > 0)
+      {
+        TUVX_INTERNAL_ERROR("Ensemble rate array is null");
+      }
+
+      // Shared work: gather, geometry, every radiator once, solar flux
+      model_.GatherColumn(base, workspace_);
+      model_.ComputeOpticalProperties(workspace_);
+      model_.FillSolarFlux(workspace_.solar_flux);
+      SplitRadiators(members);
+
+      // Per member: scale the perturbed radiators and combine with the shared part
+      member_states_.resize(members.size());
+      inputs_.resize(members.size());
+      fields_.resize(members.size());
+      for (std::size_t m = 0; m < members.size(); ++m)
+      {
+        const RadiatorState* state = &workspace_.optical_properties;
+        if (!members[m].scalings.empty() && !perturbed_.empty())
+        {
+          CombineMember(members[m], member_states_[m]);
+          state = &member_states_[m];
+        }
+
+        inputs_[m] = model_.ColumnSolverInput(workspace_, *state);
+      }
+
+      // All members in one solver call
+      model_.GetSolver()->SolveBatch(inputs_, fields_);
+
+      for (std::size_t m = 0; m < members.size(); ++m)
+      {
+        model_.PhotolysisReactions().CalculateAll(
+            fields_[m],
+            model_.WavelengthGrid(),
+            workspace_.temperature,
+            rates.data + static_cast<std::ptrdiff_t>(m) * rates.column_stride,
+            rates.reaction_stride,
+            rates.level_stride);
+      }
+    }
+
+    /// @brief Radiation field of a member from the most recent Calculate()
+    const RadiationField& Field(std::size_t member) const
+    {
+      return fields_.at(member);
+    }
+
+   private:
+    /// @brief Sort the radiators into perturbed ones and a pre-combined shared state
+    void SplitRadiators(std::span<const EnsembleMember> members)
+    {
+      const RadiatorWarehouse& radiators = model_.Radiators();
+      perturbed_.clear();
+      std::vector<const RadiatorState*> shared;
+      for (const auto& name : radiators.Names())
+      {
+        const Radiator& radiator = radiators.Get(name);
+        if (!radiator.HasState())
+        {
+          continue;
+        }
+        bool is_perturbed = false;
+        for (const auto& member : members)
+        {
+          for (const auto& scaling : member.scalings)
+          {
+            is_perturbed = is_perturbed || scaling.radiator == name;
+          }
+        }
+        if (is_perturbed)
+        {
+          perturbed_.push_back(&radiator);
+        }
+        else
+        {
+          shared.push_back(&radiator.State());
+        }
+      }
+      shared_state_ = RadiatorState::Combine(shared);
+      scaled_.resize(perturbed_.size());
+    }
+
+    /// @brief Combined optical properties of one member
+    void CombineMember(const EnsembleMember& member, RadiatorState& combined)
+    {
+      std::vector<const RadiatorState*> states;
+      states.reserve(perturbed_.size() + 1);
+      states.push_back(&shared_state_);
+      for (std::size_t k = 0; k < perturbed_.size(); ++k)
+      {
+        double factor = 1.0;
+        for (const auto& scaling : member.scalings)
+        {
+          if (scaling.radiator == perturbed_[k]->Name())
+          {
+            factor *= scaling.factor;
+          }
+        }
+        if (factor == 1.0)
+        {
+          states.push_back(&perturbed_[k]->State());
+          continue;
+        }
+        scaled_[k] = perturbed_[k]->State();
+        scaled_[k].Scale(factor);
+        states.push_back(&scaled_[k]);
+      }
+      combined = RadiatorState::Combine(states);
+    }
+
+    TuvModel& model_;
+    ColumnWorkspace workspace_;
+    RadiatorState shared_state_;
+    std::vector<const Radiator*> perturbed_;
+    std::vector<RadiatorState> scaled_;
+    std::vector<RadiatorState> member_states_;
+    std::vector<SolverInput> inputs_;
+    std::vector<RadiationField> fields_;
+  };
+
+}  // namespace tuvx
@@ -0,0 +1,408 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+#include <tuvx/grid/grid_warehouse.hpp>
+#include <tuvx/model/batch_driver.hpp>
+#include <tuvx/model/column_state.hpp>
+#include <tuvx/model/column_workspace.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/photolysis/photolysis_rate.hpp>
+#include <tuvx/profile/profile_warehouse.hpp>
+#include <tuvx/solver/solver.hpp>
+#include <tuvx/spherical_geometry/spherical_geometry.hpp>
+#include <tuvx/util/internal_error.hpp>
+#include <tuvx/util/reproducible_sum.hpp>
+
+namespace tuvx
+{
+  /// @brief Settings for TuvModel::Prepare()
+  struct ExecutionPlanConfig
+  {
+    /// Lowest temperature the reaction spectra are tabulated at [K]
+    double min_temperature{ 150.0 };
+
+    /// Highest temperature the reaction spectra are tabulated at [K]
+    double max_temperature{ 350.0 };
+
+    /// Spacing of the tabulated temperatures [K]
+    double temperature_step{ 1.0 };
+  };
+
+  /// @brief A model configuration compiled once for many column calculations
+  ///
+  /// TuvModel::CalculatePhotolysisRates() redoes the configuration-dependent
+  /// setup for every column: it copies both grids into a new grid warehouse,
+  /// builds a profile warehouse, regenerates any default profiles, rebuilds
+  /// the spherical geometry, rescales the solar flux and re-evaluates every
+  /// cross-section and quantum yield once per level. TuvModel::Prepare()
+  /// does that setup once (prepared components, warehouses with resolved
+  /// handles, default profiles, geometry, distance-corrected flux, sized
+  /// workspaces) and bins σ·φ·Δλ of every reaction on the wavelength grid at
+  /// each tabulated temperature, so Execute() does only the per-column work.
+  /// With the built-in solvers, radiators and spectra it allocates nothing;
+  /// a custom type allocates only if its in-place overloads
+  /// (CrossSection::CalculateInto(), Solver::SolveInto()) do.
+  ///
+  /// The radiation field is bit-identical to CalculatePhotolysisRates().
+  /// J-values differ from it only by the linear interpolation of σ·φ between
+  /// tabulated temperatures; layer temperatures outside the tabulated range
+  /// use the nearest end. The plan records the model's Generation(); any
+  /// later configuration change (setters, Add*() calls, SetSolver(),
+  /// Calculate() for a date) makes IsValid() false and Execute() throw until
+  /// a new plan is prepared. The plan updates the model's radiators, so it
+  /// must not run concurrently with other calculations on the same model,
+  /// and the model must outlive it.
+  ///
+  /// Example usage:
+  /// @code
+  /// ExecutionPlan plan = model.Prepare();
+  /// for (const auto& column : columns)
+  /// {
+  ///   plan.Execute(column.View(), rates, n_levels, 1);
+  /// }
+  /// @endcode
+  class ExecutionPlan
+  {
+   public:
+    /// @brief Whether the model is unchanged since the plan was built
+    bool IsValid() const
+    {
+      return model_->Generation() == generation_;
+    }
+
+    /// @brief Calculate photolysis rates for one column
+    /// @param column Column inputs (SZA, albedo, optional profiles)
+    /// @param rates Destination array; J for reaction r at level l is written to
+    ///              rates[r * reaction_stride + l * level_stride]
+    /// @param reaction_stride Distance between reactions [elements]
+    /// @param level_stride Distance between levels [elements]
+    /// @throws TuvxInternalException if the plan is stale or a profile does not match the altitude grid
+    void Execute(const ColumnView& column, double* rates, std::ptrdiff_t reaction_stride, std::ptrdiff_t level_stride)
+    {
+      if (!IsValid())
+      {
+        TUVX_INTERNAL_ERROR("Execution plan is out of date; the model changed after the plan was built");
+      }
+      Gather(column);
+      ComputeOpticalProperties();
+      Solve();
+      Integrate(rates, reaction_stride, level_stride);
+    }
+
+    /// @brief Calculate photolysis rates for every column in a batch, in order
+    /// @param batch Column inputs
+    /// @param rates Destination for J-values
+    /// @throws TuvxInternalException if the plan is stale or the batch does not match the model grids
+    void Execute(const ColumnBatchView& batch, const RateBatchView& rates)
+    {
+      if (batch.n_columns == 0)
+      {
+        return;
+      }
+      detail::CheckBatch(*model_, batch, rates);
+      for (std::size_t c = 0; c < batch.n_columns; ++c)
+      {
+        Execute(
+            detail::BatchColumn(*model_, batch, c),
+            rates.data + static_cast<std::ptrdiff_t>(c) * rates.column_stride,
+            rates.reaction_stride,
+            rates.level_stride);
+      }
+    }
+
+    /// @brief Intermediate results of the most recent column
+    const ColumnWorkspace& Workspace() const
+    {
+      return workspace_;
+    }
+
+    /// @brief Temperatures the reaction spectra are tabulated at [K]
+    const std::vector<double>& Temperatures() const
+    {
+      return temperatures_;
+    }
+
+   private:
+    friend class TuvModel;
+
+    /// @brief Prepare a model and compile its current configuration
+    /// @param model Model with grids, radiators and reactions set up
+    /// @param config Temperatures to tabulate the reaction spectra at
+    /// @throws std::invalid_argument if the temperature range is invalid
+    ExecutionPlan(TuvModel& model, const ExecutionPlanConfig& config)
+        : model_(&model)
+    {
+      if (!(config.temperature_step > 0.0) || !(config.max_temperature >= config.min_temperature))
+      {
+        TUVX_THROW(std::invalid_argument("Execution plan temperatures need a positive step and max >= min"));
+      }
+
+      model.PrepareComponents();
+      generation_ = model.Generation();
+
+      const ModelConfig& model_config = model.config_;
+      n_layers_ = model.altitude_grid_.Spec().n_cells;
+      n_wavelengths_ = model.wavelength_grid_.Spec().n_cells;
+
+      grids_.Add(model.wavelength_grid_);
+      grids_.Add(model.altitude_grid_);
+
+      // Profiles used when a column does not give its own
+      auto midpoints_span = model.altitude_grid_.Midpoints();
+      std::vector<double> midpoints(midpoints_span.begin(), midpoints_span.end());
+      default_temperature_ = model_config.temperature_profile.empty()
+                                 ? StandardAtmosphere::GenerateTemperatureProfile(midpoints)
+                                 : model_config.temperature_profile;
+      default_air_density_ = model_config.air_density_profile.empty()
+                                 ? StandardAtmosphere::GenerateAirDensityProfile(midpoints)
+                                 : model_config.air_density_profile;
+      default_ozone_ = model_config.ozone_profile.empty()
+                           ? StandardAtmosphere::GenerateOzoneProfile(midpoints, model_config.ozone_column_DU)
+                           : model_config.ozone_profile;
+
+      std::vector<double> zeros(n_layers_, 0.0);
+      temperature_handle_ = profiles_.Add(Profile(ProfileSpec{ "temperature", "K", n_layers_ }, zeros));
+      air_density_handle_ = profiles_.Add(Profile(ProfileSpec{ "air_density", "molecules/cm^3", n_layers_ }, zeros));
+      ozone_handle_ = profiles_.Add(Profile(ProfileSpec{ "O3", "molecules/cm^3", n_layers_ }, zeros));
+      o2_handle_ = profiles_.Add(Profile(ProfileSpec{ "O2", "molecules/cm^3", n_layers_ }, zeros));
+
+      if (model_config.use_spherical_geometry)
+      {
+        geometry_.emplace(model.altitude_grid_, model_config.earth_radius);
+      }
+
+      model.FillSolarFlux(workspace_.solar_flux);
+
+      // Size the per-column buffers for the first column
+      workspace_.surface_albedo.reserve(n_wavelengths_);
+      workspace_.temperature.reserve(n_layers_);
+      workspace_.air_density.reserve(n_layers_);
+      workspace_.ozone.reserve(n_layers_);
+      workspace_.o2.reserve(n_layers_);
+      workspace_.optical_properties.Initialize(n_layers_, n_wavelengths_);
+      workspace_.radiation_field.Initialize(n_layers_ + 1, n_wavelengths_);
+      actinic_flux_.resize((n_layers_ + 1) * n_wavelengths_);
+      sigma_phi_row_.resize(n_wavelengths_);
+      layer_row_.resize(n_layers_);
+      layer_weight_.resize(n_layers_);
+
+      BinSpectra(config);
+    }
+
+    /// @brief Tabulate σ·φ·Δλ of every reaction on the wavelength grid at each plan temperature
+    void BinSpectra(const ExecutionPlanConfig& config)
+    {
+      auto n_steps = static_cast<std::size_t>(
+          std::ceil((config.max_temperature - config.min_temperature) / config.temperature_step - 1.0e-9));
+      temperatures_.resize(n_steps + 1);
+      for (std::size_t k = 0; k <= n_steps; ++k)
+      {
+        temperatures_[k] = config.min_temperature + static_cast<double>(k) * config.temperature_step;
+      }
+      temperature_step_ = config.temperature_step;
+
+      const Grid& wavelength_grid = model_->wavelength_grid_;
+      auto deltas = wavelength_grid.Deltas();
+      std::vector<double> cross_section(n_wavelengths_);
+      std::vector<double> quantum_yield(n_wavelengths_);
+      const PhotolysisRateSet& reactions = model_->photolysis_reactions_;
+      sigma_phi_.reserve(reactions.Size() * temperatures_.size() * n_wavelengths_);
+      for (std::size_t r = 0; r < reactions.Size(); ++r)
+      {
+        const PhotolysisRateCalculator& reaction = reactions.Get(r);
+        if (!reaction.GetCrossSection() || !reaction.GetQuantumYield())
+        {
+          unbinned_reactions_.push_back(r);
+          continue;
+        }
+        binned_reactions_.push_back(r);
+        for (double temperature : temperatures_)
+        {
+          reaction.GetCrossSection()->CalculateInto(wavelength_grid, temperature, cross_section);
+          reaction.GetQuantumYield()->CalculateInto(wavelength_grid, temperature, 0.0, quantum_yield);
+          for (std::size_t j = 0; j < n_wavelengths_; ++j)
+          {
+            sigma_phi_.push_back(cross_section[j] * quantum_yield[j] * std::abs(deltas[j]));
+          }
+        }
+      }
+    }
+
+    /// @brief Copy the column inputs, falling back to the plan's default profiles
+    void Gather(const ColumnView& column)
+    {
+      workspace_.solar_zenith_angle = column.solar_zenith_angle;
+      TuvModel::GatherColumnProfile(column.temperature, default_temperature_, n_layers_, workspace_.temperature);
+      TuvModel::GatherColumnProfile(column.air_density, default_air_density_, n_layers_, workspace_.air_density);
+      TuvModel::GatherColumnProfile(column.ozone, default_ozone_, n_layers_, workspace_.ozone);
+      model_->FillSurfaceAlbedo(column.surface_albedo, workspace_.surface_albedo);
+    }
+
+    /// @brief Slant paths and combined optical properties, as TuvModel::ComputeOpticalProperties()
+    void ComputeOpticalProperties()
+    {
+      if (geometry_)
+      {
+        geometry_->CalculateInto(workspace_.solar_zenith_angle, workspace_.geometry);
+      }
+
+      RadiatorWarehouse& radiators = model_->radiators_;
+      if (radiators.Empty())
+      {
+        return;
+      }
+
+      // O2 is 20.95% of air density
+      workspace_.o2.resize(workspace_.air_density.size());
+      for (std::size_t i = 0; i < workspace_.o2.size(); ++i)
+      {
+        workspace_.o2[i] = workspace_.air_density[i] * StandardAtmosphere::kO2MixingRatio;
+      }
+
+      profiles_.Update(temperature_handle_, workspace_.temperature);
+      profiles_.Update(air_density_handle_, workspace_.air_density);
+      profiles_.Update(ozone_handle_, workspace_.ozone);
+      profiles_.Update(o2_handle_, workspace_.o2);
+
+      radiators.UpdateAll(grids_, profiles_);
+      radiators.CombineInto(workspace_.optical_properties);
+    }
+
+    /// @brief Solve radiative transfer with the plan's flux, geometry and solver scratch memory
+    void Solve()
+    {
+      SolverInput solver_input = model_->ColumnSolverInput(workspace_, workspace_.optical_properties);
+      solver_input.workspace = &workspace_.solver;
+      model_->solver_->SolveInto(solver_input, workspace_.radiation_field);
+    }
+
+    /// @brief Integrate J-values from the binned spectra
+    ///
+    /// Uses the same temperature for each level as
+    /// PhotolysisRateCalculator::CalculateLevel() (the layer below the level),
+    /// interpolating σ·φ·Δλ linearly between the two bracketing tabulated
+    /// temperatures once per layer and reaction.
+    void Integrate(double* rates, std::ptrdiff_t reaction_stride, std::ptrdiff_t level_stride)
+    {
+      const RadiationField& field = workspace_.radiation_field;
+      if (field.Empty())
+      {
+        return;
+      }
+      std::size_t n_levels = field.NumberOfLevels();
+      std::size_t n_wavelengths = std::min(field.NumberOfWavelengths(), n_wavelengths_);
+
+      actinic_flux_.resize(n_levels * n_wavelengths_);
+      for (std::size_t level = 0; level < n_levels; ++level)
+      {
+        double* flux = actinic_flux_.data() + level * n_wavelengths_;
+        for (std::size_t j = 0; j < n_wavelengths; ++j)
+        {
+          flux[j] = field.actinic_flux_direct[level][j] + field.actinic_flux_diffuse[level][j];
+        }
+      }
+
+      // Bracketing tabulated temperatures of each layer
+      const std::vector<double>& temperature = workspace_.temperature;
+      std::size_t n_rows = temperatures_.size();
+      for (std::size_t layer = 0; layer < temperature.size(); ++layer)
+      {
+        double clamped = std::clamp(temperature[layer], temperatures_.front(), temperatures_.back());
+        double position = (clamped - temperatures_.front()) / temperature_step_;
+        std::size_t row = std::min(static_cast<std::size_t>(position), n_rows - 1);
+        layer_row_[layer] = row;
+        layer_weight_[layer] = row + 1 < n_rows ? position - static_cast<double>(row) : 0.0;
+      }
+
+      // Reactions without both spectra have J = 0, as in PhotolysisRateCalculator::CalculateLevel()
+      for (std::size_t r : unbinned_reactions_)
+      {
+        double* reaction_rates = rates + static_cast<std::ptrdiff_t>(r) * reaction_stride;
+        for (std::size_t level = 0; level < n_levels; ++level)
+        {
+          reaction_rates[static_cast<std::ptrdiff_t>(level) * level_stride] = 0.0;
+        }
+      }
+
+      std::size_t table_size = n_rows * n_wavelengths_;
+      for (std::size_t b = 0; b < binned_reactions_.size(); ++b)
+      {
+        const double* table = sigma_phi_.data() + b * table_size;
+        double* reaction_rates = rates + static_cast<std::ptrdiff_t>(binned_reactions_[b]) * reaction_stride;
+        std::size_t row_layer = temperature.size();
+        for (std::size_t level = 0; level < n_levels; ++level)
+        {
+          std::size_t layer = level > 0 ? level - 1 : 0;
+          if (layer >= temperature.size())
+          {
+            continue;
+          }
+          if (layer != row_layer)
+          {
+            const double* lower = table + layer_row_[layer] * n_wavelengths_;
+            double weight = layer_weight_[layer];
+            for (std::size_t j = 0; j < n_wavelengths; ++j)
+            {
+              sigma_phi_row_[j] = weight > 0.0 ? lower[j] + weight * (lower[j + n_wavelengths_] - lower[j]) : lower[j];
+            }
+            row_layer = layer;
+          }
+          const double* flux = actinic_flux_.data() + level * n_wavelengths_;
+          reaction_rates[static_cast<std::ptrdiff_t>(level) * level_stride] =
+              ReproducibleSum(n_wavelengths, [&](std::size_t j) { return flux[j] * sigma_phi_row_[j]; });
+        }
+      }
+    }
+
+    TuvModel* model_;
+    std::uint64_t generation_{ 0 };
+    std::size_t n_layers_{ 0 };
+    std::size_t n_wavelengths_{ 0 };
+
+    // Resolved components
+    GridWarehouse grids_;
+    ProfileWarehouse profiles_;
+    ProfileHandle temperature_handle_;
+    ProfileHandle air_density_handle_;
+    ProfileHandle ozone_handle_;
+    ProfileHandle o2_handle_;
+    std::optional<SphericalGeometry> geometry_;
+
+    // Profiles used when a column leaves one empty
+    std::vector<double> default_temperature_;
+    std::vector<double> default_air_density_;
+    std::vector<double> default_ozone_;
+
+    // Binned spectra: σ·φ·Δλ [binned reaction][temperature][wavelength]
+    std::vector<double> temperatures_;
+    double temperature_step_{ 1.0 };
+    std::vector<std::size_t> binned_reactions_;
+    std::vector<std::size_t> unbinned_reactions_;
+    std::vector<double> sigma_phi_;
+
+    // Per-column buffers, reused from one column to the next
+    ColumnWorkspace workspace_;
+    std::vector<double> actinic_flux_;
+    std::vector<double> sigma_phi_row_;
+    std::vector<std::size_t> layer_row_;
+    std::vector<double> layer_weight_;
+  };
+
+  inline ExecutionPlan TuvModel::Prepare()
+  {
+    return Prepare(ExecutionPlanConfig{});
+  }
+
+  inline ExecutionPlan TuvModel::Prepare(const ExecutionPlanConfig& config)
+  {
+    return ExecutionPlan(*this, config);
+  }
+
+}  // namespace tuvx
@@ -118,6 +118,14 @@ namespace tuvx
     /// Earth radius [km]
     double earth_radius{ constants::kEarthRadius };
 
+    // ========================================================================
+    // Initialization
+    // ========================================================================
+
+    /// Defer preparing the solver, the standard radiators and the
+    /// extraterrestrial flux until the first calculation (or PrepareComponents())
+    bool lazy_initialization{ false };
+
     // ========================================================================
     // Output Options
     // ========================================================================
@@ -3,12 +3,15 @@
 #include <algorithm>
 #include <stdexcept>
 #include <string>
+#include <system_error>
 #include <unordered_map>
 #include <vector>
 
 #include <tuvx/grid/grid.hpp>
 #include <tuvx/photolysis/photolysis_rate.hpp>
 #include <tuvx/radiation_field/radiation_field.hpp>
+#include <tuvx/util/internal_error.hpp>
+#include <tuvx/util/reproducible_sum.hpp>
 
 namespace tuvx
 {
@@ -115,12 +118,12 @@ namespace tuvx
         {
           if (level >= result.rates.size())
           {
-            throw std::out_of_range("Level index out of bounds");
+            TUVX_THROW(std::out_of_range("Level index out of bounds"));
           }
           return result.rates[level];
         }
       }
-      throw std::out_of_range("Reaction not found: " + reaction_name);
+      TUVX_THROW(std::out_of_range("Reaction not found: " + reaction_name));
     }
 
     /// @brief Get photolysis rate profile for a specific reaction
@@ -136,7 +139,46 @@ namespace tuvx
           return result.rates;
         }
       }
-      throw std::out_of_range("Reaction not found: " + reaction_name);
+      TUVX_THROW(std::out_of_range("Reaction not found: " + reaction_name));
+    }
+
+    /// @brief Look up the photolysis rate of a reaction at one level without throwing
+    /// @param reaction_name Name of the photolysis reaction
+    /// @param level Altitude level index (0 = surface)
+    /// @param rate Set to the photolysis rate [s⁻¹] on success
+    /// @return Empty error code on success, TuvxInternalErrc::ReactionNotFound or OutOfRange otherwise
+    std::error_code TryGetPhotolysisRate(const std::string& reaction_name, std::size_t level, double& rate) const noexcept
+    {
+      const std::vector<double>* profile = nullptr;
+      if (auto error = TryGetPhotolysisRateProfile(reaction_name, profile))
+      {
+        return error;
+      }
+      if (level >= profile->size())
+      {
+        return TuvxInternalErrc::OutOfRange;
+      }
+      rate = (*profile)[level];
+      return {};
+    }
+
+    /// @brief Look up the photolysis rate profile of a reaction without throwing
+    /// @param reaction_name Name of the photolysis reaction
+    /// @param profile Set to the rates at all levels on success, nullptr otherwise
+    /// @return Empty error code on success, TuvxInternalErrc::ReactionNotFound otherwise
+    std::error_code TryGetPhotolysisRateProfile(const std::string& reaction_name, const std::vector<double>*& profile)
+        const noexcept
+    {
+      for (const auto& result : photolysis_rates)
+      {
+        if (result.reaction_name == reaction_name)
+        {
+          profile = &result.rates;
+          return {};
+        }
+      }
+      profile = nullptr;
+      return TuvxInternalErrc::ReactionNotFound;
     }
 
     /// @brief Get surface photolysis rate for a specific reaction
@@ -227,13 +269,8 @@ namespace tuvx
       auto flux = GetActinicFlux(level);
       auto deltas = wavelength_grid.Deltas();
 
-      double total = 0.0;
       std::size_t n = std::min(flux.size(), deltas.size());
-      for (std::size_t i = 0; i < n; ++i)
-      {
-        total += flux[i] * std::abs(deltas[i]);
-      }
-      return total;
+      return ReproducibleSum(n, [&](std::size_t i) { return flux[i] * std::abs(deltas[i]); });
     }
 
     /// @brief Get UV-B actinic flux (280-315 nm) at a level
@@ -263,16 +300,11 @@ namespace tuvx
       auto midpoints = wavelength_grid.Midpoints();
       auto deltas = wavelength_grid.Deltas();
 
-      double total = 0.0;
       std::size_t n = std::min({ flux.size(), midpoints.size(), deltas.size() });
-      for (std::size_t i = 0; i < n; ++i)
-      {
-        if (midpoints[i] >= wl_min && midpoints[i] <= wl_max)
-        {
-          total += flux[i] * std::abs(deltas[i]);
-        }
-      }
-      return total;
+      return ReproducibleSum(
+          n,
+          [&](std::size_t i)
+          { return (midpoints[i] >= wl_min && midpoints[i] <= wl_max) ? flux[i] * std::abs(deltas[i]) : 0.0; });
     }
 
     // ========================================================================
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <utility>
+
+#include <tuvx/model/batch_driver.hpp>
+#include <tuvx/util/numa.hpp>
+#include <tuvx/util/strided_view.hpp>
+#include <tuvx/util/thread_pool.hpp>
+
+namespace tuvx
+{
+  /// @brief Batch input and output arrays placed on the NUMA nodes of the workers that use them
+  ///
+  /// When one thread allocates and fills every column buffer, all pages sit
+  /// on that thread's node and the other socket's workers read and write
+  /// remote memory for the whole run. NumaBatchBuffers allocates the arrays
+  /// untouched and has each pool thread first-touch the block of columns it
+  /// owns under BatchSchedule::Static, so every page lands on the node of
+  /// the worker that later computes those columns. Pin the pool first (see
+  /// WorkerPlacement::Pin) so threads do not migrate between nodes.
+  ///
+  /// Each column is stored contiguously: profile layer l of column c is at
+  /// [c * n_layers + l], and J for reaction r at level l of column c is at
+  /// [(c * n_reactions + r) * n_levels + l] with n_levels = n_layers + 1.
+  ///
+  /// Example usage:
+  /// @code
+  /// ThreadPool pool;
+  /// WorkerPlacement(NumaTopology::Detect(), pool.Size()).Pin(pool);
+  /// NumaBatchBuffers buffers(pool, n_columns, n_layers, n_reactions);
+  /// pool.ForEachWorker([&](std::size_t w) { FillColumns(buffers, buffers.Columns(w)); });
+  /// BatchDriver(model, pool, BatchSchedule::Static).Calculate(buffers.Inputs(), buffers.Outputs());
+  /// @endcode
+  class NumaBatchBuffers
+  {
+   public:
+    /// @brief Allocate and first-touch the buffers for a batch
+    /// @param pool Pool that will run the batch with BatchSchedule::Static
+    /// @param n_columns Number of columns
+    /// @param n_layers Number of layers per column
+    /// @param n_reactions Number of photolysis reactions
+    /// @param huge_pages Request transparent huge pages for large arrays
+    NumaBatchBuffers(
+        ThreadPool& pool,
+        std::size_t n_columns,
+        std::size_t n_layers,
+        std::size_t n_reactions,
+        bool huge_pages = false)
+        : n_columns_(n_columns),
+          n_layers_(n_layers),
+          n_reactions_(n_reactions),
+          n_workers_(pool.Size()),
+          solar_zenith_angle_(n_columns, huge_pages),
+          surface_albedo_(n_columns, huge_pages),
+          temperature_(n_columns * n_layers, huge_pages),
+          air_density_(n_columns * n_layers, huge_pages),
+          ozone_(n_columns * n_layers, huge_pages),
+          rates_(n_columns * n_reactions * (n_layers + 1), huge_pages)
+    {
+      pool.ForEachWorker(
+          [&](std::size_t worker)
+          {
+            auto [first, last] = Columns(worker);
+            solar_zenith_angle_.FirstTouch(first, last);
+            surface_albedo_.FirstTouch(first, last);
+            temperature_.FirstTouch(first * n_layers_, last * n_layers_);
+            air_density_.FirstTouch(first * n_layers_, last * n_layers_);
+            ozone_.FirstTouch(first * n_layers_, last * n_layers_);
+            rates_.FirstTouch(first * RatesPerColumn(), last * RatesPerColumn());
+          });
+    }
+
+    /// @brief Columns owned by a worker
+    /// @param worker Worker index in [0, pool size)
+    /// @return Half-open column range {first, last}
+    std::pair<std::size_t, std::size_t> Columns(std::size_t worker) const
+    {
+      return StaticBlock(n_columns_, worker, n_workers_);
+    }
+
+    /// @brief Number of columns
+    std::size_t NumberOfColumns() const
+    {
+      return n_columns_;
+    }
+
+    /// @brief Number of layers per column
+    std::size_t NumberOfLayers() const
+    {
+      return n_layers_;
+    }
+
+    /// @brief Solar zenith angle for each column [degrees]
+    std::span<double> SolarZenithAngle()
+    {
+      return solar_zenith_angle_.Span();
+    }
+
+    /// @brief Surface albedo for each column
+    std::span<double> SurfaceAlbedo()
+    {
+      return surface_albedo_.Span();
+    }
+
+    /// @brief Temperature profiles [K]
+    std::span<double> Temperature()
+    {
+      return temperature_.Span();
+    }
+
+    /// @brief Air density profiles [molecules/cm³]
+    std::span<double> AirDensity()
+    {
+      return air_density_.Span();
+    }
+
+    /// @brief Ozone density profiles [molecules/cm³]
+    std::span<double> Ozone()
+    {
+      return ozone_.Span();
+    }
+
+    /// @brief Photolysis rates written by BatchDriver [s⁻¹]
+    std::span<const double> Rates() const
+    {
+      return rates_.Span();
+    }
+
+    /// @brief View of the inputs for BatchDriver::Calculate
+    ColumnBatchView Inputs() const
+    {
+      ColumnBatchView batch;
+      batch.n_columns = n_columns_;
+      batch.n_layers = n_layers_;
+      batch.solar_zenith_angle = StridedView<const double>(solar_zenith_angle_.Data(), n_columns_);
+      batch.surface_albedo = StridedView<const double>(surface_albedo_.Data(), n_columns_);
+      auto layers = static_cast<std::ptrdiff_t>(n_layers_);
+      batch.temperature = { temperature_.Data(), layers, 1 };
+      batch.air_density = { air_density_.Data(), layers, 1 };
+      batch.ozone = { ozone_.Data(), layers, 1 };
+      return batch;
+    }
+
+    /// @brief View of the outputs for BatchDriver::Calculate
+    RateBatchView Outputs()
+    {
+      auto levels = static_cast<std::ptrdiff_t>(n_layers_ + 1);
+      return { rates_.Data(), static_cast<std::ptrdiff_t>(RatesPerColumn()), levels, 1 };
+    }
+
+   private:
+    std::size_t RatesPerColumn() const
+    {
+      return n_reactions_ * (n_layers_ + 1);
+    }
+
+    std::size_t n_columns_;
+    std::size_t n_layers_;
+    std::size_t n_reactions_;
+    std::size_t n_workers_;
+    NumaBuffer<double> solar_zenith_angle_;
+    NumaBuffer<double> surface_albedo_;
+    NumaBuffer<double> temperature_;
+    NumaBuffer<double> air_density_;
+    NumaBuffer<double> ozone_;
+    NumaBuffer<double> rates_;
+  };
+
+}  // namespace tuvx
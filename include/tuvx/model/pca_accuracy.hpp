@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <tuvx/model/differential_harness.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/solver/delta_eddington.hpp>
+#include <tuvx/solver/pca_solver.hpp>
+
+namespace tuvx
+{
+  /// @brief Accuracy and cost of PcaSolver against the full spectral solve
+  struct PcaAccuracyReport
+  {
+    std::size_t n_wavelengths{ 0 };
+    std::size_t n_bins{ 0 };
+
+    /// Accurate-solver wavelengths per column (at most; see PcaSolver::AccurateSolves)
+    std::size_t accurate_solves{ 0 };
+    std::size_t n_columns{ 0 };
+
+    /// Per-reaction error of the accelerated J-values over all columns and levels
+    std::vector<DifferentialReactionError> reactions;
+
+    /// Wall time for all columns with each solver [s]
+    double full_seconds{ 0.0 };
+    double pca_seconds{ 0.0 };
+
+    /// @brief Full-solve time over accelerated time
+    double Speedup() const
+    {
+      return pca_seconds > 0.0 ? full_seconds / pca_seconds : 0.0;
+    }
+
+    /// @brief Largest relative error of any reaction
+    double MaxRelativeError() const
+    {
+      double max_error = 0.0;
+      for (const auto& reaction : reactions)
+      {
+        max_error = std::max(max_error, reaction.max_relative_error);
+      }
+      return max_error;
+    }
+
+    /// @brief Solve counts, timings and one line per reaction
+    std::string Summary() const
+    {
+      std::ostringstream out;
+      out << n_wavelengths << " wavelengths in " << n_bins << " bins, " << accurate_solves
+          << " accurate solves per column, over " << n_columns << " columns: " << full_seconds << " s -> " << pca_seconds
+          << " s (" << Speedup() << "x)\n";
+      for (const auto& reaction : reactions)
+      {
+        out << "  " << reaction.reaction_name << ": max " << reaction.max_relative_error << ", rms "
+            << reaction.rms_relative_error << " over " << reaction.n_values << " values\n";
+      }
+      return out.str();
+    }
+  };
+
+  /// @brief Compare PcaSolver with the full Delta-Eddington solve on random columns
+  /// @param model Model with the radiators and reactions to evaluate; its own solver is replaced
+  /// @param config Options for the accelerated solver
+  /// @param n_columns Number of columns
+  /// @param seed Seed for DifferentialColumnGenerator; aerosol draws are ignored
+  /// @param relative_floor Errors are relative to at least this fraction of
+  ///        the column's largest J for the reaction
+  /// @return Errors and the wall time of each solver
+  ///
+  /// Both runs use TuvModel::CalculatePhotolysisRates() on copies of the
+  /// model that differ only in the solver, so the timings include the
+  /// optical-property and photolysis stages every column pays.
+  inline PcaAccuracyReport EvaluatePcaSolver(
+      const TuvModel& model,
+      const PcaSolverConfig& config,
+      std::size_t n_columns,
+      std::uint64_t seed,
+      double relative_floor = 1.0e-3)
+  {
+    TuvModel full(model);
+    full.SetSolver(std::make_unique<DeltaEddingtonSolver>());
+    full.PrepareComponents();
+    TuvModel accelerated(model);
+    auto solver = std::make_unique<PcaSolver>(config);
+
+    PcaAccuracyReport report;
+    report.n_wavelengths = model.WavelengthGrid().Spec().n_cells;
+    report.n_bins = solver->NumberOfBins(report.n_wavelengths);
+    report.accurate_solves = solver->AccurateSolves(report.n_wavelengths);
+    report.n_columns = n_columns;
+    accelerated.SetSolver(std::move(solver));
+    accelerated.PrepareComponents();
+
+    auto columns = detail::RandomColumns(full, n_columns, seed);
+    std::vector<double> full_rates;
+    std::vector<double> pca_rates;
+    report.full_seconds = detail::TimeBulkColumns(full, columns, full_rates);
+    report.pca_seconds = detail::TimeBulkColumns(accelerated, columns, pca_rates);
+    report.reactions = detail::CompareBulkRates(
+        full.PhotolysisReactions().ReactionNames(),
+        full_rates,
+        pca_rates,
+        n_columns,
+        full.AltitudeGrid().Spec().n_cells + 1,
+        relative_floor);
+    return report;
+  }
+
+}  // namespace tuvx
@@ -0,0 +1,510 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include <tuvx/model/column_state.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/util/constants.hpp>
+#include <tuvx/util/strided_view.hpp>
+
+namespace tuvx
+{
+  /// @brief How PhotolysisScheduler estimates J between full solves
+  enum class PhotolysisEstimate
+  {
+    /// Linear in cos(SZA) through the column's two most recent full solves, extended past them
+    Extrapolate,
+    /// Most recent full solve scaled by a J(SZA) curve computed for the column
+    ScaleCurve
+  };
+
+  /// @brief What PhotolysisScheduler::Step() did for a column
+  enum class PhotolysisUpdate
+  {
+    /// Rates come from a full model calculation
+    FullSolve,
+    /// Rates were extrapolated in cos(SZA) from the two latest full solves
+    Extrapolated,
+    /// Rates were scaled along the column's J(SZA) curve
+    Scaled
+  };
+
+  /// @brief Decision thresholds and error control for a PhotolysisScheduler
+  struct PhotolysisSchedulerConfig
+  {
+    /// Estimation method used between full solves
+    PhotolysisEstimate estimate{ PhotolysisEstimate::Extrapolate };
+
+    /// A full solve is made at least every this many steps of a column
+    std::size_t full_solve_interval{ 6 };
+
+    /// Largest distance from the nearest full solve that may be estimated [degrees]
+    double max_sza_change{ 5.0 };
+
+    /// A step whose SZA is on the other side of this angle than the latest full solve is solved [degrees]
+    double terminator_sza{ 90.0 };
+
+    /// Largest change in any layer temperature since the last full solve [K]
+    double max_temperature_drift{ 2.0 };
+
+    /// Largest relative change in any layer air density or ozone since the last full solve
+    double max_density_drift{ 0.02 };
+
+    /// Largest change in surface albedo since the last full solve
+    double max_albedo_drift{ 0.02 };
+
+    /// Farthest an Extrapolate estimate may reach outside the two full solves, in multiples of their
+    /// cos(SZA) spacing; steps beyond it are solved
+    double max_extrapolation{ 8.0 };
+
+    /// Number of SZA nodes in a J(SZA) curve (ScaleCurve only)
+    std::size_t curve_points{ 10 };
+
+    /// Largest SZA covered by a J(SZA) curve; larger angles are always solved [degrees]
+    double curve_max_sza{ 88.0 };
+
+    /// Every this many estimated steps of a column, solve instead and check the estimate (0 disables)
+    std::size_t verify_interval{ 0 };
+
+    /// Largest accepted verification error, relative to each reaction's peak J
+    double max_relative_error{ 0.05 };
+  };
+
+  /// @brief Counters kept by a PhotolysisScheduler
+  struct PhotolysisSchedulerStats
+  {
+    /// Calls to Step()
+    std::uint64_t steps{ 0 };
+    /// Steps answered by a full model calculation (including verifications)
+    std::uint64_t full_solves{ 0 };
+    /// Steps answered by extrapolation
+    std::uint64_t extrapolated{ 0 };
+    /// Steps answered by curve scaling
+    std::uint64_t scaled{ 0 };
+    /// Extra model calculations made to build J(SZA) curves
+    std::uint64_t curve_solves{ 0 };
+    /// Full solves forced by input drift
+    std::uint64_t drift_solves{ 0 };
+    /// Verifications made
+    std::uint64_t verifications{ 0 };
+    /// Verifications whose error exceeded max_relative_error
+    std::uint64_t verification_failures{ 0 };
+    /// Largest relative error seen by a verification
+    double max_verified_error{ 0.0 };
+
+    /// @brief Full solves avoided by estimation, less the extra solves spent on J(SZA) curves
+    std::uint64_t AvoidedSolves() const
+    {
+      std::uint64_t estimated = extrapolated + scaled;
+      return estimated > curve_solves ? estimated - curve_solves : 0;
+    }
+  };
+
+  /// @brief Calls a model only when a column's photolysis rates need a full update
+  ///
+  /// Chemistry time steps are usually minutes apart while the optical state
+  /// of a column changes slowly. For every column the scheduler remembers the
+  /// inputs and J-values of its recent full solves and answers a step by
+  /// estimation when
+  ///   - fewer than full_solve_interval steps have passed since the last full solve,
+  ///   - no layer temperature, density or the albedo has drifted past its threshold,
+  ///   - the SZA is within max_sza_change of a full solve and on the same side of
+  ///     terminator_sza as the latest one.
+  ///
+  /// Otherwise it runs TuvModel::CalculatePhotolysisRates(). Drift is measured
+  /// against the inputs of the latest full solve. Estimates either extend the
+  /// line in cos(SZA) through the last two full solves (Extrapolate; steps
+  /// more than max_extrapolation anchor spacings outside them are solved), or
+  /// scale the last full solve by J(SZA)/J(SZA_full) from a curve of
+  /// curve_points solves made for the column's inputs (ScaleCurve; the curve
+  /// is also rebuilt when the inputs drift from those it was made for). The
+  /// curve solves are subtracted from AvoidedSolves(). With verify_interval set, some
+  /// estimated steps are solved instead and the estimate's error is recorded;
+  /// the step always returns the solved rates.
+  ///
+  /// Columns are identified by caller-chosen IDs, which need not be dense:
+  /// histories are kept in a hash map, so memory follows the number of
+  /// distinct IDs seen rather than the largest one. A change of the model's
+  /// Generation() discards every column's history. The scheduler calls the
+  /// model, so it is not thread-safe; use one scheduler per model copy.
+  ///
+  /// Example usage:
+  /// @code
+  /// PhotolysisScheduler scheduler(model);
+  /// for (int step = 0; step < n_steps; ++step)
+  ///   for (std::size_t c = 0; c < n_columns; ++c)
+  ///     scheduler.Step(c, columns[c].View(), rates[c].data(), n_levels, 1);
+  /// std::cout << scheduler.Stats().AvoidedSolves() << "\n";
+  /// @endcode
+  class PhotolysisScheduler
+  {
+   public:
+    /// @brief Wrap a configured model
+    /// @param model Model used for full solves (must outlive the scheduler)
+    /// @param config Decision thresholds and error control
+    explicit PhotolysisScheduler(TuvModel& model, PhotolysisSchedulerConfig config = {})
+        : model_(model),
+          config_(config),
+          generation_(model.Generation())
+    {
+    }
+
+    /// @brief Configuration the scheduler was created with
+    const PhotolysisSchedulerConfig& Config() const
+    {
+      return config_;
+    }
+
+    /// @brief Counters since construction or the last ResetStats()
+    const PhotolysisSchedulerStats& Stats() const
+    {
+      return stats_;
+    }
+
+    /// @brief Zero the counters
+    void ResetStats()
+    {
+      stats_ = {};
+    }
+
+    /// @brief Forget every column's history so the next step of each is solved
+    void Reset()
+    {
+      columns_.clear();
+    }
+
+    /// @brief Photolysis rates for one column at one time step
+    /// @param column_id Caller-chosen ID identifying the column across steps (any value)
+    /// @param column Column inputs at this step
+    /// @param rates Destination array; J for reaction r at level l is written to
+    ///              rates[r * reaction_stride + l * level_stride]
+    /// @param reaction_stride Distance between reactions [elements]
+    /// @param level_stride Distance between levels [elements]
+    /// @return How the rates were obtained
+    /// @throws TuvxInternalException if a profile does not match the altitude grid
+    PhotolysisUpdate Step(
+        std::size_t column_id,
+        const ColumnView& column,
+        double* rates,
+        std::ptrdiff_t reaction_stride,
+        std::ptrdiff_t level_stride)
+    {
+      if (model_.Generation() != generation_)
+      {
+        generation_ = model_.Generation();
+        columns_.clear();
+      }
+      ColumnHistory& history = columns_[column_id];
+      ++stats_.steps;
+
+      n_reactions_ = model_.PhotolysisReactions().Size();
+      n_levels_ = model_.AltitudeGrid().Spec().n_cells + 1;
+
+      bool drifted = history.anchors.empty() || Drifted(history.inputs, column) ||
+                     (config_.estimate == PhotolysisEstimate::ScaleCurve && Drifted(history.curve_inputs, column));
+      if (drifted || !CanEstimate(history, column.solar_zenith_angle))
+      {
+        Solve(history, column, drifted);
+        Write(history.anchors.back().rates, rates, reaction_stride, level_stride);
+        return PhotolysisUpdate::FullSolve;
+      }
+
+      PhotolysisUpdate update = Estimate(history, column.solar_zenith_angle);
+      ++history.steps_since_solve;
+
+      if (config_.verify_interval > 0 && ++history.estimates_since_verify >= config_.verify_interval)
+      {
+        history.estimates_since_verify = 0;
+        Solve(history, column, false);
+        Verify(history.anchors.back().rates);
+        Write(history.anchors.back().rates, rates, reaction_stride, level_stride);
+        return PhotolysisUpdate::FullSolve;
+      }
+
+      if (update == PhotolysisUpdate::Extrapolated)
+      {
+        ++stats_.extrapolated;
+      }
+      else
+      {
+        ++stats_.scaled;
+      }
+      Write(estimate_, rates, reaction_stride, level_stride);
+      return update;
+    }
+
+   private:
+    /// @brief J-values from one full solve of a column
+    struct Anchor
+    {
+      double solar_zenith_angle{ 0.0 };
+      std::vector<double> rates;  // [reaction * n_levels + level]
+    };
+
+    /// @brief What the scheduler remembers about one column
+    struct ColumnHistory
+    {
+      ColumnState inputs;           // inputs of the latest full solve
+      ColumnState curve_inputs;     // inputs the curve was built for (ScaleCurve)
+      std::vector<Anchor> anchors;  // up to two, oldest first
+      std::vector<double> curve;    // [node][reaction * n_levels + level] (ScaleCurve)
+      std::size_t steps_since_solve{ 0 };
+      std::size_t estimates_since_verify{ 0 };
+    };
+
+    static double Cosine(double sza)
+    {
+      return std::cos(sza * constants::kDegreesToRadians);
+    }
+
+    static void CopyProfile(const StridedView<const double>& source, std::vector<double>& destination)
+    {
+      destination.resize(source.Size());
+      for (std::size_t i = 0; i < source.Size(); ++i)
+      {
+        destination[i] = source[i];
+      }
+    }
+
+    static bool ProfileDrifted(
+        const StridedView<const double>& current,
+        const std::vector<double>& previous,
+        double threshold,
+        bool relative)
+    {
+      if (current.Size() != previous.size())
+      {
+        return true;
+      }
+      for (std::size_t i = 0; i < previous.size(); ++i)
+      {
+        double change = std::abs(current[i] - previous[i]);
+        if (change > (relative ? threshold * std::abs(previous[i]) : threshold))
+        {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    static void CopyInputs(const ColumnView& column, ColumnState& destination)
+    {
+      destination.surface_albedo = column.surface_albedo;
+      CopyProfile(column.temperature, destination.temperature);
+      CopyProfile(column.air_density, destination.air_density);
+      CopyProfile(column.ozone, destination.ozone);
+    }
+
+    bool Drifted(const ColumnState& previous, const ColumnView& column) const
+    {
+      return std::abs(column.surface_albedo - previous.surface_albedo) > config_.max_albedo_drift ||
+             ProfileDrifted(column.temperature, previous.temperature, config_.max_temperature_drift, false) ||
+             ProfileDrifted(column.air_density, previous.air_density, config_.max_density_drift, true) ||
+             ProfileDrifted(column.ozone, previous.ozone, config_.max_density_drift, true);
+    }
+
+    bool CanEstimate(const ColumnHistory& history, double sza) const
+    {
+      if (history.steps_since_solve + 1 >= config_.full_solve_interval)
+      {
+        return false;
+      }
+      const Anchor& latest = history.anchors.back();
+      if ((sza < config_.terminator_sza) != (latest.solar_zenith_angle < config_.terminator_sza))
+      {
+        return false;
+      }
+      double nearest = std::abs(sza - latest.solar_zenith_angle);
+      for (const auto& anchor : history.anchors)
+      {
+        nearest = std::min(nearest, std::abs(sza - anchor.solar_zenith_angle));
+      }
+      if (nearest > config_.max_sza_change)
+      {
+        return false;
+      }
+      if (config_.estimate == PhotolysisEstimate::Extrapolate)
+      {
+        return history.anchors.size() == 2 && ExtrapolationWeight(history, sza).has_value();
+      }
+      return config_.curve_points >= 2 && sza >= 0.0 && sza <= config_.curve_max_sza &&
+             latest.solar_zenith_angle <= config_.curve_max_sza;
+    }
+
+    /// @brief Weight of the latest anchor in the line through both anchors at a step's cos(SZA)
+    /// @return Nothing if the step is more than max_extrapolation anchor spacings outside the anchors
+    std::optional<double> ExtrapolationWeight(const ColumnHistory& history, double sza) const
+    {
+      double mu_older = Cosine(history.anchors.front().solar_zenith_angle);
+      double mu_latest = Cosine(history.anchors.back().solar_zenith_angle);
+      double spacing = mu_latest - mu_older;
+      if (std::abs(spacing) <= 1.0e-12)
+      {
+        // Coincident anchors only reproduce themselves
+        return std::abs(Cosine(sza) - mu_latest) <= 1.0e-12 ? std::optional<double>(1.0) : std::nullopt;
+      }
+      double weight = (Cosine(sza) - mu_older) / spacing;
+      if (weight < -config_.max_extrapolation || weight > 1.0 + config_.max_extrapolation)
+      {
+        return std::nullopt;
+      }
+      return weight;
+    }
+
+    /// @brief Run the model for a column and make the result the latest anchor
+    /// @param restart True if the inputs drifted, which invalidates older anchors and the curve
+    void Solve(ColumnHistory& history, const ColumnView& column, bool restart)
+    {
+      Anchor anchor;
+      anchor.solar_zenith_angle = column.solar_zenith_angle;
+      anchor.rates.resize(n_reactions_ * n_levels_);
+      model_.CalculatePhotolysisRates(column, anchor.rates.data(), static_cast<std::ptrdiff_t>(n_levels_), 1);
+      ++stats_.full_solves;
+
+      if (restart)
+      {
+        if (!history.anchors.empty())
+        {
+          ++stats_.drift_solves;
+        }
+        history.anchors.clear();
+        history.curve.clear();
+        if (config_.estimate == PhotolysisEstimate::ScaleCurve)
+        {
+          CopyInputs(column, history.curve_inputs);
+          BuildCurve(history, column);
+        }
+      }
+      CopyInputs(column, history.inputs);
+      if (history.anchors.size() == 2)
+      {
+        history.anchors.erase(history.anchors.begin());
+      }
+      history.anchors.push_back(std::move(anchor));
+      history.steps_since_solve = 0;
+    }
+
+    double CurveNode(std::size_t node) const
+    {
+      return config_.curve_max_sza * static_cast<double>(node) / static_cast<double>(config_.curve_points - 1);
+    }
+
+    void BuildCurve(ColumnHistory& history, const ColumnView& column)
+    {
+      if (config_.curve_points < 2)
+      {
+        return;
+      }
+      std::size_t n_rates = n_reactions_ * n_levels_;
+      history.curve.resize(config_.curve_points * n_rates);
+      ColumnView node_column = column;
+      for (std::size_t node = 0; node < config_.curve_points; ++node)
+      {
+        node_column.solar_zenith_angle = CurveNode(node);
+        model_.CalculatePhotolysisRates(
+            node_column, history.curve.data() + node * n_rates, static_cast<std::ptrdiff_t>(n_levels_), 1);
+        ++stats_.curve_solves;
+      }
+    }
+
+    /// @brief Value of the J(SZA) curve at one rate index, linear in cos(SZA) between nodes
+    double CurveValue(const ColumnHistory& history, double sza, std::size_t index) const
+    {
+      std::size_t n_rates = n_reactions_ * n_levels_;
+      double position = sza / config_.curve_max_sza * static_cast<double>(config_.curve_points - 1);
+      std::size_t lower = std::min(static_cast<std::size_t>(position), config_.curve_points - 2);
+      double mu_lower = Cosine(CurveNode(lower));
+      double mu_upper = Cosine(CurveNode(lower + 1));
+      double weight = (Cosine(sza) - mu_lower) / (mu_upper - mu_lower);
+      double j_lower = history.curve[lower * n_rates + index];
+      double j_upper = history.curve[(lower + 1) * n_rates + index];
+      return j_lower + weight * (j_upper - j_lower);
+    }
+
+    PhotolysisUpdate Estimate(const ColumnHistory& history, double sza)
+    {
+      const Anchor& latest = history.anchors.back();
+      estimate_.resize(latest.rates.size());
+
+      if (config_.estimate == PhotolysisEstimate::Extrapolate)
+      {
+        const Anchor& older = history.anchors.front();
+        double weight = ExtrapolationWeight(history, sza).value_or(1.0);
+        for (std::size_t i = 0; i < estimate_.size(); ++i)
+        {
+          estimate_[i] = std::max(0.0, older.rates[i] + weight * (latest.rates[i] - older.rates[i]));
+        }
+        return PhotolysisUpdate::Extrapolated;
+      }
+
+      for (std::size_t i = 0; i < estimate_.size(); ++i)
+      {
+        double curve_now = CurveValue(history, sza, i);
+        double curve_anchor = CurveValue(history, latest.solar_zenith_angle, i);
+        double estimate = curve_anchor > 0.0 ? latest.rates[i] * (curve_now / curve_anchor) : curve_now;
+        estimate_[i] = std::max(0.0, estimate);
+      }
+      return PhotolysisUpdate::Scaled;
+    }
+
+    /// @brief Compare the pending estimate with solved rates and record the error
+    void Verify(const std::vector<double>& solved)
+    {
+      double error = 0.0;
+      for (std::size_t r = 0; r < n_reactions_; ++r)
+      {
+        double peak = 0.0;
+        double difference = 0.0;
+        for (std::size_t l = 0; l < n_levels_; ++l)
+        {
+          std::size_t i = r * n_levels_ + l;
+          peak = std::max(peak, std::abs(solved[i]));
+          difference = std::max(difference, std::abs(estimate_[i] - solved[i]));
+        }
+        if (peak > 0.0)
+        {
+          error = std::max(error, difference / peak);
+        }
+        else if (difference > 0.0)
+        {
+          error = std::max(error, 1.0);
+        }
+      }
+      ++stats_.verifications;
+      stats_.max_verified_error = std::max(stats_.max_verified_error, error);
+      if (error > config_.max_relative_error)
+      {
+        ++stats_.verification_failures;
+      }
+    }
+
+    void Write(const std::vector<double>& source, double* rates, std::ptrdiff_t reaction_stride, std::ptrdiff_t level_stride)
+        const
+    {
+      for (std::size_t r = 0; r < n_reactions_; ++r)
+      {
+        for (std::size_t l = 0; l < n_levels_; ++l)
+        {
+          rates[static_cast<std::ptrdiff_t>(r) * reaction_stride + static_cast<std::ptrdiff_t>(l) * level_stride] =
+              source[r * n_levels_ + l];
+        }
+      }
+    }
+
+    TuvModel& model_;
+    PhotolysisSchedulerConfig config_;
+    PhotolysisSchedulerStats stats_;
+    std::uint64_t generation_;
+    std::unordered_map<std::size_t, ColumnHistory> columns_;
+    std::vector<double> estimate_;
+    std::size_t n_reactions_{ 0 };
+    std::size_t n_levels_{ 0 };
+  };
+
+}  // namespace tuvx
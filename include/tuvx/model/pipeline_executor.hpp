@@ -0,0 +1,279 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <tuvx/model/batch_driver.hpp>
+#include <tuvx/model/column_workspace.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/util/internal_error.hpp>
+#include <tuvx/util/spsc_queue.hpp>
+
+namespace tuvx
+{
+  /// @brief Runs the column stages of one model as a three-thread pipeline
+  ///
+  /// TuvModel::CalculatePhotolysisRates() runs each column's stages back to
+  /// back. PipelineExecutor streams a batch through them instead:
+  ///
+  /// - stage A (calling thread): GatherColumn() + ComputeOpticalProperties()
+  /// - stage B (helper thread):  SolveColumn()
+  /// - stage C (helper thread):  IntegrateColumn()
+  ///
+  /// so column k+1's optical properties are computed while column k is
+  /// solved and column k-1's J-values are integrated. Columns move between
+  /// stages through a bounded ring of ColumnWorkspace slots; slot indices
+  /// travel on lock-free single-producer/single-consumer queues (A -> B,
+  /// B -> C, and C -> A to recycle slots). Each stage touches disjoint parts
+  /// of the model (A the radiators, B the solver, C the reactions), so one
+  /// model is shared rather than copied. Throughput is set by the slowest
+  /// stage, at most three times that of the serial path; combine with
+  /// BatchDriver replicas to use more cores.
+  ///
+  /// The two helper threads are started by the constructor, sleep between
+  /// batches and are joined by the destructor, so a call costs no thread
+  /// start-up. Results are bit-identical to
+  /// TuvModel::CalculatePhotolysisRates(). The model must not be used by
+  /// other threads during Calculate().
+  ///
+  /// Example usage:
+  /// @code
+  /// PipelineExecutor pipeline(model);
+  /// pipeline.Calculate(batch, rates);
+  /// @endcode
+  class PipelineExecutor
+  {
+   public:
+    /// @brief Create an executor for a configured model and start its stage threads
+    /// @param model Model with grids, radiators and reactions set up (must outlive the executor)
+    /// @param depth Number of workspace slots (columns in flight); at least 3 keeps every stage busy
+    /// @throws std::invalid_argument if depth is zero
+    /// @throws std::system_error if a stage thread cannot be started; any thread already started is joined first
+    explicit PipelineExecutor(TuvModel& model, std::size_t depth = 4)
+        : model_(model),
+          ring_(depth),
+          free_slots_(depth + 1),
+          to_solve_(depth + 1),
+          to_integrate_(depth + 1)
+    {
+      if (depth == 0)
+      {
+        TUVX_THROW(std::invalid_argument("PipelineExecutor depth must be positive"));
+      }
+      solver_ = std::thread([this] { SolveLoop(); });
+#if TUVX_EXCEPTIONS
+      try
+      {
+        integrator_ = std::thread([this] { IntegrateLoop(); });
+      }
+      catch (...)
+      {
+        to_solve_.Push({ 0, kStop });
+        solver_.join();
+        throw;
+      }
+#else
+      integrator_ = std::thread([this] { IntegrateLoop(); });
+#endif
+    }
+
+    PipelineExecutor(const PipelineExecutor&) = delete;
+    PipelineExecutor& operator=(const PipelineExecutor&) = delete;
+
+    /// @brief Stop and join the stage threads
+    ~PipelineExecutor()
+    {
+      to_solve_.Push({ 0, kStop });
+      solver_.join();
+      integrator_.join();
+    }
+
+    /// @brief Number of workspace slots
+    std::size_t Depth() const
+    {
+      return ring_.size();
+    }
+
+    /// @brief Calculate photolysis rates for every column in a batch
+    /// @param batch Column inputs
+    /// @param rates Destination for J-values
+    /// @throws TuvxInternalException if the batch does not match the model grids
+    ///
+    /// If a stage fails, the columns already in flight are drained, later
+    /// columns are skipped, and the first error is rethrown here. Calls on
+    /// one executor must not overlap.
+    void Calculate(const ColumnBatchView& batch, const RateBatchView& rates)
+    {
+      if (batch.n_columns == 0)
+      {
+        return;
+      }
+      detail::CheckBatch(model_, batch, rates);
+      model_.PrepareComponents();
+
+      // The stage threads are idle between calls, so the per-call state
+      // can be set here; the queues publish it to them
+      failure_.Reset();
+      rates_ = rates;
+
+      // Every slot is free at the start of a call; hand out the unused ones
+      // first and then wait for the integrator to recycle them
+      std::size_t unused = 0;
+      for (std::size_t c = 0; c < batch.n_columns && !failure_.Failed(); ++c)
+      {
+        std::size_t slot = unused < ring_.size() ? unused++ : free_slots_.Pop();
+        failure_.Guard(
+            [&]
+            {
+              model_.GatherColumn(detail::BatchColumn(model_, batch, c), ring_[slot]);
+              model_.ComputeOpticalProperties(ring_[slot]);
+            });
+        to_solve_.Push({ slot, c });
+      }
+      to_solve_.Push({ 0, kEnd });
+
+      // The integrator answers the end marker once every column has left the pipeline
+      while (free_slots_.Pop() != kEnd)
+      {
+      }
+      failure_.Rethrow();
+    }
+
+   private:
+    /// A column in flight: its workspace slot and batch index
+    struct Item
+    {
+      std::size_t slot{ 0 };
+      std::size_t column{ 0 };
+    };
+
+    /// Batch indices marking the end of a call's columns and the shutdown of the stage threads
+    static constexpr std::size_t kEnd = std::numeric_limits<std::size_t>::max();
+    static constexpr std::size_t kStop = kEnd - 1;
+
+    /// Stage B: solve each column, forwarding every item (markers included) to stage C
+    void SolveLoop()
+    {
+      for (;;)
+      {
+        Item item = to_solve_.Pop();
+        if (item.column < kStop)
+        {
+          failure_.Guard([&] { model_.SolveColumn(ring_[item.slot]); });
+        }
+        to_integrate_.Push(item);
+        if (item.column == kStop)
+        {
+          return;
+        }
+      }
+    }
+
+    /// Stage C: integrate each column and recycle its slot; echo the end marker back to stage A
+    void IntegrateLoop()
+    {
+      for (;;)
+      {
+        Item item = to_integrate_.Pop();
+        if (item.column == kStop)
+        {
+          return;
+        }
+        if (item.column == kEnd)
+        {
+          free_slots_.Push(kEnd);
+          continue;
+        }
+        failure_.Guard(
+            [&]
+            {
+              model_.IntegrateColumn(
+                  ring_[item.slot],
+                  rates_.data + static_cast<std::ptrdiff_t>(item.column) * rates_.column_stride,
+                  rates_.reaction_stride,
+                  rates_.level_stride);
+            });
+        free_slots_.Push(item.slot);
+      }
+    }
+
+    /// First error raised by any stage; later stages skip work once set
+    class Failure
+    {
+     public:
+      template<typename Func>
+      void Guard(Func&& func)
+      {
+        if (Failed())
+        {
+          return;
+        }
+#if TUVX_EXCEPTIONS
+        try
+        {
+          func();
+        }
+        catch (...)
+        {
+          bool expected = false;
+          if (failed_.compare_exchange_strong(expected, true))
+          {
+            error_ = std::current_exception();
+          }
+        }
+#else
+        func();
+#endif
+      }
+
+      bool Failed() const
+      {
+        return failed_.load(std::memory_order_acquire);
+      }
+
+      /// Called by stage A while the stage threads are idle
+      void Reset()
+      {
+        failed_.store(false, std::memory_order_relaxed);
+        error_ = nullptr;
+      }
+
+      /// Called by stage A once every column has left the pipeline
+      void Rethrow()
+      {
+#if TUVX_EXCEPTIONS
+        if (error_)
+        {
+          std::rethrow_exception(error_);
+        }
+#endif
+      }
+
+     private:
+      std::atomic<bool> failed_{ false };
+      std::exception_ptr error_;
+    };
+
+    TuvModel& model_;
+    std::vector<ColumnWorkspace> ring_;
+
+    // Slot indices between the stages; each holds every slot plus a marker
+    SpscQueue<std::size_t> free_slots_;
+    SpscQueue<Item> to_solve_;
+    SpscQueue<Item> to_integrate_;
+
+    // Per-call state, written by Calculate() while the stage threads are idle
+    RateBatchView rates_{};
+    Failure failure_;
+
+    // Declared last so the queues and state above outlive them
+    std::thread solver_;
+    std::thread integrator_;
+  };
+
+}  // namespace tuvx
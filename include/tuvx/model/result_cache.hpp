@@ -0,0 +1,497 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <tuvx/model/column_state.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/util/hash.hpp>
+#include <tuvx/util/strided_view.hpp>
+
+namespace tuvx
+{
+  /// @brief Quantization steps and memory limit for a ResultCache
+  ///
+  /// Two columns share a cache entry when every input rounds to the same
+  /// multiple of its step. A step of zero makes that input match exactly.
+  /// Solar zenith angles on either side of 90° never share an entry.
+  struct ResultCacheConfig
+  {
+    /// Upper bound on the memory held by cached entries [bytes]
+    std::size_t max_bytes{ std::size_t{ 64 } << 20 };
+
+    /// Number of independently locked shards
+    std::size_t n_shards{ 16 };
+
+    /// Solar zenith angle step [degrees]
+    double solar_zenith_angle_step{ 0.1 };
+
+    /// Surface albedo step [0-1]
+    double surface_albedo_step{ 0.01 };
+
+    /// Temperature step [K]
+    double temperature_step{ 0.5 };
+
+    /// Relative step for air density and ozone (quantized on a log scale;
+    /// zero and negative densities have buckets of their own)
+    double density_relative_step{ 1.0e-3 };
+  };
+
+  /// @brief Hit, miss and occupancy counters of a ResultCache
+  struct ResultCacheStats
+  {
+    std::uint64_t hits{ 0 };
+    std::uint64_t misses{ 0 };
+    std::uint64_t evictions{ 0 };
+    std::size_t entries{ 0 };
+    std::size_t bytes{ 0 };
+
+    /// @brief Fraction of lookups that hit (0 before the first lookup)
+    double HitRate() const
+    {
+      std::uint64_t lookups = hits + misses;
+      return lookups == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(lookups);
+    }
+  };
+
+  /// @brief Bounded LRU cache of photolysis rates keyed by quantized column inputs
+  ///
+  /// Regional runs often contain many columns whose inputs differ by less than
+  /// any meaningful amount (open ocean with climatological profiles and nearly
+  /// the same solar zenith angle). ResultCache rounds each column input (SZA,
+  /// albedo and every profile layer) to the steps in ResultCacheConfig and
+  /// returns the stored J-values for a column whose rounded inputs were seen
+  /// before. A hit returns the rates of the first column computed with those
+  /// inputs, so results differ from an uncached run by at most the effect of
+  /// the quantization steps. Columns with a NaN input, or an input too large
+  /// to count in steps, are calculated but never cached.
+  ///
+  /// Keys also hold the model's Generation(), so any configuration change
+  /// (radiators and their aerosol settings, reactions, grids, default
+  /// profiles) makes older entries unreachable; they age out through the LRU.
+  /// A cache serves one model and the copies made from it (BatchDriver
+  /// replicas); use separate caches for separately configured models.
+  ///
+  /// Entries are spread over shards that are locked independently, so one
+  /// cache can be shared by all threads of a ThreadPool or BatchDriver.
+  ///
+  /// Example usage:
+  /// @code
+  /// ResultCache cache;
+  /// BatchDriver driver(model, pool);
+  /// driver.SetCache(&cache);
+  /// driver.Calculate(batch, rates);
+  /// std::cout << cache.Stats().HitRate() << "\n";
+  /// @endcode
+  class ResultCache
+  {
+   public:
+    /// @brief Quantized column inputs with a precomputed hash
+    class Key
+    {
+     public:
+      /// @brief Hash of the quantized inputs
+      std::size_t Hash() const
+      {
+        return hash_;
+      }
+
+      /// @brief False if an input could not be quantized; such keys never hit and are never stored
+      bool Cacheable() const
+      {
+        return cacheable_;
+      }
+
+      bool operator==(const Key& other) const
+      {
+        return hash_ == other.hash_ && values_ == other.values_;
+      }
+
+     private:
+      friend class ResultCache;
+
+      std::vector<std::int64_t> values_;
+      std::size_t hash_{ 0 };
+      bool cacheable_{ true };
+    };
+
+    /// @brief Create an empty cache
+    /// @param config Quantization steps and memory limit
+    explicit ResultCache(ResultCacheConfig config = {})
+        : config_(config),
+          shards_(config.n_shards == 0 ? 1 : config.n_shards)
+    {
+    }
+
+    ResultCache(const ResultCache&) = delete;
+    ResultCache& operator=(const ResultCache&) = delete;
+
+    /// @brief Configuration the cache was created with
+    const ResultCacheConfig& Config() const
+    {
+      return config_;
+    }
+
+    /// @brief Build the key for a column calculated with a model
+    /// @param model Model that would calculate the column
+    /// @param column Column inputs, as passed to TuvModel::CalculatePhotolysisRates()
+    Key MakeKey(const TuvModel& model, const ColumnView& column) const
+    {
+      Key key;
+      std::size_t n_values = 3 + 3 * (1 + model.AltitudeGrid().Spec().n_cells);
+      key.values_.reserve(n_values);
+      key.values_.push_back(static_cast<std::int64_t>(model.Generation()));
+      AppendSolarZenithAngle(key, column.solar_zenith_angle);
+      AppendQuantized(key, column.surface_albedo, config_.surface_albedo_step);
+      AppendProfile(key, column.temperature, config_.temperature_step, false);
+      AppendProfile(key, column.air_density, config_.density_relative_step, true);
+      AppendProfile(key, column.ozone, config_.density_relative_step, true);
+
+      std::uint64_t hash = kHashSeed;
+      for (std::int64_t value : key.values_)
+      {
+        hash = HashCombine(hash, static_cast<std::uint64_t>(value));
+      }
+      key.hash_ = static_cast<std::size_t>(hash);
+      return key;
+    }
+
+    /// @brief Copy cached rates for a key into caller-owned memory
+    /// @param key Key from MakeKey()
+    /// @param rates Destination; J for reaction r at level l goes to rates[r * reaction_stride + l * level_stride]
+    /// @param reaction_stride Distance between reactions [elements]
+    /// @param level_stride Distance between levels [elements]
+    /// @param n_reactions Number of reactions expected
+    /// @param n_levels Number of levels expected
+    /// @return True on a hit; on a miss the destination is not touched
+    bool Lookup(
+        const Key& key,
+        double* rates,
+        std::ptrdiff_t reaction_stride,
+        std::ptrdiff_t level_stride,
+        std::size_t n_reactions,
+        std::size_t n_levels)
+    {
+      Shard& shard = ShardFor(key);
+      if (key.Cacheable())
+      {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto found = shard.index.find(&key);
+        if (found != shard.index.end() && found->second->n_reactions == n_reactions &&
+            found->second->n_levels == n_levels)
+        {
+          shard.entries.splice(shard.entries.begin(), shard.entries, found->second);
+          const Entry& entry = *found->second;
+          for (std::size_t r = 0; r < n_reactions; ++r)
+          {
+            for (std::size_t l = 0; l < n_levels; ++l)
+            {
+              rates[static_cast<std::ptrdiff_t>(r) * reaction_stride + static_cast<std::ptrdiff_t>(l) * level_stride] =
+                  entry.rates[r * n_levels + l];
+            }
+          }
+          hits_.fetch_add(1, std::memory_order_relaxed);
+          return true;
+        }
+      }
+      misses_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    /// @brief Store rates for a key, evicting least recently used entries to stay within max_bytes
+    /// @param key Key from MakeKey()
+    /// @param rates Source; J for reaction r at level l is read from rates[r * reaction_stride + l * level_stride]
+    /// @param reaction_stride Distance between reactions [elements]
+    /// @param level_stride Distance between levels [elements]
+    /// @param n_reactions Number of reactions
+    /// @param n_levels Number of levels
+    ///
+    /// An existing entry for the key is replaced. Entries larger than one
+    /// shard's share of max_bytes, and keys that are not Cacheable(), are not
+    /// stored.
+    void Insert(
+        Key key,
+        const double* rates,
+        std::ptrdiff_t reaction_stride,
+        std::ptrdiff_t level_stride,
+        std::size_t n_reactions,
+        std::size_t n_levels)
+    {
+      if (!key.Cacheable())
+      {
+        return;
+      }
+      Entry entry;
+      entry.n_reactions = n_reactions;
+      entry.n_levels = n_levels;
+      entry.rates.resize(n_reactions * n_levels);
+      for (std::size_t r = 0; r < n_reactions; ++r)
+      {
+        for (std::size_t l = 0; l < n_levels; ++l)
+        {
+          entry.rates[r * n_levels + l] =
+              rates[static_cast<std::ptrdiff_t>(r) * reaction_stride + static_cast<std::ptrdiff_t>(l) * level_stride];
+        }
+      }
+      entry.bytes = sizeof(Entry) + kNodeOverhead + key.values_.capacity() * sizeof(std::int64_t) +
+                    entry.rates.capacity() * sizeof(double);
+      entry.key = std::move(key);
+
+      std::size_t shard_budget = config_.max_bytes / shards_.size();
+      if (entry.bytes > shard_budget)
+      {
+        return;
+      }
+
+      Shard& shard = ShardFor(entry.key);
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      auto found = shard.index.find(&entry.key);
+      if (found != shard.index.end())
+      {
+        Erase(shard, found->second);
+      }
+      while (!shard.entries.empty() && shard.bytes + entry.bytes > shard_budget)
+      {
+        Erase(shard, std::prev(shard.entries.end()));
+        evictions_.fetch_add(1, std::memory_order_relaxed);
+      }
+      shard.bytes += entry.bytes;
+      shard.entries.push_front(std::move(entry));
+      shard.index.emplace(&shard.entries.front().key, shard.entries.begin());
+    }
+
+    /// @brief Calculate photolysis rates for one column, using the cache when possible
+    /// @param model Model used on a miss; also supplies the key's generation
+    /// @param column Column inputs
+    /// @param rates Destination array (see TuvModel::CalculatePhotolysisRates())
+    /// @param reaction_stride Distance between reactions [elements]
+    /// @param level_stride Distance between levels [elements]
+    /// @return True if the rates came from the cache
+    bool CalculatePhotolysisRates(
+        TuvModel& model,
+        const ColumnView& column,
+        double* rates,
+        std::ptrdiff_t reaction_stride,
+        std::ptrdiff_t level_stride)
+    {
+      return CalculatePhotolysisRates(MakeKey(model, column), model, column, rates, reaction_stride, level_stride);
+    }
+
+    /// @brief Calculate photolysis rates for one column with a key built beforehand
+    /// @param key Key from MakeKey() for the same column
+    /// @param model Model used on a miss (may be a copy of the model the key was built from)
+    /// @param column Column inputs
+    /// @param rates Destination array (see TuvModel::CalculatePhotolysisRates())
+    /// @param reaction_stride Distance between reactions [elements]
+    /// @param level_stride Distance between levels [elements]
+    /// @return True if the rates came from the cache
+    bool CalculatePhotolysisRates(
+        Key key,
+        TuvModel& model,
+        const ColumnView& column,
+        double* rates,
+        std::ptrdiff_t reaction_stride,
+        std::ptrdiff_t level_stride)
+    {
+      std::size_t n_reactions = model.PhotolysisReactions().Size();
+      std::size_t n_levels = model.AltitudeGrid().Spec().n_cells + 1;
+      if (Lookup(key, rates, reaction_stride, level_stride, n_reactions, n_levels))
+      {
+        return true;
+      }
+      model.CalculatePhotolysisRates(column, rates, reaction_stride, level_stride);
+      Insert(std::move(key), rates, reaction_stride, level_stride, n_reactions, n_levels);
+      return false;
+    }
+
+    /// @brief Current counters
+    ResultCacheStats Stats() const
+    {
+      ResultCacheStats stats;
+      stats.hits = hits_.load(std::memory_order_relaxed);
+      stats.misses = misses_.load(std::memory_order_relaxed);
+      stats.evictions = evictions_.load(std::memory_order_relaxed);
+      for (const auto& shard : shards_)
+      {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        stats.entries += shard.entries.size();
+        stats.bytes += shard.bytes;
+      }
+      return stats;
+    }
+
+    /// @brief Remove every entry and reset the counters
+    void Clear()
+    {
+      for (auto& shard : shards_)
+      {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.index.clear();
+        shard.entries.clear();
+        shard.bytes = 0;
+      }
+      hits_ = 0;
+      misses_ = 0;
+      evictions_ = 0;
+    }
+
+   private:
+    /// Approximate per-entry cost of the list node and index slot [bytes]
+    static constexpr std::size_t kNodeOverhead = 64;
+
+    /// Marks a profile taken from the model configuration
+    static constexpr std::int64_t kDefaultProfile = std::numeric_limits<std::int64_t>::min();
+
+    /// Stands in for a zero density
+    static constexpr std::int64_t kZero = std::numeric_limits<std::int64_t>::min() + 1;
+
+    /// Precedes the log-scale bucket of a negative density's magnitude
+    static constexpr std::int64_t kNegative = std::numeric_limits<std::int64_t>::min() + 2;
+
+    /// Largest step count a bucket may hold; the markers above lie far outside
+    static constexpr double kMaxSteps = 0x1p61;
+
+    struct Entry
+    {
+      Key key;
+      std::size_t n_reactions{ 0 };
+      std::size_t n_levels{ 0 };
+      std::vector<double> rates;
+      std::size_t bytes{ 0 };
+    };
+
+    struct KeyPointerHash
+    {
+      std::size_t operator()(const Key* key) const
+      {
+        return key->Hash();
+      }
+    };
+
+    struct KeyPointerEqual
+    {
+      bool operator()(const Key* a, const Key* b) const
+      {
+        return *a == *b;
+      }
+    };
+
+    struct Shard
+    {
+      mutable std::mutex mutex;
+      std::list<Entry> entries;  // most recently used first
+      std::unordered_map<const Key*, std::list<Entry>::iterator, KeyPointerHash, KeyPointerEqual> index;
+      std::size_t bytes{ 0 };
+    };
+
+    /// @brief Round a step count to its bucket
+    /// @return The bucket, or 0 with the key marked not cacheable if the count is NaN or beyond kMaxSteps
+    static std::int64_t Round(double steps, Key& key)
+    {
+      if (!(std::abs(steps) < kMaxSteps))
+      {
+        key.cacheable_ = false;
+        return 0;
+      }
+      return static_cast<std::int64_t>(std::llround(steps));
+    }
+
+    /// @brief Append the nearest multiple of step, or the exact value for a zero step
+    static void AppendQuantized(Key& key, double value, double step)
+    {
+      if (step <= 0.0)
+      {
+        key.cacheable_ = key.cacheable_ && !std::isnan(value);
+        key.values_.push_back(std::bit_cast<std::int64_t>(value));
+        return;
+      }
+      key.values_.push_back(Round(value / step, key));
+    }
+
+    /// @brief Append the solar zenith angle, with the bucket that holds 90° split in two
+    ///
+    /// Rounding alone would put 89.95° (sunlit) and 90.04° (past the
+    /// terminator) in one bucket at a 0.1° step.
+    void AppendSolarZenithAngle(Key& key, double solar_zenith_angle) const
+    {
+      double step = config_.solar_zenith_angle_step;
+      if (step <= 0.0)
+      {
+        AppendQuantized(key, solar_zenith_angle, step);
+        return;
+      }
+      std::int64_t bucket = Round(solar_zenith_angle / step, key);
+      key.values_.push_back(2 * bucket + (solar_zenith_angle > 90.0 ? 1 : 0));
+    }
+
+    /// @brief Append a density on a log scale; zero and negative values get buckets of their own
+    static void AppendRelative(Key& key, double value, double relative_step)
+    {
+      if (relative_step <= 0.0)
+      {
+        AppendQuantized(key, value, relative_step);
+        return;
+      }
+      if (value == 0.0)
+      {
+        key.values_.push_back(kZero);
+        return;
+      }
+      if (value < 0.0)
+      {
+        key.values_.push_back(kNegative);
+        value = -value;
+      }
+      key.values_.push_back(Round(std::log(value) / std::log1p(relative_step), key));
+    }
+
+    void AppendProfile(Key& key, const StridedView<const double>& profile, double step, bool relative) const
+    {
+      if (profile.Empty())
+      {
+        key.values_.push_back(kDefaultProfile);
+        return;
+      }
+      key.values_.push_back(static_cast<std::int64_t>(profile.Size()));
+      for (std::size_t i = 0; i < profile.Size(); ++i)
+      {
+        if (relative)
+        {
+          AppendRelative(key, profile[i], step);
+        }
+        else
+        {
+          AppendQuantized(key, profile[i], step);
+        }
+      }
+    }
+
+    Shard& ShardFor(const Key& key)
+    {
+      return shards_[MixHash(key.Hash()) % shards_.size()];
+    }
+
+    static void Erase(Shard& shard, std::list<Entry>::iterator entry)
+    {
+      shard.index.erase(&entry->key);
+      shard.bytes -= entry->bytes;
+      shard.entries.erase(entry);
+    }
+
+    ResultCacheConfig config_;
+    std::vector<Shard> shards_;
+    std::atomic<std::uint64_t> hits_{ 0 };
+    std::atomic<std::uint64_t> misses_{ 0 };
+    std::atomic<std::uint64_t> evictions_{ 0 };
+  };
+
+}  // namespace tuvx
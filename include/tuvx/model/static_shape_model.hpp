@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <tuvx/model/model_config.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/solver/static_delta_eddington.hpp>
+#include <tuvx/util/internal_error.hpp>
+
+namespace tuvx
+{
+  /// @brief TuvModel specialized for a grid shape fixed at compile time
+  /// @tparam NL Number of altitude layers
+  /// @tparam NW Number of wavelength bins
+  ///
+  /// A TuvModel in every respect (grids, radiators, reactions, batch and
+  /// C API use) except that it solves with StaticDeltaEddingtonSolver<NL, NW>.
+  /// Results are bit-identical to TuvModel with the same configuration.
+  /// The configuration must produce NL layers and NW wavelength bins;
+  /// changing the grid shape afterwards makes Calculate() throw.
+  ///
+  /// Example usage:
+  /// @code
+  /// using ProductionModel = StaticShapeModel<80, 140>;
+  /// ModelConfig config;  // defaults: 80 layers, 140 wavelength bins
+  /// ProductionModel model(config);
+  /// model.AddStandardRadiators();
+  /// @endcode
+  template<std::size_t NL, std::size_t NW>
+  class StaticShapeModel : public TuvModel
+  {
+   public:
+    static constexpr std::size_t kLayers = NL;
+    static constexpr std::size_t kWavelengths = NW;
+
+    /// @brief Construct the model
+    /// @param config Model configuration; must give NL layers and NW wavelength bins
+    /// @throws std::invalid_argument if the grid shape does not match
+    explicit StaticShapeModel(const ModelConfig& config = ModelConfig{})
+        : TuvModel(config)
+    {
+      std::size_t n_layers = AltitudeGrid().Spec().n_cells;
+      std::size_t n_wavelengths = WavelengthGrid().Spec().n_cells;
+      if (n_layers != NL || n_wavelengths != NW)
+      {
+        TUVX_THROW(std::invalid_argument(
+            "StaticShapeModel<" + std::to_string(NL) + ", " + std::to_string(NW) + "> configured with " +
+            std::to_string(n_layers) + " layers and " + std::to_string(n_wavelengths) + " wavelength bins"));
+      }
+      SetSolver(std::make_unique<StaticDeltaEddingtonSolver<NL, NW>>());
+    }
+  };
+
+}  // namespace tuvx
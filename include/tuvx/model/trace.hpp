@@ -0,0 +1,1010 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <tuvx/model/column_state.hpp>
+#include <tuvx/model/model_config.hpp>
+#include <tuvx/model/model_output.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/radiator/types/aerosol.hpp>
+#include <tuvx/util/internal_error.hpp>
+
+namespace tuvx
+{
+  /// @brief Model setup captured in a trace
+  ///
+  /// Everything needed to rebuild the model that made a recorded call, except
+  /// the reactions themselves: cross-sections and quantum yields are code, so
+  /// only reaction names are stored and the replayer supplies the reactions.
+  struct TraceSetup
+  {
+    /// Configuration in effect for the call (grids, profiles, albedo, ...)
+    ModelConfig config;
+
+    /// Radiator names in the order they were added
+    std::vector<std::string> radiators;
+
+    /// Aerosol optical properties, if an "aerosol" radiator was present
+    std::optional<AerosolRadiator::Config> aerosol;
+
+    /// Photolysis reaction names in the order they were added
+    std::vector<std::string> reactions;
+  };
+
+  /// @brief One recorded Calculate() or CalculatePhotolysisRates() call
+  struct TraceCall
+  {
+    /// Index of the setup in effect (into Trace::setups)
+    std::size_t setup{ 0 };
+
+    /// Solar zenith angle [degrees]
+    double solar_zenith_angle{ 0.0 };
+
+    /// Number of levels per reaction in rates (0 if outputs were not recorded)
+    std::size_t n_levels{ 0 };
+
+    /// Recorded J-values, rates[r * n_levels + l] for the setup's reactions
+    std::vector<double> rates;
+
+    /// Column inputs of a CalculatePhotolysisRates() call; empty for Calculate()
+    std::optional<ColumnState> column;
+
+    /// @brief True if this call carries reference outputs
+    bool HasOutputs() const
+    {
+      return !rates.empty();
+    }
+  };
+
+  /// @brief A decoded trace: distinct setups and the calls that used them
+  struct Trace
+  {
+    std::vector<TraceSetup> setups;
+    std::vector<TraceCall> calls;
+  };
+
+  namespace trace_format
+  {
+    /// File signature ("TUVXTRC" and a terminating null)
+    inline constexpr char kMagic[8] = { 'T', 'U', 'V', 'X', 'T', 'R', 'C', '\0' };
+
+    /// Format version, bumped on any layout change
+    inline constexpr std::uint32_t kVersion = 2;
+
+    /// Oldest version still read (version 1 has no column records)
+    inline constexpr std::uint32_t kMinimumVersion = 1;
+
+    /// Written in native order to detect traces from a different byte order
+    inline constexpr std::uint32_t kByteOrderMark = 0x01020304;
+
+    /// Record tags
+    inline constexpr std::uint8_t kSetupRecord = 1;
+    inline constexpr std::uint8_t kCallRecord = 2;
+    inline constexpr std::uint8_t kColumnRecord = 3;
+
+    /// Largest piece of a record read at once, so a corrupt size cannot force a huge allocation
+    inline constexpr std::size_t kReadChunkBytes = std::size_t{ 1 } << 20;
+
+    /// @brief Appends native-order binary fields to a byte buffer
+    class Encoder
+    {
+     public:
+      explicit Encoder(std::string& buffer)
+          : buffer_(buffer)
+      {
+      }
+
+      template<typename T>
+      void Put(T value)
+      {
+        char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        buffer_.append(bytes, sizeof(T));
+      }
+
+      void PutBool(bool value)
+      {
+        Put<std::uint8_t>(value ? 1 : 0);
+      }
+
+      void PutSize(std::size_t value)
+      {
+        Put<std::uint64_t>(static_cast<std::uint64_t>(value));
+      }
+
+      void PutString(const std::string& value)
+      {
+        PutSize(value.size());
+        buffer_.append(value);
+      }
+
+      void PutDoubles(const std::vector<double>& values)
+      {
+        PutSize(values.size());
+        buffer_.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(double));
+      }
+
+      void PutDoubles(const StridedView<const double>& values)
+      {
+        PutSize(values.Size());
+        for (std::size_t i = 0; i < values.Size(); ++i)
+        {
+          Put(values[i]);
+        }
+      }
+
+     private:
+      std::string& buffer_;
+    };
+
+    /// @brief Reads native-order binary fields from a byte buffer
+    class Decoder
+    {
+     public:
+      explicit Decoder(const std::string& buffer)
+          : buffer_(buffer)
+      {
+      }
+
+      template<typename T>
+      T Get()
+      {
+        Require(sizeof(T));
+        T value;
+        std::memcpy(&value, buffer_.data() + position_, sizeof(T));
+        position_ += sizeof(T);
+        return value;
+      }
+
+      bool GetBool()
+      {
+        return Get<std::uint8_t>() != 0;
+      }
+
+      std::size_t GetSize()
+      {
+        return static_cast<std::size_t>(Get<std::uint64_t>());
+      }
+
+      /// @brief Read an element count, rejecting one the remaining bytes cannot hold
+      /// @param min_element_size Fewest bytes one encoded element takes
+      std::size_t GetCount(std::size_t min_element_size)
+      {
+        std::size_t n = GetSize();
+        if (n > Remaining() / min_element_size)
+        {
+          TUVX_THROW(std::runtime_error("Trace record is truncated"));
+        }
+        return n;
+      }
+
+      std::string GetString()
+      {
+        std::size_t n = GetSize();
+        Require(n);
+        std::string value = buffer_.substr(position_, n);
+        position_ += n;
+        return value;
+      }
+
+      std::vector<double> GetDoubles()
+      {
+        std::size_t n = GetSize();
+        if (n > (buffer_.size() - position_) / sizeof(double))
+        {
+          TUVX_THROW(std::runtime_error("Trace record is truncated"));
+        }
+        std::vector<double> values(n);
+        std::memcpy(values.data(), buffer_.data() + position_, n * sizeof(double));
+        position_ += n * sizeof(double);
+        return values;
+      }
+
+      bool AtEnd() const
+      {
+        return position_ == buffer_.size();
+      }
+
+      std::size_t Remaining() const
+      {
+        return buffer_.size() - position_;
+      }
+
+     private:
+      void Require(std::size_t n) const
+      {
+        if (n > buffer_.size() - position_)
+        {
+          TUVX_THROW(std::runtime_error("Trace record is truncated"));
+        }
+      }
+
+      const std::string& buffer_;
+      std::size_t position_{ 0 };
+    };
+
+    inline void EncodeSetup(const TraceSetup& setup, std::string& buffer)
+    {
+      Encoder out(buffer);
+      const ModelConfig& c = setup.config;
+      out.PutDoubles(c.wavelength_edges);
+      out.Put(c.wavelength_min);
+      out.Put(c.wavelength_max);
+      out.PutSize(c.n_wavelength_bins);
+      out.PutDoubles(c.altitude_edges);
+      out.Put(c.altitude_min);
+      out.Put(c.altitude_max);
+      out.PutSize(c.n_altitude_layers);
+      out.Put(c.solar_zenith_angle);
+      out.Put<std::int32_t>(c.day_of_year);
+      out.Put(c.earth_sun_distance);
+      out.Put(c.latitude);
+      out.Put(c.longitude);
+      out.Put(c.surface_altitude);
+      out.Put(c.surface_albedo);
+      out.PutDoubles(c.surface_albedo_spectrum);
+      out.PutDoubles(c.temperature_profile);
+      out.PutDoubles(c.pressure_profile);
+      out.PutDoubles(c.air_density_profile);
+      out.PutDoubles(c.ozone_profile);
+      out.Put(c.ozone_column_DU);
+      out.PutString(c.solver_type);
+      out.PutBool(c.use_spherical_geometry);
+      out.PutBool(c.use_refraction);
+      out.Put(c.earth_radius);
+      out.PutBool(c.calculate_actinic_flux);
+      out.PutBool(c.calculate_irradiance);
+
+      out.PutSize(setup.radiators.size());
+      for (const auto& name : setup.radiators)
+      {
+        out.PutString(name);
+      }
+      out.PutBool(setup.aerosol.has_value());
+      if (setup.aerosol)
+      {
+        const auto& a = *setup.aerosol;
+        out.Put(a.optical_depth_ref);
+        out.Put(a.wavelength_ref);
+        out.Put(a.angstrom_exponent);
+        out.Put(a.scale_height);
+        out.Put(a.single_scattering_albedo);
+        out.Put(a.asymmetry_factor);
+        out.PutDoubles(a.ssa_wavelengths);
+        out.PutDoubles(a.ssa_values);
+        out.PutDoubles(a.g_wavelengths);
+        out.PutDoubles(a.g_values);
+      }
+      out.PutSize(setup.reactions.size());
+      for (const auto& name : setup.reactions)
+      {
+        out.PutString(name);
+      }
+    }
+
+    inline TraceSetup DecodeSetup(const std::string& buffer)
+    {
+      Decoder in(buffer);
+      TraceSetup setup;
+      ModelConfig& c = setup.config;
+      c.wavelength_edges = in.GetDoubles();
+      c.wavelength_min = in.Get<double>();
+      c.wavelength_max = in.Get<double>();
+      c.n_wavelength_bins = in.GetSize();
+      c.altitude_edges = in.GetDoubles();
+      c.altitude_min = in.Get<double>();
+      c.altitude_max = in.Get<double>();
+      c.n_altitude_layers = in.GetSize();
+      c.solar_zenith_angle = in.Get<double>();
+      c.day_of_year = in.Get<std::int32_t>();
+      c.earth_sun_distance = in.Get<double>();
+      c.latitude = in.Get<double>();
+      c.longitude = in.Get<double>();
+      c.surface_altitude = in.Get<double>();
+      c.surface_albedo = in.Get<double>();
+      c.surface_albedo_spectrum = in.GetDoubles();
+      c.temperature_profile = in.GetDoubles();
+      c.pressure_profile = in.GetDoubles();
+      c.air_density_profile = in.GetDoubles();
+      c.ozone_profile = in.GetDoubles();
+      c.ozone_column_DU = in.Get<double>();
+      c.solver_type = in.GetString();
+      c.use_spherical_geometry = in.GetBool();
+      c.use_refraction = in.GetBool();
+      c.earth_radius = in.Get<double>();
+      c.calculate_actinic_flux = in.GetBool();
+      c.calculate_irradiance = in.GetBool();
+
+      setup.radiators.resize(in.GetCount(sizeof(std::uint64_t)));
+      for (auto& name : setup.radiators)
+      {
+        name = in.GetString();
+      }
+      if (in.GetBool())
+      {
+        AerosolRadiator::Config a;
+        a.optical_depth_ref = in.Get<double>();
+        a.wavelength_ref = in.Get<double>();
+        a.angstrom_exponent = in.Get<double>();
+        a.scale_height = in.Get<double>();
+        a.single_scattering_albedo = in.Get<double>();
+        a.asymmetry_factor = in.Get<double>();
+        a.ssa_wavelengths = in.GetDoubles();
+        a.ssa_values = in.GetDoubles();
+        a.g_wavelengths = in.GetDoubles();
+        a.g_values = in.GetDoubles();
+        setup.aerosol = std::move(a);
+      }
+      setup.reactions.resize(in.GetCount(sizeof(std::uint64_t)));
+      for (auto& name : setup.reactions)
+      {
+        name = in.GetString();
+      }
+      if (!in.AtEnd())
+      {
+        TUVX_THROW(std::runtime_error("Trace setup record has trailing bytes"));
+      }
+      return setup;
+    }
+
+    /// @brief Append reaction and level counts and, unless n_levels is 0, the J-values
+    inline void EncodeRates(
+        Encoder& out,
+        std::size_t n_reactions,
+        std::size_t n_levels,
+        const double* rates,
+        std::ptrdiff_t reaction_stride,
+        std::ptrdiff_t level_stride)
+    {
+      out.PutSize(n_reactions);
+      out.PutSize(n_levels);
+      if (n_levels == 0)
+      {
+        return;
+      }
+      for (std::size_t r = 0; r < n_reactions; ++r)
+      {
+        for (std::size_t l = 0; l < n_levels; ++l)
+        {
+          out.Put(rates[static_cast<std::ptrdiff_t>(r) * reaction_stride + static_cast<std::ptrdiff_t>(l) * level_stride]);
+        }
+      }
+    }
+
+    /// @brief Read the counts and J-values written by EncodeRates()
+    /// @param in Decoder positioned at the counts
+    /// @param call Call to fill
+    /// @param expected_reactions Reaction count of the call's setup
+    /// @throws std::runtime_error if the record's reaction count differs from the setup's
+    inline void DecodeRates(Decoder& in, TraceCall& call, std::size_t expected_reactions)
+    {
+      std::size_t n_reactions = in.GetSize();
+      if (n_reactions != expected_reactions)
+      {
+        TUVX_THROW(std::runtime_error(
+            "Trace call record has " + std::to_string(n_reactions) + " reactions but its setup has " +
+            std::to_string(expected_reactions)));
+      }
+      call.n_levels = in.GetSize();
+      if (call.n_levels != 0 && n_reactions > in.Remaining() / sizeof(double) / call.n_levels)
+      {
+        TUVX_THROW(std::runtime_error("Trace record is truncated"));
+      }
+      call.rates.resize(n_reactions * call.n_levels);
+      for (auto& rate : call.rates)
+      {
+        rate = in.Get<double>();
+      }
+      if (!in.AtEnd())
+      {
+        TUVX_THROW(std::runtime_error("Trace call record has trailing bytes"));
+      }
+    }
+
+    /// @brief Bytes between the read position and the end of a seekable stream
+    /// @return The count, or nothing if the stream cannot seek
+    inline std::optional<std::uint64_t> RemainingBytes(std::istream& stream)
+    {
+      std::istream::pos_type position = stream.tellg();
+      if (position == std::istream::pos_type(-1))
+      {
+        return std::nullopt;
+      }
+      stream.seekg(0, std::ios::end);
+      std::istream::pos_type end = stream.tellg();
+      stream.seekg(position);
+      if (end == std::istream::pos_type(-1) || !stream)
+      {
+        stream.clear();
+        stream.seekg(position);
+        return std::nullopt;
+      }
+      return static_cast<std::uint64_t>(end - position);
+    }
+
+    /// @brief Read a record payload in bounded chunks
+    /// @throws std::runtime_error if the stream ends first
+    inline void ReadPayload(std::istream& stream, std::uint64_t size, std::string& payload)
+    {
+      payload.clear();
+      while (payload.size() < size)
+      {
+        std::size_t offset = payload.size();
+        auto chunk = static_cast<std::size_t>(std::min<std::uint64_t>(size - offset, kReadChunkBytes));
+        payload.resize(offset + chunk);
+        if (!stream.read(payload.data() + offset, static_cast<std::streamsize>(chunk)))
+        {
+          TUVX_THROW(std::runtime_error("Trace record is truncated"));
+        }
+      }
+    }
+  }  // namespace trace_format
+
+  /// @brief Capture the setup of a model for a trace
+  /// @param model Model to describe
+  /// @return Configuration, radiator and reaction names, aerosol properties
+  inline TraceSetup CaptureTraceSetup(const TuvModel& model)
+  {
+    TraceSetup setup;
+    setup.config = model.Config();
+    setup.radiators = model.Radiators().Names();
+    for (const auto& name : setup.radiators)
+    {
+      if (auto* aerosol = dynamic_cast<const AerosolRadiator*>(&model.Radiators().Get(name)))
+      {
+        setup.aerosol = aerosol->GetConfig();
+      }
+    }
+    setup.reactions = model.PhotolysisReactions().ReactionNames();
+    return setup;
+  }
+
+  /// @brief Records TuvModel inputs to a compact binary trace
+  ///
+  /// A trace is a header followed by setup and call records. A setup record
+  /// (configuration, profiles, albedo, radiators, aerosol properties and
+  /// reaction names) is only written when it differs from the previous one,
+  /// so a run that changes only the solar zenith angle costs 8 bytes per call
+  /// plus, optionally, the J-values used as a reference for regression checks.
+  /// The setup is only captured again when the model's Generation() changes.
+  ///
+  /// Calculate(solar_zenith_angle) calls are written as call records;
+  /// CalculatePhotolysisRates() calls as column records, which also hold the
+  /// column's albedo and any profiles it supplied.
+  ///
+  /// Example usage:
+  /// @code
+  /// TraceWriter writer("columns.trace");
+  /// writer.Attach(model);
+  /// model.Calculate(30.0);  // recorded
+  /// @endcode
+  ///
+  /// The file layout is native byte order; the header holds a byte-order
+  /// mark so traces moved to a machine with a different byte order are
+  /// rejected rather than misread.
+  class TraceWriter
+  {
+   public:
+    /// @brief Record to a file
+    /// @param path Output file (truncated)
+    /// @param record_outputs Also store J-values for result checking
+    /// @throws std::runtime_error if the file cannot be opened
+    explicit TraceWriter(const std::string& path, bool record_outputs = true)
+        : file_(std::make_unique<std::ofstream>(path, std::ios::binary | std::ios::trunc)),
+          stream_(*file_),
+          record_outputs_(record_outputs)
+    {
+      if (!*file_)
+      {
+        TUVX_THROW(std::runtime_error("Cannot open trace file '" + path + "' for writing"));
+      }
+      WriteHeader();
+    }
+
+    /// @brief Record to a caller-owned stream
+    /// @param stream Binary output stream (must outlive the writer)
+    /// @param record_outputs Also store J-values for result checking
+    explicit TraceWriter(std::ostream& stream, bool record_outputs = true)
+        : stream_(stream),
+          record_outputs_(record_outputs)
+    {
+      WriteHeader();
+    }
+
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    /// @brief Record every subsequent Calculate() and CalculatePhotolysisRates() call of a model
+    /// @param model Model to observe; the writer must outlive the attachment
+    void Attach(TuvModel& model)
+    {
+      model.SetCalculateObserver([this](const TuvModel& m, double sza, const ModelOutput& output)
+                                 { Record(m, sza, output); });
+      model.SetColumnObserver(
+          [this](const TuvModel& m, const ColumnView& column, const double* rates, std::ptrdiff_t rs, std::ptrdiff_t ls)
+          { RecordColumn(m, column, rates, rs, ls); });
+    }
+
+    /// @brief Record one call
+    /// @param model Model that made the call
+    /// @param solar_zenith_angle Solar zenith angle of the call [degrees]
+    /// @param output Output of the call (J-values stored if enabled)
+    void Record(const TuvModel& model, double solar_zenith_angle, const ModelOutput& output)
+    {
+      WriteSetupIfChanged(model);
+
+      scratch_.clear();
+      trace_format::Encoder out(scratch_);
+      out.Put(solar_zenith_angle);
+      std::size_t n_levels = 0;
+      if (record_outputs_ && !output.photolysis_rates.empty())
+      {
+        n_levels = output.photolysis_rates.front().rates.size();
+      }
+      out.PutSize(output.photolysis_rates.size());
+      out.PutSize(n_levels);
+      if (n_levels > 0)
+      {
+        for (const auto& result : output.photolysis_rates)
+        {
+          if (result.rates.size() != n_levels)
+          {
+            TUVX_THROW(std::runtime_error("Cannot record reactions with different level counts"));
+          }
+          const char* bytes = reinterpret_cast<const char*>(result.rates.data());
+          scratch_.append(bytes, n_levels * sizeof(double));
+        }
+      }
+      WriteRecord(trace_format::kCallRecord, scratch_);
+      ++n_calls_;
+    }
+
+    /// @brief Record one CalculatePhotolysisRates() call
+    /// @param model Model that made the call
+    /// @param column Column inputs of the call
+    /// @param rates J-values written by the call (stored if enabled)
+    /// @param reaction_stride Distance between reactions in rates [elements]
+    /// @param level_stride Distance between levels in rates [elements]
+    void RecordColumn(
+        const TuvModel& model,
+        const ColumnView& column,
+        const double* rates,
+        std::ptrdiff_t reaction_stride,
+        std::ptrdiff_t level_stride)
+    {
+      WriteSetupIfChanged(model);
+
+      scratch_.clear();
+      trace_format::Encoder out(scratch_);
+      out.Put(column.solar_zenith_angle);
+      out.Put(column.surface_albedo);
+      out.PutDoubles(column.temperature);
+      out.PutDoubles(column.air_density);
+      out.PutDoubles(column.ozone);
+      std::size_t n_levels = record_outputs_ ? model.AltitudeGrid().Spec().n_cells + 1 : 0;
+      trace_format::EncodeRates(out, model.PhotolysisReactions().Size(), n_levels, rates, reaction_stride, level_stride);
+      WriteRecord(trace_format::kColumnRecord, scratch_);
+      ++n_calls_;
+    }
+
+    /// @brief Flush buffered records to the stream
+    void Flush()
+    {
+      stream_.flush();
+    }
+
+    /// @brief Number of call records written
+    std::size_t CallsWritten() const
+    {
+      return n_calls_;
+    }
+
+    /// @brief Number of setup records written
+    std::size_t SetupsWritten() const
+    {
+      return n_setups_;
+    }
+
+   private:
+    /// @brief Write a setup record if the model's setup differs from the last one written
+    void WriteSetupIfChanged(const TuvModel& model)
+    {
+      if (n_setups_ > 0 && &model == setup_model_ && model.Generation() == setup_generation_)
+      {
+        return;
+      }
+      setup_model_ = &model;
+      setup_generation_ = model.Generation();
+
+      scratch_.clear();
+      trace_format::EncodeSetup(CaptureTraceSetup(model), scratch_);
+      if (n_setups_ == 0 || scratch_ != last_setup_)
+      {
+        WriteRecord(trace_format::kSetupRecord, scratch_);
+        last_setup_.swap(scratch_);
+        ++n_setups_;
+      }
+    }
+
+    void WriteHeader()
+    {
+      std::string header(trace_format::kMagic, sizeof(trace_format::kMagic));
+      trace_format::Encoder out(header);
+      out.Put(trace_format::kVersion);
+      out.Put(trace_format::kByteOrderMark);
+      stream_.write(header.data(), static_cast<std::streamsize>(header.size()));
+    }
+
+    void WriteRecord(std::uint8_t tag, const std::string& payload)
+    {
+      std::string prefix;
+      trace_format::Encoder out(prefix);
+      out.Put(tag);
+      out.PutSize(payload.size());
+      stream_.write(prefix.data(), static_cast<std::streamsize>(prefix.size()));
+      stream_.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+      if (!stream_)
+      {
+        TUVX_THROW(std::runtime_error("Failed to write trace record"));
+      }
+    }
+
+    std::unique_ptr<std::ofstream> file_;
+    std::ostream& stream_;
+    bool record_outputs_;
+    std::string last_setup_;
+    std::string scratch_;
+    std::size_t n_setups_{ 0 };
+    std::size_t n_calls_{ 0 };
+
+    // Model and generation the last setup was captured from
+    const TuvModel* setup_model_{ nullptr };
+    std::uint64_t setup_generation_{ 0 };
+  };
+
+  /// @brief Read a trace from a stream
+  /// @param stream Binary input stream positioned at the trace header
+  /// @return Decoded trace
+  /// @throws std::runtime_error on a bad header, unknown record, truncation,
+  ///        or a call whose reaction count differs from its setup's
+  ///
+  /// Record sizes are checked against the bytes left in the stream when it
+  /// can seek, and payloads are read in bounded chunks otherwise. Element
+  /// counts inside a record are checked against the bytes left in it, so a
+  /// corrupt size or count fails without a matching allocation.
+  inline Trace ReadTrace(std::istream& stream)
+  {
+    char magic[sizeof(trace_format::kMagic)];
+    std::uint32_t version = 0;
+    std::uint32_t byte_order = 0;
+    stream.read(magic, sizeof(magic));
+    stream.read(reinterpret_cast<char*>(&version), sizeof(version));
+    stream.read(reinterpret_cast<char*>(&byte_order), sizeof(byte_order));
+    if (!stream || std::memcmp(magic, trace_format::kMagic, sizeof(magic)) != 0)
+    {
+      TUVX_THROW(std::runtime_error("Not a TUV-x trace"));
+    }
+    if (byte_order != trace_format::kByteOrderMark)
+    {
+      TUVX_THROW(std::runtime_error("Trace was written with a different byte order"));
+    }
+    if (version < trace_format::kMinimumVersion || version > trace_format::kVersion)
+    {
+      TUVX_THROW(std::runtime_error("Unsupported trace version " + std::to_string(version)));
+    }
+
+    Trace trace;
+    std::string payload;
+    std::optional<std::uint64_t> remaining = trace_format::RemainingBytes(stream);
+    while (true)
+    {
+      std::uint8_t tag = 0;
+      std::uint64_t size = 0;
+      if (!stream.read(reinterpret_cast<char*>(&tag), sizeof(tag)))
+      {
+        break;
+      }
+      if (!stream.read(reinterpret_cast<char*>(&size), sizeof(size)))
+      {
+        TUVX_THROW(std::runtime_error("Trace record is truncated"));
+      }
+      if (remaining)
+      {
+        *remaining -= std::min<std::uint64_t>(*remaining, sizeof(tag) + sizeof(size));
+        if (size > *remaining)
+        {
+          TUVX_THROW(std::runtime_error("Trace record is truncated"));
+        }
+        *remaining -= size;
+      }
+      trace_format::ReadPayload(stream, size, payload);
+
+      if (tag == trace_format::kSetupRecord)
+      {
+        trace.setups.push_back(trace_format::DecodeSetup(payload));
+      }
+      else if (tag == trace_format::kCallRecord || (tag == trace_format::kColumnRecord && version >= 2))
+      {
+        if (trace.setups.empty())
+        {
+          TUVX_THROW(std::runtime_error("Trace call record precedes any setup record"));
+        }
+        trace_format::Decoder in(payload);
+        TraceCall call;
+        call.setup = trace.setups.size() - 1;
+        call.solar_zenith_angle = in.Get<double>();
+        if (tag == trace_format::kColumnRecord)
+        {
+          ColumnState column;
+          column.solar_zenith_angle = call.solar_zenith_angle;
+          column.surface_albedo = in.Get<double>();
+          column.temperature = in.GetDoubles();
+          column.air_density = in.GetDoubles();
+          column.ozone = in.GetDoubles();
+          call.column = std::move(column);
+        }
+        trace_format::DecodeRates(in, call, trace.setups[call.setup].reactions.size());
+        trace.calls.push_back(std::move(call));
+      }
+      else
+      {
+        TUVX_THROW(std::runtime_error("Unknown trace record tag " + std::to_string(tag)));
+      }
+    }
+    return trace;
+  }
+
+  /// @brief Read a trace from a file
+  /// @param path Trace file written by TraceWriter
+  /// @return Decoded trace
+  /// @throws std::runtime_error if the file cannot be read or is malformed
+  inline Trace ReadTrace(const std::string& path)
+  {
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+      TUVX_THROW(std::runtime_error("Cannot open trace file '" + path + "'"));
+    }
+    return ReadTrace(file);
+  }
+
+  /// @brief Build a model with the configuration and radiators of a setup
+  /// @param setup Recorded setup
+  /// @return Model without reactions (the caller adds them)
+  /// @throws std::runtime_error for a radiator the trace cannot rebuild
+  ///
+  /// Supports the radiators added by the TuvModel convenience methods:
+  /// "O3", "O2", "rayleigh" and "aerosol".
+  inline TuvModel BuildTraceModel(const TraceSetup& setup)
+  {
+    TuvModel model(setup.config);
+    for (const auto& name : setup.radiators)
+    {
+      if (name == "O3")
+      {
+        model.AddO3Radiator();
+      }
+      else if (name == "O2")
+      {
+        model.AddO2Radiator();
+      }
+      else if (name == "rayleigh")
+      {
+        model.AddRayleighRadiator();
+      }
+      else if (name == "aerosol")
+      {
+        model.AddAerosolRadiator(setup.aerosol.value_or(AerosolRadiator::Config{}));
+      }
+      else
+      {
+        TUVX_THROW(std::runtime_error("Cannot rebuild radiator '" + name + "' from a trace"));
+      }
+    }
+    return model;
+  }
+
+  /// @brief Options for ReplayTrace()
+  struct TraceReplayOptions
+  {
+    /// Compare replayed J-values against recorded ones when available
+    bool check_outputs{ true };
+
+    /// A value passes if |replayed - recorded| <= rtol * |recorded| + atol
+    double relative_tolerance{ 1.0e-10 };
+    double absolute_tolerance{ 0.0 };
+
+    /// Number of timed executions per call (the minimum is reported)
+    std::size_t repeats{ 1 };
+  };
+
+  /// @brief Replay result for one call
+  struct TraceCallReport
+  {
+    /// Best wall time over the repeats [s]
+    double seconds{ 0.0 };
+
+    /// Largest relative difference over compared values
+    double max_relative_error{ 0.0 };
+
+    /// Number of J-values compared
+    std::size_t n_compared{ 0 };
+
+    /// Number of J-values outside the tolerance
+    std::size_t n_mismatched{ 0 };
+  };
+
+  /// @brief Replay results for a whole trace
+  struct TraceReplayReport
+  {
+    std::vector<TraceCallReport> calls;
+
+    /// @brief Total best-case replay time [s]
+    double TotalSeconds() const
+    {
+      double total = 0.0;
+      for (const auto& call : calls)
+      {
+        total += call.seconds;
+      }
+      return total;
+    }
+
+    /// @brief Number of J-values outside the tolerance over all calls
+    std::size_t Mismatches() const
+    {
+      std::size_t total = 0;
+      for (const auto& call : calls)
+      {
+        total += call.n_mismatched;
+      }
+      return total;
+    }
+
+    /// @brief Largest relative difference over all calls
+    double MaxRelativeError() const
+    {
+      double max_error = 0.0;
+      for (const auto& call : calls)
+      {
+        max_error = std::max(max_error, call.max_relative_error);
+      }
+      return max_error;
+    }
+  };
+
+  /// @brief Feed a trace back through the model and time each call
+  /// @param trace Trace to replay
+  /// @param make_model Builds the model for a setup (typically
+  ///                   BuildTraceModel() plus the reactions the caller knows)
+  /// @param options Comparison tolerance and repeat count
+  /// @return Per-call timing and comparison results
+  ///
+  /// One model is built per setup and reused for all its calls, so model
+  /// construction is not part of the per-call time. Column records are
+  /// replayed through CalculatePhotolysisRates(), the others through
+  /// Calculate(). Recorded reactions the replayed model does not have are
+  /// skipped in the comparison.
+  inline TraceReplayReport ReplayTrace(
+      const Trace& trace,
+      const std::function<TuvModel(const TraceSetup&)>& make_model,
+      const TraceReplayOptions& options = TraceReplayOptions{})
+  {
+    using clock = std::chrono::steady_clock;
+
+    std::vector<std::unique_ptr<TuvModel>> models(trace.setups.size());
+    TraceReplayReport report;
+    report.calls.reserve(trace.calls.size());
+
+    for (const auto& call : trace.calls)
+    {
+      const TraceSetup& setup = trace.setups.at(call.setup);
+      if (!models[call.setup])
+      {
+        models[call.setup] = std::make_unique<TuvModel>(make_model(setup));
+      }
+      TuvModel& model = *models[call.setup];
+
+      TraceCallReport call_report;
+      std::size_t repeats = std::max<std::size_t>(options.repeats, 1);
+      auto time = [&](auto&& calculate)
+      {
+        for (std::size_t repeat = 0; repeat < repeats; ++repeat)
+        {
+          auto start = clock::now();
+          calculate();
+          double seconds = std::chrono::duration<double>(clock::now() - start).count();
+          call_report.seconds = repeat == 0 ? seconds : std::min(call_report.seconds, seconds);
+        }
+      };
+
+      // Replayed J-values of each recorded reaction, or null if the model lacks it
+      std::vector<const double*> replayed(setup.reactions.size(), nullptr);
+      std::size_t n_replayed_levels = 0;
+      ModelOutput output;
+      std::vector<double> column_rates;
+      if (call.column)
+      {
+        n_replayed_levels = model.AltitudeGrid().Spec().n_cells + 1;
+        column_rates.assign(model.PhotolysisReactions().Size() * n_replayed_levels, 0.0);
+        ColumnView column = call.column->View();
+        time(
+            [&]
+            {
+              model.CalculatePhotolysisRates(
+                  column, column_rates.data(), static_cast<std::ptrdiff_t>(n_replayed_levels), 1);
+            });
+        auto names = model.PhotolysisReactions().ReactionNames();
+        for (std::size_t r = 0; r < setup.reactions.size(); ++r)
+        {
+          auto found = std::find(names.begin(), names.end(), setup.reactions[r]);
+          if (found != names.end())
+          {
+            replayed[r] = column_rates.data() + (found - names.begin()) * static_cast<std::ptrdiff_t>(n_replayed_levels);
+          }
+        }
+      }
+      else
+      {
+        time([&] { output = model.Calculate(call.solar_zenith_angle); });
+        for (std::size_t r = 0; r < setup.reactions.size(); ++r)
+        {
+          for (const auto& result : output.photolysis_rates)
+          {
+            if (result.reaction_name == setup.reactions[r])
+            {
+              replayed[r] = result.rates.data();
+              n_replayed_levels = result.rates.size();
+              break;
+            }
+          }
+        }
+      }
+
+      if (options.check_outputs && call.HasOutputs())
+      {
+        for (std::size_t r = 0; r < setup.reactions.size(); ++r)
+        {
+          if (replayed[r] == nullptr)
+          {
+            continue;
+          }
+          for (std::size_t l = 0; l < call.n_levels; ++l)
+          {
+            double expected = call.rates[r * call.n_levels + l];
+            double actual = l < n_replayed_levels ? replayed[r][l] : std::nan("");
+            double diff = std::abs(actual - expected);
+            double relative = expected != 0.0 ? diff / std::abs(expected) : diff;
+            ++call_report.n_compared;
+            if (!(diff <= options.relative_tolerance * std::abs(expected) + options.absolute_tolerance))
+            {
+              ++call_report.n_mismatched;
+            }
+            if (std::isnan(relative))
+            {
+              relative = std::numeric_limits<double>::infinity();
+            }
+            call_report.max_relative_error = std::max(call_report.max_relative_error, relative);
+          }
+        }
+      }
+      report.calls.push_back(call_report);
+    }
+    return report;
+  }
+
+}  // namespace tuvx
@@ -0,0 +1,616 @@
+#pragma once
+
+#include <tuvx/model/tuv_model.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Out-of-line TuvModel members. Included by tuv_model.hpp in header-only
+// builds, compiled into the library by src/tuvx.cpp with TUVX_BUILD_COMPILED.
+
+namespace tuvx
+{
+  TUVX_INLINE TuvModel& TuvModel::UseStandardAtmosphere()
+  {
+    auto midpoints_span = altitude_grid_.Midpoints();
+    std::vector<double> midpoints(midpoints_span.begin(), midpoints_span.end());
+    config_.temperature_profile = StandardAtmosphere::GenerateTemperatureProfile(midpoints);
+    config_.pressure_profile = StandardAtmosphere::GeneratePressureProfile(midpoints);
+    config_.air_density_profile = StandardAtmosphere::GenerateAirDensityProfile(midpoints);
+    config_.ozone_profile = StandardAtmosphere::GenerateOzoneProfile(midpoints, config_.ozone_column_DU);
+    generation_ = NextGeneration();
+    return *this;
+  }
+
+  TUVX_INLINE ModelOutput TuvModel::Calculate(double solar_zenith_angle)
+  {
+    ModelOutput output;
+    Calculate(solar_zenith_angle, output);
+    return output;
+  }
+
+  TUVX_INLINE void TuvModel::Calculate(double solar_zenith_angle, ModelOutput& output)
+  {
+    // Store calculation metadata
+    output.solar_zenith_angle = solar_zenith_angle;
+    output.day_of_year = config_.day_of_year;
+    output.earth_sun_distance = config_.EffectiveEarthSunDistance();
+    output.is_daytime = solar_zenith_angle < 90.0;
+    output.used_spherical_geometry = config_.use_spherical_geometry;
+
+    // Store grids
+    CopyGrid(wavelength_grid_, output.wavelength_grid);
+    CopyGrid(altitude_grid_, output.altitude_grid);
+
+    ColumnWorkspace& workspace = column_workspace_;
+    workspace.solar_zenith_angle = solar_zenith_angle;
+
+    FillSurfaceAlbedo(config_.surface_albedo, workspace.surface_albedo);
+
+    // Get temperature, air density and ozone profiles
+    workspace.temperature.assign(config_.temperature_profile.begin(), config_.temperature_profile.end());
+    workspace.air_density.assign(config_.air_density_profile.begin(), config_.air_density_profile.end());
+    workspace.ozone.assign(config_.ozone_profile.begin(), config_.ozone_profile.end());
+
+    // Fill any profile that is not configured
+    if (workspace.temperature.empty() || workspace.air_density.empty() || workspace.ozone.empty())
+    {
+      auto midpoints_span = altitude_grid_.Midpoints();
+      std::vector<double> midpoints_vec(midpoints_span.begin(), midpoints_span.end());
+      if (workspace.temperature.empty())
+      {
+        workspace.temperature = StandardAtmosphere::GenerateTemperatureProfile(midpoints_vec);
+      }
+      if (workspace.air_density.empty())
+      {
+        workspace.air_density = StandardAtmosphere::GenerateAirDensityProfile(midpoints_vec);
+      }
+      if (workspace.ozone.empty())
+      {
+        workspace.ozone = StandardAtmosphere::GenerateOzoneProfile(midpoints_vec, config_.ozone_column_DU);
+      }
+    }
+
+    // Solve radiative transfer, handing the output's previous field to the
+    // workspace so its storage is reused on the next call
+    ComputeOpticalProperties(workspace);
+    SolveColumn(workspace);
+    std::swap(output.radiation_field, workspace.radiation_field);
+
+    // Calculate photolysis rates
+    photolysis_reactions_.CalculateAll(
+        output.radiation_field, wavelength_grid_, workspace.temperature, output.photolysis_rates);
+
+    if (calculate_observer_)
+    {
+      calculate_observer_(*this, solar_zenith_angle, output);
+    }
+  }
+
+  TUVX_INLINE void TuvModel::CalculatePhotolysisRates(
+      const ColumnView& column,
+      double* rates,
+      std::ptrdiff_t reaction_stride,
+      std::ptrdiff_t level_stride)
+  {
+    GatherColumn(column, column_workspace_);
+    ComputeOpticalProperties(column_workspace_);
+    SolveColumn(column_workspace_);
+    IntegrateColumn(column_workspace_, rates, reaction_stride, level_stride);
+
+    if (column_observer_)
+    {
+      column_observer_(*this, column, rates, reaction_stride, level_stride);
+    }
+  }
+
+  TUVX_INLINE void TuvModel::GatherColumn(const ColumnView& column, ColumnWorkspace& workspace) const
+  {
+    std::size_t n_layers = altitude_grid_.Spec().n_cells;
+
+    workspace.solar_zenith_angle = column.solar_zenith_angle;
+    GatherColumnProfile(column.temperature, config_.temperature_profile, n_layers, workspace.temperature);
+    GatherColumnProfile(column.air_density, config_.air_density_profile, n_layers, workspace.air_density);
+    GatherColumnProfile(column.ozone, config_.ozone_profile, n_layers, workspace.ozone);
+
+    // Fill any profile that is neither given by the column nor configured
+    if (workspace.temperature.empty() || workspace.air_density.empty() || workspace.ozone.empty())
+    {
+      auto midpoints_span = altitude_grid_.Midpoints();
+      std::vector<double> midpoints_vec(midpoints_span.begin(), midpoints_span.end());
+      if (workspace.temperature.empty())
+      {
+        workspace.temperature = StandardAtmosphere::GenerateTemperatureProfile(midpoints_vec);
+      }
+      if (workspace.air_density.empty())
+      {
+        workspace.air_density = StandardAtmosphere::GenerateAirDensityProfile(midpoints_vec);
+      }
+      if (workspace.ozone.empty())
+      {
+        workspace.ozone = StandardAtmosphere::GenerateOzoneProfile(midpoints_vec, config_.ozone_column_DU);
+      }
+    }
+
+    FillSurfaceAlbedo(column.surface_albedo, workspace.surface_albedo);
+  }
+
+  TUVX_INLINE void TuvModel::FillSurfaceAlbedo(double uniform_albedo, std::vector<double>& albedo) const
+  {
+    if (!config_.surface_albedo_spectrum.empty())
+    {
+      if (config_.surface_albedo_spectrum.size() != wavelength_grid_.Spec().n_cells)
+      {
+        TUVX_INTERNAL_ERROR("Surface albedo spectrum does not match the wavelength grid");
+      }
+      albedo.assign(config_.surface_albedo_spectrum.begin(), config_.surface_albedo_spectrum.end());
+      return;
+    }
+    albedo.assign(wavelength_grid_.Spec().n_cells, uniform_albedo);
+  }
+
+  TUVX_INLINE ModelOutput TuvModel::Calculate(
+      int year,
+      int month,
+      int day,
+      double hour,
+      double latitude,
+      double longitude)
+  {
+    return Calculate(SetSolarPosition(year, month, day, hour, latitude, longitude));
+  }
+
+  TUVX_INLINE void TuvModel::Calculate(
+      int year,
+      int month,
+      int day,
+      double hour,
+      double latitude,
+      double longitude,
+      ModelOutput& output)
+  {
+    Calculate(SetSolarPosition(year, month, day, hour, latitude, longitude), output);
+  }
+
+  TUVX_INLINE double
+  TuvModel::SetSolarPosition(int year, int month, int day, double hour, double latitude, double longitude)
+  {
+    // Calculate solar position using free functions from solar namespace
+    auto position = solar::CalculateSolarPosition(year, month, day, hour, latitude, longitude);
+
+    // Update config
+    config_.solar_zenith_angle = position.zenith_angle;
+    config_.day_of_year = solar::DayOfYear(year, month, day);
+    config_.latitude = latitude;
+    config_.longitude = longitude;
+    generation_ = NextGeneration();
+
+    return position.zenith_angle;
+  }
+
+  TUVX_INLINE void TuvModel::CopyGrid(const Grid& source, Grid& destination)
+  {
+    auto source_edges = source.Edges();
+    auto destination_edges = destination.Edges();
+    if (destination.Spec() == source.Spec() &&
+        std::equal(source_edges.begin(), source_edges.end(), destination_edges.begin(), destination_edges.end()))
+    {
+      return;
+    }
+    destination = source;
+  }
+
+  TUVX_INLINE ProfileWarehouse TuvModel::CreateProfileWarehouse() const
+  {
+    std::size_t n_layers = altitude_grid_.Spec().n_cells;
+
+    // Get altitude midpoints for profile generation
+    auto midpoints_span = altitude_grid_.Midpoints();
+    std::vector<double> midpoints_vec(midpoints_span.begin(), midpoints_span.end());
+
+    // Get temperature profile
+    std::vector<double> temperatures = config_.temperature_profile;
+    if (temperatures.empty())
+    {
+      temperatures = StandardAtmosphere::GenerateTemperatureProfile(midpoints_vec);
+    }
+
+    // Get air density profile
+    std::vector<double> air_density = config_.air_density_profile;
+    if (air_density.empty())
+    {
+      air_density = StandardAtmosphere::GenerateAirDensityProfile(midpoints_vec);
+    }
+
+    // Get ozone profile
+    std::vector<double> ozone = config_.ozone_profile;
+    if (ozone.empty())
+    {
+      ozone = StandardAtmosphere::GenerateOzoneProfile(midpoints_vec, config_.ozone_column_DU);
+    }
+
+    // Get O2 profile (20.95% of air density)
+    std::vector<double> o2;
+    o2.reserve(air_density.size());
+    for (double air_n : air_density)
+    {
+      o2.push_back(air_n * StandardAtmosphere::kO2MixingRatio);
+    }
+
+    // Create profile warehouse
+    ProfileWarehouse profiles;
+    profiles.Add(Profile(
+        ProfileSpec{ "temperature", "K", n_layers },
+        temperatures));
+    profiles.Add(Profile(
+        ProfileSpec{ "air_density", "molecules/cm^3", n_layers },
+        air_density));
+    profiles.Add(Profile(
+        ProfileSpec{ "O3", "molecules/cm^3", n_layers },
+        ozone));
+    profiles.Add(Profile(
+        ProfileSpec{ "O2", "molecules/cm^3", n_layers },
+        o2));
+
+    return profiles;
+  }
+
+  TUVX_INLINE void TuvModel::ComputeOpticalProperties(ColumnWorkspace& workspace)
+  {
+    PrepareComponents();
+
+    // Get number of levels and wavelengths
+    std::size_t n_layers = altitude_grid_.Spec().n_cells;
+    std::size_t n_wavelengths = wavelength_grid_.Spec().n_cells;
+
+    // Compute spherical geometry if enabled
+    if (config_.use_spherical_geometry)
+    {
+      SphericalGeometry spherical_geom(altitude_grid_, config_.earth_radius);
+      workspace.geometry = spherical_geom.Calculate(workspace.solar_zenith_angle);
+    }
+
+    // Update radiators if any are configured
+    if (radiators_.Empty())
+    {
+      workspace.optical_properties.Initialize(n_layers, n_wavelengths);
+      return;
+    }
+
+    // Refill the persistent warehouses from the workspace
+    workspace.o2.resize(workspace.air_density.size());
+    for (std::size_t i = 0; i < workspace.air_density.size(); ++i)
+    {
+      workspace.o2[i] = workspace.air_density[i] * StandardAtmosphere::kO2MixingRatio;
+    }
+    if (column_grids_.Empty())
+    {
+      BuildColumnWarehouses();
+    }
+    column_profiles_.Update(column_profile_handles_.temperature, workspace.temperature);
+    column_profiles_.Update(column_profile_handles_.air_density, workspace.air_density);
+    column_profiles_.Update(column_profile_handles_.ozone, workspace.ozone);
+    column_profiles_.Update(column_profile_handles_.o2, workspace.o2);
+
+    // Update all radiators with current atmospheric state
+    radiators_.UpdateAll(column_grids_, column_profiles_);
+
+    // Combine their optical properties into the workspace's storage
+    radiators_.CombineInto(workspace.optical_properties);
+  }
+
+  TUVX_INLINE void TuvModel::BuildColumnWarehouses()
+  {
+    std::size_t n_layers = altitude_grid_.Spec().n_cells;
+    std::vector<double> zeros(n_layers, 0.0);
+
+    column_grids_.Clear();
+    column_grids_.Add(wavelength_grid_);
+    column_grids_.Add(altitude_grid_);
+
+    column_profiles_.Clear();
+    column_profile_handles_.temperature = column_profiles_.Add(Profile(ProfileSpec{ "temperature", "K", n_layers }, zeros));
+    column_profile_handles_.air_density =
+        column_profiles_.Add(Profile(ProfileSpec{ "air_density", "molecules/cm^3", n_layers }, zeros));
+    column_profile_handles_.ozone = column_profiles_.Add(Profile(ProfileSpec{ "O3", "molecules/cm^3", n_layers }, zeros));
+    column_profile_handles_.o2 = column_profiles_.Add(Profile(ProfileSpec{ "O2", "molecules/cm^3", n_layers }, zeros));
+  }
+
+  TUVX_INLINE void TuvModel::SolveColumn(ColumnWorkspace& workspace) const
+  {
+    if (!IsPrepared())
+    {
+      TUVX_INTERNAL_ERROR("SolveColumn() called before the model was prepared");
+    }
+
+    FillSolarFlux(workspace.solar_flux);
+
+    // Solve radiative transfer, reusing the workspace's field and scratch memory
+    SolverInput solver_input = ColumnSolverInput(workspace, workspace.optical_properties);
+    solver_input.workspace = &workspace.solver;
+    solver_->SolveInto(solver_input, workspace.radiation_field);
+  }
+
+  TUVX_INLINE void TuvModel::FillSolarFlux(std::vector<double>& solar_flux) const
+  {
+    double earth_sun_distance = config_.EffectiveEarthSunDistance();
+    double distance_factor = 1.0 / (earth_sun_distance * earth_sun_distance);
+    solar_flux.assign(extraterrestrial_flux_.begin(), extraterrestrial_flux_.end());
+    for (auto& flux : solar_flux)
+    {
+      flux *= distance_factor;
+    }
+  }
+
+  TUVX_INLINE SolverInput
+  TuvModel::ColumnSolverInput(const ColumnWorkspace& workspace, const RadiatorState& optical_properties) const
+  {
+    SolverInput solver_input;
+    solver_input.radiator_state = &optical_properties;
+    solver_input.solar_zenith_angle = workspace.solar_zenith_angle;
+    solver_input.extraterrestrial_flux = &workspace.solar_flux;
+    solver_input.surface_albedo = &workspace.surface_albedo;
+    if (config_.use_spherical_geometry)
+    {
+      solver_input.geometry = &workspace.geometry;
+    }
+    return solver_input;
+  }
+
+  TUVX_INLINE void TuvModel::IntegrateColumn(
+      const ColumnWorkspace& workspace,
+      double* rates,
+      std::ptrdiff_t reaction_stride,
+      std::ptrdiff_t level_stride) const
+  {
+    photolysis_reactions_.CalculateAll(
+        workspace.radiation_field, wavelength_grid_, workspace.temperature, rates, reaction_stride, level_stride);
+  }
+
+  TUVX_INLINE void TuvModel::GatherColumnProfile(
+      const StridedView<const double>& source,
+      const std::vector<double>& fallback,
+      std::size_t n_layers,
+      std::vector<double>& destination)
+  {
+    if (source.Empty())
+    {
+      if (!fallback.empty() && fallback.size() != n_layers)
+      {
+        TUVX_INTERNAL_ERROR("Configured profile size does not match altitude grid");
+      }
+      destination.assign(fallback.begin(), fallback.end());
+      return;
+    }
+    if (source.Size() != n_layers)
+    {
+      TUVX_INTERNAL_ERROR("Column profile size does not match altitude grid");
+    }
+    destination.resize(n_layers);
+    for (std::size_t i = 0; i < n_layers; ++i)
+    {
+      destination[i] = source[i];
+    }
+  }
+
+  TUVX_INLINE std::vector<std::pair<std::string, std::string>> TuvModel::SharedTableKeys() const
+  {
+    std::size_t n_reactions = photolysis_reactions_.Size();
+    std::vector<std::pair<std::string, std::string>> keys(n_reactions);
+    for (std::size_t r = 0; r < n_reactions; ++r)
+    {
+      const auto& reaction = photolysis_reactions_.Get(r);
+      for (std::size_t first = 0; first <= r; ++first)
+      {
+        const auto& owner = photolysis_reactions_.Get(first);
+        if (keys[r].first.empty() && reaction.GetCrossSection() != nullptr &&
+            owner.GetCrossSection() == reaction.GetCrossSection())
+        {
+          keys[r].first = owner.ReactionName() + "/cross_section";
+        }
+        if (keys[r].second.empty() && reaction.GetQuantumYield() != nullptr &&
+            owner.GetQuantumYield() == reaction.GetQuantumYield())
+        {
+          keys[r].second = owner.ReactionName() + "/quantum_yield";
+        }
+      }
+    }
+    return keys;
+  }
+
+  TUVX_INLINE void
+  TuvModel::BinSharedTables(SharedTableBuilder& builder, const std::vector<double>& temperatures, double air_density) const
+  {
+    auto keys = SharedTableKeys();
+    for (std::size_t r = 0; r < keys.size(); ++r)
+    {
+      const auto& reaction = photolysis_reactions_.Get(r);
+      const auto& [cross_section_key, quantum_yield_key] = keys[r];
+      if (!cross_section_key.empty() && !builder.Contains(cross_section_key + "/values"))
+      {
+        BinCrossSection(builder, cross_section_key, *reaction.GetCrossSection(), wavelength_grid_, temperatures);
+      }
+      if (!quantum_yield_key.empty() && !builder.Contains(quantum_yield_key + "/values"))
+      {
+        BinQuantumYield(
+            builder, quantum_yield_key, *reaction.GetQuantumYield(), wavelength_grid_, temperatures, air_density);
+      }
+    }
+
+    // Absorbing radiators, including those still deferred by lazy initialization
+    auto bin_radiator = [&](const Radiator& radiator)
+    {
+      const auto* absorber = dynamic_cast<const FromCrossSectionRadiator*>(&radiator);
+      std::string key = SharedRadiatorKey(radiator.Name());
+      if (absorber != nullptr && !builder.Contains(key + "/values"))
+      {
+        BinCrossSection(builder, key, absorber->GetCrossSection(), wavelength_grid_, temperatures);
+      }
+    };
+    for (const auto& name : radiators_.Names())
+    {
+      bin_radiator(radiators_.Get(name));
+    }
+    for (const auto& pending : pending_radiators_)
+    {
+      bin_radiator(*pending.make());
+    }
+
+    if (!builder.Contains("extraterrestrial_flux"))
+    {
+      builder.Add(
+          "extraterrestrial_flux",
+          extraterrestrial_flux_.empty() ? solar::reference_spectra::CreateASTM_E490().Calculate(wavelength_grid_)
+                                         : extraterrestrial_flux_);
+    }
+  }
+
+  TUVX_INLINE TuvModel& TuvModel::UseSharedTables(std::shared_ptr<const SharedTableSegment> segment)
+  {
+    auto keys = SharedTableKeys();
+    std::vector<std::shared_ptr<const CrossSection>> cross_sections(keys.size());
+    std::vector<std::shared_ptr<const QuantumYield>> quantum_yields(keys.size());
+    for (std::size_t r = 0; r < keys.size(); ++r)
+    {
+      const auto& reaction = photolysis_reactions_.Get(r);
+      const auto& [cross_section_key, quantum_yield_key] = keys[r];
+      // Reactions sharing a spectrum share its replacement
+      for (std::size_t first = 0; first < r; ++first)
+      {
+        if (!cross_section_key.empty() && keys[first].first == cross_section_key)
+        {
+          cross_sections[r] = cross_sections[first];
+        }
+        if (!quantum_yield_key.empty() && keys[first].second == quantum_yield_key)
+        {
+          quantum_yields[r] = quantum_yields[first];
+        }
+      }
+      if (!cross_section_key.empty() && !cross_sections[r])
+      {
+        cross_sections[r] = std::make_shared<SharedCrossSection>(segment, cross_section_key);
+      }
+      if (!quantum_yield_key.empty() && !quantum_yields[r])
+      {
+        const QuantumYield& source = *reaction.GetQuantumYield();
+        quantum_yields[r] =
+            std::make_shared<SharedQuantumYield>(segment, quantum_yield_key, source.Reactant(), source.Products());
+      }
+    }
+
+    // Absorbing radiators
+    PrepareRadiators();
+    std::vector<std::pair<FromCrossSectionRadiator*, std::unique_ptr<CrossSection>>> radiator_cross_sections;
+    for (const auto& name : radiators_.Names())
+    {
+      if (auto* absorber = dynamic_cast<FromCrossSectionRadiator*>(&radiators_.GetMutable(name)))
+      {
+        radiator_cross_sections.emplace_back(
+            absorber, std::make_unique<SharedCrossSection>(segment, SharedRadiatorKey(name)));
+      }
+    }
+
+    SharedTable flux = segment->Get("extraterrestrial_flux");
+    if (flux.rows != 1 || flux.cols != wavelength_grid_.Spec().n_cells)
+    {
+      TUVX_THROW(std::invalid_argument("Shared extraterrestrial flux does not match the wavelength grid"));
+    }
+
+    // Everything was found; switch over
+    for (std::size_t r = 0; r < keys.size(); ++r)
+    {
+      photolysis_reactions_.SetSpectra(r, cross_sections[r].get(), quantum_yields[r].get());
+    }
+    for (auto& [absorber, cross_section] : radiator_cross_sections)
+    {
+      absorber->SetCrossSection(std::move(cross_section));
+    }
+    auto flux_values = flux.Values();
+    extraterrestrial_flux_.assign(flux_values.begin(), flux_values.end());
+    shared_cross_sections_ = std::move(cross_sections);
+    shared_quantum_yields_ = std::move(quantum_yields);
+    generation_ = NextGeneration();
+    return *this;
+  }
+
+  TUVX_INLINE void TuvModel::Initialize()
+  {
+    InitializeWavelengthGrid();
+    InitializeAltitudeGrid();
+    if (!custom_solver_)
+    {
+      solver_.reset();
+      if (!config_.lazy_initialization)
+      {
+        InitializeSolver();
+      }
+    }
+  }
+
+  TUVX_INLINE void TuvModel::InitializeWavelengthGrid()
+  {
+    startup_profile_.Measure(
+        "wavelength grid",
+        [this]
+        {
+          if (!config_.wavelength_edges.empty())
+          {
+            GridSpec spec{ "wavelength", "nm", config_.wavelength_edges.size() - 1 };
+            wavelength_grid_ = Grid(spec, config_.wavelength_edges);
+          }
+          else
+          {
+            // Create default equally-spaced grid
+            GridSpec spec{ "wavelength", "nm", config_.n_wavelength_bins };
+            wavelength_grid_ = Grid::EquallySpaced(spec, config_.wavelength_min, config_.wavelength_max);
+          }
+        });
+
+    // The flux and the radiators' warehouses depend on the grid
+    extraterrestrial_flux_.clear();
+    column_grids_.Clear();
+    if (!config_.lazy_initialization)
+    {
+      InitializeExtraterrestrialFlux();
+    }
+  }
+
+  TUVX_INLINE void TuvModel::InitializeAltitudeGrid()
+  {
+    startup_profile_.Measure(
+        "altitude grid",
+        [this]
+        {
+          if (!config_.altitude_edges.empty())
+          {
+            GridSpec spec{ "altitude", "km", config_.altitude_edges.size() - 1 };
+            altitude_grid_ = Grid(spec, config_.altitude_edges);
+          }
+          else
+          {
+            // Create default equally-spaced grid
+            GridSpec spec{ "altitude", "km", config_.n_altitude_layers };
+            altitude_grid_ = Grid::EquallySpaced(spec, config_.altitude_min, config_.altitude_max);
+          }
+        });
+    column_grids_.Clear();
+  }
+
+  TUVX_INLINE void TuvModel::InitializeSolver()
+  {
+    // Currently only Delta-Eddington is supported
+    solver_ = startup_profile_.Measure("solver", [] { return std::make_unique<DeltaEddingtonSolver>(); });
+  }
+
+  TUVX_INLINE void TuvModel::InitializeExtraterrestrialFlux()
+  {
+    // ASTM E-490 reference spectrum at 1 AU
+    extraterrestrial_flux_ = startup_profile_.Measure(
+        "extraterrestrial flux",
+        [this] { return solar::reference_spectra::CreateASTM_E490().Calculate(wavelength_grid_); });
+  }
+
+}  // namespace tuvx
@@ -1,13 +1,20 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <tuvx/cross_section/cross_section.hpp>
 #include <tuvx/cross_section/cross_section_warehouse.hpp>
 #include <tuvx/grid/grid.hpp>
 #include <tuvx/grid/grid_warehouse.hpp>
+#include <tuvx/model/column_state.hpp>
+#include <tuvx/model/column_workspace.hpp>
 #include <tuvx/model/model_config.hpp>
 #include <tuvx/model/model_output.hpp>
 #include <tuvx/photolysis/photolysis_rate.hpp>
@@ -15,6 +22,7 @@
 #include <tuvx/profile/profile_warehouse.hpp>
 #include <tuvx/quantum_yield/quantum_yield.hpp>
 #include <tuvx/quantum_yield/quantum_yield_warehouse.hpp>
+#include <tuvx/quantum_yield/types/shared.hpp>
 #include <tuvx/radiation_field/radiation_field.hpp>
 #include <tuvx/radiator/radiator.hpp>
 #include <tuvx/radiator/radiator_state.hpp>
@@ -24,6 +32,7 @@
 #include <tuvx/radiator/types/aerosol.hpp>
 #include <tuvx/cross_section/types/o3.hpp>
 #include <tuvx/cross_section/types/o2.hpp>
+#include <tuvx/cross_section/types/shared.hpp>
 #include <tuvx/solar/extraterrestrial_flux.hpp>
 #include <tuvx/solar/solar_position.hpp>
 #include <tuvx/solver/delta_eddington.hpp>
@@ -31,9 +40,17 @@
 #include <tuvx/spherical_geometry/spherical_geometry.hpp>
 #include <tuvx/surface/surface_albedo.hpp>
 #include <tuvx/util/array.hpp>
+#include <tuvx/util/build_mode.hpp>
+#include <tuvx/util/internal_error.hpp>
+#include <tuvx/util/shared_table.hpp>
+#include <tuvx/util/startup_profiler.hpp>
+#include <tuvx/util/strided_view.hpp>
 
 namespace tuvx
 {
+  class ExecutionPlan;
+  struct ExecutionPlanConfig;
+
   /// @brief Main TUV radiative transfer and photolysis model
   ///
   /// TuvModel orchestrates all components needed for UV/visible radiative
@@ -56,9 +73,29 @@ namespace tuvx
   /// auto output = model.Calculate();
   /// double j_o3 = output.GetSurfacePhotolysisRate("O3 -> O2 + O(1D)");
   /// @endcode
+  ///
+  /// With ModelConfig::lazy_initialization the solver, the radiators added
+  /// by the Add*Radiator() helpers and the extraterrestrial flux on the
+  /// wavelength grid are prepared on first use instead of up front; call
+  /// PrepareComponents() to warm them up outside a timed region. The cost of each
+  /// preparation is recorded in StartupProfile().
   class TuvModel
   {
    public:
+    /// @brief Callback invoked after each Calculate(solar_zenith_angle) call
+    ///
+    /// Receives the model (with the configuration used for the call), the
+    /// solar zenith angle and the output. Used by TraceWriter to record
+    /// production inputs for offline replay.
+    using CalculateObserver = std::function<void(const TuvModel&, double, const ModelOutput&)>;
+
+    /// @brief Callback invoked after each CalculatePhotolysisRates() call
+    ///
+    /// Receives the model, the column inputs and the J-values just written
+    /// with their strides. Used by TraceWriter to record the bulk path.
+    using ColumnObserver =
+        std::function<void(const TuvModel&, const ColumnView&, const double*, std::ptrdiff_t, std::ptrdiff_t)>;
+
     // ========================================================================
     // Construction
     // ========================================================================
@@ -77,6 +114,43 @@ namespace tuvx
       Initialize();
     }
 
+    /// @brief Copy a model, deep-cloning its radiators and solver
+    ///
+    /// The copy can be run concurrently with the original. Cross-sections and
+    /// quantum yields passed to AddPhotolysisReaction() are not owned by the
+    /// model and are shared between copies; they are only read. So are those
+    /// created by UseSharedTables(), which the copies keep alive. The
+    /// calculate and column observers are not copied.
+    TuvModel(const TuvModel& other)
+        : config_(other.config_),
+          wavelength_grid_(other.wavelength_grid_),
+          altitude_grid_(other.altitude_grid_),
+          radiators_(other.radiators_.Clone()),
+          photolysis_reactions_(other.photolysis_reactions_),
+          solver_(other.solver_ ? other.solver_->Clone() : nullptr),
+          custom_solver_(other.custom_solver_),
+          pending_radiators_(other.pending_radiators_),
+          extraterrestrial_flux_(other.extraterrestrial_flux_),
+          shared_cross_sections_(other.shared_cross_sections_),
+          shared_quantum_yields_(other.shared_quantum_yields_),
+          startup_profile_(other.startup_profile_)
+    {
+    }
+
+    /// @brief Copy-assign a model (see the copy constructor)
+    TuvModel& operator=(const TuvModel& other)
+    {
+      if (this != &other)
+      {
+        *this = TuvModel(other);
+        generation_ = NextGeneration();
+      }
+      return *this;
+    }
+
+    TuvModel(TuvModel&&) = default;
+    TuvModel& operator=(TuvModel&&) = default;
+
     // ========================================================================
     // Configuration
     // ========================================================================
@@ -92,6 +166,7 @@ namespace tuvx
     void SetConfig(const ModelConfig& config)
     {
       config_ = config;
+      generation_ = NextGeneration();
       Initialize();
     }
 
@@ -105,16 +180,37 @@ namespace tuvx
     TuvModel& SetWavelengthGrid(std::vector<double> edges)
     {
       config_.wavelength_edges = std::move(edges);
+      generation_ = NextGeneration();
       InitializeWavelengthGrid();
       return *this;
     }
 
+    /// @brief Replace the extraterrestrial flux on the wavelength grid
+    /// @param flux Flux at 1 AU in each wavelength bin [photons/cm^2/s/nm]
+    /// @return Reference to this model for chaining
+    /// @throws std::invalid_argument if the size does not match the wavelength grid
+    ///
+    /// By default the reference spectrum is sampled at the bin midpoints,
+    /// which is not the bin mean on a coarse band grid. SetWavelengthGrid()
+    /// and SetConfig() restore the reference spectrum.
+    TuvModel& SetExtraterrestrialFlux(std::vector<double> flux)
+    {
+      if (flux.size() != wavelength_grid_.Spec().n_cells)
+      {
+        TUVX_THROW(std::invalid_argument("Extraterrestrial flux does not match the wavelength grid"));
+      }
+      extraterrestrial_flux_ = std::move(flux);
+      generation_ = NextGeneration();
+      return *this;
+    }
+
     /// @brief Set custom altitude grid
     /// @param edges Altitude level edges [km]
     /// @return Reference to this model for chaining
     TuvModel& SetAltitudeGrid(std::vector<double> edges)
     {
       config_.altitude_edges = std::move(edges);
+      generation_ = NextGeneration();
       InitializeAltitudeGrid();
       return *this;
     }
@@ -129,6 +225,7 @@ namespace tuvx
     TuvModel& SetTemperatureProfile(std::vector<double> values)
     {
       config_.temperature_profile = std::move(values);
+      generation_ = NextGeneration();
       return *this;
     }
 
@@ -138,6 +235,7 @@ namespace tuvx
     TuvModel& SetPressureProfile(std::vector<double> values)
     {
       config_.pressure_profile = std::move(values);
+      generation_ = NextGeneration();
       return *this;
     }
 
@@ -147,6 +245,7 @@ namespace tuvx
     TuvModel& SetAirDensityProfile(std::vector<double> values)
     {
       config_.air_density_profile = std::move(values);
+      generation_ = NextGeneration();
       return *this;
     }
 
@@ -156,21 +255,13 @@ namespace tuvx
     TuvModel& SetOzoneProfile(std::vector<double> values)
     {
       config_.ozone_profile = std::move(values);
+      generation_ = NextGeneration();
       return *this;
     }
 
     /// @brief Use US Standard Atmosphere 1976 for atmospheric profiles
     /// @return Reference to this model for chaining
-    TuvModel& UseStandardAtmosphere()
-    {
-      auto midpoints_span = altitude_grid_.Midpoints();
-      std::vector<double> midpoints(midpoints_span.begin(), midpoints_span.end());
-      config_.temperature_profile = StandardAtmosphere::GenerateTemperatureProfile(midpoints);
-      config_.pressure_profile = StandardAtmosphere::GeneratePressureProfile(midpoints);
-      config_.air_density_profile = StandardAtmosphere::GenerateAirDensityProfile(midpoints);
-      config_.ozone_profile = StandardAtmosphere::GenerateOzoneProfile(midpoints, config_.ozone_column_DU);
-      return *this;
-    }
+    TuvModel& UseStandardAtmosphere();
 
     // ========================================================================
     // Surface Properties
@@ -183,6 +274,7 @@ namespace tuvx
     {
       config_.surface_albedo = albedo;
       config_.surface_albedo_spectrum.clear();
+      generation_ = NextGeneration();
       return *this;
     }
 
@@ -192,9 +284,32 @@ namespace tuvx
     TuvModel& SetSurfaceAlbedoSpectrum(std::vector<double> albedo_spectrum)
     {
       config_.surface_albedo_spectrum = std::move(albedo_spectrum);
+      generation_ = NextGeneration();
+      return *this;
+    }
+
+    // ========================================================================
+    // Solver Setup
+    // ========================================================================
+
+    /// @brief Replace the radiative transfer solver
+    /// @param solver Solver to use; kept across SetConfig()
+    /// @return Reference to this model for chaining
+    TuvModel& SetSolver(std::unique_ptr<Solver> solver)
+    {
+      solver_ = std::move(solver);
+      custom_solver_ = solver_ != nullptr;
+      generation_ = NextGeneration();
       return *this;
     }
 
+    /// @brief Get the radiative transfer solver
+    /// @note Null until prepared when lazy initialization defers the solver
+    const Solver* GetSolver() const
+    {
+      return solver_.get();
+    }
+
     // ========================================================================
     // Radiator Setup
     // ========================================================================
@@ -202,9 +317,14 @@ namespace tuvx
     /// @brief Add a radiator (absorber/scatterer) to the model
     /// @param radiator Radiator to add (model takes ownership via clone)
     /// @return Reference to this model for chaining
+    ///
+    /// Radiators still deferred by lazy initialization are prepared first so
+    /// the radiator order does not depend on the initialization mode.
     TuvModel& AddRadiator(const Radiator& radiator)
     {
-      radiators_.Add(radiator.Clone());
+      PrepareRadiators();
+      radiators_.Add(startup_profile_.Measure("radiator " + radiator.Name(), [&] { return radiator.Clone(); }));
+      generation_ = NextGeneration();
       return *this;
     }
 
@@ -218,16 +338,19 @@ namespace tuvx
     /// @return Reference to this model for chaining
     TuvModel& AddO3Radiator()
     {
-      auto o3_radiator = std::make_unique<FromCrossSectionRadiator>(
-          "O3",
-          std::make_unique<O3CrossSection>(),
-          "O3",          // density profile name
-          "temperature", // temperature profile name
-          "wavelength",  // wavelength grid name
-          "altitude"     // altitude grid name
-      );
-      radiators_.Add(std::move(o3_radiator));
-      return *this;
+      return AddRadiatorFactory(
+          "radiator O3",
+          []() -> std::unique_ptr<Radiator>
+          {
+            return std::make_unique<FromCrossSectionRadiator>(
+                "O3",
+                std::make_unique<O3CrossSection>(),
+                "O3",          // density profile name
+                "temperature", // temperature profile name
+                "wavelength",  // wavelength grid name
+                "altitude"     // altitude grid name
+            );
+          });
     }
 
     /// @brief Add oxygen (O2) as a radiator using Schumann-Runge cross-sections
@@ -239,16 +362,19 @@ namespace tuvx
     /// @return Reference to this model for chaining
     TuvModel& AddO2Radiator()
     {
-      auto o2_radiator = std::make_unique<FromCrossSectionRadiator>(
-          "O2",
-          std::make_unique<O2CrossSection>(),
-          "O2",          // density profile name
-          "temperature", // temperature profile name
-          "wavelength",  // wavelength grid name
-          "altitude"     // altitude grid name
-      );
-      radiators_.Add(std::move(o2_radiator));
-      return *this;
+      return AddRadiatorFactory(
+          "radiator O2",
+          []() -> std::unique_ptr<Radiator>
+          {
+            return std::make_unique<FromCrossSectionRadiator>(
+                "O2",
+                std::make_unique<O2CrossSection>(),
+                "O2",          // density profile name
+                "temperature", // temperature profile name
+                "wavelength",  // wavelength grid name
+                "altitude"     // altitude grid name
+            );
+          });
     }
 
     /// @brief Add Rayleigh (molecular) scattering
@@ -260,13 +386,16 @@ namespace tuvx
     /// @return Reference to this model for chaining
     TuvModel& AddRayleighRadiator()
     {
-      auto rayleigh_radiator = std::make_unique<RayleighRadiator>(
-          "air_density", // air density profile name
-          "wavelength",  // wavelength grid name
-          "altitude"     // altitude grid name
-      );
-      radiators_.Add(std::move(rayleigh_radiator));
-      return *this;
+      return AddRadiatorFactory(
+          "radiator Rayleigh",
+          []() -> std::unique_ptr<Radiator>
+          {
+            return std::make_unique<RayleighRadiator>(
+                "air_density", // air density profile name
+                "wavelength",  // wavelength grid name
+                "altitude"     // altitude grid name
+            );
+          });
     }
 
     /// @brief Add aerosol radiator with default configuration
@@ -277,9 +406,8 @@ namespace tuvx
     /// @return Reference to this model for chaining
     TuvModel& AddAerosolRadiator()
     {
-      auto aerosol_radiator = std::make_unique<AerosolRadiator>();
-      radiators_.Add(std::move(aerosol_radiator));
-      return *this;
+      return AddRadiatorFactory(
+          "radiator aerosol", []() -> std::unique_ptr<Radiator> { return std::make_unique<AerosolRadiator>(); });
     }
 
     /// @brief Add aerosol radiator with custom configuration
@@ -288,9 +416,9 @@ namespace tuvx
     /// @return Reference to this model for chaining
     TuvModel& AddAerosolRadiator(AerosolRadiator::Config config)
     {
-      auto aerosol_radiator = std::make_unique<AerosolRadiator>(std::move(config));
-      radiators_.Add(std::move(aerosol_radiator));
-      return *this;
+      return AddRadiatorFactory(
+          "radiator aerosol",
+          [config = std::move(config)]() -> std::unique_ptr<Radiator> { return std::make_unique<AerosolRadiator>(config); });
     }
 
     /// @brief Add all standard radiators (O3, O2, Rayleigh)
@@ -323,161 +451,160 @@ namespace tuvx
         const QuantumYield* quantum_yield)
     {
       photolysis_reactions_.AddReaction(name, cross_section, quantum_yield);
+      generation_ = NextGeneration();
       return *this;
     }
 
+    /// @brief Tabulate the model's spectral data on its wavelength grid for a shared segment
+    /// @param builder Builder the tables are added to
+    /// @param temperatures Temperatures to tabulate at [K], ascending
+    /// @param air_density Air density the quantum yields are evaluated at [molecules/cm^3]
+    /// @throws std::invalid_argument if the builder already holds a table of the same name
+    ///
+    /// Adds every reaction's spectra ("<reaction>/cross_section/...",
+    /// "<reaction>/quantum_yield/..."), the cross-section of every absorbing
+    /// radiator ("radiator <name>/cross_section/...", e.g. O3 and O2) and the
+    /// extraterrestrial flux ("extraterrestrial_flux"). A spectrum used by
+    /// several reactions is tabulated once, under the first of them. One rank
+    /// per node calls this and publishes the builder; every rank then passes
+    /// the segment to UseSharedTables() on a model with the same reactions,
+    /// radiators and wavelength grid.
+    void BinSharedTables(SharedTableBuilder& builder, const std::vector<double>& temperatures, double air_density = 0.0)
+        const;
+
+    /// @brief Read the model's spectral data from a shared table segment
+    /// @param segment Segment holding the tables written by BinSharedTables()
+    /// @return Reference to this model for chaining
+    /// @throws std::out_of_range if a reaction's or radiator's tables, or the flux, are missing
+    /// @throws std::invalid_argument if their shapes are inconsistent
+    ///
+    /// Each reaction's cross-section and quantum yield, and each absorbing
+    /// radiator's cross-section, are replaced by a SharedCrossSection or
+    /// SharedQuantumYield reading the mapping, which the model (and its
+    /// copies) keep alive. Values are interpolated linearly in temperature
+    /// between the tabulated ones. Radiators deferred by lazy initialization
+    /// are built first. The extraterrestrial flux, one value per wavelength
+    /// bin, is copied from the segment, so the reference spectrum it is
+    /// binned from is never built on this rank. Radiators added afterwards
+    /// keep their own tables.
+    TuvModel& UseSharedTables(std::shared_ptr<const SharedTableSegment> segment);
+
     // ========================================================================
-    // Calculation
+    // Initialization
     // ========================================================================
 
-    /// @brief Calculate radiation field and photolysis rates
-    /// @return Model output containing all computed quantities
-    ModelOutput Calculate()
-    {
-      return Calculate(config_.solar_zenith_angle);
-    }
-
-    /// @brief Calculate for a specific solar zenith angle
-    /// @param solar_zenith_angle Solar zenith angle [degrees]
-    /// @return Model output
-    ModelOutput Calculate(double solar_zenith_angle)
-    {
-      ModelOutput output;
-
-      // Store calculation metadata
-      output.solar_zenith_angle = solar_zenith_angle;
-      output.day_of_year = config_.day_of_year;
-      output.earth_sun_distance = config_.EffectiveEarthSunDistance();
-      output.is_daytime = solar_zenith_angle < 90.0;
-      output.used_spherical_geometry = config_.use_spherical_geometry;
-
-      // Store grids
-      output.wavelength_grid = wavelength_grid_;
-      output.altitude_grid = altitude_grid_;
-
-      // Get number of levels and wavelengths
-      std::size_t n_layers = altitude_grid_.Spec().n_cells;
-      std::size_t n_wavelengths = wavelength_grid_.Spec().n_cells;
-
-      // Compute spherical geometry if enabled
-      SphericalGeometry::SlantPathResult geometry;
-      if (config_.use_spherical_geometry)
-      {
-        SphericalGeometry spherical_geom(altitude_grid_, config_.earth_radius);
-        geometry = spherical_geom.Calculate(solar_zenith_angle);
-      }
-
-      // Get extraterrestrial flux using ASTM E-490 reference spectrum
-      auto et_flux = solar::reference_spectra::CreateASTM_E490();
-      auto solar_flux = et_flux.Calculate(wavelength_grid_);
-
-      // Apply Earth-Sun distance correction
-      double distance_factor = 1.0 / (output.earth_sun_distance * output.earth_sun_distance);
-      for (auto& flux : solar_flux)
-      {
-        flux *= distance_factor;
-      }
-
-      // Get surface albedo
-      std::vector<double> surface_albedo;
-      if (!config_.surface_albedo_spectrum.empty())
-      {
-        surface_albedo = config_.surface_albedo_spectrum;
-      }
-      else
-      {
-        surface_albedo.assign(n_wavelengths, config_.surface_albedo);
-      }
-
-      // Get altitude midpoints for profile generation
-      auto midpoints_span = altitude_grid_.Midpoints();
-      std::vector<double> midpoints_vec(midpoints_span.begin(), midpoints_span.end());
-
-      // Get temperature profile for cross-section calculations
-      std::vector<double> temperatures = config_.temperature_profile;
-      if (temperatures.empty())
+    /// @brief Prepare every component that is still deferred
+    ///
+    /// Builds the solver, the radiators deferred by lazy initialization and
+    /// the extraterrestrial flux on the wavelength grid. Calculations do this
+    /// on first use; call it beforehand to keep the cost out of a timed
+    /// region. Does nothing once everything is prepared.
+    void PrepareComponents()
+    {
+      PrepareRadiators();
+      if (!solver_)
       {
-        temperatures = StandardAtmosphere::GenerateTemperatureProfile(midpoints_vec);
+        InitializeSolver();
       }
-
-      // Get air density profile
-      std::vector<double> air_density = config_.air_density_profile;
-      if (air_density.empty())
+      if (extraterrestrial_flux_.empty())
       {
-        air_density = StandardAtmosphere::GenerateAirDensityProfile(midpoints_vec);
+        InitializeExtraterrestrialFlux();
       }
+    }
 
-      // Get ozone profile
-      std::vector<double> ozone = config_.ozone_profile;
-      if (ozone.empty())
-      {
-        ozone = StandardAtmosphere::GenerateOzoneProfile(midpoints_vec, config_.ozone_column_DU);
-      }
+    /// @brief Compile the current configuration into an execution plan
+    /// @return Plan that runs columns with only the per-column work
+    ///
+    /// Prepares every deferred component, then resolves the grids, profiles,
+    /// geometry, flux and workspaces a column calculation needs and bins
+    /// every reaction's spectra on the wavelength grid. Defined in
+    /// execution_plan.hpp, which callers include.
+    ExecutionPlan Prepare();
 
-      // Get O2 profile (20.95% of air density)
-      std::vector<double> o2;
-      o2.reserve(air_density.size());
-      for (double air_n : air_density)
-      {
-        o2.push_back(air_n * StandardAtmosphere::kO2MixingRatio);
-      }
+    /// @brief Compile the current configuration into an execution plan
+    /// @param config Temperatures the plan tabulates the reaction spectra at
+    /// @return Plan that runs columns with only the per-column work
+    /// @throws std::invalid_argument if the temperature range is invalid
+    ExecutionPlan Prepare(const ExecutionPlanConfig& config);
 
-      // Combine radiator states
-      RadiatorState combined_state;
-      combined_state.Initialize(n_layers, n_wavelengths);
+    /// @brief Whether every component has been prepared
+    bool IsPrepared() const
+    {
+      return pending_radiators_.empty() && solver_ && !extraterrestrial_flux_.empty();
+    }
 
-      // Update radiators if any are configured
-      if (!radiators_.Empty())
-      {
-        // Create grid warehouse
-        GridWarehouse grids;
-        grids.Add(wavelength_grid_);
-        grids.Add(altitude_grid_);
-
-        // Create profile warehouse with atmospheric profiles
-        ProfileWarehouse profiles;
-        profiles.Add(Profile(
-            ProfileSpec{ "temperature", "K", n_layers },
-            temperatures));
-        profiles.Add(Profile(
-            ProfileSpec{ "air_density", "molecules/cm^3", n_layers },
-            air_density));
-        profiles.Add(Profile(
-            ProfileSpec{ "O3", "molecules/cm^3", n_layers },
-            ozone));
-        profiles.Add(Profile(
-            ProfileSpec{ "O2", "molecules/cm^3", n_layers },
-            o2));
-
-        // Update all radiators with current atmospheric state
-        radiators_.UpdateAll(grids, profiles);
-
-        // Get combined optical properties from all radiators
-        combined_state = radiators_.CombinedState();
-      }
+    /// @brief Time and memory spent preparing each component so far
+    const StartupProfiler& StartupProfile() const
+    {
+      return startup_profile_;
+    }
 
-      // Set up solver input
-      SolverInput solver_input;
-      solver_input.radiator_state = &combined_state;
-      solver_input.solar_zenith_angle = solar_zenith_angle;
-      solver_input.extraterrestrial_flux = &solar_flux;
-      solver_input.surface_albedo = &surface_albedo;
+    /// @brief Identifies the model's current configuration
+    ///
+    /// Every setter, Add*() call and Calculate() for a date and location
+    /// changes it. Values are drawn from a process-wide counter, so no two
+    /// models, or states of one model, share a value, even when one model is
+    /// destroyed and another built at the same address. An ExecutionPlan
+    /// records the value it was built at and refuses to run once it differs.
+    std::uint64_t Generation() const
+    {
+      return generation_;
+    }
 
-      if (config_.use_spherical_geometry)
-      {
-        solver_input.geometry = &geometry;
-      }
+    // ========================================================================
+    // Calculation
+    // ========================================================================
 
-      // Solve radiative transfer
-      output.radiation_field = solver_->Solve(solver_input);
+    /// @brief Calculate radiation field and photolysis rates
+    /// @return Model output containing all computed quantities
+    ModelOutput Calculate()
+    {
+      return Calculate(config_.solar_zenith_angle);
+    }
 
-      // Calculate photolysis rates
-      output.photolysis_rates = photolysis_reactions_.CalculateAll(
-          output.radiation_field, wavelength_grid_, temperatures);
+    /// @brief Calculate for a specific solar zenith angle
+    /// @param solar_zenith_angle Solar zenith angle [degrees]
+    /// @return Model output
+    ModelOutput Calculate(double solar_zenith_angle);
 
-      return output;
+    /// @brief Calculate radiation field and photolysis rates into an existing output
+    /// @param output Output to overwrite (see Calculate(double, ModelOutput&))
+    void Calculate(ModelOutput& output)
+    {
+      Calculate(config_.solar_zenith_angle, output);
     }
 
+    /// @brief Calculate for a specific solar zenith angle into an existing output
+    /// @param solar_zenith_angle Solar zenith angle [degrees]
+    /// @param output Output to overwrite
+    ///
+    /// Gives the same values as Calculate(solar_zenith_angle) but reuses the
+    /// output's storage: grids are copied only when they differ, the radiation
+    /// field and rate vectors are overwritten in place, and reaction names are
+    /// written only when the reaction list changed. In a time loop with a
+    /// fixed configuration, passing the same output each step avoids
+    /// reallocating it.
+    void Calculate(double solar_zenith_angle, ModelOutput& output);
+
+    /// @brief Calculate photolysis rates for one column into caller-owned memory
+    /// @param column Column inputs (SZA, albedo, optional profiles)
+    /// @param rates Destination array; J for reaction r at level l is written to
+    ///              rates[r * reaction_stride + l * level_stride]
+    /// @param reaction_stride Distance between reactions [elements]
+    /// @param level_stride Distance between levels [elements]
+    /// @throws TuvxInternalException if a profile does not match the altitude grid
+    ///
+    /// This is the bulk entry point used by BatchDriver and the C API. It skips
+    /// ModelOutput entirely: no grids, radiation field or reaction names are
+    /// copied out, and J-values go straight to the destination. It runs the
+    /// four column stages in order on a workspace owned by the model, whose
+    /// buffers keep their capacity from one column to the next.
+    void CalculatePhotolysisRates(
+        const ColumnView& column,
+        double* rates,
+        std::ptrdiff_t reaction_stride,
+        std::ptrdiff_t level_stride);
+
     /// @brief Calculate for a specific location and time
     /// @param year Year
     /// @param month Month [1-12]
@@ -492,18 +619,93 @@ namespace tuvx
         int day,
         double hour,
         double latitude,
-        double longitude)
-    {
-      // Calculate solar position using free functions from solar namespace
-      auto position = solar::CalculateSolarPosition(year, month, day, hour, latitude, longitude);
+        double longitude);
+
+    /// @brief Calculate for a specific location and time into an existing output
+    /// @param year Year
+    /// @param month Month [1-12]
+    /// @param day Day of month [1-31]
+    /// @param hour Hour (UTC) with fractional hours
+    /// @param latitude Latitude [degrees]
+    /// @param longitude Longitude [degrees]
+    /// @param output Output to overwrite (see Calculate(double, ModelOutput&))
+    void Calculate(
+        int year,
+        int month,
+        int day,
+        double hour,
+        double latitude,
+        double longitude,
+        ModelOutput& output);
+
+    // ========================================================================
+    // Column Stages
+    // ========================================================================
 
-      // Update config
-      config_.solar_zenith_angle = position.zenith_angle;
-      config_.day_of_year = solar::DayOfYear(year, month, day);
-      config_.latitude = latitude;
-      config_.longitude = longitude;
+    /// @brief Stage 1: gather one column's inputs into a workspace
+    /// @param column Column inputs (SZA, albedo, optional profiles)
+    /// @param workspace Workspace to fill
+    /// @throws TuvxInternalException if a profile does not match the altitude grid
+    ///
+    /// Profiles missing from the column come from the configuration or the
+    /// US Standard Atmosphere, as in CalculatePhotolysisRates().
+    void GatherColumn(const ColumnView& column, ColumnWorkspace& workspace) const;
+
+    /// @brief Stage 2: compute slant paths and combined optical properties
+    /// @param workspace Workspace filled by GatherColumn()
+    ///
+    /// Updates the model's radiators, so only one thread may run this stage
+    /// at a time. Prepares any deferred components first.
+    void ComputeOpticalProperties(ColumnWorkspace& workspace);
+
+    /// @brief Stage 3: solve radiative transfer for the column
+    /// @param workspace Workspace filled by ComputeOpticalProperties()
+    /// @throws TuvxInternalException if the model has not been prepared
+    ///
+    /// Equivalent to FillSolarFlux() followed by a solve of
+    /// ColumnSolverInput(workspace, workspace.optical_properties).
+    void SolveColumn(ColumnWorkspace& workspace) const;
+
+    /// @brief Extraterrestrial flux on the wavelength grid, corrected for the Earth-Sun distance
+    /// @param solar_flux Destination, resized to the number of wavelength bins
+    void FillSolarFlux(std::vector<double>& solar_flux) const;
+
+    /// @brief Solver input for a column, as SolveColumn() builds it
+    /// @param workspace Workspace whose solar flux, albedo, angle and geometry are used
+    /// @param optical_properties Combined optical properties to solve with
+    /// @return Input referring to workspace and optical_properties, which must outlive it
+    SolverInput ColumnSolverInput(const ColumnWorkspace& workspace, const RadiatorState& optical_properties) const;
+
+    /// @brief Stage 4: integrate photolysis rates for the column
+    /// @param workspace Workspace filled by SolveColumn()
+    /// @param rates Destination array; J for reaction r at level l is written to
+    ///              rates[r * reaction_stride + l * level_stride]
+    /// @param reaction_stride Distance between reactions [elements]
+    /// @param level_stride Distance between levels [elements]
+    void IntegrateColumn(
+        const ColumnWorkspace& workspace,
+        double* rates,
+        std::ptrdiff_t reaction_stride,
+        std::ptrdiff_t level_stride) const;
+
+    /// @brief Set a callback to run after each Calculate(solar_zenith_angle)
+    /// @param observer Callback, or an empty function to remove it
+    ///
+    /// The bulk CalculatePhotolysisRates() path notifies the column observer
+    /// instead.
+    void SetCalculateObserver(CalculateObserver observer)
+    {
+      calculate_observer_ = std::move(observer);
+    }
 
-      return Calculate(position.zenith_angle);
+    /// @brief Set a callback to run after each CalculatePhotolysisRates()
+    /// @param observer Callback, or an empty function to remove it
+    ///
+    /// Drivers that calculate on copies of the model (threaded BatchDriver,
+    /// AsyncCalculator) do not notify it, since copies do not carry observers.
+    void SetColumnObserver(ColumnObserver observer)
+    {
+      column_observer_ = std::move(observer);
     }
 
     // ========================================================================
@@ -523,6 +725,7 @@ namespace tuvx
     }
 
     /// @brief Get radiator warehouse
+    /// @note Radiators deferred by lazy initialization appear after PrepareComponents()
     const RadiatorWarehouse& Radiators() const
     {
       return radiators_;
@@ -534,6 +737,13 @@ namespace tuvx
       return photolysis_reactions_;
     }
 
+    /// @brief Get the extraterrestrial flux at 1 AU on the wavelength grid [photons/cm^2/s/nm]
+    /// @note Empty until prepared when lazy initialization defers the flux
+    const std::vector<double>& ExtraterrestrialFlux() const
+    {
+      return extraterrestrial_flux_;
+    }
+
     /// @brief Get grid warehouse containing wavelength and altitude grids
     /// @return GridWarehouse with model grids
     GridWarehouse GetGridWarehouse() const
@@ -546,108 +756,113 @@ namespace tuvx
 
     /// @brief Create profile warehouse with current atmospheric profiles
     /// @return ProfileWarehouse with temperature, air density, O3, O2 profiles
-    ProfileWarehouse CreateProfileWarehouse() const
-    {
-      std::size_t n_layers = altitude_grid_.Spec().n_cells;
+    ProfileWarehouse CreateProfileWarehouse() const;
 
-      // Get altitude midpoints for profile generation
-      auto midpoints_span = altitude_grid_.Midpoints();
-      std::vector<double> midpoints_vec(midpoints_span.begin(), midpoints_span.end());
+   private:
+    friend class ExecutionPlan;
 
-      // Get temperature profile
-      std::vector<double> temperatures = config_.temperature_profile;
-      if (temperatures.empty())
-      {
-        temperatures = StandardAtmosphere::GenerateTemperatureProfile(midpoints_vec);
-      }
+    /// Radiator whose construction is deferred by lazy initialization
+    struct PendingRadiator
+    {
+      std::string component;
+      std::function<std::unique_ptr<Radiator>()> make;
+    };
 
-      // Get air density profile
-      std::vector<double> air_density = config_.air_density_profile;
-      if (air_density.empty())
+    /// @brief Add a radiator now, or on first use with lazy initialization
+    /// @param component Component name used in the startup profile
+    /// @param make Factory for the radiator
+    TuvModel& AddRadiatorFactory(std::string component, std::function<std::unique_ptr<Radiator>()> make)
+    {
+      if (config_.lazy_initialization)
       {
-        air_density = StandardAtmosphere::GenerateAirDensityProfile(midpoints_vec);
+        pending_radiators_.push_back({ std::move(component), std::move(make) });
       }
-
-      // Get ozone profile
-      std::vector<double> ozone = config_.ozone_profile;
-      if (ozone.empty())
+      else
       {
-        ozone = StandardAtmosphere::GenerateOzoneProfile(midpoints_vec, config_.ozone_column_DU);
+        radiators_.Add(startup_profile_.Measure(std::move(component), make));
       }
+      generation_ = NextGeneration();
+      return *this;
+    }
 
-      // Get O2 profile (20.95% of air density)
-      std::vector<double> o2;
-      o2.reserve(air_density.size());
-      for (double air_n : air_density)
+    /// @brief Construct the radiators deferred by lazy initialization, in order
+    void PrepareRadiators()
+    {
+      for (auto& pending : pending_radiators_)
       {
-        o2.push_back(air_n * StandardAtmosphere::kO2MixingRatio);
+        radiators_.Add(startup_profile_.Measure(std::move(pending.component), pending.make));
       }
+      pending_radiators_.clear();
+    }
+
+    /// @brief Gather one column profile into a contiguous buffer
+    /// @param source Column profile view (may be empty)
+    /// @param fallback Configured profile used when the view is empty (may be empty)
+    /// @param n_layers Expected number of layers
+    /// @param destination Buffer to fill; left empty if neither source is available
+    /// @throws TuvxInternalException if the selected profile has the wrong size
+    static void GatherColumnProfile(
+        const StridedView<const double>& source,
+        const std::vector<double>& fallback,
+        std::size_t n_layers,
+        std::vector<double>& destination);
+
+    /// @brief Fill the per-wavelength surface albedo of a column
+    /// @param uniform_albedo Albedo used when no surface albedo spectrum is configured
+    /// @param albedo Buffer to fill, one value per wavelength bin
+    /// @throws TuvxInternalException if the configured spectrum does not match the wavelength grid
+    ///
+    /// Shared by Calculate() and CalculatePhotolysisRates() so both treat a
+    /// configured spectrum the same way: it takes precedence over the uniform
+    /// value.
+    void FillSurfaceAlbedo(double uniform_albedo, std::vector<double>& albedo) const;
 
-      // Create profile warehouse
-      ProfileWarehouse profiles;
-      profiles.Add(Profile(
-          ProfileSpec{ "temperature", "K", n_layers },
-          temperatures));
-      profiles.Add(Profile(
-          ProfileSpec{ "air_density", "molecules/cm^3", n_layers },
-          air_density));
-      profiles.Add(Profile(
-          ProfileSpec{ "O3", "molecules/cm^3", n_layers },
-          ozone));
-      profiles.Add(Profile(
-          ProfileSpec{ "O2", "molecules/cm^3", n_layers },
-          o2));
+    /// @brief Build the grid and profile warehouses handed to the radiators
+    ///
+    /// Built once per grid; ComputeOpticalProperties() then overwrites the
+    /// profile values in place for each column.
+    void BuildColumnWarehouses();
 
-      return profiles;
-    }
+    /// @brief Move the model configuration to a solar position and date
+    /// @return Solar zenith angle [degrees]
+    double SetSolarPosition(int year, int month, int day, double hour, double latitude, double longitude);
 
-   private:
-    /// @brief Initialize model components from configuration
-    void Initialize()
+    /// @brief Shared-table keys of each reaction's cross-section and quantum yield
+    ///
+    /// A spectrum used by several reactions is keyed by the first of them;
+    /// keys are empty for a missing spectrum.
+    std::vector<std::pair<std::string, std::string>> SharedTableKeys() const;
+
+    /// @brief Shared-table key of an absorbing radiator's cross-section
+    static std::string SharedRadiatorKey(const std::string& radiator)
     {
-      InitializeWavelengthGrid();
-      InitializeAltitudeGrid();
-      InitializeSolver();
+      return "radiator " + radiator + "/cross_section";
     }
 
-    /// @brief Initialize wavelength grid
-    void InitializeWavelengthGrid()
+    /// @brief Next configuration generation, unique within the process
+    static std::uint64_t NextGeneration()
     {
-      if (!config_.wavelength_edges.empty())
-      {
-        GridSpec spec{ "wavelength", "nm", config_.wavelength_edges.size() - 1 };
-        wavelength_grid_ = Grid(spec, config_.wavelength_edges);
-      }
-      else
-      {
-        // Create default equally-spaced grid
-        GridSpec spec{ "wavelength", "nm", config_.n_wavelength_bins };
-        wavelength_grid_ = Grid::EquallySpaced(spec, config_.wavelength_min, config_.wavelength_max);
-      }
+      static std::atomic<std::uint64_t> counter{ 0 };
+      return counter.fetch_add(1, std::memory_order_relaxed) + 1;
     }
 
+    /// @brief Copy a grid unless the destination already holds the same one
+    static void CopyGrid(const Grid& source, Grid& destination);
+
+    /// @brief Initialize model components from configuration
+    void Initialize();
+
+    /// @brief Initialize wavelength grid
+    void InitializeWavelengthGrid();
+
     /// @brief Initialize altitude grid
-    void InitializeAltitudeGrid()
-    {
-      if (!config_.altitude_edges.empty())
-      {
-        GridSpec spec{ "altitude", "km", config_.altitude_edges.size() - 1 };
-        altitude_grid_ = Grid(spec, config_.altitude_edges);
-      }
-      else
-      {
-        // Create default equally-spaced grid
-        GridSpec spec{ "altitude", "km", config_.n_altitude_layers };
-        altitude_grid_ = Grid::EquallySpaced(spec, config_.altitude_min, config_.altitude_max);
-      }
-    }
+    void InitializeAltitudeGrid();
 
     /// @brief Initialize solver
-    void InitializeSolver()
-    {
-      // Currently only Delta-Eddington is supported
-      solver_ = std::make_unique<DeltaEddingtonSolver>();
-    }
+    void InitializeSolver();
+
+    /// @brief Evaluate the extraterrestrial flux on the wavelength grid
+    void InitializeExtraterrestrialFlux();
 
     // Configuration
     ModelConfig config_;
@@ -664,6 +879,48 @@ namespace tuvx
 
     // Solver
     std::unique_ptr<Solver> solver_;
+    bool custom_solver_{ false };
+
+    // Radiators not yet constructed (lazy initialization)
+    std::vector<PendingRadiator> pending_radiators_;
+
+    // Extraterrestrial flux on the wavelength grid at 1 AU; empty until prepared
+    std::vector<double> extraterrestrial_flux_;
+
+    // Spectra created by UseSharedTables(); shared with copies of the model
+    std::vector<std::shared_ptr<const CrossSection>> shared_cross_sections_;
+    std::vector<std::shared_ptr<const QuantumYield>> shared_quantum_yields_;
+
+    // Cost of each component preparation
+    StartupProfiler startup_profile_;
+
+    // Workspace reused by Calculate() and CalculatePhotolysisRates()
+    ColumnWorkspace column_workspace_;
+
+    // Grids and profiles handed to the radiators, refilled for each column;
+    // empty until first used and cleared when a grid changes
+    GridWarehouse column_grids_;
+    ProfileWarehouse column_profiles_;
+    struct
+    {
+      ProfileHandle temperature;
+      ProfileHandle air_density;
+      ProfileHandle ozone;
+      ProfileHandle o2;
+    } column_profile_handles_;
+
+    // Optional hook run after each Calculate(solar_zenith_angle)
+    CalculateObserver calculate_observer_;
+
+    // Optional hook run after each CalculatePhotolysisRates()
+    ColumnObserver column_observer_;
+
+    // Replaced on every configuration change (see Generation())
+    std::uint64_t generation_{ NextGeneration() };
   };
 
 }  // namespace tuvx
+
+#if TUVX_HEADER_ONLY
+  #include <tuvx/model/tuv_model-inl.hpp>
+#endif
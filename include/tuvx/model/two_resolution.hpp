@@ -0,0 +1,457 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <tuvx/model/column_state.hpp>
+#include <tuvx/model/column_workspace.hpp>
+#include <tuvx/model/differential_harness.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/solver/direct_beam.hpp>
+#include <tuvx/util/internal_error.hpp>
+
+namespace tuvx
+{
+  /// @brief Options for TwoResolutionModel
+  struct TwoResolutionConfig
+  {
+    /// Number of adjacent fine bins merged into each coarse bin; the last
+    /// coarse bin takes any remainder. Ignored when coarse_edges is set.
+    std::size_t merge_factor{ 4 };
+
+    /// Explicit coarse grid [nm]; a subset of the fine grid's edges spanning
+    /// the same range, such as BandAggregation::BandEdges()
+    std::vector<double> coarse_edges;
+
+    /// Largest change of any level's slant optical depth, in any coarse bin,
+    /// tolerated before the fine/coarse ratios are recomputed
+    double refresh_tolerance{ 0.2 };
+
+    /// Slant optical depths are capped here when comparing columns; the
+    /// direct beam is below e^-10 of its top-of-atmosphere value beyond it
+    double max_optical_depth{ 10.0 };
+  };
+
+  /// @brief Radiative transfer on a coarse grid, photolysis on a fine grid
+  ///
+  /// The full solver runs on a coarse wavelength grid. Its radiation field
+  /// is projected onto the fine grid by per-level shape ratios
+  /// S = F_fine / F_coarse of the direct-beam actinic flux, which carry the
+  /// structure of the solar spectrum and of the absorber cross-sections
+  /// inside each coarse bin, and J-values are integrated on the fine grid.
+  /// Every component of the coarse field is scaled by the same ratio, so the
+  /// direct beam is reproduced exactly and the diffuse light is assumed to
+  /// share its spectral shape within a coarse bin. Where the coarse direct
+  /// beam is extinguished, a level reuses the ratios of the level above.
+  ///
+  /// The ratios come from a DirectBeamSolver pass on the fine grid, whose
+  /// optical-property update is the costly part, so they are cached and
+  /// reused while the column stays close to the one they were computed for.
+  /// Closeness is measured on the coarse direct beam every column solves
+  /// anyway: the ratios are refreshed once the slant optical depth of any
+  /// level in any coarse bin has moved by more than
+  /// TwoResolutionConfig::refresh_tolerance. Slowly varying sequences, such
+  /// as neighbouring columns or successive time steps of one column, then
+  /// pay for the fine pass only occasionally.
+  ///
+  /// Like TuvModel, an instance is not thread-safe; give each thread its
+  /// own copy.
+  ///
+  /// Example usage:
+  /// @code
+  /// TwoResolutionModel model(fine_model);
+  /// for (const auto& column : columns)
+  /// {
+  ///   model.CalculatePhotolysisRates(column.View(), rates, reaction_stride, level_stride);
+  /// }
+  /// std::cout << model.RatioRefreshes() << " of " << model.Columns() << " columns refreshed\n";
+  /// @endcode
+  class TwoResolutionModel
+  {
+   public:
+    /// @brief Build the coarse and fine models
+    /// @param fine_model Model on the fine grid, with its radiators, reactions and solver
+    /// @param config Two-resolution options
+    /// @throws std::invalid_argument if merge_factor is zero, or coarse_edges is not an
+    ///         ascending subset of the fine edges with the same end points
+    explicit TwoResolutionModel(const TuvModel& fine_model, TwoResolutionConfig config = TwoResolutionConfig{})
+        : config_(std::move(config)),
+          coarse_(fine_model),
+          fine_(fine_model)
+    {
+      fine_.PrepareComponents();
+      auto fine_edges_span = fine_.WavelengthGrid().Edges();
+      std::vector<double> fine_edges(fine_edges_span.begin(), fine_edges_span.end());
+      std::size_t n_fine = fine_edges.size() - 1;
+
+      // Index of the first fine bin of each coarse bin, then the fine bin count
+      std::vector<std::size_t> starts;
+      if (config_.coarse_edges.empty())
+      {
+        if (config_.merge_factor == 0)
+        {
+          TUVX_THROW(std::invalid_argument("Two-resolution merge factor must be positive"));
+        }
+        for (std::size_t start = 0; start < n_fine; start += config_.merge_factor)
+        {
+          starts.push_back(start);
+        }
+      }
+      else
+      {
+        for (double edge : config_.coarse_edges)
+        {
+          auto index = static_cast<std::size_t>(std::find(fine_edges.begin(), fine_edges.end(), edge) - fine_edges.begin());
+          if (index == fine_edges.size() || (!starts.empty() && index <= starts.back()))
+          {
+            TUVX_THROW(std::invalid_argument("Coarse edges must be ascending fine-grid edges"));
+          }
+          starts.push_back(index);
+        }
+        if (starts.size() < 2 || starts.front() != 0 || starts.back() != n_fine)
+        {
+          TUVX_THROW(std::invalid_argument("Coarse edges must span the fine grid"));
+        }
+        starts.pop_back();
+      }
+      starts.push_back(n_fine);
+
+      std::vector<double> coarse_edges;
+      coarse_bin_.resize(n_fine);
+      for (std::size_t b = 0; b + 1 < starts.size(); ++b)
+      {
+        coarse_edges.push_back(fine_edges[starts[b]]);
+        std::fill(coarse_bin_.begin() + static_cast<std::ptrdiff_t>(starts[b]),
+                  coarse_bin_.begin() + static_cast<std::ptrdiff_t>(starts[b + 1]),
+                  b);
+      }
+      coarse_edges.push_back(fine_edges.back());
+
+      // Coarse flux is the bin mean of the fine flux, not the reference
+      // spectrum at the coarse midpoints
+      const auto& fine_flux = fine_.ExtraterrestrialFlux();
+      std::vector<double> coarse_flux(coarse_edges.size() - 1, 0.0);
+      for (std::size_t j = 0; j < n_fine; ++j)
+      {
+        coarse_flux[coarse_bin_[j]] += fine_flux[j] * std::abs(fine_edges[j + 1] - fine_edges[j]);
+      }
+      for (std::size_t b = 0; b < coarse_flux.size(); ++b)
+      {
+        coarse_flux[b] /= std::abs(coarse_edges[b + 1] - coarse_edges[b]);
+      }
+      coarse_.SetWavelengthGrid(std::move(coarse_edges));
+      coarse_.SetExtraterrestrialFlux(std::move(coarse_flux));
+      coarse_.PrepareComponents();
+
+      fine_.SetSolver(std::make_unique<DirectBeamSolver>());
+    }
+
+    /// @brief Calculate photolysis rates for one column into caller-owned memory
+    /// @param column Column inputs (SZA, albedo, optional profiles)
+    /// @param rates Destination array; J for reaction r at level l is written to
+    ///              rates[r * reaction_stride + l * level_stride]
+    /// @param reaction_stride Distance between reactions [elements]
+    /// @param level_stride Distance between levels [elements]
+    /// @throws TuvxInternalException if a profile does not match the altitude grid
+    ///
+    /// Same contract as TuvModel::CalculatePhotolysisRates() on the fine model.
+    void CalculatePhotolysisRates(
+        const ColumnView& column,
+        double* rates,
+        std::ptrdiff_t reaction_stride,
+        std::ptrdiff_t level_stride)
+    {
+      ++columns_;
+      coarse_.GatherColumn(column, coarse_workspace_);
+      coarse_.ComputeOpticalProperties(coarse_workspace_);
+      coarse_.SolveColumn(coarse_workspace_);
+      fine_.GatherColumn(column, fine_workspace_);
+
+      const RadiationField& coarse_field = coarse_workspace_.radiation_field;
+      RadiationField& fine_field = fine_workspace_.radiation_field;
+      std::size_t n_levels = coarse_field.NumberOfLevels();
+      std::size_t n_fine = coarse_bin_.size();
+      const auto& top = coarse_field.actinic_flux_direct[n_levels - 1];
+      if (std::none_of(top.begin(), top.end(), [](double flux) { return flux > 0.0; }))
+      {
+        // Night time - no radiation on either grid
+        fine_field.Initialize(n_levels, n_fine);
+        fine_.IntegrateColumn(fine_workspace_, rates, reaction_stride, level_stride);
+        return;
+      }
+
+      ComputeSignature(coarse_field, signature_scratch_);
+      if (NeedsRefresh())
+      {
+        RefreshRatios();
+        std::swap(signature_, signature_scratch_);
+      }
+
+      fine_field.Initialize(n_levels, n_fine);
+      for (std::size_t l = 0; l < n_levels; ++l)
+      {
+        const double* ratio = ratios_.data() + l * n_fine;
+        for (auto [coarse_component, fine_component] :
+             { std::pair{ &coarse_field.direct_irradiance, &fine_field.direct_irradiance },
+               std::pair{ &coarse_field.diffuse_up, &fine_field.diffuse_up },
+               std::pair{ &coarse_field.diffuse_down, &fine_field.diffuse_down },
+               std::pair{ &coarse_field.actinic_flux_direct, &fine_field.actinic_flux_direct },
+               std::pair{ &coarse_field.actinic_flux_diffuse, &fine_field.actinic_flux_diffuse } })
+        {
+          const double* coarse_values = (*coarse_component)[l].data();
+          double* fine_values = (*fine_component)[l].data();
+          for (std::size_t j = 0; j < n_fine; ++j)
+          {
+            fine_values[j] = coarse_values[coarse_bin_[j]] * ratio[j];
+          }
+        }
+      }
+      fine_.IntegrateColumn(fine_workspace_, rates, reaction_stride, level_stride);
+    }
+
+    /// @brief Model on the coarse grid, running the fine model's solver
+    const TuvModel& CoarseModel() const
+    {
+      return coarse_;
+    }
+
+    /// @brief Model on the fine grid; its solver is a DirectBeamSolver
+    const TuvModel& FineModel() const
+    {
+      return fine_;
+    }
+
+    /// @brief Fine altitude grid, as for TuvModel
+    const Grid& AltitudeGrid() const
+    {
+      return fine_.AltitudeGrid();
+    }
+
+    /// @brief Reactions integrated on the fine grid, as for TuvModel
+    const PhotolysisRateSet& PhotolysisReactions() const
+    {
+      return fine_.PhotolysisReactions();
+    }
+
+    /// @brief Number of coarse bins the radiative transfer is solved on
+    std::size_t NumberOfCoarseBins() const
+    {
+      return coarse_.WavelengthGrid().Spec().n_cells;
+    }
+
+    /// @brief Columns calculated so far
+    std::size_t Columns() const
+    {
+      return columns_;
+    }
+
+    /// @brief Columns so far that recomputed the fine/coarse ratios
+    std::size_t RatioRefreshes() const
+    {
+      return ratio_refreshes_;
+    }
+
+    /// @brief Recompute the ratios on the next daytime column
+    void InvalidateRatios()
+    {
+      signature_.clear();
+    }
+
+   private:
+    /// @brief Capped slant optical depth of the coarse direct beam [level][coarse bin]
+    void ComputeSignature(const RadiationField& coarse_field, std::vector<double>& signature) const
+    {
+      std::size_t n_levels = coarse_field.NumberOfLevels();
+      std::size_t n_coarse = coarse_field.NumberOfWavelengths();
+      const auto& top = coarse_field.actinic_flux_direct[n_levels - 1];
+      signature.resize(n_levels * n_coarse);
+      for (std::size_t l = 0; l < n_levels; ++l)
+      {
+        const auto& direct = coarse_field.actinic_flux_direct[l];
+        for (std::size_t b = 0; b < n_coarse; ++b)
+        {
+          double depth = 0.0;
+          if (top[b] > 0.0)
+          {
+            depth = direct[b] > 0.0 ? std::min(std::log(top[b] / direct[b]), config_.max_optical_depth)
+                                    : config_.max_optical_depth;
+          }
+          signature[l * n_coarse + b] = depth;
+        }
+      }
+    }
+
+    /// @brief Whether the cached ratios are missing or were computed for a column too far away
+    bool NeedsRefresh() const
+    {
+      if (signature_.size() != signature_scratch_.size())
+      {
+        return true;
+      }
+      for (std::size_t i = 0; i < signature_.size(); ++i)
+      {
+        if (std::abs(signature_scratch_[i] - signature_[i]) > config_.refresh_tolerance)
+        {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    /// @brief Solve the direct beam on the fine grid and divide by the coarse one
+    void RefreshRatios()
+    {
+      ++ratio_refreshes_;
+      fine_.ComputeOpticalProperties(fine_workspace_);
+      fine_.SolveColumn(fine_workspace_);
+
+      const auto& fine_direct = fine_workspace_.radiation_field.actinic_flux_direct;
+      const auto& coarse_direct = coarse_workspace_.radiation_field.actinic_flux_direct;
+      std::size_t n_levels = fine_direct.size();
+      std::size_t n_fine = coarse_bin_.size();
+      ratios_.assign(n_levels * n_fine, 0.0);
+      for (std::size_t i = n_levels; i > 0; --i)
+      {
+        std::size_t l = i - 1;
+        double* ratio = ratios_.data() + l * n_fine;
+        for (std::size_t j = 0; j < n_fine; ++j)
+        {
+          double coarse = coarse_direct[l][coarse_bin_[j]];
+          if (coarse > 0.0)
+          {
+            ratio[j] = fine_direct[l][j] / coarse;
+          }
+          else if (l + 1 < n_levels)
+          {
+            ratio[j] = ratio[j + n_fine];
+          }
+        }
+      }
+    }
+
+    TwoResolutionConfig config_;
+    TuvModel coarse_;
+    TuvModel fine_;
+
+    /// Coarse bin of each fine bin
+    std::vector<std::size_t> coarse_bin_;
+
+    /// Cached F_fine / F_coarse, [level][fine bin]
+    std::vector<double> ratios_;
+
+    /// Signature of the column the ratios were computed for, and of the current column
+    std::vector<double> signature_;
+    std::vector<double> signature_scratch_;
+
+    ColumnWorkspace coarse_workspace_;
+    ColumnWorkspace fine_workspace_;
+    std::size_t columns_{ 0 };
+    std::size_t ratio_refreshes_{ 0 };
+  };
+
+  /// @brief Accuracy, cost and cache use of TwoResolutionModel against the fine model
+  struct TwoResolutionReport
+  {
+    std::size_t n_fine_bins{ 0 };
+    std::size_t n_coarse_bins{ 0 };
+    std::size_t n_columns{ 0 };
+
+    /// Columns in the timed run that recomputed the fine/coarse ratios
+    std::size_t ratio_refreshes{ 0 };
+
+    /// Per-reaction error of the two-resolution J-values over all columns and levels
+    std::vector<DifferentialReactionError> reactions;
+
+    /// Wall time for all columns with each model [s]
+    double fine_seconds{ 0.0 };
+    double two_resolution_seconds{ 0.0 };
+
+    /// @brief Fine time over two-resolution time
+    double Speedup() const
+    {
+      return two_resolution_seconds > 0.0 ? fine_seconds / two_resolution_seconds : 0.0;
+    }
+
+    /// @brief Largest relative error of any reaction
+    double MaxRelativeError() const
+    {
+      double max_error = 0.0;
+      for (const auto& reaction : reactions)
+      {
+        max_error = std::max(max_error, reaction.max_relative_error);
+      }
+      return max_error;
+    }
+
+    /// @brief Grid sizes, refreshes, timings and one line per reaction
+    std::string Summary() const
+    {
+      std::ostringstream out;
+      out << n_fine_bins << " bins solved on " << n_coarse_bins << ", " << ratio_refreshes << " of " << n_columns
+          << " columns refreshed: " << fine_seconds << " s -> " << two_resolution_seconds << " s (" << Speedup()
+          << "x)\n";
+      for (const auto& reaction : reactions)
+      {
+        out << "  " << reaction.reaction_name << ": max " << reaction.max_relative_error << ", rms "
+            << reaction.rms_relative_error << " over " << reaction.n_values << " values\n";
+      }
+      return out.str();
+    }
+  };
+
+  /// @brief Compare TwoResolutionModel with the fine model over a column sequence
+  /// @param fine_model Model on the fine grid, with its radiators and reactions
+  /// @param config Two-resolution options
+  /// @param columns Columns, in the order they are calculated; the cache
+  ///        only pays off when neighbours are similar
+  /// @param relative_floor Errors are relative to at least this fraction of
+  ///        the column's largest J for the reaction
+  /// @return Errors, ratio refreshes and the wall time of each model
+  inline TwoResolutionReport EvaluateTwoResolution(
+      const TuvModel& fine_model,
+      const TwoResolutionConfig& config,
+      const std::vector<ColumnState>& columns,
+      double relative_floor = 1.0e-3)
+  {
+    TuvModel fine(fine_model);
+    fine.PrepareComponents();
+    TwoResolutionModel two_resolution(fine_model, config);
+
+    TwoResolutionReport report;
+    report.n_fine_bins = fine.WavelengthGrid().Spec().n_cells;
+    report.n_coarse_bins = two_resolution.NumberOfCoarseBins();
+    report.n_columns = columns.size();
+
+    std::vector<double> fine_rates;
+    std::vector<double> two_resolution_rates;
+    report.fine_seconds = detail::TimeBulkColumns(fine, columns, fine_rates);
+
+    // Count only the timed run's refreshes: the warm-up column computes the first ratios
+    std::size_t n_levels = fine.AltitudeGrid().Spec().n_cells + 1;
+    if (!columns.empty())
+    {
+      two_resolution_rates.resize(fine.PhotolysisReactions().Size() * n_levels);
+      two_resolution.CalculatePhotolysisRates(
+          columns[0].View(), two_resolution_rates.data(), static_cast<std::ptrdiff_t>(n_levels), 1);
+    }
+    std::size_t warm_up_refreshes = two_resolution.RatioRefreshes();
+    report.two_resolution_seconds = detail::TimeBulkColumns(two_resolution, columns, two_resolution_rates);
+    report.ratio_refreshes = two_resolution.RatioRefreshes() - warm_up_refreshes;
+    report.reactions = detail::CompareBulkRates(
+        fine.PhotolysisReactions().ReactionNames(),
+        fine_rates,
+        two_resolution_rates,
+        columns.size(),
+        n_levels,
+        relative_floor);
+    return report;
+  }
+
+}  // namespace tuvx
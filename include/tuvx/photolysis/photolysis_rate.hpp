@@ -1,5 +1,9 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -7,6 +11,9 @@
 #include <tuvx/grid/grid.hpp>
 #include <tuvx/quantum_yield/quantum_yield.hpp>
 #include <tuvx/radiation_field/radiation_field.hpp>
+#include <tuvx/util/reproducible_sum.hpp>
+#include <tuvx/util/strided_view.hpp>
+#include <tuvx/util/thread_pool.hpp>
 
 namespace tuvx
 {
@@ -76,53 +83,97 @@ namespace tuvx
         const std::vector<double>& temperature_profile = {}) const
     {
       Result result;
-      result.reaction_name = reaction_name_;
+      Calculate(radiation_field, wavelength_grid, temperature_profile, result);
+      return result;
+    }
 
-      if (radiation_field.Empty() || !cross_section_ || !quantum_yield_)
+    /// @brief Calculate photolysis rates into an existing result
+    /// @param radiation_field Computed actinic flux at all levels
+    /// @param wavelength_grid Wavelength grid
+    /// @param temperature_profile Temperature at each layer (for T-dependent xs/qy)
+    /// @param result Result to overwrite; the name is only written if it differs
+    ///               and the rate storage is reused
+    void Calculate(
+        const RadiationField& radiation_field,
+        const Grid& wavelength_grid,
+        const std::vector<double>& temperature_profile,
+        Result& result) const
+    {
+      if (result.reaction_name != reaction_name_)
       {
-        return result;
+        result.reaction_name = reaction_name_;
       }
 
-      std::size_t n_levels = radiation_field.NumberOfLevels();
-      std::size_t n_wavelengths = radiation_field.NumberOfWavelengths();
+      if (radiation_field.Empty() || !cross_section_ || !quantum_yield_)
+      {
+        result.rates.clear();
+        return;
+      }
 
-      result.rates.resize(n_levels, 0.0);
+      result.rates.assign(radiation_field.NumberOfLevels(), 0.0);
+      CalculateInto(
+          radiation_field, wavelength_grid, temperature_profile, StridedView<double>(result.rates.data(), result.rates.size()));
+    }
 
-      // Get wavelength bin widths for integration
-      auto deltas = wavelength_grid.Deltas();
+    /// @brief Calculate photolysis rates into caller-owned memory
+    /// @param radiation_field Computed actinic flux at all levels
+    /// @param wavelength_grid Wavelength grid
+    /// @param temperature_profile Temperature at each layer (for T-dependent xs/qy)
+    /// @param rates Destination for the rate at each level [s^-1] (n_levels elements)
+    ///
+    /// Rates are written straight into the destination view, which lets
+    /// bulk callers fill a host-owned array without an intermediate Result.
+    /// A reaction missing its cross-section or quantum yield writes zeros.
+    void CalculateInto(
+        const RadiationField& radiation_field,
+        const Grid& wavelength_grid,
+        const std::vector<double>& temperature_profile,
+        StridedView<double> rates) const
+    {
+      if (radiation_field.Empty())
+      {
+        return;
+      }
 
-      // Calculate at each level
+      std::size_t n_levels = std::min(radiation_field.NumberOfLevels(), rates.Size());
       for (std::size_t level = 0; level < n_levels; ++level)
       {
-        // Get temperature for this level (use layer below or default)
-        double temperature = 298.0;  // Default
-        if (!temperature_profile.empty())
-        {
-          std::size_t layer = (level > 0) ? level - 1 : 0;
-          if (layer < temperature_profile.size())
-          {
-            temperature = temperature_profile[layer];
-          }
-        }
-
-        // Get cross-section and quantum yield at this temperature
-        auto xs_values = cross_section_->Calculate(wavelength_grid, temperature);
-        auto qy_values = quantum_yield_->Calculate(wavelength_grid, temperature);
+        rates[level] = CalculateLevel(radiation_field, wavelength_grid, temperature_profile, level);
+      }
+    }
 
-        // Get total actinic flux at this level
-        auto actinic_flux = radiation_field.TotalActinicFlux(level);
+    /// @brief Calculate the photolysis rate at one level of a radiation field
+    /// @param radiation_field Computed actinic flux at all levels
+    /// @param wavelength_grid Wavelength grid
+    /// @param temperature_profile Temperature at each layer (for T-dependent xs/qy)
+    /// @param level Altitude level index
+    /// @return Photolysis rate [s^-1]
+    ///
+    /// Levels are independent, so callers may evaluate them concurrently.
+    double CalculateLevel(
+        const RadiationField& radiation_field,
+        const Grid& wavelength_grid,
+        const std::vector<double>& temperature_profile,
+        std::size_t level) const
+    {
+      if (radiation_field.Empty() || !cross_section_ || !quantum_yield_)
+      {
+        return 0.0;
+      }
 
-        // Integrate: J = ∫ F(λ) × σ(λ) × φ(λ) dλ
-        double j_value = 0.0;
-        for (std::size_t j = 0; j < n_wavelengths; ++j)
+      // Get temperature for this level (use layer below or default)
+      double temperature = 298.0;  // Default
+      if (!temperature_profile.empty())
+      {
+        std::size_t layer = (level > 0) ? level - 1 : 0;
+        if (layer < temperature_profile.size())
         {
-          j_value += actinic_flux[j] * xs_values[j] * qy_values[j] * std::abs(deltas[j]);
+          temperature = temperature_profile[layer];
         }
-
-        result.rates[level] = j_value;
       }
 
-      return result;
+      // Get total actinic flux at this level
+      return CalculateAtLevel(radiation_field.TotalActinicFlux(level), wavelength_grid, temperature);
     }
 
     /// @brief Calculate photolysis rate at a single level
@@ -142,17 +193,39 @@ namespace tuvx
 
       auto xs_values = cross_section_->Calculate(wavelength_grid, temperature);
       auto qy_values = quantum_yield_->Calculate(wavelength_grid, temperature);
-      auto deltas = wavelength_grid.Deltas();
+      return Integrate(actinic_flux, xs_values, qy_values, wavelength_grid.Deltas());
+    }
 
-      double j_value = 0.0;
-      std::size_t n = std::min({ actinic_flux.size(), xs_values.size(), qy_values.size() });
+    /// @brief Integrate a photolysis rate from spectra already on the wavelength grid
+    /// @param actinic_flux Total actinic flux [photons/cm^2/s/nm]
+    /// @param cross_section Cross-section values [cm^2]
+    /// @param quantum_yield Quantum yield values
+    /// @param deltas Wavelength bin widths [nm]
+    /// @return Photolysis rate [s^-1]
+    ///
+    /// J = ∫ F(λ) × σ(λ) × φ(λ) dλ over the common length of the spectra,
+    /// in a fixed summation order.
+    static double Integrate(
+        std::span<const double> actinic_flux,
+        std::span<const double> cross_section,
+        std::span<const double> quantum_yield,
+        std::span<const double> deltas)
+    {
+      std::size_t n = std::min({ actinic_flux.size(), cross_section.size(), quantum_yield.size() });
+      return ReproducibleSum(
+          n, [&](std::size_t j) { return actinic_flux[j] * cross_section[j] * quantum_yield[j] * std::abs(deltas[j]); });
+    }
 
-      for (std::size_t j = 0; j < n; ++j)
-      {
-        j_value += actinic_flux[j] * xs_values[j] * qy_values[j] * std::abs(deltas[j]);
-      }
+    /// @brief Get the cross-section (may be null)
+    const CrossSection* GetCrossSection() const
+    {
+      return cross_section_;
+    }
 
-      return j_value;
+    /// @brief Get the quantum yield (may be null)
+    const QuantumYield* GetQuantumYield() const
+    {
+      return quantum_yield_;
     }
 
    private:
@@ -195,6 +268,115 @@ namespace tuvx
       return results;
     }
 
+    /// @brief Calculate all photolysis rates into existing results
+    /// @param radiation_field Computed actinic flux
+    /// @param wavelength_grid Wavelength grid
+    /// @param temperature_profile Temperature profile
+    /// @param results Resized to one result per reaction; reaction names and
+    ///                rate storage from a previous call are reused
+    void CalculateAll(
+        const RadiationField& radiation_field,
+        const Grid& wavelength_grid,
+        const std::vector<double>& temperature_profile,
+        std::vector<PhotolysisRateCalculator::Result>& results) const
+    {
+      results.resize(calculators_.size());
+      for (std::size_t r = 0; r < calculators_.size(); ++r)
+      {
+        calculators_[r].Calculate(radiation_field, wavelength_grid, temperature_profile, results[r]);
+      }
+    }
+
+    /// @brief Calculate all photolysis rates into caller-owned memory
+    /// @param radiation_field Computed actinic flux
+    /// @param wavelength_grid Wavelength grid
+    /// @param temperature_profile Temperature profile
+    /// @param rates Destination array; J for reaction r at level l is written to
+    ///              rates[r * reaction_stride + l * level_stride]
+    /// @param reaction_stride Distance between reactions [elements]
+    /// @param level_stride Distance between levels [elements]
+    void CalculateAll(
+        const RadiationField& radiation_field,
+        const Grid& wavelength_grid,
+        const std::vector<double>& temperature_profile,
+        double* rates,
+        std::ptrdiff_t reaction_stride,
+        std::ptrdiff_t level_stride) const
+    {
+      std::size_t n_levels = radiation_field.NumberOfLevels();
+      for (std::size_t r = 0; r < calculators_.size(); ++r)
+      {
+        StridedView<double> reaction_rates(rates + static_cast<std::ptrdiff_t>(r) * reaction_stride, n_levels, level_stride);
+        calculators_[r].CalculateInto(radiation_field, wavelength_grid, temperature_profile, reaction_rates);
+      }
+    }
+
+    /// @brief Calculate all photolysis rates on a thread pool
+    /// @param radiation_field Computed actinic flux
+    /// @param wavelength_grid Wavelength grid
+    /// @param temperature_profile Temperature profile
+    /// @param pool Thread pool; every (reaction, level) pair is an independent work item
+    /// @return Vector of results for each reaction, bit-identical to the serial overload
+    std::vector<PhotolysisRateCalculator::Result> CalculateAll(
+        const RadiationField& radiation_field,
+        const Grid& wavelength_grid,
+        const std::vector<double>& temperature_profile,
+        ThreadPool& pool) const
+    {
+      std::vector<PhotolysisRateCalculator::Result> results(calculators_.size());
+      std::size_t n_levels = radiation_field.Empty() ? 0 : radiation_field.NumberOfLevels();
+      for (std::size_t r = 0; r < calculators_.size(); ++r)
+      {
+        results[r].reaction_name = calculators_[r].ReactionName();
+        results[r].rates.assign(n_levels, 0.0);
+      }
+      if (n_levels > 0)
+      {
+        CalculateAll(radiation_field, wavelength_grid, temperature_profile, pool, [&](std::size_t r, std::size_t level) -> double& {
+          return results[r].rates[level];
+        });
+      }
+      return results;
+    }
+
+    /// @brief Calculate all photolysis rates into caller-owned memory on a thread pool
+    /// @param radiation_field Computed actinic flux
+    /// @param wavelength_grid Wavelength grid
+    /// @param temperature_profile Temperature profile
+    /// @param rates Destination array (see the serial overload for the layout)
+    /// @param reaction_stride Distance between reactions [elements]
+    /// @param level_stride Distance between levels [elements]
+    /// @param pool Thread pool; every (reaction, level) pair is an independent work item
+    void CalculateAll(
+        const RadiationField& radiation_field,
+        const Grid& wavelength_grid,
+        const std::vector<double>& temperature_profile,
+        double* rates,
+        std::ptrdiff_t reaction_stride,
+        std::ptrdiff_t level_stride,
+        ThreadPool& pool) const
+    {
+      CalculateAll(radiation_field, wavelength_grid, temperature_profile, pool, [&](std::size_t r, std::size_t level) -> double& {
+        return rates[static_cast<std::ptrdiff_t>(r) * reaction_stride + static_cast<std::ptrdiff_t>(level) * level_stride];
+      });
+    }
+
+    /// @brief Replace a reaction's cross-section and quantum yield
+    /// @param index Reaction index, in the order reactions were added
+    /// @param cross_section New cross-section (must remain valid)
+    /// @param quantum_yield New quantum yield (must remain valid)
+    void SetSpectra(std::size_t index, const CrossSection* cross_section, const QuantumYield* quantum_yield)
+    {
+      calculators_[index] = PhotolysisRateCalculator(calculators_[index].ReactionName(), cross_section, quantum_yield);
+    }
+
+    /// @brief Get a reaction's calculator
+    /// @param index Reaction index, in the order reactions were added
+    const PhotolysisRateCalculator& Get(std::size_t index) const
+    {
+      return calculators_[index];
+    }
+
     /// @brief Get number of reactions
     std::size_t Size() const
     {
@@ -220,6 +402,30 @@ namespace tuvx
     }
 
    private:
+    /// @brief Evaluate every (reaction, level) pair on a pool, storing J through a destination accessor
+    template<typename Destination>
+    void CalculateAll(
+        const RadiationField& radiation_field,
+        const Grid& wavelength_grid,
+        const std::vector<double>& temperature_profile,
+        ThreadPool& pool,
+        Destination&& destination) const
+    {
+      if (radiation_field.Empty())
+      {
+        return;
+      }
+      std::size_t n_levels = radiation_field.NumberOfLevels();
+      pool.ParallelFor(
+          calculators_.size() * n_levels,
+          [&](std::size_t item)
+          {
+            std::size_t r = item / n_levels;
+            std::size_t level = item % n_levels;
+            destination(r, level) = calculators_[r].CalculateLevel(radiation_field, wavelength_grid, temperature_profile, level);
+          });
+    }
+
     std::vector<PhotolysisRateCalculator> calculators_;
   };
 
@@ -197,6 +197,24 @@ namespace tuvx
       }
     }
 
+    /// @brief Overwrite the midpoint values, reusing the profile's storage
+    /// @param mid_values New values at cell midpoints (n_cells elements)
+    /// @throws TuvxInternalException if mid_values.size() != n_cells
+    ///
+    /// Recomputes the edge values and discards layer and burden densities,
+    /// which must be recalculated for the new values.
+    void SetMidValues(std::span<const double> mid_values)
+    {
+      if (mid_values.size() != spec_.n_cells)
+      {
+        TUVX_INTERNAL_ERROR("Profile mid_values size must equal n_cells");
+      }
+      mid_values_.assign(mid_values.begin(), mid_values.end());
+      ComputeEdgeValuesFromMidpoints();
+      layer_dens_.clear();
+      burden_dens_.clear();
+    }
+
     /// @brief Calculate extrapolated value above the grid
     /// @param altitude Altitude above the top of the grid (same units as grid)
     /// @param grid_top_altitude Top altitude of the grid
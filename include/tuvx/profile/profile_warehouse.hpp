@@ -1,8 +1,11 @@
 #pragma once
 
 #include <cstddef>
+#include <span>
 #include <string>
+#include <system_error>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <tuvx/profile/profile.hpp>
@@ -90,6 +93,42 @@ namespace tuvx
       return ProfileHandle(index);
     }
 
+    /// @brief Replace the values of a stored profile
+    /// @param handle Profile handle from Add()
+    /// @param profile New profile with the same name and units
+    /// @throws TuvxInternalException if the handle is invalid or the name/units differ
+    ///
+    /// Keeps handles and name lookups valid, so a warehouse can be built once
+    /// and refilled for each new atmospheric state.
+    void Replace(ProfileHandle handle, Profile profile)
+    {
+      if (!handle.IsValid() || handle.Index() >= profiles_.size())
+      {
+        TUVX_INTERNAL_ERROR("Invalid profile handle");
+      }
+      if (profile.Name() != profiles_[handle.Index()].Name() || profile.Units() != profiles_[handle.Index()].Units())
+      {
+        TUVX_INTERNAL_ERROR("Replacement profile name or units differ");
+      }
+      profiles_[handle.Index()] = std::move(profile);
+    }
+
+    /// @brief Overwrite the midpoint values of a stored profile in place
+    /// @param handle Profile handle from Add()
+    /// @param mid_values New values at cell midpoints
+    /// @throws TuvxInternalException if the handle is invalid or the size differs
+    ///
+    /// Unlike Replace(), reuses the profile's storage, so refilling a
+    /// warehouse for each column does not allocate.
+    void Update(ProfileHandle handle, std::span<const double> mid_values)
+    {
+      if (!handle.IsValid() || handle.Index() >= profiles_.size())
+      {
+        TUVX_INTERNAL_ERROR("Invalid profile handle");
+      }
+      profiles_[handle.Index()].SetMidValues(mid_values);
+    }
+
     /// @brief Check if a profile exists in the warehouse
     /// @param name Profile name
     /// @param units Profile units
@@ -129,6 +168,43 @@ namespace tuvx
       return profiles_[handle.Index()];
     }
 
+    /// @brief Look up a profile by name and units without throwing
+    /// @param name Profile name
+    /// @param units Profile units
+    /// @param profile Set to the profile on success, nullptr otherwise
+    /// @return Empty error code on success, TuvxInternalErrc::ProfileNotFound otherwise
+    ///
+    /// Compares the stored specs instead of building a key, so the lookup
+    /// does not allocate; radiators call it on every update.
+    std::error_code TryGet(const std::string& name, const std::string& units, const Profile*& profile) const
+    {
+      profile = nullptr;
+      for (const auto& entry : profiles_)
+      {
+        if (entry.Spec().name == name && entry.Spec().units == units)
+        {
+          profile = &entry;
+          return {};
+        }
+      }
+      return TuvxInternalErrc::ProfileNotFound;
+    }
+
+    /// @brief Look up a profile by handle without throwing
+    /// @param handle Profile handle from Add()
+    /// @param profile Set to the profile on success, nullptr otherwise
+    /// @return Empty error code on success, TuvxInternalErrc::InvalidHandle otherwise
+    std::error_code TryGet(ProfileHandle handle, const Profile*& profile) const noexcept
+    {
+      if (!handle.IsValid() || handle.Index() >= profiles_.size())
+      {
+        profile = nullptr;
+        return TuvxInternalErrc::InvalidHandle;
+      }
+      profile = &profiles_[handle.Index()];
+      return {};
+    }
+
     /// @brief Get a handle for a profile by name and units
     /// @param name Profile name
     /// @param units Profile units
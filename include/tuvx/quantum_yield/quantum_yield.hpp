@@ -1,6 +1,8 @@
 #pragma once
 
+#include <algorithm>
 #include <memory>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -47,6 +49,21 @@ namespace tuvx
     virtual std::vector<double>
     Calculate(const Grid& wavelength_grid, double temperature, double air_density = 0.0) const = 0;
 
+    /// @brief Calculate quantum yield values into caller-owned memory
+    /// @param wavelength_grid Wavelength grid (midpoints used) [nm]
+    /// @param temperature Temperature [K]
+    /// @param air_density Air number density [molecules/cm^3]
+    /// @param result Destination for wavelength_grid.Spec().n_cells values
+    ///
+    /// The default implementation copies the result of Calculate(); tabulated
+    /// types override it to write in place without allocating.
+    virtual void
+    CalculateInto(const Grid& wavelength_grid, double temperature, double air_density, std::span<double> result) const
+    {
+      auto values = Calculate(wavelength_grid, temperature, air_density);
+      std::copy_n(values.begin(), std::min(values.size(), result.size()), result.begin());
+    }
+
     /// @brief Calculate quantum yield profile (altitude-dependent)
     /// @param wavelength_grid Wavelength grid
     /// @param altitude_grid Altitude grid
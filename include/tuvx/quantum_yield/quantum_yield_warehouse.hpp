@@ -7,6 +7,7 @@
 #include <vector>
 
 #include <tuvx/quantum_yield/quantum_yield.hpp>
+#include <tuvx/util/internal_error.hpp>
 
 namespace tuvx
 {
@@ -69,13 +70,13 @@ namespace tuvx
     {
       if (!quantum_yield)
       {
-        throw std::runtime_error("Cannot add null quantum yield to warehouse");
+        TUVX_THROW(std::runtime_error("Cannot add null quantum yield to warehouse"));
       }
 
       const std::string& name = quantum_yield->Name();
       if (name_to_index_.count(name) > 0)
       {
-        throw std::runtime_error("Quantum yield '" + name + "' already exists in warehouse");
+        TUVX_THROW(std::runtime_error("Quantum yield '" + name + "' already exists in warehouse"));
       }
 
       std::size_t index = quantum_yields_.size();
@@ -94,7 +95,7 @@ namespace tuvx
       auto it = name_to_index_.find(name);
       if (it == name_to_index_.end())
       {
-        throw std::out_of_range("Quantum yield '" + name + "' not found in warehouse");
+        TUVX_THROW(std::out_of_range("Quantum yield '" + name + "' not found in warehouse"));
       }
       return *quantum_yields_[it->second];
     }
@@ -107,7 +108,7 @@ namespace tuvx
     {
       if (!handle.IsValid() || handle.Index() >= quantum_yields_.size())
       {
-        throw std::out_of_range("Invalid quantum yield handle");
+        TUVX_THROW(std::out_of_range("Invalid quantum yield handle"));
       }
       return *quantum_yields_[handle.Index()];
     }
@@ -121,7 +122,7 @@ namespace tuvx
       auto it = name_to_index_.find(name);
       if (it == name_to_index_.end())
       {
-        throw std::out_of_range("Quantum yield '" + name + "' not found in warehouse");
+        TUVX_THROW(std::out_of_range("Quantum yield '" + name + "' not found in warehouse"));
       }
       return QuantumYieldHandle(it->second);
     }
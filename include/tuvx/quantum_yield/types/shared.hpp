@@ -0,0 +1,110 @@
+#pragma once
+
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <tuvx/cross_section/types/shared.hpp>
+#include <tuvx/grid/grid.hpp>
+#include <tuvx/quantum_yield/quantum_yield.hpp>
+#include <tuvx/util/internal_error.hpp>
+#include <tuvx/util/shared_table.hpp>
+
+namespace tuvx
+{
+  /// @brief Quantum yield whose data lives in a SharedTableSegment
+  ///
+  /// Same table layout and interpolation as SharedCrossSection
+  /// ("<key>/wavelengths", "<key>/temperatures", "<key>/values"). Air-density
+  /// dependence is not tabulated: the values are those the source quantum
+  /// yield gave at the air density passed to BinQuantumYield.
+  class SharedQuantumYield : public QuantumYield
+  {
+   public:
+    /// @brief Reference a quantum yield in a shared segment
+    /// @param segment Segment holding the tables
+    /// @param key Table key prefix; also used as the quantum yield name
+    /// @param reactant Parent molecule
+    /// @param products Product description
+    /// @throws std::out_of_range if any of the tables is missing
+    /// @throws std::invalid_argument if the table shapes do not match
+    SharedQuantumYield(
+        std::shared_ptr<const SharedTableSegment> segment,
+        const std::string& key,
+        std::string reactant = "",
+        std::string products = "")
+        : segment_(std::move(segment)),
+          wavelengths_(segment_->Get(key + "/wavelengths")),
+          temperatures_(segment_->Get(key + "/temperatures")),
+          values_(segment_->Get(key + "/values"))
+    {
+      name_ = key;
+      reactant_ = std::move(reactant);
+      products_ = std::move(products);
+      if (values_.rows != temperatures_.cols || values_.cols != wavelengths_.cols || wavelengths_.cols == 0)
+      {
+        TUVX_THROW(std::invalid_argument("Shared quantum yield '" + key + "' has inconsistent table shapes"));
+      }
+    }
+
+    /// @brief Clone this quantum yield (shares the segment)
+    std::unique_ptr<QuantumYield> Clone() const override
+    {
+      return std::make_unique<SharedQuantumYield>(*this);
+    }
+
+    /// @brief Calculate quantum yield values on wavelength grid
+    std::vector<double>
+    Calculate(const Grid& wavelength_grid, double temperature, double /*air_density*/ = 0.0) const override
+    {
+      std::vector<double> result(wavelength_grid.Spec().n_cells);
+      CalculateInto(wavelength_grid, temperature, 0.0, result);
+      return result;
+    }
+
+    /// @brief Interpolate the shared table straight into caller-owned memory, without allocating
+    void CalculateInto(const Grid& wavelength_grid, double temperature, double /*air_density*/, std::span<double> result)
+        const override
+    {
+      detail::InterpolateTable(wavelength_grid, temperature, wavelengths_.Values(), temperatures_.Values(), values_, result);
+    }
+
+   private:
+    std::shared_ptr<const SharedTableSegment> segment_;
+    SharedTable wavelengths_;
+    SharedTable temperatures_;
+    SharedTable values_;
+  };
+
+  /// @brief Bin a quantum yield onto a wavelength grid and add it to a shared-table builder
+  /// @param builder Builder to add the "<key>/..." tables to
+  /// @param key Table key prefix
+  /// @param quantum_yield Quantum yield to evaluate
+  /// @param wavelength_grid Grid whose midpoints become the table wavelengths
+  /// @param temperatures Temperatures to evaluate at [K], ascending
+  /// @param air_density Air density to evaluate at [molecules/cm^3]
+  inline void BinQuantumYield(
+      SharedTableBuilder& builder,
+      const std::string& key,
+      const QuantumYield& quantum_yield,
+      const Grid& wavelength_grid,
+      const std::vector<double>& temperatures,
+      double air_density = 0.0)
+  {
+    auto midpoints = wavelength_grid.Midpoints();
+    std::vector<double> values;
+    values.reserve(temperatures.size() * midpoints.size());
+    for (double temperature : temperatures)
+    {
+      auto row = quantum_yield.Calculate(wavelength_grid, temperature, air_density);
+      values.insert(values.end(), row.begin(), row.end());
+    }
+    builder.Add(key + "/wavelengths", midpoints);
+    builder.Add(key + "/temperatures", temperatures);
+    builder.Add(key + "/values", temperatures.size(), midpoints.size(), values);
+  }
+
+}  // namespace tuvx
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstddef>
+#include <initializer_list>
 #include <vector>
 
 namespace tuvx
@@ -55,13 +56,19 @@ namespace tuvx
     /// @brief Initialize field with zeros for given dimensions
     /// @param n_levels Number of altitude levels (n_layers + 1)
     /// @param n_wavelengths Number of wavelength bins
+    ///
+    /// Existing storage is reused, so re-initializing a field of the same
+    /// shape does not allocate.
     void Initialize(std::size_t n_levels, std::size_t n_wavelengths)
     {
-      direct_irradiance.assign(n_levels, std::vector<double>(n_wavelengths, 0.0));
-      diffuse_up.assign(n_levels, std::vector<double>(n_wavelengths, 0.0));
-      diffuse_down.assign(n_levels, std::vector<double>(n_wavelengths, 0.0));
-      actinic_flux_direct.assign(n_levels, std::vector<double>(n_wavelengths, 0.0));
-      actinic_flux_diffuse.assign(n_levels, std::vector<double>(n_wavelengths, 0.0));
+      for (auto* component : { &direct_irradiance, &diffuse_up, &diffuse_down, &actinic_flux_direct, &actinic_flux_diffuse })
+      {
+        component->resize(n_levels);
+        for (auto& level : *component)
+        {
+          level.assign(n_wavelengths, 0.0);
+        }
+      }
     }
 
     /// @brief Get number of levels
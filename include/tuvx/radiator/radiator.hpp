@@ -2,10 +2,12 @@
 
 #include <memory>
 #include <string>
+#include <system_error>
 
 #include <tuvx/grid/grid_warehouse.hpp>
 #include <tuvx/profile/profile_warehouse.hpp>
 #include <tuvx/radiator/radiator_state.hpp>
+#include <tuvx/util/internal_error.hpp>
 
 namespace tuvx
 {
@@ -64,8 +66,51 @@ namespace tuvx
     }
 
    protected:
+    /// @brief Look up a grid this radiator needs
+    /// @param grids Available grids
+    /// @param name Grid name
+    /// @param units Grid units
+    /// @return The grid
+    /// @throws TuvxInternalException with TuvxInternalErrc::GridNotFound, naming the radiator, if it is missing
+    const Grid& RequireGrid(const GridWarehouse& grids, const std::string& name, const std::string& units) const
+    {
+      const Grid* grid = nullptr;
+      if (std::error_code error = grids.TryGet(name, units, grid))
+      {
+        ReportMissingInput(error, "grid", name, units);
+      }
+      return *grid;
+    }
+
+    /// @brief Look up a profile this radiator needs
+    /// @param profiles Available profiles
+    /// @param name Profile name
+    /// @param units Profile units
+    /// @return The profile
+    /// @throws TuvxInternalException with TuvxInternalErrc::ProfileNotFound, naming the radiator, if it is missing
+    const Profile& RequireProfile(const ProfileWarehouse& profiles, const std::string& name, const std::string& units) const
+    {
+      const Profile* profile = nullptr;
+      if (std::error_code error = profiles.TryGet(name, units, profile))
+      {
+        ReportMissingInput(error, "profile", name, units);
+      }
+      return *profile;
+    }
+
     std::string name_{};
     RadiatorState state_{};
+
+   private:
+    [[noreturn]] void ReportMissingInput(
+        std::error_code error,
+        const char* kind,
+        const std::string& name,
+        const std::string& units) const
+    {
+      std::string message = "Radiator '" + name_ + "' needs " + kind + " '" + name + "' [" + units + "]";
+      ThrowInternalError(static_cast<TuvxInternalErrc>(error.value()), __FILE__, __LINE__, message.c_str());
+    }
   };
 
 }  // namespace tuvx
@@ -1,9 +1,15 @@
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
 #include <stdexcept>
+#include <system_error>
 #include <vector>
 
+#include <tuvx/util/internal_error.hpp>
+#include <tuvx/util/reproducible_sum.hpp>
+#include <tuvx/util/thread_pool.hpp>
+
 namespace tuvx
 {
   /// @brief Optical properties state for a radiator on a grid
@@ -47,11 +53,19 @@ namespace tuvx
     /// @brief Initialize state with zeros for given dimensions
     /// @param n_layers Number of altitude layers
     /// @param n_wavelengths Number of wavelength bins
+    ///
+    /// Existing storage is reused, so re-initializing a state of the same
+    /// shape does not allocate.
     void Initialize(std::size_t n_layers, std::size_t n_wavelengths)
     {
-      optical_depth.assign(n_layers, std::vector<double>(n_wavelengths, 0.0));
-      single_scattering_albedo.assign(n_layers, std::vector<double>(n_wavelengths, 0.0));
-      asymmetry_factor.assign(n_layers, std::vector<double>(n_wavelengths, 0.0));
+      for (auto* component : { &optical_depth, &single_scattering_albedo, &asymmetry_factor })
+      {
+        component->resize(n_layers);
+        for (auto& layer : *component)
+        {
+          layer.assign(n_wavelengths, 0.0);
+        }
+      }
     }
 
     /// @brief Get the number of layers
@@ -86,16 +100,29 @@ namespace tuvx
     /// @param other The state to accumulate
     /// @throws std::runtime_error if dimensions don't match
     void Accumulate(const RadiatorState& other)
+    {
+      if (TryAccumulate(other))
+      {
+        TUVX_THROW(std::runtime_error("Cannot accumulate RadiatorState with different dimensions"));
+      }
+    }
+
+    /// @brief Accumulate another radiator's state into this one without throwing
+    /// @param other The state to accumulate
+    /// @return Empty error code on success, TuvxInternalErrc::InvalidSize if dimensions don't match
+    ///
+    /// Leaves this state unchanged on error.
+    std::error_code TryAccumulate(const RadiatorState& other)
     {
       if (other.Empty())
       {
-        return;
+        return {};
       }
 
       if (Empty())
       {
         *this = other;
-        return;
+        return {};
       }
 
       std::size_t n_layers = NumberOfLayers();
@@ -103,7 +130,7 @@ namespace tuvx
 
       if (other.NumberOfLayers() != n_layers || other.NumberOfWavelengths() != n_wavelengths)
       {
-        throw std::runtime_error("Cannot accumulate RadiatorState with different dimensions");
+        return TuvxInternalErrc::InvalidSize;
       }
 
       for (std::size_t i = 0; i < n_layers; ++i)
@@ -144,6 +171,8 @@ namespace tuvx
           asymmetry_factor[i][j] = g_total;
         }
       }
+
+      return {};
     }
 
     /// @brief Scale all optical depths by a factor
@@ -171,15 +200,149 @@ namespace tuvx
       std::size_t n_wavelengths = NumberOfWavelengths();
       std::vector<double> total(n_wavelengths, 0.0);
 
-      for (const auto& layer : optical_depth)
+      for (std::size_t j = 0; j < n_wavelengths; ++j)
       {
-        for (std::size_t j = 0; j < n_wavelengths; ++j)
+        total[j] = ReproducibleSum(optical_depth.size(), [&](std::size_t i) { return optical_depth[i][j]; });
+      }
+
+      return total;
+    }
+
+    /// @brief Combine the states of several radiators in one pass
+    /// @param states States to combine, in a fixed (radiator) order; empty states are skipped
+    /// @return Combined state
+    /// @throws std::runtime_error if dimensions don't match
+    ///
+    /// Equivalent to accumulating the states one after another, but the
+    /// sums of τ, τω and τωg over radiators are each formed with
+    /// ReproducibleSum and the weighted averages are taken once at the end,
+    /// so the result does not depend on how the work is partitioned.
+    static RadiatorState Combine(const std::vector<const RadiatorState*>& states)
+    {
+      ThreadPool* no_pool = nullptr;
+      return Combine(states, no_pool);
+    }
+
+    /// @brief Combine the states of several radiators, splitting layers across a thread pool
+    /// @param states States to combine, in a fixed (radiator) order; empty states are skipped
+    /// @param pool Thread pool; the result is bit-identical to the serial overload
+    static RadiatorState Combine(const std::vector<const RadiatorState*>& states, ThreadPool& pool)
+    {
+      return Combine(states, &pool);
+    }
+
+    /// @brief Combine the states of several radiators into an existing state
+    /// @param states States to combine, in a fixed (radiator) order; empty states are skipped
+    /// @param combined Destination; its storage is reused when the dimensions already match
+    /// @param pool Optional thread pool; the result does not depend on it
+    /// @throws std::runtime_error if dimensions don't match
+    ///
+    /// Gives the same values as Combine() without allocating once the
+    /// destination has the right shape, provided no state is empty.
+    static void
+    CombineInto(const std::vector<const RadiatorState*>& states, RadiatorState& combined, ThreadPool* pool = nullptr)
+    {
+      bool all_active =
+          std::all_of(states.begin(), states.end(), [](const RadiatorState* state) { return state && !state->Empty(); });
+      if (all_active)
+      {
+        CombineActive(states, combined, pool);
+        return;
+      }
+      std::vector<const RadiatorState*> active;
+      active.reserve(states.size());
+      for (const auto* state : states)
+      {
+        if (state != nullptr && !state->Empty())
         {
-          total[j] += layer[j];
+          active.push_back(state);
         }
       }
+      CombineActive(active, combined, pool);
+    }
 
-      return total;
+   private:
+    static RadiatorState Combine(const std::vector<const RadiatorState*>& states, ThreadPool* pool)
+    {
+      RadiatorState combined;
+      CombineInto(states, combined, pool);
+      return combined;
+    }
+
+    /// @brief Resize every table to n_layers x n_wavelengths, keeping storage that already fits
+    void Resize(std::size_t n_layers, std::size_t n_wavelengths)
+    {
+      for (auto* table : { &optical_depth, &single_scattering_albedo, &asymmetry_factor })
+      {
+        table->resize(n_layers);
+        for (auto& row : *table)
+        {
+          row.resize(n_wavelengths);
+        }
+      }
+    }
+
+    /// @brief Combine non-empty states into an existing state
+    static void CombineActive(const std::vector<const RadiatorState*>& active, RadiatorState& combined, ThreadPool* pool)
+    {
+      if (active.empty())
+      {
+        combined.optical_depth.clear();
+        combined.single_scattering_albedo.clear();
+        combined.asymmetry_factor.clear();
+        return;
+      }
+      if (active.size() == 1)
+      {
+        combined = *active[0];
+        return;
+      }
+
+      std::size_t n_layers = active[0]->NumberOfLayers();
+      std::size_t n_wavelengths = active[0]->NumberOfWavelengths();
+      for (const auto* state : active)
+      {
+        if (state->NumberOfLayers() != n_layers || state->NumberOfWavelengths() != n_wavelengths)
+        {
+          TUVX_THROW(std::runtime_error("Cannot accumulate RadiatorState with different dimensions"));
+        }
+      }
+      combined.Resize(n_layers, n_wavelengths);
+
+      auto combine_layer = [&](std::size_t i)
+      {
+        for (std::size_t j = 0; j < n_wavelengths; ++j)
+        {
+          double tau_total =
+              ReproducibleSum(active.size(), [&](std::size_t k) { return active[k]->optical_depth[i][j]; });
+          double scatter_tau_total = ReproducibleSum(
+              active.size(),
+              [&](std::size_t k) { return active[k]->optical_depth[i][j] * active[k]->single_scattering_albedo[i][j]; });
+          double scatter_g_total = ReproducibleSum(
+              active.size(),
+              [&](std::size_t k)
+              {
+                return active[k]->optical_depth[i][j] * active[k]->single_scattering_albedo[i][j] *
+                       active[k]->asymmetry_factor[i][j];
+              });
+
+          combined.optical_depth[i][j] = tau_total;
+          combined.single_scattering_albedo[i][j] = tau_total > 0.0 ? scatter_tau_total / tau_total : 0.0;
+          combined.asymmetry_factor[i][j] = scatter_tau_total > 0.0 ? scatter_g_total / scatter_tau_total : 0.0;
+        }
+      };
+
+      if (pool != nullptr)
+      {
+        pool->ParallelFor(n_layers, combine_layer);
+      }
+      else
+      {
+        for (std::size_t i = 0; i < n_layers; ++i)
+        {
+          combine_layer(i);
+        }
+      }
     }
   };
 
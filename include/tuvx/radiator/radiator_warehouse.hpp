@@ -8,6 +8,7 @@
 
 #include <tuvx/radiator/radiator.hpp>
 #include <tuvx/radiator/radiator_state.hpp>
+#include <tuvx/util/internal_error.hpp>
 
 namespace tuvx
 {
@@ -64,13 +65,13 @@ namespace tuvx
     {
       if (!radiator)
       {
-        throw std::runtime_error("Cannot add null radiator to warehouse");
+        TUVX_THROW(std::runtime_error("Cannot add null radiator to warehouse"));
       }
 
       const std::string& name = radiator->Name();
       if (name_to_index_.count(name) > 0)
       {
-        throw std::runtime_error("Radiator '" + name + "' already exists in warehouse");
+        TUVX_THROW(std::runtime_error("Radiator '" + name + "' already exists in warehouse"));
       }
 
       std::size_t index = radiators_.size();
@@ -86,7 +87,7 @@ namespace tuvx
       auto it = name_to_index_.find(name);
       if (it == name_to_index_.end())
       {
-        throw std::out_of_range("Radiator '" + name + "' not found in warehouse");
+        TUVX_THROW(std::out_of_range("Radiator '" + name + "' not found in warehouse"));
       }
       return *radiators_[it->second];
     }
@@ -96,7 +97,7 @@ namespace tuvx
     {
       if (!handle.IsValid() || handle.Index() >= radiators_.size())
       {
-        throw std::out_of_range("Invalid radiator handle");
+        TUVX_THROW(std::out_of_range("Invalid radiator handle"));
       }
       return *radiators_[handle.Index()];
     }
@@ -107,7 +108,7 @@ namespace tuvx
       auto it = name_to_index_.find(name);
       if (it == name_to_index_.end())
       {
-        throw std::out_of_range("Radiator '" + name + "' not found in warehouse");
+        TUVX_THROW(std::out_of_range("Radiator '" + name + "' not found in warehouse"));
       }
       return *radiators_[it->second];
     }
@@ -117,7 +118,7 @@ namespace tuvx
     {
       if (!handle.IsValid() || handle.Index() >= radiators_.size())
       {
-        throw std::out_of_range("Invalid radiator handle");
+        TUVX_THROW(std::out_of_range("Invalid radiator handle"));
       }
       return *radiators_[handle.Index()];
     }
@@ -128,7 +129,7 @@ namespace tuvx
       auto it = name_to_index_.find(name);
       if (it == name_to_index_.end())
       {
-        throw std::out_of_range("Radiator '" + name + "' not found in warehouse");
+        TUVX_THROW(std::out_of_range("Radiator '" + name + "' not found in warehouse"));
       }
       return RadiatorHandle(it->second);
     }
@@ -177,21 +178,50 @@ namespace tuvx
     /// @brief Get combined atmospheric state from all radiators
     /// @return Combined optical properties
     ///
-    /// Accumulates optical properties from all radiators following
-    /// radiative transfer combination rules.
+    /// Combines optical properties from all radiators following
+    /// radiative transfer combination rules (see RadiatorState::Combine).
     RadiatorState CombinedState() const
     {
-      RadiatorState combined;
+      return RadiatorState::Combine(ActiveStates());
+    }
+
+    /// @brief Get combined atmospheric state, splitting layers across a thread pool
+    /// @param pool Thread pool; the result is bit-identical to the serial overload
+    RadiatorState CombinedState(ThreadPool& pool) const
+    {
+      return RadiatorState::Combine(ActiveStates(), pool);
+    }
 
+    /// @brief Combine the radiators' states into an existing state
+    /// @param combined Destination; its storage is reused when the dimensions already match
+    ///
+    /// Same values as CombinedState(), without allocating once the warehouse
+    /// and the destination have been used for a grid of this size.
+    void CombineInto(RadiatorState& combined)
+    {
+      active_states_.clear();
       for (const auto& radiator : radiators_)
       {
         if (radiator->HasState())
         {
-          combined.Accumulate(radiator->State());
+          active_states_.push_back(&radiator->State());
         }
       }
+      RadiatorState::CombineInto(active_states_, combined);
+    }
 
-      return combined;
+    /// @brief Create an independent deep copy of this warehouse
+    ///
+    /// Every radiator is cloned, so the copy can be updated concurrently
+    /// with the original.
+    RadiatorWarehouse Clone() const
+    {
+      RadiatorWarehouse copy;
+      for (const auto& radiator : radiators_)
+      {
+        copy.Add(radiator->Clone());
+      }
+      return copy;
     }
 
     /// @brief Clear all radiators
@@ -202,8 +232,26 @@ namespace tuvx
     }
 
    private:
+    /// @brief States of radiators that have been updated, in insertion order
+    std::vector<const RadiatorState*> ActiveStates() const
+    {
+      std::vector<const RadiatorState*> states;
+      states.reserve(radiators_.size());
+      for (const auto& radiator : radiators_)
+      {
+        if (radiator->HasState())
+        {
+          states.push_back(&radiator->State());
+        }
+      }
+      return states;
+    }
+
     std::vector<std::unique_ptr<Radiator>> radiators_;
     std::unordered_map<std::string, std::size_t> name_to_index_;
+
+    // Scratch list of updated states reused by CombineInto()
+    std::vector<const RadiatorState*> active_states_;
   };
 
 }  // namespace tuvx
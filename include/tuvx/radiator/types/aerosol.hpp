@@ -114,8 +114,8 @@ namespace tuvx
       (void)profiles;  // Aerosol doesn't use atmospheric profiles
 
       // Get grids
-      const auto& wl_grid = grids.Get(wavelength_grid_name_, "nm");
-      const auto& alt_grid = grids.Get(altitude_grid_name_, "km");
+      const auto& wl_grid = RequireGrid(grids, wavelength_grid_name_, "nm");
+      const auto& alt_grid = RequireGrid(grids, altitude_grid_name_, "km");
 
       std::size_t n_layers = alt_grid.Spec().n_cells;
       std::size_t n_wavelengths = wl_grid.Spec().n_cells;
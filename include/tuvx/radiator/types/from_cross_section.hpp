@@ -3,6 +3,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <tuvx/cross_section/cross_section.hpp>
 #include <tuvx/grid/grid.hpp>
@@ -69,12 +70,12 @@ namespace tuvx
     void UpdateState(const GridWarehouse& grids, const ProfileWarehouse& profiles) override
     {
       // Get grids
-      const auto& wl_grid = grids.Get(wavelength_grid_name_, "nm");
-      const auto& alt_grid = grids.Get(altitude_grid_name_, "km");
+      const auto& wl_grid = RequireGrid(grids, wavelength_grid_name_, "nm");
+      const auto& alt_grid = RequireGrid(grids, altitude_grid_name_, "km");
 
       // Get profiles
-      const auto& density_profile = profiles.Get(density_profile_name_, "molecules/cm^3");
-      const auto& temperature_profile = profiles.Get(temperature_profile_name_, "K");
+      const auto& density_profile = RequireProfile(profiles, density_profile_name_, "molecules/cm^3");
+      const auto& temperature_profile = RequireProfile(profiles, temperature_profile_name_, "K");
 
       std::size_t n_layers = alt_grid.Spec().n_cells;
       std::size_t n_wavelengths = wl_grid.Spec().n_cells;
@@ -85,22 +86,22 @@ namespace tuvx
       // Get layer thicknesses (convert km to cm for consistency with cross-sections)
       auto deltas = alt_grid.Deltas();
 
-      // Get number densities at each layer
+      // Get number densities and temperatures at each layer
       auto densities = density_profile.MidValues();
+      auto temperatures = temperature_profile.MidValues();
 
-      // Calculate cross-section profile [n_layers][n_wavelengths]
-      auto xs_profile = cross_section_->CalculateProfile(wl_grid, alt_grid, temperature_profile);
-
-      // Compute optical depths
+      // Compute optical depths, evaluating each layer's cross-section in place
       for (std::size_t i = 0; i < n_layers; ++i)
       {
         // Convert layer thickness from km to cm
         double delta_z_cm = std::abs(deltas[i]) * 1.0e5;  // km -> cm
 
+        std::vector<double>& optical_depth = state_.optical_depth[i];
+        cross_section_->CalculateInto(wl_grid, temperatures[i], optical_depth);
         for (std::size_t j = 0; j < n_wavelengths; ++j)
         {
           // τ = σ × N × Δz
-          state_.optical_depth[i][j] = xs_profile[i][j] * densities[i] * delta_z_cm;
+          optical_depth[j] = optical_depth[j] * densities[i] * delta_z_cm;
         }
 
         // Pure absorber: ω = 0, g = 0 (already initialized to zero)
@@ -113,6 +114,13 @@ namespace tuvx
       return *cross_section_;
     }
 
+    /// @brief Replace the cross-section used by this radiator
+    /// @param cross_section New cross-section (e.g. a SharedCrossSection over node-shared tables)
+    void SetCrossSection(std::unique_ptr<CrossSection> cross_section)
+    {
+      cross_section_ = std::move(cross_section);
+    }
+
     /// @brief Get the density profile name
     const std::string& DensityProfileName() const
     {
@@ -67,11 +67,11 @@ namespace tuvx
     void UpdateState(const GridWarehouse& grids, const ProfileWarehouse& profiles) override
     {
       // Get grids
-      const auto& wl_grid = grids.Get(wavelength_grid_name_, "nm");
-      const auto& alt_grid = grids.Get(altitude_grid_name_, "km");
+      const auto& wl_grid = RequireGrid(grids, wavelength_grid_name_, "nm");
+      const auto& alt_grid = RequireGrid(grids, altitude_grid_name_, "km");
 
       // Get air density profile
-      const auto& air_density_profile = profiles.Get(air_density_profile_name_, "molecules/cm^3");
+      const auto& air_density_profile = RequireProfile(profiles, air_density_profile_name_, "molecules/cm^3");
 
       std::size_t n_layers = alt_grid.Spec().n_cells;
       std::size_t n_wavelengths = wl_grid.Spec().n_cells;
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <tuvx/model/batch_driver.hpp>
+#include <tuvx/service/protocol.hpp>
+#include <tuvx/util/internal_error.hpp>
+
+namespace tuvx
+{
+  /// @brief Connection to a PhotolysisServer
+  ///
+  /// The constructor connects and asks the server for its altitude grid size
+  /// and reaction names. Calculate() then sends a batch and scatters the
+  /// returned J-values into the caller's arrays, with the same views as
+  /// BatchDriver, so switching a tool between a local model and the service
+  /// changes only the object it calls. A client must not be used by several
+  /// threads at once; open one connection per thread instead.
+  ///
+  /// Example usage:
+  /// @code
+  /// PhotolysisClient client("/tmp/tuvx.sock");
+  /// std::vector<double> j(n_columns * client.NumberOfReactions() * client.NumberOfLevels());
+  /// client.Calculate(batch, rates);
+  /// @endcode
+  class PhotolysisClient
+  {
+   public:
+    /// @brief Connect to a server
+    /// @param socket_path Path of the server's Unix domain socket
+    /// @throws std::runtime_error if the server cannot be reached
+    explicit PhotolysisClient(const std::string& socket_path)
+    {
+#if TUVX_HAS_UNIX_SOCKETS
+      sockaddr_un address;
+      if (!service::MakeAddress(socket_path, address))
+      {
+        TUVX_THROW(std::runtime_error("Invalid photolysis service socket path '" + socket_path + "'"));
+      }
+      socket_ = service::Socket(::socket(AF_UNIX, SOCK_STREAM, 0));
+      if (!socket_.Valid() || ::connect(socket_.Get(), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+      {
+        std::string reason = std::strerror(errno);
+        TUVX_THROW(std::runtime_error("Cannot connect to photolysis service '" + socket_path + "': " + reason));
+      }
+  #if defined(SO_NOSIGPIPE)
+      int one = 1;
+      ::setsockopt(socket_.Get(), SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+  #endif
+      request_.Clear();
+      Exchange(service::MessageType::Describe, kDescriptionWords);
+      std::uint64_t n_layers = 0;
+      std::uint64_t n_reactions = 0;
+      bool valid = response_.GetCount(n_layers) && response_.GetCount(n_reactions);
+      reaction_names_.resize(valid ? n_reactions : 0);
+      for (auto& name : reaction_names_)
+      {
+        valid = valid && response_.GetString(name);
+      }
+      if (!valid)
+      {
+        TUVX_THROW(std::runtime_error("Malformed description from photolysis service"));
+      }
+      n_layers_ = n_layers;
+#else
+      TUVX_THROW(std::runtime_error("The photolysis service needs Unix domain sockets: " + socket_path));
+#endif
+    }
+
+    PhotolysisClient(const PhotolysisClient&) = delete;
+    PhotolysisClient& operator=(const PhotolysisClient&) = delete;
+
+    /// @brief Number of layers in the server's altitude grid
+    std::size_t NumberOfLayers() const
+    {
+      return n_layers_;
+    }
+
+    /// @brief Number of levels (layer edges) J-values are returned for
+    std::size_t NumberOfLevels() const
+    {
+      return n_layers_ + 1;
+    }
+
+    /// @brief Number of photolysis reactions the server calculates
+    std::size_t NumberOfReactions() const
+    {
+      return reaction_names_.size();
+    }
+
+    /// @brief Reaction names in the order J-values are returned
+    const std::vector<std::string>& ReactionNames() const
+    {
+      return reaction_names_;
+    }
+
+    /// @brief Calculate photolysis rates for a batch on the server
+    /// @param batch Column inputs; missing albedo or profiles take the server model's defaults
+    /// @param rates Destination for J-values
+    /// @throws std::invalid_argument if the batch does not match the server's grid or the rate array is null
+    /// @throws std::runtime_error if the server reports an error or the connection fails
+    void Calculate(const ColumnBatchView& batch, const RateBatchView& rates)
+    {
+      if (batch.n_columns == 0)
+      {
+        return;
+      }
+      if (batch.n_layers != n_layers_ || batch.solar_zenith_angle.Size() < batch.n_columns)
+      {
+        TUVX_THROW(std::invalid_argument("Batch does not match the photolysis service's altitude grid"));
+      }
+      if (rates.data == nullptr && NumberOfReactions() > 0)
+      {
+        TUVX_THROW(std::invalid_argument("Photolysis service rate array is null"));
+      }
+
+      // Pack the inputs contiguously
+      std::size_t n = batch.n_columns;
+      bool has_albedo = !batch.surface_albedo.Empty();
+      auto flag = [](bool present, service::Field field) { return present ? static_cast<std::uint64_t>(field) : 0; };
+      std::uint64_t fields = flag(has_albedo, service::kAlbedo) |
+                             flag(batch.temperature.data != nullptr, service::kTemperature) |
+                             flag(batch.air_density.data != nullptr, service::kAirDensity) |
+                             flag(batch.ozone.data != nullptr, service::kOzone);
+      request_.Clear();
+      request_.PutCount(n);
+      request_.PutCount(n_layers_);
+      request_.PutCount(fields);
+      double* sza = request_.Append(n);
+      for (std::size_t c = 0; c < n; ++c)
+      {
+        sza[c] = batch.solar_zenith_angle[c];
+      }
+      if (has_albedo)
+      {
+        double* albedo = request_.Append(n);
+        for (std::size_t c = 0; c < n; ++c)
+        {
+          albedo[c] = batch.surface_albedo[c];
+        }
+      }
+      for (const ProfileBatchView* profile : { &batch.temperature, &batch.air_density, &batch.ozone })
+      {
+        if (profile->data == nullptr)
+        {
+          continue;
+        }
+        double* values = request_.Append(n * n_layers_);
+        for (std::size_t c = 0; c < n; ++c)
+        {
+          auto column = profile->Column(c, n_layers_);
+          for (std::size_t l = 0; l < n_layers_; ++l)
+          {
+            values[c * n_layers_ + l] = column[l];
+          }
+        }
+      }
+
+      std::size_t n_reactions = NumberOfReactions();
+      std::size_t n_levels = NumberOfLevels();
+      Exchange(service::MessageType::Calculate, 3 + n * n_reactions * n_levels);
+
+      std::uint64_t n_returned = 0;
+      std::uint64_t n_returned_reactions = 0;
+      std::uint64_t n_returned_levels = 0;
+      bool valid = response_.GetCount(n_returned) && response_.GetCount(n_returned_reactions) &&
+                   response_.GetCount(n_returned_levels) && n_returned == n && n_returned_reactions == n_reactions &&
+                   n_returned_levels == n_levels;
+      const double* j = valid ? response_.Take(n * n_reactions * n_levels) : nullptr;
+      if (j == nullptr)
+      {
+        TUVX_THROW(std::runtime_error("Malformed rates from photolysis service"));
+      }
+      for (std::size_t c = 0; c < n; ++c)
+      {
+        double* column_rates = rates.data + static_cast<std::ptrdiff_t>(c) * rates.column_stride;
+        for (std::size_t r = 0; r < n_reactions; ++r)
+        {
+          for (std::size_t l = 0; l < n_levels; ++l)
+          {
+            column_rates[static_cast<std::ptrdiff_t>(r) * rates.reaction_stride +
+                         static_cast<std::ptrdiff_t>(l) * rates.level_stride] = *j++;
+          }
+        }
+      }
+    }
+
+   private:
+    /// Largest Description payload accepted
+    static constexpr std::size_t kDescriptionWords = 1 << 16;
+
+    /// Largest Error payload accepted
+    static constexpr std::size_t kErrorWords = 1 << 12;
+
+    /// @brief Send request_ and receive the reply into response_
+    /// @param expected_words Payload size expected for a successful reply
+    /// @throws std::runtime_error if the connection fails or the server replies with an error
+    void Exchange(service::MessageType type, std::size_t expected_words)
+    {
+#if TUVX_HAS_UNIX_SOCKETS
+      service::MessageType reply{};
+      if (!service::SendMessage(socket_.Get(), type, request_) ||
+          service::ReceiveMessage(socket_.Get(), std::max(expected_words, kErrorWords), reply, response_) !=
+              service::ReceiveStatus::Ok)
+      {
+        TUVX_THROW(std::runtime_error("Lost connection to photolysis service"));
+      }
+      if (reply == service::MessageType::Error)
+      {
+        std::string message;
+        response_.GetString(message);
+        TUVX_THROW(std::runtime_error("Photolysis service error: " + message));
+      }
+#endif
+    }
+
+    service::Socket socket_;
+    std::size_t n_layers_{ 0 };
+    std::vector<std::string> reaction_names_;
+    service::Payload request_;
+    service::Payload response_;
+  };
+
+}  // namespace tuvx
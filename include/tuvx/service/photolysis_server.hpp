@@ -0,0 +1,446 @@
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <tuvx/model/batch_driver.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/service/protocol.hpp>
+#include <tuvx/util/internal_error.hpp>
+#include <tuvx/util/thread_pool.hpp>
+
+#if TUVX_HAS_UNIX_SOCKETS
+  #include <poll.h>
+#endif
+
+namespace tuvx
+{
+  /// @brief Configuration for PhotolysisServer
+  struct PhotolysisServerConfig
+  {
+    /// Filesystem path of the Unix domain socket. A stale socket file there is
+    /// replaced; any other kind of file makes the constructor fail.
+    std::string socket_path;
+
+    /// Largest batch accepted in one request
+    std::size_t max_columns_per_request{ 65536 };
+
+    /// Connections served at once; further clients receive an error and are closed
+    std::size_t max_clients{ 64 };
+
+    /// Pending connections queued by the kernel
+    int backlog{ 16 };
+  };
+
+  /// @brief Counters kept by PhotolysisServer
+  struct PhotolysisServerStats
+  {
+    std::size_t connections{ 0 };
+    std::size_t requests{ 0 };
+    std::size_t columns{ 0 };
+
+    /// Requests answered with an error message
+    std::size_t errors{ 0 };
+  };
+
+  /// @brief Serves J-values for a resident model over a Unix domain socket
+  ///
+  /// Tools that each build their own model pay the startup cost (grids,
+  /// cross-sections, radiators) every time they run. A PhotolysisServer
+  /// keeps one prepared model and answers PhotolysisClient requests using
+  /// the protocol in service/protocol.hpp, so that cost is paid once per node.
+  ///
+  /// Each connection is read and answered on its own thread. Batches from
+  /// all clients are calculated one at a time by a BatchDriver spreading
+  /// the columns over the pool, so a large batch uses every pool thread
+  /// while other connections receive and decode their next request.
+  ///
+  /// Example usage:
+  /// @code
+  /// ThreadPool pool(8);
+  /// PhotolysisServer server(model, pool, { "/tmp/tuvx.sock" });
+  /// server.Start();
+  /// // ... until shutdown
+  /// server.Stop();
+  /// @endcode
+  class PhotolysisServer
+  {
+   public:
+    /// @brief Bind and listen on the socket
+    /// @param model Model with grids, radiators and reactions set up (must outlive the server)
+    /// @param pool Thread pool for calculations (must outlive the server)
+    /// @param config Socket path and limits
+    /// @throws std::runtime_error if the socket cannot be created or bound, or the
+    ///         path holds a file that is not a socket
+    PhotolysisServer(TuvModel& model, ThreadPool& pool, PhotolysisServerConfig config)
+        : model_(Prepared(model)),
+          driver_(model_, pool),
+          config_(std::move(config))
+    {
+      n_layers_ = model_.AltitudeGrid().Spec().n_cells;
+      n_reactions_ = model_.PhotolysisReactions().Size();
+      description_.PutCount(n_layers_);
+      description_.PutCount(n_reactions_);
+      for (const auto& name : model_.PhotolysisReactions().ReactionNames())
+      {
+        description_.PutString(name);
+      }
+      Listen();
+    }
+
+    PhotolysisServer(const PhotolysisServer&) = delete;
+    PhotolysisServer& operator=(const PhotolysisServer&) = delete;
+
+    /// @brief Stop serving and remove the socket file
+    ~PhotolysisServer()
+    {
+      Stop();
+#if TUVX_HAS_UNIX_SOCKETS
+      if (listen_fd_ >= 0)
+      {
+        ::close(listen_fd_);
+        service::RemoveSocketFile(config_.socket_path);
+      }
+#endif
+    }
+
+    /// @brief Start accepting clients on a background thread
+    void Start()
+    {
+      if (running_)
+      {
+        return;
+      }
+      running_ = true;
+      stopping_.store(false);
+      accept_thread_ = std::thread([this] { AcceptLoop(); });
+    }
+
+    /// @brief Stop accepting, close every connection and wait for their threads
+    ///
+    /// A request being calculated is finished first; its reply may be lost.
+    void Stop()
+    {
+      if (!running_)
+      {
+        return;
+      }
+      stopping_.store(true);
+      accept_thread_.join();
+#if TUVX_HAS_UNIX_SOCKETS
+      {
+        std::lock_guard<std::mutex> lock(clients_mutex_);
+        for (auto& client : clients_)
+        {
+          ::shutdown(client.fd, SHUT_RDWR);
+        }
+      }
+#endif
+      for (auto& client : clients_)
+      {
+        client.thread.join();
+        CloseSocket(client.fd);
+      }
+      clients_.clear();
+      running_ = false;
+    }
+
+    /// @brief Path of the listening socket
+    const std::string& SocketPath() const
+    {
+      return config_.socket_path;
+    }
+
+    /// @brief Counters since construction
+    PhotolysisServerStats Stats() const
+    {
+      PhotolysisServerStats stats;
+      stats.connections = connections_.load();
+      stats.requests = requests_.load();
+      stats.columns = columns_.load();
+      stats.errors = errors_.load();
+      return stats;
+    }
+
+   private:
+    /// One connected client and the thread serving it
+    struct Client
+    {
+      int fd{ -1 };
+      std::thread thread;
+      std::atomic<bool> done{ false };
+    };
+
+    /// @brief Prepare the model before the driver copies it into its replicas
+    static TuvModel& Prepared(TuvModel& model)
+    {
+      model.PrepareComponents();
+      return model;
+    }
+
+    void Listen()
+    {
+#if TUVX_HAS_UNIX_SOCKETS
+      sockaddr_un address;
+      if (!service::MakeAddress(config_.socket_path, address))
+      {
+        TUVX_THROW(std::runtime_error("Invalid photolysis service socket path '" + config_.socket_path + "'"));
+      }
+      listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+      if (listen_fd_ < 0)
+      {
+        TUVX_THROW(std::runtime_error(std::string("Cannot create photolysis service socket: ") + std::strerror(errno)));
+      }
+      if (service::RemoveSocketFile(config_.socket_path) == service::RemoveStatus::NotSocket)
+      {
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        TUVX_THROW(std::runtime_error("Cannot listen on '" + config_.socket_path + "': not a socket file"));
+      }
+      if (::bind(listen_fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+          ::listen(listen_fd_, config_.backlog) != 0)
+      {
+        std::string reason = std::strerror(errno);
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        TUVX_THROW(std::runtime_error("Cannot listen on '" + config_.socket_path + "': " + reason));
+      }
+#else
+      TUVX_THROW(std::runtime_error("The photolysis service needs Unix domain sockets: " + config_.socket_path));
+#endif
+    }
+
+    void AcceptLoop()
+    {
+#if TUVX_HAS_UNIX_SOCKETS
+      while (!stopping_.load())
+      {
+        ReapClients();
+        // Wake up regularly to notice Stop()
+        pollfd listener{ listen_fd_, POLLIN, 0 };
+        if (::poll(&listener, 1, 50) <= 0)
+        {
+          continue;
+        }
+        int fd = ::accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0)
+        {
+          continue;
+        }
+  #if defined(SO_NOSIGPIPE)
+        int one = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+  #endif
+        std::lock_guard<std::mutex> lock(clients_mutex_);
+        if (clients_.size() >= config_.max_clients)
+        {
+          service::Payload busy;
+          busy.PutString("Photolysis server is serving its maximum number of clients");
+          service::SendMessage(fd, service::MessageType::Error, busy);
+          ::close(fd);
+          continue;
+        }
+        ++connections_;
+        Client& client = clients_.emplace_back();
+        client.fd = fd;
+        client.thread = std::thread([this, &client] { Serve(client); });
+      }
+#endif
+    }
+
+    /// @brief Close a connection once its thread has finished, so the descriptor is never reused early
+    static void CloseSocket(int fd)
+    {
+#if TUVX_HAS_UNIX_SOCKETS
+      ::close(fd);
+#endif
+    }
+
+    /// @brief Join the threads of clients that have disconnected
+    void ReapClients()
+    {
+      std::lock_guard<std::mutex> lock(clients_mutex_);
+      for (auto it = clients_.begin(); it != clients_.end();)
+      {
+        if (it->done.load())
+        {
+          it->thread.join();
+          CloseSocket(it->fd);
+          it = clients_.erase(it);
+        }
+        else
+        {
+          ++it;
+        }
+      }
+    }
+
+    /// @brief Answer one client's requests until it disconnects
+    void Serve(Client& client)
+    {
+#if TUVX_HAS_UNIX_SOCKETS
+      std::size_t max_words = 3 + config_.max_columns_per_request * (2 + 3 * n_layers_);
+      service::Payload request;
+      service::Payload response;
+      for (;;)
+      {
+        service::MessageType type{};
+        auto status = service::ReceiveMessage(client.fd, max_words, type, request);
+        if (status == service::ReceiveStatus::Closed)
+        {
+          break;
+        }
+        if (status == service::ReceiveStatus::Invalid)
+        {
+          SendError(client.fd, "Malformed or oversized request");
+          break;
+        }
+        bool sent = false;
+        if (type == service::MessageType::Describe)
+        {
+          sent = service::SendMessage(client.fd, service::MessageType::Description, description_);
+        }
+        else if (type == service::MessageType::Calculate)
+        {
+          sent = HandleCalculate(client.fd, request, response);
+        }
+        else
+        {
+          sent = SendError(client.fd, "Unknown request type");
+        }
+        if (!sent)
+        {
+          break;
+        }
+      }
+#endif
+      client.done.store(true);
+    }
+
+    /// @brief Decode a Calculate request, run it and send the rates or an error
+    /// @return False if the reply could not be sent
+    bool HandleCalculate(int fd, service::Payload& request, service::Payload& response)
+    {
+      std::uint64_t n_columns = 0;
+      std::uint64_t n_layers = 0;
+      std::uint64_t fields = 0;
+      if (!request.GetCount(n_columns) || !request.GetCount(n_layers) || !request.GetCount(fields))
+      {
+        return SendError(fd, "Truncated calculate request");
+      }
+      if (n_layers != n_layers_)
+      {
+        return SendError(
+            fd, "Request has " + std::to_string(n_layers) + " layers, model has " + std::to_string(n_layers_));
+      }
+      if (n_columns > config_.max_columns_per_request)
+      {
+        return SendError(fd, "Request has more than " + std::to_string(config_.max_columns_per_request) + " columns");
+      }
+
+      std::size_t n = n_columns;
+      std::size_t n_profile = n * n_layers_;
+      auto take_profile = [&](std::uint64_t flag) -> ProfileBatchView
+      {
+        if ((fields & flag) == 0)
+        {
+          return {};
+        }
+        return { request.Take(n_profile), static_cast<std::ptrdiff_t>(n_layers_), 1 };
+      };
+      ColumnBatchView batch;
+      batch.n_columns = n;
+      batch.n_layers = n_layers_;
+      const double* sza = request.Take(n);
+      const double* albedo = (fields & service::kAlbedo) != 0 ? request.Take(n) : nullptr;
+      batch.temperature = take_profile(service::kTemperature);
+      batch.air_density = take_profile(service::kAirDensity);
+      batch.ozone = take_profile(service::kOzone);
+      bool truncated = sza == nullptr || ((fields & service::kAlbedo) != 0 && albedo == nullptr) ||
+                       ((fields & service::kTemperature) != 0 && batch.temperature.data == nullptr) ||
+                       ((fields & service::kAirDensity) != 0 && batch.air_density.data == nullptr) ||
+                       ((fields & service::kOzone) != 0 && batch.ozone.data == nullptr);
+      if (truncated || n == 0)
+      {
+        return SendError(fd, n == 0 ? "Request has no columns" : "Truncated calculate request");
+      }
+      batch.solar_zenith_angle = StridedView<const double>(sza, n);
+      if (albedo != nullptr)
+      {
+        batch.surface_albedo = StridedView<const double>(albedo, n);
+      }
+
+      std::size_t n_levels = n_layers_ + 1;
+      response.Clear();
+      response.PutCount(n);
+      response.PutCount(n_reactions_);
+      response.PutCount(n_levels);
+      RateBatchView rates{ response.Append(n * n_reactions_ * n_levels),
+                           static_cast<std::ptrdiff_t>(n_reactions_ * n_levels),
+                           static_cast<std::ptrdiff_t>(n_levels),
+                           1 };
+      std::string error;
+      {
+        std::lock_guard<std::mutex> lock(calculate_mutex_);
+#if TUVX_EXCEPTIONS
+        try
+        {
+          driver_.Calculate(batch, rates);
+        }
+        catch (const std::exception& e)
+        {
+          error = e.what();
+        }
+#else
+        driver_.Calculate(batch, rates);
+#endif
+      }
+      if (!error.empty())
+      {
+        return SendError(fd, error);
+      }
+      ++requests_;
+      columns_ += n;
+      return service::SendMessage(fd, service::MessageType::Rates, response);
+    }
+
+    bool SendError(int fd, const std::string& message)
+    {
+      ++errors_;
+      service::Payload payload;
+      payload.PutString(message);
+      return service::SendMessage(fd, service::MessageType::Error, payload);
+    }
+
+    TuvModel& model_;
+    BatchDriver driver_;
+    PhotolysisServerConfig config_;
+    std::size_t n_layers_{ 0 };
+    std::size_t n_reactions_{ 0 };
+    service::Payload description_;
+
+    int listen_fd_{ -1 };
+    bool running_{ false };
+    std::atomic<bool> stopping_{ false };
+    std::thread accept_thread_;
+    std::mutex clients_mutex_;
+    std::list<Client> clients_;
+    std::mutex calculate_mutex_;
+
+    std::atomic<std::size_t> connections_{ 0 };
+    std::atomic<std::size_t> requests_{ 0 };
+    std::atomic<std::size_t> columns_{ 0 };
+    std::atomic<std::size_t> errors_{ 0 };
+  };
+
+}  // namespace tuvx
@@ -0,0 +1,391 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <tuvx/model/batch_driver.hpp>
+
+#if defined(__unix__) || defined(__APPLE__)
+  #define TUVX_HAS_UNIX_SOCKETS 1
+  #include <sys/socket.h>
+  #include <sys/stat.h>
+  #include <sys/types.h>
+  #include <sys/un.h>
+  #include <unistd.h>
+#else
+  #define TUVX_HAS_UNIX_SOCKETS 0
+#endif
+
+namespace tuvx
+{
+  /// @brief Binary protocol spoken by PhotolysisServer and PhotolysisClient
+  ///
+  /// Every message is a service::Header followed by a payload of 8-byte words
+  /// in the host's native byte order (both ends run on the same node):
+  ///
+  /// | Type        | Payload                                                                  |
+  /// |-------------|--------------------------------------------------------------------------|
+  /// | Describe    | (empty)                                                                  |
+  /// | Description | n_layers, n_reactions, then per reaction: name length, name (padded)     |
+  /// | Calculate   | n_columns, n_layers, field flags, sza[n], albedo[n], profiles[n][layers] |
+  /// | Rates       | n_columns, n_reactions, n_levels, J[n][reactions][levels]                |
+  /// | Error       | message length, message (padded)                                         |
+  ///
+  /// Counts are unsigned 64-bit integers and data are doubles. In a Calculate
+  /// request the albedo and each profile (temperature, air density, ozone, in
+  /// that order) are present only if their service::Field flag is set; missing
+  /// fields take the server model's defaults, as in BatchDriver.
+  namespace service
+  {
+    /// "TUVJ" as a little-endian word
+    inline constexpr std::uint32_t kMagic = 0x4A565554;
+    inline constexpr std::uint16_t kVersion = 1;
+
+    /// @brief Message types
+    enum class MessageType : std::uint16_t
+    {
+      Describe = 1,
+      Description = 2,
+      Calculate = 3,
+      Rates = 4,
+      Error = 5
+    };
+
+    /// @brief Flags marking the optional fields of a Calculate request
+    enum Field : std::uint64_t
+    {
+      kAlbedo = 1u << 0,
+      kTemperature = 1u << 1,
+      kAirDensity = 1u << 2,
+      kOzone = 1u << 3
+    };
+
+    /// @brief Fixed-size header preceding every payload
+    struct Header
+    {
+      std::uint32_t magic{ kMagic };
+      std::uint16_t version{ kVersion };
+      std::uint16_t type{ 0 };
+
+      /// Payload size in 8-byte words
+      std::uint64_t payload_words{ 0 };
+    };
+    static_assert(sizeof(Header) == 16);
+
+    /// @brief Payload being written or read, stored as 8-byte words so doubles are aligned
+    class Payload
+    {
+     public:
+      /// @brief Remove all words and rewind
+      void Clear()
+      {
+        words_.clear();
+        position_ = 0;
+      }
+
+      void PutCount(std::uint64_t value)
+      {
+        double word;
+        std::memcpy(&word, &value, sizeof(word));
+        words_.push_back(word);
+      }
+
+      /// @brief Append a string as its length followed by its bytes padded to whole words
+      void PutString(const std::string& value)
+      {
+        PutCount(value.size());
+        std::size_t first = words_.size();
+        words_.resize(first + (value.size() + 7) / 8, 0.0);
+        std::memcpy(words_.data() + first, value.data(), value.size());
+      }
+
+      /// @brief Reserve n words at the end and return a pointer to them
+      double* Append(std::size_t n)
+      {
+        std::size_t first = words_.size();
+        words_.resize(first + n);
+        return words_.data() + first;
+      }
+
+      /// @brief Read the next count
+      /// @return False if the payload is exhausted
+      bool GetCount(std::uint64_t& value)
+      {
+        if (Remaining() < 1)
+        {
+          return false;
+        }
+        std::memcpy(&value, &words_[position_++], sizeof(value));
+        return true;
+      }
+
+      /// @brief Read a string written by PutString()
+      /// @return False if the payload is truncated
+      bool GetString(std::string& value)
+      {
+        std::uint64_t length = 0;
+        if (!GetCount(length) || length > 8 * Remaining())
+        {
+          return false;
+        }
+        value.assign(reinterpret_cast<const char*>(words_.data() + position_), length);
+        position_ += (length + 7) / 8;
+        return true;
+      }
+
+      /// @brief Take the next n words
+      /// @return Pointer to the words, or null if the payload is truncated
+      const double* Take(std::size_t n)
+      {
+        if (n > Remaining())
+        {
+          return nullptr;
+        }
+        const double* first = words_.data() + position_;
+        position_ += n;
+        return first;
+      }
+
+      std::size_t Remaining() const
+      {
+        return words_.size() - position_;
+      }
+
+      std::size_t Size() const
+      {
+        return words_.size();
+      }
+
+      double* Data()
+      {
+        return words_.data();
+      }
+
+      const double* Data() const
+      {
+        return words_.data();
+      }
+
+     private:
+      std::vector<double> words_;
+      std::size_t position_{ 0 };
+    };
+
+    /// @brief Socket descriptor closed when the owner goes out of scope
+    class Socket
+    {
+     public:
+      Socket() = default;
+
+      explicit Socket(int fd)
+          : fd_(fd)
+      {
+      }
+
+      Socket(const Socket&) = delete;
+      Socket& operator=(const Socket&) = delete;
+
+      Socket(Socket&& other) noexcept
+          : fd_(other.fd_)
+      {
+        other.fd_ = -1;
+      }
+
+      Socket& operator=(Socket&& other) noexcept
+      {
+        if (this != &other)
+        {
+          Close();
+          fd_ = other.fd_;
+          other.fd_ = -1;
+        }
+        return *this;
+      }
+
+      ~Socket()
+      {
+        Close();
+      }
+
+      int Get() const
+      {
+        return fd_;
+      }
+
+      bool Valid() const
+      {
+        return fd_ >= 0;
+      }
+
+      void Close()
+      {
+#if TUVX_HAS_UNIX_SOCKETS
+        if (fd_ >= 0)
+        {
+          ::close(fd_);
+        }
+#endif
+        fd_ = -1;
+      }
+
+     private:
+      int fd_{ -1 };
+    };
+
+#if TUVX_HAS_UNIX_SOCKETS
+  #if defined(MSG_NOSIGNAL)
+    inline constexpr int kSendFlags = MSG_NOSIGNAL;
+  #else
+    inline constexpr int kSendFlags = 0;
+  #endif
+
+    /// Words read per call while receiving a payload
+    inline constexpr std::size_t kReceiveChunkWords = std::size_t{ 1 } << 16;
+
+    /// @brief Write every byte, retrying after interrupts and short writes
+    /// @return False if the connection failed
+    inline bool SendAll(int fd, const void* data, std::size_t bytes)
+    {
+      const char* first = static_cast<const char*>(data);
+      while (bytes > 0)
+      {
+        ssize_t sent = ::send(fd, first, bytes, kSendFlags);
+        if (sent < 0 && errno == EINTR)
+        {
+          continue;
+        }
+        if (sent <= 0)
+        {
+          return false;
+        }
+        first += sent;
+        bytes -= static_cast<std::size_t>(sent);
+      }
+      return true;
+    }
+
+    /// @brief Read exactly the requested number of bytes
+    /// @return False on end of stream or error
+    inline bool ReceiveAll(int fd, void* data, std::size_t bytes)
+    {
+      char* first = static_cast<char*>(data);
+      while (bytes > 0)
+      {
+        ssize_t received = ::recv(fd, first, bytes, 0);
+        if (received < 0 && errno == EINTR)
+        {
+          continue;
+        }
+        if (received <= 0)
+        {
+          return false;
+        }
+        first += received;
+        bytes -= static_cast<std::size_t>(received);
+      }
+      return true;
+    }
+
+    /// @brief Send a header and payload
+    inline bool SendMessage(int fd, MessageType type, const Payload& payload)
+    {
+      Header header;
+      header.type = static_cast<std::uint16_t>(type);
+      header.payload_words = payload.Size();
+      return SendAll(fd, &header, sizeof(header)) && SendAll(fd, payload.Data(), payload.Size() * sizeof(double));
+    }
+
+    /// @brief Outcome of ReceiveMessage()
+    enum class ReceiveStatus
+    {
+      Ok,
+      Closed,  ///< The peer closed the connection or it failed
+      Invalid  ///< Wrong magic or version, or the payload exceeds the limit
+    };
+
+    /// @brief Read one message
+    /// @param fd Connected socket
+    /// @param max_words Largest payload accepted
+    /// @param type Message type read from the header
+    /// @param payload Filled with the payload and rewound
+    inline ReceiveStatus ReceiveMessage(int fd, std::size_t max_words, MessageType& type, Payload& payload)
+    {
+      Header header;
+      if (!ReceiveAll(fd, &header, sizeof(header)))
+      {
+        return ReceiveStatus::Closed;
+      }
+      if (header.magic != kMagic || header.version != kVersion || header.payload_words > max_words)
+      {
+        return ReceiveStatus::Invalid;
+      }
+      type = static_cast<MessageType>(header.type);
+
+      // Grow the buffer as the words arrive, so a header alone cannot make
+      // the receiver allocate the largest payload it accepts
+      payload.Clear();
+      std::size_t remaining = header.payload_words;
+      while (remaining > 0)
+      {
+        std::size_t chunk = std::min(remaining, kReceiveChunkWords);
+        if (!ReceiveAll(fd, payload.Append(chunk), chunk * sizeof(double)))
+        {
+          return ReceiveStatus::Closed;
+        }
+        remaining -= chunk;
+      }
+      return ReceiveStatus::Ok;
+    }
+
+    /// @brief Outcome of RemoveSocketFile()
+    enum class RemoveStatus
+    {
+      Removed,  ///< A socket file was there and has been removed
+      Absent,   ///< Nothing was at the path
+      NotSocket  ///< Something other than a socket is at the path; it was left alone
+    };
+
+    /// @brief Remove a stale socket file, never any other kind of file
+    /// @param path Filesystem path of the socket
+    inline RemoveStatus RemoveSocketFile(const std::string& path)
+    {
+      struct stat info;
+      if (::lstat(path.c_str(), &info) != 0)
+      {
+        return RemoveStatus::Absent;
+      }
+      if (!S_ISSOCK(info.st_mode))
+      {
+        return RemoveStatus::NotSocket;
+      }
+      ::unlink(path.c_str());
+      return RemoveStatus::Removed;
+    }
+
+    /// @brief Fill a socket address for a path
+    /// @return False if the path does not fit
+    inline bool MakeAddress(const std::string& path, sockaddr_un& address)
+    {
+      std::memset(&address, 0, sizeof(address));
+      address.sun_family = AF_UNIX;
+      if (path.empty() || path.size() >= sizeof(address.sun_path))
+      {
+        return false;
+      }
+      std::memcpy(address.sun_path, path.data(), path.size());
+      return true;
+    }
+#else
+    inline bool SendMessage(int, MessageType, const Payload&)
+    {
+      return false;
+    }
+#endif
+  }  // namespace service
+
+}  // namespace tuvx
@@ -9,6 +9,7 @@
 #include <tuvx/interpolation/linear_interpolator.hpp>
 #include <tuvx/solar/solar_position.hpp>
 #include <tuvx/util/constants.hpp>
+#include <tuvx/util/internal_error.hpp>
 
 namespace tuvx
 {
@@ -30,11 +31,11 @@ namespace tuvx
       {
         if (wavelengths_.size() != flux_.size())
         {
-          throw std::invalid_argument("Wavelength and flux arrays must have same size");
+          TUVX_THROW(std::invalid_argument("Wavelength and flux arrays must have same size"));
         }
         if (wavelengths_.size() < 2)
         {
-          throw std::invalid_argument("At least 2 wavelength points required");
+          TUVX_THROW(std::invalid_argument("At least 2 wavelength points required"));
         }
       }
 
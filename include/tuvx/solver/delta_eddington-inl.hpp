@@ -0,0 +1,173 @@
+#pragma once
+
+#include <tuvx/solver/delta_eddington.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <span>
+#include <vector>
+
+// Out-of-line DeltaEddingtonSolver members. Included by delta_eddington.hpp in
+// header-only builds, compiled into the library by src/tuvx.cpp with
+// TUVX_BUILD_COMPILED.
+
+namespace tuvx
+{
+  TUVX_INLINE void DeltaEddingtonSolver::SolveInto(const SolverInput& input, RadiationField& field) const
+  {
+    // Use the caller's scratch memory when it gives some
+    SolverWorkspace local;
+    SolverWorkspace& workspace = input.workspace ? *input.workspace : local;
+    SolveColumns(std::span<const SolverInput>(&input, 1), std::span<RadiationField>(&field, 1), workspace);
+  }
+
+  TUVX_INLINE void DeltaEddingtonSolver::SolveBatch(std::span<const SolverInput> inputs, std::span<RadiationField> fields)
+      const
+  {
+    if (inputs.size() != fields.size())
+    {
+      TUVX_INTERNAL_ERROR("SolveBatch() needs one field per input");
+    }
+    SolverWorkspace workspace;
+    SolveColumns(inputs, fields, workspace);
+  }
+
+  TUVX_INLINE void DeltaEddingtonSolver::SolveColumns(
+      std::span<const SolverInput> inputs,
+      std::span<RadiationField> fields,
+      SolverWorkspace& workspace) const
+  {
+    // Prepare each column: output shape and night check
+    std::vector<std::size_t>& active = workspace.active;
+    active.clear();
+    std::size_t max_layers = 0;
+    std::size_t max_wavelengths = 0;
+    for (std::size_t m = 0; m < inputs.size(); ++m)
+    {
+      const SolverInput& input = inputs[m];
+
+      // Validate input
+      if (!input.radiator_state || input.radiator_state->Empty())
+      {
+        fields[m] = RadiationField{};
+        continue;
+      }
+
+      std::size_t n_layers = input.radiator_state->NumberOfLayers();
+      std::size_t n_wavelengths = input.radiator_state->NumberOfWavelengths();
+
+      // Initialize output, reusing the field's storage
+      fields[m].Initialize(n_layers + 1, n_wavelengths);
+
+      // Check if sun is above horizon; at night there is no radiation
+      if (input.mu0() <= 0.0)
+      {
+        continue;
+      }
+      active.push_back(m);
+      max_layers = std::max(max_layers, n_layers);
+      max_wavelengths = std::max(max_wavelengths, n_wavelengths);
+    }
+
+    // Slant path factors of each sunlit column (default to 1/mu0 if not provided)
+    workspace.slant_factors.resize(active.size() * max_layers);
+    for (std::size_t a = 0; a < active.size(); ++a)
+    {
+      const SolverInput& input = inputs[active[a]];
+      std::size_t n_layers = input.radiator_state->NumberOfLayers();
+      double* slant_factors = workspace.slant_factors.data() + a * max_layers;
+      if (input.geometry)
+      {
+        const auto& enhancement = input.geometry->enhancement_factor;
+        std::copy_n(enhancement.begin(), std::min(enhancement.size(), n_layers), slant_factors);
+      }
+      else
+      {
+        std::fill_n(slant_factors, n_layers, 1.0 / input.mu0());
+      }
+    }
+
+    // Column workspaces, reused for every wavelength and column
+    std::size_t max_levels = max_layers + 1;
+    workspace.values.resize(8 * max_layers + 5 * max_levels);
+    double* tau = workspace.values.data();
+    double* omega = tau + max_layers;
+    double* g = omega + max_layers;
+    double* scratch_values = g + max_layers;
+    double* level_values = scratch_values + 5 * max_layers;
+    detail::TwoStreamScratch scratch{ scratch_values,
+                                      scratch_values + max_layers,
+                                      scratch_values + 2 * max_layers,
+                                      scratch_values + 3 * max_layers,
+                                      scratch_values + 4 * max_layers };
+    detail::TwoStreamLevels levels{ level_values,
+                                    level_values + max_levels,
+                                    level_values + 2 * max_levels,
+                                    level_values + 3 * max_levels,
+                                    level_values + 4 * max_levels };
+
+    // Solve each wavelength for every column before moving to the next
+    for (std::size_t j = 0; j < max_wavelengths; ++j)
+    {
+      for (std::size_t a = 0; a < active.size(); ++a)
+      {
+        std::size_t m = active[a];
+        const SolverInput& input = inputs[m];
+        const RadiatorState& state = *input.radiator_state;
+        RadiationField& field = fields[m];
+        std::size_t n_layers = state.NumberOfLayers();
+        std::size_t n_levels = n_layers + 1;
+        if (j >= state.NumberOfWavelengths())
+        {
+          continue;
+        }
+
+        // Get optical properties for this wavelength
+        for (std::size_t i = 0; i < n_layers; ++i)
+        {
+          tau[i] = state.optical_depth[i][j];
+          omega[i] = state.single_scattering_albedo[i][j];
+          g[i] = state.asymmetry_factor[i][j];
+        }
+
+        // Get surface albedo
+        double albedo = 0.0;
+        if (input.surface_albedo && j < input.surface_albedo->size())
+        {
+          albedo = (*input.surface_albedo)[j];
+        }
+
+        // Get TOA flux
+        double flux_toa = 1.0;
+        if (input.extraterrestrial_flux && j < input.extraterrestrial_flux->size())
+        {
+          flux_toa = (*input.extraterrestrial_flux)[j];
+        }
+
+        // Solve two-stream equations
+        detail::SolveDeltaEddingtonColumn(
+            n_layers,
+            tau,
+            omega,
+            g,
+            input.mu0(),
+            albedo,
+            flux_toa,
+            workspace.slant_factors.data() + a * max_layers,
+            scratch,
+            levels);
+
+        // Store results
+        for (std::size_t i = 0; i < n_levels; ++i)
+        {
+          field.direct_irradiance[i][j] = levels.direct[i];
+          field.diffuse_down[i][j] = levels.diffuse_down[i];
+          field.diffuse_up[i][j] = levels.diffuse_up[i];
+          field.actinic_flux_direct[i][j] = levels.actinic_direct[i];
+          field.actinic_flux_diffuse[i][j] = levels.actinic_diffuse[i];
+        }
+      }
+    }
+  }
+
+}  // namespace tuvx
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+
+namespace tuvx
+{
+  namespace detail
+  {
+    /// @brief Apply delta-M scaling to optical properties
+    /// @param tau Original optical depth
+    /// @param omega Original single scattering albedo
+    /// @param g Original asymmetry factor
+    /// @return Tuple of (scaled_tau, scaled_omega, scaled_g)
+    inline std::tuple<double, double, double> DeltaScale(double tau, double omega, double g)
+    {
+      // Delta-M scaling: removes forward scattering peak
+      double f = g * g;  // Fraction of forward scattering
+
+      double tau_scaled = tau * (1.0 - omega * f);
+      double omega_scaled = omega * (1.0 - f) / (1.0 - omega * f);
+      double g_scaled = (g - f) / (1.0 - f);
+
+      // Clamp to valid ranges
+      omega_scaled = std::clamp(omega_scaled, 0.0, 1.0);
+      g_scaled = std::clamp(g_scaled, -1.0, 1.0);
+
+      return { tau_scaled, omega_scaled, g_scaled };
+    }
+
+    /// @brief Per-level outputs of the two-stream solution for one wavelength
+    ///
+    /// Each pointer addresses n_layers + 1 values, level 0 = surface.
+    struct TwoStreamLevels
+    {
+      double* direct;           // Direct irradiance
+      double* diffuse_down;     // Diffuse downwelling
+      double* diffuse_up;       // Diffuse upwelling
+      double* actinic_direct;   // Direct actinic flux
+      double* actinic_diffuse;  // Diffuse actinic flux
+    };
+
+    /// @brief Per-layer scratch space for the two-stream solution
+    ///
+    /// Each pointer addresses n_layers values.
+    struct TwoStreamScratch
+    {
+      double* tau;            // Delta-scaled optical depth
+      double* omega;          // Delta-scaled single scattering albedo
+      double* g;              // Delta-scaled asymmetry factor
+      double* reflectance;    // Layer reflectance
+      double* transmittance;  // Layer transmittance
+    };
+
+    /// @brief Solve the delta-Eddington two-stream equations for one wavelength
+    /// @tparam Extent std::size_t, or std::integral_constant<std::size_t, N> to fix the
+    ///         layer count at compile time
+    /// @param n_layers Number of layers (layer 0 at the surface)
+    /// @param tau Optical depth of each layer
+    /// @param omega Single scattering albedo of each layer
+    /// @param g Asymmetry factor of each layer
+    /// @param mu0 Cosine of the solar zenith angle (> 0)
+    /// @param albedo Surface albedo
+    /// @param flux_toa Top-of-atmosphere flux
+    /// @param slant_factors Slant path enhancement of each layer
+    /// @param scratch Workspace, n_layers values per array
+    /// @param levels Output, n_layers + 1 values per array; fully overwritten
+    ///
+    /// Shared by DeltaEddingtonSolver and StaticDeltaEddingtonSolver so both
+    /// run the same arithmetic in the same order; with a compile-time extent
+    /// every loop has a constant trip count.
+    template<typename Extent>
+    void SolveDeltaEddingtonColumn(
+        Extent n_layers,
+        const double* tau,
+        const double* omega,
+        const double* g,
+        double mu0,
+        double albedo,
+        double flux_toa,
+        const double* slant_factors,
+        const TwoStreamScratch& scratch,
+        const TwoStreamLevels& levels)
+    {
+      static_assert(std::is_convertible_v<Extent, std::size_t>, "Extent must convert to std::size_t");
+      const std::size_t n = n_layers;
+
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        auto [tau_s, omega_s, g_s] = DeltaScale(tau[i], omega[i], g[i]);
+        scratch.tau[i] = tau_s;
+        scratch.omega[i] = omega_s;
+        scratch.g[i] = g_s;
+      }
+
+      // Direct beam attenuation (Beer-Lambert law)
+      // Levels are ordered: 0=surface, n=TOA, which receives the full flux
+      levels.direct[n] = flux_toa * mu0;
+      levels.actinic_direct[n] = flux_toa;
+      for (std::size_t i = n; i > 0; --i)
+      {
+        std::size_t layer = i - 1;  // Layer between levels i and i-1
+        double trans = std::exp(-(scratch.tau[layer] * slant_factors[layer]));
+        levels.direct[i - 1] = levels.direct[i] * trans;
+        levels.actinic_direct[i - 1] = levels.actinic_direct[i] * trans;
+      }
+
+      // Layer reflectance and transmittance (Eddington approximation)
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        double tau_s = scratch.tau[i];
+        double omega_s = scratch.omega[i];
+        double g_s = scratch.g[i];
+
+        if (tau_s < 1e-10 || omega_s < 1e-10)
+        {
+          // Negligible optical depth or pure absorption
+          scratch.reflectance[i] = 0.0;
+          scratch.transmittance[i] = std::exp(-tau_s / mu0);
+        }
+        else
+        {
+          // Two-stream coefficients
+          double gamma1 = (7.0 - omega_s * (4.0 + 3.0 * g_s)) / 4.0;
+          double gamma2 = -(1.0 - omega_s * (4.0 - 3.0 * g_s)) / 4.0;
+
+          // Lambda and Gamma parameters (lambda -> 0 for conservative
+          // scattering, where rounding can make the radicand slightly negative)
+          double lambda = std::sqrt(std::max(gamma1 * gamma1 - gamma2 * gamma2, 0.0));
+          double Gamma = gamma2 / (gamma1 + lambda);
+
+          double exp_minus = std::exp(-lambda * tau_s);
+          double denom = (1.0 - Gamma * Gamma * exp_minus * exp_minus);
+          if (std::abs(denom) < 1e-30)
+          {
+            denom = 1e-30;
+          }
+
+          scratch.reflectance[i] = Gamma * (1.0 - exp_minus * exp_minus) / denom;
+          scratch.transmittance[i] = (1.0 - Gamma * Gamma) * exp_minus / denom;
+        }
+      }
+
+      for (std::size_t i = 0; i <= n; ++i)
+      {
+        levels.diffuse_down[i] = 0.0;
+      }
+
+      // Surface boundary: reflected direct beam
+      double direct_surface = levels.direct[0];
+      levels.diffuse_up[0] = albedo * (direct_surface + levels.diffuse_down[0]);
+
+      // Propagate diffuse upward
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        levels.diffuse_up[i + 1] =
+            levels.diffuse_up[i] * scratch.transmittance[i] + scratch.reflectance[i] * levels.diffuse_down[i + 1];
+      }
+
+      // Single scattering contribution to diffuse
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        double direct_avg = 0.5 * (levels.direct[i] + levels.direct[i + 1]) / mu0;
+        double scatter_source = scratch.omega[i] * direct_avg * scratch.tau[i];
+
+        // Add to diffuse down at bottom of layer, diffuse up at top of layer
+        levels.diffuse_down[i] += 0.5 * scatter_source * (1.0 - scratch.g[i]);
+        levels.diffuse_up[i + 1] += 0.5 * scatter_source * (1.0 + scratch.g[i]);
+      }
+
+      // Recalculate surface reflection with updated diffuse_down
+      levels.diffuse_up[0] = albedo * (direct_surface / mu0 + levels.diffuse_down[0]);
+
+      // Actinic flux: F_actinic ≈ 2 * (F_up + F_down) for isotropic radiation
+      for (std::size_t i = 0; i <= n; ++i)
+      {
+        levels.actinic_diffuse[i] = 2.0 * (levels.diffuse_up[i] + levels.diffuse_down[i]);
+      }
+    }
+  }  // namespace detail
+}  // namespace tuvx
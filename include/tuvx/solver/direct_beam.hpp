@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include <tuvx/solver/solver.hpp>
+
+namespace tuvx
+{
+  /// @brief Direct-beam-only radiative transfer solver
+  ///
+  /// Attenuates the solar beam by the Beer-Lambert law along the slant path
+  /// and leaves every diffuse component zero. It is exact in a purely
+  /// absorbing atmosphere and a cheap lower bound elsewhere: one exponential
+  /// per layer and wavelength, against the reflectance, transmittance and
+  /// scattering terms of DeltaEddingtonSolver. Its direct components equal
+  /// DeltaEddingtonSolver's bit for bit. PcaSolver uses it as the fast model
+  /// its principal-component corrections are applied to.
+  class DirectBeamSolver : public Solver
+  {
+   public:
+    DirectBeamSolver() = default;
+
+    std::string Name() const override
+    {
+      return "direct_beam";
+    }
+
+    std::unique_ptr<Solver> Clone() const override
+    {
+      return std::make_unique<DirectBeamSolver>(*this);
+    }
+
+    RadiationField Solve(const SolverInput& input) const override
+    {
+      RadiationField field;
+      SolveInto(input, field);
+      return field;
+    }
+
+    void SolveInto(const SolverInput& input, RadiationField& field) const override
+    {
+      if (!input.radiator_state || input.radiator_state->Empty())
+      {
+        field = RadiationField{};
+        return;
+      }
+      const RadiatorState& state = *input.radiator_state;
+      std::size_t n_layers = state.NumberOfLayers();
+      std::size_t n_wavelengths = state.NumberOfWavelengths();
+      field.Initialize(n_layers + 1, n_wavelengths);
+
+      double mu0 = input.mu0();
+      if (mu0 <= 0.0)
+      {
+        // Night time - no radiation
+        return;
+      }
+
+      for (std::size_t j = 0; j < n_wavelengths; ++j)
+      {
+        double flux_toa = 1.0;
+        if (input.extraterrestrial_flux && j < input.extraterrestrial_flux->size())
+        {
+          flux_toa = (*input.extraterrestrial_flux)[j];
+        }
+        field.direct_irradiance[n_layers][j] = flux_toa * mu0;
+        field.actinic_flux_direct[n_layers][j] = flux_toa;
+      }
+
+      // Attenuate level by level from the top, all wavelengths at once. Only the
+      // delta-scaled optical depth of detail::DeltaScale() is needed.
+      for (std::size_t i = n_layers; i > 0; --i)
+      {
+        std::size_t layer = i - 1;
+        const double* tau = state.optical_depth[layer].data();
+        const double* omega = state.single_scattering_albedo[layer].data();
+        const double* g = state.asymmetry_factor[layer].data();
+        const double* direct_above = field.direct_irradiance[i].data();
+        const double* actinic_above = field.actinic_flux_direct[i].data();
+        double* direct = field.direct_irradiance[i - 1].data();
+        double* actinic = field.actinic_flux_direct[i - 1].data();
+        double slant = input.geometry ? input.geometry->enhancement_factor[layer] : 1.0 / mu0;
+        for (std::size_t j = 0; j < n_wavelengths; ++j)
+        {
+          double f = g[j] * g[j];
+          double tau_scaled = tau[j] * (1.0 - omega[j] * f);
+          double trans = std::exp(-(tau_scaled * slant));
+          direct[j] = direct_above[j] * trans;
+          actinic[j] = actinic_above[j] * trans;
+        }
+      }
+    }
+  };
+
+}  // namespace tuvx
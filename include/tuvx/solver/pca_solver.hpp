@@ -0,0 +1,760 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <tuvx/solver/delta_eddington.hpp>
+#include <tuvx/solver/direct_beam.hpp>
+#include <tuvx/solver/solver.hpp>
+#include <tuvx/util/internal_error.hpp>
+
+namespace tuvx
+{
+  /// @brief Options for PcaSolver
+  struct PcaSolverConfig
+  {
+    /// Wavelengths of similar column optical depth grouped into one spectral bin
+    std::size_t bin_size{ 20 };
+
+    /// Principal components the correction follows in each bin
+    std::size_t n_components{ 2 };
+
+    /// Fit the correction to second order in each component (two accurate
+    /// solves per component) rather than first order (one)
+    bool second_order{ true };
+
+    /// Orthogonal-iteration steps for the leading components
+    std::size_t iterations{ 30 };
+  };
+
+  namespace detail
+  {
+    /// @brief Dot product with four independent partial sums
+    inline double Dot(const double* a, const double* b, std::size_t n)
+    {
+      double sums[4] = { 0.0, 0.0, 0.0, 0.0 };
+      std::size_t i = 0;
+      for (; i + 4 <= n; i += 4)
+      {
+        sums[0] += a[i] * b[i];
+        sums[1] += a[i + 1] * b[i + 1];
+        sums[2] += a[i + 2] * b[i + 2];
+        sums[3] += a[i + 3] * b[i + 3];
+      }
+      for (; i < n; ++i)
+      {
+        sums[0] += a[i] * b[i];
+      }
+      return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+    }
+
+    /// @brief Buffers for LeadingEigenvectors(), reused from one call to the next
+    struct EigenScratch
+    {
+      /// Eigenvalue estimates by decreasing value
+      std::vector<double> values{};
+
+      /// Eigenvector estimates, one row of the matrix order per eigenvalue
+      std::vector<double> vectors{};
+
+      std::vector<double> previous{};
+      std::vector<double> product{};
+      std::vector<std::size_t> order{};
+    };
+
+    /// @brief Leading eigenvectors of a symmetric matrix by orthogonal iteration
+    /// @param matrix Row-major n x n symmetric positive semi-definite matrix
+    /// @param n Matrix order
+    /// @param k Number of eigenvectors wanted
+    /// @param iterations Largest number of iteration steps
+    /// @param scratch Receives the eigenvalues and orthonormal eigenvectors,
+    ///        by decreasing eigenvalue; directions with no weight are dropped
+    /// @return Number of eigenvectors found
+    inline std::size_t LeadingEigenvectors(
+        const double* matrix,
+        std::size_t n,
+        std::size_t k,
+        std::size_t iterations,
+        EigenScratch& scratch)
+    {
+      std::vector<double>& basis = scratch.vectors;
+      scratch.values.clear();
+      auto multiply = [&](const double* v, double* result)
+      {
+        std::fill(result, result + n, 0.0);
+        for (std::size_t c = 0; c < n; ++c)
+        {
+          const double* column = matrix + c * n;
+          for (std::size_t r = 0; r < n; ++r)
+          {
+            result[r] += column[r] * v[c];
+          }
+        }
+      };
+
+      double trace = 0.0;
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        trace += matrix[i * n + i];
+      }
+      if (trace <= 0.0 || k == 0)
+      {
+        return 0;
+      }
+
+      // Start from the columns with the largest diagonal entries
+      std::vector<std::size_t>& order = scratch.order;
+      order.resize(n);
+      std::iota(order.begin(), order.end(), std::size_t{ 0 });
+      std::sort(
+          order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return matrix[a * n + a] > matrix[b * n + b]; });
+      std::size_t count = std::min(k, n);
+      basis.resize(count * n);
+      for (std::size_t m = 0; m < count; ++m)
+      {
+        std::copy_n(matrix + order[m] * n, n, basis.data() + m * n);
+      }
+
+      // Gram-Schmidt, dropping vectors that are (nearly) dependent on earlier ones
+      auto orthonormalize = [&](std::size_t rows)
+      {
+        std::size_t kept = 0;
+        for (std::size_t m = 0; m < rows; ++m)
+        {
+          double* v = basis.data() + m * n;
+          double initial = std::sqrt(Dot(v, v, n));
+          for (std::size_t u = 0; u < kept; ++u)
+          {
+            const double* w = basis.data() + u * n;
+            double projection = Dot(w, v, n);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+              v[i] -= projection * w[i];
+            }
+          }
+          double norm = std::sqrt(Dot(v, v, n));
+          if (norm > 1.0e-10 * initial && norm > 0.0)
+          {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+              v[i] /= norm;
+            }
+            if (kept != m)
+            {
+              std::copy_n(v, n, basis.data() + kept * n);
+            }
+            ++kept;
+          }
+        }
+        return kept;
+      };
+
+      count = orthonormalize(count);
+      for (std::size_t step = 0; step < iterations && count > 0; ++step)
+      {
+        scratch.previous.assign(basis.begin(), basis.begin() + static_cast<std::ptrdiff_t>(count * n));
+        for (std::size_t m = 0; m < count; ++m)
+        {
+          multiply(scratch.previous.data() + m * n, basis.data() + m * n);
+        }
+        std::size_t kept = orthonormalize(count);
+        double change = kept == count ? 0.0 : 1.0;
+        for (std::size_t i = 0; i < kept * n && change < 1.0e-8; ++i)
+        {
+          change = std::max(change, std::abs(basis[i] - scratch.previous[i]));
+        }
+        count = kept;
+        if (change < 1.0e-8)
+        {
+          break;
+        }
+      }
+
+      // Rayleigh quotients, kept rows moved to the front and ordered by insertion
+      scratch.product.resize(n);
+      std::size_t found = 0;
+      for (std::size_t m = 0; m < count; ++m)
+      {
+        double* v = basis.data() + m * n;
+        multiply(v, scratch.product.data());
+        double eigenvalue = Dot(v, scratch.product.data(), n);
+        if (eigenvalue <= 1.0e-12 * trace)
+        {
+          continue;
+        }
+        if (found != m)
+        {
+          std::copy_n(v, n, basis.data() + found * n);
+        }
+        scratch.values.push_back(eigenvalue);
+        for (std::size_t at = found; at > 0 && scratch.values[at - 1] < scratch.values[at]; --at)
+        {
+          std::swap(scratch.values[at - 1], scratch.values[at]);
+          std::swap_ranges(basis.data() + (at - 1) * n, basis.data() + at * n, basis.data() + at * n);
+        }
+        ++found;
+      }
+      return found;
+    }
+  }  // namespace detail
+
+  /// @brief Principal-component accelerated radiative transfer
+  ///
+  /// Wavelengths with similar optical properties have similar radiation
+  /// fields, so the difference between an accurate and a fast solution
+  /// varies smoothly over a group of them. Following the PCA method of
+  /// Natraj et al. (2005) and Kopparla et al. (2016), the wavelengths are
+  /// sorted by column optical depth and cut into bins of
+  /// PcaSolverConfig::bin_size, so a bin gathers wavelengths of similar
+  /// opacity wherever they fall in the spectrum. Each wavelength is
+  /// described by the ln τ, ω and g of every layer plus the surface albedo.
+  /// The leading principal components of those vectors are found, and the
+  /// accurate solver runs only at the bin's mean optical state and at the
+  /// mean displaced by ±σ along each component, σ being the standard
+  /// deviation of its scores. A feature that would leave the range the bin
+  /// spans moves only as far as it can both ways, so the two displaced
+  /// states are mirror images about the mean and the central differences
+  /// are symmetric. The fast solver runs at those states
+  /// and at every wavelength. At each level, the accurate excess over the
+  /// fast solution, relative to the fast one, is fitted as a polynomial in
+  /// the component scores p_k and added back at every wavelength:
+  ///
+  ///   F(λ) = F_fast(λ) + R(λ) (c0 + Σ_k a_k p_k(λ) + b_k p_k(λ)²)
+  ///
+  /// R is the fast total actinic flux for the actinic flux and the fast
+  /// downwelling irradiance for both irradiances. The direct components are
+  /// the fast solver's.
+  ///
+  /// The accurate model defaults to DeltaEddingtonSolver and the fast one to
+  /// DirectBeamSolver, whose direct beam matches it exactly, so only the
+  /// diffuse part is approximated. With 20 wavelengths per bin and two
+  /// components the accurate solver runs 5 times per bin instead of 20.
+  /// Bins too small to save solves are solved accurately at every
+  /// wavelength. Any pair of solvers can be plugged in; the gain grows with
+  /// the cost of the accurate one.
+  ///
+  /// Working buffers are kept in the solver and reused, so repeated solves
+  /// of the same shape do not allocate. A solver used from several threads
+  /// at once stays correct: a call that finds the buffers busy uses
+  /// temporary ones. Copies start with empty buffers.
+  class PcaSolver : public Solver
+  {
+   public:
+    /// @brief Construct with the default accurate and fast solvers
+    /// @param config Bin and component options
+    /// @throws std::invalid_argument if the bin size is zero
+    explicit PcaSolver(PcaSolverConfig config = {})
+        : PcaSolver(config, std::make_unique<DeltaEddingtonSolver>(), std::make_unique<DirectBeamSolver>())
+    {
+    }
+
+    /// @brief Construct with explicit solvers
+    /// @param config Bin and component options
+    /// @param accurate Solver run at the principal-component states
+    /// @param fast Solver run at every wavelength
+    /// @throws std::invalid_argument if the bin size is zero or a solver is missing
+    PcaSolver(PcaSolverConfig config, std::unique_ptr<Solver> accurate, std::unique_ptr<Solver> fast)
+        : config_(config),
+          accurate_(std::move(accurate)),
+          fast_(std::move(fast))
+    {
+      if (config_.bin_size == 0 || !accurate_ || !fast_)
+      {
+        TUVX_THROW(std::invalid_argument("PcaSolver needs a positive bin size and both solvers"));
+      }
+    }
+
+    PcaSolver(const PcaSolver& other)
+        : Solver(other),
+          config_(other.config_),
+          accurate_(other.accurate_->Clone()),
+          fast_(other.fast_->Clone())
+    {
+    }
+
+    PcaSolver& operator=(const PcaSolver& other)
+    {
+      if (this != &other)
+      {
+        config_ = other.config_;
+        accurate_ = other.accurate_->Clone();
+        fast_ = other.fast_->Clone();
+      }
+      return *this;
+    }
+
+    std::string Name() const override
+    {
+      return "pca_" + accurate_->Name();
+    }
+
+    std::unique_ptr<Solver> Clone() const override
+    {
+      return std::make_unique<PcaSolver>(*this);
+    }
+
+    bool CanHandle(double sza) const override
+    {
+      return accurate_->CanHandle(sza) && fast_->CanHandle(sza);
+    }
+
+    const PcaSolverConfig& Config() const
+    {
+      return config_;
+    }
+
+    /// @brief Accurate-solver wavelengths per column for a spectral grid size
+    /// @param n_wavelengths Number of wavelengths in the radiator state
+    /// @return Upper bound; bins whose optical states vary in fewer directions need fewer
+    std::size_t AccurateSolves(std::size_t n_wavelengths) const
+    {
+      std::size_t total = 0;
+      for (std::size_t b = 0; b < NumberOfBins(n_wavelengths); ++b)
+      {
+        total += BinSolves(BinStart(b + 1, n_wavelengths) - BinStart(b, n_wavelengths));
+      }
+      return total;
+    }
+
+    /// @brief Number of spectral bins for a spectral grid size
+    std::size_t NumberOfBins(std::size_t n_wavelengths) const
+    {
+      return (n_wavelengths + config_.bin_size - 1) / config_.bin_size;
+    }
+
+    RadiationField Solve(const SolverInput& input) const override
+    {
+      RadiationField field;
+      SolveInto(input, field);
+      return field;
+    }
+
+    void SolveInto(const SolverInput& input, RadiationField& field) const override
+    {
+      fast_->SolveInto(input, field);
+      if (field.Empty() || input.mu0() <= 0.0)
+      {
+        return;
+      }
+      std::unique_lock lock(scratch_mutex_, std::try_to_lock);
+      if (lock.owns_lock())
+      {
+        Correct(input, field, scratch_);
+        return;
+      }
+      Scratch scratch;
+      Correct(input, field, scratch);
+    }
+
+   private:
+    /// Floor on the optical depth before taking its logarithm
+    static constexpr double kMinOpticalDepth = 1.0e-30;
+
+    /// @brief A run of Scratch::order sharing one set of principal components
+    struct Bin
+    {
+      std::size_t first;
+      std::size_t last;
+      std::size_t first_state;
+      std::size_t n_components;
+      bool exact;
+    };
+
+    /// @brief Working buffers of one solve
+    struct Scratch
+    {
+      std::vector<std::size_t> order{};         // Wavelengths by increasing column optical depth
+      std::vector<double> column_depth{};       // [wavelength]
+      std::vector<Bin> bins{};
+      std::vector<double> steps{};              // [bin][component] score standard deviation
+      std::vector<double> scores{};             // [component][wavelength]
+      std::vector<double> features{};           // [wavelength in bin][feature]
+      std::vector<std::size_t> active{};        // Features that vary within the bin
+      std::vector<double> centred{};            // [wavelength in bin][active feature]
+      std::vector<double> direction{};          // [active feature]
+      std::vector<double> mean{};
+      std::vector<double> lower{};
+      std::vector<double> upper{};
+      std::vector<double> gram{};
+      detail::EigenScratch eigen{};
+      std::vector<double> state_features{};     // [synthetic state][feature]
+      std::vector<std::size_t> state_source{};  // Wavelength, or n_wavelengths + synthetic state
+      RadiatorState states{};
+      std::vector<double> state_albedo{};
+      std::vector<double> state_flux{};
+      RadiationField accurate{};
+      RadiationField fast{};
+      SolverWorkspace accurate_workspace{};
+      SolverWorkspace fast_workspace{};
+      std::vector<double> center{};
+      std::vector<double> plus{};
+      std::vector<double> minus{};
+      std::vector<double> linear{};             // [component][quantity and level]
+      std::vector<double> quadratic{};          // [component][quantity and level]
+    };
+
+    /// First position in the sorted order of bin b; bins split it as evenly as possible
+    std::size_t BinStart(std::size_t b, std::size_t n_wavelengths) const
+    {
+      std::size_t n_bins = NumberOfBins(n_wavelengths);
+      return n_bins == 0 ? 0 : b * n_wavelengths / n_bins;
+    }
+
+    /// Accurate solves for a bin of n wavelengths
+    std::size_t BinSolves(std::size_t n) const
+    {
+      std::size_t solves = 1 + config_.n_components * (config_.second_order ? 2 : 1);
+      return solves < n ? solves : n;
+    }
+
+    /// @brief Replace the fast solution's diffuse components with the fitted accurate ones
+    /// @param input Column input; the sun is above the horizon
+    /// @param field Fast solution of the column, corrected in place
+    /// @param s Working buffers
+    void Correct(const SolverInput& input, RadiationField& field, Scratch& s) const
+    {
+      const RadiatorState& state = *input.radiator_state;
+      const std::size_t n_layers = state.NumberOfLayers();
+      const std::size_t n_levels = n_layers + 1;
+      const std::size_t n_wavelengths = state.NumberOfWavelengths();
+      const std::size_t n_features = 3 * n_layers + 1;
+      const std::size_t n_excess = 3 * n_levels;
+      const std::size_t max_components = config_.n_components;
+      auto albedo_at = [&](std::size_t j)
+      { return input.surface_albedo && j < input.surface_albedo->size() ? (*input.surface_albedo)[j] : 0.0; };
+      auto flux_at = [&](std::size_t j)
+      {
+        return input.extraterrestrial_flux && j < input.extraterrestrial_flux->size() ? (*input.extraterrestrial_flux)[j]
+                                                                                      : 1.0;
+      };
+
+      // Cluster by opacity: bins are runs of the wavelengths sorted by column optical depth
+      s.column_depth.assign(n_wavelengths, 0.0);
+      for (std::size_t i = 0; i < n_layers; ++i)
+      {
+        const double* tau = state.optical_depth[i].data();
+        for (std::size_t j = 0; j < n_wavelengths; ++j)
+        {
+          s.column_depth[j] += tau[j];
+        }
+      }
+      s.order.resize(n_wavelengths);
+      std::iota(s.order.begin(), s.order.end(), std::size_t{ 0 });
+      std::sort(
+          s.order.begin(),
+          s.order.end(),
+          [&](std::size_t a, std::size_t b)
+          { return s.column_depth[a] != s.column_depth[b] ? s.column_depth[a] < s.column_depth[b] : a < b; });
+
+      // Plan every bin and collect the optical states the accurate solver runs at
+      const std::size_t n_bins = NumberOfBins(n_wavelengths);
+      s.bins.clear();
+      s.steps.resize(n_bins * max_components);
+      s.scores.resize(max_components * n_wavelengths);
+      s.state_features.clear();
+      s.state_source.clear();
+      s.mean.resize(n_features);
+      s.lower.resize(n_features);
+      s.upper.resize(n_features);
+      for (std::size_t b = 0; b < n_bins; ++b)
+      {
+        Bin bin{ BinStart(b, n_wavelengths), BinStart(b + 1, n_wavelengths), s.state_source.size(), 0, false };
+        const std::size_t n = bin.last - bin.first;
+        const std::size_t* members = s.order.data() + bin.first;
+        if (BinSolves(n) == n)
+        {
+          // Nothing to save: solve every wavelength accurately
+          bin.exact = true;
+          s.state_source.insert(s.state_source.end(), members, members + n);
+          s.bins.push_back(bin);
+          continue;
+        }
+
+        // ln τ, ω and g of each layer, then the surface albedo: [wavelength in bin][feature]
+        s.features.resize(n * n_features);
+        for (std::size_t i = 0; i < n_layers; ++i)
+        {
+          const double* tau = state.optical_depth[i].data();
+          const double* omega = state.single_scattering_albedo[i].data();
+          const double* g = state.asymmetry_factor[i].data();
+          for (std::size_t w = 0; w < n; ++w)
+          {
+            double* x = s.features.data() + w * n_features;
+            x[i] = std::log(std::max(tau[members[w]], kMinOpticalDepth));
+            x[n_layers + i] = omega[members[w]];
+            x[2 * n_layers + i] = g[members[w]];
+          }
+        }
+        for (std::size_t w = 0; w < n; ++w)
+        {
+          s.features[w * n_features + 3 * n_layers] = albedo_at(members[w]);
+        }
+        std::copy_n(s.features.begin(), n_features, s.mean.begin());
+        std::copy_n(s.features.begin(), n_features, s.lower.begin());
+        std::copy_n(s.features.begin(), n_features, s.upper.begin());
+        for (std::size_t w = 1; w < n; ++w)
+        {
+          const double* x = s.features.data() + w * n_features;
+          for (std::size_t d = 0; d < n_features; ++d)
+          {
+            s.mean[d] += x[d];
+            s.lower[d] = std::min(s.lower[d], x[d]);
+            s.upper[d] = std::max(s.upper[d], x[d]);
+          }
+        }
+        for (double& value : s.mean)
+        {
+          value /= static_cast<double>(n);
+        }
+
+        // Centre the features that vary within the bin; the rest stay at the mean
+        s.active.clear();
+        for (std::size_t d = 0; d < n_features; ++d)
+        {
+          if (s.upper[d] > s.lower[d])
+          {
+            s.active.push_back(d);
+          }
+        }
+        const std::size_t n_active = s.active.size();
+        s.centred.resize(n * n_active);
+        for (std::size_t w = 0; w < n; ++w)
+        {
+          const double* x = s.features.data() + w * n_features;
+          double* y = s.centred.data() + w * n_active;
+          for (std::size_t m = 0; m < n_active; ++m)
+          {
+            y[m] = x[s.active[m]] - s.mean[s.active[m]];
+          }
+        }
+
+        // Principal components from the n x n Gram matrix of the centred features
+        s.gram.resize(n * n);
+        for (std::size_t a = 0; a < n; ++a)
+        {
+          for (std::size_t c = 0; c <= a; ++c)
+          {
+            double sum = detail::Dot(s.centred.data() + a * n_active, s.centred.data() + c * n_active, n_active);
+            s.gram[a * n + c] = sum;
+            s.gram[c * n + a] = sum;
+          }
+        }
+        bin.n_components = detail::LeadingEigenvectors(s.gram.data(), n, max_components, config_.iterations, s.eigen);
+
+        // Mean state, then the states displaced symmetrically along each component
+        auto add_state = [&](double step)
+        {
+          std::size_t row = s.state_features.size();
+          s.state_features.insert(s.state_features.end(), s.mean.begin(), s.mean.end());
+          double* x = s.state_features.data() + row;
+          for (std::size_t m = 0; m < n_active; ++m)
+          {
+            std::size_t d = s.active[m];
+            // A feature that would leave the bin's range moves as far as it can
+            // both ways, so the + and - states stay mirror images about the mean
+            double reach = std::min(s.upper[d] - s.mean[d], s.mean[d] - s.lower[d]);
+            x[d] = s.mean[d] + std::clamp(step * s.direction[m], -reach, reach);
+          }
+          s.state_source.push_back(n_wavelengths + row / n_features);
+        };
+        s.direction.assign(n_active, 0.0);
+        add_state(0.0);
+        for (std::size_t k = 0; k < bin.n_components; ++k)
+        {
+          double root = std::sqrt(s.eigen.values[k]);
+          const double* vector = s.eigen.vectors.data() + k * n;
+          std::fill(s.direction.begin(), s.direction.end(), 0.0);
+          for (std::size_t w = 0; w < n; ++w)
+          {
+            const double* y = s.centred.data() + w * n_active;
+            double weight = vector[w] / root;
+            for (std::size_t m = 0; m < n_active; ++m)
+            {
+              s.direction[m] += weight * y[m];
+            }
+          }
+
+          // Displace by one standard deviation of the scores
+          double step = root / std::sqrt(static_cast<double>(n));
+          s.steps[b * max_components + k] = step;
+          for (std::size_t w = 0; w < n; ++w)
+          {
+            s.scores[k * n_wavelengths + members[w]] = root * vector[w];
+          }
+          add_state(step);
+          if (config_.second_order)
+          {
+            add_state(-step);
+          }
+        }
+        s.bins.push_back(bin);
+      }
+
+      // Optical states as one radiator state; exact columns keep the real flux
+      const std::size_t n_states = s.state_source.size();
+      s.states.Initialize(n_layers, n_states);
+      s.state_albedo.resize(n_states);
+      s.state_flux.resize(n_states);
+      for (std::size_t q = 0; q < n_states; ++q)
+      {
+        std::size_t j = s.state_source[q];
+        if (j < n_wavelengths)
+        {
+          for (std::size_t i = 0; i < n_layers; ++i)
+          {
+            s.states.optical_depth[i][q] = state.optical_depth[i][j];
+            s.states.single_scattering_albedo[i][q] = state.single_scattering_albedo[i][j];
+            s.states.asymmetry_factor[i][q] = state.asymmetry_factor[i][j];
+          }
+          s.state_albedo[q] = albedo_at(j);
+          s.state_flux[q] = flux_at(j);
+          continue;
+        }
+        const double* x = s.state_features.data() + (j - n_wavelengths) * n_features;
+        for (std::size_t i = 0; i < n_layers; ++i)
+        {
+          s.states.optical_depth[i][q] = std::exp(x[i]);
+          s.states.single_scattering_albedo[i][q] = x[n_layers + i];
+          s.states.asymmetry_factor[i][q] = x[2 * n_layers + i];
+        }
+        s.state_albedo[q] = x[3 * n_layers];
+        s.state_flux[q] = 1.0;
+      }
+
+      SolverInput state_input = input;
+      state_input.radiator_state = &s.states;
+      state_input.surface_albedo = &s.state_albedo;
+      state_input.extraterrestrial_flux = &s.state_flux;
+      state_input.workspace = &s.accurate_workspace;
+      accurate_->SolveInto(state_input, s.accurate);
+      state_input.workspace = &s.fast_workspace;
+      fast_->SolveInto(state_input, s.fast);
+
+      // Excess of the accurate over the fast total actinic flux, downwelling and
+      // upwelling irradiance at state q, relative to the fast reference
+      auto excess = [](double accurate_value, double fast_value, double reference)
+      { return reference > 0.0 ? (accurate_value - fast_value) / reference : 0.0; };
+      auto state_excess = [&](std::size_t q, std::vector<double>& values)
+      {
+        const RadiationField& accurate = s.accurate;
+        const RadiationField& fast = s.fast;
+        for (std::size_t l = 0; l < n_levels; ++l)
+        {
+          double fast_actinic = fast.actinic_flux_direct[l][q] + fast.actinic_flux_diffuse[l][q];
+          double fast_down = fast.direct_irradiance[l][q] + fast.diffuse_down[l][q];
+          values[l] = excess(
+              accurate.actinic_flux_direct[l][q] + accurate.actinic_flux_diffuse[l][q], fast_actinic, fast_actinic);
+          values[n_levels + l] =
+              excess(accurate.direct_irradiance[l][q] + accurate.diffuse_down[l][q], fast_down, fast_down);
+          values[2 * n_levels + l] = excess(accurate.diffuse_up[l][q], fast.diffuse_up[l][q], fast_down);
+        }
+      };
+
+      s.center.resize(n_excess);
+      s.plus.resize(n_excess);
+      s.minus.resize(n_excess);
+      s.linear.resize(max_components * n_excess);
+      s.quadratic.resize(max_components * n_excess);
+      for (std::size_t b = 0; b < n_bins; ++b)
+      {
+        const Bin& bin = s.bins[b];
+        const std::size_t n = bin.last - bin.first;
+        const std::size_t* members = s.order.data() + bin.first;
+        if (bin.exact)
+        {
+          for (std::size_t l = 0; l < n_levels; ++l)
+          {
+            for (std::size_t w = 0; w < n; ++w)
+            {
+              std::size_t j = members[w];
+              std::size_t q = bin.first_state + w;
+              field.direct_irradiance[l][j] = s.accurate.direct_irradiance[l][q];
+              field.diffuse_down[l][j] = s.accurate.diffuse_down[l][q];
+              field.diffuse_up[l][j] = s.accurate.diffuse_up[l][q];
+              field.actinic_flux_direct[l][j] = s.accurate.actinic_flux_direct[l][q];
+              field.actinic_flux_diffuse[l][j] = s.accurate.actinic_flux_diffuse[l][q];
+            }
+          }
+          continue;
+        }
+
+        // Polynomial coefficients of the excess in each component score
+        const std::size_t states_per_component = config_.second_order ? 2 : 1;
+        state_excess(bin.first_state, s.center);
+        for (std::size_t k = 0; k < bin.n_components; ++k)
+        {
+          std::size_t q = bin.first_state + 1 + k * states_per_component;
+          state_excess(q, s.plus);
+          double h = s.steps[b * max_components + k];
+          double* a = s.linear.data() + k * n_excess;
+          double* c = s.quadratic.data() + k * n_excess;
+          if (config_.second_order)
+          {
+            state_excess(q + 1, s.minus);
+            for (std::size_t e = 0; e < n_excess; ++e)
+            {
+              a[e] = (s.plus[e] - s.minus[e]) / (2.0 * h);
+              c[e] = (s.plus[e] - 2.0 * s.center[e] + s.minus[e]) / (2.0 * h * h);
+            }
+          }
+          else
+          {
+            for (std::size_t e = 0; e < n_excess; ++e)
+            {
+              a[e] = (s.plus[e] - s.center[e]) / h;
+              c[e] = 0.0;
+            }
+          }
+        }
+
+        // Correct the fast solution at every wavelength of the bin
+        for (std::size_t l = 0; l < n_levels; ++l)
+        {
+          const double* direct = field.direct_irradiance[l].data();
+          const double* actinic_direct = field.actinic_flux_direct[l].data();
+          double* down = field.diffuse_down[l].data();
+          double* up = field.diffuse_up[l].data();
+          double* actinic_diffuse = field.actinic_flux_diffuse[l].data();
+          for (std::size_t w = 0; w < n; ++w)
+          {
+            std::size_t j = members[w];
+            double actinic_excess = s.center[l];
+            double down_excess = s.center[n_levels + l];
+            double up_excess = s.center[2 * n_levels + l];
+            for (std::size_t k = 0; k < bin.n_components; ++k)
+            {
+              double p = s.scores[k * n_wavelengths + j];
+              const double* a = s.linear.data() + k * n_excess;
+              const double* c = s.quadratic.data() + k * n_excess;
+              actinic_excess += p * (a[l] + p * c[l]);
+              down_excess += p * (a[n_levels + l] + p * c[n_levels + l]);
+              up_excess += p * (a[2 * n_levels + l] + p * c[2 * n_levels + l]);
+            }
+            double fast_actinic = actinic_direct[j] + actinic_diffuse[j];
+            double fast_down = direct[j] + down[j];
+            actinic_diffuse[j] += fast_actinic * actinic_excess;
+            down[j] += fast_down * down_excess;
+            up[j] += fast_down * up_excess;
+          }
+        }
+      }
+    }
+
+    PcaSolverConfig config_;
+    std::unique_ptr<Solver> accurate_;
+    std::unique_ptr<Solver> fast_;
+
+    /// Guards scratch_; a call that finds it held uses its own buffers
+    mutable std::mutex scratch_mutex_;
+    mutable Scratch scratch_;
+  };
+
+}  // namespace tuvx
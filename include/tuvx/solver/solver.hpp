@@ -1,15 +1,35 @@
 #pragma once
 
+#include <cstddef>
 #include <memory>
+#include <span>
 #include <string>
+#include <vector>
 
 #include <tuvx/radiation_field/radiation_field.hpp>
 #include <tuvx/radiator/radiator_state.hpp>
 #include <tuvx/spherical_geometry/spherical_geometry.hpp>
 #include <tuvx/surface/surface_albedo.hpp>
+#include <tuvx/util/internal_error.hpp>
 
 namespace tuvx
 {
+  /// @brief Scratch memory a caller keeps from one solve to the next
+  ///
+  /// Solvers size the buffers on first use; later solves of the same shape
+  /// reuse them without allocating.
+  struct SolverWorkspace
+  {
+    /// Per-wavelength column values (optical properties, elimination terms, level results)
+    std::vector<double> values{};
+
+    /// Slant path factors of each solved column
+    std::vector<double> slant_factors{};
+
+    /// Columns with the sun above the horizon
+    std::vector<std::size_t> active{};
+  };
+
   /// @brief Input parameters for radiative transfer calculation
   struct SolverInput
   {
@@ -28,6 +48,10 @@ namespace tuvx
     /// Solar zenith angle [degrees]
     double solar_zenith_angle{ 0.0 };
 
+    /// Scratch memory kept by the caller between solves (optional); solvers
+    /// that need scratch memory use it instead of allocating their own
+    SolverWorkspace* workspace{ nullptr };
+
     /// Cosine of solar zenith angle
     double mu0() const
     {
@@ -56,6 +80,37 @@ namespace tuvx
     /// @return Computed radiation field at all levels and wavelengths
     virtual RadiationField Solve(const SolverInput& input) const = 0;
 
+    /// @brief Solve radiative transfer into an existing field
+    /// @param input Input parameters (optical properties, geometry, boundary conditions)
+    /// @param field Field to overwrite; its storage is reused when the shape is unchanged
+    ///
+    /// The default assigns the result of Solve(). Solvers that write the field
+    /// in place override both; the model calls this one.
+    virtual void SolveInto(const SolverInput& input, RadiationField& field) const
+    {
+      field = Solve(input);
+    }
+
+    /// @brief Solve several independent columns in one call
+    /// @param inputs Input parameters for each column
+    /// @param fields Fields to overwrite, one per input
+    /// @throws TuvxInternalException if the spans differ in size
+    ///
+    /// The default calls SolveInto() for each column. Solvers override it to
+    /// share setup and workspaces across columns; every field must equal what
+    /// SolveInto() gives for its input.
+    virtual void SolveBatch(std::span<const SolverInput> inputs, std::span<RadiationField> fields) const
+    {
+      if (inputs.size() != fields.size())
+      {
+        TUVX_INTERNAL_ERROR("SolveBatch() needs one field per input");
+      }
+      for (std::size_t i = 0; i < inputs.size(); ++i)
+      {
+        SolveInto(inputs[i], fields[i]);
+      }
+    }
+
     /// @brief Check if solver can handle given solar zenith angle
     /// @param sza Solar zenith angle [degrees]
     /// @return True if solver can compute for this SZA
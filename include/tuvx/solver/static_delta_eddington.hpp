@@ -0,0 +1,159 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <tuvx/solver/delta_eddington_kernel.hpp>
+#include <tuvx/solver/solver.hpp>
+#include <tuvx/util/internal_error.hpp>
+
+namespace tuvx
+{
+  /// @brief Delta-Eddington solver specialized for a fixed grid shape
+  /// @tparam NL Number of altitude layers
+  /// @tparam NW Number of wavelength bins
+  ///
+  /// Runs the same column kernel as DeltaEddingtonSolver
+  /// (detail::SolveDeltaEddingtonColumn) and gives bit-identical results,
+  /// but with the layer count fixed at compile time: column workspaces are
+  /// std::array on the stack, every loop has a constant trip count, and the
+  /// albedo and flux inputs are checked once up front instead of per
+  /// wavelength. The workspaces take about 11 * NL doubles of stack.
+  ///
+  /// Solve() throws std::invalid_argument if the radiator state does not
+  /// have NL layers and NW wavelengths.
+  template<std::size_t NL, std::size_t NW>
+  class StaticDeltaEddingtonSolver : public Solver
+  {
+    static_assert(NL > 0 && NW > 0, "StaticDeltaEddingtonSolver needs at least one layer and one wavelength");
+
+   public:
+    static constexpr std::size_t kLayers = NL;
+    static constexpr std::size_t kLevels = NL + 1;
+    static constexpr std::size_t kWavelengths = NW;
+
+    StaticDeltaEddingtonSolver() = default;
+
+    std::string Name() const override
+    {
+      return "delta_eddington";
+    }
+
+    std::unique_ptr<Solver> Clone() const override
+    {
+      return std::make_unique<StaticDeltaEddingtonSolver>(*this);
+    }
+
+    RadiationField Solve(const SolverInput& input) const override
+    {
+      RadiationField field;
+      SolveInto(input, field);
+      return field;
+    }
+
+    void SolveInto(const SolverInput& input, RadiationField& field) const override
+    {
+      if (!input.radiator_state || input.radiator_state->Empty())
+      {
+        field = RadiationField{};
+        return;
+      }
+      const RadiatorState& state = *input.radiator_state;
+      if (state.NumberOfLayers() != NL || state.NumberOfWavelengths() != NW)
+      {
+        TUVX_THROW(std::invalid_argument(
+            "StaticDeltaEddingtonSolver<" + std::to_string(NL) + ", " + std::to_string(NW) + "> given " +
+            std::to_string(state.NumberOfLayers()) + " layers and " + std::to_string(state.NumberOfWavelengths()) +
+            " wavelengths"));
+      }
+
+      field.Initialize(kLevels, NW);
+
+      double mu0 = input.mu0();
+      if (mu0 <= 0.0)
+      {
+        // Night time - no radiation
+        return;
+      }
+
+      std::array<double, NL> slant_factors;
+      slant_factors.fill(1.0 / mu0);
+      if (input.geometry)
+      {
+        if (input.geometry->enhancement_factor.size() < NL)
+        {
+          TUVX_THROW(std::invalid_argument("Slant path factors do not cover every layer"));
+        }
+        std::copy_n(input.geometry->enhancement_factor.begin(), NL, slant_factors.begin());
+      }
+
+      // Missing entries default as in DeltaEddingtonSolver
+      std::array<double, NW> albedo;
+      std::array<double, NW> flux_toa;
+      albedo.fill(0.0);
+      flux_toa.fill(1.0);
+      if (input.surface_albedo)
+      {
+        std::copy_n(input.surface_albedo->begin(), std::min(input.surface_albedo->size(), NW), albedo.begin());
+      }
+      if (input.extraterrestrial_flux)
+      {
+        std::copy_n(
+            input.extraterrestrial_flux->begin(), std::min(input.extraterrestrial_flux->size(), NW), flux_toa.begin());
+      }
+
+      std::array<double, NL> tau;
+      std::array<double, NL> omega;
+      std::array<double, NL> g;
+      std::array<double, 5 * NL> scratch_values;
+      std::array<double, 5 * kLevels> level_values;
+      detail::TwoStreamScratch scratch{ scratch_values.data(),
+                                        scratch_values.data() + NL,
+                                        scratch_values.data() + 2 * NL,
+                                        scratch_values.data() + 3 * NL,
+                                        scratch_values.data() + 4 * NL };
+      detail::TwoStreamLevels levels{ level_values.data(),
+                                      level_values.data() + kLevels,
+                                      level_values.data() + 2 * kLevels,
+                                      level_values.data() + 3 * kLevels,
+                                      level_values.data() + 4 * kLevels };
+
+      for (std::size_t j = 0; j < NW; ++j)
+      {
+        for (std::size_t i = 0; i < NL; ++i)
+        {
+          tau[i] = state.optical_depth[i][j];
+          omega[i] = state.single_scattering_albedo[i][j];
+          g[i] = state.asymmetry_factor[i][j];
+        }
+
+        detail::SolveDeltaEddingtonColumn(
+            std::integral_constant<std::size_t, NL>{},
+            tau.data(),
+            omega.data(),
+            g.data(),
+            mu0,
+            albedo[j],
+            flux_toa[j],
+            slant_factors.data(),
+            scratch,
+            levels);
+
+        for (std::size_t i = 0; i < kLevels; ++i)
+        {
+          field.direct_irradiance[i][j] = levels.direct[i];
+          field.diffuse_down[i][j] = levels.diffuse_down[i];
+          field.diffuse_up[i][j] = levels.diffuse_up[i];
+          field.actinic_flux_direct[i][j] = levels.actinic_direct[i];
+          field.actinic_flux_diffuse[i][j] = levels.actinic_diffuse[i];
+        }
+      }
+    }
+  };
+
+}  // namespace tuvx
@@ -70,12 +70,21 @@ namespace tuvx
     SlantPathResult Calculate(double solar_zenith_angle) const
     {
       SlantPathResult result;
+      CalculateInto(solar_zenith_angle, result);
+      return result;
+    }
+
+    /// @brief Calculate slant path enhancement factors into an existing result
+    /// @param solar_zenith_angle Solar zenith angle [degrees]
+    /// @param result Result to overwrite; its storage is reused when the grid is unchanged
+    void CalculateInto(double solar_zenith_angle, SlantPathResult& result) const
+    {
       result.zenith_angle = solar_zenith_angle;
 
       std::size_t n_layers = n_levels_ - 1;
       result.enhancement_factor.resize(n_layers);
       result.air_mass.resize(n_layers);
-      result.sunlit.resize(n_layers, true);
+      result.sunlit.assign(n_layers, true);
       result.screening_height = 0.0;
 
       double sza_rad = solar_zenith_angle * constants::kDegreesToRadians;
@@ -100,7 +109,7 @@ namespace tuvx
           result.air_mass[i - 1] = result.air_mass[i] + sec_sza;
         }
 
-        return result;
+        return;
       }
 
       // Spherical geometry for large SZA
@@ -153,8 +162,6 @@ namespace tuvx
         }
         result.air_mass[layer] = cumulative;
       }
-
-      return result;
     }
 
     /// @brief Get plane-parallel air mass approximation
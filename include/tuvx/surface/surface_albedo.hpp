@@ -8,6 +8,7 @@
 
 #include <tuvx/grid/grid.hpp>
 #include <tuvx/interpolation/linear_interpolator.hpp>
+#include <tuvx/util/internal_error.hpp>
 
 namespace tuvx
 {
@@ -44,11 +45,11 @@ namespace tuvx
     {
       if (wavelengths_.size() != albedo_.size())
       {
-        throw std::invalid_argument("Wavelength and albedo arrays must have same size");
+        TUVX_THROW(std::invalid_argument("Wavelength and albedo arrays must have same size"));
       }
       if (wavelengths_.size() < 2)
       {
-        throw std::invalid_argument("At least 2 wavelength points required for spectral albedo");
+        TUVX_THROW(std::invalid_argument("At least 2 wavelength points required for spectral albedo"));
       }
 
       for (double a : albedo_)
@@ -148,7 +149,7 @@ namespace tuvx
     {
       if (!is_constant_)
       {
-        throw std::runtime_error("Cannot get constant value from spectral albedo");
+        TUVX_THROW(std::runtime_error("Cannot get constant value from spectral albedo"));
       }
       return constant_albedo_;
     }
@@ -158,7 +159,7 @@ namespace tuvx
     {
       if (is_constant_)
       {
-        throw std::runtime_error("Constant albedo has no reference wavelengths");
+        TUVX_THROW(std::runtime_error("Constant albedo has no reference wavelengths"));
       }
       return wavelengths_;
     }
@@ -168,7 +169,7 @@ namespace tuvx
     {
       if (is_constant_)
       {
-        throw std::runtime_error("Constant albedo has no reference values");
+        TUVX_THROW(std::runtime_error("Constant albedo has no reference values"));
       }
       return albedo_;
     }
@@ -178,7 +179,7 @@ namespace tuvx
     {
       if (albedo < 0.0 || albedo > 1.0)
       {
-        throw std::invalid_argument("Albedo must be in range [0, 1]");
+        TUVX_THROW(std::invalid_argument("Albedo must be in range [0, 1]"));
       }
     }
 
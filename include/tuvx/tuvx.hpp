@@ -8,6 +8,13 @@
 #include <tuvx/util/constants.hpp>
 #include <tuvx/util/error.hpp>
 #include <tuvx/util/internal_error.hpp>
+#include <tuvx/util/strided_view.hpp>
+#include <tuvx/util/thread_pool.hpp>
+#include <tuvx/util/spsc_queue.hpp>
+#include <tuvx/util/numa.hpp>
+#include <tuvx/util/shared_table.hpp>
+#include <tuvx/util/reproducible_sum.hpp>
+#include <tuvx/util/hash.hpp>
 
 // Grid system headers
 #include <tuvx/grid/grid_spec.hpp>
@@ -32,12 +39,15 @@
 #include <tuvx/cross_section/cross_section_warehouse.hpp>
 #include <tuvx/cross_section/types/base.hpp>
 #include <tuvx/cross_section/types/o3.hpp>
+#include <tuvx/cross_section/types/shared.hpp>
+#include <tuvx/cross_section/types/band.hpp>
 
 // Quantum yield headers
 #include <tuvx/quantum_yield/quantum_yield.hpp>
 #include <tuvx/quantum_yield/quantum_yield_warehouse.hpp>
 #include <tuvx/quantum_yield/types/base.hpp>
 #include <tuvx/quantum_yield/types/o3_o1d.hpp>
+#include <tuvx/quantum_yield/types/shared.hpp>
 
 // Radiator headers
 #include <tuvx/radiator/radiator_state.hpp>
@@ -61,6 +71,9 @@
 // Solver headers
 #include <tuvx/solver/solver.hpp>
 #include <tuvx/solver/delta_eddington.hpp>
+#include <tuvx/solver/static_delta_eddington.hpp>
+#include <tuvx/solver/direct_beam.hpp>
+#include <tuvx/solver/pca_solver.hpp>
 
 // Photolysis rate headers
 #include <tuvx/photolysis/photolysis_rate.hpp>
@@ -69,6 +82,27 @@
 #include <tuvx/model/model_config.hpp>
 #include <tuvx/model/model_output.hpp>
 #include <tuvx/model/tuv_model.hpp>
+#include <tuvx/model/static_shape_model.hpp>
+#include <tuvx/model/column_state.hpp>
+#include <tuvx/model/result_cache.hpp>
+#include <tuvx/model/photolysis_scheduler.hpp>
+#include <tuvx/model/batch_driver.hpp>
+#include <tuvx/model/ensemble_runner.hpp>
+#include <tuvx/model/execution_plan.hpp>
+#include <tuvx/model/numa_batch_buffers.hpp>
+#include <tuvx/model/pipeline_executor.hpp>
+#include <tuvx/model/async_calculator.hpp>
+#include <tuvx/model/trace.hpp>
+#include <tuvx/model/differential_harness.hpp>
+#include <tuvx/model/band_aggregation.hpp>
+#include <tuvx/model/adaptive_wavelength_grid.hpp>
+#include <tuvx/model/pca_accuracy.hpp>
+#include <tuvx/model/two_resolution.hpp>
+
+// Photolysis service headers
+#include <tuvx/service/protocol.hpp>
+#include <tuvx/service/photolysis_server.hpp>
+#include <tuvx/service/photolysis_client.hpp>
 
 // Version information
 #include <tuvx/version.hpp>
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#include <tuvx/util/internal_error.hpp>
+
+namespace tuvx
+{
+  /// @brief Process-wide heap allocation counters
+  ///
+  /// The counters are only advanced when the counting global allocation
+  /// functions are installed with TUVX_DEFINE_COUNTING_ALLOCATOR() in exactly
+  /// one translation unit of a test or benchmark executable. The library
+  /// itself never replaces operator new.
+  struct AllocationCounters
+  {
+    /// Number of calls to operator new (all forms)
+    static inline std::atomic<std::uint64_t> allocations{ 0 };
+
+    /// Number of calls to operator delete with a non-null pointer
+    static inline std::atomic<std::uint64_t> deallocations{ 0 };
+
+    /// Total bytes requested from operator new
+    static inline std::atomic<std::uint64_t> bytes{ 0 };
+
+    /// True once the counting allocator has handled at least one request
+    static inline std::atomic<bool> installed{ false };
+
+    /// @brief Record one allocation of the given size
+    static void RecordAllocation(std::size_t size)
+    {
+      allocations.fetch_add(1, std::memory_order_relaxed);
+      bytes.fetch_add(size, std::memory_order_relaxed);
+      installed.store(true, std::memory_order_relaxed);
+    }
+
+    /// @brief Record one deallocation
+    static void RecordDeallocation()
+    {
+      deallocations.fetch_add(1, std::memory_order_relaxed);
+    }
+  };
+
+  /// @brief Allocation statistics for a region of code
+  struct AllocationStats
+  {
+    std::uint64_t allocations{ 0 };
+    std::uint64_t deallocations{ 0 };
+    std::uint64_t bytes{ 0 };
+  };
+
+  /// @brief Measures heap activity between construction and Stats()
+  ///
+  /// Counts are process-wide, so allocations made concurrently by other
+  /// threads are included.
+  ///
+  /// Example usage:
+  /// @code
+  /// AllocationScope scope;
+  /// model.Calculate(30.0);
+  /// EXPECT_LE(scope.Stats().allocations, budget);
+  /// @endcode
+  class AllocationScope
+  {
+   public:
+    AllocationScope()
+    {
+      Reset();
+    }
+
+    /// @brief Restart the measurement from the current counter values
+    void Reset()
+    {
+      start_.allocations = AllocationCounters::allocations.load(std::memory_order_relaxed);
+      start_.deallocations = AllocationCounters::deallocations.load(std::memory_order_relaxed);
+      start_.bytes = AllocationCounters::bytes.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Allocation statistics since construction or the last Reset()
+    AllocationStats Stats() const
+    {
+      AllocationStats stats;
+      stats.allocations = AllocationCounters::allocations.load(std::memory_order_relaxed) - start_.allocations;
+      stats.deallocations = AllocationCounters::deallocations.load(std::memory_order_relaxed) - start_.deallocations;
+      stats.bytes = AllocationCounters::bytes.load(std::memory_order_relaxed) - start_.bytes;
+      return stats;
+    }
+
+   private:
+    AllocationStats start_;
+  };
+
+  /// @brief Count the allocations made by one call of a callable
+  /// @param func Callable to measure
+  /// @return Allocation statistics for the call
+  template<typename Func>
+  AllocationStats CountAllocations(Func&& func)
+  {
+    AllocationScope scope;
+    func();
+    return scope.Stats();
+  }
+
+  namespace detail
+  {
+    inline void* CountingAllocate(std::size_t size)
+    {
+      AllocationCounters::RecordAllocation(size);
+      if (void* ptr = std::malloc(size == 0 ? 1 : size))
+      {
+        return ptr;
+      }
+      TUVX_THROW(std::bad_alloc());
+    }
+
+    inline void* CountingAllocateAligned(std::size_t size, std::align_val_t alignment)
+    {
+      AllocationCounters::RecordAllocation(size);
+      std::size_t align = static_cast<std::size_t>(alignment);
+      std::size_t rounded = ((size == 0 ? 1 : size) + align - 1) / align * align;
+      if (void* ptr = std::aligned_alloc(align, rounded))
+      {
+        return ptr;
+      }
+      TUVX_THROW(std::bad_alloc());
+    }
+
+    inline void CountingFree(void* ptr) noexcept
+    {
+      if (ptr != nullptr)
+      {
+        AllocationCounters::RecordDeallocation();
+        std::free(ptr);
+      }
+    }
+  }  // namespace detail
+
+}  // namespace tuvx
+
+/// @brief Replace the global allocation functions with counting versions
+///
+/// Expand at namespace scope in exactly one source file of a test or
+/// benchmark executable. Never use it in library code.
+#define TUVX_DEFINE_COUNTING_ALLOCATOR()                                                                  \
+  void* operator new(std::size_t size)                                                                    \
+  {                                                                                                       \
+    return tuvx::detail::CountingAllocate(size);                                                          \
+  }                                                                                                       \
+  void* operator new[](std::size_t size)                                                                  \
+  {                                                                                                       \
+    return tuvx::detail::CountingAllocate(size);                                                          \
+  }                                                                                                       \
+  void* operator new(std::size_t size, std::align_val_t alignment)                                        \
+  {                                                                                                       \
+    return tuvx::detail::CountingAllocateAligned(size, alignment);                                        \
+  }                                                                                                       \
+  void* operator new[](std::size_t size, std::align_val_t alignment)                                      \
+  {                                                                                                       \
+    return tuvx::detail::CountingAllocateAligned(size, alignment);                                        \
+  }                                                                                                       \
+  void* operator new(std::size_t size, const std::nothrow_t&) noexcept                                    \
+  {                                                                                                       \
+    try                                                                                                   \
+    {                                                                                                     \
+      return tuvx::detail::CountingAllocate(size);                                                        \
+    }                                                                                                     \
+    catch (...)                                                                                           \
+    {                                                                                                     \
+      return nullptr;                                                                                     \
+    }                                                                                                     \
+  }                                                                                                       \
+  void* operator new[](std::size_t size, const std::nothrow_t&) noexcept                                  \
+  {                                                                                                       \
+    try                                                                                                   \
+    {                                                                                                     \
+      return tuvx::detail::CountingAllocate(size);                                                        \
+    }                                                                                                     \
+    catch (...)                                                                                           \
+    {                                                                                                     \
+      return nullptr;                                                                                     \
+    }                                                                                                     \
+  }                                                                                                       \
+  void operator delete(void* ptr) noexcept                                                                \
+  {                                                                                                       \
+    tuvx::detail::CountingFree(ptr);                                                                      \
+  }                                                                                                       \
+  void operator delete[](void* ptr) noexcept                                                              \
+  {                                                                                                       \
+    tuvx::detail::CountingFree(ptr);                                                                      \
+  }                                                                                                       \
+  void operator delete(void* ptr, std::size_t) noexcept                                                   \
+  {                                                                                                       \
+    tuvx::detail::CountingFree(ptr);                                                                      \
+  }                                                                                                       \
+  void operator delete[](void* ptr, std::size_t) noexcept                                                 \
+  {                                                                                                       \
+    tuvx::detail::CountingFree(ptr);                                                                      \
+  }                                                                                                       \
+  void operator delete(void* ptr, std::align_val_t) noexcept                                              \
+  {                                                                                                       \
+    tuvx::detail::CountingFree(ptr);                                                                      \
+  }                                                                                                       \
+  void operator delete[](void* ptr, std::align_val_t) noexcept                                            \
+  {                                                                                                       \
+    tuvx::detail::CountingFree(ptr);                                                                      \
+  }                                                                                                       \
+  void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept                                 \
+  {                                                                                                       \
+    tuvx::detail::CountingFree(ptr);                                                                      \
+  }                                                                                                       \
+  void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept                               \
+  {                                                                                                       \
+    tuvx::detail::CountingFree(ptr);                                                                      \
+  }                                                                                                       \
+  static_assert(true, "")
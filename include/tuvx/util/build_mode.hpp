@@ -0,0 +1,19 @@
+#pragma once
+
+/// @file build_mode.hpp
+/// @brief Header-only vs. precompiled library selection
+///
+/// By default TUV-x is header-only and every out-of-line definition in the
+/// *-inl.hpp files is included by its header and marked inline. When the
+/// library is configured with TUVX_BUILD_COMPILED, the build defines
+/// TUVX_COMPILED_LIBRARY for the library and all its consumers: headers then
+/// only declare those functions, and src/tuvx.cpp compiles the definitions
+/// once.
+
+#if defined(TUVX_COMPILED_LIBRARY)
+  #define TUVX_HEADER_ONLY 0
+  #define TUVX_INLINE
+#else
+  #define TUVX_HEADER_ONLY 1
+  #define TUVX_INLINE inline
+#endif
@@ -8,6 +8,7 @@
 #define TUVX_ERROR_CATEGORY_GRID          "TUVX Grid"
 #define TUVX_ERROR_CATEGORY_PROFILE       "TUVX Profile"
 #define TUVX_ERROR_CATEGORY_RADIATOR      "TUVX Radiator"
+#define TUVX_ERROR_CATEGORY_MODEL         "TUVX Model"
 #define TUVX_ERROR_CATEGORY_INTERNAL      "TUVX Internal Error"
 
 // Configuration errors (1xx)
@@ -32,5 +33,9 @@
 #define TUVX_RADIATOR_ERROR_CODE_INVALID_DATA       402
 #define TUVX_RADIATOR_ERROR_CODE_RADIATOR_NOT_FOUND 403
 
+// Model errors (5xx)
+#define TUVX_MODEL_ERROR_CODE_REACTION_NOT_FOUND 501
+
 // Internal errors (9xx)
-#define TUVX_INTERNAL_ERROR_CODE_GENERAL 901
+#define TUVX_INTERNAL_ERROR_CODE_GENERAL        901
+#define TUVX_INTERNAL_ERROR_CODE_INVALID_HANDLE 902
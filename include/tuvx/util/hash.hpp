@@ -0,0 +1,48 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include <tuvx/util/strided_view.hpp>
+
+namespace tuvx
+{
+  /// @brief Starting value for running hashes built with HashCombine()
+  inline constexpr std::uint64_t kHashSeed = 0x9e3779b97f4a7c15ULL;
+
+  /// @brief Scramble a 64-bit value (SplitMix64 finalizer)
+  inline std::uint64_t MixHash(std::uint64_t x)
+  {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+  }
+
+  /// @brief Fold a value into a running hash; the result depends on the order of values
+  inline std::uint64_t HashCombine(std::uint64_t seed, std::uint64_t value)
+  {
+    return MixHash(seed ^ value);
+  }
+
+  /// @brief Fold the bit pattern of a double into a running hash
+  inline std::uint64_t HashCombine(std::uint64_t seed, double value)
+  {
+    return HashCombine(seed, std::bit_cast<std::uint64_t>(value));
+  }
+
+  /// @brief Fold the size and element bit patterns of a strided view into a running hash
+  inline std::uint64_t HashCombine(std::uint64_t seed, const StridedView<const double>& values)
+  {
+    seed = HashCombine(seed, static_cast<std::uint64_t>(values.Size()));
+    for (std::size_t i = 0; i < values.Size(); ++i)
+    {
+      seed = HashCombine(seed, values[i]);
+    }
+    return seed;
+  }
+
+}  // namespace tuvx
@@ -1,16 +1,39 @@
 #pragma once
 
+#include <tuvx/util/error.hpp>
+
+#include <cstdio>
+#include <cstdlib>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 #include <system_error>
 
+// TUVX_EXCEPTIONS is 0 when the including translation unit is compiled with
+// exceptions disabled (-fno-exceptions). Errors that would throw then print
+// their message and abort, and the Try* accessors on the hot path report
+// failures as std::error_code values from this category instead.
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+  #define TUVX_EXCEPTIONS 1
+#else
+  #define TUVX_EXCEPTIONS 0
+#endif
+
 namespace tuvx
 {
   /// @brief Error codes for internal TUV-x errors
+  ///
+  /// Values other than General reuse the numeric codes from error.hpp.
   enum class TuvxInternalErrc
   {
-    General = 1
+    General = 1,
+    InvalidSize = TUVX_GRID_ERROR_CODE_INVALID_SIZE,
+    OutOfRange = TUVX_GRID_ERROR_CODE_OUT_OF_RANGE,
+    GridNotFound = TUVX_GRID_ERROR_CODE_GRID_NOT_FOUND,
+    ProfileNotFound = TUVX_PROFILE_ERROR_CODE_PROFILE_NOT_FOUND,
+    RadiatorNotFound = TUVX_RADIATOR_ERROR_CODE_RADIATOR_NOT_FOUND,
+    ReactionNotFound = TUVX_MODEL_ERROR_CODE_REACTION_NOT_FOUND,
+    InvalidHandle = TUVX_INTERNAL_ERROR_CODE_INVALID_HANDLE
   };
 
   /// @brief Error category for TUV-x internal errors
@@ -32,6 +55,13 @@ namespace tuvx
       switch (static_cast<TuvxInternalErrc>(ev))
       {
         case TuvxInternalErrc::General: return "General internal error";
+        case TuvxInternalErrc::InvalidSize: return "Dimensions do not match";
+        case TuvxInternalErrc::OutOfRange: return "Index out of range";
+        case TuvxInternalErrc::GridNotFound: return "Grid not found";
+        case TuvxInternalErrc::ProfileNotFound: return "Profile not found";
+        case TuvxInternalErrc::RadiatorNotFound: return "Radiator not found";
+        case TuvxInternalErrc::ReactionNotFound: return "Reaction not found";
+        case TuvxInternalErrc::InvalidHandle: return "Invalid handle";
         default: return "Unknown error";
       }
     }
@@ -108,14 +138,28 @@ namespace tuvx
     }
   };
 
+  /// @brief Report an error and terminate; used in place of throw when exceptions are disabled
+  /// @param what Error message
+  [[noreturn]] inline void AbortWithError(const char* what) noexcept
+  {
+    std::fprintf(stderr, "TUV-x error: %s\n", what);
+    std::abort();
+  }
+
   /// @brief Throw an internal error with file/line information
   /// @param e Error code
   /// @param file Source file
   /// @param line Line number
   /// @param msg Error message
+  ///
+  /// Aborts with the same message when exceptions are disabled.
   [[noreturn]] inline void ThrowInternalError(TuvxInternalErrc e, const char* file, int line, const char* msg)
   {
+#if TUVX_EXCEPTIONS
     throw TuvxInternalException(e, file, line, msg);
+#else
+    AbortWithError(TuvxInternalException(e, file, line, msg).what());
+#endif
   }
 
 }  // namespace tuvx
@@ -129,3 +173,11 @@ struct std::is_error_code_enum<tuvx::TuvxInternalErrc> : std::true_type
 /// @brief Macro to throw an internal error with current file/line information
 /// @param msg Error message string
 #define TUVX_INTERNAL_ERROR(msg) tuvx::ThrowInternalError(tuvx::TuvxInternalErrc::General, __FILE__, __LINE__, msg)
+
+/// @brief Macro to throw an exception object, or abort with its message when exceptions are disabled
+/// @param exception Exception expression, e.g. std::runtime_error("message")
+#if TUVX_EXCEPTIONS
+  #define TUVX_THROW(exception) throw exception
+#else
+  #define TUVX_THROW(exception) tuvx::AbortWithError((exception).what())
+#endif
@@ -0,0 +1,473 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <tuvx/util/internal_error.hpp>
+#include <tuvx/util/thread_pool.hpp>
+
+#if defined(__linux__)
+  #include <pthread.h>
+  #include <sched.h>
+  #include <sys/mman.h>
+  #include <unistd.h>
+#endif
+
+namespace tuvx
+{
+  /// @brief Parse a Linux cpulist string such as "0-3,8,10-11"
+  /// @param list CPU list as found in /sys/devices/system/node/nodeN/cpulist
+  /// @return CPU ids in ascending order; empty if the string is malformed
+  inline std::vector<int> ParseCpuList(const std::string& list)
+  {
+    std::vector<int> cpus;
+    std::size_t pos = 0;
+    while (pos < list.size())
+    {
+      std::size_t end = list.find(',', pos);
+      if (end == std::string::npos)
+      {
+        end = list.size();
+      }
+      std::string range = list.substr(pos, end - pos);
+      while (!range.empty() && (range.back() == '\n' || range.back() == ' '))
+      {
+        range.pop_back();
+      }
+      if (!range.empty())
+      {
+        std::size_t dash = range.find('-');
+        char* parse_end = nullptr;
+        long first = std::strtol(range.c_str(), &parse_end, 10);
+        long last = first;
+        if (parse_end == range.c_str())
+        {
+          return {};
+        }
+        if (dash != std::string::npos)
+        {
+          const char* last_begin = range.c_str() + dash + 1;
+          last = std::strtol(last_begin, &parse_end, 10);
+          if (parse_end == last_begin)
+          {
+            return {};
+          }
+        }
+        if (first < 0 || last < first)
+        {
+          return {};
+        }
+        for (long cpu = first; cpu <= last; ++cpu)
+        {
+          cpus.push_back(static_cast<int>(cpu));
+        }
+      }
+      pos = end + 1;
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+  }
+
+  /// @brief CPUs this process may run on
+  /// @return CPU ids from the affinity mask on Linux, 0..hardware_concurrency-1 elsewhere
+  inline std::vector<int> AllowedCpus()
+  {
+    std::vector<int> cpus;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+    {
+      for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+      {
+        if (CPU_ISSET(cpu, &set))
+        {
+          cpus.push_back(cpu);
+        }
+      }
+    }
+#endif
+    if (cpus.empty())
+    {
+      unsigned n = std::max<unsigned>(std::thread::hardware_concurrency(), 1u);
+      for (unsigned cpu = 0; cpu < n; ++cpu)
+      {
+        cpus.push_back(static_cast<int>(cpu));
+      }
+    }
+    return cpus;
+  }
+
+  /// @brief Pin the calling thread to one CPU
+  /// @param cpu CPU id
+  /// @return True if the affinity was set; always false on platforms without thread affinity
+  inline bool PinCurrentThread(int cpu)
+  {
+#if defined(__linux__)
+    if (cpu < 0 || cpu >= CPU_SETSIZE)
+    {
+      return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+  }
+
+  /// @brief CPUs grouped by NUMA node
+  ///
+  /// Detect() reads the node layout from sysfs on Linux, keeping only the
+  /// CPUs this process may run on. Where that is unavailable (other
+  /// platforms, containers without sysfs) it falls back to a single node
+  /// holding every allowed CPU, so NUMA-aware code paths still run on a
+  /// single-socket machine. Tests can build arbitrary layouts from CPU lists.
+  class NumaTopology
+  {
+   public:
+    /// @brief Build a topology from the CPUs of each node
+    /// @param node_cpus CPU ids for each node; nodes without CPUs are dropped
+    /// @throws std::invalid_argument if no node has a CPU
+    explicit NumaTopology(std::vector<std::vector<int>> node_cpus)
+    {
+      for (auto& cpus : node_cpus)
+      {
+        if (!cpus.empty())
+        {
+          node_cpus_.push_back(std::move(cpus));
+        }
+      }
+      if (node_cpus_.empty())
+      {
+        TUVX_THROW(std::invalid_argument("NUMA topology needs at least one CPU"));
+      }
+    }
+
+    /// @brief Single node with every CPU this process may use
+    static NumaTopology SingleNode()
+    {
+      return NumaTopology({ AllowedCpus() });
+    }
+
+    /// @brief Detect the NUMA layout of this machine
+    /// @param sysfs_root Directory holding node0, node1, ... (overridable for testing)
+    static NumaTopology Detect(const std::string& sysfs_root = "/sys/devices/system/node")
+    {
+      std::vector<int> allowed = AllowedCpus();
+      std::vector<std::vector<int>> nodes;
+      for (int node = 0;; ++node)
+      {
+        std::ifstream file(sysfs_root + "/node" + std::to_string(node) + "/cpulist");
+        if (!file)
+        {
+          break;
+        }
+        std::string list;
+        std::getline(file, list);
+        std::vector<int> cpus;
+        for (int cpu : ParseCpuList(list))
+        {
+          if (std::binary_search(allowed.begin(), allowed.end(), cpu))
+          {
+            cpus.push_back(cpu);
+          }
+        }
+        nodes.push_back(std::move(cpus));
+      }
+      bool any = std::any_of(nodes.begin(), nodes.end(), [](const auto& cpus) { return !cpus.empty(); });
+      return any ? NumaTopology(std::move(nodes)) : SingleNode();
+    }
+
+    /// @brief Number of nodes with at least one usable CPU
+    std::size_t NumberOfNodes() const
+    {
+      return node_cpus_.size();
+    }
+
+    /// @brief CPUs of one node
+    /// @param node Node index in [0, NumberOfNodes())
+    const std::vector<int>& Cpus(std::size_t node) const
+    {
+      return node_cpus_[node];
+    }
+
+    /// @brief Total number of usable CPUs
+    std::size_t NumberOfCpus() const
+    {
+      std::size_t n = 0;
+      for (const auto& cpus : node_cpus_)
+      {
+        n += cpus.size();
+      }
+      return n;
+    }
+
+   private:
+    std::vector<std::vector<int>> node_cpus_;
+  };
+
+  /// @brief Assignment of thread-pool workers to NUMA nodes and CPUs
+  ///
+  /// Workers are split into contiguous blocks of (almost) equal size, one
+  /// block per node (see StaticBlock), so consecutive workers share a node.
+  /// Within a node, workers take the node's CPUs in order, wrapping if there
+  /// are more workers than CPUs. Combined with StaticBlock over columns,
+  /// data first touched by worker w stays on w's node.
+  class WorkerPlacement
+  {
+   public:
+    /// @brief Place n_workers workers on a topology
+    /// @param topology NUMA layout
+    /// @param n_workers Number of workers, usually ThreadPool::Size()
+    WorkerPlacement(const NumaTopology& topology, std::size_t n_workers)
+        : n_nodes_(topology.NumberOfNodes())
+    {
+      node_.resize(n_workers);
+      cpu_.resize(n_workers);
+      for (std::size_t node = 0; node < n_nodes_; ++node)
+      {
+        auto [first, last] = StaticBlock(n_workers, node, n_nodes_);
+        const auto& cpus = topology.Cpus(node);
+        for (std::size_t w = first; w < last; ++w)
+        {
+          node_[w] = node;
+          cpu_[w] = cpus[(w - first) % cpus.size()];
+        }
+      }
+    }
+
+    /// @brief Number of workers placed
+    std::size_t NumberOfWorkers() const
+    {
+      return node_.size();
+    }
+
+    /// @brief Number of nodes in the topology
+    std::size_t NumberOfNodes() const
+    {
+      return n_nodes_;
+    }
+
+    /// @brief Node a worker is placed on
+    std::size_t Node(std::size_t worker) const
+    {
+      return node_[worker];
+    }
+
+    /// @brief CPU a worker is pinned to
+    int Cpu(std::size_t worker) const
+    {
+      return cpu_[worker];
+    }
+
+    /// @brief Pin every thread of a pool to its CPU
+    /// @param pool Pool with NumberOfWorkers() threads; worker 0 is the calling thread
+    /// @return Number of threads successfully pinned (0 where affinity is unsupported)
+    /// @throws std::invalid_argument if the pool size does not match
+    ///
+    /// Worker 0 is the thread that calls ParallelFor, so it is pinned too;
+    /// call this from the thread that will drive the pool.
+    std::size_t Pin(ThreadPool& pool) const
+    {
+      CheckPool(pool);
+      std::vector<char> pinned(pool.Size(), 0);
+      pool.ForEachWorker([&](std::size_t w) { pinned[w] = PinCurrentThread(cpu_[w]) ? 1 : 0; });
+      return static_cast<std::size_t>(std::count(pinned.begin(), pinned.end(), 1));
+    }
+
+    /// @brief Check that a pool has one thread per placed worker
+    /// @throws std::invalid_argument if it does not
+    void CheckPool(const ThreadPool& pool) const
+    {
+      if (pool.Size() != node_.size())
+      {
+        TUVX_THROW(std::invalid_argument("Worker placement does not match thread pool size"));
+      }
+    }
+
+   private:
+    std::size_t n_nodes_;
+    std::vector<std::size_t> node_;
+    std::vector<int> cpu_;
+  };
+
+  /// @brief Page-aligned array whose pages are not touched on allocation
+  ///
+  /// With Linux's first-touch policy a page lands on the NUMA node of the
+  /// thread that first writes it. NumaBuffer maps memory without writing it
+  /// and leaves that first write to the owning worker (see FirstTouch).
+  /// Large buffers can ask for transparent huge pages; elsewhere the buffer
+  /// falls back to an aligned heap allocation with the same interface.
+  ///
+  /// Contents are unspecified until touched.
+  template<typename T>
+  class NumaBuffer
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "NumaBuffer holds trivially copyable elements only");
+
+   public:
+    /// @brief Size from which huge pages are requested [bytes]
+    static constexpr std::size_t kHugePageSize = std::size_t{ 2 } << 20;
+
+    /// @brief Default constructor creates an empty buffer
+    NumaBuffer() = default;
+
+    /// @brief Allocate without touching
+    /// @param size Number of elements
+    /// @param huge_pages Request transparent huge pages if the buffer spans at least one
+    /// @throws std::bad_alloc if the mapping fails
+    explicit NumaBuffer(std::size_t size, bool huge_pages = false)
+        : size_(size)
+    {
+      if (size == 0)
+      {
+        return;
+      }
+      std::size_t page = PageSize();
+      bytes_ = (size * sizeof(T) + page - 1) / page * page;
+#if defined(__linux__)
+      bool use_huge = huge_pages && bytes_ >= kHugePageSize;
+      if (use_huge)
+      {
+        bytes_ = (bytes_ + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+      }
+      void* memory = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (memory == MAP_FAILED)
+      {
+        TUVX_THROW(std::bad_alloc());
+      }
+  #if defined(MADV_HUGEPAGE)
+      huge_pages_ = use_huge && madvise(memory, bytes_, MADV_HUGEPAGE) == 0;
+  #endif
+#else
+      (void)huge_pages;
+      void* memory = std::aligned_alloc(page, bytes_);
+      if (memory == nullptr)
+      {
+        TUVX_THROW(std::bad_alloc());
+      }
+#endif
+      data_ = static_cast<T*>(memory);
+    }
+
+    NumaBuffer(const NumaBuffer&) = delete;
+    NumaBuffer& operator=(const NumaBuffer&) = delete;
+
+    NumaBuffer(NumaBuffer&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)),
+          size_(std::exchange(other.size_, 0)),
+          bytes_(std::exchange(other.bytes_, 0)),
+          huge_pages_(std::exchange(other.huge_pages_, false))
+    {
+    }
+
+    NumaBuffer& operator=(NumaBuffer&& other) noexcept
+    {
+      if (this != &other)
+      {
+        Release();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        bytes_ = std::exchange(other.bytes_, 0);
+        huge_pages_ = std::exchange(other.huge_pages_, false);
+      }
+      return *this;
+    }
+
+    ~NumaBuffer()
+    {
+      Release();
+    }
+
+    /// @brief Pointer to the first element
+    T* Data()
+    {
+      return data_;
+    }
+
+    /// @brief Pointer to the first element
+    const T* Data() const
+    {
+      return data_;
+    }
+
+    /// @brief Number of elements
+    std::size_t Size() const
+    {
+      return size_;
+    }
+
+    /// @brief View of the whole buffer
+    std::span<T> Span()
+    {
+      return { data_, size_ };
+    }
+
+    /// @brief View of the whole buffer
+    std::span<const T> Span() const
+    {
+      return { data_, size_ };
+    }
+
+    /// @brief Whether the kernel accepted the huge-page request
+    bool HugePages() const
+    {
+      return huge_pages_;
+    }
+
+    /// @brief Write a value to a range of elements, placing their pages on the calling thread's node
+    /// @param begin First element
+    /// @param end One past the last element
+    /// @param value Value to write
+    void FirstTouch(std::size_t begin, std::size_t end, const T& value = T{})
+    {
+      std::fill(data_ + begin, data_ + end, value);
+    }
+
+    /// @brief Page size used for alignment [bytes]
+    static std::size_t PageSize()
+    {
+#if defined(__linux__)
+      long page = sysconf(_SC_PAGESIZE);
+      return page > 0 ? static_cast<std::size_t>(page) : 4096;
+#else
+      return 4096;
+#endif
+    }
+
+   private:
+    void Release()
+    {
+      if (data_ == nullptr)
+      {
+        return;
+      }
+#if defined(__linux__)
+      munmap(data_, bytes_);
+#else
+      std::free(data_);
+#endif
+      data_ = nullptr;
+    }
+
+    T* data_{ nullptr };
+    std::size_t size_{ 0 };
+    std::size_t bytes_{ 0 };
+    bool huge_pages_{ false };
+  };
+
+}  // namespace tuvx
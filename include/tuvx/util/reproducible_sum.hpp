@@ -0,0 +1,115 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include <tuvx/util/thread_pool.hpp>
+
+namespace tuvx
+{
+  /// @brief Number of consecutive terms summed left-to-right at each leaf
+  ///
+  /// Sums of at most this many terms are therefore identical to a plain
+  /// sequential loop.
+  inline constexpr std::size_t kReproducibleSumBlockSize = 64;
+
+  namespace detail
+  {
+    /// @brief Sequential sum of terms [begin, end)
+    template<typename Term>
+    double BlockSum(std::size_t begin, std::size_t end, Term& term)
+    {
+      double sum = 0.0;
+      for (std::size_t i = begin; i < end; ++i)
+      {
+        sum += term(i);
+      }
+      return sum;
+    }
+
+    /// @brief Pairwise sum over blocks [first_block, last_block) of n terms
+    template<typename Term>
+    double BlockTreeSum(std::size_t first_block, std::size_t last_block, std::size_t n, Term& term)
+    {
+      if (last_block - first_block == 1)
+      {
+        std::size_t begin = first_block * kReproducibleSumBlockSize;
+        std::size_t end = std::min(begin + kReproducibleSumBlockSize, n);
+        return BlockSum(begin, end, term);
+      }
+      std::size_t mid = first_block + (last_block - first_block) / 2;
+      return BlockTreeSum(first_block, mid, n, term) + BlockTreeSum(mid, last_block, n, term);
+    }
+
+    /// @brief Pairwise sum of precomputed block partials [first, last)
+    inline double PartialTreeSum(const double* partials, std::size_t first, std::size_t last)
+    {
+      if (last - first == 1)
+      {
+        return partials[first];
+      }
+      std::size_t mid = first + (last - first) / 2;
+      return PartialTreeSum(partials, first, mid) + PartialTreeSum(partials, mid, last);
+    }
+
+    inline std::size_t NumberOfBlocks(std::size_t n)
+    {
+      return (n + kReproducibleSumBlockSize - 1) / kReproducibleSumBlockSize;
+    }
+  }  // namespace detail
+
+  /// @brief Sum n terms in a fixed order that depends only on n
+  /// @param n Number of terms
+  /// @param term Callable returning term i as double
+  /// @return Sum of term(0) ... term(n-1)
+  ///
+  /// Terms are summed sequentially in blocks of kReproducibleSumBlockSize and
+  /// the block partials are combined with a balanced binary tree. Because the
+  /// association order is a function of n alone, the serial and threaded
+  /// overloads return bit-identical results for any thread count. Pairwise
+  /// combination also bounds the rounding error growth to O(log n).
+  template<typename Term>
+  double ReproducibleSum(std::size_t n, Term&& term)
+  {
+    if (n == 0)
+    {
+      return 0.0;
+    }
+    return detail::BlockTreeSum(0, detail::NumberOfBlocks(n), n, term);
+  }
+
+  /// @brief Sum a contiguous range in reproducible order
+  /// @param values Values to sum
+  inline double ReproducibleSum(std::span<const double> values)
+  {
+    return ReproducibleSum(values.size(), [values](std::size_t i) { return values[i]; });
+  }
+
+  /// @brief Sum n terms on a thread pool, bit-identical to the serial overload
+  /// @param n Number of terms
+  /// @param term Callable returning term i as double (must be safe to call concurrently)
+  /// @param pool Thread pool that evaluates the block partials
+  template<typename Term>
+  double ReproducibleSum(std::size_t n, Term&& term, ThreadPool& pool)
+  {
+    std::size_t n_blocks = detail::NumberOfBlocks(n);
+    if (n_blocks <= 1 || pool.Size() == 1)
+    {
+      return ReproducibleSum(n, term);
+    }
+
+    std::vector<double> partials(n_blocks);
+    pool.ParallelFor(
+        n_blocks,
+        [&](std::size_t block)
+        {
+          std::size_t begin = block * kReproducibleSumBlockSize;
+          std::size_t end = std::min(begin + kReproducibleSumBlockSize, n);
+          partials[block] = detail::BlockSum(begin, end, term);
+        });
+    return detail::PartialTreeSum(partials.data(), 0, n_blocks);
+  }
+
+}  // namespace tuvx
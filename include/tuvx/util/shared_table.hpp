@@ -0,0 +1,448 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <tuvx/util/internal_error.hpp>
+
+#if defined(__unix__) || defined(__APPLE__)
+  #define TUVX_HAS_POSIX_SHM 1
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#else
+  #define TUVX_HAS_POSIX_SHM 0
+#endif
+
+namespace tuvx
+{
+  /// @brief Read-only view of one table in a SharedTableSegment
+  ///
+  /// Values are stored row-major: element (r, c) is data[r * cols + c].
+  struct SharedTable
+  {
+    const double* data{ nullptr };
+    std::size_t rows{ 0 };
+    std::size_t cols{ 0 };
+
+    /// @brief Whether the table was found
+    bool Empty() const
+    {
+      return data == nullptr;
+    }
+
+    /// @brief All values, row-major
+    std::span<const double> Values() const
+    {
+      return { data, rows * cols };
+    }
+
+    /// @brief One row
+    /// @param r Row index in [0, rows)
+    std::span<const double> Row(std::size_t r) const
+    {
+      return { data + r * cols, cols };
+    }
+  };
+
+  class SharedTableBuilder;
+
+  /// @brief Named double tables in one POSIX shared-memory segment
+  ///
+  /// With many MPI ranks per node, every rank otherwise holds its own copy
+  /// of each cross-section table, the extraterrestrial flux and any lookup
+  /// table. Instead one rank per node fills a SharedTableBuilder and
+  /// publishes it; the other ranks Open() the segment by name and map it
+  /// read-only, so the node holds one copy. SharedCrossSection and
+  /// SharedQuantumYield read their data straight from the mapping.
+  ///
+  /// The segment stays mapped while any shared_ptr to it (including those
+  /// held by shared cross-sections) is alive. The name is removed from the
+  /// system when the publishing process's segment object is destroyed;
+  /// processes that have already opened it keep their mapping.
+  ///
+  /// Example usage (with an MPI shared-memory communicator):
+  /// @code
+  /// std::shared_ptr<const SharedTableSegment> tables;
+  /// if (node_rank == 0)
+  /// {
+  ///   SharedTableBuilder builder;
+  ///   BinCrossSection(builder, "O3", O3CrossSection(), wavelength_grid, { 218.0, 228.0, 243.0, 273.0, 295.0 });
+  ///   tables = builder.Publish("/tuvx_tables");
+  /// }
+  /// MPI_Barrier(node_comm);
+  /// if (node_rank != 0)
+  /// {
+  ///   tables = SharedTableSegment::Open("/tuvx_tables");
+  /// }
+  /// SharedCrossSection o3(tables, "O3");
+  /// @endcode
+  class SharedTableSegment
+  {
+   public:
+    SharedTableSegment(const SharedTableSegment&) = delete;
+    SharedTableSegment& operator=(const SharedTableSegment&) = delete;
+
+    ~SharedTableSegment()
+    {
+#if TUVX_HAS_POSIX_SHM
+      if (base_ != nullptr)
+      {
+        munmap(const_cast<std::byte*>(base_), bytes_);
+      }
+      if (owner_)
+      {
+        shm_unlink(name_.c_str());
+      }
+#endif
+    }
+
+    /// @brief Map a segment published by another process
+    /// @param name Segment name (a leading '/' is added if missing)
+    /// @return Read-only segment
+    /// @throws std::runtime_error if the segment does not exist, is not a table segment or is not yet complete
+    static std::shared_ptr<const SharedTableSegment> Open(const std::string& name)
+    {
+      std::string shm_name = NormalizeName(name);
+#if TUVX_HAS_POSIX_SHM
+      int fd = shm_open(shm_name.c_str(), O_RDONLY, 0);
+      if (fd < 0)
+      {
+        TUVX_THROW(std::runtime_error("Cannot open shared table segment '" + shm_name + "': " + std::strerror(errno)));
+      }
+      struct stat info;
+      if (fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(Header))
+      {
+        close(fd);
+        TUVX_THROW(std::runtime_error("Shared table segment '" + shm_name + "' is too small"));
+      }
+      std::size_t bytes = static_cast<std::size_t>(info.st_size);
+      void* memory = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+      close(fd);
+      if (memory == MAP_FAILED)
+      {
+        TUVX_THROW(std::runtime_error("Cannot map shared table segment '" + shm_name + "'"));
+      }
+      std::shared_ptr<SharedTableSegment> segment(new SharedTableSegment(shm_name, static_cast<std::byte*>(memory), bytes, false));
+      segment->Validate();
+      return segment;
+#else
+      TUVX_THROW(std::runtime_error("Shared table segments need POSIX shared memory: " + shm_name));
+#endif
+    }
+
+    /// @brief Remove a segment name left behind by a crashed run
+    /// @param name Segment name
+    /// @return True if a segment was removed
+    static bool Remove(const std::string& name)
+    {
+#if TUVX_HAS_POSIX_SHM
+      return shm_unlink(NormalizeName(name).c_str()) == 0;
+#else
+      (void)name;
+      return false;
+#endif
+    }
+
+    /// @brief Segment name as passed to shm_open
+    const std::string& Name() const
+    {
+      return name_;
+    }
+
+    /// @brief Whether this process published the segment
+    bool Owner() const
+    {
+      return owner_;
+    }
+
+    /// @brief Size of the mapping [bytes]
+    std::size_t Bytes() const
+    {
+      return bytes_;
+    }
+
+    /// @brief Number of tables
+    std::size_t Size() const
+    {
+      return HeaderView().n_tables;
+    }
+
+    /// @brief Names of all tables, in the order they were added
+    std::vector<std::string> Names() const
+    {
+      std::vector<std::string> names;
+      names.reserve(Size());
+      for (std::size_t i = 0; i < Size(); ++i)
+      {
+        names.emplace_back(Entries()[i].name);
+      }
+      return names;
+    }
+
+    /// @brief Look up a table
+    /// @param table Table name
+    /// @return View of the table, or an empty view if there is none by that name
+    SharedTable Find(const std::string& table) const
+    {
+      for (std::size_t i = 0; i < Size(); ++i)
+      {
+        const Entry& entry = Entries()[i];
+        if (table == entry.name)
+        {
+          return { reinterpret_cast<const double*>(base_ + entry.offset), entry.rows, entry.cols };
+        }
+      }
+      return {};
+    }
+
+    /// @brief Look up a table that must exist
+    /// @param table Table name
+    /// @throws std::out_of_range if there is no such table
+    SharedTable Get(const std::string& table) const
+    {
+      SharedTable found = Find(table);
+      if (found.Empty())
+      {
+        TUVX_THROW(std::out_of_range("Shared table '" + table + "' not found in segment " + name_));
+      }
+      return found;
+    }
+
+   private:
+    friend class SharedTableBuilder;
+
+    static constexpr char kMagic[8] = { 'T', 'U', 'V', 'X', 'S', 'H', 'M', '\0' };
+    static constexpr std::uint32_t kVersion = 1;
+    static constexpr std::size_t kMaxNameLength = 95;
+    static constexpr std::size_t kAlignment = 64;
+
+    struct Header
+    {
+      char magic[8];
+      std::uint32_t version;
+      std::uint32_t ready;
+      std::uint64_t n_tables;
+      std::uint64_t bytes;
+    };
+
+    struct Entry
+    {
+      char name[kMaxNameLength + 1];
+      std::uint64_t offset;
+      std::uint64_t rows;
+      std::uint64_t cols;
+    };
+
+    SharedTableSegment(std::string name, std::byte* base, std::size_t bytes, bool owner)
+        : name_(std::move(name)),
+          base_(base),
+          bytes_(bytes),
+          owner_(owner)
+    {
+    }
+
+    static std::string NormalizeName(const std::string& name)
+    {
+      return !name.empty() && name[0] == '/' ? name : "/" + name;
+    }
+
+    static std::size_t Align(std::size_t bytes)
+    {
+      return (bytes + kAlignment - 1) / kAlignment * kAlignment;
+    }
+
+    const Header& HeaderView() const
+    {
+      return *reinterpret_cast<const Header*>(base_);
+    }
+
+    const Entry* Entries() const
+    {
+      return reinterpret_cast<const Entry*>(base_ + Align(sizeof(Header)));
+    }
+
+    void Validate() const
+    {
+      const Header& header = HeaderView();
+      if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0)
+      {
+        TUVX_THROW(std::runtime_error("'" + name_ + "' is not a TUV-x shared table segment"));
+      }
+      if (header.version != kVersion)
+      {
+        TUVX_THROW(std::runtime_error("Shared table segment '" + name_ + "' has unsupported version"));
+      }
+      std::atomic_ref<std::uint32_t> ready(const_cast<std::uint32_t&>(header.ready));
+      if (ready.load(std::memory_order_acquire) == 0 || header.bytes != bytes_)
+      {
+        TUVX_THROW(std::runtime_error("Shared table segment '" + name_ + "' is not completely written"));
+      }
+      std::size_t directory_begin = Align(sizeof(Header));
+      if (directory_begin > bytes_ || header.n_tables > (bytes_ - directory_begin) / sizeof(Entry))
+      {
+        TUVX_THROW(std::runtime_error("Shared table segment '" + name_ + "' is truncated"));
+      }
+      for (std::size_t i = 0; i < header.n_tables; ++i)
+      {
+        const Entry& entry = Entries()[i];
+        if (entry.name[kMaxNameLength] != '\0' || entry.offset % alignof(double) != 0)
+        {
+          TUVX_THROW(std::runtime_error("Shared table segment '" + name_ + "' has a corrupt directory"));
+        }
+        // rows * cols may not fit in 64 bits, so compare against what the segment can hold
+        std::uint64_t capacity = entry.offset <= bytes_ ? (bytes_ - entry.offset) / sizeof(double) : 0;
+        if (entry.offset > bytes_ || (entry.rows != 0 && entry.cols > capacity / entry.rows))
+        {
+          TUVX_THROW(std::runtime_error("Shared table segment '" + name_ + "' is truncated"));
+        }
+      }
+    }
+
+    std::string name_;
+    const std::byte* base_{ nullptr };
+    std::size_t bytes_{ 0 };
+    bool owner_{ false };
+  };
+
+  /// @brief Collects tables in process memory and publishes them as a SharedTableSegment
+  class SharedTableBuilder
+  {
+   public:
+    /// @brief Add a 2-D table
+    /// @param name Table name (at most 95 characters, unique within the segment)
+    /// @param rows Number of rows
+    /// @param cols Number of columns
+    /// @param values Row-major values, rows * cols of them
+    /// @throws std::invalid_argument on a size mismatch, an over-long name or a duplicate name
+    void Add(const std::string& name, std::size_t rows, std::size_t cols, std::span<const double> values)
+    {
+      if ((rows != 0 && cols > values.size() / rows) || values.size() != rows * cols)
+      {
+        TUVX_THROW(std::invalid_argument("Shared table '" + name + "' has the wrong number of values"));
+      }
+      if (name.empty() || name.size() > SharedTableSegment::kMaxNameLength)
+      {
+        TUVX_THROW(std::invalid_argument("Shared table name '" + name + "' is empty or too long"));
+      }
+      if (Contains(name))
+      {
+        TUVX_THROW(std::invalid_argument("Shared table '" + name + "' was already added"));
+      }
+      tables_.push_back({ name, rows, cols, std::vector<double>(values.begin(), values.end()) });
+    }
+
+    /// @brief Add a 1-D table
+    /// @param name Table name
+    /// @param values Values
+    void Add(const std::string& name, std::span<const double> values)
+    {
+      Add(name, 1, values.size(), values);
+    }
+
+    /// @brief Whether a table of this name was added
+    bool Contains(const std::string& name) const
+    {
+      return std::any_of(tables_.begin(), tables_.end(), [&](const Pending& table) { return table.name == name; });
+    }
+
+    /// @brief Size the published segment will have [bytes]
+    std::size_t Bytes() const
+    {
+      std::size_t bytes =
+          SharedTableSegment::Align(SharedTableSegment::Align(sizeof(SharedTableSegment::Header)) + tables_.size() * sizeof(SharedTableSegment::Entry));
+      for (const auto& table : tables_)
+      {
+        bytes += SharedTableSegment::Align(table.values.size() * sizeof(double));
+      }
+      return bytes;
+    }
+
+    /// @brief Write every table into a new shared-memory segment
+    /// @param name Segment name (a leading '/' is added if missing)
+    /// @return The segment, mapped read-only; the name is removed when it is destroyed
+    /// @throws std::runtime_error if a segment of that name already exists or cannot be created
+    ///
+    /// The segment is marked complete only after all tables are written, so
+    /// Open() in another process never sees a partial segment.
+    std::shared_ptr<const SharedTableSegment> Publish(const std::string& name) const
+    {
+      std::string shm_name = SharedTableSegment::NormalizeName(name);
+#if TUVX_HAS_POSIX_SHM
+      int fd = shm_open(shm_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+      if (fd < 0)
+      {
+        TUVX_THROW(std::runtime_error("Cannot create shared table segment '" + shm_name + "': " + std::strerror(errno)));
+      }
+      std::size_t bytes = Bytes();
+      if (ftruncate(fd, static_cast<off_t>(bytes)) != 0)
+      {
+        close(fd);
+        shm_unlink(shm_name.c_str());
+        TUVX_THROW(std::runtime_error("Cannot size shared table segment '" + shm_name + "'"));
+      }
+      void* memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      close(fd);
+      if (memory == MAP_FAILED)
+      {
+        shm_unlink(shm_name.c_str());
+        TUVX_THROW(std::runtime_error("Cannot map shared table segment '" + shm_name + "'"));
+      }
+      auto* base = static_cast<std::byte*>(memory);
+      Write(base, bytes);
+      mprotect(memory, bytes, PROT_READ);
+      return std::shared_ptr<const SharedTableSegment>(new SharedTableSegment(shm_name, base, bytes, true));
+#else
+      TUVX_THROW(std::runtime_error("Shared table segments need POSIX shared memory: " + shm_name));
+#endif
+    }
+
+   private:
+    struct Pending
+    {
+      std::string name;
+      std::size_t rows;
+      std::size_t cols;
+      std::vector<double> values;
+    };
+
+    void Write(std::byte* base, std::size_t bytes) const
+    {
+      using Segment = SharedTableSegment;
+      auto* header = reinterpret_cast<Segment::Header*>(base);
+      auto* entries = reinterpret_cast<Segment::Entry*>(base + Segment::Align(sizeof(Segment::Header)));
+      std::size_t offset = Segment::Align(Segment::Align(sizeof(Segment::Header)) + tables_.size() * sizeof(Segment::Entry));
+      for (std::size_t i = 0; i < tables_.size(); ++i)
+      {
+        const Pending& table = tables_[i];
+        Segment::Entry& entry = entries[i];
+        std::memset(entry.name, 0, sizeof(entry.name));
+        std::memcpy(entry.name, table.name.data(), table.name.size());
+        entry.offset = offset;
+        entry.rows = table.rows;
+        entry.cols = table.cols;
+        std::memcpy(base + offset, table.values.data(), table.values.size() * sizeof(double));
+        offset += Segment::Align(table.values.size() * sizeof(double));
+      }
+      std::memcpy(header->magic, Segment::kMagic, sizeof(Segment::kMagic));
+      header->version = Segment::kVersion;
+      header->n_tables = tables_.size();
+      header->bytes = bytes;
+      std::atomic_ref<std::uint32_t>(header->ready).store(1, std::memory_order_release);
+    }
+
+    std::vector<Pending> tables_;
+  };
+
+}  // namespace tuvx
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <tuvx/util/internal_error.hpp>
+
+namespace tuvx
+{
+  /// @brief Bounded lock-free queue for exactly one producer and one consumer thread
+  ///
+  /// A ring buffer with one atomic index per side: the producer only writes
+  /// tail_, the consumer only writes head_, and each side reads the other's
+  /// index with acquire ordering, so no locks or compare-and-swap loops are
+  /// needed. The indices sit on separate cache lines so the two threads do
+  /// not false-share. Push() and Pop() spin briefly and then sleep with
+  /// std::atomic::wait when the queue is full or empty.
+  ///
+  /// Calling TryPush()/Push() from more than one thread, or TryPop()/Pop()
+  /// from more than one thread, is a data race.
+  ///
+  /// Example usage:
+  /// @code
+  /// SpscQueue<int> queue(8);
+  /// std::thread producer([&] { for (int i = 0; i < 100; ++i) queue.Push(i); });
+  /// for (int i = 0; i < 100; ++i) use(queue.Pop());
+  /// producer.join();
+  /// @endcode
+  template<typename T>
+  class SpscQueue
+  {
+   public:
+    /// @brief Create a queue
+    /// @param capacity Maximum number of queued elements (> 0)
+    /// @throws std::invalid_argument if capacity is zero
+    explicit SpscQueue(std::size_t capacity)
+        : slots_(capacity + 1)
+    {
+      if (capacity == 0)
+      {
+        TUVX_THROW(std::invalid_argument("SpscQueue capacity must be positive"));
+      }
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /// @brief Maximum number of queued elements
+    std::size_t Capacity() const
+    {
+      return slots_.size() - 1;
+    }
+
+    /// @brief Append an element if there is room (producer only)
+    /// @return False if the queue is full
+    bool TryPush(const T& value)
+    {
+      std::size_t tail = tail_.load(std::memory_order_relaxed);
+      if (Next(tail) == head_.load(std::memory_order_acquire))
+      {
+        return false;
+      }
+      Publish(tail, T(value));
+      return true;
+    }
+
+    /// @brief Append an element, waiting while the queue is full (producer only)
+    void Push(T value)
+    {
+      std::size_t tail = tail_.load(std::memory_order_relaxed);
+      std::size_t head;
+      while ((head = head_.load(std::memory_order_acquire)) == Next(tail))
+      {
+        Wait(head_, head);
+      }
+      Publish(tail, std::move(value));
+    }
+
+    /// @brief Remove the oldest element if there is one (consumer only)
+    /// @return False if the queue is empty; value is left unchanged
+    bool TryPop(T& value)
+    {
+      std::size_t head = head_.load(std::memory_order_relaxed);
+      if (head == tail_.load(std::memory_order_acquire))
+      {
+        return false;
+      }
+      value = Consume(head);
+      return true;
+    }
+
+    /// @brief Remove the oldest element, waiting while the queue is empty (consumer only)
+    T Pop()
+    {
+      std::size_t head = head_.load(std::memory_order_relaxed);
+      std::size_t tail;
+      while ((tail = tail_.load(std::memory_order_acquire)) == head)
+      {
+        Wait(tail_, tail);
+      }
+      return Consume(head);
+    }
+
+    /// @brief Whether the queue is empty (exact only when called by the consumer)
+    bool Empty() const
+    {
+      return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+   private:
+    static constexpr std::size_t kCacheLine = 64;
+    static constexpr int kSpins = 256;
+
+    std::size_t Next(std::size_t index) const
+    {
+      return index + 1 == slots_.size() ? 0 : index + 1;
+    }
+
+    void Publish(std::size_t tail, T&& value)
+    {
+      slots_[tail] = std::move(value);
+      tail_.store(Next(tail), std::memory_order_release);
+      tail_.notify_one();
+    }
+
+    T Consume(std::size_t head)
+    {
+      T value = std::move(slots_[head]);
+      head_.store(Next(head), std::memory_order_release);
+      head_.notify_one();
+      return value;
+    }
+
+    /// Wait until the other side moves an index away from the value seen by the caller
+    static void Wait(const std::atomic<std::size_t>& index, std::size_t observed)
+    {
+      for (int i = 0; i < kSpins; ++i)
+      {
+        if (index.load(std::memory_order_acquire) != observed)
+        {
+          return;
+        }
+      }
+      index.wait(observed, std::memory_order_acquire);
+    }
+
+    std::vector<T> slots_;
+    alignas(kCacheLine) std::atomic<std::size_t> head_{ 0 };  // next slot to pop, written by the consumer
+    alignas(kCacheLine) std::atomic<std::size_t> tail_{ 0 };  // next slot to push, written by the producer
+  };
+
+}  // namespace tuvx
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <tuvx/util/allocation_counter.hpp>
+
+namespace tuvx
+{
+  /// @brief Cost of preparing one model component
+  struct StartupRecord
+  {
+    /// Component name (e.g. "solver", "radiator O3")
+    std::string component;
+
+    /// Wall-clock time spent preparing the component [s]
+    double seconds{ 0.0 };
+
+    /// Heap allocations made while preparing the component
+    std::uint64_t allocations{ 0 };
+
+    /// Heap bytes requested while preparing the component
+    std::uint64_t bytes{ 0 };
+  };
+
+  /// @brief Records the time and memory spent preparing each model component
+  ///
+  /// TuvModel records every component it prepares (grids, solver, radiators,
+  /// the extraterrestrial flux on the wavelength grid) so the cost of
+  /// startup can be split across components. Memory figures come from
+  /// AllocationCounters and are only non-zero in executables that install
+  /// the counting allocator (TUVX_DEFINE_COUNTING_ALLOCATOR); check
+  /// MemoryTracked() before relying on them.
+  ///
+  /// Example usage:
+  /// @code
+  /// TuvModel model(config);
+  /// model.AddStandardRadiators();
+  /// model.PrepareComponents();
+  /// std::fputs(model.StartupProfile().Report().c_str(), stderr);
+  /// @endcode
+  class StartupProfiler
+  {
+   public:
+    /// @brief Run a callable and record its cost under a component name
+    /// @param component Component name
+    /// @param func Callable that prepares the component
+    /// @return Whatever func returns
+    template<typename Func>
+    decltype(auto) Measure(std::string component, Func&& func)
+    {
+      Timer timer(*this, std::move(component));
+      return func();
+    }
+
+    /// @brief Recorded components, in the order they were prepared
+    const std::vector<StartupRecord>& Records() const
+    {
+      return records_;
+    }
+
+    /// @brief Sum of all recorded times [s]
+    double TotalSeconds() const
+    {
+      double total = 0.0;
+      for (const auto& record : records_)
+      {
+        total += record.seconds;
+      }
+      return total;
+    }
+
+    /// @brief Sum of all recorded heap bytes
+    std::uint64_t TotalBytes() const
+    {
+      std::uint64_t total = 0;
+      for (const auto& record : records_)
+      {
+        total += record.bytes;
+      }
+      return total;
+    }
+
+    /// @brief Whether memory figures are being recorded
+    static bool MemoryTracked()
+    {
+      return AllocationCounters::installed.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Format the records as a table, one component per line
+    std::string Report() const
+    {
+      std::string report = "component                        time [ms]   allocs      bytes\n";
+      char line[128];
+      for (const auto& record : records_)
+      {
+        std::snprintf(
+            line,
+            sizeof(line),
+            "%-32s %9.3f %8llu %10llu\n",
+            record.component.c_str(),
+            record.seconds * 1e3,
+            static_cast<unsigned long long>(record.allocations),
+            static_cast<unsigned long long>(record.bytes));
+        report += line;
+      }
+      std::snprintf(
+          line,
+          sizeof(line),
+          "%-32s %9.3f %8s %10llu\n",
+          "total",
+          TotalSeconds() * 1e3,
+          "",
+          static_cast<unsigned long long>(TotalBytes()));
+      report += line;
+      return report;
+    }
+
+    /// @brief Discard all records
+    void Clear()
+    {
+      records_.clear();
+    }
+
+   private:
+    /// Records the elapsed time and allocations when it goes out of scope
+    class Timer
+    {
+     public:
+      Timer(StartupProfiler& profiler, std::string component)
+          : profiler_(profiler),
+            component_(std::move(component)),
+            start_(std::chrono::steady_clock::now())
+      {
+      }
+
+      ~Timer()
+      {
+        auto elapsed = std::chrono::steady_clock::now() - start_;
+        AllocationStats stats = allocations_.Stats();
+        profiler_.records_.push_back(
+            { std::move(component_), std::chrono::duration<double>(elapsed).count(), stats.allocations, stats.bytes });
+      }
+
+      Timer(const Timer&) = delete;
+      Timer& operator=(const Timer&) = delete;
+
+     private:
+      StartupProfiler& profiler_;
+      std::string component_;
+      std::chrono::steady_clock::time_point start_;
+      AllocationScope allocations_;
+    };
+
+    std::vector<StartupRecord> records_;
+  };
+
+}  // namespace tuvx
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <tuvx/util/build_mode.hpp>
+
+#include <cstddef>
+
+namespace tuvx
+{
+  /// @brief Non-owning view over strided host memory
+  ///
+  /// StridedView lets the library read from and write to arrays owned by a
+  /// host model without copying them into std::vector first. Element i lives
+  /// at data[i * stride], so the same type can describe a contiguous C array,
+  /// a Fortran column-major slice, or one field of an array of structs.
+  ///
+  /// Strides are given in elements, not bytes.
+  template<typename T>
+  class StridedView
+  {
+   public:
+    /// @brief Default constructor creates an empty view
+    StridedView() = default;
+
+    /// @brief Construct a view over host memory
+    /// @param data Pointer to the first element
+    /// @param size Number of elements
+    /// @param stride Distance between consecutive elements [elements]
+    StridedView(T* data, std::size_t size, std::ptrdiff_t stride = 1)
+        : data_(data),
+          size_(size),
+          stride_(stride)
+    {
+    }
+
+    /// @brief Access element i
+    T& operator[](std::size_t i) const
+    {
+      return data_[static_cast<std::ptrdiff_t>(i) * stride_];
+    }
+
+    /// @brief Get the number of elements
+    std::size_t Size() const
+    {
+      return size_;
+    }
+
+    /// @brief Check if the view is empty (no data or zero size)
+    bool Empty() const
+    {
+      return data_ == nullptr || size_ == 0;
+    }
+
+    /// @brief Get the pointer to the first element
+    T* Data() const
+    {
+      return data_;
+    }
+
+    /// @brief Get the element stride
+    std::ptrdiff_t Stride() const
+    {
+      return stride_;
+    }
+
+    /// @brief Check if the elements are contiguous in memory
+    bool IsContiguous() const
+    {
+      return stride_ == 1;
+    }
+
+   private:
+    T* data_{ nullptr };
+    std::size_t size_{ 0 };
+    std::ptrdiff_t stride_{ 1 };
+  };
+
+#if !TUVX_HEADER_ONLY
+  // Instantiated once in src/tuvx.cpp
+  extern template class StridedView<double>;
+  extern template class StridedView<const double>;
+#endif
+
+}  // namespace tuvx
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <tuvx/util/internal_error.hpp>
+
+namespace tuvx
+{
+  /// @brief Fixed-size pool of worker threads for data-parallel loops
+  ///
+  /// The calling thread takes part in every loop as worker 0, so a pool of
+  /// size 1 spawns no threads and runs loops inline. Work items are handed
+  /// out dynamically; callers that need reproducible results must make each
+  /// item independent of which worker runs it (see ReproducibleSum).
+  ///
+  /// ParallelFor is not re-entrant: a loop body must not call ParallelFor
+  /// on the same pool.
+  ///
+  /// Example usage:
+  /// @code
+  /// ThreadPool pool(4);
+  /// pool.ParallelFor(n, [&](std::size_t i) { out[i] = f(in[i]); });
+  /// @endcode
+  class ThreadPool
+  {
+   public:
+    /// @brief Create a pool
+    /// @param n_threads Total number of threads including the caller (0 is treated as 1)
+    explicit ThreadPool(std::size_t n_threads = DefaultSize())
+    {
+      std::size_t n_workers = std::max<std::size_t>(n_threads, 1) - 1;
+      workers_.reserve(n_workers);
+      for (std::size_t w = 0; w < n_workers; ++w)
+      {
+        workers_.emplace_back([this, w] { WorkerLoop(w + 1); });
+      }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool()
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+      }
+      work_cv_.notify_all();
+      for (auto& worker : workers_)
+      {
+        worker.join();
+      }
+    }
+
+    /// @brief Number of hardware threads, or 1 if unknown
+    static std::size_t DefaultSize()
+    {
+      return std::max<unsigned>(std::thread::hardware_concurrency(), 1u);
+    }
+
+    /// @brief Total number of threads, including the caller
+    std::size_t Size() const
+    {
+      return workers_.size() + 1;
+    }
+
+    /// @brief Run func for every index in [0, n) and wait for completion
+    /// @param n Number of work items
+    /// @param func Callable as func(index) or func(index, worker), where
+    ///             worker in [0, Size()) identifies the executing thread
+    ///
+    /// The first exception thrown by a work item is rethrown to the caller
+    /// once all workers have stopped.
+    template<typename Func>
+    void ParallelFor(std::size_t n, Func&& func)
+    {
+      auto body = [&func](std::size_t index, std::size_t worker)
+      {
+        if constexpr (std::is_invocable_v<Func&, std::size_t, std::size_t>)
+        {
+          func(index, worker);
+        }
+        else
+        {
+          func(index);
+        }
+      };
+
+      if (workers_.empty() || n <= 1)
+      {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+          body(i, 0);
+        }
+        return;
+      }
+
+      std::function<void(std::size_t, std::size_t)> job(body);
+      Run(job, n, false);
+    }
+
+    /// @brief Run func once on every thread of the pool and wait for completion
+    /// @param func Callable as func(worker), where worker in [0, Size()) identifies the executing thread
+    ///
+    /// Unlike ParallelFor, each call is guaranteed to run on the thread it
+    /// names, which is what per-thread setup (CPU pinning, first-touch of
+    /// thread-owned memory) needs. Exceptions are handled as in ParallelFor.
+    template<typename Func>
+    void ForEachWorker(Func&& func)
+    {
+      if (workers_.empty())
+      {
+        func(std::size_t{ 0 });
+        return;
+      }
+      std::function<void(std::size_t, std::size_t)> job([&func](std::size_t, std::size_t worker) { func(worker); });
+      Run(job, Size(), true);
+    }
+
+   private:
+    void Run(const std::function<void(std::size_t, std::size_t)>& job, std::size_t n, bool per_worker)
+    {
+      std::lock_guard<std::mutex> submit_lock(submit_mutex_);
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = &job;
+        job_size_ = n;
+        per_worker_ = per_worker;
+        next_.store(0, std::memory_order_relaxed);
+        active_ = workers_.size();
+        error_ = nullptr;
+        ++generation_;
+      }
+      work_cv_.notify_all();
+
+      RunJob(job, n, per_worker, 0);
+
+      std::unique_lock<std::mutex> lock(mutex_);
+      done_cv_.wait(lock, [this] { return active_ == 0; });
+      job_ = nullptr;
+      if (error_)
+      {
+        std::rethrow_exception(error_);
+      }
+    }
+
+    void RunJob(const std::function<void(std::size_t, std::size_t)>& job, std::size_t n, bool per_worker, std::size_t worker)
+    {
+      if (per_worker)
+      {
+        RunItem(job, worker, n, worker);
+        return;
+      }
+      for (std::size_t i = next_.fetch_add(1, std::memory_order_relaxed); i < n;
+           i = next_.fetch_add(1, std::memory_order_relaxed))
+      {
+        RunItem(job, i, n, worker);
+      }
+    }
+
+    void RunItem(const std::function<void(std::size_t, std::size_t)>& job, std::size_t i, std::size_t n, std::size_t worker)
+    {
+#if TUVX_EXCEPTIONS
+      try
+      {
+        job(i, worker);
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!error_)
+        {
+          error_ = std::current_exception();
+        }
+        next_.store(n, std::memory_order_relaxed);
+      }
+#else
+      (void)n;
+      job(i, worker);
+#endif
+    }
+
+    void WorkerLoop(std::size_t worker)
+    {
+      std::uint64_t seen = 0;
+      while (true)
+      {
+        const std::function<void(std::size_t, std::size_t)>* job = nullptr;
+        std::size_t n = 0;
+        bool per_worker = false;
+        {
+          std::unique_lock<std::mutex> lock(mutex_);
+          work_cv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+          if (stop_)
+          {
+            return;
+          }
+          seen = generation_;
+          job = job_;
+          n = job_size_;
+          per_worker = per_worker_;
+        }
+
+        RunJob(*job, n, per_worker, worker);
+
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          if (--active_ == 0)
+          {
+            done_cv_.notify_one();
+          }
+        }
+      }
+    }
+
+    std::vector<std::thread> workers_;
+    std::mutex submit_mutex_;
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    const std::function<void(std::size_t, std::size_t)>* job_{ nullptr };
+    std::size_t job_size_{ 0 };
+    bool per_worker_{ false };
+    std::atomic<std::size_t> next_{ 0 };
+    std::size_t active_{ 0 };
+    std::uint64_t generation_{ 0 };
+    std::exception_ptr error_;
+    bool stop_{ false };
+  };
+
+  /// @brief Contiguous block of [0, n) owned by one of n_parts owners
+  /// @param n Number of items
+  /// @param part Owner index in [0, n_parts)
+  /// @param n_parts Number of owners
+  /// @return Half-open range {begin, end}; blocks differ in size by at most one item
+  ///
+  /// Used with ThreadPool::ForEachWorker wherever data placed by one worker
+  /// must later be processed by the same worker.
+  inline std::pair<std::size_t, std::size_t> StaticBlock(std::size_t n, std::size_t part, std::size_t n_parts)
+  {
+    return { n * part / n_parts, n * (part + 1) / n_parts };
+  }
+
+}  // namespace tuvx
@@ -0,0 +1,247 @@
+#!/usr/bin/env python3
+"""
+Plot TUV-x scaling study results.
+
+Usage:
+    # Generate CSV data (progress goes to stderr)
+    ./build/test/benchmark/scaling_study > plots/scaling.csv
+
+    # Create plots
+    python scripts/plot_scaling_study.py plots/scaling.csv -o plots/scaling
+
+    # Or pipe directly
+    ./build/test/benchmark/scaling_study --studies strong,weak | python scripts/plot_scaling_study.py -o plots/scaling
+"""
+
+import sys
+import argparse
+import pandas as pd
+import numpy as np
+import matplotlib.pyplot as plt
+import seaborn as sns
+
+# Set style - seaborn with enhanced aesthetics
+sns.set_theme(style="whitegrid", context="talk", palette="deep")
+sns.set_style("whitegrid", {
+    'grid.linestyle': '--',
+    'grid.alpha': 0.6,
+    'axes.edgecolor': '0.2',
+    'axes.linewidth': 1.2,
+})
+
+# Font and figure settings
+plt.rcParams.update({
+    'figure.dpi': 300,
+    'savefig.dpi': 300,
+    'text.usetex': False,
+    'mathtext.fontset': 'dejavusans',
+    'font.family': 'sans-serif',
+    'font.sans-serif': ['DejaVu Sans', 'Helvetica', 'Arial'],
+    'font.size': 14,
+    'axes.titlesize': 16,
+    'axes.labelsize': 14,
+    'xtick.labelsize': 12,
+    'ytick.labelsize': 12,
+    'legend.fontsize': 12,
+    'figure.titlesize': 18,
+    'axes.titleweight': 'bold',
+    'axes.labelweight': 'medium',
+})
+
+# Swept dimension for each size study
+SIZE_STUDIES = {
+    'layers': 'Altitude Layers',
+    'wavelengths': 'Wavelength Bins',
+    'reactions': 'Reactions',
+    'batch': 'Batch Size (columns)',
+}
+
+
+def load_data(source):
+    """Load CSV data from file or stdin."""
+    if source == '-' or source is None:
+        return pd.read_csv(sys.stdin)
+    return pd.read_csv(source)
+
+
+def save_figure(fig, output_prefix, name):
+    """Save figure in both PNG and PDF formats."""
+    png_path = f'{output_prefix}_{name}.png'
+    pdf_path = f'{output_prefix}_{name}.pdf'
+    fig.savefig(png_path, dpi=300, bbox_inches='tight')
+    fig.savefig(pdf_path, bbox_inches='tight')
+    print(f"Saved: {png_path}, {pdf_path}")
+
+
+def plot_strong_scaling(df, output_prefix):
+    """Plot strong scaling: fixed batch, speedup and efficiency vs threads."""
+    data = df[df['study'] == 'strong'].sort_values('threads')
+
+    if data.empty:
+        print("No strong scaling data found")
+        return
+
+    base = data.iloc[0]
+    threads = data['threads'].to_numpy()
+    speedup = data['throughput_columns_per_s'].to_numpy() / base['throughput_columns_per_s']
+    efficiency = speedup / (threads / base['threads'])
+
+    fig, axes = plt.subplots(1, 2, figsize=(14, 6))
+
+    # Left: speedup vs ideal
+    ax1 = axes[0]
+    ax1.plot(threads, speedup, 'o-', linewidth=2.5, markersize=9, label='Measured')
+    ax1.plot(threads, threads / base['threads'], '--', color='#555555', alpha=0.7,
+             linewidth=2, label='Ideal')
+    ax1.set_xscale('log', base=2)
+    ax1.set_yscale('log', base=2)
+    ax1.set_xlabel('Threads')
+    ax1.set_ylabel('Speedup')
+    ax1.set_title(f"Strong Scaling (batch = {int(base['batch'])})")
+    ax1.legend(framealpha=0.9, loc='upper left')
+
+    # Right: parallel efficiency
+    ax2 = axes[1]
+    ax2.plot(threads, efficiency * 100, 'o-', linewidth=2.5, markersize=9,
+             color=sns.color_palette("deep")[1])
+    ax2.axhline(y=100, color='#555555', linestyle='--', linewidth=2, alpha=0.7)
+    ax2.set_xscale('log', base=2)
+    ax2.set_ylim(0, 110)
+    ax2.set_xlabel('Threads')
+    ax2.set_ylabel('Parallel Efficiency (%)')
+    ax2.set_title('Strong Scaling Efficiency')
+
+    plt.tight_layout(pad=2.0)
+    save_figure(fig, output_prefix, 'strong')
+    plt.close()
+
+
+def plot_weak_scaling(df, output_prefix):
+    """Plot weak scaling: batch grows with threads, efficiency from latency."""
+    data = df[df['study'] == 'weak'].sort_values('threads')
+
+    if data.empty:
+        print("No weak scaling data found")
+        return
+
+    base = data.iloc[0]
+    threads = data['threads'].to_numpy()
+    efficiency = base['latency_mean_ms'] / data['latency_mean_ms'].to_numpy()
+
+    fig, axes = plt.subplots(1, 2, figsize=(14, 6))
+
+    # Left: throughput vs ideal
+    ax1 = axes[0]
+    ax1.plot(threads, data['throughput_columns_per_s'], 'o-', linewidth=2.5, markersize=9,
+             label='Measured')
+    ax1.plot(threads, base['throughput_columns_per_s'] * threads / base['threads'], '--',
+             color='#555555', alpha=0.7, linewidth=2, label='Ideal')
+    ax1.set_xscale('log', base=2)
+    ax1.set_yscale('log')
+    ax1.set_xlabel('Threads')
+    ax1.set_ylabel('Throughput (columns/s)')
+    per_thread = int(base['batch'] / base['threads'])
+    ax1.set_title(f'Weak Scaling ({per_thread} columns/thread)')
+    ax1.legend(framealpha=0.9, loc='upper left')
+
+    # Right: weak scaling efficiency
+    ax2 = axes[1]
+    ax2.plot(threads, efficiency * 100, 'o-', linewidth=2.5, markersize=9,
+             color=sns.color_palette("deep")[1])
+    ax2.axhline(y=100, color='#555555', linestyle='--', linewidth=2, alpha=0.7)
+    ax2.set_xscale('log', base=2)
+    ax2.set_ylim(0, 110)
+    ax2.set_xlabel('Threads')
+    ax2.set_ylabel('Weak Scaling Efficiency (%)')
+    ax2.set_title('Weak Scaling Efficiency')
+
+    plt.tight_layout(pad=2.0)
+    save_figure(fig, output_prefix, 'weak')
+    plt.close()
+
+
+def plot_size_scaling(df, output_prefix):
+    """Plot throughput, latency percentiles and peak RSS vs each swept dimension."""
+    studies = [s for s in SIZE_STUDIES if not df[df['study'] == s].empty]
+
+    if not studies:
+        print("No size scaling data found")
+        return
+
+    fig, axes = plt.subplots(3, len(studies), figsize=(6 * len(studies), 15), squeeze=False)
+    palette = sns.color_palette("deep")
+
+    for col, study in enumerate(studies):
+        data = df[df['study'] == study].sort_values(study)
+        x = data[study].to_numpy()
+
+        # Row 1: throughput with a fitted power law to show the cost exponent
+        ax = axes[0][col]
+        throughput = data['throughput_columns_per_s'].to_numpy()
+        ax.plot(x, throughput, 'o-', linewidth=2.5, markersize=9, color=palette[0])
+        if len(x) >= 2 and np.all(x > 0) and np.all(throughput > 0):
+            slope, _ = np.polyfit(np.log(x), np.log(throughput), 1)
+            ax.text(0.95, 0.95, f'throughput ~ n^{slope:.2f}', transform=ax.transAxes,
+                    ha='right', va='top', fontsize=12,
+                    bbox=dict(boxstyle='round,pad=0.3', facecolor='white', alpha=0.8))
+        ax.set_xscale('log')
+        ax.set_yscale('log')
+        ax.set_xlabel(SIZE_STUDIES[study])
+        ax.set_ylabel('Throughput (columns/s)')
+        ax.set_title(f'Throughput vs {SIZE_STUDIES[study]}')
+
+        # Row 2: latency percentiles
+        ax = axes[1][col]
+        for p, color in zip(['p50', 'p95', 'p99'], palette[1:4]):
+            ax.plot(x, data[f'latency_{p}_ms'], 'o-', linewidth=2, markersize=7,
+                    color=color, label=p)
+        ax.set_xscale('log')
+        ax.set_yscale('log')
+        ax.set_xlabel(SIZE_STUDIES[study])
+        ax.set_ylabel('Batch Latency (ms)')
+        ax.set_title('Latency Percentiles')
+        ax.legend(framealpha=0.9, loc='upper left')
+
+        # Row 3: peak resident set size
+        ax = axes[2][col]
+        ax.plot(x, data['peak_rss_mb'], 'o-', linewidth=2.5, markersize=9, color=palette[4])
+        ax.set_xscale('log')
+        ax.set_xlabel(SIZE_STUDIES[study])
+        ax.set_ylabel('Peak RSS (MB)')
+        ax.set_title('Peak Memory')
+
+    plt.tight_layout(pad=2.0)
+    save_figure(fig, output_prefix, 'size')
+    plt.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Plot TUV-x scaling study results')
+    parser.add_argument('input', nargs='?', default='-',
+                        help='Input CSV file (default: stdin)')
+    parser.add_argument('-o', '--output', default='scaling',
+                        help='Output prefix for plots (default: scaling)')
+    args = parser.parse_args()
+
+    print(f"Loading data from {'stdin' if args.input == '-' else args.input}...")
+    df = load_data(args.input)
+    print(f"Loaded {len(df)} configurations")
+    print(f"Studies: {', '.join(df['study'].unique())}")
+
+    # Create output directory if needed
+    import os
+    output_dir = os.path.dirname(args.output)
+    if output_dir and not os.path.exists(output_dir):
+        os.makedirs(output_dir)
+
+    # Generate plots
+    print("\nGenerating plots...")
+    plot_strong_scaling(df, args.output)
+    plot_weak_scaling(df, args.output)
+    plot_size_scaling(df, args.output)
+
+    print("\nDone!")
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,283 @@
+// TUV-x C API implementation
+//
+// Thin extern "C" layer over BatchDriver. Exceptions never cross the C
+// boundary: each entry point translates them into the error codes defined
+// in <tuvx/util/error.hpp>.
+
+#include <tuvx/c_api/tuvx_c.h>
+#include <tuvx/cross_section/types/base.hpp>
+#include <tuvx/cross_section/types/o3.hpp>
+#include <tuvx/model/batch_driver.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/quantum_yield/types/base.hpp>
+#include <tuvx/quantum_yield/types/o3_o1d.hpp>
+#include <tuvx/util/internal_error.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// @brief C handle: a model plus the cross-sections and quantum yields it references
+struct tuvx_model
+{
+  explicit tuvx_model(const tuvx::ModelConfig& config)
+      : model(config)
+  {
+  }
+
+  tuvx::TuvModel model;
+  std::vector<std::unique_ptr<tuvx::CrossSection>> cross_sections;
+  std::vector<std::unique_ptr<tuvx::QuantumYield>> quantum_yields;
+};
+
+namespace
+{
+  /// @brief Run a callable, translating exceptions into C error codes
+  template<typename Func>
+  int Guard(Func&& func)
+  {
+    try
+    {
+      func();
+      return TUVX_SUCCESS;
+    }
+    catch (const tuvx::TuvxInternalException& e)
+    {
+      // General shares its numeric value with a configuration code, so it maps to the C API's general code
+      int code = e.code().value();
+      return code == static_cast<int>(tuvx::TuvxInternalErrc::General) ? TUVX_INTERNAL_ERROR_CODE_GENERAL : code;
+    }
+    catch (...)
+    {
+      return TUVX_INTERNAL_ERROR_CODE_GENERAL;
+    }
+  }
+
+  tuvx::ModelConfig ToModelConfig(const tuvx_model_config& c)
+  {
+    tuvx::ModelConfig config;
+    config.wavelength_min = c.wavelength_min;
+    config.wavelength_max = c.wavelength_max;
+    config.n_wavelength_bins = c.n_wavelength_bins;
+    config.altitude_min = c.altitude_min;
+    config.altitude_max = c.altitude_max;
+    config.n_altitude_layers = c.n_altitude_layers;
+    config.day_of_year = c.day_of_year;
+    config.earth_sun_distance = c.earth_sun_distance;
+    config.surface_albedo = c.surface_albedo;
+    config.ozone_column_DU = c.ozone_column_du;
+    config.use_spherical_geometry = c.use_spherical_geometry != 0;
+    return config;
+  }
+}  // namespace
+
+extern "C"
+{
+  void tuvx_model_config_default(tuvx_model_config* config)
+  {
+    if (config == nullptr)
+    {
+      return;
+    }
+    tuvx::ModelConfig defaults;
+    config->wavelength_min = defaults.wavelength_min;
+    config->wavelength_max = defaults.wavelength_max;
+    config->n_wavelength_bins = defaults.n_wavelength_bins;
+    config->altitude_min = defaults.altitude_min;
+    config->altitude_max = defaults.altitude_max;
+    config->n_altitude_layers = defaults.n_altitude_layers;
+    config->day_of_year = defaults.day_of_year;
+    config->earth_sun_distance = defaults.earth_sun_distance;
+    config->surface_albedo = defaults.surface_albedo;
+    config->ozone_column_du = defaults.ozone_column_DU;
+    config->use_spherical_geometry = defaults.use_spherical_geometry ? 1 : 0;
+  }
+
+  tuvx_model* tuvx_model_create(const tuvx_model_config* config, int* error)
+  {
+    tuvx_model* model = nullptr;
+    int code = TUVX_SUCCESS;
+    if (config == nullptr)
+    {
+      code = TUVX_CONFIGURATION_ERROR_CODE_MISSING_KEY;
+    }
+    else
+    {
+      tuvx::ModelConfig model_config = ToModelConfig(*config);
+      if (!model_config.IsValid())
+      {
+        code = TUVX_CONFIGURATION_ERROR_CODE_INVALID_KEY;
+      }
+      else
+      {
+        code = Guard([&] { model = new tuvx_model(model_config); });
+      }
+    }
+    if (error != nullptr)
+    {
+      *error = code;
+    }
+    return model;
+  }
+
+  void tuvx_model_destroy(tuvx_model* model)
+  {
+    delete model;
+  }
+
+  int tuvx_model_add_standard_radiators(tuvx_model* model)
+  {
+    if (model == nullptr)
+    {
+      return TUVX_INTERNAL_ERROR_CODE_GENERAL;
+    }
+    return Guard([&] { model->model.AddStandardRadiators(); });
+  }
+
+  int tuvx_model_add_aerosol_radiator(tuvx_model* model)
+  {
+    if (model == nullptr)
+    {
+      return TUVX_INTERNAL_ERROR_CODE_GENERAL;
+    }
+    return Guard([&] { model->model.AddAerosolRadiator(); });
+  }
+
+  int tuvx_model_add_builtin_reaction(tuvx_model* model, const char* name)
+  {
+    if (model == nullptr || name == nullptr)
+    {
+      return TUVX_INTERNAL_ERROR_CODE_GENERAL;
+    }
+    std::string reaction(name);
+    std::unique_ptr<tuvx::QuantumYield> quantum_yield;
+    if (reaction == "O3 -> O2 + O(1D)")
+    {
+      quantum_yield = std::make_unique<tuvx::O3O1DQuantumYield>();
+    }
+    else if (reaction == "O3 -> O2 + O(3P)")
+    {
+      quantum_yield = std::make_unique<tuvx::O3O3PQuantumYield>();
+    }
+    else
+    {
+      return TUVX_CONFIGURATION_ERROR_CODE_INVALID_KEY;
+    }
+    return Guard(
+        [&]
+        {
+          model->cross_sections.push_back(std::make_unique<tuvx::O3CrossSection>());
+          model->quantum_yields.push_back(std::move(quantum_yield));
+          model->model.AddPhotolysisReaction(
+              reaction, model->cross_sections.back().get(), model->quantum_yields.back().get());
+        });
+  }
+
+  int tuvx_model_add_tabulated_reaction(
+      tuvx_model* model,
+      const char* name,
+      size_t n_points,
+      const double* wavelengths,
+      const double* cross_sections,
+      double quantum_yield)
+  {
+    if (model == nullptr || name == nullptr || wavelengths == nullptr || cross_sections == nullptr)
+    {
+      return TUVX_INTERNAL_ERROR_CODE_GENERAL;
+    }
+    if (n_points < 2)
+    {
+      return TUVX_RADIATOR_ERROR_CODE_INVALID_DATA;
+    }
+    return Guard(
+        [&]
+        {
+          std::string reaction(name);
+          model->cross_sections.push_back(std::make_unique<tuvx::BaseCrossSection>(
+              reaction,
+              std::vector<double>(wavelengths, wavelengths + n_points),
+              std::vector<double>(cross_sections, cross_sections + n_points)));
+          model->quantum_yields.push_back(
+              std::make_unique<tuvx::ConstantQuantumYield>(reaction, reaction, reaction, quantum_yield));
+          model->model.AddPhotolysisReaction(
+              reaction, model->cross_sections.back().get(), model->quantum_yields.back().get());
+        });
+  }
+
+  size_t tuvx_model_number_of_layers(const tuvx_model* model)
+  {
+    return model == nullptr ? 0 : model->model.AltitudeGrid().Spec().n_cells;
+  }
+
+  size_t tuvx_model_number_of_levels(const tuvx_model* model)
+  {
+    return model == nullptr ? 0 : model->model.AltitudeGrid().Spec().n_cells + 1;
+  }
+
+  size_t tuvx_model_number_of_wavelengths(const tuvx_model* model)
+  {
+    return model == nullptr ? 0 : model->model.WavelengthGrid().Spec().n_cells;
+  }
+
+  size_t tuvx_model_number_of_reactions(const tuvx_model* model)
+  {
+    return model == nullptr ? 0 : model->model.PhotolysisReactions().Size();
+  }
+
+  int tuvx_model_reaction_name(const tuvx_model* model, size_t index, char* buffer, size_t buffer_size)
+  {
+    if (model == nullptr || buffer == nullptr || buffer_size == 0)
+    {
+      return TUVX_INTERNAL_ERROR_CODE_GENERAL;
+    }
+    auto names = model->model.PhotolysisReactions().ReactionNames();
+    if (index >= names.size())
+    {
+      return TUVX_CONFIGURATION_ERROR_CODE_INVALID_KEY;
+    }
+    std::size_t n = std::min(names[index].size(), buffer_size - 1);
+    std::memcpy(buffer, names[index].data(), n);
+    buffer[n] = '\0';
+    return TUVX_SUCCESS;
+  }
+
+  int tuvx_model_calculate_batch(tuvx_model* model, const tuvx_column_batch* batch, const tuvx_rate_array* rates)
+  {
+    if (model == nullptr || batch == nullptr || rates == nullptr)
+    {
+      return TUVX_INTERNAL_ERROR_CODE_GENERAL;
+    }
+    if (batch->n_columns > 0 && batch->solar_zenith_angle == nullptr)
+    {
+      return TUVX_CONFIGURATION_ERROR_CODE_MISSING_KEY;
+    }
+    if (batch->n_layers != model->model.AltitudeGrid().Spec().n_cells)
+    {
+      return TUVX_PROFILE_ERROR_CODE_INVALID_SIZE;
+    }
+    if (batch->n_columns > 0 && rates->data == nullptr)
+    {
+      return TUVX_INTERNAL_ERROR_CODE_GENERAL;
+    }
+
+    tuvx::ColumnBatchView view;
+    view.n_columns = batch->n_columns;
+    view.n_layers = batch->n_layers;
+    view.solar_zenith_angle =
+        tuvx::StridedView<const double>(batch->solar_zenith_angle, batch->n_columns, batch->solar_zenith_angle_stride);
+    if (batch->surface_albedo != nullptr)
+    {
+      view.surface_albedo =
+          tuvx::StridedView<const double>(batch->surface_albedo, batch->n_columns, batch->surface_albedo_stride);
+    }
+    view.temperature = { batch->temperature, batch->temperature_column_stride, batch->temperature_layer_stride };
+    view.air_density = { batch->air_density, batch->air_density_column_stride, batch->air_density_layer_stride };
+    view.ozone = { batch->ozone, batch->ozone_column_stride, batch->ozone_layer_stride };
+
+    tuvx::RateBatchView rate_view{ rates->data, rates->column_stride, rates->reaction_stride, rates->level_stride };
+
+    return Guard([&] { tuvx::BatchDriver(model->model).Calculate(view, rate_view); });
+  }
+}
@@ -0,0 +1,160 @@
+// Photolysis service daemon
+//
+// Keeps one prepared TuvModel resident and answers PhotolysisClient
+// requests on a Unix domain socket until it receives SIGINT or SIGTERM.
+// Tools on the node connect to the socket instead of building their own
+// model, so the startup cost is paid once per node.
+//
+// Usage:
+//   tuvx_photolysisd --socket /tmp/tuvx.sock
+//   tuvx_photolysisd --socket /tmp/tuvx.sock --threads 8 --layers 80 --wavelength-bins 140
+//
+// The model has the standard radiators, an optional aerosol radiator and the
+// built-in O3 photolysis reactions.
+
+#include <tuvx/cross_section/types/o3.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/quantum_yield/types/o3_o1d.hpp>
+#include <tuvx/service/photolysis_server.hpp>
+#include <tuvx/util/thread_pool.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace
+{
+  using namespace tuvx;
+
+  /// Set by the signal handler; polled by main
+  std::atomic<bool> g_stop{ false };
+
+  void HandleSignal(int)
+  {
+    g_stop.store(true);
+  }
+
+  /// Command-line options
+  struct Options
+  {
+    PhotolysisServerConfig server;
+    std::size_t threads{ ThreadPool::DefaultSize() };
+    std::size_t layers{ 80 };
+    std::size_t wavelength_bins{ 140 };
+    double aerosol_optical_depth{ 0.0 };
+  };
+
+  void PrintUsage()
+  {
+    std::cerr << "usage: tuvx_photolysisd --socket PATH [--threads N] [--layers N] [--wavelength-bins N]\n"
+              << "                        [--aerosol-optical-depth X] [--max-columns N] [--max-clients N]\n";
+  }
+
+  Options ParseOptions(int argc, char** argv)
+  {
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+      std::string arg = argv[i];
+      auto value = [&]() -> std::string
+      {
+        if (i + 1 >= argc)
+        {
+          throw std::invalid_argument("missing value for " + arg);
+        }
+        return argv[++i];
+      };
+      if (arg == "--socket")
+      {
+        options.server.socket_path = value();
+      }
+      else if (arg == "--threads")
+      {
+        options.threads = std::stoul(value());
+      }
+      else if (arg == "--layers")
+      {
+        options.layers = std::stoul(value());
+      }
+      else if (arg == "--wavelength-bins")
+      {
+        options.wavelength_bins = std::stoul(value());
+      }
+      else if (arg == "--aerosol-optical-depth")
+      {
+        options.aerosol_optical_depth = std::stod(value());
+      }
+      else if (arg == "--max-columns")
+      {
+        options.server.max_columns_per_request = std::stoul(value());
+      }
+      else if (arg == "--max-clients")
+      {
+        options.server.max_clients = std::stoul(value());
+      }
+      else
+      {
+        throw std::invalid_argument("unknown option " + arg);
+      }
+    }
+    if (options.server.socket_path.empty())
+    {
+      throw std::invalid_argument("--socket is required");
+    }
+    return options;
+  }
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  try
+  {
+    Options options = ParseOptions(argc, argv);
+
+    ModelConfig config;
+    config.n_altitude_layers = options.layers;
+    config.n_wavelength_bins = options.wavelength_bins;
+    O3CrossSection o3_xs;
+    O3O1DQuantumYield o3_o1d_qy;
+    O3O3PQuantumYield o3_o3p_qy;
+    TuvModel model(config);
+    model.AddStandardRadiators();
+    if (options.aerosol_optical_depth > 0.0)
+    {
+      AerosolRadiator::Config aerosol;
+      aerosol.optical_depth_ref = options.aerosol_optical_depth;
+      model.AddAerosolRadiator(aerosol);
+    }
+    model.AddPhotolysisReaction("O3 -> O2 + O(1D)", &o3_xs, &o3_o1d_qy);
+    model.AddPhotolysisReaction("O3 -> O2 + O(3P)", &o3_xs, &o3_o3p_qy);
+
+    ThreadPool pool(options.threads);
+    PhotolysisServer server(model, pool, options.server);
+    std::signal(SIGINT, HandleSignal);
+    std::signal(SIGTERM, HandleSignal);
+    server.Start();
+    std::cerr << "tuvx_photolysisd: serving " << options.layers << " layers x " << options.wavelength_bins
+              << " wavelengths on " << server.SocketPath() << " with " << pool.Size() << " threads\n";
+
+    while (!g_stop.load())
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    server.Stop();
+    auto stats = server.Stats();
+    std::cerr << "tuvx_photolysisd: " << stats.connections << " connections, " << stats.requests << " requests, "
+              << stats.columns << " columns, " << stats.errors << " errors\n";
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "tuvx_photolysisd: " << e.what() << "\n";
+    PrintUsage();
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,21 @@
+// Precompiled TUV-x library
+//
+// Built only with TUVX_BUILD_COMPILED. Compiles the out-of-line definitions
+// from the *-inl.hpp files and the explicit template instantiations once, so
+// consumers only parse declarations.
+
+#if !defined(TUVX_COMPILED_LIBRARY)
+  #error "src/tuvx.cpp is only built with TUVX_BUILD_COMPILED"
+#endif
+
+#include <tuvx/cross_section/types/o2-inl.hpp>
+#include <tuvx/cross_section/types/o3-inl.hpp>
+#include <tuvx/model/tuv_model-inl.hpp>
+#include <tuvx/solver/delta_eddington-inl.hpp>
+#include <tuvx/util/strided_view.hpp>
+
+namespace tuvx
+{
+  template class StridedView<double>;
+  template class StridedView<const double>;
+}  // namespace tuvx
@@ -0,0 +1,148 @@
+// Band aggregation accuracy and speed study
+//
+// Derives coarse band grids of several sizes from the production model
+// (80 layers x 140 wavelength bins, standard radiators, O3 photolysis) with
+// BandAggregation and compares each band model with the fine model on random
+// columns. Writes one CSV row per band count and reaction to stdout.
+//
+// Usage:
+//   ./build/test/benchmark/band_aggregation > band_aggregation.csv
+//   ./build/test/benchmark/band_aggregation --bands 12,18,30 --columns 500
+//   ./build/test/benchmark/band_aggregation --quick
+
+#include <tuvx/cross_section/types/o3.hpp>
+#include <tuvx/model/band_aggregation.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/quantum_yield/types/o3_o1d.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+  using namespace tuvx;
+
+  /// Command-line options
+  struct Options
+  {
+    std::vector<std::size_t> bands{ 12, 18, 24, 36 };
+    std::size_t columns{ 200 };
+    std::size_t layers{ 80 };
+    std::size_t wavelength_bins{ 140 };
+    std::uint64_t seed{ 42 };
+  };
+
+  void PrintUsage()
+  {
+    std::cerr << "usage: band_aggregation [--bands N,N,...] [--columns N] [--layers N] [--wavelength-bins N]\n"
+              << "                        [--seed N] [--quick]\n";
+  }
+
+  std::vector<std::size_t> ParseList(const std::string& text)
+  {
+    std::vector<std::size_t> values;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+      values.push_back(std::stoul(item));
+    }
+    return values;
+  }
+
+  Options ParseOptions(int argc, char** argv)
+  {
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+      std::string arg = argv[i];
+      auto value = [&]() -> std::string
+      {
+        if (i + 1 >= argc)
+        {
+          throw std::invalid_argument("missing value for " + arg);
+        }
+        return argv[++i];
+      };
+      if (arg == "--bands")
+      {
+        options.bands = ParseList(value());
+      }
+      else if (arg == "--columns")
+      {
+        options.columns = std::stoul(value());
+      }
+      else if (arg == "--layers")
+      {
+        options.layers = std::stoul(value());
+      }
+      else if (arg == "--wavelength-bins")
+      {
+        options.wavelength_bins = std::stoul(value());
+      }
+      else if (arg == "--seed")
+      {
+        options.seed = std::stoull(value());
+      }
+      else if (arg == "--quick")
+      {
+        options.bands = { 8, 18 };
+        options.columns = 4;
+        options.layers = 20;
+        options.wavelength_bins = 60;
+      }
+      else
+      {
+        throw std::invalid_argument("unknown option " + arg);
+      }
+    }
+    return options;
+  }
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  try
+  {
+    Options options = ParseOptions(argc, argv);
+
+    ModelConfig config;
+    config.n_altitude_layers = options.layers;
+    config.n_wavelength_bins = options.wavelength_bins;
+    O3CrossSection o3_xs;
+    O3O1DQuantumYield o3_o1d_qy;
+    O3O3PQuantumYield o3_o3p_qy;
+    TuvModel fine(config);
+    fine.AddStandardRadiators();
+    fine.AddPhotolysisReaction("O3 -> O2 + O(1D)", &o3_xs, &o3_o1d_qy);
+    fine.AddPhotolysisReaction("O3 -> O2 + O(3P)", &o3_xs, &o3_o3p_qy);
+
+    std::cout << "fine_bins,bands,columns,fine_s,band_s,speedup,reaction,max_relative_error,rms_relative_error\n";
+    for (std::size_t n_bands : options.bands)
+    {
+      BandAggregationConfig band_config;
+      band_config.n_bands = n_bands;
+      BandAggregation bands(fine, band_config);
+      auto report = bands.Evaluate(fine, options.columns, options.seed);
+      for (const auto& reaction : report.reactions)
+      {
+        std::cout << report.n_fine_bins << "," << report.n_bands << "," << report.n_columns << ","
+                  << report.fine_seconds << "," << report.band_seconds << "," << report.Speedup() << ",\""
+                  << reaction.reaction_name << "\"," << reaction.max_relative_error << ","
+                  << reaction.rms_relative_error << "\n";
+      }
+    }
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "band_aggregation: " << e.what() << "\n";
+    PrintUsage();
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,160 @@
+// PCA-accelerated radiative transfer accuracy and speed study
+//
+// Runs the production model (80 layers x 140 wavelength bins, standard
+// radiators, O3 photolysis) with PcaSolver at several spectral bin sizes and
+// compares it with the full Delta-Eddington solve on random columns. Writes
+// one CSV row per bin size and reaction to stdout.
+//
+// Usage:
+//   ./build/test/benchmark/pca_solver > pca_solver.csv
+//   ./build/test/benchmark/pca_solver --bin-sizes 10,20,35 --components 1 --columns 500
+//   ./build/test/benchmark/pca_solver --quick
+
+#include <tuvx/cross_section/types/o3.hpp>
+#include <tuvx/model/pca_accuracy.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/quantum_yield/types/o3_o1d.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+  using namespace tuvx;
+
+  /// Command-line options
+  struct Options
+  {
+    std::vector<std::size_t> bin_sizes{ 10, 14, 20, 28, 35 };
+    std::size_t components{ 2 };
+    bool second_order{ true };
+    std::size_t columns{ 200 };
+    std::size_t layers{ 80 };
+    std::size_t wavelength_bins{ 140 };
+    std::uint64_t seed{ 42 };
+  };
+
+  void PrintUsage()
+  {
+    std::cerr << "usage: pca_solver [--bin-sizes N,N,...] [--components N] [--first-order] [--columns N]\n"
+              << "                  [--layers N] [--wavelength-bins N] [--seed N] [--quick]\n";
+  }
+
+  std::vector<std::size_t> ParseList(const std::string& text)
+  {
+    std::vector<std::size_t> values;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+      values.push_back(std::stoul(item));
+    }
+    return values;
+  }
+
+  Options ParseOptions(int argc, char** argv)
+  {
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+      std::string arg = argv[i];
+      auto value = [&]() -> std::string
+      {
+        if (i + 1 >= argc)
+        {
+          throw std::invalid_argument("missing value for " + arg);
+        }
+        return argv[++i];
+      };
+      if (arg == "--bin-sizes")
+      {
+        options.bin_sizes = ParseList(value());
+      }
+      else if (arg == "--components")
+      {
+        options.components = std::stoul(value());
+      }
+      else if (arg == "--first-order")
+      {
+        options.second_order = false;
+      }
+      else if (arg == "--columns")
+      {
+        options.columns = std::stoul(value());
+      }
+      else if (arg == "--layers")
+      {
+        options.layers = std::stoul(value());
+      }
+      else if (arg == "--wavelength-bins")
+      {
+        options.wavelength_bins = std::stoul(value());
+      }
+      else if (arg == "--seed")
+      {
+        options.seed = std::stoull(value());
+      }
+      else if (arg == "--quick")
+      {
+        options.bin_sizes = { 5, 12 };
+        options.columns = 4;
+        options.layers = 20;
+        options.wavelength_bins = 60;
+      }
+      else
+      {
+        throw std::invalid_argument("unknown option " + arg);
+      }
+    }
+    return options;
+  }
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  try
+  {
+    Options options = ParseOptions(argc, argv);
+
+    ModelConfig config;
+    config.n_altitude_layers = options.layers;
+    config.n_wavelength_bins = options.wavelength_bins;
+    O3CrossSection o3_xs;
+    O3O1DQuantumYield o3_o1d_qy;
+    O3O3PQuantumYield o3_o3p_qy;
+    TuvModel model(config);
+    model.AddStandardRadiators();
+    model.AddPhotolysisReaction("O3 -> O2 + O(1D)", &o3_xs, &o3_o1d_qy);
+    model.AddPhotolysisReaction("O3 -> O2 + O(3P)", &o3_xs, &o3_o3p_qy);
+
+    std::cout << "wavelengths,bin_size,bins,accurate_solves,columns,full_s,pca_s,speedup,reaction,max_relative_error,"
+                 "rms_relative_error\n";
+    for (std::size_t bin_size : options.bin_sizes)
+    {
+      PcaSolverConfig pca_config;
+      pca_config.bin_size = bin_size;
+      pca_config.n_components = options.components;
+      pca_config.second_order = options.second_order;
+      auto report = EvaluatePcaSolver(model, pca_config, options.columns, options.seed);
+      for (const auto& reaction : report.reactions)
+      {
+        std::cout << report.n_wavelengths << "," << bin_size << "," << report.n_bins << "," << report.accurate_solves << ","
+                  << report.n_columns << "," << report.full_seconds << "," << report.pca_seconds << ","
+                  << report.Speedup() << ",\"" << reaction.reaction_name << "\"," << reaction.max_relative_error << ","
+                  << reaction.rms_relative_error << "\n";
+      }
+    }
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "pca_solver: " << e.what() << "\n";
+    PrintUsage();
+    return 1;
+  }
+  return 0;
+}
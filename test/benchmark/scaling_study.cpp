@@ -0,0 +1,521 @@
+// Scaling study for TUV-x batch photolysis calculations
+//
+// Sweeps thread count, altitude layers, wavelength bins, reaction count and
+// batch size, and writes one CSV row per configuration with throughput,
+// batch latency percentiles and peak resident set size.
+//
+// Usage:
+//   ./build/test/benchmark/scaling_study > plots/scaling.csv
+//   ./build/test/benchmark/scaling_study --studies strong,weak --threads 1,2,4,8,16
+//   ./build/test/benchmark/scaling_study --quick
+//   python scripts/plot_scaling_study.py plots/scaling.csv -o plots/scaling
+//
+// Each configuration runs in a forked child process (unless --no-fork), so
+// peak RSS is measured per configuration rather than for the whole sweep.
+
+#include <tuvx/cross_section/types/base.hpp>
+#include <tuvx/model/batch_driver.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/quantum_yield/types/base.hpp>
+#include <tuvx/util/thread_pool.hpp>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+  using namespace tuvx;
+
+  /// One point of the sweep
+  struct StudyPoint
+  {
+    std::string study;
+    std::size_t threads;
+    std::size_t layers;
+    std::size_t wavelengths;
+    std::size_t reactions;
+    std::size_t batch;
+  };
+
+  /// Results for one point
+  struct Measurement
+  {
+    double throughput{ 0.0 };  // columns per second
+    double latency_p50_ms{ 0.0 };
+    double latency_p95_ms{ 0.0 };
+    double latency_p99_ms{ 0.0 };
+    double latency_mean_ms{ 0.0 };
+    double peak_rss_mb{ 0.0 };
+  };
+
+  /// Command-line options
+  struct Options
+  {
+    std::vector<std::string> studies{ "strong", "weak", "layers", "wavelengths", "reactions", "batch" };
+    std::vector<std::size_t> threads;
+    std::vector<std::size_t> layers{ 20, 50, 100, 200, 500 };
+    std::vector<std::size_t> wavelengths{ 50, 100, 500, 1000, 5000, 10000 };
+    std::vector<std::size_t> reactions{ 1, 5, 10, 50, 100 };
+    std::vector<std::size_t> batches{ 1, 8, 32, 128 };
+    std::size_t base_threads{ 1 };
+    std::size_t base_layers{ 50 };
+    std::size_t base_wavelengths{ 100 };
+    std::size_t base_reactions{ 10 };
+    std::size_t base_batch{ 32 };
+    std::size_t repeats{ 10 };
+    std::size_t warmup{ 1 };
+    bool fork_points{ true };
+  };
+
+  std::vector<std::size_t> ParseList(const std::string& text)
+  {
+    std::vector<std::size_t> values;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+      if (!item.empty())
+      {
+        values.push_back(std::stoul(item));
+      }
+    }
+    return values;
+  }
+
+  std::vector<std::string> ParseNames(const std::string& text)
+  {
+    std::vector<std::string> names;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+      if (!item.empty())
+      {
+        names.push_back(item);
+      }
+    }
+    return names;
+  }
+
+  void PrintUsage()
+  {
+    std::cerr << "Usage: scaling_study [options] > results.csv\n"
+              << "  --studies LIST       strong,weak,layers,wavelengths,reactions,batch\n"
+              << "  --threads LIST       thread counts for strong/weak scaling (default 1,2,4,..,cores)\n"
+              << "  --layers LIST        layer counts for the layers study\n"
+              << "  --wavelengths LIST   wavelength bin counts for the wavelengths study\n"
+              << "  --reactions LIST     reaction counts for the reactions study\n"
+              << "  --batch LIST         batch sizes for the batch study\n"
+              << "  --base-threads N     threads for the size studies (default 1)\n"
+              << "  --base-layers N      --base-wavelengths N  --base-reactions N  --base-batch N\n"
+              << "                       fixed values while another dimension is swept\n"
+              << "                       (base-batch is per thread for weak scaling)\n"
+              << "  --repeats N          timed batch calls per point (default 10)\n"
+              << "  --warmup N           untimed batch calls per point (default 1)\n"
+              << "  --no-fork            run points in-process (peak RSS becomes cumulative)\n"
+              << "  --quick              tiny sweep for smoke testing\n";
+  }
+
+  Options ParseOptions(int argc, char** argv)
+  {
+    Options options;
+    for (std::size_t t = 1; t <= ThreadPool::DefaultSize(); t *= 2)
+    {
+      options.threads.push_back(t);
+    }
+    if (options.threads.back() != ThreadPool::DefaultSize())
+    {
+      options.threads.push_back(ThreadPool::DefaultSize());
+    }
+
+    for (int i = 1; i < argc; ++i)
+    {
+      std::string arg = argv[i];
+      auto next = [&]() -> std::string
+      {
+        if (i + 1 >= argc)
+        {
+          throw std::invalid_argument("Missing value for " + arg);
+        }
+        return argv[++i];
+      };
+
+      if (arg == "--studies")
+      {
+        options.studies = ParseNames(next());
+      }
+      else if (arg == "--threads")
+      {
+        options.threads = ParseList(next());
+      }
+      else if (arg == "--layers")
+      {
+        options.layers = ParseList(next());
+      }
+      else if (arg == "--wavelengths")
+      {
+        options.wavelengths = ParseList(next());
+      }
+      else if (arg == "--reactions")
+      {
+        options.reactions = ParseList(next());
+      }
+      else if (arg == "--batch")
+      {
+        options.batches = ParseList(next());
+      }
+      else if (arg == "--base-threads")
+      {
+        options.base_threads = std::stoul(next());
+      }
+      else if (arg == "--base-layers")
+      {
+        options.base_layers = std::stoul(next());
+      }
+      else if (arg == "--base-wavelengths")
+      {
+        options.base_wavelengths = std::stoul(next());
+      }
+      else if (arg == "--base-reactions")
+      {
+        options.base_reactions = std::stoul(next());
+      }
+      else if (arg == "--base-batch")
+      {
+        options.base_batch = std::stoul(next());
+      }
+      else if (arg == "--repeats")
+      {
+        options.repeats = std::stoul(next());
+      }
+      else if (arg == "--warmup")
+      {
+        options.warmup = std::stoul(next());
+      }
+      else if (arg == "--no-fork")
+      {
+        options.fork_points = false;
+      }
+      else if (arg == "--quick")
+      {
+        options.threads = { 1, 2 };
+        options.layers = { 10, 20 };
+        options.wavelengths = { 20, 40 };
+        options.reactions = { 1, 4 };
+        options.batches = { 1, 4 };
+        options.base_layers = 10;
+        options.base_wavelengths = 20;
+        options.base_reactions = 2;
+        options.base_batch = 2;
+        options.repeats = 3;
+      }
+      else if (arg == "--help" || arg == "-h")
+      {
+        PrintUsage();
+        std::exit(0);
+      }
+      else
+      {
+        throw std::invalid_argument("Unknown option " + arg);
+      }
+    }
+    if (options.repeats == 0)
+    {
+      throw std::invalid_argument("--repeats must be at least 1");
+    }
+    return options;
+  }
+
+  /// Expand the selected studies into sweep points
+  std::vector<StudyPoint> BuildPoints(const Options& o)
+  {
+    std::vector<StudyPoint> points;
+    for (const auto& study : o.studies)
+    {
+      if (study == "strong")
+      {
+        for (auto t : o.threads)
+        {
+          points.push_back({ study, t, o.base_layers, o.base_wavelengths, o.base_reactions, o.base_batch });
+        }
+      }
+      else if (study == "weak")
+      {
+        for (auto t : o.threads)
+        {
+          points.push_back({ study, t, o.base_layers, o.base_wavelengths, o.base_reactions, o.base_batch * t });
+        }
+      }
+      else if (study == "layers")
+      {
+        for (auto n : o.layers)
+        {
+          points.push_back({ study, o.base_threads, n, o.base_wavelengths, o.base_reactions, o.base_batch });
+        }
+      }
+      else if (study == "wavelengths")
+      {
+        for (auto n : o.wavelengths)
+        {
+          points.push_back({ study, o.base_threads, o.base_layers, n, o.base_reactions, o.base_batch });
+        }
+      }
+      else if (study == "reactions")
+      {
+        for (auto n : o.reactions)
+        {
+          points.push_back({ study, o.base_threads, o.base_layers, o.base_wavelengths, n, o.base_batch });
+        }
+      }
+      else if (study == "batch")
+      {
+        for (auto n : o.batches)
+        {
+          points.push_back({ study, o.base_threads, o.base_layers, o.base_wavelengths, o.base_reactions, n });
+        }
+      }
+      else
+      {
+        throw std::invalid_argument("Unknown study " + study);
+      }
+    }
+    return points;
+  }
+
+  /// Nearest-rank percentile of sorted samples
+  double Percentile(const std::vector<double>& sorted, double percent)
+  {
+    std::size_t rank = static_cast<std::size_t>(std::ceil(percent / 100.0 * static_cast<double>(sorted.size())));
+    return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+  }
+
+  double PeakRssMegabytes()
+  {
+    struct rusage usage
+    {
+    };
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<double>(usage.ru_maxrss) / 1024.0;  // ru_maxrss is in kB on Linux
+  }
+
+  /// Build a model and batch for one point and time repeated batch calls
+  Measurement Run(const StudyPoint& point, const Options& options)
+  {
+    ModelConfig config;
+    config.n_altitude_layers = point.layers;
+    config.n_wavelength_bins = point.wavelengths;
+    config.wavelength_min = 280.0;
+    config.wavelength_max = 700.0;
+
+    TuvModel model(config);
+    model.AddStandardRadiators();
+
+    // Synthetic reactions: smooth, distinct cross-sections over the model range
+    std::vector<std::unique_ptr<BaseCrossSection>> cross_sections;
+    std::vector<std::unique_ptr<ConstantQuantumYield>> quantum_yields;
+    std::vector<double> xs_wavelengths;
+    for (double wl = 270.0; wl <= 710.0; wl += 5.0)
+    {
+      xs_wavelengths.push_back(wl);
+    }
+    for (std::size_t r = 0; r < point.reactions; ++r)
+    {
+      std::string name = "R" + std::to_string(r);
+      double scale = 300.0 + 4.0 * static_cast<double>(r % 100);
+      std::vector<double> xs(xs_wavelengths.size());
+      for (std::size_t i = 0; i < xs.size(); ++i)
+      {
+        xs[i] = 1e-18 * std::exp(-(xs_wavelengths[i] - 270.0) / (0.2 * scale));
+      }
+      cross_sections.push_back(std::make_unique<BaseCrossSection>(name, xs_wavelengths, xs));
+      quantum_yields.push_back(std::make_unique<ConstantQuantumYield>(name, name, name, 1.0));
+      model.AddPhotolysisReaction(name, cross_sections.back().get(), quantum_yields.back().get());
+    }
+
+    // Column inputs: standard atmosphere with per-column perturbations
+    auto mid = model.AltitudeGrid().Midpoints();
+    std::vector<double> midpoints(mid.begin(), mid.end());
+    auto t_base = StandardAtmosphere::GenerateTemperatureProfile(midpoints);
+    auto n_base = StandardAtmosphere::GenerateAirDensityProfile(midpoints);
+    std::vector<double> sza(point.batch);
+    std::vector<double> temperature, air_density, ozone;
+    temperature.reserve(point.batch * point.layers);
+    air_density.reserve(point.batch * point.layers);
+    ozone.reserve(point.batch * point.layers);
+    for (std::size_t c = 0; c < point.batch; ++c)
+    {
+      double f = static_cast<double>(c) / static_cast<double>(std::max<std::size_t>(point.batch, 2) - 1);
+      sza[c] = 10.0 + 70.0 * f;
+      auto o3 = StandardAtmosphere::GenerateOzoneProfile(midpoints, 250.0 + 100.0 * f);
+      for (std::size_t l = 0; l < point.layers; ++l)
+      {
+        temperature.push_back(t_base[l] + 10.0 * (f - 0.5));
+        air_density.push_back(n_base[l]);
+        ozone.push_back(o3[l]);
+      }
+    }
+
+    ColumnBatchView batch;
+    batch.n_columns = point.batch;
+    batch.n_layers = point.layers;
+    batch.solar_zenith_angle = StridedView<const double>(sza.data(), sza.size());
+    auto stride = static_cast<std::ptrdiff_t>(point.layers);
+    batch.temperature = { temperature.data(), stride, 1 };
+    batch.air_density = { air_density.data(), stride, 1 };
+    batch.ozone = { ozone.data(), stride, 1 };
+
+    std::size_t n_levels = point.layers + 1;
+    std::vector<double> j(point.batch * point.reactions * n_levels);
+    RateBatchView rates{ j.data(),
+                         static_cast<std::ptrdiff_t>(point.reactions * n_levels),
+                         static_cast<std::ptrdiff_t>(n_levels),
+                         1 };
+
+    ThreadPool pool(point.threads);
+    BatchDriver driver(model, pool);
+
+    for (std::size_t w = 0; w < options.warmup; ++w)
+    {
+      driver.Calculate(batch, rates);
+    }
+
+    std::vector<double> latencies_ms;
+    latencies_ms.reserve(options.repeats);
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t r = 0; r < options.repeats; ++r)
+    {
+      auto t0 = std::chrono::steady_clock::now();
+      driver.Calculate(batch, rates);
+      auto t1 = std::chrono::steady_clock::now();
+      latencies_ms.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+    }
+    double elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::sort(latencies_ms.begin(), latencies_ms.end());
+    Measurement m;
+    m.throughput = static_cast<double>(point.batch * options.repeats) / elapsed_s;
+    m.latency_p50_ms = Percentile(latencies_ms, 50.0);
+    m.latency_p95_ms = Percentile(latencies_ms, 95.0);
+    m.latency_p99_ms = Percentile(latencies_ms, 99.0);
+    m.latency_mean_ms = elapsed_s * 1000.0 / static_cast<double>(options.repeats);
+    m.peak_rss_mb = PeakRssMegabytes();
+    return m;
+  }
+
+  std::string FormatRow(const StudyPoint& p, const Options& o, const Measurement& m)
+  {
+    char buffer[512];
+    std::snprintf(
+        buffer,
+        sizeof(buffer),
+        "%s,%zu,%zu,%zu,%zu,%zu,%zu,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g",
+        p.study.c_str(),
+        p.threads,
+        p.layers,
+        p.wavelengths,
+        p.reactions,
+        p.batch,
+        o.repeats,
+        m.throughput,
+        m.latency_p50_ms,
+        m.latency_p95_ms,
+        m.latency_p99_ms,
+        m.latency_mean_ms,
+        m.peak_rss_mb);
+    return buffer;
+  }
+
+  /// Run one point in a child process and return its CSV row
+  std::string RunForked(const StudyPoint& point, const Options& options)
+  {
+    int fds[2];
+    if (pipe(fds) != 0)
+    {
+      throw std::runtime_error("pipe() failed");
+    }
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+      throw std::runtime_error("fork() failed");
+    }
+    if (pid == 0)
+    {
+      close(fds[0]);
+      int status = 0;
+      try
+      {
+        std::string row = FormatRow(point, options, Run(point, options));
+        if (write(fds[1], row.data(), row.size()) != static_cast<ssize_t>(row.size()))
+        {
+          status = 1;
+        }
+      }
+      catch (const std::exception& e)
+      {
+        std::cerr << "scaling_study: " << point.study << " point failed: " << e.what() << "\n";
+        status = 1;
+      }
+      close(fds[1]);
+      _exit(status);
+    }
+
+    close(fds[1]);
+    std::string row;
+    char buffer[256];
+    ssize_t n = 0;
+    while ((n = read(fds[0], buffer, sizeof(buffer))) > 0)
+    {
+      row.append(buffer, static_cast<std::size_t>(n));
+    }
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || row.empty())
+    {
+      throw std::runtime_error("Child process failed for study " + point.study);
+    }
+    return row;
+  }
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  try
+  {
+    Options options = ParseOptions(argc, argv);
+    auto points = BuildPoints(options);
+
+    std::cout << "study,threads,layers,wavelengths,reactions,batch,repeats,throughput_columns_per_s,"
+                 "latency_p50_ms,latency_p95_ms,latency_p99_ms,latency_mean_ms,peak_rss_mb\n";
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+      const auto& point = points[i];
+      std::cerr << "[" << i + 1 << "/" << points.size() << "] " << point.study << ": threads=" << point.threads
+                << " layers=" << point.layers << " wavelengths=" << point.wavelengths
+                << " reactions=" << point.reactions << " batch=" << point.batch << "\n";
+      std::string row =
+          options.fork_points ? RunForked(point, options) : FormatRow(point, options, Run(point, options));
+      std::cout << row << "\n" << std::flush;
+    }
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "scaling_study: " << e.what() << "\n";
+    PrintUsage();
+    return 1;
+  }
+  return 0;
+}
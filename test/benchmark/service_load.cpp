@@ -0,0 +1,238 @@
+// Load generator for the photolysis service
+//
+// Opens several PhotolysisClient connections, each sending batches of
+// columns as fast as the server answers, and reports throughput and request
+// latency. Without --socket it starts an in-process PhotolysisServer; with
+// --socket it loads a running tuvx_photolysisd. Writes one CSV row to
+// stdout; exits with status 1 if any request fails or, for the in-process
+// server, any J-value differs from a local BatchDriver.
+//
+// Usage:
+//   ./build/test/benchmark/service_load --clients 8 --requests 200 --columns 64
+//   ./build/test/benchmark/service_load --socket /tmp/tuvx.sock --clients 16
+//   ./build/test/benchmark/service_load --quick
+
+#include <tuvx/cross_section/types/o3.hpp>
+#include <tuvx/model/batch_driver.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/quantum_yield/types/o3_o1d.hpp>
+#include <tuvx/service/photolysis_client.hpp>
+#include <tuvx/service/photolysis_server.hpp>
+#include <tuvx/util/thread_pool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+namespace
+{
+  using namespace tuvx;
+
+  /// Command-line options
+  struct Options
+  {
+    std::string socket_path;
+    std::size_t clients{ 4 };
+    std::size_t requests{ 100 };
+    std::size_t columns{ 32 };
+    std::size_t server_threads{ ThreadPool::DefaultSize() };
+  };
+
+  void PrintUsage()
+  {
+    std::cerr << "usage: service_load [--socket PATH] [--clients N] [--requests N] [--columns N]\n"
+              << "                    [--server-threads N] [--quick]\n";
+  }
+
+  Options ParseOptions(int argc, char** argv)
+  {
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+      std::string arg = argv[i];
+      auto value = [&]() -> std::string
+      {
+        if (i + 1 >= argc)
+        {
+          throw std::invalid_argument("missing value for " + arg);
+        }
+        return argv[++i];
+      };
+      if (arg == "--socket")
+      {
+        options.socket_path = value();
+      }
+      else if (arg == "--clients")
+      {
+        options.clients = std::stoul(value());
+      }
+      else if (arg == "--requests")
+      {
+        options.requests = std::stoul(value());
+      }
+      else if (arg == "--columns")
+      {
+        options.columns = std::stoul(value());
+      }
+      else if (arg == "--server-threads")
+      {
+        options.server_threads = std::stoul(value());
+      }
+      else if (arg == "--quick")
+      {
+        options.clients = 3;
+        options.requests = 4;
+        options.columns = 8;
+        options.server_threads = 2;
+      }
+      else
+      {
+        throw std::invalid_argument("unknown option " + arg);
+      }
+    }
+    return options;
+  }
+
+  /// Columns sweeping SZA and ozone, with temperature and density from the server's model
+  struct Workload
+  {
+    std::vector<double> sza;
+    std::vector<double> ozone;
+    ColumnBatchView batch;
+
+    Workload(std::size_t n_columns, std::size_t n_layers)
+    {
+      for (std::size_t c = 0; c < n_columns; ++c)
+      {
+        sza.push_back(85.0 * static_cast<double>(c) / static_cast<double>(std::max<std::size_t>(n_columns - 1, 1)));
+      }
+      ozone.resize(n_columns * n_layers);
+      for (std::size_t i = 0; i < ozone.size(); ++i)
+      {
+        ozone[i] = 1.0e12 * (1.0 + 0.01 * static_cast<double>(i % 97));
+      }
+      batch.n_columns = n_columns;
+      batch.n_layers = n_layers;
+      batch.solar_zenith_angle = StridedView<const double>(sza.data(), n_columns);
+      batch.ozone = { ozone.data(), static_cast<std::ptrdiff_t>(n_layers), 1 };
+    }
+  };
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  try
+  {
+    Options options = ParseOptions(argc, argv);
+
+    // In-process server unless an external one is given
+    O3CrossSection o3_xs;
+    O3O1DQuantumYield o3_o1d_qy;
+    O3O3PQuantumYield o3_o3p_qy;
+    std::unique_ptr<TuvModel> model;
+    std::unique_ptr<ThreadPool> pool;
+    std::unique_ptr<PhotolysisServer> server;
+    if (options.socket_path.empty())
+    {
+      ModelConfig config;
+      config.n_altitude_layers = 40;
+      config.n_wavelength_bins = 60;
+      model = std::make_unique<TuvModel>(config);
+      model->AddStandardRadiators();
+      model->AddPhotolysisReaction("O3 -> O2 + O(1D)", &o3_xs, &o3_o1d_qy);
+      model->AddPhotolysisReaction("O3 -> O2 + O(3P)", &o3_xs, &o3_o3p_qy);
+      options.socket_path = "/tmp/tuvx_service_load_" + std::to_string(getpid()) + ".sock";
+      pool = std::make_unique<ThreadPool>(options.server_threads);
+      server = std::make_unique<PhotolysisServer>(*model, *pool, PhotolysisServerConfig{ options.socket_path });
+      server->Start();
+    }
+
+    PhotolysisClient probe(options.socket_path);
+    std::size_t n_rates = options.columns * probe.NumberOfReactions() * probe.NumberOfLevels();
+    Workload workload(options.columns, probe.NumberOfLayers());
+    auto levels = static_cast<std::ptrdiff_t>(probe.NumberOfLevels());
+    auto column_stride = static_cast<std::ptrdiff_t>(probe.NumberOfReactions()) * levels;
+
+    // Reference from a local model when it is available
+    std::vector<double> expected;
+    if (model)
+    {
+      expected.resize(n_rates);
+      BatchDriver(*model).Calculate(workload.batch, { expected.data(), column_stride, levels, 1 });
+    }
+
+    std::atomic<std::size_t> failures{ 0 };
+    std::vector<std::vector<double>> latencies(options.clients);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < options.clients; ++i)
+    {
+      threads.emplace_back(
+          [&, i]
+          {
+            try
+            {
+              PhotolysisClient client(options.socket_path);
+              std::vector<double> j(n_rates);
+              for (std::size_t r = 0; r < options.requests; ++r)
+              {
+                auto sent = std::chrono::steady_clock::now();
+                client.Calculate(workload.batch, { j.data(), column_stride, levels, 1 });
+                latencies[i].push_back(
+                    std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - sent).count());
+                if (!expected.empty() && j != expected)
+                {
+                  ++failures;
+                }
+              }
+            }
+            catch (const std::exception& e)
+            {
+              std::cerr << "service_load: client " << i << ": " << e.what() << "\n";
+              ++failures;
+            }
+          });
+    }
+    for (auto& thread : threads)
+    {
+      thread.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<double> all;
+    for (const auto& client : latencies)
+    {
+      all.insert(all.end(), client.begin(), client.end());
+    }
+    std::sort(all.begin(), all.end());
+    auto percentile = [&](double p) { return all.empty() ? 0.0 : all[static_cast<std::size_t>(p * (all.size() - 1))]; };
+
+    std::cout << "clients,requests_per_client,columns_per_request,seconds,requests_per_s,columns_per_s,p50_us,p99_us\n";
+    std::cout << options.clients << "," << options.requests << "," << options.columns << "," << seconds << ","
+              << static_cast<double>(all.size()) / seconds << ","
+              << static_cast<double>(all.size() * options.columns) / seconds << "," << percentile(0.5) << ","
+              << percentile(0.99) << "\n";
+
+    if (failures > 0)
+    {
+      std::cerr << "service_load: " << failures << " failed or mismatched requests\n";
+      return 1;
+    }
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "service_load: " << e.what() << "\n";
+    PrintUsage();
+    return 1;
+  }
+  return 0;
+}
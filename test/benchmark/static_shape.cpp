@@ -0,0 +1,176 @@
+// Static-shape vs dynamic model benchmark
+//
+// Times the radiative transfer solve and the full Calculate() for the
+// production grid shape (80 layers x 140 wavelength bins) with TuvModel and
+// StaticShapeModel<80, 140>. Writes one CSV row per variant and stage to
+// stdout; exits with status 1 if the two variants disagree in any bit.
+//
+// Usage:
+//   ./build/test/benchmark/static_shape > static_shape.csv
+//   ./build/test/benchmark/static_shape --repeats 500
+//   ./build/test/benchmark/static_shape --quick
+
+#include <tuvx/cross_section/types/o3.hpp>
+#include <tuvx/model/static_shape_model.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/quantum_yield/types/o3_o1d.hpp>
+#include <tuvx/solver/delta_eddington.hpp>
+#include <tuvx/solver/static_delta_eddington.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+  using namespace tuvx;
+
+  constexpr std::size_t kLayers = 80;
+  constexpr std::size_t kWavelengths = 140;
+
+  /// Command-line options
+  struct Options
+  {
+    std::size_t repeats{ 200 };
+    std::size_t warmup{ 5 };
+  };
+
+  void PrintUsage()
+  {
+    std::cerr << "usage: static_shape [--repeats N] [--warmup N] [--quick]\n";
+  }
+
+  Options ParseOptions(int argc, char** argv)
+  {
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+      std::string arg = argv[i];
+      auto next = [&]() -> std::size_t
+      {
+        if (i + 1 >= argc)
+        {
+          throw std::invalid_argument("missing value for " + arg);
+        }
+        return std::stoul(argv[++i]);
+      };
+      if (arg == "--repeats")
+      {
+        options.repeats = next();
+      }
+      else if (arg == "--warmup")
+      {
+        options.warmup = next();
+      }
+      else if (arg == "--quick")
+      {
+        options.repeats = 3;
+        options.warmup = 1;
+      }
+      else
+      {
+        throw std::invalid_argument("unknown option " + arg);
+      }
+    }
+    return options;
+  }
+
+  /// Median time of one call [us]
+  template<typename Func>
+  double MedianMicroseconds(const Options& options, Func&& func)
+  {
+    for (std::size_t i = 0; i < options.warmup; ++i)
+    {
+      func();
+    }
+    std::vector<double> times;
+    times.reserve(options.repeats);
+    for (std::size_t i = 0; i < options.repeats; ++i)
+    {
+      auto start = std::chrono::steady_clock::now();
+      func();
+      times.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+  }
+
+  bool SameField(const RadiationField& a, const RadiationField& b)
+  {
+    return a.direct_irradiance == b.direct_irradiance && a.diffuse_down == b.diffuse_down &&
+           a.diffuse_up == b.diffuse_up && a.actinic_flux_direct == b.actinic_flux_direct &&
+           a.actinic_flux_diffuse == b.actinic_flux_diffuse;
+  }
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  try
+  {
+    Options options = ParseOptions(argc, argv);
+
+    ModelConfig config;
+    config.n_altitude_layers = kLayers;
+    config.n_wavelength_bins = kWavelengths;
+    O3CrossSection xs;
+    O3O1DQuantumYield qy;
+
+    TuvModel dynamic(config);
+    dynamic.AddStandardRadiators();
+    dynamic.AddPhotolysisReaction("O3 -> O2 + O(1D)", &xs, &qy);
+    StaticShapeModel<kLayers, kWavelengths> fixed(config);
+    fixed.AddStandardRadiators();
+    fixed.AddPhotolysisReaction("O3 -> O2 + O(1D)", &xs, &qy);
+
+    // Solver inputs taken from the model after one calculation
+    ModelOutput reference = dynamic.Calculate(30.0);
+    RadiatorState state = dynamic.Radiators().CombinedState();
+    std::vector<double> albedo(kWavelengths, config.surface_albedo);
+    std::vector<double> flux(kWavelengths, 1e14);
+    SolverInput input;
+    input.radiator_state = &state;
+    input.solar_zenith_angle = 30.0;
+    input.surface_albedo = &albedo;
+    input.extraterrestrial_flux = &flux;
+
+    DeltaEddingtonSolver dynamic_solver;
+    StaticDeltaEddingtonSolver<kLayers, kWavelengths> static_solver;
+    bool identical = SameField(dynamic_solver.Solve(input), static_solver.Solve(input)) &&
+                     fixed.Calculate(30.0).photolysis_rates[0].rates == reference.photolysis_rates[0].rates;
+
+    RadiationField field;
+    ModelOutput output;
+    double solve_dynamic = MedianMicroseconds(options, [&] { field = dynamic_solver.Solve(input); });
+    double solve_static = MedianMicroseconds(options, [&] { field = static_solver.Solve(input); });
+    double calculate_dynamic = MedianMicroseconds(options, [&] { output = dynamic.Calculate(30.0); });
+    double calculate_static = MedianMicroseconds(options, [&] { output = fixed.Calculate(30.0); });
+
+    std::cout << "stage,variant,layers,wavelengths,repeats,median_us,speedup\n";
+    auto row = [&](const char* stage, const char* variant, double time, double baseline)
+    {
+      std::cout << stage << "," << variant << "," << kLayers << "," << kWavelengths << "," << options.repeats << ","
+                << time << "," << baseline / time << "\n";
+    };
+    row("solve", "dynamic", solve_dynamic, solve_dynamic);
+    row("solve", "static", solve_static, solve_dynamic);
+    row("calculate", "dynamic", calculate_dynamic, calculate_dynamic);
+    row("calculate", "static", calculate_static, calculate_dynamic);
+
+    if (!identical)
+    {
+      std::cerr << "static_shape: static and dynamic results differ\n";
+      return 1;
+    }
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "static_shape: " << e.what() << "\n";
+    PrintUsage();
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,270 @@
+// Replay recorded TuvModel::Calculate() and CalculatePhotolysisRates() calls
+//
+// Feeds a trace written by TraceWriter back through the model, timing each
+// call and checking the J-values against the recorded ones. Writes one CSV
+// row per call to stdout and a summary to stderr; exits with status 1 if any
+// J-value is outside the tolerance.
+//
+// Usage:
+//   ./build/test/benchmark/trace_replay columns.trace > replay.csv
+//   ./build/test/benchmark/trace_replay columns.trace --repeats 5 --rtol 1e-6
+//   ./build/test/benchmark/trace_replay --record-example example.trace --calls 200
+//
+// Reactions are not stored in traces (only their names). This tool knows the
+// built-in O3 reactions; recorded reactions it does not know are skipped in
+// the comparison and listed in the summary.
+
+#include <tuvx/cross_section/types/o3.hpp>
+#include <tuvx/model/trace.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/quantum_yield/types/o3_o1d.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+  using namespace tuvx;
+
+  /// Command-line options
+  struct Options
+  {
+    std::string trace_path;
+    std::string record_path;
+    std::size_t example_calls{ 48 };
+    TraceReplayOptions replay;
+  };
+
+  void PrintUsage(const char* program)
+  {
+    std::cerr << "Usage: " << program << " TRACE [--repeats N] [--rtol X] [--atol X] [--no-check]\n"
+              << "       " << program << " --record-example TRACE [--calls N]\n";
+  }
+
+  Options ParseOptions(int argc, char** argv)
+  {
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+      std::string arg = argv[i];
+      auto value = [&]() -> std::string
+      {
+        if (i + 1 >= argc)
+        {
+          throw std::invalid_argument("Missing value for " + arg);
+        }
+        return argv[++i];
+      };
+      if (arg == "--repeats")
+      {
+        options.replay.repeats = std::stoul(value());
+      }
+      else if (arg == "--rtol")
+      {
+        options.replay.relative_tolerance = std::stod(value());
+      }
+      else if (arg == "--atol")
+      {
+        options.replay.absolute_tolerance = std::stod(value());
+      }
+      else if (arg == "--no-check")
+      {
+        options.replay.check_outputs = false;
+      }
+      else if (arg == "--record-example")
+      {
+        options.record_path = value();
+      }
+      else if (arg == "--calls")
+      {
+        options.example_calls = std::stoul(value());
+      }
+      else if (!arg.empty() && arg[0] != '-' && options.trace_path.empty())
+      {
+        options.trace_path = arg;
+      }
+      else
+      {
+        throw std::invalid_argument("Unknown argument " + arg);
+      }
+    }
+    if (options.trace_path.empty() == options.record_path.empty())
+    {
+      throw std::invalid_argument("Give either a trace to replay or --record-example");
+    }
+    return options;
+  }
+
+  /// Reactions this tool can rebuild from their recorded names
+  class ReactionCatalog
+  {
+   public:
+    /// Add a reaction by name; returns false if the name is not known
+    bool Add(const std::string& name, TuvModel& model)
+    {
+      if (name == "O3 -> O2 + O(1D)")
+      {
+        model.AddPhotolysisReaction(name, &o3_xs_, &o3_o1d_qy_);
+      }
+      else if (name == "O3 -> O2 + O(3P)")
+      {
+        model.AddPhotolysisReaction(name, &o3_xs_, &o3_o3p_qy_);
+      }
+      else
+      {
+        return false;
+      }
+      return true;
+    }
+
+    /// Add every known reaction of a setup to the model, remember the rest
+    void AddTo(const TraceSetup& setup, TuvModel& model)
+    {
+      for (const auto& name : setup.reactions)
+      {
+        if (!Add(name, model))
+        {
+          unknown_.insert(name);
+        }
+      }
+    }
+
+    const std::set<std::string>& Unknown() const
+    {
+      return unknown_;
+    }
+
+   private:
+    O3CrossSection o3_xs_;
+    O3O1DQuantumYield o3_o1d_qy_;
+    O3O3PQuantumYield o3_o3p_qy_;
+    std::set<std::string> unknown_;
+  };
+
+  /// Record a synthetic trace: a diurnal SZA sweep over a few columns with
+  /// different ozone, temperature, albedo and aerosol loads
+  int RecordExample(const Options& options)
+  {
+    ModelConfig config;
+    config.n_wavelength_bins = 40;
+    config.n_altitude_layers = 30;
+
+    TraceWriter writer(options.record_path);
+    ReactionCatalog catalog;
+    const std::size_t n_columns = 4;
+    std::size_t calls_per_column = std::max<std::size_t>(options.example_calls / n_columns, 1);
+
+    for (std::size_t c = 0; c < n_columns; ++c)
+    {
+      AerosolRadiator::Config aerosol;
+      aerosol.optical_depth_ref = 0.05 + 0.15 * static_cast<double>(c);
+      aerosol.angstrom_exponent = 1.6 - 0.3 * static_cast<double>(c);
+
+      ModelConfig column_config = config;
+      column_config.ozone_column_DU = 250.0 + 40.0 * static_cast<double>(c);
+      column_config.surface_albedo = 0.05 + 0.1 * static_cast<double>(c);
+      column_config.day_of_year = 80 + 60 * static_cast<int>(c);
+
+      TuvModel model(column_config);
+      model.AddStandardRadiators();
+      model.AddAerosolRadiator(aerosol);
+      catalog.Add("O3 -> O2 + O(1D)", model);
+      catalog.Add("O3 -> O2 + O(3P)", model);
+
+      auto midpoints = model.AltitudeGrid().Midpoints();
+      std::vector<double> mid(midpoints.begin(), midpoints.end());
+      auto temperature = StandardAtmosphere::GenerateTemperatureProfile(mid);
+      for (auto& t : temperature)
+      {
+        t += 4.0 * static_cast<double>(c) - 6.0;
+      }
+      model.SetTemperatureProfile(temperature);
+
+      writer.Attach(model);
+      for (std::size_t i = 0; i < calls_per_column; ++i)
+      {
+        double phase = static_cast<double>(i) / static_cast<double>(calls_per_column);
+        double sza = 20.0 + 70.0 * std::abs(std::cos(constants::kPi * phase));
+        model.Calculate(sza);
+      }
+    }
+    std::cerr << "Recorded " << writer.CallsWritten() << " calls, " << writer.SetupsWritten() << " setups to "
+              << options.record_path << "\n";
+    return 0;
+  }
+
+  int Replay(const Options& options)
+  {
+    Trace trace = ReadTrace(options.trace_path);
+    ReactionCatalog catalog;
+    auto report = ReplayTrace(
+        trace,
+        [&](const TraceSetup& setup)
+        {
+          TuvModel model = BuildTraceModel(setup);
+          catalog.AddTo(setup, model);
+          return model;
+        },
+        options.replay);
+
+    std::printf("call,setup,solar_zenith_angle,time_ms,n_compared,n_mismatched,max_relative_error\n");
+    for (std::size_t i = 0; i < report.calls.size(); ++i)
+    {
+      const auto& call = report.calls[i];
+      std::printf(
+          "%zu,%zu,%.6f,%.6f,%zu,%zu,%.6e\n",
+          i,
+          trace.calls[i].setup,
+          trace.calls[i].solar_zenith_angle,
+          call.seconds * 1000.0,
+          call.n_compared,
+          call.n_mismatched,
+          call.max_relative_error);
+    }
+
+    std::cerr << "Replayed " << report.calls.size() << " calls (" << trace.setups.size() << " setups) in "
+              << report.TotalSeconds() * 1000.0 << " ms\n";
+    if (!report.calls.empty())
+    {
+      std::cerr << "Mean time per call: " << report.TotalSeconds() * 1000.0 / static_cast<double>(report.calls.size())
+                << " ms\n";
+    }
+    for (const auto& name : catalog.Unknown())
+    {
+      std::cerr << "Skipped unknown reaction '" << name << "'\n";
+    }
+    if (options.replay.check_outputs)
+    {
+      std::cerr << "Max relative error: " << report.MaxRelativeError() << ", mismatches: " << report.Mismatches()
+                << "\n";
+    }
+    return report.Mismatches() == 0 ? 0 : 1;
+  }
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  try
+  {
+    Options options = ParseOptions(argc, argv);
+    return options.record_path.empty() ? Replay(options) : RecordExample(options);
+  }
+  catch (const std::invalid_argument& e)
+  {
+    std::cerr << e.what() << "\n";
+    PrintUsage(argv[0]);
+    return 2;
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Error: " << e.what() << "\n";
+    return 1;
+  }
+}
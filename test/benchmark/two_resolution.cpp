@@ -0,0 +1,192 @@
+// Two-resolution solve accuracy, cache use and speed study
+//
+// Runs TwoResolutionModel on the production model (80 layers x 140
+// wavelength bins, standard radiators, O3 photolysis) for several merge
+// factors and refresh tolerances, and compares it with the fine model on two
+// column sequences: a slowly varying one (a single column through a day, its
+// solar zenith angle sweeping 20-85-20 degrees while its ozone drifts by
+// +-10%) and independent random columns, where nearly every column refreshes
+// the cached ratios. Writes one CSV row per sequence, setting and reaction
+// to stdout.
+//
+// Usage:
+//   ./build/test/benchmark/two_resolution > two_resolution.csv
+//   ./build/test/benchmark/two_resolution --merge-factors 4,8 --tolerances 0.1,0.5 --columns 500
+//   ./build/test/benchmark/two_resolution --quick
+
+#include <tuvx/cross_section/types/o3.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/model/two_resolution.hpp>
+#include <tuvx/quantum_yield/types/o3_o1d.hpp>
+#include <tuvx/util/constants.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+  using namespace tuvx;
+
+  /// Command-line options
+  struct Options
+  {
+    std::vector<std::size_t> merge_factors{ 2, 4, 8 };
+    std::vector<double> tolerances{ 0.0, 0.2, 0.5 };
+    std::size_t columns{ 200 };
+    std::size_t layers{ 80 };
+    std::size_t wavelength_bins{ 140 };
+    std::uint64_t seed{ 42 };
+  };
+
+  void PrintUsage()
+  {
+    std::cerr << "usage: two_resolution [--merge-factors N,N,...] [--tolerances X,X,...] [--columns N] [--layers N]\n"
+              << "                      [--wavelength-bins N] [--seed N] [--quick]\n";
+  }
+
+  template<typename T>
+  std::vector<T> ParseList(const std::string& text)
+  {
+    std::vector<T> values;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+      values.push_back(static_cast<T>(std::stod(item)));
+    }
+    return values;
+  }
+
+  Options ParseOptions(int argc, char** argv)
+  {
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+      std::string arg = argv[i];
+      auto value = [&]() -> std::string
+      {
+        if (i + 1 >= argc)
+        {
+          throw std::invalid_argument("missing value for " + arg);
+        }
+        return argv[++i];
+      };
+      if (arg == "--merge-factors")
+      {
+        options.merge_factors = ParseList<std::size_t>(value());
+      }
+      else if (arg == "--tolerances")
+      {
+        options.tolerances = ParseList<double>(value());
+      }
+      else if (arg == "--columns")
+      {
+        options.columns = std::stoul(value());
+      }
+      else if (arg == "--layers")
+      {
+        options.layers = std::stoul(value());
+      }
+      else if (arg == "--wavelength-bins")
+      {
+        options.wavelength_bins = std::stoul(value());
+      }
+      else if (arg == "--seed")
+      {
+        options.seed = std::stoull(value());
+      }
+      else if (arg == "--quick")
+      {
+        options.merge_factors = { 4 };
+        options.tolerances = { 0.2 };
+        options.columns = 8;
+        options.layers = 20;
+        options.wavelength_bins = 60;
+      }
+      else
+      {
+        throw std::invalid_argument("unknown option " + arg);
+      }
+    }
+    return options;
+  }
+
+  /// One column through a day: the sun rises and sets while the ozone drifts
+  std::vector<ColumnState> DiurnalColumns(const TuvModel& model, std::size_t n_columns, std::uint64_t seed)
+  {
+    ColumnState base = detail::RandomColumns(model, 1, seed)[0];
+    std::vector<ColumnState> columns;
+    for (std::size_t c = 0; c < n_columns; ++c)
+    {
+      double t = n_columns > 1 ? static_cast<double>(c) / static_cast<double>(n_columns - 1) : 0.0;
+      ColumnState column = base;
+      column.solar_zenith_angle = 20.0 + 65.0 * std::abs(2.0 * t - 1.0);
+      for (auto& ozone : column.ozone)
+      {
+        ozone *= 1.0 + 0.1 * std::sin(constants::kTwoPi * t);
+      }
+      columns.push_back(std::move(column));
+    }
+    return columns;
+  }
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  try
+  {
+    Options options = ParseOptions(argc, argv);
+
+    ModelConfig config;
+    config.n_altitude_layers = options.layers;
+    config.n_wavelength_bins = options.wavelength_bins;
+    O3CrossSection o3_xs;
+    O3O1DQuantumYield o3_o1d_qy;
+    O3O3PQuantumYield o3_o3p_qy;
+    TuvModel fine(config);
+    fine.AddStandardRadiators();
+    fine.AddPhotolysisReaction("O3 -> O2 + O(1D)", &o3_xs, &o3_o1d_qy);
+    fine.AddPhotolysisReaction("O3 -> O2 + O(3P)", &o3_xs, &o3_o3p_qy);
+
+    std::vector<std::pair<std::string, std::vector<ColumnState>>> sequences;
+    sequences.emplace_back("diurnal", DiurnalColumns(fine, options.columns, options.seed));
+    sequences.emplace_back("random", detail::RandomColumns(fine, options.columns, options.seed));
+
+    std::cout << "sequence,fine_bins,coarse_bins,tolerance,columns,refreshes,fine_s,two_resolution_s,speedup,reaction,"
+                 "max_relative_error,rms_relative_error\n";
+    for (const auto& [name, columns] : sequences)
+    {
+      for (std::size_t merge_factor : options.merge_factors)
+      {
+        for (double tolerance : options.tolerances)
+        {
+          TwoResolutionConfig two_resolution_config;
+          two_resolution_config.merge_factor = merge_factor;
+          two_resolution_config.refresh_tolerance = tolerance;
+          auto report = EvaluateTwoResolution(fine, two_resolution_config, columns);
+          for (const auto& reaction : report.reactions)
+          {
+            std::cout << name << "," << report.n_fine_bins << "," << report.n_coarse_bins << "," << tolerance << ","
+                      << report.n_columns << "," << report.ratio_refreshes << "," << report.fine_seconds << ","
+                      << report.two_resolution_seconds << "," << report.Speedup() << ",\"" << reaction.reaction_name
+                      << "\"," << reaction.max_relative_error << "," << reaction.rms_relative_error << "\n";
+          }
+        }
+      }
+    }
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "two_resolution: " << e.what() << "\n";
+    PrintUsage();
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,183 @@
+#include <tuvx/c_api/tuvx_c.h>
+#include <tuvx/cross_section/types/o3.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/quantum_yield/types/o3_o1d.hpp>
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+  tuvx_model_config SmallConfig()
+  {
+    tuvx_model_config config;
+    tuvx_model_config_default(&config);
+    config.n_wavelength_bins = 30;
+    config.wavelength_max = 400.0;
+    config.n_altitude_layers = 20;
+    config.altitude_max = 60.0;
+    return config;
+  }
+}  // namespace
+
+TEST(CApiTest, DefaultConfigMatchesModelConfig)
+{
+  tuvx_model_config config;
+  tuvx_model_config_default(&config);
+  tuvx::ModelConfig defaults;
+
+  EXPECT_EQ(config.n_wavelength_bins, defaults.n_wavelength_bins);
+  EXPECT_EQ(config.n_altitude_layers, defaults.n_altitude_layers);
+  EXPECT_DOUBLE_EQ(config.wavelength_min, defaults.wavelength_min);
+  EXPECT_DOUBLE_EQ(config.surface_albedo, defaults.surface_albedo);
+  EXPECT_EQ(config.use_spherical_geometry, 1);
+}
+
+TEST(CApiTest, CreateAndQueryDimensions)
+{
+  auto config = SmallConfig();
+  int error = -1;
+  tuvx_model* model = tuvx_model_create(&config, &error);
+  ASSERT_NE(model, nullptr);
+  EXPECT_EQ(error, TUVX_SUCCESS);
+
+  EXPECT_EQ(tuvx_model_number_of_layers(model), 20u);
+  EXPECT_EQ(tuvx_model_number_of_levels(model), 21u);
+  EXPECT_EQ(tuvx_model_number_of_wavelengths(model), 30u);
+  EXPECT_EQ(tuvx_model_number_of_reactions(model), 0u);
+
+  EXPECT_EQ(tuvx_model_add_builtin_reaction(model, "O3 -> O2 + O(1D)"), TUVX_SUCCESS);
+  EXPECT_EQ(tuvx_model_number_of_reactions(model), 1u);
+
+  char name[64];
+  EXPECT_EQ(tuvx_model_reaction_name(model, 0, name, sizeof(name)), TUVX_SUCCESS);
+  EXPECT_EQ(std::string(name), "O3 -> O2 + O(1D)");
+
+  char short_name[4];
+  EXPECT_EQ(tuvx_model_reaction_name(model, 0, short_name, sizeof(short_name)), TUVX_SUCCESS);
+  EXPECT_EQ(std::string(short_name), "O3 ");
+
+  tuvx_model_destroy(model);
+}
+
+TEST(CApiTest, ErrorCodes)
+{
+  int error = 0;
+  EXPECT_EQ(tuvx_model_create(nullptr, &error), nullptr);
+  EXPECT_EQ(error, TUVX_CONFIGURATION_ERROR_CODE_MISSING_KEY);
+
+  auto config = SmallConfig();
+  config.wavelength_min = 800.0;
+  EXPECT_EQ(tuvx_model_create(&config, &error), nullptr);
+  EXPECT_EQ(error, TUVX_CONFIGURATION_ERROR_CODE_INVALID_KEY);
+
+  config = SmallConfig();
+  tuvx_model* model = tuvx_model_create(&config, &error);
+  ASSERT_NE(model, nullptr);
+  EXPECT_EQ(tuvx_model_add_builtin_reaction(model, "NO2 -> NO + O"), TUVX_CONFIGURATION_ERROR_CODE_INVALID_KEY);
+
+  double sza = 30.0;
+  tuvx_column_batch batch{};
+  batch.n_columns = 1;
+  batch.n_layers = 19;
+  batch.solar_zenith_angle = &sza;
+  batch.solar_zenith_angle_stride = 1;
+  tuvx_rate_array rates{};
+  EXPECT_EQ(tuvx_model_calculate_batch(model, &batch, &rates), TUVX_PROFILE_ERROR_CODE_INVALID_SIZE);
+  EXPECT_EQ(tuvx_model_calculate_batch(nullptr, &batch, &rates), TUVX_INTERNAL_ERROR_CODE_GENERAL);
+
+  // A missing output buffer is reported rather than written through
+  batch.n_layers = tuvx_model_number_of_layers(model);
+  EXPECT_EQ(tuvx_model_calculate_batch(model, &batch, &rates), TUVX_INTERNAL_ERROR_CODE_GENERAL);
+
+  tuvx_model_destroy(model);
+  tuvx_model_destroy(nullptr);
+}
+
+TEST(CApiTest, BatchMatchesCppModel)
+{
+  auto config = SmallConfig();
+  int error = 0;
+  tuvx_model* model = tuvx_model_create(&config, &error);
+  ASSERT_NE(model, nullptr);
+  ASSERT_EQ(tuvx_model_add_standard_radiators(model), TUVX_SUCCESS);
+  ASSERT_EQ(tuvx_model_add_builtin_reaction(model, "O3 -> O2 + O(1D)"), TUVX_SUCCESS);
+
+  std::vector<double> wl = { 280.0, 320.0, 360.0, 400.0 };
+  std::vector<double> xs = { 1e-19, 5e-20, 1e-20, 1e-21 };
+  ASSERT_EQ(
+      tuvx_model_add_tabulated_reaction(model, "X -> Y", wl.size(), wl.data(), xs.data(), 0.5), TUVX_SUCCESS);
+
+  const std::size_t n_layers = tuvx_model_number_of_layers(model);
+  const std::size_t n_levels = tuvx_model_number_of_levels(model);
+  const std::size_t n_reactions = tuvx_model_number_of_reactions(model);
+  ASSERT_EQ(n_reactions, 2u);
+
+  // Reference C++ model with the same configuration
+  tuvx::ModelConfig cpp_config;
+  cpp_config.n_wavelength_bins = 30;
+  cpp_config.wavelength_max = 400.0;
+  cpp_config.n_altitude_layers = 20;
+  cpp_config.altitude_max = 60.0;
+  tuvx::TuvModel reference(cpp_config);
+  reference.AddStandardRadiators();
+  tuvx::O3CrossSection o3_xs;
+  tuvx::O3O1DQuantumYield o3_qy;
+  reference.AddPhotolysisReaction("O3 -> O2 + O(1D)", &o3_xs, &o3_qy);
+
+  // Fortran-style column-major inputs: temperature(n_layers, n_columns)
+  auto mid = reference.AltitudeGrid().Midpoints();
+  std::vector<double> midpoints(mid.begin(), mid.end());
+  auto t = tuvx::StandardAtmosphere::GenerateTemperatureProfile(midpoints);
+  auto n = tuvx::StandardAtmosphere::GenerateAirDensityProfile(midpoints);
+  auto o3 = tuvx::StandardAtmosphere::GenerateOzoneProfile(midpoints, 300.0);
+
+  const std::size_t n_columns = 2;
+  std::vector<double> sza = { 25.0, 60.0 };
+  std::vector<double> temperature, air_density, ozone;
+  for (std::size_t c = 0; c < n_columns; ++c)
+  {
+    temperature.insert(temperature.end(), t.begin(), t.end());
+    air_density.insert(air_density.end(), n.begin(), n.end());
+    ozone.insert(ozone.end(), o3.begin(), o3.end());
+  }
+
+  tuvx_column_batch batch{};
+  batch.n_columns = n_columns;
+  batch.n_layers = n_layers;
+  batch.solar_zenith_angle = sza.data();
+  batch.solar_zenith_angle_stride = 1;
+  batch.temperature = temperature.data();
+  batch.temperature_column_stride = static_cast<ptrdiff_t>(n_layers);
+  batch.temperature_layer_stride = 1;
+  batch.air_density = air_density.data();
+  batch.air_density_column_stride = static_cast<ptrdiff_t>(n_layers);
+  batch.air_density_layer_stride = 1;
+  batch.ozone = ozone.data();
+  batch.ozone_column_stride = static_cast<ptrdiff_t>(n_layers);
+  batch.ozone_layer_stride = 1;
+
+  std::vector<double> j(n_levels * n_reactions * n_columns, -1.0);
+  tuvx_rate_array rates{ j.data(),
+                         static_cast<ptrdiff_t>(n_levels * n_reactions),
+                         static_cast<ptrdiff_t>(n_levels),
+                         1 };
+  ASSERT_EQ(tuvx_model_calculate_batch(model, &batch, &rates), TUVX_SUCCESS);
+
+  reference.SetTemperatureProfile(t);
+  reference.SetAirDensityProfile(n);
+  reference.SetOzoneProfile(o3);
+  for (std::size_t c = 0; c < n_columns; ++c)
+  {
+    auto output = reference.Calculate(sza[c]);
+    for (std::size_t l = 0; l < n_levels; ++l)
+    {
+      EXPECT_DOUBLE_EQ(j[c * n_levels * n_reactions + l], output.photolysis_rates[0].rates[l]);
+      EXPECT_GE(j[c * n_levels * n_reactions + n_levels + l], 0.0);
+    }
+  }
+
+  tuvx_model_destroy(model);
+}
@@ -176,6 +176,26 @@ TEST(LinearInterpolatorTest, SizeMismatch)
   EXPECT_DOUBLE_EQ(result[0], 0.0);
 }
 
+TEST(LinearInterpolatorTest, InterpolateIntoMatchesInterpolate)
+{
+  LinearInterpolator interp;
+
+  std::vector<double> source_x = { 0.0, 1.0, 5.0, 10.0 };
+  std::vector<double> source_y = { 0.0, 10.0, 50.0, 100.0 };
+  std::vector<double> target_x = { -1.0, 0.5, 3.0, 7.5, 12.0 };
+
+  std::vector<double> result(target_x.size(), -1.0);
+  interp.InterpolateInto(target_x, source_x, source_y, result);
+  EXPECT_EQ(result, interp.Interpolate(target_x, source_x, source_y));
+
+  // A shorter destination takes the leading values; mismatched sources give zeros
+  std::vector<double> first(2, -1.0);
+  interp.InterpolateInto(target_x, source_x, source_y, first);
+  EXPECT_EQ(first, std::vector<double>({ 0.0, 5.0 }));
+  interp.InterpolateInto(target_x, source_x, std::vector<double>{ 1.0 }, result);
+  EXPECT_EQ(result, std::vector<double>(target_x.size(), 0.0));
+}
+
 // ============================================================================
 // LinearInterpolator Non-Uniform Spacing Tests
 // ============================================================================
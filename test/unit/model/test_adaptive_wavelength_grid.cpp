@@ -0,0 +1,145 @@
+#include <tuvx/cross_section/types/o3.hpp>
+#include <tuvx/model/adaptive_wavelength_grid.hpp>
+#include <tuvx/quantum_yield/types/o3_o1d.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace tuvx;
+
+class AdaptiveWavelengthGridTest : public ::testing::Test
+{
+ protected:
+  /// Model with the standard radiators and O3 photolysis, on equal bins unless edges are given
+  TuvModel MakeModel(std::vector<double> edges = {}) const
+  {
+    ModelConfig config;
+    config.n_altitude_layers = 20;
+    TuvModel model(config);
+    if (!edges.empty())
+    {
+      model.SetWavelengthGrid(std::move(edges));
+    }
+    model.AddStandardRadiators();
+    model.AddPhotolysisReaction("O3 -> O2 + O(1D)", &o3_xs_, &o3_qy_);
+    model.AddPhotolysisReaction("O3 -> O2 + O(3P)", &o3_xs_, &o3p_qy_);
+    return model;
+  }
+
+  static std::vector<double> EqualEdges(std::size_t n_bins)
+  {
+    std::vector<double> edges;
+    for (std::size_t i = 0; i <= n_bins; ++i)
+    {
+      edges.push_back(280.0 + 420.0 * static_cast<double>(i) / static_cast<double>(n_bins));
+    }
+    return edges;
+  }
+
+  /// Largest relative error of surface and mid-column J against a reference
+  static double MaxError(TuvModel& model, const ModelOutput& reference)
+  {
+    auto rates = model.Calculate(30.0).photolysis_rates;
+    double max_error = 0.0;
+    for (std::size_t r = 0; r < rates.size(); ++r)
+    {
+      for (std::size_t level : { std::size_t{ 0 }, std::size_t{ 10 } })
+      {
+        double expected = reference.photolysis_rates[r].rates[level];
+        max_error = std::max(max_error, std::abs(rates[r].rates[level] - expected) / expected);
+      }
+    }
+    return max_error;
+  }
+
+  O3CrossSection o3_xs_;
+  O3O1DQuantumYield o3_qy_;
+  O3O3PQuantumYield o3p_qy_;
+};
+
+TEST_F(AdaptiveWavelengthGridTest, SpendsBudgetWithinModelRange)
+{
+  AdaptiveGridConfig config;
+  config.max_bins = 40;
+  auto grid = BuildAdaptiveWavelengthGrid(MakeModel(), config);
+
+  ASSERT_EQ(grid.edges.size(), 41u);
+  EXPECT_EQ(grid.edges.front(), 280.0);
+  EXPECT_EQ(grid.edges.back(), 700.0);
+  EXPECT_TRUE(std::adjacent_find(grid.edges.begin(), grid.edges.end(), std::greater_equal<>()) == grid.edges.end());
+  EXPECT_GT(grid.estimated_error, 0.0);
+
+  // A larger budget lowers the estimate
+  config.max_bins = 80;
+  EXPECT_LT(BuildAdaptiveWavelengthGrid(MakeModel(), config).estimated_error, grid.estimated_error);
+}
+
+TEST_F(AdaptiveWavelengthGridTest, ConcentratesBinsAtOzoneCutoff)
+{
+  AdaptiveGridConfig config;
+  config.max_bins = 40;
+  auto edges = BuildAdaptiveWavelengthGrid(MakeModel(), config).edges;
+
+  auto mean_width = [&](double low, double high)
+  {
+    double width = 0.0;
+    std::size_t n = 0;
+    for (std::size_t i = 0; i + 1 < edges.size(); ++i)
+    {
+      double center = 0.5 * (edges[i] + edges[i + 1]);
+      if (center >= low && center < high)
+      {
+        width += edges[i + 1] - edges[i];
+        ++n;
+      }
+    }
+    return n > 0 ? width / static_cast<double>(n) : 0.0;
+  };
+  EXPECT_LT(mean_width(290.0, 320.0), 0.5 * mean_width(400.0, 580.0));
+}
+
+TEST_F(AdaptiveWavelengthGridTest, BeatsEqualSpacingAtSameBinCount)
+{
+  TuvModel reference_model = MakeModel(EqualEdges(840));
+  auto reference = reference_model.Calculate(30.0);
+
+  AdaptiveGridConfig config;
+  config.max_bins = 30;
+  TuvModel adaptive = MakeModel(BuildAdaptiveWavelengthGrid(MakeModel(), config).edges);
+  TuvModel equal = MakeModel(EqualEdges(30));
+
+  double adaptive_error = MaxError(adaptive, reference);
+  EXPECT_LT(adaptive_error, 0.02);
+  EXPECT_LT(adaptive_error, 0.5 * MaxError(equal, reference));
+}
+
+TEST_F(AdaptiveWavelengthGridTest, StopsAtTolerance)
+{
+  AdaptiveGridConfig config;
+  config.max_bins = 400;
+  config.tolerance = 0.01;
+  auto loose = BuildAdaptiveWavelengthGrid(MakeModel(), config);
+  EXPECT_LE(loose.estimated_error, 0.01);
+  EXPECT_LT(loose.edges.size(), 401u);
+
+  config.tolerance = 0.001;
+  auto tight = BuildAdaptiveWavelengthGrid(MakeModel(), config);
+  EXPECT_LE(tight.estimated_error, 0.001);
+  EXPECT_GT(tight.edges.size(), loose.edges.size());
+}
+
+TEST_F(AdaptiveWavelengthGridTest, RejectsInvalidConfig)
+{
+  AdaptiveGridConfig config;
+  config.max_bins = 0;
+  EXPECT_THROW(BuildAdaptiveWavelengthGrid(MakeModel(), config), std::invalid_argument);
+  config.max_bins = 10;
+  config.reference_resolution = 0.0;
+  EXPECT_THROW(BuildAdaptiveWavelengthGrid(MakeModel(), config), std::invalid_argument);
+}
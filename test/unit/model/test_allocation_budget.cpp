@@ -0,0 +1,303 @@
+// Heap-allocation budgets for the hot paths
+//
+// This executable replaces the global allocation functions with counting
+// versions, so every test here can measure exactly how many allocations a
+// call makes. Budgets are set just above the current counts: a change that
+// adds allocations to a hot path fails here, and a change that removes them
+// should lower the budget to lock the improvement in. The prepared path
+// (TuvModel::Prepare() and ExecutionPlan::Execute()) has no budget: once
+// warmed up it must not allocate at all.
+
+#include <tuvx/cross_section/types/o3.hpp>
+#include <tuvx/cross_section/types/shared.hpp>
+#include <tuvx/model/execution_plan.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/quantum_yield/types/o3_o1d.hpp>
+#include <tuvx/quantum_yield/types/shared.hpp>
+#include <tuvx/solver/delta_eddington.hpp>
+#include <tuvx/solver/pca_solver.hpp>
+#include <tuvx/util/allocation_counter.hpp>
+#include <tuvx/util/reproducible_sum.hpp>
+#include <tuvx/util/shared_table.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+TUVX_DEFINE_COUNTING_ALLOCATOR();
+
+using namespace tuvx;
+
+namespace
+{
+  // Per-call allocation budgets for the reference configuration below
+  // (20 wavelength bins, 10 layers, standard radiators, 2 reactions)
+  constexpr std::uint64_t kCalculateBudget = 170;
+  constexpr std::uint64_t kSolveBudget = 70;
+  constexpr std::uint64_t kCalculateAllBudget = 90;
+  constexpr std::uint64_t kCalculateInPlaceBudget = 95;
+
+  ModelConfig ReferenceConfig()
+  {
+    ModelConfig config;
+    config.n_wavelength_bins = 20;
+    config.n_altitude_layers = 10;
+    return config;
+  }
+}  // namespace
+
+class AllocationBudgetTest : public ::testing::Test
+{
+ protected:
+  void SetUp() override
+  {
+    model_ = std::make_unique<TuvModel>(ReferenceConfig());
+    model_->AddStandardRadiators();
+    model_->AddPhotolysisReaction("O3 -> O2 + O(1D)", &o3_xs_, &o3_qy_);
+    model_->AddPhotolysisReaction("O3 -> O2 + O(3P)", &o3_xs_, &o3p_qy_);
+
+    // Warm up so one-time setup is not charged to the measured call
+    output_ = model_->Calculate(30.0);
+  }
+
+  O3CrossSection o3_xs_;
+  O3O1DQuantumYield o3_qy_;
+  O3O3PQuantumYield o3p_qy_;
+  std::unique_ptr<TuvModel> model_;
+  ModelOutput output_;
+};
+
+TEST(AllocationCounterTest, CountsNewAndDelete)
+{
+  AllocationScope scope;
+  auto* value = new double(1.0);
+  auto stats = scope.Stats();
+  EXPECT_TRUE(AllocationCounters::installed.load());
+  EXPECT_EQ(stats.allocations, 1u);
+  EXPECT_EQ(stats.deallocations, 0u);
+  EXPECT_EQ(stats.bytes, sizeof(double));
+
+  delete value;
+  EXPECT_EQ(scope.Stats().deallocations, 1u);
+
+  scope.Reset();
+  std::vector<double> values(100);
+  EXPECT_EQ(scope.Stats().allocations, 1u);
+  EXPECT_EQ(scope.Stats().bytes, 100 * sizeof(double));
+}
+
+TEST(AllocationCounterTest, CountsAlignedAllocations)
+{
+  struct alignas(64) Aligned
+  {
+    double value[8];
+  };
+  auto stats = CountAllocations([] { auto ptr = std::make_unique<Aligned>(); });
+  EXPECT_EQ(stats.allocations, 1u);
+  EXPECT_EQ(stats.deallocations, 1u);
+}
+
+TEST(AllocationCounterTest, SteadyStateReductionIsAllocationFree)
+{
+  std::vector<double> values(10000, 0.5);
+  double sum = 0.0;
+  auto stats = CountAllocations([&] { sum = ReproducibleSum(values); });
+  EXPECT_EQ(stats.allocations, 0u);
+  EXPECT_DOUBLE_EQ(sum, 5000.0);
+}
+
+TEST_F(AllocationBudgetTest, Calculate)
+{
+  auto stats = CountAllocations([&] { output_ = model_->Calculate(30.0); });
+  EXPECT_LE(stats.allocations, kCalculateBudget) << stats.bytes << " bytes";
+}
+
+TEST_F(AllocationBudgetTest, CalculateInPlace)
+{
+  auto by_value = CountAllocations([&] { output_ = model_->Calculate(30.0); });
+
+  model_->Calculate(30.0, output_);
+  auto stats = CountAllocations([&] { model_->Calculate(30.0, output_); });
+  EXPECT_LE(stats.allocations, kCalculateInPlaceBudget) << stats.bytes << " bytes";
+  EXPECT_LT(stats.allocations, by_value.allocations);
+}
+
+TEST(StartupProfileTest, RecordsComponentMemory)
+{
+  ASSERT_TRUE(StartupProfiler::MemoryTracked());
+  TuvModel model(ReferenceConfig());
+  model.AddStandardRadiators();
+  std::size_t found = 0;
+  for (const auto& record : model.StartupProfile().Records())
+  {
+    if (record.component == "radiator O3")
+    {
+      ++found;
+      // The cross-section tables are built when the radiator is constructed
+      EXPECT_GT(record.allocations, 0u);
+      EXPECT_GT(record.bytes, 1000u);
+    }
+  }
+  EXPECT_EQ(found, 1u);
+  EXPECT_GT(model.StartupProfile().TotalBytes(), 0u);
+}
+
+TEST_F(AllocationBudgetTest, Solve)
+{
+  RadiatorState state = model_->Radiators().CombinedState();
+  SphericalGeometry geometry(model_->AltitudeGrid());
+  auto slant = geometry.Calculate(30.0);
+  std::vector<double> albedo(model_->WavelengthGrid().Spec().n_cells, 0.1);
+  std::vector<double> etf(model_->WavelengthGrid().Spec().n_cells, 1e14);
+
+  SolverInput input;
+  input.radiator_state = &state;
+  input.geometry = &slant;
+  input.surface_albedo = &albedo;
+  input.extraterrestrial_flux = &etf;
+  input.solar_zenith_angle = 30.0;
+
+  DeltaEddingtonSolver solver;
+  RadiationField field = solver.Solve(input);
+  auto stats = CountAllocations([&] { field = solver.Solve(input); });
+  EXPECT_LE(stats.allocations, kSolveBudget) << stats.bytes << " bytes";
+}
+
+TEST_F(AllocationBudgetTest, PcaSolverReusesItsBuffers)
+{
+  RadiatorState state = model_->Radiators().CombinedState();
+  SphericalGeometry geometry(model_->AltitudeGrid());
+  auto slant = geometry.Calculate(30.0);
+  std::vector<double> albedo(model_->WavelengthGrid().Spec().n_cells, 0.1);
+  std::vector<double> etf(model_->WavelengthGrid().Spec().n_cells, 1e14);
+  SolverWorkspace workspace;
+
+  SolverInput input;
+  input.radiator_state = &state;
+  input.geometry = &slant;
+  input.surface_albedo = &albedo;
+  input.extraterrestrial_flux = &etf;
+  input.solar_zenith_angle = 30.0;
+  input.workspace = &workspace;
+
+  PcaSolverConfig config;
+  config.bin_size = 10;
+  PcaSolver solver(config);
+  RadiationField field;
+  solver.SolveInto(input, field);
+  auto stats = CountAllocations([&] { solver.SolveInto(input, field); });
+  EXPECT_EQ(stats.allocations, 0u) << stats.bytes << " bytes";
+}
+
+TEST_F(AllocationBudgetTest, CalculateAll)
+{
+  std::vector<double> temperature(model_->AltitudeGrid().Spec().n_cells, 250.0);
+  std::vector<PhotolysisRateCalculator::Result> results;
+  auto stats = CountAllocations(
+      [&]
+      {
+        results = model_->PhotolysisReactions().CalculateAll(
+            output_.radiation_field, model_->WavelengthGrid(), temperature);
+      });
+  EXPECT_LE(stats.allocations, kCalculateAllBudget) << stats.bytes << " bytes";
+}
+
+TEST_F(AllocationBudgetTest, SharedSpectraInterpolateWithoutAllocating)
+{
+  SharedTableBuilder builder;
+  model_->BinSharedTables(builder, { 200.0, 250.0, 300.0 });
+  std::string name = "/tuvx_test_allocation_" + std::to_string(getpid());
+  SharedTableSegment::Remove(name);
+  auto tables = builder.Publish(name);
+  SharedCrossSection cross_section(tables, "O3 -> O2 + O(1D)/cross_section");
+  SharedQuantumYield quantum_yield(tables, "O3 -> O2 + O(1D)/quantum_yield");
+
+  // On the binned grid and on another one
+  const Grid& grid = model_->WavelengthGrid();
+  Grid coarse = Grid::EquallySpaced(GridSpec{ .name = "wavelength", .units = "nm", .n_cells = 7 }, 250.0, 400.0);
+  std::vector<double> values(grid.Spec().n_cells);
+  auto stats = CountAllocations(
+      [&]
+      {
+        cross_section.CalculateInto(grid, 230.0, values);
+        quantum_yield.CalculateInto(grid, 230.0, 0.0, values);
+        cross_section.CalculateInto(coarse, 280.0, values);
+        quantum_yield.CalculateInto(coarse, 280.0, 0.0, values);
+      });
+  EXPECT_EQ(stats.allocations, 0u);
+}
+
+TEST_F(AllocationBudgetTest, PlanExecute)
+{
+  std::size_t n_levels = model_->AltitudeGrid().Spec().n_cells + 1;
+  std::vector<double> rates(2 * n_levels);
+  ColumnView column;
+  column.solar_zenith_angle = 30.0;
+  auto stride = static_cast<std::ptrdiff_t>(n_levels);
+
+  model_->CalculatePhotolysisRates(column, rates.data(), stride, 1);
+  auto unplanned = CountAllocations([&] { model_->CalculatePhotolysisRates(column, rates.data(), stride, 1); });
+
+  ExecutionPlan plan = model_->Prepare();
+  plan.Execute(column, rates.data(), stride, 1);
+  auto stats = CountAllocations([&] { plan.Execute(column, rates.data(), stride, 1); });
+  EXPECT_EQ(stats.allocations, 0u) << stats.bytes << " bytes";
+  EXPECT_LT(stats.allocations, unplanned.allocations);
+
+  // Later columns with their own profiles and geometry reuse the same buffers
+  ModelConfig config = ReferenceConfig();
+  config.use_spherical_geometry = true;
+  model_->SetConfig(config);
+  ExecutionPlan spherical = model_->Prepare();
+  std::vector<double> temperature(config.n_altitude_layers, 240.0);
+  column.temperature = StridedView<const double>(temperature.data(), temperature.size());
+  column.solar_zenith_angle = 88.0;
+  spherical.Execute(column, rates.data(), stride, 1);
+  column.solar_zenith_angle = 40.0;
+  stats = CountAllocations([&] { spherical.Execute(column, rates.data(), stride, 1); });
+  EXPECT_EQ(stats.allocations, 0u) << stats.bytes << " bytes";
+}
+
+TEST_F(AllocationBudgetTest, PreparedPathIsAllocationFreeInSteadyState)
+{
+  std::size_t n_layers = model_->AltitudeGrid().Spec().n_cells;
+  std::size_t n_levels = n_layers + 1;
+  std::size_t n_columns = 3;
+  std::vector<double> rates(2 * n_levels * n_columns);
+  auto reaction_stride = static_cast<std::ptrdiff_t>(n_levels * n_columns);
+  auto level_stride = static_cast<std::ptrdiff_t>(n_columns);
+
+  ExecutionPlan plan = model_->Prepare();
+  std::vector<double> temperature(n_layers);
+  std::vector<double> ozone(n_layers);
+  ColumnView column;
+  column.temperature = StridedView<const double>(temperature.data(), n_layers);
+  column.ozone = StridedView<const double>(ozone.data(), n_layers);
+
+  // Each column writes its own slot of an interleaved output array
+  auto run_columns = [&](std::size_t first_step, std::size_t n_steps)
+  {
+    for (std::size_t step = first_step; step < first_step + n_steps; ++step)
+    {
+      for (std::size_t i = 0; i < n_layers; ++i)
+      {
+        temperature[i] = 190.0 + 10.0 * static_cast<double>((i + step) % 12);
+        ozone[i] = 1.0e12 * (1.0 + 0.1 * static_cast<double>(step % 5));
+      }
+      column.solar_zenith_angle = 5.0 * static_cast<double>(step % 20);
+      column.surface_albedo = 0.05 * static_cast<double>(step % 4);
+      plan.Execute(column, rates.data() + step % n_columns, reaction_stride, level_stride);
+    }
+  };
+
+  // One warm-up column sizes every buffer; later columns, including night
+  // columns (solar zenith angle 90 and 95), must reuse them
+  run_columns(0, 1);
+  auto stats = CountAllocations([&] { run_columns(1, 40); });
+  EXPECT_EQ(stats.allocations, 0u) << stats.bytes << " bytes";
+  EXPECT_EQ(stats.deallocations, 0u);
+}
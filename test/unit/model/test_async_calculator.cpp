@@ -0,0 +1,244 @@
+#include <tuvx/cross_section/types/o3.hpp>
+#include <tuvx/model/async_calculator.hpp>
+#include <tuvx/model/batch_driver.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/quantum_yield/types/o3_o1d.hpp>
+#include <tuvx/radiator/radiator.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace tuvx;
+
+namespace
+{
+  /// Radiator that fails on request, when copied or when updated
+  class FailingRadiator : public Radiator
+  {
+   public:
+    struct Failures
+    {
+      std::atomic<bool> clone{ false };
+      std::atomic<bool> update{ false };
+    };
+
+    explicit FailingRadiator(std::shared_ptr<Failures> failures)
+        : failures_(std::move(failures))
+    {
+      name_ = "failing";
+    }
+
+    std::unique_ptr<Radiator> Clone() const override
+    {
+      if (failures_->clone)
+      {
+        throw std::runtime_error("clone failed");
+      }
+      return std::make_unique<FailingRadiator>(*this);
+    }
+
+    void UpdateState(const GridWarehouse&, const ProfileWarehouse&) override
+    {
+      if (failures_->update)
+      {
+        throw std::runtime_error("update failed");
+      }
+    }
+
+   private:
+    std::shared_ptr<Failures> failures_;
+  };
+}  // namespace
+
+class AsyncCalculatorTest : public ::testing::Test
+{
+ protected:
+  void SetUp() override
+  {
+    ModelConfig config;
+    config.n_wavelength_bins = 20;
+    config.wavelength_min = 280.0;
+    config.wavelength_max = 400.0;
+    config.n_altitude_layers = 10;
+    model_ = std::make_unique<TuvModel>(config);
+    model_->AddStandardRadiators();
+    model_->AddPhotolysisReaction("O3 -> O2 + O(1D)", &o3_xs_, &o3_qy_);
+    model_->AddPhotolysisReaction("O3 -> O2 + O(3P)", &o3_xs_, &o3p_qy_);
+
+    n_layers_ = model_->AltitudeGrid().Spec().n_cells;
+    n_levels_ = n_layers_ + 1;
+    auto mid = model_->AltitudeGrid().Midpoints();
+    std::vector<double> midpoints(mid.begin(), mid.end());
+    temperature_ = StandardAtmosphere::GenerateTemperatureProfile(midpoints);
+    air_density_ = StandardAtmosphere::GenerateAirDensityProfile(midpoints);
+    ozone_ = StandardAtmosphere::GenerateOzoneProfile(midpoints, 300.0);
+    for (std::size_t c = 0; c < kColumns; ++c)
+    {
+      sza_.push_back(10.0 + 8.0 * static_cast<double>(c));
+    }
+  }
+
+  /// Batch of kColumns columns sharing one profile and differing in SZA
+  ColumnBatchView Batch() const
+  {
+    ColumnBatchView batch;
+    batch.n_columns = kColumns;
+    batch.n_layers = n_layers_;
+    batch.solar_zenith_angle = StridedView<const double>(sza_.data(), kColumns);
+    batch.temperature = { temperature_.data(), 0, 1 };
+    batch.air_density = { air_density_.data(), 0, 1 };
+    batch.ozone = { ozone_.data(), 0, 1 };
+    return batch;
+  }
+
+  RateBatchView Rates(std::vector<double>& j) const
+  {
+    j.assign(kColumns * 2 * n_levels_, -1.0);
+    auto levels = static_cast<std::ptrdiff_t>(n_levels_);
+    return { j.data(), 2 * levels, levels, 1 };
+  }
+
+  static constexpr std::size_t kColumns = 8;
+  O3CrossSection o3_xs_;
+  O3O1DQuantumYield o3_qy_;
+  O3O3PQuantumYield o3p_qy_;
+  std::unique_ptr<TuvModel> model_;
+  std::size_t n_layers_{ 0 };
+  std::size_t n_levels_{ 0 };
+  std::vector<double> sza_, temperature_, air_density_, ozone_;
+};
+
+TEST_F(AsyncCalculatorTest, MatchesBatchDriver)
+{
+  std::vector<double> expected;
+  BatchDriver(*model_).Calculate(Batch(), Rates(expected));
+
+  AsyncCalculatorConfig config;
+  config.n_workers = 2;
+  AsyncCalculator async(*model_, config);
+  std::vector<std::vector<double>> j(3);
+  std::vector<AsyncTicket> tickets;
+  for (auto& block : j)
+  {
+    tickets.push_back(async.Submit(Batch(), Rates(block)));
+  }
+  for (std::size_t i = 0; i < tickets.size(); ++i)
+  {
+    AsyncResult result = tickets[i].Get();
+    EXPECT_EQ(result.status, AsyncStatus::Completed);
+    EXPECT_EQ(result.columns_completed, kColumns);
+    EXPECT_EQ(j[i], expected) << "request " << i;
+  }
+}
+
+TEST_F(AsyncCalculatorTest, CallbackRunsBeforeFutureIsReady)
+{
+  AsyncCalculator async(*model_);
+  std::atomic<std::size_t> calls{ 0 };
+  std::vector<double> j;
+  auto ticket = async.Submit(
+      Batch(),
+      Rates(j),
+      [&](const AsyncResult& result)
+      {
+        EXPECT_EQ(result.columns_completed, kColumns);
+        ++calls;
+      });
+  ticket.Get();
+  EXPECT_EQ(calls.load(), 1u);
+}
+
+TEST_F(AsyncCalculatorTest, BoundedQueueAndCancellation)
+{
+  AsyncCalculatorConfig config;
+  config.queue_capacity = 1;
+  AsyncCalculator async(*model_, config);
+
+  // Hold the only worker until released so the queue fills up
+  std::atomic<bool> release{ false };
+  std::vector<double> j_first, j_queued, j_rejected;
+  ColumnBatchView empty;
+  auto first = async.Submit(
+      empty,
+      Rates(j_first),
+      [&](const AsyncResult&)
+      {
+        while (!release.load())
+        {
+          std::this_thread::yield();
+        }
+      });
+  while (async.Queued() != 0)
+  {
+    std::this_thread::yield();
+  }
+  auto queued = async.Submit(Batch(), Rates(j_queued));
+  EXPECT_EQ(async.Queued(), 1u);
+  EXPECT_FALSE(async.TrySubmit(Batch(), Rates(j_rejected)).has_value());
+
+  queued.Cancel();
+  release = true;
+  first.Get();
+  AsyncResult result = queued.Get();
+  EXPECT_EQ(result.status, AsyncStatus::Cancelled);
+  EXPECT_EQ(result.columns_completed, 0u);
+  EXPECT_EQ(j_queued[0], -1.0);
+}
+
+TEST_F(AsyncCalculatorTest, RejectsInvalidInput)
+{
+  AsyncCalculatorConfig config;
+  config.n_workers = 0;
+  EXPECT_THROW(AsyncCalculator(*model_, config), std::invalid_argument);
+
+  AsyncCalculator async(*model_);
+  ColumnBatchView batch = Batch();
+  batch.n_layers = n_layers_ + 1;
+  std::vector<double> j;
+  EXPECT_THROW(async.Submit(batch, Rates(j)), TuvxInternalException);
+}
+
+TEST_F(AsyncCalculatorTest, ReportsFailureThroughCallback)
+{
+  auto failures = std::make_shared<FailingRadiator::Failures>();
+  model_->AddRadiator(FailingRadiator(failures));
+  AsyncCalculator async(*model_);
+
+  failures->update = true;
+  std::atomic<std::size_t> calls{ 0 };
+  AsyncStatus status = AsyncStatus::Completed;
+  std::vector<double> j;
+  auto ticket = async.Submit(
+      Batch(),
+      Rates(j),
+      [&](const AsyncResult& result)
+      {
+        status = result.status;
+        EXPECT_EQ(result.columns_completed, 0u);
+        ++calls;
+      });
+  EXPECT_THROW(ticket.Get(), std::runtime_error);
+  EXPECT_EQ(calls.load(), 1u);
+  EXPECT_EQ(status, AsyncStatus::Failed);
+
+  // The worker survives and takes the next request
+  failures->update = false;
+  std::vector<double> j_next;
+  EXPECT_EQ(async.Submit(Batch(), Rates(j_next)).Get().status, AsyncStatus::Completed);
+}
+
+TEST_F(AsyncCalculatorTest, WorkerStartupFailureThrows)
+{
+  auto failures = std::make_shared<FailingRadiator::Failures>();
+  model_->AddRadiator(FailingRadiator(failures));
+  failures->clone = true;
+  AsyncCalculatorConfig config;
+  config.n_workers = 3;
+  EXPECT_THROW(AsyncCalculator(*model_, config), std::runtime_error);
+}
@@ -0,0 +1,132 @@
+#include <tuvx/cross_section/types/band.hpp>
+#include <tuvx/cross_section/types/o3.hpp>
+#include <tuvx/model/band_aggregation.hpp>
+#include <tuvx/quantum_yield/types/o3_o1d.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace tuvx;
+
+class BandAggregationTest : public ::testing::Test
+{
+ protected:
+  TuvModel FineModel(bool with_radiators) const
+  {
+    ModelConfig config;
+    config.n_wavelength_bins = 70;
+    config.n_altitude_layers = 20;
+    TuvModel model(config);
+    if (with_radiators)
+    {
+      model.AddStandardRadiators();
+    }
+    model.AddPhotolysisReaction("O3 -> O2 + O(1D)", &o3_xs_, &o3_qy_);
+    model.AddPhotolysisReaction("O3 -> O2 + O(3P)", &o3_xs_, &o3p_qy_);
+    return model;
+  }
+
+  O3CrossSection o3_xs_;
+  O3O1DQuantumYield o3_qy_;
+  O3O3PQuantumYield o3p_qy_;
+};
+
+TEST(BandCrossSectionTest, InterpolatesInTemperature)
+{
+  BandCrossSection xs("test", { 200.0, 300.0 }, { { 1.0, 2.0 }, { 3.0, 6.0 } });
+  GridSpec spec{ "wavelength", "nm", 2 };
+  Grid bands(spec, { 280.0, 300.0, 400.0 });
+
+  EXPECT_EQ(xs.Calculate(bands, 250.0), (std::vector<double>{ 2.0, 4.0 }));
+  EXPECT_EQ(xs.Calculate(bands, 100.0), (std::vector<double>{ 1.0, 2.0 }));
+  EXPECT_EQ(xs.Clone()->Calculate(bands, 400.0), (std::vector<double>{ 3.0, 6.0 }));
+
+  Grid other(GridSpec{ "wavelength", "nm", 1 }, { 280.0, 400.0 });
+  EXPECT_THROW(xs.Calculate(other, 250.0), std::invalid_argument);
+  EXPECT_THROW(BandCrossSection("bad", { 200.0 }, { { 1.0 }, { 2.0 } }), std::invalid_argument);
+}
+
+TEST(BandAggregationMergeTest, SplitsWhereFeaturesChange)
+{
+  // Two plateaus; the heavily weighted bins at the end must stay resolved
+  std::vector<std::vector<double>> features = { { 0.0 }, { 0.0 }, { 0.0 }, { 1.0 }, { 1.0 }, { 0.5 }, { 0.9 } };
+  std::vector<double> weights = { 1.0, 1.0, 1.0, 1.0, 1.0, 10.0, 10.0 };
+
+  EXPECT_EQ(detail::MergeBands(features, weights, 4), (std::vector<std::size_t>{ 0, 3, 5, 6, 7 }));
+  EXPECT_EQ(detail::MergeBands(features, weights, 1), (std::vector<std::size_t>{ 0, 7 }));
+  EXPECT_EQ(detail::MergeBands(features, weights, 20), (std::vector<std::size_t>{ 0, 1, 2, 3, 4, 5, 6, 7 }));
+}
+
+TEST_F(BandAggregationTest, ReproducesFineGridWithoutAttenuation)
+{
+  // With no radiators the actinic flux is the attenuated-free beam, so band
+  // J-values equal the fine ones at every level when T is a table node
+  TuvModel fine = FineModel(false);
+  fine.SetTemperatureProfile(std::vector<double>(20, 220.0));
+  BandAggregationConfig config;
+  config.n_bands = 6;
+  BandAggregation bands(fine, config);
+
+  ASSERT_EQ(bands.NumberOfBands(), 6u);
+  EXPECT_EQ(bands.BandEdges().front(), 280.0);
+  EXPECT_EQ(bands.BandEdges().back(), 700.0);
+  EXPECT_TRUE(std::is_sorted(bands.BandEdges().begin(), bands.BandEdges().end()));
+  EXPECT_EQ(bands.Model().WavelengthGrid().Spec().n_cells, 6u);
+
+  auto expected = fine.Calculate(30.0).photolysis_rates;
+  auto actual = bands.Model().Calculate(30.0).photolysis_rates;
+  ASSERT_EQ(actual.size(), expected.size());
+  for (std::size_t r = 0; r < expected.size(); ++r)
+  {
+    EXPECT_EQ(actual[r].reaction_name, expected[r].reaction_name);
+    for (std::size_t l = 0; l < expected[r].rates.size(); ++l)
+    {
+      EXPECT_NEAR(actual[r].rates[l], expected[r].rates[l], 1.0e-10 * expected[r].rates[l]) << r << " " << l;
+    }
+  }
+}
+
+TEST_F(BandAggregationTest, StaysCloseToFineGridOnRandomColumns)
+{
+  TuvModel fine = FineModel(true);
+  BandAggregationConfig config;
+  config.n_bands = 12;
+  BandAggregation bands(fine, config);
+  EXPECT_EQ(bands.NumberOfBands(), 12u);
+  EXPECT_EQ(bands.BandStarts().back(), 70u);
+
+  auto report = bands.Evaluate(fine, 20, 7);
+  EXPECT_EQ(report.n_fine_bins, 70u);
+  EXPECT_EQ(report.n_bands, 12u);
+  ASSERT_EQ(report.reactions.size(), 2u);
+  EXPECT_EQ(report.reactions[0].n_values, 20u * 21u);
+  EXPECT_LT(report.reactions[0].rms_relative_error, 0.05) << report.Summary();
+  EXPECT_LT(report.reactions[1].rms_relative_error, 0.01) << report.Summary();
+  EXPECT_GT(report.fine_seconds, 0.0);
+
+  // More bands are more accurate
+  config.n_bands = 30;
+  auto finer = BandAggregation(fine, config).Evaluate(fine, 20, 7);
+  EXPECT_LT(finer.reactions[0].rms_relative_error, report.reactions[0].rms_relative_error);
+}
+
+TEST_F(BandAggregationTest, RejectsInvalidConfig)
+{
+  TuvModel fine = FineModel(true);
+  BandAggregationConfig config;
+  config.n_bands = 0;
+  EXPECT_THROW(BandAggregation(fine, config), std::invalid_argument);
+  config.n_bands = 10;
+  config.temperatures = { 300.0, 200.0 };
+  EXPECT_THROW(BandAggregation(fine, config), std::invalid_argument);
+
+  BandAggregation bands(fine);
+  ModelConfig other;
+  other.n_altitude_layers = 5;
+  EXPECT_THROW(bands.Evaluate(TuvModel(other), 1, 1), std::invalid_argument);
+}
@@ -0,0 +1,445 @@
+#include <tuvx/cross_section/types/o3.hpp>
+#include <tuvx/model/batch_driver.hpp>
+#include <tuvx/model/numa_batch_buffers.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/quantum_yield/types/o3_o1d.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace tuvx;
+
+namespace
+{
+  ModelConfig SmallConfig()
+  {
+    ModelConfig config;
+    config.n_wavelength_bins = 30;
+    config.wavelength_min = 280.0;
+    config.wavelength_max = 400.0;
+    config.n_altitude_layers = 20;
+    config.altitude_max = 60.0;
+    return config;
+  }
+
+  /// Standard atmosphere profiles for a model's altitude grid, scaled per column
+  struct ColumnProfiles
+  {
+    std::vector<double> temperature;
+    std::vector<double> air_density;
+    std::vector<double> ozone;
+  };
+
+  ColumnProfiles MakeProfiles(const TuvModel& model, double ozone_scale, double temperature_offset)
+  {
+    auto mid = model.AltitudeGrid().Midpoints();
+    std::vector<double> midpoints(mid.begin(), mid.end());
+    ColumnProfiles p;
+    p.temperature = StandardAtmosphere::GenerateTemperatureProfile(midpoints);
+    p.air_density = StandardAtmosphere::GenerateAirDensityProfile(midpoints);
+    p.ozone = StandardAtmosphere::GenerateOzoneProfile(midpoints, 300.0 * ozone_scale);
+    for (auto& t : p.temperature)
+    {
+      t += temperature_offset;
+    }
+    return p;
+  }
+}  // namespace
+
+class BatchDriverTest : public ::testing::Test
+{
+ protected:
+  void SetUp() override
+  {
+    model_ = std::make_unique<TuvModel>(SmallConfig());
+    model_->AddStandardRadiators();
+    model_->AddPhotolysisReaction("O3 -> O2 + O(1D)", &o3_xs_, &o3_qy_);
+    model_->AddPhotolysisReaction("O3 -> O2 + O(3P)", &o3_xs_, &o3p_qy_);
+  }
+
+  O3CrossSection o3_xs_;
+  O3O1DQuantumYield o3_qy_;
+  O3O3PQuantumYield o3p_qy_;
+  std::unique_ptr<TuvModel> model_;
+};
+
+TEST_F(BatchDriverTest, MatchesPerColumnCalculate)
+{
+  const std::size_t n_columns = 3;
+  const std::size_t n_layers = model_->AltitudeGrid().Spec().n_cells;
+  const std::size_t n_levels = n_layers + 1;
+  const std::size_t n_reactions = 2;
+
+  std::vector<double> sza = { 10.0, 45.0, 70.0 };
+  std::vector<double> albedo = { 0.05, 0.1, 0.3 };
+  std::vector<ColumnProfiles> columns;
+  std::vector<double> temperature, air_density, ozone;
+  for (std::size_t c = 0; c < n_columns; ++c)
+  {
+    columns.push_back(MakeProfiles(*model_, 0.8 + 0.2 * static_cast<double>(c), 5.0 * static_cast<double>(c)));
+    temperature.insert(temperature.end(), columns[c].temperature.begin(), columns[c].temperature.end());
+    air_density.insert(air_density.end(), columns[c].air_density.begin(), columns[c].air_density.end());
+    ozone.insert(ozone.end(), columns[c].ozone.begin(), columns[c].ozone.end());
+  }
+
+  ColumnBatchView batch;
+  batch.n_columns = n_columns;
+  batch.n_layers = n_layers;
+  batch.solar_zenith_angle = StridedView<const double>(sza.data(), n_columns);
+  batch.surface_albedo = StridedView<const double>(albedo.data(), n_columns);
+  batch.temperature = { temperature.data(), static_cast<std::ptrdiff_t>(n_layers), 1 };
+  batch.air_density = { air_density.data(), static_cast<std::ptrdiff_t>(n_layers), 1 };
+  batch.ozone = { ozone.data(), static_cast<std::ptrdiff_t>(n_layers), 1 };
+
+  std::vector<double> j(n_columns * n_reactions * n_levels, -1.0);
+  RateBatchView rates{ j.data(),
+                       static_cast<std::ptrdiff_t>(n_reactions * n_levels),
+                       static_cast<std::ptrdiff_t>(n_levels),
+                       1 };
+
+  BatchDriver driver(*model_);
+  driver.Calculate(batch, rates);
+
+  for (std::size_t c = 0; c < n_columns; ++c)
+  {
+    model_->SetTemperatureProfile(columns[c].temperature);
+    model_->SetAirDensityProfile(columns[c].air_density);
+    model_->SetOzoneProfile(columns[c].ozone);
+    model_->SetSurfaceAlbedo(albedo[c]);
+    auto output = model_->Calculate(sza[c]);
+
+    for (std::size_t r = 0; r < n_reactions; ++r)
+    {
+      for (std::size_t l = 0; l < n_levels; ++l)
+      {
+        EXPECT_DOUBLE_EQ(j[c * n_reactions * n_levels + r * n_levels + l], output.photolysis_rates[r].rates[l])
+            << "column " << c << " reaction " << r << " level " << l;
+      }
+    }
+  }
+}
+
+TEST_F(BatchDriverTest, StridedInputsMatchContiguous)
+{
+  const std::size_t n_columns = 2;
+  const std::size_t n_layers = model_->AltitudeGrid().Spec().n_cells;
+  const std::size_t n_levels = n_layers + 1;
+
+  auto profiles = MakeProfiles(*model_, 1.0, 0.0);
+
+  // Array-of-structs layout: [layer][column][field] with 3 fields
+  std::vector<double> aos(n_layers * n_columns * 3);
+  for (std::size_t l = 0; l < n_layers; ++l)
+  {
+    for (std::size_t c = 0; c < n_columns; ++c)
+    {
+      aos[(l * n_columns + c) * 3 + 0] = profiles.temperature[l];
+      aos[(l * n_columns + c) * 3 + 1] = profiles.air_density[l];
+      aos[(l * n_columns + c) * 3 + 2] = profiles.ozone[l];
+    }
+  }
+  std::vector<double> sza = { 30.0, 30.0 };
+
+  ColumnBatchView strided;
+  strided.n_columns = n_columns;
+  strided.n_layers = n_layers;
+  strided.solar_zenith_angle = StridedView<const double>(sza.data(), n_columns);
+  auto layer_stride = static_cast<std::ptrdiff_t>(n_columns * 3);
+  strided.temperature = { aos.data() + 0, 3, layer_stride };
+  strided.air_density = { aos.data() + 1, 3, layer_stride };
+  strided.ozone = { aos.data() + 2, 3, layer_stride };
+
+  // Level-major output: [level][column] for a single reaction subset
+  std::vector<double> j_strided(n_levels * n_columns * 2);
+  RateBatchView strided_rates{ j_strided.data(), 1, static_cast<std::ptrdiff_t>(n_levels * n_columns),
+                               static_cast<std::ptrdiff_t>(n_columns) };
+
+  BatchDriver driver(*model_);
+  driver.Calculate(strided, strided_rates);
+
+  ColumnView contiguous;
+  contiguous.solar_zenith_angle = 30.0;
+  contiguous.surface_albedo = model_->Config().surface_albedo;
+  contiguous.temperature = StridedView<const double>(profiles.temperature.data(), n_layers);
+  contiguous.air_density = StridedView<const double>(profiles.air_density.data(), n_layers);
+  contiguous.ozone = StridedView<const double>(profiles.ozone.data(), n_layers);
+  std::vector<double> j_contiguous(2 * n_levels);
+  model_->CalculatePhotolysisRates(contiguous, j_contiguous.data(), static_cast<std::ptrdiff_t>(n_levels), 1);
+
+  for (std::size_t c = 0; c < n_columns; ++c)
+  {
+    for (std::size_t r = 0; r < 2; ++r)
+    {
+      for (std::size_t l = 0; l < n_levels; ++l)
+      {
+        EXPECT_DOUBLE_EQ(j_strided[r * n_levels * n_columns + l * n_columns + c], j_contiguous[r * n_levels + l]);
+      }
+    }
+  }
+}
+
+TEST_F(BatchDriverTest, ThreadedBitIdenticalAcrossThreadCounts)
+{
+  const std::size_t n_columns = 11;
+  const std::size_t n_layers = model_->AltitudeGrid().Spec().n_cells;
+  const std::size_t n_levels = n_layers + 1;
+  const std::size_t n_reactions = 2;
+
+  std::vector<double> sza(n_columns);
+  std::vector<double> temperature, air_density, ozone;
+  for (std::size_t c = 0; c < n_columns; ++c)
+  {
+    sza[c] = 5.0 + 7.5 * static_cast<double>(c);
+    auto p = MakeProfiles(*model_, 0.7 + 0.05 * static_cast<double>(c), static_cast<double>(c) - 5.0);
+    temperature.insert(temperature.end(), p.temperature.begin(), p.temperature.end());
+    air_density.insert(air_density.end(), p.air_density.begin(), p.air_density.end());
+    ozone.insert(ozone.end(), p.ozone.begin(), p.ozone.end());
+  }
+
+  ColumnBatchView batch;
+  batch.n_columns = n_columns;
+  batch.n_layers = n_layers;
+  batch.solar_zenith_angle = StridedView<const double>(sza.data(), n_columns);
+  batch.temperature = { temperature.data(), static_cast<std::ptrdiff_t>(n_layers), 1 };
+  batch.air_density = { air_density.data(), static_cast<std::ptrdiff_t>(n_layers), 1 };
+  batch.ozone = { ozone.data(), static_cast<std::ptrdiff_t>(n_layers), 1 };
+
+  auto column_stride = static_cast<std::ptrdiff_t>(n_reactions * n_levels);
+  std::vector<double> serial(n_columns * n_reactions * n_levels);
+  BatchDriver(*model_).Calculate(batch, RateBatchView{ serial.data(), column_stride, static_cast<std::ptrdiff_t>(n_levels), 1 });
+
+  for (std::size_t n_threads : { 1u, 2u, 4u, 8u })
+  {
+    ThreadPool pool(n_threads);
+    BatchDriver driver(*model_, pool);
+    std::vector<double> threaded(serial.size(), -1.0);
+    driver.Calculate(batch, RateBatchView{ threaded.data(), column_stride, static_cast<std::ptrdiff_t>(n_levels), 1 });
+    EXPECT_EQ(std::memcmp(threaded.data(), serial.data(), serial.size() * sizeof(double)), 0)
+        << "threads = " << n_threads;
+  }
+}
+
+TEST_F(BatchDriverTest, ThreadsSeeModelChangesMadeAfterConstruction)
+{
+  const std::size_t n_columns = 8;
+  const std::size_t n_layers = model_->AltitudeGrid().Spec().n_cells;
+  const std::size_t n_levels = n_layers + 1;
+  const std::size_t n_reactions = 2;
+
+  std::vector<double> sza(n_columns);
+  for (std::size_t c = 0; c < n_columns; ++c)
+  {
+    sza[c] = 10.0 + 8.0 * static_cast<double>(c);
+  }
+  ColumnBatchView batch;
+  batch.n_columns = n_columns;
+  batch.n_layers = n_layers;
+  batch.solar_zenith_angle = StridedView<const double>(sza.data(), n_columns);
+  RateBatchView rates;
+  rates.column_stride = static_cast<std::ptrdiff_t>(n_reactions * n_levels);
+  rates.reaction_stride = static_cast<std::ptrdiff_t>(n_levels);
+
+  ThreadPool pool(4);
+  BatchDriver driver(*model_, pool);
+  std::vector<double> before(n_columns * n_reactions * n_levels);
+  rates.data = before.data();
+  driver.Calculate(batch, rates);
+
+  // Every thread must use the new albedo and ozone, not just the calling one
+  model_->SetSurfaceAlbedo(0.6);
+  auto p = MakeProfiles(*model_, 0.5, 0.0);
+  model_->SetOzoneProfile(p.ozone);
+  std::vector<double> serial(before.size());
+  rates.data = serial.data();
+  BatchDriver(*model_).Calculate(batch, rates);
+  std::vector<double> threaded(before.size(), -1.0);
+  rates.data = threaded.data();
+  driver.Calculate(batch, rates);
+  EXPECT_NE(std::memcmp(serial.data(), before.data(), serial.size() * sizeof(double)), 0);
+  EXPECT_EQ(std::memcmp(threaded.data(), serial.data(), serial.size() * sizeof(double)), 0);
+}
+
+TEST_F(BatchDriverTest, NumaBuffersWithStaticScheduleMatchSerial)
+{
+  const std::size_t n_columns = 9;
+  const std::size_t n_layers = model_->AltitudeGrid().Spec().n_cells;
+  const std::size_t n_levels = n_layers + 1;
+  const std::size_t n_reactions = 2;
+
+  ThreadPool pool(3);
+  NumaBatchBuffers buffers(pool, n_columns, n_layers, n_reactions);
+
+  // Each worker fills the columns it owns
+  pool.ForEachWorker(
+      [&](std::size_t worker)
+      {
+        auto [first, last] = buffers.Columns(worker);
+        for (std::size_t c = first; c < last; ++c)
+        {
+          auto p = MakeProfiles(*model_, 0.6 + 0.1 * static_cast<double>(c), static_cast<double>(c));
+          buffers.SolarZenithAngle()[c] = 8.0 * static_cast<double>(c);
+          buffers.SurfaceAlbedo()[c] = 0.05 + 0.02 * static_cast<double>(c);
+          std::copy(p.temperature.begin(), p.temperature.end(), buffers.Temperature().begin() + c * n_layers);
+          std::copy(p.air_density.begin(), p.air_density.end(), buffers.AirDensity().begin() + c * n_layers);
+          std::copy(p.ozone.begin(), p.ozone.end(), buffers.Ozone().begin() + c * n_layers);
+        }
+      });
+
+  std::vector<double> serial(n_columns * n_reactions * n_levels);
+  BatchDriver(*model_).Calculate(
+      buffers.Inputs(),
+      RateBatchView{ serial.data(), static_cast<std::ptrdiff_t>(n_reactions * n_levels), static_cast<std::ptrdiff_t>(n_levels), 1 });
+
+  BatchDriver driver(*model_, pool, BatchSchedule::Static);
+  EXPECT_EQ(driver.Schedule(), BatchSchedule::Static);
+  driver.Calculate(buffers.Inputs(), buffers.Outputs());
+  ASSERT_EQ(buffers.Rates().size(), serial.size());
+  EXPECT_EQ(std::memcmp(buffers.Rates().data(), serial.data(), serial.size() * sizeof(double)), 0);
+}
+
+TEST_F(BatchDriverTest, MissingProfilesUseModelDefaults)
+{
+  const std::size_t n_layers = model_->AltitudeGrid().Spec().n_cells;
+  const std::size_t n_levels = n_layers + 1;
+
+  double sza = 20.0;
+  ColumnBatchView batch;
+  batch.n_columns = 1;
+  batch.n_layers = n_layers;
+  batch.solar_zenith_angle = StridedView<const double>(&sza, 1);
+
+  std::vector<double> j(2 * n_levels);
+  BatchDriver(*model_).Calculate(batch, RateBatchView{ j.data(), 0, static_cast<std::ptrdiff_t>(n_levels), 1 });
+
+  auto output = model_->Calculate(sza);
+  for (std::size_t l = 0; l < n_levels; ++l)
+  {
+    EXPECT_DOUBLE_EQ(j[l], output.photolysis_rates[0].rates[l]);
+  }
+}
+
+TEST_F(BatchDriverTest, SurfaceAlbedoSpectrumMatchesCalculate)
+{
+  const std::size_t n_levels = model_->AltitudeGrid().Spec().n_cells + 1;
+  std::vector<double> spectrum(model_->WavelengthGrid().Spec().n_cells);
+  for (std::size_t w = 0; w < spectrum.size(); ++w)
+  {
+    spectrum[w] = 0.05 + 0.02 * static_cast<double>(w % 10);
+  }
+  model_->SetSurfaceAlbedoSpectrum(spectrum);
+
+  // The configured spectrum takes precedence over the column's uniform albedo
+  ColumnView column;
+  column.solar_zenith_angle = 35.0;
+  column.surface_albedo = 0.9;
+  std::vector<double> j(2 * n_levels);
+  model_->CalculatePhotolysisRates(column, j.data(), static_cast<std::ptrdiff_t>(n_levels), 1);
+
+  auto output = model_->Calculate(column.solar_zenith_angle);
+  for (std::size_t l = 0; l < n_levels; ++l)
+  {
+    EXPECT_DOUBLE_EQ(j[l], output.photolysis_rates[0].rates[l]);
+  }
+}
+
+TEST_F(BatchDriverTest, DeduplicatedColumnsMatchFullSolve)
+{
+  // Columns 0, 2, 5 and 1, 4 are identical; 3 differs from 0 only in SZA
+  const std::size_t n_columns = 6;
+  const std::size_t n_layers = model_->AltitudeGrid().Spec().n_cells;
+  const std::size_t n_levels = n_layers + 1;
+  const std::size_t n_reactions = 2;
+  const std::vector<int> profile = { 0, 1, 0, 0, 1, 0 };
+
+  std::vector<double> sza = { 30.0, 50.0, 30.0, 31.0, 50.0, 30.0 };
+  std::vector<double> temperature, air_density, ozone;
+  for (std::size_t c = 0; c < n_columns; ++c)
+  {
+    auto p = MakeProfiles(*model_, profile[c] == 0 ? 1.0 : 0.8, 0.0);
+    temperature.insert(temperature.end(), p.temperature.begin(), p.temperature.end());
+    air_density.insert(air_density.end(), p.air_density.begin(), p.air_density.end());
+    ozone.insert(ozone.end(), p.ozone.begin(), p.ozone.end());
+  }
+
+  ColumnBatchView batch;
+  batch.n_columns = n_columns;
+  batch.n_layers = n_layers;
+  batch.solar_zenith_angle = StridedView<const double>(sza.data(), n_columns);
+  batch.temperature = { temperature.data(), static_cast<std::ptrdiff_t>(n_layers), 1 };
+  batch.air_density = { air_density.data(), static_cast<std::ptrdiff_t>(n_layers), 1 };
+  batch.ozone = { ozone.data(), static_cast<std::ptrdiff_t>(n_layers), 1 };
+
+  auto run = [&](BatchDriver& driver)
+  {
+    std::vector<double> j(n_columns * n_reactions * n_levels, -1.0);
+    driver.Calculate(
+        batch,
+        { j.data(), static_cast<std::ptrdiff_t>(n_reactions * n_levels), static_cast<std::ptrdiff_t>(n_levels), 1 });
+    return j;
+  };
+
+  BatchDriver reference_driver(*model_);
+  auto reference = run(reference_driver);
+  EXPECT_EQ(reference_driver.Stats().n_solved, n_columns);
+  EXPECT_DOUBLE_EQ(reference_driver.Stats().DedupeRatio(), 1.0);
+
+  BatchDriver driver(*model_);
+  driver.SetDeduplicate(true);
+  EXPECT_TRUE(driver.Deduplicate());
+  EXPECT_EQ(run(driver), reference);
+  EXPECT_EQ(driver.Stats().n_columns, n_columns);
+  EXPECT_EQ(driver.Stats().n_solved, 3u);
+  EXPECT_DOUBLE_EQ(driver.Stats().DedupeRatio(), 2.0);
+  EXPECT_GE(driver.Stats().total_seconds, driver.Stats().hash_seconds);
+
+  // Same unique set with a thread pool and either schedule
+  ThreadPool pool(3);
+  BatchDriver threaded(*model_, pool, BatchSchedule::Static);
+  threaded.SetDeduplicate(true);
+  EXPECT_EQ(run(threaded), reference);
+  threaded.SetSchedule(BatchSchedule::Dynamic);
+  EXPECT_EQ(run(threaded), reference);
+  EXPECT_EQ(threaded.Stats().n_solved, 3u);
+}
+
+TEST_F(BatchDriverTest, RejectsLayerMismatch)
+{
+  double sza = 20.0;
+  ColumnBatchView batch;
+  batch.n_columns = 1;
+  batch.n_layers = model_->AltitudeGrid().Spec().n_cells + 1;
+  batch.solar_zenith_angle = StridedView<const double>(&sza, 1);
+
+  std::vector<double> j(100);
+  BatchDriver driver(*model_);
+  EXPECT_THROW(driver.Calculate(batch, RateBatchView{ j.data(), 0, 0, 1 }), TuvxInternalException);
+}
+
+TEST_F(BatchDriverTest, EmptyBatchIsNoOp)
+{
+  ColumnBatchView batch;
+  BatchDriver driver(*model_);
+  EXPECT_NO_THROW(driver.Calculate(batch, RateBatchView{}));
+}
+
+TEST(StridedViewTest, IndexesWithStride)
+{
+  std::vector<double> data = { 0.0, 1.0, 2.0, 3.0, 4.0, 5.0 };
+  StridedView<const double> view(data.data() + 1, 3, 2);
+  EXPECT_EQ(view.Size(), 3u);
+  EXPECT_FALSE(view.IsContiguous());
+  EXPECT_DOUBLE_EQ(view[0], 1.0);
+  EXPECT_DOUBLE_EQ(view[1], 3.0);
+  EXPECT_DOUBLE_EQ(view[2], 5.0);
+
+  StridedView<const double> reversed(data.data() + 5, 6, -1);
+  EXPECT_DOUBLE_EQ(reversed[0], 5.0);
+  EXPECT_DOUBLE_EQ(reversed[5], 0.0);
+
+  StridedView<const double> empty;
+  EXPECT_TRUE(empty.Empty());
+}
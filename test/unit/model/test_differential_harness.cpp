@@ -0,0 +1,162 @@
+#include <tuvx/cross_section/types/o3.hpp>
+#include <tuvx/model/differential_harness.hpp>
+#include <tuvx/quantum_yield/types/o3_o1d.hpp>
+#include <tuvx/util/thread_pool.hpp>
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace tuvx;
+
+class DifferentialHarnessTest : public ::testing::Test
+{
+ protected:
+  ModelConfig SmallConfig() const
+  {
+    ModelConfig config;
+    config.n_wavelength_bins = 20;
+    config.n_altitude_layers = 10;
+    return config;
+  }
+
+  DifferentialHarness MakeHarness()
+  {
+    return DifferentialHarness(
+        SmallConfig(),
+        [this](TuvModel& model)
+        {
+          model.AddPhotolysisReaction("O3 -> O2 + O(1D)", &o3_xs_, &o3_qy_);
+          model.AddPhotolysisReaction("O3 -> O2 + O(3P)", &o3_xs_, &o3p_qy_);
+        });
+  }
+
+  O3CrossSection o3_xs_;
+  O3O1DQuantumYield o3_qy_;
+  O3O3PQuantumYield o3p_qy_;
+};
+
+TEST_F(DifferentialHarnessTest, GeneratorProducesValidReproducibleColumns)
+{
+  std::vector<double> midpoints;
+  for (int i = 0; i < 40; ++i)
+  {
+    midpoints.push_back(0.5 + 2.0 * i);
+  }
+  DifferentialColumnGenerator a(midpoints, 7);
+  DifferentialColumnGenerator b(midpoints, 7);
+
+  std::size_t with_aerosol = 0;
+  for (int c = 0; c < 200; ++c)
+  {
+    auto column = a.Next();
+    auto same = b.Next();
+    EXPECT_EQ(column.state.temperature, same.state.temperature);
+    EXPECT_EQ(column.state.solar_zenith_angle, same.state.solar_zenith_angle);
+
+    EXPECT_GE(column.state.solar_zenith_angle, 0.0);
+    EXPECT_LT(column.state.solar_zenith_angle, 90.0);
+    EXPECT_GT(column.state.surface_albedo, 0.0);
+    EXPECT_LT(column.state.surface_albedo, 1.0);
+    ASSERT_EQ(column.state.temperature.size(), midpoints.size());
+    ASSERT_EQ(column.state.air_density.size(), midpoints.size());
+    ASSERT_EQ(column.state.ozone.size(), midpoints.size());
+    for (std::size_t i = 0; i < midpoints.size(); ++i)
+    {
+      EXPECT_GE(column.state.temperature[i], 160.0);
+      EXPECT_LE(column.state.temperature[i], 330.0);
+      EXPECT_GT(column.state.air_density[i], 0.0);
+      EXPECT_GE(column.state.ozone[i], 0.0);
+      if (i > 0)
+      {
+        EXPECT_LT(column.state.air_density[i], column.state.air_density[i - 1]);
+      }
+    }
+    if (column.aerosol)
+    {
+      ++with_aerosol;
+      EXPECT_GT(column.aerosol->optical_depth_ref, 0.0);
+      EXPECT_LE(column.aerosol->single_scattering_albedo, 1.0);
+    }
+  }
+  EXPECT_GT(with_aerosol, 100u);
+  EXPECT_LT(with_aerosol, 200u);
+}
+
+TEST_F(DifferentialHarnessTest, ReferencePathAgainstItselfHasZeroError)
+{
+  auto harness = MakeHarness();
+  harness.AddPath(
+      "reference",
+      [](TuvModel& model, const DifferentialColumn& column)
+      { return model.Calculate(column.state.solar_zenith_angle).photolysis_rates; });
+
+  auto reports = harness.Run(5, 1);
+  ASSERT_EQ(reports.size(), 1u);
+  ASSERT_EQ(reports[0].reactions.size(), 2u);
+  for (const auto& reaction : reports[0].reactions)
+  {
+    EXPECT_EQ(reaction.max_relative_error, 0.0);
+    EXPECT_EQ(reaction.rms_relative_error, 0.0);
+    EXPECT_EQ(reaction.n_values, 5u * 11u);
+  }
+  EXPECT_TRUE(reports[0].Passed());
+}
+
+TEST_F(DifferentialHarnessTest, BuiltInFastPathsMeetTolerance)
+{
+  ThreadPool pool(4);
+  auto harness = MakeHarness();
+  harness.AddPath("bulk_column", differential_paths::BulkColumn);
+  harness.AddPath("threaded_rates", differential_paths::ThreadedRates(pool));
+
+  for (const auto& report : harness.Run(20, 42))
+  {
+    EXPECT_TRUE(report.Passed()) << report.Summary();
+  }
+}
+
+TEST_F(DifferentialHarnessTest, DetectsPerturbedReaction)
+{
+  auto harness = MakeHarness();
+  harness.AddPath(
+      "perturbed",
+      [](TuvModel& model, const DifferentialColumn& column)
+      {
+        auto rates = model.Calculate(column.state.solar_zenith_angle).photolysis_rates;
+        for (auto& j : rates[1].rates)
+        {
+          j *= 1.0 + 1e-4;
+        }
+        return rates;
+      });
+
+  auto reports = harness.Run(5, 3);
+  ASSERT_EQ(reports[0].reactions.size(), 2u);
+  EXPECT_TRUE(reports[0].reactions[0].Passes(reports[0].tolerance));
+  EXPECT_FALSE(reports[0].reactions[1].Passes(reports[0].tolerance));
+  EXPECT_NEAR(reports[0].reactions[1].max_relative_error, 1e-4, 1e-9);
+  EXPECT_FALSE(reports[0].Passed());
+  EXPECT_NE(reports[0].Summary().find("FAIL"), std::string::npos);
+
+  // A looser tolerance accepts the same path
+  DifferentialTolerance loose{ 1e-3, 1e-3, 1e-30 };
+  EXPECT_TRUE(reports[0].reactions[1].Passes(loose));
+}
+
+TEST_F(DifferentialHarnessTest, MissingReactionIsAFailure)
+{
+  auto harness = MakeHarness();
+  harness.AddPath(
+      "drops_reaction",
+      [](TuvModel& model, const DifferentialColumn& column)
+      {
+        auto rates = model.Calculate(column.state.solar_zenith_angle).photolysis_rates;
+        rates.pop_back();
+        return rates;
+      });
+
+  auto reports = harness.Run(2, 5);
+  EXPECT_FALSE(reports[0].Passed());
+  EXPECT_TRUE(std::isinf(reports[0].reactions[1].max_relative_error));
+}
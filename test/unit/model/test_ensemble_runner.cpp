@@ -0,0 +1,136 @@
+#include <tuvx/cross_section/types/o3.hpp>
+#include <tuvx/model/ensemble_runner.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/quantum_yield/types/o3_o1d.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace tuvx;
+
+class EnsembleRunnerTest : public ::testing::Test
+{
+ protected:
+  static ModelConfig Config()
+  {
+    ModelConfig config;
+    config.n_wavelength_bins = 20;
+    config.wavelength_min = 280.0;
+    config.wavelength_max = 400.0;
+    config.n_altitude_layers = 10;
+    return config;
+  }
+
+  std::unique_ptr<TuvModel> MakeModel(double aerosol_optical_depth)
+  {
+    auto model = std::make_unique<TuvModel>(Config());
+    model->AddStandardRadiators();
+    AerosolRadiator::Config aerosol;
+    aerosol.optical_depth_ref = aerosol_optical_depth;
+    model->AddAerosolRadiator(aerosol);
+    model->AddPhotolysisReaction("O3 -> O2 + O(1D)", &o3_xs_, &o3_qy_);
+    model->AddPhotolysisReaction("O3 -> O2 + O(3P)", &o3_xs_, &o3p_qy_);
+    return model;
+  }
+
+  void SetUp() override
+  {
+    model_ = MakeModel(0.2);
+    auto mid = model_->AltitudeGrid().Midpoints();
+    std::vector<double> midpoints(mid.begin(), mid.end());
+    base_.solar_zenith_angle = 35.0;
+    base_.surface_albedo = 0.15;
+    base_.temperature = StandardAtmosphere::GenerateTemperatureProfile(midpoints);
+    base_.air_density = StandardAtmosphere::GenerateAirDensityProfile(midpoints);
+    base_.ozone = StandardAtmosphere::GenerateOzoneProfile(midpoints, 300.0);
+    n_levels_ = midpoints.size() + 1;
+  }
+
+  /// Rates for one column computed independently
+  std::vector<double> Independent(TuvModel& model, const ColumnState& column) const
+  {
+    std::vector<double> rates(2 * n_levels_);
+    model.CalculatePhotolysisRates(column.View(), rates.data(), static_cast<std::ptrdiff_t>(n_levels_), 1);
+    return rates;
+  }
+
+  RateBatchView Rates(std::vector<double>& data) const
+  {
+    auto levels = static_cast<std::ptrdiff_t>(n_levels_);
+    return { data.data(), 2 * levels, levels, 1 };
+  }
+
+  O3CrossSection o3_xs_;
+  O3O1DQuantumYield o3_qy_;
+  O3O3PQuantumYield o3p_qy_;
+  std::unique_ptr<TuvModel> model_;
+  ColumnState base_;
+  std::size_t n_levels_{ 0 };
+};
+
+TEST_F(EnsembleRunnerTest, MembersMatchIndependentRuns)
+{
+  std::vector<EnsembleMember> members(4);
+  members[1].scalings = { { "O3", 1.2 } };
+  members[2].scalings = { { "aerosol", 0.5 } };
+  members[3].scalings = { { "O3", 0.8 }, { "aerosol", 1.5 } };
+
+  std::vector<double> j(members.size() * 2 * n_levels_);
+  EnsembleRunner runner(*model_);
+  runner.Calculate(base_.View(), members, Rates(j));
+
+  // Unperturbed member is bit-identical to the model
+  std::vector<double> expected = Independent(*model_, base_);
+  EXPECT_TRUE(std::equal(expected.begin(), expected.end(), j.begin()));
+
+  auto check = [&](std::size_t member, double ozone_scale, double aerosol_optical_depth)
+  {
+    auto model = MakeModel(aerosol_optical_depth);
+    ColumnState column = base_;
+    for (auto& o3 : column.ozone)
+    {
+      o3 *= ozone_scale;
+    }
+    auto reference = Independent(*model, column);
+    for (std::size_t i = 0; i < reference.size(); ++i)
+    {
+      EXPECT_NEAR(j[member * reference.size() + i], reference[i], 1.0e-10 * std::abs(reference[i]))
+          << "member " << member << " index " << i;
+    }
+    // The perturbation has a visible effect
+    EXPECT_NE(j[member * reference.size()], expected[0]);
+  };
+  check(1, 1.2, 0.2);
+  check(2, 1.0, 0.1);
+  check(3, 0.8, 0.3);
+}
+
+TEST_F(EnsembleRunnerTest, ExposesMemberFields)
+{
+  std::vector<EnsembleMember> members(2);
+  members[1].scalings = { { "O3", 2.0 } };
+  std::vector<double> j(members.size() * 2 * n_levels_);
+  EnsembleRunner runner(*model_);
+  runner.Calculate(base_.View(), members, Rates(j));
+
+  // More ozone means less UV reaching the surface
+  EXPECT_LT(runner.Field(1).actinic_flux_direct[0][0], runner.Field(0).actinic_flux_direct[0][0]);
+  EXPECT_THROW(runner.Field(2), std::out_of_range);
+}
+
+TEST_F(EnsembleRunnerTest, RejectsUnknownRadiator)
+{
+  std::vector<EnsembleMember> members(1);
+  members[0].scalings = { { "SO2", 2.0 } };
+  std::vector<double> j(2 * n_levels_);
+  EXPECT_THROW(EnsembleRunner(*model_).Calculate(base_.View(), members, Rates(j)), std::invalid_argument);
+
+  // An empty ensemble is a no-op
+  EnsembleRunner(*model_).Calculate(base_.View(), {}, Rates(j));
+}
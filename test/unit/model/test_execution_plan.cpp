@@ -0,0 +1,258 @@
+#include <tuvx/cross_section/types/o3.hpp>
+#include <tuvx/model/execution_plan.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/quantum_yield/types/o3_o1d.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace tuvx;
+
+namespace
+{
+  ModelConfig SmallConfig()
+  {
+    ModelConfig config;
+    config.n_wavelength_bins = 30;
+    config.wavelength_min = 280.0;
+    config.wavelength_max = 400.0;
+    config.n_altitude_layers = 20;
+    config.altitude_max = 60.0;
+    return config;
+  }
+
+  /// Columns with varied angles, albedos and profiles; odd columns leave the ozone profile empty
+  std::vector<ColumnState> MakeColumns(const TuvModel& model, std::size_t n_columns)
+  {
+    auto mid = model.AltitudeGrid().Midpoints();
+    std::vector<double> midpoints(mid.begin(), mid.end());
+    std::vector<ColumnState> columns(n_columns);
+    for (std::size_t c = 0; c < n_columns; ++c)
+    {
+      double x = static_cast<double>(c);
+      columns[c].solar_zenith_angle = 10.0 + 12.0 * x;
+      columns[c].surface_albedo = 0.05 + 0.05 * x;
+      columns[c].temperature = StandardAtmosphere::GenerateTemperatureProfile(midpoints);
+      for (auto& t : columns[c].temperature)
+      {
+        t += 3.0 * x - 6.0;
+      }
+      columns[c].air_density = StandardAtmosphere::GenerateAirDensityProfile(midpoints);
+      if (c % 2 == 0)
+      {
+        columns[c].ozone = StandardAtmosphere::GenerateOzoneProfile(midpoints, 260.0 + 20.0 * x);
+      }
+    }
+    return columns;
+  }
+
+  /// Planned J-values may differ from the model's by the interpolation of σ·φ in temperature
+  void ExpectNearRates(const std::vector<double>& planned, const std::vector<double>& expected)
+  {
+    ASSERT_EQ(planned.size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+      EXPECT_NEAR(planned[i], expected[i], 1e-4 * expected[i]) << "rate " << i;
+    }
+  }
+}  // namespace
+
+class ExecutionPlanTest : public ::testing::Test
+{
+ protected:
+  void SetUp() override
+  {
+    model_ = std::make_unique<TuvModel>(SmallConfig());
+    model_->AddStandardRadiators();
+    model_->AddPhotolysisReaction("O3 -> O2 + O(1D)", &o3_xs_, &o3_qy_);
+    model_->AddPhotolysisReaction("O3 -> O2 + O(3P)", &o3_xs_, &o3p_qy_);
+  }
+
+  /// Run every column through the plan and through the model's column stages
+  ///
+  /// The radiation field must be identical, the J-values close.
+  void ExpectMatchesModel(ExecutionPlan& plan, const std::vector<ColumnState>& columns)
+  {
+    std::size_t n_levels = model_->AltitudeGrid().Spec().n_cells + 1;
+    std::size_t n_rates = model_->PhotolysisReactions().Size() * n_levels;
+    ColumnWorkspace workspace;
+    for (const auto& column : columns)
+    {
+      std::vector<double> expected(n_rates, -1.0);
+      std::vector<double> planned(n_rates, -2.0);
+      model_->CalculatePhotolysisRates(column.View(), expected.data(), static_cast<std::ptrdiff_t>(n_levels), 1);
+      plan.Execute(column.View(), planned.data(), static_cast<std::ptrdiff_t>(n_levels), 1);
+      ExpectNearRates(planned, expected);
+
+      model_->GatherColumn(column.View(), workspace);
+      model_->ComputeOpticalProperties(workspace);
+      model_->SolveColumn(workspace);
+      const RadiationField& field = plan.Workspace().radiation_field;
+      EXPECT_EQ(field.actinic_flux_direct, workspace.radiation_field.actinic_flux_direct);
+      EXPECT_EQ(field.actinic_flux_diffuse, workspace.radiation_field.actinic_flux_diffuse);
+    }
+  }
+
+  O3CrossSection o3_xs_;
+  O3O1DQuantumYield o3_qy_;
+  O3O3PQuantumYield o3p_qy_;
+  std::unique_ptr<TuvModel> model_;
+};
+
+TEST_F(ExecutionPlanTest, MatchesCalculatePhotolysisRates)
+{
+  ExecutionPlan plan = model_->Prepare();
+  EXPECT_TRUE(plan.IsValid());
+  ExpectMatchesModel(plan, MakeColumns(*model_, 6));
+}
+
+TEST_F(ExecutionPlanTest, MatchesWithSphericalGeometryAndConfiguredProfiles)
+{
+  ModelConfig config = SmallConfig();
+  config.use_spherical_geometry = true;
+  model_->SetConfig(config);
+  model_->UseStandardAtmosphere();
+
+  ExecutionPlan plan = model_->Prepare();
+  auto columns = MakeColumns(*model_, 4);
+  columns[1].solar_zenith_angle = 88.0;
+  columns[3].temperature.clear();
+  ExpectMatchesModel(plan, columns);
+}
+
+TEST_F(ExecutionPlanTest, BatchMatchesBatchDriver)
+{
+  auto columns = MakeColumns(*model_, 5);
+  std::size_t n_layers = model_->AltitudeGrid().Spec().n_cells;
+  std::size_t n_levels = n_layers + 1;
+  std::vector<double> sza;
+  std::vector<double> temperature;
+  std::vector<double> air_density;
+  for (const auto& column : columns)
+  {
+    sza.push_back(column.solar_zenith_angle);
+    temperature.insert(temperature.end(), column.temperature.begin(), column.temperature.end());
+    air_density.insert(air_density.end(), column.air_density.begin(), column.air_density.end());
+  }
+
+  ColumnBatchView batch;
+  batch.n_columns = columns.size();
+  batch.n_layers = n_layers;
+  batch.solar_zenith_angle = StridedView<const double>(sza.data(), sza.size());
+  batch.temperature = { temperature.data(), static_cast<std::ptrdiff_t>(n_layers), 1 };
+  batch.air_density = { air_density.data(), static_cast<std::ptrdiff_t>(n_layers), 1 };
+
+  std::size_t per_column = 2 * n_levels;
+  std::vector<double> expected(columns.size() * per_column);
+  std::vector<double> planned(columns.size() * per_column);
+  BatchDriver(*model_).Calculate(
+      batch, { expected.data(), static_cast<std::ptrdiff_t>(per_column), static_cast<std::ptrdiff_t>(n_levels), 1 });
+  ExecutionPlan plan = model_->Prepare();
+  plan.Execute(batch, { planned.data(), static_cast<std::ptrdiff_t>(per_column), static_cast<std::ptrdiff_t>(n_levels), 1 });
+  ExpectNearRates(planned, expected);
+
+  batch.n_layers += 1;
+  EXPECT_THROW(plan.Execute(batch, { planned.data(), 0, 0, 1 }), TuvxInternalException);
+}
+
+TEST_F(ExecutionPlanTest, ConfigurationChangeInvalidatesPlan)
+{
+  auto columns = MakeColumns(*model_, 1);
+  std::vector<double> rates(2 * (model_->AltitudeGrid().Spec().n_cells + 1));
+
+  ExecutionPlan plan = model_->Prepare();
+  model_->SetSurfaceAlbedo(0.3);
+  EXPECT_FALSE(plan.IsValid());
+  EXPECT_THROW(plan.Execute(columns[0].View(), rates.data(), 21, 1), TuvxInternalException);
+
+  ExecutionPlan replanned = model_->Prepare();
+  EXPECT_TRUE(replanned.IsValid());
+  model_->AddPhotolysisReaction("O3 -> O2 + O(1D) again", &o3_xs_, &o3_qy_);
+  EXPECT_FALSE(replanned.IsValid());
+
+  ExecutionPlan after_date = model_->Prepare();
+  model_->Calculate(2024, 6, 21, 12.0, 40.0, -105.0);
+  EXPECT_FALSE(after_date.IsValid());
+
+  // Calculating for an angle does not change the configuration
+  ExecutionPlan stable = model_->Prepare();
+  model_->Calculate(45.0);
+  EXPECT_TRUE(stable.IsValid());
+}
+
+TEST_F(ExecutionPlanTest, PreparesLazyModel)
+{
+  ModelConfig config = SmallConfig();
+  config.lazy_initialization = true;
+  TuvModel lazy(config);
+  lazy.AddStandardRadiators();
+  lazy.AddPhotolysisReaction("O3 -> O2 + O(1D)", &o3_xs_, &o3_qy_);
+  lazy.AddPhotolysisReaction("O3 -> O2 + O(3P)", &o3_xs_, &o3p_qy_);
+  ASSERT_FALSE(lazy.IsPrepared());
+
+  ExecutionPlan plan = lazy.Prepare();
+  EXPECT_TRUE(lazy.IsPrepared());
+  EXPECT_TRUE(plan.IsValid());
+  ExpectMatchesModel(plan, MakeColumns(*model_, 2));
+}
+
+TEST_F(ExecutionPlanTest, ModelWithoutRadiators)
+{
+  TuvModel bare(SmallConfig());
+  bare.AddPhotolysisReaction("O3 -> O2 + O(1D)", &o3_xs_, &o3_qy_);
+  ColumnState column;
+  column.solar_zenith_angle = 20.0;
+  std::size_t n_levels = bare.AltitudeGrid().Spec().n_cells + 1;
+  std::vector<double> expected(n_levels);
+  std::vector<double> planned(n_levels);
+  bare.CalculatePhotolysisRates(column.View(), expected.data(), 0, 1);
+  ExecutionPlan plan = bare.Prepare();
+  plan.Execute(column.View(), planned.data(), 0, 1);
+  ExpectNearRates(planned, expected);
+  EXPECT_GT(planned[n_levels - 1], 0.0);
+}
+
+TEST_F(ExecutionPlanTest, ReactionWithoutQuantumYieldIsZero)
+{
+  model_ = std::make_unique<TuvModel>(SmallConfig());
+  model_->AddStandardRadiators();
+  model_->AddPhotolysisReaction("O3 -> O2 + O(1D)", &o3_xs_, &o3_qy_);
+  model_->AddPhotolysisReaction("O3 -> products", &o3_xs_, nullptr);
+  model_->AddPhotolysisReaction("O3 -> O2 + O(3P)", &o3_xs_, &o3p_qy_);
+
+  // The output starts out non-zero, so stale rows would show
+  ExecutionPlan plan = model_->Prepare();
+  ExpectMatchesModel(plan, MakeColumns(*model_, 3));
+}
+
+TEST_F(ExecutionPlanTest, TabulatesConfiguredTemperatures)
+{
+  ExecutionPlanConfig config;
+  config.min_temperature = 180.0;
+  config.max_temperature = 300.0;
+  config.temperature_step = 40.0;
+  ExecutionPlan coarse = model_->Prepare(config);
+  EXPECT_EQ(coarse.Temperatures(), std::vector<double>({ 180.0, 220.0, 260.0, 300.0 }));
+
+  // Coarser tables stay close to the exact spectra
+  auto columns = MakeColumns(*model_, 2);
+  std::size_t n_levels = model_->AltitudeGrid().Spec().n_cells + 1;
+  std::vector<double> expected(2 * n_levels);
+  std::vector<double> planned(2 * n_levels);
+  model_->CalculatePhotolysisRates(columns[1].View(), expected.data(), static_cast<std::ptrdiff_t>(n_levels), 1);
+  coarse.Execute(columns[1].View(), planned.data(), static_cast<std::ptrdiff_t>(n_levels), 1);
+  for (std::size_t i = 0; i < expected.size(); ++i)
+  {
+    EXPECT_NEAR(planned[i], expected[i], 0.05 * expected[i]) << "rate " << i;
+  }
+
+  config.temperature_step = 0.0;
+  EXPECT_THROW(model_->Prepare(config), std::invalid_argument);
+  config.temperature_step = 1.0;
+  config.max_temperature = 100.0;
+  EXPECT_THROW(model_->Prepare(config), std::invalid_argument);
+}
@@ -0,0 +1,262 @@
+#include <tuvx/cross_section/types/o3.hpp>
+#include <tuvx/model/photolysis_scheduler.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/quantum_yield/types/o3_o1d.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace tuvx;
+
+class PhotolysisSchedulerTest : public ::testing::Test
+{
+ protected:
+  void SetUp() override
+  {
+    ModelConfig config;
+    config.n_wavelength_bins = 20;
+    config.wavelength_min = 280.0;
+    config.wavelength_max = 400.0;
+    config.n_altitude_layers = 10;
+    model_ = std::make_unique<TuvModel>(config);
+    model_->AddStandardRadiators();
+    model_->AddPhotolysisReaction("O3 -> O2 + O(1D)", &o3_xs_, &o3_qy_);
+    model_->AddPhotolysisReaction("O3 -> O2 + O(3P)", &o3_xs_, &o3p_qy_);
+
+    auto mid = model_->AltitudeGrid().Midpoints();
+    std::vector<double> midpoints(mid.begin(), mid.end());
+    column_.temperature = StandardAtmosphere::GenerateTemperatureProfile(midpoints);
+    column_.air_density = StandardAtmosphere::GenerateAirDensityProfile(midpoints);
+    column_.ozone = StandardAtmosphere::GenerateOzoneProfile(midpoints, 300.0);
+    n_levels_ = midpoints.size() + 1;
+  }
+
+  PhotolysisUpdate Step(PhotolysisScheduler& scheduler, double sza, std::vector<double>& rates, std::size_t id = 0)
+  {
+    column_.solar_zenith_angle = sza;
+    rates.assign(2 * n_levels_, -1.0);
+    return scheduler.Step(id, column_.View(), rates.data(), static_cast<std::ptrdiff_t>(n_levels_), 1);
+  }
+
+  std::vector<double> Direct(double sza)
+  {
+    column_.solar_zenith_angle = sza;
+    std::vector<double> rates(2 * n_levels_);
+    model_->CalculatePhotolysisRates(column_.View(), rates.data(), static_cast<std::ptrdiff_t>(n_levels_), 1);
+    return rates;
+  }
+
+  /// Largest difference relative to each reaction's peak J
+  double RelativeError(const std::vector<double>& estimate, const std::vector<double>& exact) const
+  {
+    double error = 0.0;
+    for (std::size_t r = 0; r < 2; ++r)
+    {
+      auto first = exact.begin() + static_cast<std::ptrdiff_t>(r * n_levels_);
+      double peak = *std::max_element(first, first + static_cast<std::ptrdiff_t>(n_levels_));
+      for (std::size_t l = 0; l < n_levels_; ++l)
+      {
+        error = std::max(error, std::abs(estimate[r * n_levels_ + l] - exact[r * n_levels_ + l]) / peak);
+      }
+    }
+    return error;
+  }
+
+  O3CrossSection o3_xs_;
+  O3O1DQuantumYield o3_qy_;
+  O3O3PQuantumYield o3p_qy_;
+  std::unique_ptr<TuvModel> model_;
+  ColumnState column_;
+  std::size_t n_levels_{ 0 };
+};
+
+TEST_F(PhotolysisSchedulerTest, FirstStepsAreSolved)
+{
+  PhotolysisScheduler scheduler(*model_);
+  std::vector<double> rates;
+  EXPECT_EQ(Step(scheduler, 30.0, rates), PhotolysisUpdate::FullSolve);
+  EXPECT_EQ(rates, Direct(30.0));
+
+  // Extrapolation needs a second anchor
+  EXPECT_EQ(Step(scheduler, 31.0, rates), PhotolysisUpdate::FullSolve);
+  EXPECT_EQ(Step(scheduler, 32.0, rates), PhotolysisUpdate::Extrapolated);
+  EXPECT_EQ(scheduler.Stats().steps, 3u);
+  EXPECT_EQ(scheduler.Stats().full_solves, 2u);
+  EXPECT_EQ(scheduler.Stats().AvoidedSolves(), 1u);
+}
+
+TEST_F(PhotolysisSchedulerTest, ExtrapolatesInCosineOfSza)
+{
+  PhotolysisSchedulerConfig config;
+  config.full_solve_interval = 4;
+  PhotolysisScheduler scheduler(*model_, config);
+  std::vector<double> rates;
+  std::vector<PhotolysisUpdate> updates;
+  for (int step = 0; step < 10; ++step)
+  {
+    double sza = 30.0 + 0.5 * step;
+    updates.push_back(Step(scheduler, sza, rates));
+    EXPECT_LT(RelativeError(rates, Direct(sza)), 1.0e-3) << "step " << step;
+  }
+  auto full = PhotolysisUpdate::FullSolve;
+  auto extrapolated = PhotolysisUpdate::Extrapolated;
+  EXPECT_EQ(
+      updates,
+      (std::vector<PhotolysisUpdate>{
+          full, full, extrapolated, extrapolated, extrapolated, full, extrapolated, extrapolated, extrapolated, full }));
+  EXPECT_EQ(scheduler.Stats().AvoidedSolves(), 6u);
+}
+
+TEST_F(PhotolysisSchedulerTest, ScalesAlongColumnCurve)
+{
+  PhotolysisSchedulerConfig config;
+  config.estimate = PhotolysisEstimate::ScaleCurve;
+  config.curve_points = 12;
+  config.full_solve_interval = 10;
+  PhotolysisScheduler scheduler(*model_, config);
+  std::vector<double> rates;
+  EXPECT_EQ(Step(scheduler, 50.0, rates), PhotolysisUpdate::FullSolve);
+  for (int step = 1; step < 9; ++step)
+  {
+    double sza = 50.0 + 0.5 * step;
+    EXPECT_EQ(Step(scheduler, sza, rates), PhotolysisUpdate::Scaled);
+    EXPECT_LT(RelativeError(rates, Direct(sza)), 1.0e-2) << "step " << step;
+  }
+  EXPECT_EQ(scheduler.Stats().curve_solves, 12u);
+  EXPECT_EQ(scheduler.Stats().scaled, 8u);
+  EXPECT_EQ(scheduler.Stats().AvoidedSolves(), 0u);
+
+  // Beyond the curve's range the step is solved
+  EXPECT_EQ(Step(scheduler, 89.0, rates), PhotolysisUpdate::FullSolve);
+}
+
+TEST_F(PhotolysisSchedulerTest, ExtrapolationIsBounded)
+{
+  PhotolysisSchedulerConfig config;
+  config.max_extrapolation = 2.0;
+  PhotolysisScheduler scheduler(*model_, config);
+  std::vector<double> rates;
+  Step(scheduler, 30.0, rates);
+  Step(scheduler, 30.5, rates);
+
+  // Two anchor spacings past the latest solve are estimated, four are not
+  EXPECT_EQ(Step(scheduler, 31.4, rates), PhotolysisUpdate::Extrapolated);
+  EXPECT_EQ(Step(scheduler, 32.5, rates), PhotolysisUpdate::FullSolve);
+  EXPECT_EQ(rates, Direct(32.5));
+
+  // Coincident anchors only answer their own angle
+  scheduler.Reset();
+  Step(scheduler, 32.5, rates);
+  Step(scheduler, 32.5, rates);
+  EXPECT_EQ(Step(scheduler, 32.5, rates), PhotolysisUpdate::Extrapolated);
+  EXPECT_EQ(rates, Direct(32.5));
+  EXPECT_EQ(Step(scheduler, 32.6, rates), PhotolysisUpdate::FullSolve);
+}
+
+TEST_F(PhotolysisSchedulerTest, DriftIsMeasuredFromLatestSolve)
+{
+  PhotolysisSchedulerConfig config;
+  config.full_solve_interval = 1;
+  PhotolysisScheduler scheduler(*model_, config);
+  std::vector<double> rates;
+  Step(scheduler, 30.0, rates);
+
+  // Each step stays within the threshold of the solve before it, so none is a drift restart
+  for (int step = 1; step < 6; ++step)
+  {
+    column_.temperature[2] += 1.5;
+    EXPECT_EQ(Step(scheduler, 30.0 + step, rates), PhotolysisUpdate::FullSolve);
+  }
+  EXPECT_EQ(scheduler.Stats().drift_solves, 0u);
+}
+
+TEST_F(PhotolysisSchedulerTest, DriftAndSzaJumpsForceSolves)
+{
+  PhotolysisScheduler scheduler(*model_);
+  std::vector<double> rates;
+  Step(scheduler, 30.0, rates);
+  Step(scheduler, 31.0, rates);
+
+  // Small temperature change is tolerated, a large one is not
+  column_.temperature[2] += 0.5;
+  EXPECT_EQ(Step(scheduler, 31.5, rates), PhotolysisUpdate::Extrapolated);
+  column_.temperature[2] += 5.0;
+  EXPECT_EQ(Step(scheduler, 32.0, rates), PhotolysisUpdate::FullSolve);
+  EXPECT_EQ(rates, Direct(32.0));
+  EXPECT_EQ(scheduler.Stats().drift_solves, 1u);
+
+  column_.ozone[4] *= 1.1;
+  EXPECT_EQ(Step(scheduler, 32.5, rates), PhotolysisUpdate::FullSolve);
+  EXPECT_EQ(Step(scheduler, 33.0, rates), PhotolysisUpdate::FullSolve);
+
+  // A large SZA jump and a terminator crossing are solved
+  EXPECT_EQ(Step(scheduler, 45.0, rates), PhotolysisUpdate::FullSolve);
+  Step(scheduler, 88.0, rates);
+  Step(scheduler, 89.0, rates);
+  EXPECT_EQ(Step(scheduler, 89.5, rates), PhotolysisUpdate::Extrapolated);
+  EXPECT_EQ(Step(scheduler, 90.5, rates), PhotolysisUpdate::FullSolve);
+}
+
+TEST_F(PhotolysisSchedulerTest, VerificationRecordsError)
+{
+  PhotolysisSchedulerConfig config;
+  config.verify_interval = 2;
+  config.max_relative_error = 0.0;
+  PhotolysisScheduler scheduler(*model_, config);
+  std::vector<double> rates;
+  std::vector<PhotolysisUpdate> updates;
+  for (int step = 0; step < 4; ++step)
+  {
+    updates.push_back(Step(scheduler, 20.0 + step, rates));
+  }
+  // The second estimated step is solved and checked
+  EXPECT_EQ(updates[2], PhotolysisUpdate::Extrapolated);
+  EXPECT_EQ(updates[3], PhotolysisUpdate::FullSolve);
+  EXPECT_EQ(rates, Direct(23.0));
+
+  const auto& stats = scheduler.Stats();
+  EXPECT_EQ(stats.verifications, 1u);
+  EXPECT_EQ(stats.verification_failures, 1u);
+  EXPECT_GT(stats.max_verified_error, 0.0);
+  EXPECT_LT(stats.max_verified_error, 1.0e-2);
+
+  scheduler.ResetStats();
+  EXPECT_EQ(scheduler.Stats().steps, 0u);
+}
+
+TEST_F(PhotolysisSchedulerTest, TracksColumnsAndModelChanges)
+{
+  PhotolysisScheduler scheduler(*model_);
+  std::vector<double> rates;
+  Step(scheduler, 30.0, rates, 0);
+  Step(scheduler, 31.0, rates, 0);
+  EXPECT_EQ(Step(scheduler, 60.0, rates, 3), PhotolysisUpdate::FullSolve);
+  EXPECT_EQ(Step(scheduler, 31.5, rates, 0), PhotolysisUpdate::Extrapolated);
+
+  model_->SetSurfaceAlbedo(0.3);
+  EXPECT_EQ(Step(scheduler, 32.0, rates, 0), PhotolysisUpdate::FullSolve);
+
+  scheduler.Reset();
+  EXPECT_EQ(Step(scheduler, 32.5, rates, 0), PhotolysisUpdate::FullSolve);
+}
+
+TEST_F(PhotolysisSchedulerTest, SparseColumnIds)
+{
+  // IDs need not be dense: neither one sizes a table by its value
+  const std::size_t far = 1'000'000'000;
+  const std::size_t last = std::numeric_limits<std::size_t>::max();
+  PhotolysisScheduler scheduler(*model_);
+  std::vector<double> rates;
+  Step(scheduler, 30.0, rates, far);
+  Step(scheduler, 31.0, rates, far);
+  EXPECT_EQ(Step(scheduler, 60.0, rates, last), PhotolysisUpdate::FullSolve);
+  EXPECT_EQ(rates, Direct(60.0));
+  EXPECT_EQ(Step(scheduler, 31.5, rates, far), PhotolysisUpdate::Extrapolated);
+  EXPECT_EQ(Step(scheduler, 60.5, rates, last), PhotolysisUpdate::FullSolve);
+}
@@ -0,0 +1,251 @@
+#include <tuvx/cross_section/types/o3.hpp>
+#include <tuvx/model/batch_driver.hpp>
+#include <tuvx/model/pipeline_executor.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/quantum_yield/types/o3_o1d.hpp>
+#include <tuvx/solver/delta_eddington.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace tuvx;
+
+namespace
+{
+  ModelConfig SmallConfig()
+  {
+    ModelConfig config;
+    config.n_wavelength_bins = 30;
+    config.wavelength_min = 280.0;
+    config.wavelength_max = 400.0;
+    config.n_altitude_layers = 20;
+    config.altitude_max = 60.0;
+    return config;
+  }
+
+  /// Column inputs and rate storage for a batch of varied columns
+  struct Batch
+  {
+    std::vector<double> sza;
+    std::vector<double> albedo;
+    std::vector<double> temperature;
+    std::vector<double> air_density;
+    std::vector<double> ozone;
+    std::size_t n_columns{ 0 };
+    std::size_t n_layers{ 0 };
+    std::size_t n_reactions{ 0 };
+
+    Batch(const TuvModel& model, std::size_t columns)
+        : n_columns(columns),
+          n_layers(model.AltitudeGrid().Spec().n_cells),
+          n_reactions(model.PhotolysisReactions().Size())
+    {
+      auto mid = model.AltitudeGrid().Midpoints();
+      std::vector<double> midpoints(mid.begin(), mid.end());
+      for (std::size_t c = 0; c < n_columns; ++c)
+      {
+        double x = static_cast<double>(c);
+        sza.push_back(5.0 + 9.0 * x);
+        albedo.push_back(0.05 + 0.02 * x);
+        auto t = StandardAtmosphere::GenerateTemperatureProfile(midpoints);
+        for (auto& value : t)
+        {
+          value += x - 4.0;
+        }
+        auto n = StandardAtmosphere::GenerateAirDensityProfile(midpoints);
+        auto o3 = StandardAtmosphere::GenerateOzoneProfile(midpoints, 250.0 + 10.0 * x);
+        temperature.insert(temperature.end(), t.begin(), t.end());
+        air_density.insert(air_density.end(), n.begin(), n.end());
+        ozone.insert(ozone.end(), o3.begin(), o3.end());
+      }
+    }
+
+    ColumnBatchView Inputs() const
+    {
+      ColumnBatchView batch;
+      batch.n_columns = n_columns;
+      batch.n_layers = n_layers;
+      batch.solar_zenith_angle = StridedView<const double>(sza.data(), n_columns);
+      batch.surface_albedo = StridedView<const double>(albedo.data(), n_columns);
+      auto layers = static_cast<std::ptrdiff_t>(n_layers);
+      batch.temperature = { temperature.data(), layers, 1 };
+      batch.air_density = { air_density.data(), layers, 1 };
+      batch.ozone = { ozone.data(), layers, 1 };
+      return batch;
+    }
+
+    std::size_t RateCount() const
+    {
+      return n_columns * n_reactions * (n_layers + 1);
+    }
+
+    RateBatchView Outputs(std::vector<double>& rates) const
+    {
+      auto levels = static_cast<std::ptrdiff_t>(n_layers + 1);
+      return { rates.data(), static_cast<std::ptrdiff_t>(n_reactions) * levels, levels, 1 };
+    }
+  };
+
+  /// Delta-Eddington solver that fails on a chosen call
+  class FailingSolver : public DeltaEddingtonSolver
+  {
+   public:
+    explicit FailingSolver(int fail_on)
+        : fail_on_(fail_on)
+    {
+    }
+
+    void SolveInto(const SolverInput& input, RadiationField& field) const override
+    {
+      if (calls_++ == fail_on_)
+      {
+        throw std::runtime_error("solver failure");
+      }
+      DeltaEddingtonSolver::SolveInto(input, field);
+    }
+
+   private:
+    int fail_on_;
+    mutable std::atomic<int> calls_{ 0 };
+  };
+
+  /// Delta-Eddington solver that records the threads it runs on
+  class ThreadRecordingSolver : public DeltaEddingtonSolver
+  {
+   public:
+    void SolveInto(const SolverInput& input, RadiationField& field) const override
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        threads_.insert(std::this_thread::get_id());
+      }
+      DeltaEddingtonSolver::SolveInto(input, field);
+    }
+
+    std::size_t Threads() const
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return threads_.size();
+    }
+
+   private:
+    mutable std::mutex mutex_;
+    mutable std::set<std::thread::id> threads_;
+  };
+}  // namespace
+
+class PipelineExecutorTest : public ::testing::Test
+{
+ protected:
+  void SetUp() override
+  {
+    model_ = std::make_unique<TuvModel>(SmallConfig());
+    model_->AddStandardRadiators();
+    model_->AddPhotolysisReaction("O3 -> O2 + O(1D)", &o3_xs_, &o3_qy_);
+    model_->AddPhotolysisReaction("O3 -> O2 + O(3P)", &o3_xs_, &o3p_qy_);
+  }
+
+  O3CrossSection o3_xs_;
+  O3O1DQuantumYield o3_qy_;
+  O3O3PQuantumYield o3p_qy_;
+  std::unique_ptr<TuvModel> model_;
+};
+
+TEST_F(PipelineExecutorTest, BitIdenticalToSerialAcrossDepths)
+{
+  Batch batch(*model_, 9);
+  std::vector<double> expected(batch.RateCount(), -1.0);
+  BatchDriver(*model_).Calculate(batch.Inputs(), batch.Outputs(expected));
+
+  for (std::size_t depth : { 1u, 2u, 3u, 4u, 16u })
+  {
+    PipelineExecutor pipeline(*model_, depth);
+    EXPECT_EQ(pipeline.Depth(), depth);
+    std::vector<double> rates(batch.RateCount(), -1.0);
+    pipeline.Calculate(batch.Inputs(), batch.Outputs(rates));
+    EXPECT_EQ(rates, expected) << "depth " << depth;
+  }
+}
+
+TEST_F(PipelineExecutorTest, PreparesLazyModel)
+{
+  ModelConfig config = SmallConfig();
+  config.lazy_initialization = true;
+  TuvModel lazy(config);
+  lazy.AddStandardRadiators();
+  lazy.AddPhotolysisReaction("O3 -> O2 + O(1D)", &o3_xs_, &o3_qy_);
+  lazy.AddPhotolysisReaction("O3 -> O2 + O(3P)", &o3_xs_, &o3p_qy_);
+
+  Batch batch(*model_, 4);
+  std::vector<double> expected(batch.RateCount());
+  BatchDriver(*model_).Calculate(batch.Inputs(), batch.Outputs(expected));
+
+  std::vector<double> rates(batch.RateCount());
+  PipelineExecutor(lazy).Calculate(batch.Inputs(), batch.Outputs(rates));
+  EXPECT_TRUE(lazy.IsPrepared());
+  EXPECT_EQ(rates, expected);
+}
+
+TEST_F(PipelineExecutorTest, RejectsInvalidArguments)
+{
+  EXPECT_THROW(PipelineExecutor(*model_, 0), std::invalid_argument);
+
+  Batch batch(*model_, 2);
+  std::vector<double> rates(batch.RateCount());
+  ColumnBatchView inputs = batch.Inputs();
+  inputs.n_layers += 1;
+  PipelineExecutor pipeline(*model_);
+  EXPECT_THROW(pipeline.Calculate(inputs, batch.Outputs(rates)), TuvxInternalException);
+
+  // An empty batch is a no-op
+  inputs.n_columns = 0;
+  EXPECT_NO_THROW(pipeline.Calculate(inputs, batch.Outputs(rates)));
+}
+
+TEST_F(PipelineExecutorTest, StageErrorIsRethrownAndPipelineRecovers)
+{
+  Batch batch(*model_, 8);
+  std::vector<double> expected(batch.RateCount());
+  BatchDriver(*model_).Calculate(batch.Inputs(), batch.Outputs(expected));
+
+  model_->SetSolver(std::make_unique<FailingSolver>(3));
+  std::vector<double> rates(batch.RateCount());
+  PipelineExecutor pipeline(*model_, 3);
+  EXPECT_THROW(pipeline.Calculate(batch.Inputs(), batch.Outputs(rates)), std::runtime_error);
+
+  // The failing call has passed; the same executor runs the next batch cleanly
+  pipeline.Calculate(batch.Inputs(), batch.Outputs(rates));
+  EXPECT_EQ(rates, expected);
+}
+
+TEST_F(PipelineExecutorTest, StageThreadsOutliveCalls)
+{
+  Batch batch(*model_, 6);
+  std::vector<double> expected(batch.RateCount());
+  BatchDriver(*model_).Calculate(batch.Inputs(), batch.Outputs(expected));
+
+  // An executor that never runs a batch still stops its threads
+  {
+    PipelineExecutor idle(*model_);
+  }
+
+  auto solver = std::make_unique<ThreadRecordingSolver>();
+  const ThreadRecordingSolver& recorder = *solver;
+  model_->SetSolver(std::move(solver));
+  PipelineExecutor pipeline(*model_, 2);
+  for (int call = 0; call < 3; ++call)
+  {
+    std::vector<double> rates(batch.RateCount(), -1.0);
+    pipeline.Calculate(batch.Inputs(), batch.Outputs(rates));
+    EXPECT_EQ(rates, expected) << "call " << call;
+  }
+  EXPECT_EQ(recorder.Threads(), 1u);
+}
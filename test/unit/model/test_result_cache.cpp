@@ -0,0 +1,264 @@
+#include <tuvx/cross_section/types/o3.hpp>
+#include <tuvx/model/batch_driver.hpp>
+#include <tuvx/model/result_cache.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/quantum_yield/types/o3_o1d.hpp>
+#include <tuvx/util/thread_pool.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace tuvx;
+
+class ResultCacheTest : public ::testing::Test
+{
+ protected:
+  void SetUp() override
+  {
+    ModelConfig config;
+    config.n_wavelength_bins = 20;
+    config.wavelength_min = 280.0;
+    config.wavelength_max = 400.0;
+    config.n_altitude_layers = 10;
+    model_ = std::make_unique<TuvModel>(config);
+    model_->AddStandardRadiators();
+    model_->AddPhotolysisReaction("O3 -> O2 + O(1D)", &o3_xs_, &o3_qy_);
+    model_->AddPhotolysisReaction("O3 -> O2 + O(3P)", &o3_xs_, &o3p_qy_);
+
+    auto mid = model_->AltitudeGrid().Midpoints();
+    std::vector<double> midpoints(mid.begin(), mid.end());
+    temperature_ = StandardAtmosphere::GenerateTemperatureProfile(midpoints);
+    n_levels_ = midpoints.size() + 1;
+  }
+
+  ColumnView Column(double sza, const std::vector<double>& temperature) const
+  {
+    ColumnView column;
+    column.solar_zenith_angle = sza;
+    column.temperature = StridedView<const double>(temperature.data(), temperature.size());
+    return column;
+  }
+
+  std::vector<double> Uncached(const ColumnView& column)
+  {
+    std::vector<double> rates(2 * n_levels_);
+    model_->CalculatePhotolysisRates(column, rates.data(), static_cast<std::ptrdiff_t>(n_levels_), 1);
+    return rates;
+  }
+
+  std::vector<double> Cached(ResultCache& cache, const ColumnView& column, bool& hit)
+  {
+    std::vector<double> rates(2 * n_levels_);
+    hit = cache.CalculatePhotolysisRates(*model_, column, rates.data(), static_cast<std::ptrdiff_t>(n_levels_), 1);
+    return rates;
+  }
+
+  O3CrossSection o3_xs_;
+  O3O1DQuantumYield o3_qy_;
+  O3O3PQuantumYield o3p_qy_;
+  std::unique_ptr<TuvModel> model_;
+  std::vector<double> temperature_;
+  std::size_t n_levels_{ 0 };
+};
+
+TEST_F(ResultCacheTest, HitReturnsStoredRates)
+{
+  ResultCache cache;
+  bool hit = true;
+  auto first = Cached(cache, Column(30.0, temperature_), hit);
+  EXPECT_FALSE(hit);
+  EXPECT_EQ(first, Uncached(Column(30.0, temperature_)));
+
+  auto second = Cached(cache, Column(30.0, temperature_), hit);
+  EXPECT_TRUE(hit);
+  EXPECT_EQ(second, first);
+
+  auto stats = cache.Stats();
+  EXPECT_EQ(stats.hits, 1u);
+  EXPECT_EQ(stats.misses, 1u);
+  EXPECT_EQ(stats.entries, 1u);
+  EXPECT_GT(stats.bytes, 0u);
+  EXPECT_DOUBLE_EQ(stats.HitRate(), 0.5);
+}
+
+TEST_F(ResultCacheTest, QuantizesEachField)
+{
+  ResultCache cache;
+  temperature_[3] = 250.0;  // on a step, away from a rounding boundary
+  std::vector<double> warmer = temperature_;
+  warmer[3] += 0.1;
+  std::vector<double> much_warmer = temperature_;
+  much_warmer[3] += 2.0;
+
+  auto base = cache.MakeKey(*model_, Column(30.0, temperature_));
+  EXPECT_EQ(cache.MakeKey(*model_, Column(30.04, temperature_)), base);
+  EXPECT_EQ(cache.MakeKey(*model_, Column(30.0, warmer)), base);
+  EXPECT_FALSE(cache.MakeKey(*model_, Column(30.2, temperature_)) == base);
+  EXPECT_FALSE(cache.MakeKey(*model_, Column(30.0, much_warmer)) == base);
+
+  // A configured profile is not the same input as an explicit one
+  ColumnView defaults;
+  defaults.solar_zenith_angle = 30.0;
+  EXPECT_FALSE(cache.MakeKey(*model_, defaults) == base);
+
+  ColumnView brighter = Column(30.0, temperature_);
+  brighter.surface_albedo = 0.3;
+  EXPECT_FALSE(cache.MakeKey(*model_, brighter) == base);
+
+  // Zero steps match exactly
+  ResultCacheConfig exact;
+  exact.solar_zenith_angle_step = 0.0;
+  exact.temperature_step = 0.0;
+  ResultCache exact_cache(exact);
+  EXPECT_FALSE(
+      exact_cache.MakeKey(*model_, Column(30.0, warmer)) == exact_cache.MakeKey(*model_, Column(30.0, temperature_)));
+  EXPECT_FALSE(
+      exact_cache.MakeKey(*model_, Column(30.04, temperature_)) ==
+      exact_cache.MakeKey(*model_, Column(30.0, temperature_)));
+}
+
+TEST_F(ResultCacheTest, SeparatesDayFromNight)
+{
+  ResultCache cache;
+  auto key = [&](double sza) { return cache.MakeKey(*model_, Column(sza, temperature_)); };
+  EXPECT_FALSE(key(89.95) == key(90.04));
+  EXPECT_EQ(key(89.95), key(90.0));
+  EXPECT_EQ(key(90.01), key(90.04));
+  EXPECT_EQ(key(29.96), key(30.04));
+}
+
+TEST_F(ResultCacheTest, SeparatesZeroNegativeAndNonFiniteDensities)
+{
+  ResultCache cache;
+  std::vector<double> ozone(temperature_.size(), 1.0e12);
+  auto key = [&](double value)
+  {
+    ozone[2] = value;
+    ColumnView column = Column(30.0, temperature_);
+    column.ozone = StridedView<const double>(ozone.data(), ozone.size());
+    return cache.MakeKey(*model_, column);
+  };
+  EXPECT_TRUE(key(0.0).Cacheable());
+  EXPECT_EQ(key(0.0), key(-0.0));
+  EXPECT_FALSE(key(0.0) == key(-1.0e12));
+  EXPECT_FALSE(key(-1.0e12) == key(-2.0e12));
+  EXPECT_FALSE(key(-1.0e12) == key(1.0e12));
+  EXPECT_EQ(key(-1.0e12), key(-1.0001e12));
+
+  // NaN and values beyond the countable range are calculated but never stored
+  EXPECT_FALSE(key(std::numeric_limits<double>::quiet_NaN()).Cacheable());
+  EXPECT_FALSE(key(std::numeric_limits<double>::infinity()).Cacheable());
+  EXPECT_FALSE(cache.MakeKey(*model_, Column(1.0e300, temperature_)).Cacheable());
+  EXPECT_FALSE(cache.MakeKey(*model_, Column(std::numeric_limits<double>::quiet_NaN(), temperature_)).Cacheable());
+
+  std::vector<double> hot = temperature_;
+  hot[0] = std::numeric_limits<double>::quiet_NaN();
+  bool hit = true;
+  Cached(cache, Column(30.0, hot), hit);
+  EXPECT_FALSE(hit);
+  Cached(cache, Column(30.0, hot), hit);
+  EXPECT_FALSE(hit);
+  EXPECT_EQ(cache.Stats().entries, 0u);
+  EXPECT_EQ(cache.Stats().misses, 2u);
+}
+
+TEST_F(ResultCacheTest, ConfigurationChangeMisses)
+{
+  ResultCache cache;
+  bool hit = false;
+  Cached(cache, Column(30.0, temperature_), hit);
+
+  model_->AddAerosolRadiator();
+  auto rates = Cached(cache, Column(30.0, temperature_), hit);
+  EXPECT_FALSE(hit);
+  EXPECT_EQ(rates, Uncached(Column(30.0, temperature_)));
+}
+
+TEST_F(ResultCacheTest, EvictsLeastRecentlyUsed)
+{
+  ResultCacheConfig config;
+  config.n_shards = 1;
+  ResultCache probe(config);
+  bool hit = false;
+  Cached(probe, Column(10.0, temperature_), hit);
+  std::size_t entry_bytes = probe.Stats().bytes;
+
+  // Room for exactly two entries
+  config.max_bytes = 2 * entry_bytes + entry_bytes / 2;
+  ResultCache cache(config);
+  Cached(cache, Column(10.0, temperature_), hit);
+  Cached(cache, Column(20.0, temperature_), hit);
+  Cached(cache, Column(10.0, temperature_), hit);
+  EXPECT_TRUE(hit);
+  Cached(cache, Column(30.0, temperature_), hit);
+
+  auto stats = cache.Stats();
+  EXPECT_EQ(stats.entries, 2u);
+  EXPECT_EQ(stats.evictions, 1u);
+  EXPECT_LE(stats.bytes, config.max_bytes);
+
+  Cached(cache, Column(10.0, temperature_), hit);
+  EXPECT_TRUE(hit);
+  Cached(cache, Column(20.0, temperature_), hit);
+  EXPECT_FALSE(hit);
+
+  cache.Clear();
+  EXPECT_EQ(cache.Stats().entries, 0u);
+  EXPECT_EQ(cache.Stats().hits, 0u);
+}
+
+TEST_F(ResultCacheTest, SharedByBatchDriverThreads)
+{
+  const std::size_t n_columns = 64;
+  const std::size_t n_layers = temperature_.size();
+  const std::ptrdiff_t column_stride = static_cast<std::ptrdiff_t>(2 * n_levels_);
+
+  // Four distinct columns, each repeated with SZA jitter below the step
+  std::vector<double> sza(n_columns);
+  std::vector<double> temperature;
+  for (std::size_t c = 0; c < n_columns; ++c)
+  {
+    sza[c] = 20.0 + 10.0 * static_cast<double>(c % 4) + 0.001 * static_cast<double>(c / 4);
+    temperature.insert(temperature.end(), temperature_.begin(), temperature_.end());
+  }
+  ColumnBatchView batch;
+  batch.n_columns = n_columns;
+  batch.n_layers = n_layers;
+  batch.solar_zenith_angle = StridedView<const double>(sza.data(), n_columns);
+  batch.temperature = { temperature.data(), static_cast<std::ptrdiff_t>(n_layers), 1 };
+
+  std::vector<double> expected(n_columns * 2 * n_levels_);
+  BatchDriver(*model_).Calculate(batch, { expected.data(), column_stride, static_cast<std::ptrdiff_t>(n_levels_), 1 });
+
+  ResultCache cache;
+  ThreadPool pool(4);
+  BatchDriver driver(*model_, pool);
+  driver.SetCache(&cache);
+  EXPECT_EQ(driver.Cache(), &cache);
+  std::vector<double> j(expected.size());
+  driver.Calculate(batch, { j.data(), column_stride, static_cast<std::ptrdiff_t>(n_levels_), 1 });
+
+  auto stats = cache.Stats();
+  EXPECT_EQ(stats.hits + stats.misses, n_columns);
+  EXPECT_EQ(stats.entries, 4u);
+  EXPECT_GE(stats.hits, n_columns - 4 * pool.Size());
+  for (std::size_t c = 0; c < n_columns; ++c)
+  {
+    // Every column in a group gets the rates of one of the group's columns
+    std::size_t group = c % 4;
+    bool matches_group = false;
+    for (std::size_t source = group; source < n_columns; source += 4)
+    {
+      matches_group = matches_group || std::equal(
+                                           j.begin() + static_cast<std::ptrdiff_t>(c) * column_stride,
+                                           j.begin() + static_cast<std::ptrdiff_t>(c + 1) * column_stride,
+                                           expected.begin() + static_cast<std::ptrdiff_t>(source) * column_stride);
+    }
+    EXPECT_TRUE(matches_group) << "column " << c;
+  }
+}
@@ -0,0 +1,366 @@
+#include <tuvx/cross_section/types/o3.hpp>
+#include <tuvx/model/trace.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/quantum_yield/types/o3_o1d.hpp>
+
+#include <cstdint>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace tuvx;
+
+class TraceTest : public ::testing::Test
+{
+ protected:
+  ModelConfig SmallConfig() const
+  {
+    ModelConfig config;
+    config.n_wavelength_bins = 20;
+    config.n_altitude_layers = 10;
+    return config;
+  }
+
+  void AddReactions(TuvModel& model)
+  {
+    model.AddPhotolysisReaction("O3 -> O2 + O(1D)", &o3_xs_, &o3_qy_);
+    model.AddPhotolysisReaction("O3 -> O2 + O(3P)", &o3_xs_, &o3p_qy_);
+  }
+
+  TuvModel MakeModel(const TraceSetup& setup)
+  {
+    TuvModel model = BuildTraceModel(setup);
+    AddReactions(model);
+    return model;
+  }
+
+  O3CrossSection o3_xs_;
+  O3O1DQuantumYield o3_qy_;
+  O3O3PQuantumYield o3p_qy_;
+};
+
+TEST_F(TraceTest, RoundTripsCallsAndOutputs)
+{
+  TuvModel model(SmallConfig());
+  model.AddStandardRadiators();
+  AddReactions(model);
+
+  std::stringstream stream;
+  TraceWriter writer(stream);
+  writer.Attach(model);
+
+  auto first = model.Calculate(20.0);
+  auto second = model.Calculate(60.0);
+  EXPECT_EQ(writer.CallsWritten(), 2u);
+  EXPECT_EQ(writer.SetupsWritten(), 1u);
+
+  Trace trace = ReadTrace(stream);
+  ASSERT_EQ(trace.setups.size(), 1u);
+  ASSERT_EQ(trace.calls.size(), 2u);
+
+  const auto& setup = trace.setups[0];
+  EXPECT_EQ(setup.config.n_wavelength_bins, 20u);
+  EXPECT_EQ(setup.config.n_altitude_layers, 10u);
+  EXPECT_EQ(setup.radiators, (std::vector<std::string>{ "O3", "O2", "rayleigh" }));
+  EXPECT_FALSE(setup.aerosol.has_value());
+  EXPECT_EQ(setup.reactions, model.PhotolysisReactions().ReactionNames());
+
+  EXPECT_EQ(trace.calls[0].solar_zenith_angle, 20.0);
+  EXPECT_EQ(trace.calls[1].solar_zenith_angle, 60.0);
+  ASSERT_TRUE(trace.calls[1].HasOutputs());
+  std::size_t n_levels = trace.calls[1].n_levels;
+  ASSERT_EQ(n_levels, second.photolysis_rates[0].rates.size());
+  for (std::size_t r = 0; r < second.photolysis_rates.size(); ++r)
+  {
+    for (std::size_t l = 0; l < n_levels; ++l)
+    {
+      EXPECT_EQ(trace.calls[1].rates[r * n_levels + l], second.photolysis_rates[r].rates[l]);
+    }
+  }
+}
+
+TEST_F(TraceTest, WritesSetupOnlyWhenItChanges)
+{
+  TuvModel model(SmallConfig());
+  model.AddStandardRadiators();
+  AddReactions(model);
+
+  std::stringstream stream;
+  TraceWriter writer(stream, false);
+  writer.Attach(model);
+
+  model.Calculate(10.0);
+  model.Calculate(20.0);
+  auto midpoints = model.AltitudeGrid().Midpoints();
+  std::vector<double> temperature(midpoints.size(), 240.0);
+  model.SetTemperatureProfile(temperature);
+  model.Calculate(30.0);
+  model.SetSurfaceAlbedo(0.3);
+  model.Calculate(40.0);
+  model.Calculate(50.0);
+
+  EXPECT_EQ(writer.CallsWritten(), 5u);
+  EXPECT_EQ(writer.SetupsWritten(), 3u);
+
+  Trace trace = ReadTrace(stream);
+  ASSERT_EQ(trace.calls.size(), 5u);
+  EXPECT_EQ(trace.calls[1].setup, 0u);
+  EXPECT_EQ(trace.calls[2].setup, 1u);
+  EXPECT_EQ(trace.calls[4].setup, 2u);
+  EXPECT_EQ(trace.setups[1].config.temperature_profile, temperature);
+  EXPECT_EQ(trace.setups[2].config.surface_albedo, 0.3);
+  EXPECT_FALSE(trace.calls[0].HasOutputs());
+}
+
+TEST_F(TraceTest, NewModelAtSameAddressGetsItsOwnSetup)
+{
+  std::stringstream stream;
+  TraceWriter writer(stream, false);
+  std::optional<TuvModel> model;
+  for (double albedo : { 0.1, 0.4 })
+  {
+    ModelConfig config = SmallConfig();
+    config.surface_albedo = albedo;
+    model.emplace(config);
+    model->AddStandardRadiators();
+    writer.Record(*model, 30.0, model->Calculate(30.0));
+    writer.Record(*model, 40.0, model->Calculate(40.0));
+  }
+  EXPECT_EQ(writer.SetupsWritten(), 2u);
+
+  Trace trace = ReadTrace(stream);
+  ASSERT_EQ(trace.setups.size(), 2u);
+  EXPECT_EQ(trace.setups[1].config.surface_albedo, 0.4);
+  EXPECT_EQ(trace.calls[3].setup, 1u);
+}
+
+TEST_F(TraceTest, CapturesAerosolConfiguration)
+{
+  AerosolRadiator::Config aerosol;
+  aerosol.optical_depth_ref = 0.35;
+  aerosol.angstrom_exponent = 0.8;
+  aerosol.ssa_wavelengths = { 300.0, 600.0 };
+  aerosol.ssa_values = { 0.85, 0.95 };
+
+  TuvModel model(SmallConfig());
+  model.AddStandardRadiators();
+  model.AddAerosolRadiator(aerosol);
+
+  std::stringstream stream;
+  TraceWriter writer(stream);
+  writer.Record(model, 45.0, model.Calculate(45.0));
+
+  Trace trace = ReadTrace(stream);
+  ASSERT_TRUE(trace.setups[0].aerosol.has_value());
+  EXPECT_EQ(trace.setups[0].aerosol->optical_depth_ref, 0.35);
+  EXPECT_EQ(trace.setups[0].aerosol->angstrom_exponent, 0.8);
+  EXPECT_EQ(trace.setups[0].aerosol->ssa_values, aerosol.ssa_values);
+
+  TuvModel rebuilt = BuildTraceModel(trace.setups[0]);
+  EXPECT_EQ(rebuilt.Radiators().Names(), model.Radiators().Names());
+}
+
+TEST_F(TraceTest, ReplayReproducesRecordedOutputs)
+{
+  TuvModel model(SmallConfig());
+  model.AddStandardRadiators();
+  model.AddAerosolRadiator();
+  AddReactions(model);
+
+  std::stringstream stream;
+  TraceWriter writer(stream);
+  writer.Attach(model);
+  for (double sza : { 0.0, 30.0, 60.0, 85.0 })
+  {
+    model.Calculate(sza);
+  }
+  model.SetSurfaceAlbedo(0.5);
+  model.Calculate(45.0);
+
+  Trace trace = ReadTrace(stream);
+  TraceReplayOptions options;
+  options.relative_tolerance = 0.0;
+  auto report = ReplayTrace(trace, [&](const TraceSetup& setup) { return MakeModel(setup); }, options);
+
+  ASSERT_EQ(report.calls.size(), 5u);
+  EXPECT_EQ(report.Mismatches(), 0u);
+  EXPECT_EQ(report.MaxRelativeError(), 0.0);
+  for (const auto& call : report.calls)
+  {
+    EXPECT_GT(call.n_compared, 0u);
+    EXPECT_GE(call.seconds, 0.0);
+  }
+}
+
+TEST_F(TraceTest, ReplayDetectsChangedResults)
+{
+  TuvModel model(SmallConfig());
+  model.AddStandardRadiators();
+  AddReactions(model);
+
+  std::stringstream stream;
+  TraceWriter writer(stream);
+  writer.Attach(model);
+  model.Calculate(30.0);
+
+  Trace trace = ReadTrace(stream);
+  trace.calls[0].rates[3] *= 1.01;
+
+  auto report = ReplayTrace(trace, [&](const TraceSetup& setup) { return MakeModel(setup); });
+  EXPECT_EQ(report.Mismatches(), 1u);
+  EXPECT_NEAR(report.MaxRelativeError(), 0.01 / 1.01, 1e-12);
+
+  TraceReplayOptions loose;
+  loose.relative_tolerance = 0.02;
+  EXPECT_EQ(ReplayTrace(trace, [&](const TraceSetup& setup) { return MakeModel(setup); }, loose).Mismatches(), 0u);
+}
+
+TEST_F(TraceTest, RecordsAndReplaysBulkPath)
+{
+  TuvModel model(SmallConfig());
+  model.AddStandardRadiators();
+  AddReactions(model);
+
+  std::stringstream stream;
+  TraceWriter writer(stream);
+  writer.Attach(model);
+
+  std::size_t n_levels = model.AltitudeGrid().Spec().n_cells + 1;
+  ColumnState column;
+  column.solar_zenith_angle = 35.0;
+  column.surface_albedo = 0.25;
+  column.temperature.assign(n_levels - 1, 230.0);
+  std::vector<double> rates(2 * n_levels);
+  model.CalculatePhotolysisRates(column.View(), rates.data(), static_cast<std::ptrdiff_t>(n_levels), 1);
+  model.Calculate(50.0);
+  EXPECT_EQ(writer.CallsWritten(), 2u);
+  EXPECT_EQ(writer.SetupsWritten(), 1u);
+
+  Trace trace = ReadTrace(stream);
+  ASSERT_EQ(trace.calls.size(), 2u);
+  ASSERT_TRUE(trace.calls[0].column.has_value());
+  EXPECT_FALSE(trace.calls[1].column.has_value());
+  EXPECT_EQ(trace.calls[0].column->surface_albedo, 0.25);
+  EXPECT_EQ(trace.calls[0].column->temperature, column.temperature);
+  EXPECT_TRUE(trace.calls[0].column->ozone.empty());
+  EXPECT_EQ(trace.calls[0].rates, rates);
+
+  TraceReplayOptions options;
+  options.relative_tolerance = 0.0;
+  auto report = ReplayTrace(trace, [&](const TraceSetup& setup) { return MakeModel(setup); }, options);
+  EXPECT_EQ(report.Mismatches(), 0u);
+  EXPECT_EQ(report.calls[0].n_compared, rates.size());
+}
+
+TEST_F(TraceTest, RejectsOversizedRecords)
+{
+  TuvModel model(SmallConfig());
+  model.AddStandardRadiators();
+  AddReactions(model);
+  std::stringstream stream;
+  TraceWriter writer(stream);
+  writer.Record(model, 30.0, model.Calculate(30.0));
+  std::string bytes = stream.str();
+
+  // A record claiming far more bytes than the file holds
+  std::string huge_record = bytes;
+  huge_record.push_back(static_cast<char>(2));
+  std::uint64_t size = std::uint64_t{ 1 } << 60;
+  huge_record.append(reinterpret_cast<const char*>(&size), sizeof(size));
+  std::stringstream huge(huge_record);
+  EXPECT_THROW(ReadTrace(huge), std::runtime_error);
+
+  // A call record whose level count overflows its payload
+  std::string payload;
+  trace_format::Encoder out(payload);
+  out.Put(30.0);
+  out.PutSize(2);
+  out.PutSize(std::size_t{ 1 } << 62);
+  std::string overflow_record = bytes;
+  overflow_record.push_back(static_cast<char>(2));
+  std::uint64_t payload_size = payload.size();
+  overflow_record.append(reinterpret_cast<const char*>(&payload_size), sizeof(payload_size));
+  overflow_record += payload;
+  std::stringstream overflow(overflow_record);
+  EXPECT_THROW(ReadTrace(overflow), std::runtime_error);
+}
+
+TEST_F(TraceTest, RejectsMalformedTraces)
+{
+  std::stringstream not_a_trace("this is not a trace file");
+  EXPECT_THROW(ReadTrace(not_a_trace), std::runtime_error);
+
+  TuvModel model(SmallConfig());
+  model.AddStandardRadiators();
+  std::stringstream stream;
+  TraceWriter writer(stream);
+  writer.Record(model, 30.0, model.Calculate(30.0));
+
+  std::string bytes = stream.str();
+  std::stringstream truncated(bytes.substr(0, bytes.size() - 4));
+  EXPECT_THROW(ReadTrace(truncated), std::runtime_error);
+
+  TraceSetup unknown;
+  unknown.radiators = { "SO2" };
+  EXPECT_THROW(BuildTraceModel(unknown), std::runtime_error);
+}
+
+TEST_F(TraceTest, RejectsCountsTheRecordCannotHold)
+{
+  TuvModel model(SmallConfig());
+  AddReactions(model);
+  std::stringstream stream;
+  TraceWriter writer(stream);
+  writer.Record(model, 30.0, model.Calculate(30.0));
+  std::string header = stream.str().substr(0, sizeof(trace_format::kMagic) + 2 * sizeof(std::uint32_t));
+  auto append_record = [](std::string& bytes, std::uint8_t tag, const std::string& payload)
+  {
+    std::uint64_t size = payload.size();
+    bytes.push_back(static_cast<char>(tag));
+    bytes.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    bytes += payload;
+  };
+
+  // A setup's radiator or reaction count far beyond the bytes left; both
+  // counts sit at the end of a setup without an aerosol
+  TraceSetup setup = CaptureTraceSetup(model);
+  std::string setup_payload;
+  trace_format::EncodeSetup(setup, setup_payload);
+  std::uint64_t huge = std::uint64_t{ 1 } << 40;
+  std::size_t reactions_at = setup_payload.size() - sizeof(huge);
+  for (const auto& name : setup.reactions)
+  {
+    reactions_at -= sizeof(std::uint64_t) + name.size();
+  }
+  std::size_t radiators_at = reactions_at - 1 - sizeof(huge);
+  for (std::size_t at : { radiators_at, reactions_at })
+  {
+    std::string corrupt = setup_payload;
+    corrupt.replace(at, sizeof(huge), reinterpret_cast<const char*>(&huge), sizeof(huge));
+    std::string bytes = header;
+    append_record(bytes, trace_format::kSetupRecord, corrupt);
+    std::stringstream trace(bytes);
+    EXPECT_THROW(ReadTrace(trace), std::runtime_error);
+  }
+
+  // A call recording fewer reactions than its setup has; replaying it would
+  // read past the recorded J-values
+  std::string call_payload;
+  trace_format::Encoder out(call_payload);
+  out.Put(30.0);
+  std::size_t n_levels = model.AltitudeGrid().Spec().n_cells + 1;
+  out.PutSize(1);
+  out.PutSize(n_levels);
+  for (std::size_t l = 0; l < n_levels; ++l)
+  {
+    out.Put(1.0e-5);
+  }
+  std::string bytes = header;
+  append_record(bytes, trace_format::kSetupRecord, setup_payload);
+  append_record(bytes, trace_format::kCallRecord, call_payload);
+  std::stringstream fewer(bytes);
+  EXPECT_THROW(ReadTrace(fewer), std::runtime_error);
+}
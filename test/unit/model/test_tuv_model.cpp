@@ -3,6 +3,8 @@
 #include <tuvx/quantum_yield/types/base.hpp>
 
 #include <cmath>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -204,6 +206,23 @@ TEST(TuvModelTest, SetWavelengthGrid)
   EXPECT_DOUBLE_EQ(grid_edges[3], 400.0);
 }
 
+TEST(TuvModelTest, SetExtraterrestrialFlux)
+{
+  TuvModel model;
+  model.SetWavelengthGrid({ 280.0, 300.0, 320.0, 400.0 });
+  auto reference = model.ExtraterrestrialFlux();
+  ASSERT_EQ(reference.size(), 3u);
+
+  std::vector<double> flux = { 1.0e13, 2.0e13, 3.0e13 };
+  model.SetExtraterrestrialFlux(flux);
+  EXPECT_EQ(model.ExtraterrestrialFlux(), flux);
+  EXPECT_THROW(model.SetExtraterrestrialFlux({ 1.0e13 }), std::invalid_argument);
+
+  // A new grid brings back the reference spectrum
+  model.SetWavelengthGrid({ 280.0, 300.0, 320.0, 400.0 });
+  EXPECT_EQ(model.ExtraterrestrialFlux(), reference);
+}
+
 TEST(TuvModelTest, SetAltitudeGrid)
 {
   TuvModel model;
@@ -263,6 +282,120 @@ TEST(TuvModelTest, CalculateDaytime)
   EXPECT_EQ(output.NumberOfWavelengths(), 20u);
 }
 
+TEST(TuvModelTest, CopyProducesIdenticalResults)
+{
+  ModelConfig config;
+  config.n_wavelength_bins = 20;
+  config.n_altitude_layers = 10;
+
+  std::vector<double> wl = { 200.0, 400.0, 800.0 };
+  std::vector<double> xs_values = { 1e-18, 5e-19, 1e-20 };
+  BaseCrossSection xs("test", wl, xs_values);
+  ConstantQuantumYield qy("test", "A", "B", 1.0);
+
+  TuvModel model(config);
+  model.AddStandardRadiators();
+  model.AddPhotolysisReaction("test", &xs, &qy);
+
+  TuvModel copy(model);
+  EXPECT_EQ(copy.Radiators().Size(), model.Radiators().Size());
+  EXPECT_NE(&copy.Radiators().Get("O3"), &model.Radiators().Get("O3"));
+
+  auto original = model.Calculate(30.0);
+  auto copied = copy.Calculate(30.0);
+  ASSERT_EQ(copied.photolysis_rates.size(), 1u);
+  EXPECT_EQ(copied.photolysis_rates[0].rates, original.photolysis_rates[0].rates);
+
+  TuvModel assigned;
+  assigned = model;
+  EXPECT_EQ(assigned.Calculate(30.0).photolysis_rates[0].rates, original.photolysis_rates[0].rates);
+}
+
+TEST(TuvModelTest, LazyInitializationMatchesEager)
+{
+  ModelConfig config;
+  config.n_wavelength_bins = 20;
+  config.n_altitude_layers = 10;
+
+  std::vector<double> wl = { 200.0, 400.0, 800.0 };
+  std::vector<double> xs_values = { 1e-18, 5e-19, 1e-20 };
+  BaseCrossSection xs("test", wl, xs_values);
+  ConstantQuantumYield qy("test", "A", "B", 1.0);
+
+  TuvModel eager(config);
+  eager.AddStandardRadiators().AddAerosolRadiator();
+  eager.AddPhotolysisReaction("test", &xs, &qy);
+  EXPECT_TRUE(eager.IsPrepared());
+  EXPECT_EQ(eager.Radiators().Size(), 4u);
+
+  config.lazy_initialization = true;
+  TuvModel lazy(config);
+  lazy.AddStandardRadiators().AddAerosolRadiator();
+  lazy.AddPhotolysisReaction("test", &xs, &qy);
+  EXPECT_FALSE(lazy.IsPrepared());
+  EXPECT_EQ(lazy.Radiators().Size(), 0u);
+
+  // A copy of an unprepared model prepares itself independently
+  TuvModel copy(lazy);
+  auto expected = eager.Calculate(30.0).photolysis_rates[0].rates;
+  EXPECT_EQ(lazy.Calculate(30.0).photolysis_rates[0].rates, expected);
+  EXPECT_TRUE(lazy.IsPrepared());
+  EXPECT_EQ(lazy.Radiators().Size(), 4u);
+  EXPECT_EQ(lazy.Radiators().Get("rayleigh").Name(), "rayleigh");
+  EXPECT_FALSE(copy.IsPrepared());
+  copy.PrepareComponents();
+  EXPECT_TRUE(copy.IsPrepared());
+  EXPECT_EQ(copy.Calculate(30.0).photolysis_rates[0].rates, expected);
+
+  // A changed wavelength grid needs a new extraterrestrial flux
+  lazy.SetWavelengthGrid({ 300.0, 350.0, 400.0 });
+  EXPECT_FALSE(lazy.IsPrepared());
+  lazy.PrepareComponents();
+  EXPECT_TRUE(lazy.IsPrepared());
+}
+
+TEST(TuvModelTest, StartupProfileRecordsComponents)
+{
+  ModelConfig config;
+  config.n_wavelength_bins = 20;
+  config.n_altitude_layers = 10;
+  config.lazy_initialization = true;
+
+  TuvModel model(config);
+  model.AddStandardRadiators();
+  auto names = [&]
+  {
+    std::vector<std::string> components;
+    for (const auto& record : model.StartupProfile().Records())
+    {
+      components.push_back(record.component);
+      EXPECT_GE(record.seconds, 0.0);
+    }
+    return components;
+  };
+  EXPECT_EQ(names(), (std::vector<std::string>{ "wavelength grid", "altitude grid" }));
+
+  model.PrepareComponents();
+  EXPECT_EQ(
+      names(),
+      (std::vector<std::string>{ "wavelength grid",
+                                 "altitude grid",
+                                 "radiator O3",
+                                 "radiator O2",
+                                 "radiator Rayleigh",
+                                 "solver",
+                                 "extraterrestrial flux" }));
+  std::size_t recorded = model.StartupProfile().Records().size();
+  model.PrepareComponents();
+  model.Calculate(30.0);
+  EXPECT_EQ(model.StartupProfile().Records().size(), recorded);
+
+  std::string report = model.StartupProfile().Report();
+  EXPECT_NE(report.find("radiator O3"), std::string::npos);
+  EXPECT_NE(report.find("total"), std::string::npos);
+  EXPECT_GT(model.StartupProfile().TotalSeconds(), 0.0);
+}
+
 TEST(TuvModelTest, CalculateNighttime)
 {
   ModelConfig config;
@@ -415,6 +548,61 @@ TEST(TuvModelTest, MultiplePhotolysisReactions)
   EXPECT_NEAR(j_large / j_small, 10.0, 2.0);
 }
 
+TEST(TuvModelTest, CalculateIntoReusedOutput)
+{
+  ModelConfig config;
+  config.n_wavelength_bins = 20;
+  config.n_altitude_layers = 10;
+
+  TuvModel model(config);
+  model.AddStandardRadiators();
+
+  std::vector<double> wl = { 280.0, 700.0 };
+  std::vector<double> xs = { 1e-18, 1e-19 };
+  BaseCrossSection cross_section("test", wl, xs);
+  ConstantQuantumYield quantum_yield("test", "X", "Y", 1.0);
+  model.AddPhotolysisReaction("first", &cross_section, &quantum_yield);
+
+  auto expect_same = [](const ModelOutput& actual, const ModelOutput& expected)
+  {
+    EXPECT_EQ(actual.solar_zenith_angle, expected.solar_zenith_angle);
+    EXPECT_EQ(actual.is_daytime, expected.is_daytime);
+    EXPECT_EQ(actual.NumberOfLevels(), expected.NumberOfLevels());
+    EXPECT_EQ(actual.wavelength_grid.Spec(), expected.wavelength_grid.Spec());
+    EXPECT_EQ(actual.radiation_field.actinic_flux_direct, expected.radiation_field.actinic_flux_direct);
+    EXPECT_EQ(actual.radiation_field.actinic_flux_diffuse, expected.radiation_field.actinic_flux_diffuse);
+    EXPECT_EQ(actual.radiation_field.diffuse_up, expected.radiation_field.diffuse_up);
+    ASSERT_EQ(actual.ReactionNames(), expected.ReactionNames());
+    for (std::size_t r = 0; r < actual.photolysis_rates.size(); ++r)
+    {
+      EXPECT_EQ(actual.photolysis_rates[r].rates, expected.photolysis_rates[r].rates);
+    }
+  };
+
+  // Repeated calls into the same output match fresh by-value results
+  ModelOutput output;
+  for (double sza : { 30.0, 60.0, 95.0, 10.0 })
+  {
+    model.Calculate(sza, output);
+    expect_same(output, model.Calculate(sza));
+  }
+
+  // Reaction and grid changes are picked up by a reused output
+  model.AddPhotolysisReaction("second", &cross_section, &quantum_yield);
+  model.Calculate(30.0, output);
+  expect_same(output, model.Calculate(30.0));
+  EXPECT_EQ(output.ReactionNames(), (std::vector<std::string>{ "first", "second" }));
+
+  model.SetAltitudeGrid({ 0.0, 10.0, 20.0, 30.0, 40.0, 50.0 });
+  model.Calculate(30.0, output);
+  expect_same(output, model.Calculate(30.0));
+  EXPECT_EQ(output.NumberOfLevels(), 6u);
+
+  ModelOutput dated;
+  model.Calculate(2024, 6, 21, 12.0, 40.0, -105.0, dated);
+  expect_same(dated, model.Calculate(2024, 6, 21, 12.0, 40.0, -105.0));
+}
+
 // ============================================================================
 // ModelOutput Tests
 // ============================================================================
@@ -0,0 +1,209 @@
+#include <tuvx/cross_section/types/o3.hpp>
+#include <tuvx/model/two_resolution.hpp>
+#include <tuvx/quantum_yield/types/o3_o1d.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace tuvx;
+
+class TwoResolutionTest : public ::testing::Test
+{
+ protected:
+  /// Model with the standard radiators and O3 photolysis on 60 equal bins
+  TuvModel MakeModel() const
+  {
+    ModelConfig config;
+    config.n_altitude_layers = 20;
+    config.n_wavelength_bins = 60;
+    TuvModel model(config);
+    model.AddStandardRadiators();
+    model.AddPhotolysisReaction("O3 -> O2 + O(1D)", &o3_xs_, &o3_qy_);
+    model.AddPhotolysisReaction("O3 -> O2 + O(3P)", &o3_xs_, &o3p_qy_);
+    return model;
+  }
+
+  /// J-values of one column, [reaction][level]
+  template<typename Model>
+  static std::vector<double> Rates(Model& model, const ColumnState& column)
+  {
+    std::size_t n_levels = model.AltitudeGrid().Spec().n_cells + 1;
+    std::vector<double> rates(model.PhotolysisReactions().Size() * n_levels);
+    model.CalculatePhotolysisRates(column.View(), rates.data(), static_cast<std::ptrdiff_t>(n_levels), 1);
+    return rates;
+  }
+
+  O3CrossSection o3_xs_;
+  O3O1DQuantumYield o3_qy_;
+  O3O3PQuantumYield o3p_qy_;
+};
+
+TEST_F(TwoResolutionTest, BuildsCoarseGridFromFineEdges)
+{
+  TuvModel fine = MakeModel();
+  TwoResolutionModel model(fine);
+  EXPECT_EQ(model.NumberOfCoarseBins(), 15u);
+
+  auto fine_edges = fine.WavelengthGrid().Edges();
+  auto coarse_edges = model.CoarseModel().WavelengthGrid().Edges();
+  for (std::size_t b = 0; b < 15; ++b)
+  {
+    EXPECT_EQ(coarse_edges[b], fine_edges[4 * b]);
+  }
+  EXPECT_EQ(coarse_edges.back(), fine_edges.back());
+  EXPECT_EQ(model.FineModel().GetSolver()->Name(), "direct_beam");
+
+  // Coarse flux is the fine flux averaged over each coarse bin
+  TuvModel prepared(fine);
+  prepared.PrepareComponents();
+  const auto& fine_flux = prepared.ExtraterrestrialFlux();
+  double mean = (fine_flux[4] + fine_flux[5] + fine_flux[6] + fine_flux[7]) / 4.0;
+  EXPECT_NEAR(model.CoarseModel().ExtraterrestrialFlux()[1], mean, 1e-12 * mean);
+
+  // The last coarse bin takes the remainder
+  TwoResolutionConfig config;
+  config.merge_factor = 7;
+  EXPECT_EQ(TwoResolutionModel(fine, config).NumberOfCoarseBins(), 9u);
+}
+
+TEST_F(TwoResolutionTest, CloseToFineModel)
+{
+  TuvModel fine = MakeModel();
+  fine.PrepareComponents();
+  TwoResolutionConfig config;
+  config.refresh_tolerance = 0.0;
+  TwoResolutionModel model(fine, config);
+  TuvModel coarse(model.CoarseModel());
+
+  auto columns = detail::RandomColumns(fine, 5, 11);
+  std::size_t n_levels = 21;
+  double max_error = 0.0;
+  double max_coarse_error = 0.0;
+  for (const auto& column : columns)
+  {
+    auto expected = Rates(fine, column);
+    auto actual = Rates(model, column);
+    auto coarse_only = Rates(coarse, column);
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+      double peak = *std::max_element(expected.begin() + static_cast<std::ptrdiff_t>(i / n_levels * n_levels),
+                                      expected.begin() + static_cast<std::ptrdiff_t>((i / n_levels + 1) * n_levels));
+      double scale = std::max(expected[i], 1e-3 * peak);
+      max_error = std::max(max_error, std::abs(actual[i] - expected[i]) / scale);
+      max_coarse_error = std::max(max_coarse_error, std::abs(coarse_only[i] - expected[i]) / scale);
+    }
+  }
+  EXPECT_LT(max_error, 2e-2);
+  EXPECT_LT(10.0 * max_error, max_coarse_error);
+  EXPECT_EQ(model.Columns(), 5u);
+  EXPECT_EQ(model.RatioRefreshes(), 5u);
+}
+
+TEST_F(TwoResolutionTest, ReusesRatiosForSimilarColumns)
+{
+  TuvModel fine = MakeModel();
+  TwoResolutionModel model(fine);
+  ColumnState column = detail::RandomColumns(fine, 1, 5)[0];
+  column.solar_zenith_angle = 30.0;
+
+  auto first = Rates(model, column);
+  EXPECT_EQ(model.RatioRefreshes(), 1u);
+  EXPECT_EQ(Rates(model, column), first);
+  EXPECT_EQ(model.RatioRefreshes(), 1u);
+
+  // A small change in ozone and angle keeps the cached ratios
+  ColumnState nearby = column;
+  nearby.solar_zenith_angle = 30.5;
+  for (auto& ozone : nearby.ozone)
+  {
+    ozone *= 1.01;
+  }
+  Rates(model, nearby);
+  EXPECT_EQ(model.RatioRefreshes(), 1u);
+
+  // A large one does not
+  ColumnState far = column;
+  far.solar_zenith_angle = 70.0;
+  Rates(model, far);
+  EXPECT_EQ(model.RatioRefreshes(), 2u);
+
+  model.InvalidateRatios();
+  Rates(model, far);
+  EXPECT_EQ(model.RatioRefreshes(), 3u);
+  EXPECT_EQ(model.Columns(), 5u);
+}
+
+TEST_F(TwoResolutionTest, NightColumnIsDark)
+{
+  TuvModel fine = MakeModel();
+  TwoResolutionModel model(fine);
+  ColumnState column;
+  column.solar_zenith_angle = 95.0;
+  auto rates = Rates(model, column);
+  EXPECT_TRUE(std::all_of(rates.begin(), rates.end(), [](double j) { return j == 0.0; }));
+  EXPECT_EQ(model.RatioRefreshes(), 0u);
+}
+
+TEST_F(TwoResolutionTest, AcceptsExplicitCoarseEdges)
+{
+  TuvModel fine = MakeModel();
+  auto edges = fine.WavelengthGrid().Edges();
+
+  TwoResolutionConfig config;
+  config.coarse_edges = { edges[0], edges[10], edges[12], edges[40], edges[60] };
+  TwoResolutionModel model(fine, config);
+  EXPECT_EQ(model.NumberOfCoarseBins(), 4u);
+
+  ColumnState column;
+  column.solar_zenith_angle = 40.0;
+  auto rates = Rates(model, column);
+  EXPECT_TRUE(std::all_of(rates.begin(), rates.end(), [](double j) { return std::isfinite(j) && j > 0.0; }));
+}
+
+TEST_F(TwoResolutionTest, RejectsInvalidConfig)
+{
+  TuvModel fine = MakeModel();
+  auto edges = fine.WavelengthGrid().Edges();
+
+  TwoResolutionConfig config;
+  config.merge_factor = 0;
+  EXPECT_THROW(TwoResolutionModel(fine, config), std::invalid_argument);
+
+  config.coarse_edges = { edges[0], edges[30] };
+  EXPECT_THROW(TwoResolutionModel(fine, config), std::invalid_argument);
+  config.coarse_edges = { edges[0], edges[30] + 0.5, edges[60] };
+  EXPECT_THROW(TwoResolutionModel(fine, config), std::invalid_argument);
+  config.coarse_edges = { edges[0], edges[30], edges[20], edges[60] };
+  EXPECT_THROW(TwoResolutionModel(fine, config), std::invalid_argument);
+}
+
+TEST_F(TwoResolutionTest, ReportsAccuracyAndRefreshes)
+{
+  TuvModel fine = MakeModel();
+  ColumnState base = detail::RandomColumns(fine, 1, 9)[0];
+  std::vector<ColumnState> columns;
+  for (std::size_t i = 0; i < 20; ++i)
+  {
+    ColumnState column = base;
+    column.solar_zenith_angle = 20.0 + 2.0 * static_cast<double>(i);
+    columns.push_back(column);
+  }
+
+  auto report = EvaluateTwoResolution(fine, TwoResolutionConfig{}, columns);
+  EXPECT_EQ(report.n_fine_bins, 60u);
+  EXPECT_EQ(report.n_coarse_bins, 15u);
+  EXPECT_EQ(report.n_columns, 20u);
+  EXPECT_GT(report.ratio_refreshes, 0u);
+  EXPECT_LT(report.ratio_refreshes, 20u);
+  ASSERT_EQ(report.reactions.size(), 2u);
+  EXPECT_EQ(report.reactions[0].n_values, 20u * 21u);
+  EXPECT_LT(report.MaxRelativeError(), 0.03) << report.Summary();
+  EXPECT_LT(report.reactions[0].rms_relative_error, 0.005);
+  EXPECT_GT(report.fine_seconds, 0.0);
+  EXPECT_GT(report.two_resolution_seconds, 0.0);
+}
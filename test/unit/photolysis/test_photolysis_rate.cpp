@@ -3,6 +3,7 @@
 #include <tuvx/quantum_yield/types/base.hpp>
 
 #include <cmath>
+#include <cstring>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -305,6 +306,64 @@ TEST(PhotolysisRateSetTest, CalculateAll)
   EXPECT_GT(results[0].rates[0], results[1].rates[0]);
 }
 
+TEST(PhotolysisRateSetTest, CalculateAllBitIdenticalAcrossThreadCounts)
+{
+  // 300 wavelength bins exercise multi-block reproducible sums
+  const std::size_t n_wl = 300;
+  const std::size_t n_levels = 25;
+  std::vector<double> edges(n_wl + 1);
+  std::vector<double> xs_values(n_wl + 1);
+  for (std::size_t i = 0; i <= n_wl; ++i)
+  {
+    edges[i] = 250.0 + 0.5 * static_cast<double>(i);
+    xs_values[i] = 1e-17 * std::exp(-0.03 * static_cast<double>(i)) * (1.0 + 0.3 * std::sin(0.7 * static_cast<double>(i)));
+  }
+  BaseCrossSection xs("X", edges, xs_values);
+  ConstantQuantumYield qy_a("A", "X", "Y", 1.0);
+  ConstantQuantumYield qy_b("B", "X", "Z", 0.37);
+
+  PhotolysisRateSet set;
+  set.AddReaction("A", &xs, &qy_a);
+  set.AddReaction("B", &xs, &qy_b);
+
+  RadiationField field;
+  field.Initialize(n_levels, n_wl);
+  for (std::size_t l = 0; l < n_levels; ++l)
+  {
+    for (std::size_t j = 0; j < n_wl; ++j)
+    {
+      field.actinic_flux_direct[l][j] = 1e14 * (1.0 + 0.01 * static_cast<double>(l)) * std::exp(0.002 * static_cast<double>(j));
+      field.actinic_flux_diffuse[l][j] = 3e13 / (1.0 + static_cast<double>(j + l));
+    }
+  }
+  auto grid = CreateWavelengthGrid(edges);
+  std::vector<double> temperature(n_levels - 1, 250.0);
+
+  auto serial = set.CalculateAll(field, grid, temperature);
+
+  for (std::size_t n_threads : { 1u, 2u, 4u, 8u })
+  {
+    ThreadPool pool(n_threads);
+    auto threaded = set.CalculateAll(field, grid, temperature, pool);
+    ASSERT_EQ(threaded.size(), serial.size());
+
+    std::vector<double> strided(2 * n_levels, -1.0);
+    set.CalculateAll(field, grid, temperature, strided.data(), 1, 2, pool);
+
+    for (std::size_t r = 0; r < serial.size(); ++r)
+    {
+      EXPECT_EQ(threaded[r].reaction_name, serial[r].reaction_name);
+      ASSERT_EQ(threaded[r].rates.size(), n_levels);
+      EXPECT_EQ(std::memcmp(threaded[r].rates.data(), serial[r].rates.data(), n_levels * sizeof(double)), 0)
+          << "threads = " << n_threads;
+      for (std::size_t l = 0; l < n_levels; ++l)
+      {
+        EXPECT_EQ(std::memcmp(&strided[l * 2 + r], &serial[r].rates[l], sizeof(double)), 0);
+      }
+    }
+  }
+}
+
 // ============================================================================
 // Realistic Scenario Tests
 // ============================================================================
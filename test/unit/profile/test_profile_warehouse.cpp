@@ -176,6 +176,22 @@ TEST(ProfileWarehouseTest, GetInvalidHandleThrows)
   EXPECT_THROW(warehouse.Get(invalid_handle), TuvxInternalException);
 }
 
+TEST(ProfileWarehouseTest, ReplaceKeepsHandleAndLookup)
+{
+  ProfileWarehouse warehouse;
+  ProfileSpec spec{ .name = "temperature", .units = "K", .n_cells = 10 };
+  ProfileHandle handle = warehouse.Add(Profile(spec, std::vector<double>(10, 250.0)));
+
+  warehouse.Replace(handle, Profile(spec, std::vector<double>(10, 280.0)));
+  EXPECT_EQ(warehouse.Size(), 1u);
+  EXPECT_DOUBLE_EQ(warehouse.Get(handle).MidValues()[0], 280.0);
+  EXPECT_DOUBLE_EQ(warehouse.Get("temperature", "K").MidValues()[9], 280.0);
+
+  ProfileSpec other{ .name = "temperature", .units = "C", .n_cells = 10 };
+  EXPECT_THROW(warehouse.Replace(handle, Profile(other, std::vector<double>(10, 7.0))), TuvxInternalException);
+  EXPECT_THROW(warehouse.Replace(ProfileHandle{}, Profile(spec, std::vector<double>(10, 7.0))), TuvxInternalException);
+}
+
 // ============================================================================
 // ProfileWarehouse Keys Tests
 // ============================================================================
@@ -8,6 +8,7 @@
 
 #include <cmath>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -102,6 +103,33 @@ TEST_F(RadiatorTestFixture, UpdateState)
   EXPECT_EQ(state.NumberOfWavelengths(), 3u);
 }
 
+TEST_F(RadiatorTestFixture, MissingInputsReportRadiatorAndErrorCode)
+{
+  FromCrossSectionRadiator radiator("NO2", MakeSimpleCrossSection("NO2", 1e-18), "NO2");
+  try
+  {
+    radiator.UpdateState(grids_, profiles_);
+    FAIL() << "expected a missing profile error";
+  }
+  catch (const TuvxInternalException& e)
+  {
+    EXPECT_EQ(e.code(), TuvxInternalErrc::ProfileNotFound);
+    EXPECT_NE(std::string(e.what()).find("Radiator 'NO2' needs profile 'NO2' [molecules/cm^3]"), std::string::npos);
+  }
+
+  FromCrossSectionRadiator o3("O3", MakeSimpleCrossSection("O3", 1e-18), "O3", "temperature", "wavelength", "height");
+  try
+  {
+    o3.UpdateState(grids_, profiles_);
+    FAIL() << "expected a missing grid error";
+  }
+  catch (const TuvxInternalException& e)
+  {
+    EXPECT_EQ(e.code(), TuvxInternalErrc::GridNotFound);
+  }
+  EXPECT_FALSE(o3.HasState());
+}
+
 TEST_F(RadiatorTestFixture, OpticalDepthCalculation)
 {
   // Use a known cross-section value
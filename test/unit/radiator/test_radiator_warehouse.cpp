@@ -256,6 +256,61 @@ TEST_F(RadiatorWarehouseTestFixture, CombinedStateMultipleRadiators)
   EXPECT_NEAR(combined.optical_depth[0][0], o3_tau + no2_tau, 1e-20);
 }
 
+TEST_F(RadiatorWarehouseTestFixture, CombinedStateMatchesSequentialAccumulate)
+{
+  RadiatorWarehouse warehouse;
+  warehouse.Add(MakeTestRadiator("O3", 1e-18));
+  warehouse.Add(MakeTestRadiator("NO2", 2e-18));
+  warehouse.UpdateAll(grids_, profiles_);
+
+  RadiatorState accumulated;
+  accumulated.Accumulate(warehouse.Get("O3").State());
+  accumulated.Accumulate(warehouse.Get("NO2").State());
+
+  auto combined = warehouse.CombinedState();
+  for (std::size_t i = 0; i < combined.NumberOfLayers(); ++i)
+  {
+    for (std::size_t j = 0; j < combined.NumberOfWavelengths(); ++j)
+    {
+      EXPECT_DOUBLE_EQ(combined.optical_depth[i][j], accumulated.optical_depth[i][j]);
+      EXPECT_NEAR(combined.single_scattering_albedo[i][j], accumulated.single_scattering_albedo[i][j], 1e-15);
+      EXPECT_NEAR(combined.asymmetry_factor[i][j], accumulated.asymmetry_factor[i][j], 1e-15);
+    }
+  }
+}
+
+TEST_F(RadiatorWarehouseTestFixture, CombinedStateBitIdenticalAcrossThreadCounts)
+{
+  RadiatorWarehouse warehouse;
+  warehouse.Add(MakeTestRadiator("O3", 1e-18));
+  warehouse.Add(MakeTestRadiator("NO2", 2e-18));
+  warehouse.UpdateAll(grids_, profiles_);
+
+  auto serial = warehouse.CombinedState();
+  for (std::size_t n_threads : { 1u, 2u, 4u, 8u })
+  {
+    ThreadPool pool(n_threads);
+    auto threaded = warehouse.CombinedState(pool);
+    EXPECT_EQ(threaded.optical_depth, serial.optical_depth);
+    EXPECT_EQ(threaded.single_scattering_albedo, serial.single_scattering_albedo);
+    EXPECT_EQ(threaded.asymmetry_factor, serial.asymmetry_factor);
+  }
+}
+
+TEST_F(RadiatorWarehouseTestFixture, CloneIsIndependent)
+{
+  RadiatorWarehouse warehouse;
+  warehouse.Add(MakeTestRadiator("O3", 1e-18));
+  warehouse.UpdateAll(grids_, profiles_);
+
+  auto copy = warehouse.Clone();
+  ASSERT_EQ(copy.Size(), 1u);
+  EXPECT_NE(&copy.Get("O3"), &warehouse.Get("O3"));
+
+  copy.UpdateAll(grids_, profiles_);
+  EXPECT_EQ(copy.CombinedState().optical_depth, warehouse.CombinedState().optical_depth);
+}
+
 TEST_F(RadiatorWarehouseTestFixture, CombinedStateBeforeUpdate)
 {
   RadiatorWarehouse warehouse;
@@ -0,0 +1,241 @@
+#include <tuvx/cross_section/types/o3.hpp>
+#include <tuvx/model/batch_driver.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/quantum_yield/types/o3_o1d.hpp>
+#include <tuvx/service/photolysis_client.hpp>
+#include <tuvx/service/photolysis_server.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+using namespace tuvx;
+
+class PhotolysisServiceTest : public ::testing::Test
+{
+ protected:
+  void SetUp() override
+  {
+    ModelConfig config;
+    config.n_wavelength_bins = 20;
+    config.wavelength_min = 280.0;
+    config.wavelength_max = 400.0;
+    config.n_altitude_layers = 10;
+    model_ = std::make_unique<TuvModel>(config);
+    model_->AddStandardRadiators();
+    model_->AddPhotolysisReaction("O3 -> O2 + O(1D)", &o3_xs_, &o3_qy_);
+    model_->AddPhotolysisReaction("O3 -> O2 + O(3P)", &o3_xs_, &o3p_qy_);
+
+    n_layers_ = model_->AltitudeGrid().Spec().n_cells;
+    n_levels_ = n_layers_ + 1;
+    auto mid = model_->AltitudeGrid().Midpoints();
+    std::vector<double> midpoints(mid.begin(), mid.end());
+    for (std::size_t c = 0; c < kColumns; ++c)
+    {
+      sza_.push_back(5.0 + 10.0 * static_cast<double>(c));
+      albedo_.push_back(0.05 + 0.05 * static_cast<double>(c));
+      auto ozone = StandardAtmosphere::GenerateOzoneProfile(midpoints, 250.0 + 20.0 * static_cast<double>(c));
+      ozone_.insert(ozone_.end(), ozone.begin(), ozone.end());
+    }
+    socket_path_ = "/tmp/tuvx_test_service_" + std::to_string(getpid()) + ".sock";
+  }
+
+  /// Batch with per-column SZA, albedo and ozone; temperature and density from the model
+  ColumnBatchView Batch() const
+  {
+    ColumnBatchView batch;
+    batch.n_columns = kColumns;
+    batch.n_layers = n_layers_;
+    batch.solar_zenith_angle = StridedView<const double>(sza_.data(), kColumns);
+    batch.surface_albedo = StridedView<const double>(albedo_.data(), kColumns);
+    batch.ozone = { ozone_.data(), static_cast<std::ptrdiff_t>(n_layers_), 1 };
+    return batch;
+  }
+
+  RateBatchView Rates(std::vector<double>& j) const
+  {
+    j.assign(kColumns * 2 * n_levels_, -1.0);
+    auto levels = static_cast<std::ptrdiff_t>(n_levels_);
+    return { j.data(), 2 * levels, levels, 1 };
+  }
+
+  static constexpr std::size_t kColumns = 6;
+  O3CrossSection o3_xs_;
+  O3O1DQuantumYield o3_qy_;
+  O3O3PQuantumYield o3p_qy_;
+  std::unique_ptr<TuvModel> model_;
+  std::size_t n_layers_{ 0 };
+  std::size_t n_levels_{ 0 };
+  std::vector<double> sza_, albedo_, ozone_;
+  std::string socket_path_;
+};
+
+TEST_F(PhotolysisServiceTest, ClientMatchesBatchDriver)
+{
+  std::vector<double> expected;
+  BatchDriver(*model_).Calculate(Batch(), Rates(expected));
+
+  ThreadPool pool(2);
+  PhotolysisServer server(*model_, pool, { socket_path_ });
+  server.Start();
+
+  PhotolysisClient client(socket_path_);
+  EXPECT_EQ(client.NumberOfLayers(), n_layers_);
+  EXPECT_EQ(client.NumberOfLevels(), n_levels_);
+  EXPECT_EQ(client.ReactionNames(), (std::vector<std::string>{ "O3 -> O2 + O(1D)", "O3 -> O2 + O(3P)" }));
+
+  std::vector<double> j;
+  client.Calculate(Batch(), Rates(j));
+  EXPECT_EQ(j, expected);
+
+  // Level-major output layout is filled through the view
+  std::vector<double> level_major(expected.size());
+  RateBatchView strided{ level_major.data(),
+                         1,
+                         static_cast<std::ptrdiff_t>(n_levels_ * kColumns),
+                         static_cast<std::ptrdiff_t>(kColumns) };
+  client.Calculate(Batch(), strided);
+  EXPECT_EQ(level_major[n_levels_ * kColumns + 3 * kColumns + 2], expected[2 * 2 * n_levels_ + n_levels_ + 3]);
+
+  auto stats = server.Stats();
+  EXPECT_EQ(stats.connections, 1u);
+  EXPECT_EQ(stats.requests, 2u);
+  EXPECT_EQ(stats.columns, 2 * kColumns);
+}
+
+TEST_F(PhotolysisServiceTest, ServesConcurrentClients)
+{
+  std::vector<double> expected;
+  BatchDriver(*model_).Calculate(Batch(), Rates(expected));
+
+  ThreadPool pool(2);
+  PhotolysisServer server(*model_, pool, { socket_path_ });
+  server.Start();
+
+  const std::size_t n_clients = 4;
+  const std::size_t n_requests = 5;
+  std::vector<std::size_t> matches(n_clients, 0);
+  std::vector<std::thread> clients;
+  for (std::size_t i = 0; i < n_clients; ++i)
+  {
+    clients.emplace_back(
+        [&, i]
+        {
+          PhotolysisClient client(socket_path_);
+          std::vector<double> j;
+          for (std::size_t r = 0; r < n_requests; ++r)
+          {
+            client.Calculate(Batch(), Rates(j));
+            matches[i] += j == expected ? 1 : 0;
+          }
+        });
+  }
+  for (auto& client : clients)
+  {
+    client.join();
+  }
+  for (std::size_t i = 0; i < n_clients; ++i)
+  {
+    EXPECT_EQ(matches[i], n_requests) << "client " << i;
+  }
+  EXPECT_EQ(server.Stats().requests, n_clients * n_requests);
+}
+
+TEST_F(PhotolysisServiceTest, ReportsErrors)
+{
+  EXPECT_THROW(PhotolysisClient{ socket_path_ }, std::runtime_error);
+
+  ThreadPool pool(1);
+  PhotolysisServerConfig config{ socket_path_ };
+  config.max_columns_per_request = kColumns - 1;
+  PhotolysisServer server(*model_, pool, config);
+  server.Start();
+  PhotolysisClient client(socket_path_);
+
+  // Oversized batch is rejected by the server; the connection stays usable
+  std::vector<double> j;
+  EXPECT_THROW(client.Calculate(Batch(), Rates(j)), std::runtime_error);
+  EXPECT_EQ(server.Stats().errors, 1u);
+  ColumnBatchView small = Batch();
+  small.n_columns = 2;
+  client.Calculate(small, Rates(j));
+  EXPECT_GT(j[0], 0.0);
+
+  // Grid mismatch is caught by the client
+  ColumnBatchView wrong = Batch();
+  wrong.n_layers = n_layers_ + 1;
+  EXPECT_THROW(client.Calculate(wrong, Rates(j)), std::invalid_argument);
+
+  server.Stop();
+  EXPECT_THROW(client.Calculate(small, Rates(j)), std::runtime_error);
+}
+
+TEST_F(PhotolysisServiceTest, LeavesOtherFilesAtSocketPath)
+{
+  std::FILE* file = std::fopen(socket_path_.c_str(), "w");
+  ASSERT_NE(file, nullptr);
+  std::fclose(file);
+
+  ThreadPool pool(1);
+  EXPECT_THROW(PhotolysisServer(*model_, pool, { socket_path_ }), std::runtime_error);
+  struct stat info;
+  ASSERT_EQ(::lstat(socket_path_.c_str(), &info), 0);
+  EXPECT_TRUE(S_ISREG(info.st_mode));
+  ::unlink(socket_path_.c_str());
+
+  // A stale socket left by an earlier server is replaced
+  {
+    PhotolysisServer first(*model_, pool, { socket_path_ });
+  }
+  int stale = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un address;
+  ASSERT_TRUE(service::MakeAddress(socket_path_, address));
+  ASSERT_EQ(::bind(stale, reinterpret_cast<const sockaddr*>(&address), sizeof(address)), 0);
+  ::close(stale);
+  PhotolysisServer server(*model_, pool, { socket_path_ });
+  server.Start();
+  EXPECT_EQ(PhotolysisClient(socket_path_).NumberOfLayers(), n_layers_);
+}
+
+TEST(ServiceProtocolTest, RejectsOversizedStringLength)
+{
+  service::Payload payload;
+  payload.PutCount(~std::uint64_t{ 0 });
+  payload.PutCount(0);
+  std::string value;
+  EXPECT_FALSE(payload.GetString(value));
+
+  payload.Clear();
+  payload.PutString("photolysis");
+  EXPECT_TRUE(payload.GetString(value));
+  EXPECT_EQ(value, "photolysis");
+}
+
+TEST(ServiceProtocolTest, HeaderAloneDoesNotAllocateWholePayload)
+{
+  int fds[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+  service::Header header;
+  header.type = static_cast<std::uint16_t>(service::MessageType::Calculate);
+  header.payload_words = std::size_t{ 1 } << 24;
+  ASSERT_TRUE(service::SendAll(fds[0], &header, sizeof(header)));
+  double words[3] = { 1.0, 2.0, 3.0 };
+  ASSERT_TRUE(service::SendAll(fds[0], words, sizeof(words)));
+  ::close(fds[0]);
+
+  service::Payload payload;
+  service::MessageType type{};
+  EXPECT_EQ(service::ReceiveMessage(fds[1], header.payload_words, type, payload), service::ReceiveStatus::Closed);
+  EXPECT_LE(payload.Size(), service::kReceiveChunkWords);
+  ::close(fds[1]);
+}
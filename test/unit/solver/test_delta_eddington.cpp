@@ -208,6 +208,32 @@ TEST(DeltaEddingtonTest, ConservativeScattering)
   EXPECT_GT(result.diffuse_down[0][0], 0.0);
 }
 
+TEST(DeltaEddingtonTest, ConservativeForwardScatteringIsFinite)
+{
+  DeltaEddingtonSolver solver;
+
+  // omega = 1 with strong forward scattering: the two-stream radicand
+  // gamma1^2 - gamma2^2 is zero analytically and can round below zero
+  auto state = CreateSimpleState(3, 1, 0.5, 1.0, 0.85);
+
+  std::vector<double> etr = { 1e15 };
+  std::vector<double> albedo = { 0.3 };
+
+  SolverInput input;
+  input.radiator_state = &state;
+  input.solar_zenith_angle = 40.0;
+  input.extraterrestrial_flux = &etr;
+  input.surface_albedo = &albedo;
+
+  auto result = solver.Solve(input);
+
+  for (std::size_t level = 0; level < 4; ++level)
+  {
+    EXPECT_TRUE(std::isfinite(result.actinic_flux_diffuse[level][0]));
+    EXPECT_TRUE(std::isfinite(result.diffuse_up[level][0]));
+  }
+}
+
 // ============================================================================
 // Surface Reflection Tests
 // ============================================================================
@@ -421,3 +447,83 @@ TEST(DeltaEddingtonTest, WithSphericalGeometry)
   EXPECT_FALSE(result.Empty());
   EXPECT_GT(result.direct_irradiance[0][0], 0.0);
 }
+
+// ============================================================================
+// Batched Solve Tests
+// ============================================================================
+
+TEST(DeltaEddingtonTest, SolveBatchMatchesSolve)
+{
+  DeltaEddingtonSolver solver;
+
+  auto thin = CreateSimpleState(4, 3, 0.1, 0.9, 0.7);
+  auto thick = CreateSimpleState(4, 3, 1.5, 0.3, 0.2);
+  auto short_column = CreateSimpleState(2, 2, 0.5, 0.5, 0.5);
+  std::vector<double> etr = { 1e15, 2e15, 3e15 };
+  std::vector<double> albedo = { 0.1, 0.2, 0.3 };
+
+  std::vector<SolverInput> inputs(5);
+  inputs[0].radiator_state = &thin;
+  inputs[1].radiator_state = &thick;
+  inputs[2].radiator_state = &short_column;
+  inputs[3].radiator_state = &thin;
+  inputs[3].solar_zenith_angle = 95.0;
+  inputs[4].radiator_state = nullptr;
+  for (auto& input : inputs)
+  {
+    input.solar_zenith_angle = input.solar_zenith_angle == 0.0 ? 40.0 : input.solar_zenith_angle;
+    input.extraterrestrial_flux = &etr;
+    input.surface_albedo = &albedo;
+  }
+
+  std::vector<RadiationField> fields(inputs.size());
+  solver.SolveBatch(inputs, fields);
+  for (std::size_t m = 0; m < inputs.size(); ++m)
+  {
+    auto expected = solver.Solve(inputs[m]);
+    EXPECT_EQ(fields[m].actinic_flux_direct, expected.actinic_flux_direct) << "column " << m;
+    EXPECT_EQ(fields[m].actinic_flux_diffuse, expected.actinic_flux_diffuse) << "column " << m;
+    EXPECT_EQ(fields[m].diffuse_up, expected.diffuse_up) << "column " << m;
+  }
+  EXPECT_TRUE(fields[4].Empty());
+
+  std::vector<RadiationField> too_few(2);
+  EXPECT_THROW(solver.SolveBatch(inputs, too_few), TuvxInternalException);
+}
+
+TEST(DeltaEddingtonTest, WorkspaceSolveMatchesSolve)
+{
+  DeltaEddingtonSolver solver;
+
+  auto thin = CreateSimpleState(4, 3, 0.1, 0.9, 0.7);
+  auto short_column = CreateSimpleState(2, 2, 0.5, 0.5, 0.5);
+  std::vector<double> etr = { 1e15, 2e15, 3e15 };
+  SphericalGeometry::SlantPathResult geom;
+  geom.enhancement_factor = { 2.0, 1.8, 1.5, 1.2 };
+
+  std::vector<SolverInput> inputs(3);
+  inputs[0].radiator_state = &thin;
+  inputs[1].radiator_state = &short_column;
+  inputs[2].radiator_state = &thin;
+  inputs[2].geometry = &geom;
+  // One workspace carried across columns of different shapes
+  SolverWorkspace workspace;
+  for (auto& input : inputs)
+  {
+    input.solar_zenith_angle = 50.0;
+    input.extraterrestrial_flux = &etr;
+    input.workspace = &workspace;
+  }
+
+  RadiationField field;
+  for (std::size_t m = 0; m < inputs.size(); ++m)
+  {
+    solver.SolveInto(inputs[m], field);
+    SolverInput without_workspace = inputs[m];
+    without_workspace.workspace = nullptr;
+    auto expected = solver.Solve(without_workspace);
+    EXPECT_EQ(field.actinic_flux_direct, expected.actinic_flux_direct) << "column " << m;
+    EXPECT_EQ(field.actinic_flux_diffuse, expected.actinic_flux_diffuse) << "column " << m;
+    EXPECT_EQ(field.diffuse_up, expected.diffuse_up) << "column " << m;
+  }
+}
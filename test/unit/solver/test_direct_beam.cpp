@@ -0,0 +1,65 @@
+#include <tuvx/solver/delta_eddington.hpp>
+#include <tuvx/solver/direct_beam.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace tuvx;
+
+namespace
+{
+  /// Optical properties that vary smoothly across wavelength, as real spectra do
+  RadiatorState CreateSmoothState(std::size_t n_layers, std::size_t n_wavelengths)
+  {
+    RadiatorState state;
+    state.Initialize(n_layers, n_wavelengths);
+    for (std::size_t i = 0; i < n_layers; ++i)
+    {
+      for (std::size_t j = 0; j < n_wavelengths; ++j)
+      {
+        double absorption = 0.2 * std::exp(-0.08 * static_cast<double>(j)) * (1.0 + 0.1 * static_cast<double>(i % 4));
+        double scattering = 0.05 * std::pow(300.0 / (300.0 + 5.0 * static_cast<double>(j)), 4.0);
+        state.optical_depth[i][j] = absorption + scattering;
+        state.single_scattering_albedo[i][j] = scattering / (absorption + scattering);
+        state.asymmetry_factor[i][j] = i < 3 ? 0.7 : 0.0;
+      }
+    }
+    return state;
+  }
+}  // namespace
+
+TEST(DirectBeamSolverTest, MatchesDeltaEddingtonDirectBeam)
+{
+  RadiatorState state = CreateSmoothState(10, 40);
+  std::vector<double> albedo(40, 0.2);
+  std::vector<double> flux(40, 3.0e14);
+  DirectBeamSolver direct;
+  DeltaEddingtonSolver full;
+  EXPECT_EQ(direct.Name(), "direct_beam");
+
+  for (double sza : { 0.0, 60.0 })
+  {
+    SolverInput input{ &state, nullptr, &albedo, &flux, sza };
+    RadiationField beam = direct.Solve(input);
+    RadiationField reference = full.Solve(input);
+    EXPECT_EQ(beam.direct_irradiance, reference.direct_irradiance);
+    EXPECT_EQ(beam.actinic_flux_direct, reference.actinic_flux_direct);
+    for (std::size_t l = 0; l < beam.NumberOfLevels(); ++l)
+    {
+      for (std::size_t j = 0; j < 40; ++j)
+      {
+        EXPECT_EQ(beam.diffuse_down[l][j], 0.0);
+        EXPECT_EQ(beam.diffuse_up[l][j], 0.0);
+        EXPECT_EQ(beam.actinic_flux_diffuse[l][j], 0.0);
+      }
+    }
+  }
+
+  SolverInput night{ &state, nullptr, &albedo, &flux, 95.0 };
+  RadiationField dark = direct.Solve(night);
+  EXPECT_EQ(dark.NumberOfLevels(), 11u);
+  EXPECT_EQ(dark.TotalActinicFlux(10), std::vector<double>(40, 0.0));
+}
@@ -0,0 +1,196 @@
+#include <tuvx/cross_section/types/o3.hpp>
+#include <tuvx/model/pca_accuracy.hpp>
+#include <tuvx/quantum_yield/types/o3_o1d.hpp>
+#include <tuvx/solver/delta_eddington.hpp>
+#include <tuvx/solver/direct_beam.hpp>
+#include <tuvx/solver/pca_solver.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace tuvx;
+
+namespace
+{
+  /// Optical properties that vary smoothly across wavelength, as real spectra do
+  RadiatorState CreateSmoothState(std::size_t n_layers, std::size_t n_wavelengths)
+  {
+    RadiatorState state;
+    state.Initialize(n_layers, n_wavelengths);
+    for (std::size_t i = 0; i < n_layers; ++i)
+    {
+      for (std::size_t j = 0; j < n_wavelengths; ++j)
+      {
+        double absorption = 0.2 * std::exp(-0.08 * static_cast<double>(j)) * (1.0 + 0.1 * static_cast<double>(i % 4));
+        double scattering = 0.05 * std::pow(300.0 / (300.0 + 5.0 * static_cast<double>(j)), 4.0);
+        state.optical_depth[i][j] = absorption + scattering;
+        state.single_scattering_albedo[i][j] = scattering / (absorption + scattering);
+        state.asymmetry_factor[i][j] = i < 3 ? 0.7 : 0.0;
+      }
+    }
+    return state;
+  }
+
+  /// Largest relative difference of the total actinic flux over all levels and wavelengths
+  double MaxActinicError(const RadiationField& actual, const RadiationField& expected)
+  {
+    double max_error = 0.0;
+    for (std::size_t l = 0; l < expected.NumberOfLevels(); ++l)
+    {
+      auto a = actual.TotalActinicFlux(l);
+      auto e = expected.TotalActinicFlux(l);
+      for (std::size_t j = 0; j < e.size(); ++j)
+      {
+        max_error = std::max(max_error, std::abs(a[j] - e[j]) / e[j]);
+      }
+    }
+    return max_error;
+  }
+}  // namespace
+
+TEST(PcaSolverTest, LeadingEigenvectors)
+{
+  // Eigenvalues 4, 2 and 0 with known eigenvectors
+  double r = 1.0 / std::sqrt(2.0);
+  std::vector<double> matrix = { 3.0, 1.0, 0.0, 1.0, 3.0, 0.0, 0.0, 0.0, 0.0 };
+  detail::EigenScratch scratch;
+  ASSERT_EQ(detail::LeadingEigenvectors(matrix.data(), 3, 3, 50, scratch), 2u);
+  const double* first = scratch.vectors.data();
+  const double* second = scratch.vectors.data() + 3;
+  EXPECT_NEAR(scratch.values[0], 4.0, 1e-10);
+  EXPECT_NEAR(scratch.values[1], 2.0, 1e-10);
+  EXPECT_NEAR(std::abs(first[0]), r, 1e-6);
+  EXPECT_NEAR(first[0], first[1], 1e-6);
+  EXPECT_NEAR(second[0], -second[1], 1e-6);
+  EXPECT_NEAR(second[2], 0.0, 1e-6);
+
+  std::vector<double> zero(4, 0.0);
+  EXPECT_EQ(detail::LeadingEigenvectors(zero.data(), 2, 1, 10, scratch), 0u);
+  EXPECT_TRUE(scratch.values.empty());
+}
+
+TEST(PcaSolverTest, CloseToFullSolve)
+{
+  RadiatorState state = CreateSmoothState(20, 60);
+  std::vector<double> albedo(60, 0.1);
+  std::vector<double> flux(60, 1.0e14);
+  SolverInput input{ &state, nullptr, &albedo, &flux, 30.0 };
+  RadiationField reference = DeltaEddingtonSolver().Solve(input);
+
+  PcaSolver pca;
+  EXPECT_EQ(pca.Name(), "pca_delta_eddington");
+  EXPECT_EQ(pca.NumberOfBins(60), 3u);
+  EXPECT_EQ(pca.AccurateSolves(60), 15u);
+  RadiationField field = pca.Solve(input);
+  EXPECT_EQ(field.direct_irradiance, reference.direct_irradiance);
+  EXPECT_LT(MaxActinicError(field, reference), 1e-2);
+
+  // The correction is what brings the direct beam close
+  EXPECT_GT(MaxActinicError(DirectBeamSolver().Solve(input), reference), 1e-2);
+
+  // First order needs fewer solves and is less accurate
+  PcaSolverConfig first_order;
+  first_order.second_order = false;
+  PcaSolver linear(first_order);
+  EXPECT_EQ(linear.AccurateSolves(60), 9u);
+  double linear_error = MaxActinicError(linear.Solve(input), reference);
+  EXPECT_LT(linear_error, 5e-2);
+  EXPECT_GE(linear_error, MaxActinicError(field, reference));
+}
+
+TEST(PcaSolverTest, SmallBinsSolveExactly)
+{
+  RadiatorState state = CreateSmoothState(8, 12);
+  std::vector<double> albedo(12, 0.3);
+  std::vector<double> flux(12, 2.0e14);
+  SolverInput input{ &state, nullptr, &albedo, &flux, 45.0 };
+
+  PcaSolverConfig config;
+  config.bin_size = 4;
+  PcaSolver pca(config);
+  EXPECT_EQ(pca.AccurateSolves(12), 12u);
+  RadiationField field = pca.Clone()->Solve(input);
+  RadiationField reference = DeltaEddingtonSolver().Solve(input);
+  EXPECT_EQ(field.actinic_flux_diffuse, reference.actinic_flux_diffuse);
+  EXPECT_EQ(field.diffuse_up, reference.diffuse_up);
+
+  // Night and missing state match the accurate solver too
+  input.solar_zenith_angle = 100.0;
+  EXPECT_EQ(pca.Solve(input).TotalActinicFlux(0), std::vector<double>(12, 0.0));
+  input.radiator_state = nullptr;
+  EXPECT_TRUE(pca.Solve(input).Empty());
+}
+
+TEST(PcaSolverTest, RejectsInvalidConfig)
+{
+  PcaSolverConfig config;
+  config.bin_size = 0;
+  EXPECT_THROW(PcaSolver{ config }, std::invalid_argument);
+  EXPECT_THROW(PcaSolver(PcaSolverConfig{}, nullptr, std::make_unique<DirectBeamSolver>()), std::invalid_argument);
+}
+
+TEST(PcaSolverTest, ReportsAccuracyAgainstFullSolve)
+{
+  ModelConfig config;
+  config.n_altitude_layers = 20;
+  config.n_wavelength_bins = 60;
+  O3CrossSection o3_xs;
+  O3O1DQuantumYield o3_qy;
+  O3O3PQuantumYield o3p_qy;
+  TuvModel model(config);
+  model.AddStandardRadiators();
+  model.AddPhotolysisReaction("O3 -> O2 + O(1D)", &o3_xs, &o3_qy);
+  model.AddPhotolysisReaction("O3 -> O2 + O(3P)", &o3_xs, &o3p_qy);
+
+  PcaSolverConfig pca_config;
+  pca_config.bin_size = 10;
+  auto report = EvaluatePcaSolver(model, pca_config, 10, 3);
+  EXPECT_EQ(report.n_wavelengths, 60u);
+  EXPECT_EQ(report.n_bins, 6u);
+  EXPECT_EQ(report.accurate_solves, 30u);
+  ASSERT_EQ(report.reactions.size(), 2u);
+  EXPECT_EQ(report.reactions[0].n_values, 10u * 21u);
+  EXPECT_LT(report.reactions[0].rms_relative_error, 0.015) << report.Summary();
+  EXPECT_LT(report.reactions[1].rms_relative_error, 0.001) << report.Summary();
+  EXPECT_GT(report.full_seconds, 0.0);
+  EXPECT_GT(report.pca_seconds, 0.0);
+}
+
+TEST(PcaSolverTest, BinsFollowOpticalDepthNotWavelength)
+{
+  // Alternate two absorption regimes across the spectrum, as line structure does
+  const std::size_t n_wavelengths = 60;
+  RadiatorState state = CreateSmoothState(20, n_wavelengths);
+  for (std::size_t i = 0; i < 20; ++i)
+  {
+    for (std::size_t j = 1; j < n_wavelengths; j += 2)
+    {
+      double scattering = state.optical_depth[i][j] * state.single_scattering_albedo[i][j];
+      state.optical_depth[i][j] = 5.0 * state.optical_depth[i][j];
+      state.single_scattering_albedo[i][j] = scattering / state.optical_depth[i][j];
+    }
+  }
+  std::vector<double> albedo(n_wavelengths, 0.1);
+  std::vector<double> flux(n_wavelengths, 1.0e14);
+  SolverInput input{ &state, nullptr, &albedo, &flux, 30.0 };
+  RadiationField reference = DeltaEddingtonSolver().Solve(input);
+
+  // Runs of adjacent wavelengths would mix both regimes in every bin and be off by about 4%
+  PcaSolverConfig config;
+  config.bin_size = 10;
+  PcaSolver pca(config);
+  RadiationField field = pca.Solve(input);
+  EXPECT_LT(MaxActinicError(field, reference), 2.5e-2);
+
+  // Buffers kept from the first solve give the same answer, as do a copy's
+  RadiationField again;
+  pca.SolveInto(input, again);
+  EXPECT_EQ(again.actinic_flux_diffuse, field.actinic_flux_diffuse);
+  EXPECT_EQ(pca.Clone()->Solve(input).diffuse_up, field.diffuse_up);
+}
@@ -0,0 +1,147 @@
+#include <tuvx/cross_section/types/o3.hpp>
+#include <tuvx/model/static_shape_model.hpp>
+#include <tuvx/quantum_yield/types/o3_o1d.hpp>
+#include <tuvx/solver/delta_eddington.hpp>
+#include <tuvx/solver/static_delta_eddington.hpp>
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace tuvx;
+
+namespace
+{
+  using FixedSolver = StaticDeltaEddingtonSolver<10, 20>;
+
+  /// Radiator state with optical properties that vary by layer and wavelength
+  RadiatorState CreateVaryingState(std::size_t n_layers, std::size_t n_wavelengths)
+  {
+    RadiatorState state;
+    state.Initialize(n_layers, n_wavelengths);
+    for (std::size_t i = 0; i < n_layers; ++i)
+    {
+      for (std::size_t j = 0; j < n_wavelengths; ++j)
+      {
+        state.optical_depth[i][j] = 0.05 + 0.01 * std::sin(0.3 * i + 0.7 * j);
+        state.single_scattering_albedo[i][j] = (i + j) % 5 == 0 ? 0.0 : 0.2 + 0.07 * (j % 10);
+        state.asymmetry_factor[i][j] = 0.1 * (i % 7);
+      }
+    }
+    return state;
+  }
+
+  void ExpectIdentical(const RadiationField& actual, const RadiationField& expected)
+  {
+    EXPECT_EQ(actual.direct_irradiance, expected.direct_irradiance);
+    EXPECT_EQ(actual.diffuse_down, expected.diffuse_down);
+    EXPECT_EQ(actual.diffuse_up, expected.diffuse_up);
+    EXPECT_EQ(actual.actinic_flux_direct, expected.actinic_flux_direct);
+    EXPECT_EQ(actual.actinic_flux_diffuse, expected.actinic_flux_diffuse);
+  }
+}  // namespace
+
+TEST(StaticDeltaEddingtonTest, MatchesDynamicSolver)
+{
+  constexpr std::size_t kLayers = 12;
+  constexpr std::size_t kWavelengths = 30;
+  RadiatorState state = CreateVaryingState(kLayers, kWavelengths);
+  std::vector<double> albedo(kWavelengths, 0.3);
+  std::vector<double> flux(kWavelengths);
+  for (std::size_t j = 0; j < kWavelengths; ++j)
+  {
+    flux[j] = 1e14 * (1.0 + 0.1 * j);
+  }
+
+  DeltaEddingtonSolver dynamic;
+  StaticDeltaEddingtonSolver<kLayers, kWavelengths> fixed;
+  EXPECT_EQ(fixed.Name(), dynamic.Name());
+
+  for (double sza : { 0.0, 45.0, 80.0, 95.0 })
+  {
+    SolverInput input;
+    input.radiator_state = &state;
+    input.solar_zenith_angle = sza;
+    input.surface_albedo = &albedo;
+    input.extraterrestrial_flux = &flux;
+    ExpectIdentical(fixed.Solve(input), dynamic.Solve(input));
+
+    // Short inputs fall back to the same defaults
+    std::vector<double> short_albedo(5, 0.5);
+    input.surface_albedo = &short_albedo;
+    input.extraterrestrial_flux = nullptr;
+    ExpectIdentical(fixed.Solve(input), dynamic.Solve(input));
+  }
+
+  auto clone = fixed.Clone();
+  SolverInput input;
+  input.radiator_state = &state;
+  input.solar_zenith_angle = 30.0;
+  ExpectIdentical(clone->Solve(input), dynamic.Solve(input));
+}
+
+TEST(StaticDeltaEddingtonTest, RejectsOtherShapes)
+{
+  RadiatorState state = CreateVaryingState(10, 20);
+  SolverInput input;
+  input.radiator_state = &state;
+  input.solar_zenith_angle = 30.0;
+
+  EXPECT_THROW((StaticDeltaEddingtonSolver<10, 21>().Solve(input)), std::invalid_argument);
+  EXPECT_THROW((StaticDeltaEddingtonSolver<11, 20>().Solve(input)), std::invalid_argument);
+
+  RadiatorState empty;
+  input.radiator_state = &empty;
+  EXPECT_TRUE((StaticDeltaEddingtonSolver<10, 20>().Solve(input).Empty()));
+}
+
+TEST(StaticShapeModelTest, MatchesDynamicModel)
+{
+  ModelConfig config;
+  config.n_wavelength_bins = 20;
+  config.n_altitude_layers = 10;
+
+  O3CrossSection xs;
+  O3O1DQuantumYield qy;
+  TuvModel dynamic(config);
+  dynamic.AddStandardRadiators().AddAerosolRadiator();
+  dynamic.AddPhotolysisReaction("O3 -> O2 + O(1D)", &xs, &qy);
+
+  StaticShapeModel<10, 20> fixed(config);
+  fixed.AddStandardRadiators().AddAerosolRadiator();
+  fixed.AddPhotolysisReaction("O3 -> O2 + O(1D)", &xs, &qy);
+  EXPECT_NE(dynamic_cast<const FixedSolver*>(fixed.GetSolver()), nullptr);
+
+  for (double sza : { 0.0, 30.0, 70.0 })
+  {
+    auto expected = dynamic.Calculate(sza);
+    auto actual = fixed.Calculate(sza);
+    ExpectIdentical(actual.radiation_field, expected.radiation_field);
+    EXPECT_EQ(actual.photolysis_rates[0].rates, expected.photolysis_rates[0].rates);
+  }
+
+  // The solver survives reconfiguration and copies
+  fixed.SetConfig(config);
+  TuvModel copy(fixed);
+  EXPECT_NE(dynamic_cast<const FixedSolver*>(copy.GetSolver()), nullptr);
+  EXPECT_EQ(copy.Calculate(30.0).photolysis_rates[0].rates, dynamic.Calculate(30.0).photolysis_rates[0].rates);
+
+  // A grid with a different shape is rejected at calculation time
+  fixed.SetAltitudeGrid({ 0.0, 10.0, 20.0 });
+  EXPECT_THROW(fixed.Calculate(30.0), std::invalid_argument);
+}
+
+TEST(StaticShapeModelTest, RejectsMismatchedConfig)
+{
+  ModelConfig config;
+  config.n_wavelength_bins = 20;
+  config.n_altitude_layers = 10;
+  EXPECT_THROW((StaticShapeModel<10, 21>(config)), std::invalid_argument);
+  EXPECT_THROW((StaticShapeModel<11, 20>(config)), std::invalid_argument);
+
+  // The default configuration is the production shape
+  StaticShapeModel<80, 140> production;
+  EXPECT_EQ(production.AltitudeGrid().Spec().n_cells, 80u);
+}
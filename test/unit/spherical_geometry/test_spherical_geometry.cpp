@@ -358,3 +358,21 @@ TEST(SphericalGeometryTest, DeepTwilight)
   // Lower layers should be in shadow
   EXPECT_FALSE(result.sunlit[0]);
 }
+
+TEST(SphericalGeometryTest, CalculateIntoReusesResult)
+{
+  auto grid = CreateAltitudeGrid({ 0.0, 5.0, 10.0, 20.0, 50.0, 100.0, 200.0 });
+  SphericalGeometry geom(grid);
+
+  // Twilight leaves shadowed layers behind; the next angle must clear them
+  SphericalGeometry::SlantPathResult result;
+  for (double sza : { 105.0, 30.0, 88.0 })
+  {
+    geom.CalculateInto(sza, result);
+    auto expected = geom.Calculate(sza);
+    EXPECT_EQ(result.enhancement_factor, expected.enhancement_factor) << "SZA " << sza;
+    EXPECT_EQ(result.air_mass, expected.air_mass) << "SZA " << sza;
+    EXPECT_EQ(result.sunlit, expected.sunlit) << "SZA " << sza;
+    EXPECT_EQ(result.screening_height, expected.screening_height) << "SZA " << sza;
+  }
+}
@@ -1,7 +1,9 @@
 #include <tuvx/util/error.hpp>
 #include <tuvx/util/internal_error.hpp>
 
+#include <stdexcept>
 #include <string>
+#include <system_error>
 
 #include <gtest/gtest.h>
 
@@ -59,6 +61,20 @@ TEST(InternalErrorTest, ErrorMessage)
   EXPECT_EQ(message, "General internal error");
 }
 
+TEST(InternalErrorTest, CodesReuseErrorHeaderValues)
+{
+  std::error_code ec = tuvx::TuvxInternalErrc::GridNotFound;
+  EXPECT_EQ(ec.value(), TUVX_GRID_ERROR_CODE_GRID_NOT_FOUND);
+  EXPECT_EQ(ec.message(), "Grid not found");
+  EXPECT_EQ(std::error_code(tuvx::TuvxInternalErrc::ReactionNotFound).value(), TUVX_MODEL_ERROR_CODE_REACTION_NOT_FOUND);
+  EXPECT_TRUE(TUVX_EXCEPTIONS);
+}
+
+TEST(InternalErrorTest, ThrowMacroThrowsTheGivenException)
+{
+  EXPECT_THROW(TUVX_THROW(std::out_of_range("out")), std::out_of_range);
+}
+
 TEST(InternalErrorTest, ThrowInternalError)
 {
   EXPECT_THROW(
@@ -0,0 +1,98 @@
+// Compiled with -fno-exceptions (see test/unit/CMakeLists.txt): checks that the
+// library builds without exceptions, that the Try* accessors report failures
+// as error codes, and that errors which would throw abort with their message.
+
+#include <tuvx/tuvx.hpp>
+
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace tuvx;
+
+static_assert(TUVX_EXCEPTIONS == 0, "test_no_exceptions must be compiled with exceptions disabled");
+
+TEST(NoExceptionsTest, GridWarehouseTryGet)
+{
+  GridWarehouse warehouse;
+  GridSpec spec{ .name = "wavelength", .units = "nm", .n_cells = 10 };
+  GridHandle handle = warehouse.Add(Grid::EquallySpaced(spec, 200.0, 800.0));
+
+  const Grid* grid = nullptr;
+  EXPECT_FALSE(warehouse.TryGet("wavelength", "nm", grid));
+  ASSERT_NE(grid, nullptr);
+  EXPECT_EQ(grid->NumberOfCells(), 10u);
+  EXPECT_FALSE(warehouse.TryGet(handle, grid));
+
+  std::error_code error = warehouse.TryGet("wavelength", "m", grid);
+  EXPECT_EQ(error, TuvxInternalErrc::GridNotFound);
+  EXPECT_EQ(grid, nullptr);
+  EXPECT_EQ(warehouse.TryGet(GridHandle{}, grid), TuvxInternalErrc::InvalidHandle);
+}
+
+TEST(NoExceptionsTest, ProfileWarehouseTryGet)
+{
+  ProfileWarehouse warehouse;
+  ProfileSpec spec{ .name = "temperature", .units = "K", .n_cells = 4 };
+  ProfileHandle handle = warehouse.Add(Profile(spec, std::vector<double>(4, 250.0)));
+
+  const Profile* profile = nullptr;
+  EXPECT_FALSE(warehouse.TryGet(handle, profile));
+  ASSERT_NE(profile, nullptr);
+  EXPECT_EQ(warehouse.TryGet("ozone", "molecules/cm^3", profile), TuvxInternalErrc::ProfileNotFound);
+  EXPECT_EQ(profile, nullptr);
+}
+
+TEST(NoExceptionsTest, RadiatorStateTryAccumulate)
+{
+  RadiatorState a;
+  RadiatorState b;
+  RadiatorState mismatched;
+  a.Initialize(3, 5);
+  b.Initialize(3, 5);
+  mismatched.Initialize(4, 5);
+  a.optical_depth[0][0] = 1.0;
+  b.optical_depth[0][0] = 2.0;
+
+  EXPECT_FALSE(a.TryAccumulate(b));
+  EXPECT_DOUBLE_EQ(a.optical_depth[0][0], 3.0);
+  EXPECT_EQ(a.TryAccumulate(mismatched), TuvxInternalErrc::InvalidSize);
+  EXPECT_DOUBLE_EQ(a.optical_depth[0][0], 3.0);
+}
+
+TEST(NoExceptionsTest, ModelRunsAndOutputLookupsReportErrors)
+{
+  ModelConfig config;
+  config.n_wavelength_bins = 20;
+  config.n_altitude_layers = 10;
+  TuvModel model(config);
+  model.AddStandardRadiators();
+  O3CrossSection o3_xs;
+  O3O1DQuantumYield o3_qy;
+  model.AddPhotolysisReaction("O3 -> O2 + O(1D)", &o3_xs, &o3_qy);
+
+  ModelOutput output = model.Calculate(30.0);
+
+  const std::vector<double>* profile = nullptr;
+  ASSERT_FALSE(output.TryGetPhotolysisRateProfile("O3 -> O2 + O(1D)", profile));
+  ASSERT_EQ(profile->size(), 11u);
+  double rate = 0.0;
+  EXPECT_FALSE(output.TryGetPhotolysisRate("O3 -> O2 + O(1D)", 10, rate));
+  EXPECT_GT(rate, 0.0);
+  EXPECT_EQ(rate, output.GetPhotolysisRate("O3 -> O2 + O(1D)", 10));
+
+  EXPECT_EQ(output.TryGetPhotolysisRate("O3 -> O2 + O(1D)", 11, rate), TuvxInternalErrc::OutOfRange);
+  EXPECT_EQ(output.TryGetPhotolysisRateProfile("NO2 -> NO + O(3P)", profile), TuvxInternalErrc::ReactionNotFound);
+  EXPECT_EQ(profile, nullptr);
+}
+
+TEST(NoExceptionsDeathTest, ErrorsAbortWithMessage)
+{
+  GridWarehouse grids;
+  EXPECT_DEATH(grids.Get("wavelength", "nm"), "Grid not found in warehouse");
+
+  ModelOutput output;
+  EXPECT_DEATH(output.GetPhotolysisRate("missing", 0), "Reaction not found: missing");
+}
@@ -0,0 +1,161 @@
+#include <tuvx/util/numa.hpp>
+#include <tuvx/util/thread_pool.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace tuvx;
+
+namespace
+{
+  /// Write a fake /sys/devices/system/node tree
+  std::filesystem::path MakeSysfs(const std::string& name, const std::vector<std::string>& cpulists)
+  {
+    auto root = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove_all(root);
+    for (std::size_t node = 0; node < cpulists.size(); ++node)
+    {
+      auto dir = root / ("node" + std::to_string(node));
+      std::filesystem::create_directories(dir);
+      std::ofstream(dir / "cpulist") << cpulists[node] << "\n";
+    }
+    return root;
+  }
+
+  /// Restores the calling thread's CPU affinity when it goes out of scope
+  class AffinityGuard
+  {
+   public:
+    AffinityGuard()
+    {
+#if defined(__linux__)
+      sched_getaffinity(0, sizeof(set_), &set_);
+#endif
+    }
+
+    ~AffinityGuard()
+    {
+#if defined(__linux__)
+      sched_setaffinity(0, sizeof(set_), &set_);
+#endif
+    }
+
+   private:
+#if defined(__linux__)
+    cpu_set_t set_;
+#endif
+  };
+}  // namespace
+
+TEST(NumaTest, ParsesCpuLists)
+{
+  EXPECT_EQ(ParseCpuList("0-3,8,10-11\n"), (std::vector<int>{ 0, 1, 2, 3, 8, 10, 11 }));
+  EXPECT_EQ(ParseCpuList("5"), (std::vector<int>{ 5 }));
+  EXPECT_EQ(ParseCpuList("4,2,2-3"), (std::vector<int>{ 2, 3, 4 }));
+  EXPECT_TRUE(ParseCpuList("").empty());
+  EXPECT_TRUE(ParseCpuList("a-b").empty());
+  EXPECT_TRUE(ParseCpuList("3-1").empty());
+}
+
+TEST(NumaTest, DetectsNodesFromSysfs)
+{
+  std::vector<int> allowed = AllowedCpus();
+  ASSERT_FALSE(allowed.empty());
+  // Split the CPUs this process may use across two simulated nodes
+  std::string first = std::to_string(allowed.front());
+  std::string second = allowed.size() > 1 ? std::to_string(allowed.back()) : "";
+  auto root = MakeSysfs("tuvx_numa_two_nodes", { first, second });
+
+  NumaTopology topology = NumaTopology::Detect(root.string());
+  EXPECT_EQ(topology.NumberOfNodes(), allowed.size() > 1 ? 2u : 1u);
+  EXPECT_EQ(topology.Cpus(0), (std::vector<int>{ allowed.front() }));
+  std::filesystem::remove_all(root);
+}
+
+TEST(NumaTest, FallsBackToSingleNode)
+{
+  NumaTopology topology = NumaTopology::Detect("/nonexistent/tuvx/sysfs");
+  EXPECT_EQ(topology.NumberOfNodes(), 1u);
+  EXPECT_EQ(topology.Cpus(0), AllowedCpus());
+
+  // Nodes whose CPUs are all outside the affinity mask are ignored too
+  auto root = MakeSysfs("tuvx_numa_foreign", { "100000" });
+  EXPECT_EQ(NumaTopology::Detect(root.string()).NumberOfNodes(), 1u);
+  std::filesystem::remove_all(root);
+
+  EXPECT_GE(NumaTopology::Detect().NumberOfCpus(), 1u);
+  EXPECT_THROW(NumaTopology({ {}, {} }), std::invalid_argument);
+}
+
+TEST(NumaTest, PlacesWorkersInBlocksPerNode)
+{
+  NumaTopology topology({ { 0, 1 }, { 4, 5, 6 } });
+  WorkerPlacement placement(topology, 5);
+  EXPECT_EQ(placement.NumberOfNodes(), 2u);
+  std::vector<std::size_t> nodes;
+  std::vector<int> cpus;
+  for (std::size_t w = 0; w < placement.NumberOfWorkers(); ++w)
+  {
+    nodes.push_back(placement.Node(w));
+    cpus.push_back(placement.Cpu(w));
+  }
+  EXPECT_EQ(nodes, (std::vector<std::size_t>{ 0, 0, 1, 1, 1 }));
+  EXPECT_EQ(cpus, (std::vector<int>{ 0, 1, 4, 5, 6 }));
+
+  // More workers than CPUs wrap around within the node
+  WorkerPlacement crowded(NumaTopology(std::vector<std::vector<int>>{ { 2 } }), 3);
+  EXPECT_EQ(crowded.Cpu(2), 2);
+}
+
+TEST(NumaTest, PinsPoolThreads)
+{
+  AffinityGuard guard;
+  ThreadPool pool(2);
+  WorkerPlacement placement(NumaTopology::SingleNode(), pool.Size());
+  std::size_t pinned = placement.Pin(pool);
+#if defined(__linux__)
+  EXPECT_EQ(pinned, pool.Size());
+  std::vector<int> observed(pool.Size(), -1);
+  pool.ForEachWorker(
+      [&](std::size_t w)
+      {
+        auto cpus = AllowedCpus();
+        observed[w] = cpus.size() == 1 ? cpus[0] : -2;
+      });
+  for (std::size_t w = 0; w < pool.Size(); ++w)
+  {
+    EXPECT_EQ(observed[w], placement.Cpu(w));
+  }
+#else
+  EXPECT_EQ(pinned, 0u);
+#endif
+
+  ThreadPool wrong_size(3);
+  EXPECT_THROW(placement.Pin(wrong_size), std::invalid_argument);
+}
+
+TEST(NumaTest, BufferIsPageAlignedAndMovable)
+{
+  NumaBuffer<double> buffer(1000);
+  ASSERT_NE(buffer.Data(), nullptr);
+  EXPECT_EQ(buffer.Size(), 1000u);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(buffer.Data()) % NumaBuffer<double>::PageSize(), 0u);
+  buffer.FirstTouch(0, 1000, 2.5);
+  EXPECT_EQ(std::accumulate(buffer.Span().begin(), buffer.Span().end(), 0.0), 2500.0);
+
+  NumaBuffer<double> moved(std::move(buffer));
+  EXPECT_EQ(buffer.Data(), nullptr);
+  EXPECT_EQ(moved.Span()[999], 2.5);
+
+  // Huge pages are only a request; the buffer works either way
+  NumaBuffer<double> large(NumaBuffer<double>::kHugePageSize / sizeof(double), true);
+  large.FirstTouch(0, large.Size(), 1.0);
+  EXPECT_EQ(large.Span().back(), 1.0);
+  EXPECT_FALSE(NumaBuffer<double>(16, true).HugePages());
+}
@@ -0,0 +1,107 @@
+#include <tuvx/util/reproducible_sum.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace tuvx;
+
+namespace
+{
+  /// Values spanning many orders of magnitude with mixed signs, so any
+  /// change in association order shows up in the low bits
+  std::vector<double> WideRangeValues(std::size_t n, unsigned seed)
+  {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> mantissa(-1.0, 1.0);
+    std::uniform_int_distribution<int> exponent(-20, 20);
+    std::vector<double> values(n);
+    for (auto& v : values)
+    {
+      v = std::ldexp(mantissa(rng), exponent(rng));
+    }
+    return values;
+  }
+
+  bool BitIdentical(double a, double b)
+  {
+    return std::memcmp(&a, &b, sizeof(double)) == 0;
+  }
+}  // namespace
+
+TEST(ReproducibleSumTest, EmptyAndSingle)
+{
+  EXPECT_EQ(ReproducibleSum(std::span<const double>{}), 0.0);
+  std::vector<double> one = { 3.5 };
+  EXPECT_EQ(ReproducibleSum(one), 3.5);
+}
+
+TEST(ReproducibleSumTest, SmallSumsMatchSequentialLoop)
+{
+  auto values = WideRangeValues(kReproducibleSumBlockSize, 1);
+  double sequential = 0.0;
+  for (double v : values)
+  {
+    sequential += v;
+  }
+  EXPECT_TRUE(BitIdentical(ReproducibleSum(values), sequential));
+}
+
+TEST(ReproducibleSumTest, CallableMatchesSpan)
+{
+  auto values = WideRangeValues(1000, 2);
+  double from_span = ReproducibleSum(values);
+  double from_callable = ReproducibleSum(values.size(), [&](std::size_t i) { return values[i]; });
+  EXPECT_TRUE(BitIdentical(from_span, from_callable));
+}
+
+TEST(ReproducibleSumTest, BitIdenticalAcrossThreadCounts)
+{
+  for (std::size_t n : { 0u, 1u, 63u, 64u, 65u, 129u, 1000u, 4097u, 100003u })
+  {
+    auto values = WideRangeValues(n, static_cast<unsigned>(n) + 7);
+    auto term = [&](std::size_t i) { return values[i]; };
+    double serial = ReproducibleSum(n, term);
+
+    for (std::size_t n_threads : { 1u, 2u, 4u, 8u })
+    {
+      ThreadPool pool(n_threads);
+      double threaded = ReproducibleSum(n, term, pool);
+      EXPECT_TRUE(BitIdentical(serial, threaded)) << "n = " << n << ", threads = " << n_threads;
+    }
+  }
+}
+
+TEST(ReproducibleSumTest, RepeatedThreadedSumsAreStable)
+{
+  auto values = WideRangeValues(50000, 3);
+  ThreadPool pool(8);
+  double first = ReproducibleSum(values.size(), [&](std::size_t i) { return values[i]; }, pool);
+  for (int repeat = 0; repeat < 20; ++repeat)
+  {
+    double again = ReproducibleSum(values.size(), [&](std::size_t i) { return values[i]; }, pool);
+    EXPECT_TRUE(BitIdentical(first, again));
+  }
+}
+
+TEST(ReproducibleSumTest, MoreAccurateThanSequential)
+{
+  // 1 + n tiny values: sequential summation loses them to rounding
+  const std::size_t n = 1 << 20;
+  const double tiny = 1e-16;
+  auto term = [&](std::size_t i) { return i == 0 ? 1.0 : tiny; };
+
+  double sequential = 0.0;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    sequential += term(i);
+  }
+  double exact = 1.0 + static_cast<double>(n - 1) * tiny;
+  double pairwise = ReproducibleSum(n, term);
+
+  EXPECT_LT(std::abs(pairwise - exact), std::abs(sequential - exact));
+  EXPECT_NEAR(pairwise, exact, 1e-13);
+}
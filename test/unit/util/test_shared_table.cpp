@@ -0,0 +1,304 @@
+#include <tuvx/cross_section/types/o2.hpp>
+#include <tuvx/cross_section/types/o3.hpp>
+#include <tuvx/cross_section/types/shared.hpp>
+#include <tuvx/model/tuv_model.hpp>
+#include <tuvx/quantum_yield/types/o3_o1d.hpp>
+#include <tuvx/quantum_yield/types/shared.hpp>
+#include <tuvx/radiator/types/from_cross_section.hpp>
+#include <tuvx/util/shared_table.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+using namespace tuvx;
+
+namespace
+{
+  /// Segment name unique to this process and test
+  std::string SegmentName(const std::string& test)
+  {
+    std::string name = "/tuvx_test_" + test + "_" + std::to_string(getpid());
+    SharedTableSegment::Remove(name);
+    return name;
+  }
+
+  Grid WavelengthGrid()
+  {
+    GridSpec spec{ .name = "wavelength", .units = "nm", .n_cells = 40 };
+    return Grid::EquallySpaced(spec, 240.0, 340.0);
+  }
+}  // namespace
+
+TEST(SharedTableTest, PublishAndOpenRoundTrip)
+{
+  std::vector<double> matrix(12);
+  std::iota(matrix.begin(), matrix.end(), 1.0);
+  std::vector<double> vector{ 0.5, 1.5 };
+
+  SharedTableBuilder builder;
+  builder.Add("matrix", 3, 4, matrix);
+  builder.Add("vector", vector);
+  EXPECT_TRUE(builder.Contains("matrix"));
+  EXPECT_FALSE(builder.Contains("other"));
+  EXPECT_THROW(builder.Add("matrix", vector), std::invalid_argument);
+  EXPECT_THROW(builder.Add("bad", 2, 2, vector), std::invalid_argument);
+
+  std::string name = SegmentName("round_trip");
+  auto owner = builder.Publish(name);
+  EXPECT_TRUE(owner->Owner());
+  EXPECT_EQ(owner->Bytes(), builder.Bytes());
+
+  auto reader = SharedTableSegment::Open(name);
+  EXPECT_FALSE(reader->Owner());
+  EXPECT_EQ(reader->Size(), 2u);
+  EXPECT_EQ(reader->Names(), (std::vector<std::string>{ "matrix", "vector" }));
+
+  SharedTable table = reader->Get("matrix");
+  EXPECT_EQ(table.rows, 3u);
+  EXPECT_EQ(table.cols, 4u);
+  EXPECT_EQ(table.Row(2)[1], 10.0);
+  EXPECT_TRUE(std::equal(table.Values().begin(), table.Values().end(), matrix.begin(), matrix.end()));
+  EXPECT_EQ(reader->Get("vector").Values()[1], 1.5);
+
+  // Separate mapping of the same pages
+  EXPECT_NE(table.data, owner->Get("matrix").data);
+  EXPECT_TRUE(reader->Find("missing").Empty());
+  EXPECT_THROW(reader->Get("missing"), std::out_of_range);
+}
+
+TEST(SharedTableTest, NamesAreExclusiveAndRemovedByOwner)
+{
+  SharedTableBuilder builder;
+  builder.Add("x", std::vector<double>{ 1.0 });
+  std::string name = SegmentName("exclusive");
+  {
+    auto owner = builder.Publish(name);
+    EXPECT_THROW(builder.Publish(name), std::runtime_error);
+    auto reader = SharedTableSegment::Open(name);
+    owner.reset();
+    // An open mapping survives the owner removing the name
+    EXPECT_EQ(reader->Get("x").Values()[0], 1.0);
+    EXPECT_THROW(SharedTableSegment::Open(name), std::runtime_error);
+  }
+  EXPECT_FALSE(SharedTableSegment::Remove(name));
+}
+
+TEST(SharedTableTest, RejectsOverflowingTableShapes)
+{
+  // rows * cols wraps to zero in 64 bits
+  std::uint64_t rows = std::uint64_t{ 1 } << 33;
+  std::uint64_t cols = std::uint64_t{ 1 } << 31;
+  SharedTableBuilder builder;
+  EXPECT_THROW(builder.Add("wrapped", rows, cols, std::vector<double>{}), std::invalid_argument);
+
+  // A directory entry corrupted the same way is rejected on Open
+  builder.Add("x", std::vector<double>{ 1.0 });
+  std::string name = SegmentName("overflow");
+  auto owner = builder.Publish(name);
+  int fd = shm_open(name.c_str(), O_RDWR, 0);
+  ASSERT_GE(fd, 0);
+  void* memory = mmap(nullptr, owner->Bytes(), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  ASSERT_NE(memory, MAP_FAILED);
+  // The first entry follows the 64-byte aligned header: a 96-byte name, then offset, rows and cols
+  auto* entry = static_cast<std::byte*>(memory) + 64;
+  std::memcpy(entry + 104, &rows, sizeof(rows));
+  std::memcpy(entry + 112, &cols, sizeof(cols));
+  munmap(memory, owner->Bytes());
+  EXPECT_THROW(SharedTableSegment::Open(name), std::runtime_error);
+}
+
+TEST(SharedTableDeathTest, MappingIsReadOnly)
+{
+  SharedTableBuilder builder;
+  builder.Add("x", std::vector<double>{ 1.0 });
+  std::string name = SegmentName("read_only");
+  auto owner = builder.Publish(name);
+  auto reader = SharedTableSegment::Open(name);
+  double* writable = const_cast<double*>(reader->Get("x").data);
+  EXPECT_DEATH(*writable = 2.0, "");
+  double* owner_writable = const_cast<double*>(owner->Get("x").data);
+  EXPECT_DEATH(*owner_writable = 2.0, "");
+}
+
+TEST(SharedTableTest, SharedCrossSectionMatchesSource)
+{
+  Grid grid = WavelengthGrid();
+  O3CrossSection o3;
+  std::vector<double> temperatures{ 218.0, 228.0, 243.0, 273.0, 295.0 };
+
+  SharedTableBuilder builder;
+  BinCrossSection(builder, "O3", o3, grid, temperatures);
+  std::string name = SegmentName("cross_section");
+  auto owner = builder.Publish(name);
+  SharedCrossSection shared(SharedTableSegment::Open(name), "O3");
+  EXPECT_EQ(shared.Name(), "O3");
+
+  for (double temperature : temperatures)
+  {
+    EXPECT_EQ(shared.Calculate(grid, temperature), o3.Calculate(grid, temperature));
+  }
+  // Between and beyond binned temperatures
+  for (double temperature : { 235.0, 260.0, 180.0, 320.0 })
+  {
+    auto expected = o3.Calculate(grid, temperature);
+    auto actual = shared.Calculate(grid, temperature);
+    ASSERT_EQ(actual.size(), expected.size());
+    for (std::size_t i = 0; i < actual.size(); ++i)
+    {
+      EXPECT_NEAR(actual[i], expected[i], 1e-12 * std::abs(expected[i]) + 1e-30);
+    }
+  }
+
+  // A different grid is interpolated and zeroed outside the table
+  GridSpec spec{ .name = "wavelength", .units = "nm", .n_cells = 10 };
+  auto wide = shared.Calculate(Grid::EquallySpaced(spec, 200.0, 400.0), 250.0);
+  EXPECT_EQ(wide.front(), 0.0);
+  EXPECT_EQ(wide.back(), 0.0);
+  EXPECT_GT(wide[3], 0.0);
+
+  auto clone = shared.Clone();
+  EXPECT_EQ(clone->Calculate(grid, 243.0), o3.Calculate(grid, 243.0));
+
+  builder.Add("broken/wavelengths", std::vector<double>{ 1.0, 2.0 });
+  builder.Add("broken/temperatures", std::vector<double>{ 250.0 });
+  builder.Add("broken/values", std::vector<double>{ 1.0 });
+  std::string broken = SegmentName("broken");
+  auto broken_owner = builder.Publish(broken);
+  EXPECT_THROW(SharedCrossSection(broken_owner, "broken"), std::invalid_argument);
+  EXPECT_THROW(SharedCrossSection(broken_owner, "NO2"), std::out_of_range);
+}
+
+TEST(SharedTableTest, ModelWithSharedTablesMatchesModel)
+{
+  ModelConfig config;
+  config.n_wavelength_bins = 40;
+  config.wavelength_min = 240.0;
+  config.wavelength_max = 340.0;
+  config.n_altitude_layers = 20;
+
+  O3CrossSection o3_xs;
+  O3O1DQuantumYield o3_qy;
+  TuvModel reference(config);
+  reference.AddStandardRadiators();
+  reference.AddPhotolysisReaction("O3 -> O2 + O(1D)", &o3_xs, &o3_qy);
+
+  std::vector<double> temperatures;
+  for (double t = 180.0; t <= 320.0; t += 1.0)
+  {
+    temperatures.push_back(t);
+  }
+  Grid grid = reference.WavelengthGrid();
+  SharedTableBuilder builder;
+  BinCrossSection(builder, "O3", o3_xs, grid, temperatures);
+  BinQuantumYield(builder, "O3->O1D", o3_qy, grid, temperatures);
+  std::string name = SegmentName("model");
+  auto owner = builder.Publish(name);
+  auto tables = SharedTableSegment::Open(name);
+
+  SharedCrossSection shared_xs(tables, "O3");
+  SharedQuantumYield shared_qy(tables, "O3->O1D", "O3", "O2 + O(1D)");
+  EXPECT_EQ(shared_qy.Reactant(), "O3");
+  TuvModel model(config);
+  model.AddStandardRadiators();
+  model.AddPhotolysisReaction("O3 -> O2 + O(1D)", &shared_xs, &shared_qy);
+
+  auto expected = reference.Calculate(30.0).GetPhotolysisRateProfile("O3 -> O2 + O(1D)");
+  auto actual = model.Calculate(30.0).GetPhotolysisRateProfile("O3 -> O2 + O(1D)");
+  ASSERT_EQ(actual.size(), expected.size());
+  for (std::size_t i = 0; i < actual.size(); ++i)
+  {
+    EXPECT_NEAR(actual[i], expected[i], 1e-3 * expected[i]);
+  }
+}
+
+TEST(SharedTableTest, ModelReadsSpectraFromSegment)
+{
+  ModelConfig config;
+  config.n_wavelength_bins = 40;
+  config.wavelength_min = 240.0;
+  config.wavelength_max = 340.0;
+  config.n_altitude_layers = 20;
+
+  O3CrossSection o3_xs;
+  O3O1DQuantumYield o1d_qy;
+  O3O3PQuantumYield o3p_qy;
+  TuvModel reference(config);
+  reference.AddStandardRadiators();
+  reference.AddPhotolysisReaction("O3 -> O2 + O(1D)", &o3_xs, &o1d_qy);
+  reference.AddPhotolysisReaction("O3 -> O2 + O(3P)", &o3_xs, &o3p_qy);
+
+  std::vector<double> temperatures;
+  for (double t = 180.0; t <= 320.0; t += 1.0)
+  {
+    temperatures.push_back(t);
+  }
+  SharedTableBuilder builder;
+  reference.BinSharedTables(builder, temperatures);
+  // The cross-section both reactions use is tabulated once; the O3 and O2
+  // radiators' cross-sections and the flux are tabulated too
+  EXPECT_EQ(builder.Bytes(), [&] {
+    const Grid& grid = reference.WavelengthGrid();
+    SharedTableBuilder expected;
+    BinCrossSection(expected, "O3 -> O2 + O(1D)/cross_section", o3_xs, grid, temperatures);
+    BinQuantumYield(expected, "O3 -> O2 + O(1D)/quantum_yield", o1d_qy, grid, temperatures);
+    BinQuantumYield(expected, "O3 -> O2 + O(3P)/quantum_yield", o3p_qy, grid, temperatures);
+    BinCrossSection(expected, "radiator O3/cross_section", O3CrossSection(), grid, temperatures);
+    BinCrossSection(expected, "radiator O2/cross_section", O2CrossSection(), grid, temperatures);
+    expected.Add("extraterrestrial_flux", reference.ExtraterrestrialFlux());
+    return expected.Bytes();
+  }());
+  EXPECT_TRUE(builder.Contains("radiator O3/cross_section/values"));
+  EXPECT_TRUE(builder.Contains("radiator O2/cross_section/values"));
+  EXPECT_FALSE(builder.Contains("radiator Rayleigh/cross_section/values"));
+  std::string name = SegmentName("model_wiring");
+  auto owner = builder.Publish(name);
+
+  auto model = std::make_unique<TuvModel>(reference);
+  std::uint64_t generation = model->Generation();
+  model->UseSharedTables(SharedTableSegment::Open(name));
+  EXPECT_NE(model->Generation(), generation);
+  const auto& reactions = model->PhotolysisReactions();
+  EXPECT_NE(reactions.Get(0).GetCrossSection(), &o3_xs);
+  EXPECT_EQ(reactions.Get(0).GetCrossSection(), reactions.Get(1).GetCrossSection());
+  EXPECT_EQ(reactions.Get(1).GetQuantumYield()->Products(), o3p_qy.Products());
+  for (const std::string radiator : { "O3", "O2" })
+  {
+    const auto& absorber = dynamic_cast<const FromCrossSectionRadiator&>(model->Radiators().Get(radiator));
+    EXPECT_NE(dynamic_cast<const SharedCrossSection*>(&absorber.GetCrossSection()), nullptr) << radiator;
+  }
+  EXPECT_EQ(model->ExtraterrestrialFlux(), reference.ExtraterrestrialFlux());
+
+  // A copy keeps the shared spectra alive after the original is gone
+  TuvModel copy(*model);
+  model.reset();
+  owner.reset();
+  for (const std::string reaction : { "O3 -> O2 + O(1D)", "O3 -> O2 + O(3P)" })
+  {
+    auto expected = reference.Calculate(30.0).GetPhotolysisRateProfile(reaction);
+    auto actual = copy.Calculate(30.0).GetPhotolysisRateProfile(reaction);
+    ASSERT_EQ(actual.size(), expected.size());
+    for (std::size_t i = 0; i < actual.size(); ++i)
+    {
+      EXPECT_NEAR(actual[i], expected[i], 1e-3 * expected[i]) << reaction;
+    }
+  }
+
+  // Missing tables are reported
+  SharedTableBuilder other;
+  other.Add("unrelated", std::vector<double>{ 1.0 });
+  std::string other_name = SegmentName("model_missing");
+  auto other_owner = other.Publish(other_name);
+  EXPECT_THROW(copy.UseSharedTables(other_owner), std::out_of_range);
+}
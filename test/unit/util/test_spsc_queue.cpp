@@ -0,0 +1,63 @@
+#include <tuvx/util/spsc_queue.hpp>
+
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace tuvx;
+
+TEST(SpscQueueTest, RejectsZeroCapacity)
+{
+  EXPECT_THROW(SpscQueue<int>(0), std::invalid_argument);
+}
+
+TEST(SpscQueueTest, TryPushStopsWhenFull)
+{
+  SpscQueue<int> queue(2);
+  EXPECT_EQ(queue.Capacity(), 2u);
+  EXPECT_TRUE(queue.Empty());
+  EXPECT_TRUE(queue.TryPush(1));
+  EXPECT_TRUE(queue.TryPush(2));
+  EXPECT_FALSE(queue.TryPush(3));
+
+  int value = 0;
+  EXPECT_TRUE(queue.TryPop(value));
+  EXPECT_EQ(value, 1);
+  EXPECT_TRUE(queue.TryPush(3));
+  EXPECT_EQ(queue.Pop(), 2);
+  EXPECT_EQ(queue.Pop(), 3);
+  EXPECT_TRUE(queue.Empty());
+  EXPECT_FALSE(queue.TryPop(value));
+}
+
+TEST(SpscQueueTest, DeliversInOrderAcrossThreads)
+{
+  const int n_items = 100000;
+  SpscQueue<int> queue(8);
+  std::vector<int> received;
+  received.reserve(n_items);
+
+  std::thread consumer(
+      [&]
+      {
+        for (int i = 0; i < n_items; ++i)
+        {
+          received.push_back(queue.Pop());
+        }
+      });
+  for (int i = 0; i < n_items; ++i)
+  {
+    queue.Push(i);
+  }
+  consumer.join();
+
+  ASSERT_EQ(received.size(), static_cast<std::size_t>(n_items));
+  for (int i = 0; i < n_items; ++i)
+  {
+    ASSERT_EQ(received[i], i);
+  }
+  EXPECT_TRUE(queue.Empty());
+}
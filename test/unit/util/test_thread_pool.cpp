@@ -0,0 +1,129 @@
+#include <tuvx/util/thread_pool.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace tuvx;
+
+TEST(ThreadPoolTest, SizeIncludesCaller)
+{
+  ThreadPool single(1);
+  EXPECT_EQ(single.Size(), 1u);
+
+  ThreadPool zero(0);
+  EXPECT_EQ(zero.Size(), 1u);
+
+  ThreadPool four(4);
+  EXPECT_EQ(four.Size(), 4u);
+
+  EXPECT_GE(ThreadPool::DefaultSize(), 1u);
+}
+
+TEST(ThreadPoolTest, VisitsEveryIndexOnce)
+{
+  for (std::size_t n_threads : { 1u, 2u, 4u, 8u })
+  {
+    ThreadPool pool(n_threads);
+    std::vector<std::atomic<int>> visits(1000);
+    pool.ParallelFor(visits.size(), [&](std::size_t i) { visits[i].fetch_add(1); });
+    for (std::size_t i = 0; i < visits.size(); ++i)
+    {
+      EXPECT_EQ(visits[i].load(), 1) << "threads " << n_threads << " index " << i;
+    }
+  }
+}
+
+TEST(ThreadPoolTest, WorkerIndexInRange)
+{
+  ThreadPool pool(4);
+  std::vector<std::size_t> workers(256, 99);
+  pool.ParallelFor(workers.size(), [&](std::size_t i, std::size_t worker) { workers[i] = worker; });
+  for (auto worker : workers)
+  {
+    EXPECT_LT(worker, pool.Size());
+  }
+}
+
+TEST(ThreadPoolTest, ReusableAcrossLoops)
+{
+  ThreadPool pool(3);
+  std::atomic<std::size_t> total{ 0 };
+  for (int loop = 0; loop < 50; ++loop)
+  {
+    pool.ParallelFor(17, [&](std::size_t) { total.fetch_add(1); });
+  }
+  EXPECT_EQ(total.load(), 50u * 17u);
+
+  // Empty and single-item loops run without waking workers
+  pool.ParallelFor(0, [&](std::size_t) { total.fetch_add(1); });
+  pool.ParallelFor(1, [&](std::size_t) { total.fetch_add(1); });
+  EXPECT_EQ(total.load(), 50u * 17u + 1u);
+}
+
+TEST(ThreadPoolTest, PropagatesException)
+{
+  ThreadPool pool(4);
+  EXPECT_THROW(
+      pool.ParallelFor(
+          100,
+          [](std::size_t i)
+          {
+            if (i == 42)
+            {
+              throw std::runtime_error("work item failed");
+            }
+          }),
+      std::runtime_error);
+
+  // The pool is still usable afterwards
+  std::atomic<int> count{ 0 };
+  pool.ParallelFor(10, [&](std::size_t) { count.fetch_add(1); });
+  EXPECT_EQ(count.load(), 10);
+}
+
+TEST(ThreadPoolTest, ForEachWorkerRunsOncePerThread)
+{
+  ThreadPool pool(4);
+  std::vector<std::thread::id> ids(pool.Size());
+  std::vector<int> calls(pool.Size(), 0);
+  pool.ForEachWorker(
+      [&](std::size_t worker)
+      {
+        ids[worker] = std::this_thread::get_id();
+        ++calls[worker];
+      });
+  EXPECT_EQ(calls, std::vector<int>(4, 1));
+  EXPECT_EQ(ids[0], std::this_thread::get_id());
+  for (std::size_t a = 0; a < ids.size(); ++a)
+  {
+    for (std::size_t b = a + 1; b < ids.size(); ++b)
+    {
+      EXPECT_NE(ids[a], ids[b]);
+    }
+  }
+
+  // The same worker index always maps to the same thread
+  std::vector<std::thread::id> again(pool.Size());
+  pool.ForEachWorker([&](std::size_t worker) { again[worker] = std::this_thread::get_id(); });
+  EXPECT_EQ(again, ids);
+}
+
+TEST(ThreadPoolTest, StaticBlocksCoverRangeOnce)
+{
+  for (std::size_t n : { 0u, 1u, 7u, 64u })
+  {
+    std::size_t expected_begin = 0;
+    for (std::size_t part = 0; part < 3; ++part)
+    {
+      auto [first, last] = StaticBlock(n, part, 3);
+      EXPECT_EQ(first, expected_begin);
+      EXPECT_LE(last - first, n / 3 + 1);
+      expected_begin = last;
+    }
+    EXPECT_EQ(expected_begin, n);
+  }
+}